@@ -1084,9 +1084,15 @@ class Vec3(Sequence[float]):
     def __add__(self, other: Vec3) -> Vec3:
         return self
 
+    def __iadd__(self, other: Vec3) -> Vec3:
+        return self
+
     def __sub__(self, other: Vec3) -> Vec3:
         return self
 
+    def __isub__(self, other: Vec3) -> Vec3:
+        return self
+
     @overload
     def __mul__(self, other: float) -> Vec3:
         return self
@@ -1098,6 +1104,17 @@ class Vec3(Sequence[float]):
     def __mul__(self, other: Any) -> Any:
         return self
 
+    @overload
+    def __imul__(self, other: float) -> Vec3:
+        return self
+
+    @overload
+    def __imul__(self, other: Sequence[float]) -> Vec3:
+        return self
+
+    def __imul__(self, other: Any) -> Any:
+        return self
+
     @overload
     def __rmul__(self, other: float) -> Vec3:
         return self
@@ -1136,6 +1153,15 @@ class Vec3(Sequence[float]):
         """
         return Vec3()
 
+    def distance(self, other: Vec3) -> float:
+        """distance(other: Vec3) -> float
+
+        Returns the distance between this vector and another.
+
+        Equivalent to (self - other).length() without the intermediate Vec3.
+        """
+        return float()
+
     def dot(self, other: Vec3) -> float:
         """dot(other: Vec3) -> float
 
@@ -1310,6 +1336,20 @@ def apply_config() -> None:
     return None
 
 
+def apply_scene_snapshot(snapshot: bytes) -> int:
+    """apply_scene_snapshot(snapshot: bytes) -> int
+
+    (internal)
+
+    Restore the current activity's nodes to a get_scene_snapshot() state.
+
+    Nodes that have died since are skipped and ones created since are
+    left alone. Attributes are only set where they differ from the
+    snapshot. Returns the number of nodes restored.
+    """
+    return int()
+
+
 def appname() -> str:
     """appname() -> str
 
@@ -1615,6 +1655,17 @@ def clipboard_set_text(value: str) -> None:
     return None
 
 
+def collect_garbage() -> int:
+    """collect_garbage() -> int
+
+    (internal)
+
+    Run a full Python garbage collection, recording its duration in
+    get_gc_stats(). Returns the number of unreachable objects found.
+    """
+    return int()
+
+
 def columnwidget(edit: ba.Widget = None,
                  parent: ba.Widget = None,
                  size: Sequence[float] = None,
@@ -1666,6 +1717,9 @@ def commit_config(config: str) -> None:
     """commit_config(config: str) -> None
 
     (internal)
+
+    Queue config contents to be written to disk in the background;
+    commits in quick succession coalesce into a single write.
     """
     return None
 
@@ -1992,6 +2046,18 @@ def get_account_type() -> str:
     return str()
 
 
+def get_activity_media_manifest() -> dict[str, list[str]]:
+    """get_activity_media_manifest() -> dict[str, list[str]]
+
+    (internal)
+
+    Return the names of all media requested so far in the current
+    activity, keyed by 'textures', 'models', 'collide_models', 'sounds'
+    and 'datas'.
+    """
+    return {'foo': ['bar']}
+
+
 def get_appconfig_builtin_keys() -> list[str]:
     """get_appconfig_builtin_keys() -> list[str]
 
@@ -2126,6 +2192,20 @@ def get_game_roster() -> list[dict[str, Any]]:
     return [{'foo': 'bar'}]
 
 
+def get_gc_stats(reset: bool = False) -> dict[str, dict[str, Any]]:
+    """get_gc_stats(reset: bool = False) -> dict[str, dict[str, Any]]
+
+    (internal)
+
+    Return counts and durations of engine-run garbage collections for
+    'gen0', 'gen1' and 'full' collections. Young-generation ones run
+    between game updates when they fit the idle budget; 'deferred'
+    counts times one was due but didn't fit and 'forced' counts ones
+    run over budget because they had waited too long.
+    """
+    return {'foo': {'bar': 0}}
+
+
 def get_google_play_party_client_count() -> int:
     """get_google_play_party_client_count() -> int
 
@@ -2190,6 +2270,35 @@ def get_max_graphics_quality() -> str:
     return str()
 
 
+def get_nearest_node(position: Sequence[float],
+                     type: Optional[str] = None,
+                     exclude: Optional[ba.Node] = None) -> Optional[ba.Node]:
+    """get_nearest_node(position: Sequence[float],
+    type: Optional[str] = None, exclude: Optional[ba.Node] = None)
+    -> Optional[ba.Node]
+
+    Return the node in the current ba.Context nearest to a point.
+
+    Category: Gameplay Functions
+
+    Only nodes with a 'position' attr are considered, optionally only
+    those of a given type. Returns None if there are none.
+    """
+    return None
+
+
+def get_net_stats(include_samples: bool = False) -> str:
+    """get_net_stats(include_samples: bool = False) -> str
+
+    (internal)
+
+    Return json covering the last few minutes of ping, traffic, resend
+    and buffering percentiles for current and recently closed
+    connections (optionally with their per-second samples).
+    """
+    return str()
+
+
 def get_news_show() -> str:
     """get_news_show() -> str
 
@@ -2198,6 +2307,37 @@ def get_news_show() -> str:
     return str()
 
 
+def get_node_distances(nodes: Sequence[ba.Node],
+                       position: Sequence[float]) -> list[Optional[float]]:
+    """get_node_distances(nodes: Sequence[ba.Node],
+    position: Sequence[float]) -> list[Optional[float]]
+
+    Return the distances from each of some nodes to a point.
+
+    Category: Gameplay Functions
+
+    Dead nodes and nodes with no 'position' attr give None.
+    """
+    return [0.0]
+
+
+def get_nodes_in_radius(position: Sequence[float],
+                        radius: float,
+                        type: Optional[str] = None) -> list[ba.Node]:
+    """get_nodes_in_radius(position: Sequence[float], radius: float,
+    type: Optional[str] = None) -> list[ba.Node]
+
+    Return nodes in the current ba.Context within a distance of a point.
+
+    Category: Gameplay Functions
+
+    Only nodes with a 'position' attr are considered, optionally only
+    those of a given type. Results are sorted nearest first. This is
+    much cheaper than checking each node's position from Python.
+    """
+    return [Node()]
+
+
 def get_package_collide_model(package: ba.AssetPackage,
                               name: str) -> ba.CollideModel:
     """get_package_collide_model(package: ba.AssetPackage, name: str)
@@ -2330,6 +2470,38 @@ def get_replays_dir() -> str:
     return str()
 
 
+def get_scene_digest(per_node: bool = False) -> Any:
+    """get_scene_digest(per_node: bool = False) -> Any
+
+    (internal)
+
+    Return a hash of the current (or else foreground) scene's state.
+
+    This covers the same state as get_scene_snapshot(). With per_node,
+    returns a list of (node_id, node_type, hash) tuples instead, so two
+    runs that should step identically (such as a replay and the game
+    it was recorded from) can find the first node that diverged.
+    Only bitwise-identical state hashes the same.
+    """
+    return _uninferrable()
+
+
+def get_scene_snapshot() -> bytes:
+    """get_scene_snapshot() -> bytes
+
+    (internal)
+
+    Capture the current activity's node state for apply_scene_snapshot().
+
+    This covers plain-data attribute values (numbers, bools, strings
+    and arrays of those), physics body states and any node-specific
+    resync data. References (materials, textures, other nodes, etc.),
+    timers and Python state are not included. Snapshots are only valid
+    within the running app.
+    """
+    return bytes()
+
+
 def get_scores_to_beat(level: str, config: str, callback: Callable) -> None:
     """get_scores_to_beat(level: str, config: str, callback: Callable) -> None
 
@@ -2346,6 +2518,17 @@ def get_special_widget(name: str) -> Widget:
     return Widget()
 
 
+def get_startup_timeline() -> str:
+    """get_startup_timeline() -> str
+
+    (internal)
+
+    Return a table of when each bootstrapping phase started and how
+    long it took (and on which thread), up to the first drawn frame.
+    """
+    return str()
+
+
 def get_string_height(string: str, suppress_warning: bool = False) -> float:
     """get_string_height(string: str, suppress_warning: bool = False) -> float
 
@@ -2368,6 +2551,17 @@ def get_string_width(string: str, suppress_warning: bool = False) -> float:
     return float()
 
 
+def get_telemetry_text() -> str:
+    """get_telemetry_text() -> str
+
+    (internal)
+
+    Return per-thread event loop load, queue depths, game step times
+    and scene step phase times in Prometheus text format.
+    """
+    return str()
+
+
 def get_thread_name() -> str:
     """get_thread_name() -> str
 
@@ -2881,6 +3075,31 @@ def is_xcode_build() -> bool:
     return bool()
 
 
+def load_media_async(call: Callable[[], Any],
+                     textures: Optional[Sequence[str]] = None,
+                     models: Optional[Sequence[str]] = None,
+                     collide_models: Optional[Sequence[str]] = None,
+                     sounds: Optional[Sequence[str]] = None,
+                     datas: Optional[Sequence[str]] = None) -> None:
+    """load_media_async(call: Callable[[], Any],
+      textures: Optional[Sequence[str]] = None,
+      models: Optional[Sequence[str]] = None,
+      collide_models: Optional[Sequence[str]] = None,
+      sounds: Optional[Sequence[str]] = None,
+      datas: Optional[Sequence[str]] = None) -> None
+
+    Load media in the background, calling back once it is all loaded.
+
+    Category: Asset Functions
+
+    This returns immediately; the call is run in the current context
+    once everything listed has loaded, after which ba.gettexture() and
+    friends can fetch it without hitching. Names that can't be found
+    are skipped.
+    """
+    return None
+
+
 def lock_all_input() -> None:
     """lock_all_input() -> None
 
@@ -3146,6 +3365,25 @@ def power_ranking_query(callback: Callable, season: Any = None) -> None:
     return None
 
 
+def prefetch_media(textures: Optional[Sequence[str]] = None,
+                   models: Optional[Sequence[str]] = None,
+                   collide_models: Optional[Sequence[str]] = None,
+                   sounds: Optional[Sequence[str]] = None,
+                   datas: Optional[Sequence[str]] = None) -> None:
+    """prefetch_media(textures: Optional[Sequence[str]] = None,
+      models: Optional[Sequence[str]] = None,
+      collide_models: Optional[Sequence[str]] = None,
+      sounds: Optional[Sequence[str]] = None,
+      datas: Optional[Sequence[str]] = None) -> None
+
+    (internal)
+
+    Start loading media in the background ahead of when it is needed.
+    Names that can't be found are ignored.
+    """
+    return None
+
+
 def print_context() -> None:
     """print_context() -> None
 
@@ -3384,6 +3622,39 @@ def rowwidget(edit: ba.Widget = None,
     return ba.Widget()
 
 
+def run_microbenchmarks() -> str:
+    """run_microbenchmarks() -> str
+
+    (internal)
+
+    Time low-level engine primitives in isolation and return the results
+    as a json string.
+    """
+    return str()
+
+
+def run_thread_latency_benchmark(count: int = 1000) -> None:
+    """run_thread_latency_benchmark(count: int = 1000) -> None
+
+    (internal)
+
+    Bounce calls between the game and media threads and log how long
+    each round trip takes.
+    """
+    return None
+
+
+def run_timer_benchmark(count: int = 10000) -> None:
+    """run_timer_benchmark(count: int = 10000) -> None
+
+    (internal)
+
+    Time creating, replacing and running a large number of timers
+    and log the results.
+    """
+    return None
+
+
 def run_transactions() -> None:
     """run_transactions() -> None
 
@@ -3453,7 +3724,8 @@ def scrollwidget(edit: ba.Widget = None,
                  claims_left_right: bool = None,
                  claims_up_down: bool = None,
                  claims_tab: bool = None,
-                 autoselect: bool = None) -> ba.Widget:
+                 autoselect: bool = None,
+                 on_scroll_call: Callable = None) -> ba.Widget:
     """scrollwidget(edit: ba.Widget = None, parent: ba.Widget = None,
       size: Sequence[float] = None, position: Sequence[float] = None,
       background: bool = None, selected_child: ba.Widget = None,
@@ -3465,7 +3737,8 @@ def scrollwidget(edit: ba.Widget = None,
       claims_left_right: bool = None,
       claims_up_down: bool = None,
       claims_tab: bool = None,
-      autoselect: bool = None) -> ba.Widget
+      autoselect: bool = None,
+      on_scroll_call: Callable = None) -> ba.Widget
 
     Create or edit a scroll widget.
 
@@ -3474,6 +3747,10 @@ def scrollwidget(edit: ba.Widget = None,
     Pass a valid existing ba.Widget as 'edit' to modify it; otherwise
     a new one is created and returned. Arguments that are not set to None
     are applied to the Widget.
+
+    If on_scroll_call is given, it is called with the current scroll
+    offset (from the top of the content) and the visible height as the
+    widget scrolls.
     """
     import ba  # pylint: disable=cyclic-import
     return ba.Widget()
@@ -3545,6 +3822,28 @@ def set_camera_target(x: float, y: float, z: float) -> None:
     return None
 
 
+def set_collision_batch_call(
+        call: Optional[Callable[[list], None]]) -> None:
+    """set_collision_batch_call(call: Optional[Callable[[list], None]])
+      -> None
+
+    (internal)
+
+    Batch collision-triggered Python work for the current activity.
+
+    While set, material 'call' and 'message' actions are not run
+    individually; instead, once per step after all other collision
+    actions have run, 'call' is passed a list of (node, opposingnode,
+    action) tuples in the order they would otherwise have run. 'action'
+    is the callable for 'call' actions or the message for 'message'
+    actions (to be delivered to 'node'). Records whose nodes died
+    before the batch ran are dropped using the usual rules. Note that
+    ba.getcollision() is not valid while handling a batch. Pass None
+    to go back to individual calls.
+    """
+    return None
+
+
 def set_debug_speed_exponent(speed: int) -> None:
     """set_debug_speed_exponent(speed: int) -> None
 
@@ -3626,6 +3925,30 @@ def set_party_window_open(value: bool) -> None:
     return None
 
 
+def set_physics_solver(iterations: Optional[int] = None,
+                       sor: Optional[float] = None,
+                       surface_layer: Optional[float] = None,
+                       max_correcting_vel: Optional[float] = None) -> None:
+    """set_physics_solver(iterations: Optional[int] = None,
+      sor: Optional[float] = None,
+      surface_layer: Optional[float] = None,
+      max_correcting_vel: Optional[float] = None) -> None
+
+    (internal)
+
+    Set physics solver settings for the current activity's scene.
+
+    'iterations' is the number of solver passes per step, 'sor' its
+    over-relaxation factor (between 0 and 2), 'surface_layer' how deep
+    contacts may sink before being pushed apart and
+    'max_correcting_vel' a cap on the speed they get pushed apart at
+    (negative for unlimited). Values not passed revert to the app
+    defaults. Fewer iterations cost less CPU but make stacks and
+    resting contacts softer.
+    """
+    return None
+
+
 def set_platform_misc_read_vals(mode: str) -> None:
     """set_platform_misc_read_vals(mode: str) -> None
 
@@ -3666,6 +3989,17 @@ def set_public_party_stats_url(url: Optional[str]) -> None:
     return None
 
 
+def set_python_call_profiling(enabled: bool) -> None:
+    """set_python_call_profiling(enabled: bool) -> None
+
+    (internal)
+
+    Start or stop counting context-call runs (timers, callbacks, etc.)
+    and time spent in them per call site. Stopping logs the busiest.
+    """
+    return None
+
+
 def set_replay_speed_exponent(speed: int) -> None:
     """set_replay_speed_exponent(speed: int) -> None
 
@@ -3676,8 +4010,22 @@ def set_replay_speed_exponent(speed: int) -> None:
     return None
 
 
-def set_stress_testing(testing: bool, player_count: int) -> None:
-    """set_stress_testing(testing: bool, player_count: int) -> None
+def set_spaz_step_profiling(enabled: bool) -> None:
+    """set_spaz_step_profiling(enabled: bool) -> None
+
+    (internal)
+
+    Start or stop timing the phases of spaz node steps. Stopping logs
+    the average time each phase took per step.
+    """
+    return None
+
+
+def set_stress_testing(testing: bool,
+                       player_count: int,
+                       churn: bool = True) -> None:
+    """set_stress_testing(testing: bool, player_count: int,
+        churn: bool = True) -> None
 
     (internal)
     """
@@ -3693,6 +4041,16 @@ def set_telnet_access_enabled(enable: bool) -> None:
     return None
 
 
+def set_telemetry_log_interval(interval: float) -> None:
+    """set_telemetry_log_interval(interval: float) -> None
+
+    (internal)
+
+    Log a line of load stats every 'interval' real seconds (0 stops).
+    """
+    return None
+
+
 def set_thread_name(name: str) -> None:
     """set_thread_name(name: str) -> None
 
@@ -3816,6 +4174,42 @@ def sign_out() -> None:
     return None
 
 
+def start_benchmark_recording(path: str) -> None:
+    """start_benchmark_recording(path: str) -> None
+
+    (internal)
+
+    Start recording per-frame build/render times, gpu pass times and
+    memory use. Stopping writes them to 'path' as JSON.
+    """
+    return None
+
+
+def start_control_server(path: str) -> None:
+    """start_control_server(path: str) -> None
+
+    (internal)
+
+    Serve json-lines stats/roster queries on a Unix domain socket at
+    'path' (only accessible to our user). Each request line looks like
+    {"id": 1, "method": "stats"}; methods are 'ping', 'stats',
+    'roster', 'net_stats' and 'telemetry'.
+    """
+    return None
+
+
+def start_event_trace(path: str) -> None:
+    """start_event_trace(path: str) -> None
+
+    (internal)
+
+    Start recording traced engine events from all threads. Stopping
+    writes them to 'path' in Chrome trace format (for chrome://tracing
+    or Perfetto).
+    """
+    return None
+
+
 def start_listening_for_wii_remotes() -> None:
     """start_listening_for_wii_remotes() -> None
 
@@ -3826,6 +4220,55 @@ def start_listening_for_wii_remotes() -> None:
     return None
 
 
+def start_load_test(path: str,
+                    steps: int,
+                    seed: int = 0,
+                    call: Optional[Callable[[], None]] = None) -> None:
+    """start_load_test(path: str, steps: int, seed: int = 0,
+        call: Optional[Callable[[], None]] = None) -> None
+
+    (internal)
+
+    Measure the next 'steps' game steps, then write step-time
+    percentiles, node/collision counts and client traffic as JSON to
+    'path' and run 'call'. The seed is applied to the C rand() used
+    by stress-test inputs.
+    """
+    return None
+
+
+def start_python_sampling(path: str, rate: float = 100.0) -> None:
+    """start_python_sampling(path: str, rate: float = 100.0) -> None
+
+    (internal)
+
+    Start sampling the game thread's Python stack 'rate' times per
+    second. Stopping writes totals to 'path' in folded-stack format
+    (as used by flamegraph tools).
+    """
+    return None
+
+
+def stop_benchmark_recording() -> None:
+    """stop_benchmark_recording() -> None
+
+    (internal)
+
+    Stop a start_benchmark_recording() run and write its results.
+    """
+    return None
+
+
+def stop_event_trace() -> None:
+    """stop_event_trace() -> None
+
+    (internal)
+
+    Stop a start_event_trace() run and write its results.
+    """
+    return None
+
+
 def stop_listening_for_wii_remotes() -> None:
     """stop_listening_for_wii_remotes() -> None
 
@@ -3836,6 +4279,16 @@ def stop_listening_for_wii_remotes() -> None:
     return None
 
 
+def stop_python_sampling() -> None:
+    """stop_python_sampling() -> None
+
+    (internal)
+
+    Stop a start_python_sampling() run and write its results.
+    """
+    return None
+
+
 def submit_analytics_counts() -> None:
     """submit_analytics_counts() -> None
 
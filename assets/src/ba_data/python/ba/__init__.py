@@ -14,11 +14,12 @@ from _ba import (
     Node, SessionPlayer, Sound, Texture, Timer, Vec3, Widget, buttonwidget,
     camerashake, checkboxwidget, columnwidget, containerwidget, do_once,
     emitfx, getactivity, getcollidemodel, getmodel, getnodes, getsession,
-    getsound, gettexture, hscrollwidget, imagewidget, log, newactivity,
-    newnode, playsound, printnodes, printobjects, pushcall, quit, rowwidget,
-    safecolor, screenmessage, scrollwidget, set_analytics_screen, charstr,
-    textwidget, time, timer, open_url, widget, clipboard_is_supported,
-    clipboard_has_text, clipboard_get_text, clipboard_set_text)
+    getsound, gettexture, hscrollwidget, imagewidget, load_media_async, log,
+    newactivity, newnode, playsound, printnodes, printobjects, pushcall, quit,
+    rowwidget, safecolor, screenmessage, scrollwidget, set_analytics_screen,
+    charstr, textwidget, time, timer, open_url, widget,
+    clipboard_is_supported, clipboard_has_text, clipboard_get_text,
+    clipboard_set_text)
 from ba._activity import Activity
 from ba._plugin import PotentialPlugin, Plugin, PluginSubsystem
 from ba._actor import Actor
@@ -76,7 +77,7 @@ from ba._music import (setmusic, MusicPlayer, MusicType, MusicPlayMode,
                        MusicSubsystem)
 from ba._powerup import PowerupMessage, PowerupAcceptMessage
 from ba._multiteamsession import MultiTeamSession
-from ba.ui import Window, UIController, uicleanupcheck
+from ba.ui import Window, UIController, uicleanupcheck, VirtualList
 from ba._collision import Collision, getcollision
 
 app: App
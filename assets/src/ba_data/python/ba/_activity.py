@@ -14,6 +14,8 @@ from ba._error import (print_exception, SessionTeamNotFoundError,
 from ba._dependency import DependencyComponent
 from ba._general import Call, verify_object_death
 from ba._messages import UNHANDLED
+from ba._mediaprefetch import (prefetch_activity_media,
+                               record_activity_media)
 
 if TYPE_CHECKING:
     from typing import Optional, Any
@@ -126,6 +128,13 @@ class Activity(DependencyComponent, Generic[PlayerType, TeamType]):
     # the next activity?
     can_show_ad_on_death = False
 
+    # Media this activity is known to need, as a dict of name lists keyed by
+    # 'textures', 'models', 'collide_models', 'sounds' and/or 'datas'.
+    # This starts loading as soon as an instance is created (along with
+    # whatever was recorded the last time this activity type ran), so
+    # media requested later on doesn't cause hitches.
+    media_manifest: Optional[dict[str, list[str]]] = None
+
     def __init__(self, settings: dict):
         """Creates an Activity in the current ba.Session.
 
@@ -192,6 +201,12 @@ class Activity(DependencyComponent, Generic[PlayerType, TeamType]):
         self._stats: Optional[ba.Stats] = None
         self._customdata: Optional[dict] = {}
 
+        # Get anything we know we'll want loading in the background now.
+        try:
+            prefetch_activity_media(type(self), settings)
+        except Exception:
+            print_exception(f'Error prefetching media for {self}.')
+
     def __del__(self) -> None:
 
         # If the activity has been run then we should have already cleaned
@@ -468,6 +483,12 @@ class Activity(DependencyComponent, Generic[PlayerType, TeamType]):
             except Exception:
                 print_exception(f'Error in on_transition_out for {self}.')
 
+            # Remember what we used so it can be prefetched next time.
+            try:
+                record_activity_media(self)
+            except Exception:
+                print_exception(f'Error recording media for {self}.')
+
     def begin(self, session: ba.Session) -> None:
         """Begin the activity.
 
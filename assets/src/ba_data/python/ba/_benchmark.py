@@ -9,18 +9,38 @@ from typing import TYPE_CHECKING
 import _ba
 
 if TYPE_CHECKING:
-    from typing import Any, Sequence
+    from typing import Any, Sequence, Optional
     import ba
 
 
-def run_cpu_benchmark() -> None:
-    """Run a cpu benchmark."""
+def run_cpu_benchmark(duration: float = 30.0,
+                      path: Optional[str] = None,
+                      exit_when_done: bool = False) -> None:
+    """Run a cpu benchmark.
+
+    The tutorial runs at low graphics quality with 100 scene steps per
+    game step. Frame timings are recorded for 'duration' real seconds and
+    written as JSON to 'path'; by default 'benchmark_results.json' in the
+    user python directory.
+    """
+    _run_benchmark('cpu', 'Low', duration, path, exit_when_done)
+
+
+def _run_benchmark(benchmark_type: str, quality: str, duration: float,
+                   path: Optional[str], exit_when_done: bool) -> None:
     # pylint: disable=cyclic-import
+    import os
     from bastd import tutorial
     from ba._session import Session
+    from ba._general import Call
+    from ba._generated.enums import TimeType
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user,
+                            'benchmark_results.json')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
 
     class BenchmarkSession(Session):
-        """Session type for cpu benchmark."""
+        """Session type for cpu/gpu benchmarks."""
 
         def __init__(self) -> None:
 
@@ -32,9 +52,9 @@ def run_cpu_benchmark() -> None:
             # Store old graphics settings.
             self._old_quality = _ba.app.config.resolve('Graphics Quality')
             cfg = _ba.app.config
-            cfg['Graphics Quality'] = 'Low'
+            cfg['Graphics Quality'] = quality
             cfg.apply()
-            self.benchmark_type = 'cpu'
+            self.benchmark_type = benchmark_type
             self.setactivity(_ba.newactivity(tutorial.TutorialActivity))
 
         def __del__(self) -> None:
@@ -47,7 +67,36 @@ def run_cpu_benchmark() -> None:
         def on_player_request(self, player: ba.SessionPlayer) -> bool:
             return False
 
-    _ba.new_host_session(BenchmarkSession, benchmark_type='cpu')
+    config = {
+        'benchmark_type': benchmark_type,
+        'graphics_quality': quality,
+        'duration': duration
+    }
+    _ba.new_host_session(BenchmarkSession, benchmark_type=benchmark_type)
+    with _ba.Context('ui'):
+        _ba.start_benchmark_recording(path)
+        _ba.timer(duration,
+                  Call(_finish_benchmark, path, config, exit_when_done),
+                  timetype=TimeType.REAL)
+
+
+def _finish_benchmark(path: str, config: dict[str, Any],
+                      exit_when_done: bool) -> None:
+    import json
+    _ba.stop_benchmark_recording()
+    try:
+        with open(path, encoding='utf-8') as infile:
+            results = json.load(infile)
+    except (OSError, ValueError):
+        # Recording got stopped elsewhere or its results weren't written.
+        results = None
+    if results is not None:
+        results['config'] = config
+        results['build_number'] = _ba.app.build_number
+        with open(path, 'w', encoding='utf-8') as outfile:
+            json.dump(results, outfile, indent=2)
+    if exit_when_done:
+        _ba.quit()
 
 
 def run_stress_test(playlist_type: str = 'Random',
@@ -136,9 +185,97 @@ def _reset_stress_test(args: dict[str, Any]) -> None:
     _ba.timer(1.0, Call(start_stress_test, args), timetype=TimeType.REAL)
 
 
-def run_gpu_benchmark() -> None:
-    """Kick off a benchmark to test gpu speeds."""
-    _ba.screenmessage('FIXME: Not wired up yet.', color=(1, 0, 0))
+def run_load_test(player_count: int = 8,
+                  steps: int = 7500,
+                  seed: int = 0,
+                  playlist_type: str = 'Free-For-All',
+                  playlist_name: str = '__default__',
+                  path: Optional[str] = None,
+                  warmup: float = 5.0,
+                  exit_when_done: bool = False) -> None:
+    """Run a fixed-length load test and write its stats as JSON.
+
+    Starts a session with a fixed set of stress-test players, lets it
+    settle for 'warmup' real seconds and then measures 'steps' game steps
+    (8ms each). Comparing results between builds can catch performance
+    regressions; for example, from a headless build:
+
+    ballisticacore_headless -exec "import ba.internal;
+    ba.internal.run_load_test(exit_when_done=True)"
+
+    Stats go to 'load_test_stats.json' in the user python directory by
+    default.
+    """
+    import os
+    from ba._general import Call
+    from ba._dualteamsession import DualTeamSession
+    from ba._freeforallsession import FreeForAllSession
+    from ba._generated.enums import TimeType
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user,
+                            'load_test_stats.json')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
+    config = {
+        'player_count': player_count,
+        'steps': steps,
+        'seed': seed,
+        'playlist_type': playlist_type,
+        'playlist_name': playlist_name,
+        'warmup': warmup
+    }
+
+    # Keep everything we can control the same from run to run.
+    random.seed(seed)
+    appconfig = _ba.app.config
+    if playlist_type == 'Teams':
+        appconfig['Team Tournament Playlist Selection'] = playlist_name
+        appconfig['Team Tournament Playlist Randomize'] = 0
+        sessiontype: type[ba.Session] = DualTeamSession
+    elif playlist_type == 'Free-For-All':
+        appconfig['Free-for-All Playlist Selection'] = playlist_name
+        appconfig['Free-for-All Playlist Randomize'] = 0
+        sessiontype = FreeForAllSession
+    else:
+        raise ValueError(f'Invalid playlist_type: {playlist_type}')
+
+    with _ba.Context('ui'):
+        _ba.pushcall(Call(_ba.new_host_session, sessiontype))
+        _ba.set_stress_testing(True, player_count, churn=False)
+        _ba.timer(warmup,
+                  Call(_ba.start_load_test, path, steps, seed,
+                       Call(_finish_load_test, path, config,
+                            exit_when_done)),
+                  timetype=TimeType.REAL)
+
+
+def _finish_load_test(path: str, config: dict[str, Any],
+                      exit_when_done: bool) -> None:
+    import json
+    _ba.set_stress_testing(False, 0)
+
+    # Note what was tested alongside the results.
+    with open(path, encoding='utf-8') as infile:
+        stats = json.load(infile)
+    stats['config'] = config
+    stats['build_number'] = _ba.app.build_number
+    with open(path, 'w', encoding='utf-8') as outfile:
+        json.dump(stats, outfile, indent=2)
+    if exit_when_done:
+        _ba.quit()
+
+
+def run_gpu_benchmark(duration: float = 30.0,
+                      path: Optional[str] = None,
+                      exit_when_done: bool = False) -> None:
+    """Kick off a benchmark to test gpu speeds.
+
+    Like run_cpu_benchmark() but the tutorial steps normally and draws at
+    the highest graphics quality; per-pass gpu times are included where
+    the renderer supports timer queries.
+    """
+    quality = ('Medium'
+               if _ba.get_max_graphics_quality() == 'Medium' else 'Higher')
+    _run_benchmark('gpu', quality, duration, path, exit_when_done)
 
 
 def run_media_reload_benchmark() -> None:
@@ -169,3 +306,161 @@ def run_media_reload_benchmark() -> None:
     _ba.timer(0.05,
               Call(delay_add, _ba.time(TimeType.REAL)),
               timetype=TimeType.REAL)
+
+
+def run_micro_benchmark(path: Optional[str] = None,
+                        exit_when_done: bool = False) -> None:
+    """Time low-level engine primitives in isolation.
+
+    Covers compression, timer lists, object refs, render command buffers,
+    matrix math, utf-8 decoding and physics stepping. Nanoseconds per
+    operation for each are written as JSON to 'path'; by default
+    'microbenchmark_results.json' in the user python directory. Blocks
+    the game for a few seconds while running.
+    """
+    import os
+    import json
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user,
+                            'microbenchmark_results.json')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
+    results = json.loads(_ba.run_microbenchmarks())
+    results['build_number'] = _ba.app.build_number
+    with open(path, 'w', encoding='utf-8') as outfile:
+        json.dump(results, outfile, indent=2)
+    print(f'Microbenchmark results written to {path}.')
+    if exit_when_done:
+        _ba.quit()
+
+
+def run_thread_latency_benchmark(count: int = 1000) -> None:
+    """Measure cross-thread message round trip times.
+
+    Results are logged once all round trips complete.
+    """
+    _ba.run_thread_latency_benchmark(count)
+
+
+def run_timer_benchmark(count: int = 10000) -> None:
+    """Measure timer list operations with a given number of live timers.
+
+    Results are logged when done.
+    """
+    _ba.run_timer_benchmark(count)
+
+
+def profile_spaz_steps(duration: float = 10.0) -> None:
+    """Time the phases of spaz node steps for a while (in real seconds).
+
+    A per-phase breakdown is logged when done.
+    """
+    from ba._general import Call
+    from ba._generated.enums import TimeType
+    _ba.set_spaz_step_profiling(True)
+    _ba.timer(duration,
+              Call(_ba.set_spaz_step_profiling, False),
+              timetype=TimeType.REAL)
+
+
+def profile_python_calls(duration: float = 10.0) -> None:
+    """Count timer/callback runs per call site for a while (real seconds).
+
+    The busiest call sites are logged when done.
+    """
+    from ba._general import Call
+    from ba._generated.enums import TimeType
+    _ba.set_python_call_profiling(True)
+    _ba.timer(duration,
+              Call(_ba.set_python_call_profiling, False),
+              timetype=TimeType.REAL)
+
+
+def sample_python(duration: float = 10.0,
+                  path: Optional[str] = None,
+                  rate: float = 100.0) -> None:
+    """Sample the game thread's Python stacks for a while (real seconds).
+
+    Results are written in folded-stack format (for flamegraph tools) to
+    path; by default 'python_samples.txt' in the user python directory.
+    """
+    import os
+    from ba._general import Call
+    from ba._generated.enums import TimeType
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user,
+                            'python_samples.txt')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
+    _ba.start_python_sampling(path, rate)
+    _ba.timer(duration,
+              Call(_ba.stop_python_sampling),
+              timetype=TimeType.REAL)
+
+
+def trace_events(duration: float = 5.0, path: Optional[str] = None) -> None:
+    """Record a timeline of engine events on all threads (real seconds).
+
+    The trace is written to path in Chrome trace format, which
+    chrome://tracing or Perfetto can load; by default 'event_trace.json'
+    in the user python directory.
+    """
+    import os
+    from ba._general import Call
+    from ba._generated.enums import TimeType
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user, 'event_trace.json')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
+    _ba.start_event_trace(path)
+    _ba.timer(duration, Call(_ba.stop_event_trace), timetype=TimeType.REAL)
+
+
+def write_telemetry(path: Optional[str] = None) -> None:
+    """Write engine load counters in Prometheus text format.
+
+    Covers per-thread event loop load and queue depths, game step times
+    and scene step phase times. Goes to path; by default 'telemetry.prom'
+    in the user python directory.
+    """
+    import os
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user, 'telemetry.prom')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
+
+    # Write then rename so collectors never see a partial file.
+    tmppath = path + '.tmp'
+    with open(tmppath, 'w', encoding='utf-8') as outfile:
+        outfile.write(_ba.get_telemetry_text())
+    os.replace(tmppath, path)
+
+
+def write_net_stats(path: Optional[str] = None,
+                    include_samples: bool = True) -> None:
+    """Write the last few minutes of per-connection network stats as json.
+
+    Covers ping, traffic, resend and buffering percentiles for current
+    and recently closed connections, plus (by default) their per-second
+    samples. Goes to path; by default 'net_stats.json' in the user python
+    directory.
+    """
+    import os
+    if path is None:
+        path = os.path.join(_ba.app.python_directory_user, 'net_stats.json')
+        os.makedirs(_ba.app.python_directory_user, exist_ok=True)
+    tmppath = path + '.tmp'
+    with open(tmppath, 'w', encoding='utf-8') as outfile:
+        outfile.write(_ba.get_net_stats(include_samples=include_samples))
+    os.replace(tmppath, path)
+
+
+def print_startup_timeline() -> None:
+    """Print when each bootstrapping phase ran and how long it took."""
+    print(_ba.get_startup_timeline())
+
+
+def print_gc_stats(reset: bool = False) -> None:
+    """Print how much time engine-run garbage collection has been taking."""
+    for name, stats in _ba.get_gc_stats(reset=reset).items():
+        count = stats['collections']
+        avg_ms = stats['total_ms'] / count if count else 0.0
+        print(f'GC {name}: {count} runs, {avg_ms:.2f}ms avg,'
+              f' {stats["max_ms"]:.2f}ms max, {stats["deferred"]} deferred,'
+              f' {stats["forced"]} forced')
@@ -0,0 +1,119 @@
+# Released under the MIT License. See LICENSE for details.
+#
+"""Prefetching of activity media from declared/recorded manifests."""
+from __future__ import annotations
+
+import os
+import json
+from typing import TYPE_CHECKING
+
+import _ba
+from ba._error import print_exception
+
+if TYPE_CHECKING:
+    from typing import Optional, Any
+    import ba
+
+MEDIA_TYPES = ('textures', 'models', 'collide_models', 'sounds', 'datas')
+
+# Keep the file from growing forever as mods come and go.
+MAX_RECORDED_MANIFESTS = 200
+
+
+class MediaManifestStore:
+    """Remembers the media each activity type used the last time it ran.
+
+    (internal)
+    """
+
+    def __init__(self) -> None:
+        self._manifests: Optional[dict[str, dict[str, list[str]]]] = None
+
+    @staticmethod
+    def _path() -> str:
+        return os.path.join(os.path.dirname(_ba.app.config_file_path),
+                            'media_manifests.json')
+
+    def _load(self) -> dict[str, dict[str, list[str]]]:
+        if self._manifests is None:
+            self._manifests = {}
+            try:
+                with open(self._path(), encoding='utf-8') as infile:
+                    data = json.loads(infile.read())
+                if isinstance(data, dict):
+                    self._manifests = data
+            except FileNotFoundError:
+                pass
+            except Exception:
+                print_exception('Error loading media manifests.')
+        return self._manifests
+
+    def get(self, key: str) -> Optional[dict[str, list[str]]]:
+        """Return the recorded manifest for a key (if any)."""
+        return self._load().get(key)
+
+    def set(self, key: str, manifest: dict[str, list[str]]) -> None:
+        """Record a manifest for a key, writing to disk if it changed."""
+        manifests = self._load()
+        if manifests.get(key) == manifest:
+            return
+
+        # Re-insert so the least recently recorded get dropped first.
+        manifests.pop(key, None)
+        manifests[key] = manifest
+        while len(manifests) > MAX_RECORDED_MANIFESTS:
+            del manifests[next(iter(manifests))]
+        try:
+            with open(self._path(), 'w', encoding='utf-8') as outfile:
+                outfile.write(json.dumps(manifests, separators=(',', ':')))
+        except Exception:
+            print_exception('Error writing media manifests.')
+
+
+_store = MediaManifestStore()
+
+
+def _manifest_key(activitytype: type[ba.Activity], settings: dict) -> str:
+    # Games use very different media from map to map.
+    key = f'{activitytype.__module__}.{activitytype.__qualname__}'
+    mapname = settings.get('map')
+    if isinstance(mapname, str):
+        key += ':' + mapname
+    return key
+
+
+def prefetch_activity_media(activitytype: type[ba.Activity],
+                            settings: dict) -> None:
+    """Start loading media an activity is expected to need.
+
+    (internal)
+
+    This includes the activity's declared media_manifest as well as
+    anything recorded the last time it ran.
+    """
+    names: dict[str, set[str]] = {mtype: set() for mtype in MEDIA_TYPES}
+    for manifest in (activitytype.media_manifest,
+                     _store.get(_manifest_key(activitytype, settings))):
+        if not manifest:
+            continue
+        for mtype in MEDIA_TYPES:
+            names[mtype].update(manifest.get(mtype, ()))
+    if any(names.values()):
+        args: dict[str, Any] = {
+            mtype: sorted(vals)
+            for mtype, vals in names.items()
+        }
+        _ba.prefetch_media(**args)
+
+
+def record_activity_media(activity: ba.Activity) -> None:
+    """Record the media the current activity has used so far.
+
+    (internal)
+    """
+    manifest = _ba.get_activity_media_manifest()
+    _store.set(
+        _manifest_key(type(activity), activity.settings_raw), {
+            mtype: sorted(manifest.get(mtype, []))
+            for mtype in MEDIA_TYPES
+        })
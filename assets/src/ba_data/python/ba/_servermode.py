@@ -10,8 +10,12 @@ from typing import TYPE_CHECKING
 from efro.terminal import Clr
 from bacommon.servermanager import (ServerCommand, StartServerModeCommand,
                                     ShutdownCommand, ShutdownReason,
+                                    SoftRestartCommand,
                                     ChatMessageCommand, ScreenMessageCommand,
-                                    ClientListCommand, KickCommand)
+                                    ClientListCommand, KickCommand,
+                                    SamplePythonCommand,
+                                    WriteTelemetryCommand,
+                                    WriteNetStatsCommand)
 import _ba
 from ba._generated.enums import TimeType
 from ba._freeforallsession import FreeForAllSession
@@ -42,6 +46,12 @@ def _cmd(command_data: bytes) -> None:
                                 immediate=command.immediate)
         return
 
+    if isinstance(command, SoftRestartCommand):
+        assert _ba.app.server is not None
+        _ba.app.server.soft_restart(config=command.config,
+                                    immediate=command.immediate)
+        return
+
     if isinstance(command, ChatMessageCommand):
         assert _ba.app.server is not None
         _ba.chatmessage(command.message, clients=command.clients)
@@ -70,6 +80,23 @@ def _cmd(command_data: bytes) -> None:
                             ban_time=command.ban_time)
         return
 
+    if isinstance(command, SamplePythonCommand):
+        from ba._benchmark import sample_python
+        sample_python(duration=command.duration,
+                      path=command.path,
+                      rate=command.rate)
+        return
+
+    if isinstance(command, WriteTelemetryCommand):
+        from ba._benchmark import write_telemetry
+        write_telemetry(path=command.path)
+        return
+
+    if isinstance(command, WriteNetStatsCommand):
+        from ba._benchmark import write_net_stats
+        write_net_stats(path=command.path)
+        return
+
     print(f'{Clr.SRED}ERROR: server process'
           f' got unknown command: {type(command)}{Clr.RST}')
 
@@ -90,6 +117,8 @@ class ServerController:
         self._first_run = True
         self._shutdown_reason: Optional[ShutdownReason] = None
         self._executing_shutdown = False
+        self._soft_restart_config: Optional[ServerConfig] = None
+        self._control_server_started = False
 
         # Make note if they want us to import a playlist;
         # we'll need to do that first if so.
@@ -154,6 +183,22 @@ class ServerController:
                   f' server process will exit at the next clean opportunity.'
                   f'{Clr.RST}')
 
+    def soft_restart(self, config: ServerConfig, immediate: bool) -> None:
+        """Restart our sessions in-process using a new config.
+
+        This skips the Python init, media loads and client reconnects of a
+        full process restart, so it costs well under a second of downtime.
+        Values only read at process launch (such as port) are not updated.
+        """
+        self._soft_restart_config = config
+        if immediate:
+            print(f'{Clr.SBLU}Immediate soft restart initiated.{Clr.RST}')
+            self._execute_soft_restart()
+        else:
+            print(f'{Clr.SBLU}Soft restart initiated;'
+                  f' server will restart at the next clean opportunity.'
+                  f'{Clr.RST}')
+
     def handle_transition(self) -> bool:
         """Handle transitioning to a new ba.Session or quitting the app.
 
@@ -165,8 +210,52 @@ class ServerController:
         if self._shutdown_reason is not None:
             self._execute_shutdown()
             return True
+        if self._soft_restart_config is not None:
+            self._execute_soft_restart()
+            return True
         return False
 
+    def _execute_soft_restart(self) -> None:
+        from ba._language import Lstr
+        config = self._soft_restart_config
+        if config is None or self._executing_shutdown:
+            return
+        self._soft_restart_config = None
+        if config.port != self._config.port:
+            print(f'{Clr.SRED}Port changes require a full restart;'
+                  f' keeping port {self._config.port}.{Clr.RST}')
+        print(f'{Clr.SBLU}Soft-restarting server'
+              f' at {time.strftime("%c")}.{Clr.RST}')
+        _ba.screenmessage(Lstr(resource='internal.serverRestartingText'),
+                          color=(1, 0.5, 0.0))
+
+        # These normally get written to the app config file before launch
+        # by the server manager; we need to set them ourself here.
+        appcfg = _ba.app.config
+        appcfg['Auto Balance Teams'] = config.auto_balance_teams
+        appcfg['Show Tutorial'] = config.show_tutorial
+        for key, val in (('Custom Team Names', config.team_names),
+                         ('Custom Team Colors', config.team_colors)):
+            if val is not None:
+                appcfg[key] = val
+            elif key in appcfg:
+                del appcfg[key]
+        appcfg['Idle Exit Minutes'] = config.idle_exit_minutes
+        appcfg.apply()
+
+        # Now go back through our usual prep (playlist fetches, etc.) which
+        # will replace the current session with a fresh one.
+        self._config = config
+        self._playlist_name = '__default__'
+        self._playlist_fetch_running = config.playlist_code is not None
+        self._playlist_fetch_sent_request = False
+        self._playlist_fetch_got_response = False
+        with _ba.Context('ui'):
+            self._prep_timer = _ba.Timer(0.25,
+                                         self._prepare_to_serve,
+                                         timetype=TimeType.REAL,
+                                         repeat=True)
+
     def _execute_shutdown(self) -> None:
         from ba._language import Lstr
         if self._executing_shutdown:
@@ -369,6 +458,15 @@ class ServerController:
         _ba.set_public_party_stats_url(self._config.stats_url)
         _ba.set_public_party_enabled(self._config.party_is_public)
 
+        if (self._config.control_socket_path is not None
+                and not self._control_server_started):
+            _ba.start_control_server(self._config.control_socket_path)
+            self._control_server_started = True
+
+        if self._config.telemetry_log_interval is not None:
+            _ba.set_telemetry_log_interval(
+                self._config.telemetry_log_interval)
+
         # And here.. we.. go.
         if self._config.stress_test_players is not None:
             # Special case: run a stress test.
@@ -379,6 +477,7 @@ class ServerController:
                             round_duration=30)
         else:
             _ba.new_host_session(sessiontype)
+        self._first_run = False
 
         # Run an access check if we're trying to make a public party.
         if not self._ran_access_check and self._config.party_is_public:
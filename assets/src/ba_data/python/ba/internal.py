@@ -9,6 +9,10 @@ defensively) in mods.
 
 # pylint: disable=unused-import
 
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
 from ba._map import (get_unowned_maps, get_map_class, register_map,
                      preload_map_preview_media, get_map_display_string,
                      get_filtered_map_name)
@@ -20,7 +24,13 @@ from ba._activitytypes import JoinActivity, ScoreScreenActivity
 from ba._apputils import (is_browser_likely_available, get_remote_app_name,
                           should_submit_debug_info)
 from ba._benchmark import (run_gpu_benchmark, run_cpu_benchmark,
-                           run_media_reload_benchmark, run_stress_test)
+                           run_media_reload_benchmark, run_micro_benchmark,
+                           run_stress_test, run_thread_latency_benchmark,
+                           run_timer_benchmark, run_load_test,
+                           profile_spaz_steps, profile_python_calls,
+                           sample_python, print_gc_stats,
+                           print_startup_timeline, write_telemetry,
+                           write_net_stats, trace_events)
 from ba._campaign import getcampaign
 from ba._messages import PlayerProfilesChangedMessage
 from ba._multiteamsession import DEFAULT_TEAM_COLORS, DEFAULT_TEAM_NAMES
@@ -33,9 +43,37 @@ from ba._profile import (get_player_profile_colors, get_player_profile_icon,
 from ba._tips import get_next_tip
 from ba._playlist import (get_default_free_for_all_playlist,
                           get_default_teams_playlist, filter_playlist)
-from ba._store import (get_available_sale_time, get_available_purchase_count,
-                       get_store_item_name_translated,
-                       get_store_item_display_size, get_store_layout,
-                       get_store_item, get_clean_price)
-from ba._tournament import get_tournament_prize_strings
 from ba._gameutils import get_trophy_string
+
+# Store and tournament bits aren't needed until those UIs come up, so we
+# import them on first use to keep them out of app startup.
+if TYPE_CHECKING:
+    from typing import Any
+    from ba._store import (get_available_sale_time,
+                           get_available_purchase_count,
+                           get_store_item_name_translated,
+                           get_store_item_display_size, get_store_layout,
+                           get_store_item, get_clean_price)
+    from ba._tournament import get_tournament_prize_strings
+
+_LAZY_ATTRS = {
+    'get_available_sale_time': 'ba._store',
+    'get_available_purchase_count': 'ba._store',
+    'get_store_item_name_translated': 'ba._store',
+    'get_store_item_display_size': 'ba._store',
+    'get_store_layout': 'ba._store',
+    'get_store_item': 'ba._store',
+    'get_clean_price': 'ba._store',
+    'get_tournament_prize_strings': 'ba._tournament',
+}
+
+
+def __getattr__(name: str) -> Any:
+    """Import lazily-loaded attrs on first access."""
+    modulename = _LAZY_ATTRS.get(name)
+    if modulename is None:
+        raise AttributeError(f'module {__name__!r} has no attribute {name!r}')
+    import importlib
+    val = getattr(importlib.import_module(modulename), name)
+    globals()[name] = val
+    return val
@@ -14,7 +14,7 @@ from ba._generated.enums import TimeType
 from ba._general import print_active_refs
 
 if TYPE_CHECKING:
-    from typing import Optional, Any
+    from typing import Optional, Any, Callable
 
     import ba
 
@@ -41,6 +41,98 @@ class Window:
         return self._root_widget
 
 
+class VirtualList:
+    """A scrolling list that only has widgets for rows near its view.
+
+    Category: User Interface Classes
+
+    Use this for long lists, which would otherwise be slow to build and
+    draw. Rows are all row_height tall. As a row nears the view, an empty
+    container of (width, row_height) is passed to make_row along with
+    the row index, to be filled in with widgets. Rows that scroll well
+    out of view get deleted, or, if update_row is given, moved into place
+    for a row coming into view and passed to update_row to be refilled.
+    """
+
+    def __init__(self,
+                 parent: ba.Widget,
+                 position: tuple[float, float],
+                 size: tuple[float, float],
+                 row_height: float,
+                 count: int,
+                 make_row: Callable[[ba.Widget, int], None],
+                 update_row: Optional[Callable[[ba.Widget, int],
+                                               None]] = None,
+                 extra_rows: int = 3) -> None:
+        from ba._general import WeakCall
+        self._width = size[0]
+        self._row_height = row_height
+        self._make_row = make_row
+        self._update_row = update_row
+        self._extra_rows = extra_rows
+        self._offset = 0.0
+        self._visible_height = size[1]
+        self._count = 0
+        self._rows: dict[int, ba.Widget] = {}
+        self.scrollwidget = _ba.scrollwidget(
+            parent=parent,
+            position=position,
+            size=size,
+            highlight=False,
+            on_scroll_call=WeakCall(self._on_scroll))
+        self._content = _ba.containerwidget(parent=self.scrollwidget,
+                                            size=(self._width, 0),
+                                            background=False)
+        self.set_count(count)
+
+    def set_count(self, count: int) -> None:
+        """Set the number of rows; this also refills all current rows."""
+        self._count = count
+        _ba.containerwidget(edit=self._content,
+                            size=(self._width, self._row_height * count))
+        for row in self._rows.values():
+            row.delete()
+        self._rows = {}
+        self._update_rows()
+
+    def _on_scroll(self, offset: float, visible_height: float) -> None:
+        self._offset = offset
+        self._visible_height = visible_height
+        self._update_rows()
+
+    def _update_rows(self) -> None:
+        first = max(
+            0,
+            int(self._offset // self._row_height) - self._extra_rows)
+        last = min(
+            self._count,
+            int((self._offset + self._visible_height) // self._row_height) +
+            1 + self._extra_rows)
+        freed = [
+            self._rows.pop(index) for index in list(self._rows)
+            if not first <= index < last
+        ]
+        content_height = self._row_height * self._count
+        for index in range(first, last):
+            if index in self._rows:
+                continue
+            position = (0.0, content_height - (index + 1) * self._row_height)
+            if freed and self._update_row is not None:
+                row = freed.pop()
+                _ba.containerwidget(edit=row, position=position)
+                self._update_row(row, index)
+            else:
+                row = _ba.containerwidget(parent=self._content,
+                                          position=position,
+                                          size=(self._width,
+                                                self._row_height),
+                                          background=False)
+                self._make_row(row, index)
+            self._rows[index] = row
+        for row in freed:
+            row.delete()
+
+
 @dataclass
 class UICleanupCheck:
     """Holds info about a uicleanupcheck target."""
@@ -173,7 +173,7 @@ class SpazBot(Spaz):
         closest: Optional[ba.Vec3] = None
         assert self._player_pts is not None
         for plpt, plvel in self._player_pts:
-            dist = (plpt - botpt).length()
+            dist = plpt.distance(botpt)
 
             # Ignore player-points that are significantly below the bot
             # (keeps bots from following players off cliffs).
@@ -288,12 +288,12 @@ class SpazBot(Spaz):
         assert target_vel is not None
         target_vel[1] = 0.0
 
-        dist_raw = (target_pt_raw - our_pos).length()
+        dist_raw = target_pt_raw.distance(our_pos)
 
         # Use a point out in front of them as real target.
         # (more out in front the farther from us they are)
         target_pt = (target_pt_raw +
-                     target_vel * dist_raw * 0.3 * self._lead_amount)
+                     target_vel * (dist_raw * 0.3 * self._lead_amount))
 
         diff = (target_pt - our_pos)
         dist = diff.length()
@@ -293,6 +293,43 @@ class ServerManagerApp:
         self._enqueue_server_command(
             KickCommand(client_id=client_id, ban_time=ban_time))
 
+    def sample_python(self,
+                      duration: float = 10.0,
+                      path: Optional[str] = None,
+                      rate: float = 100.0) -> None:
+        """Sample the server's Python game code for a while (real seconds).
+
+        Stack totals are written to path (by default 'python_samples.txt'
+        in the server's user python directory) in folded-stack format,
+        which flamegraph tools can turn into a flame graph.
+        """
+        from bacommon.servermanager import SamplePythonCommand
+        self._enqueue_server_command(
+            SamplePythonCommand(duration=duration, path=path, rate=rate))
+
+    def telemetry(self, path: Optional[str] = None) -> None:
+        """Write the server's engine load counters to a file.
+
+        Per-thread event loop load and queue depths, game step times and
+        scene step phase times go to path (by default 'telemetry.prom' in
+        the server's user python directory) in Prometheus text format, so
+        they can be picked up by a node_exporter textfile collector or
+        similar.
+        """
+        from bacommon.servermanager import WriteTelemetryCommand
+        self._enqueue_server_command(WriteTelemetryCommand(path=path))
+
+    def net_stats(self, path: Optional[str] = None) -> None:
+        """Write the server's recent per-connection network stats to a file.
+
+        The last few minutes of ping, traffic, resend and buffering
+        percentiles for current and recently disconnected clients (plus
+        their per-second samples) go to path (by default 'net_stats.json'
+        in the server's user python directory) as json.
+        """
+        from bacommon.servermanager import WriteNetStatsCommand
+        self._enqueue_server_command(WriteNetStatsCommand(path=path))
+
     def restart(self, immediate: bool = True) -> None:
         """Restart the server subprocess.
 
@@ -311,6 +348,21 @@ class ServerManagerApp:
             self._subprocess_force_kill_time = (
                 time.time() + self.IMMEDIATE_SHUTDOWN_TIME_LIMIT)
 
+    def soft_restart(self, immediate: bool = True) -> None:
+        """Restart the server's sessions in-process with a reloaded config.
+
+        Unlike restart(), this keeps the server process (along with its
+        loaded media, Python modules and connected clients) and just starts
+        fresh sessions, so it costs well under a second of downtime. Config
+        values only read at process launch (such as port) need a restart().
+        If 'immediate' is passed as False, this happens at the next clean
+        transition point (the end of a series, etc).
+        """
+        from bacommon.servermanager import SoftRestartCommand
+        self.load_config(strict=False, print_confirmation=True)
+        self._enqueue_server_command(
+            SoftRestartCommand(config=self._config, immediate=immediate))
+
     def shutdown(self, immediate: bool = True) -> None:
         """Shut down the server subprocess and exit the wrapper.
 
@@ -574,6 +626,17 @@ class ServerManagerApp:
         # slight behavior tweaks. Hmm; should this be an argument instead?
         os.environ['BA_SERVER_WRAPPER_MANAGED'] = '1'
 
+        # Threads pick up their scheduling settings as they launch.
+        for envvar, settings in (
+            ('BA_THREAD_AFFINITY', self._config.thread_affinity),
+            ('BA_THREAD_PRIORITY', self._config.thread_priority),
+        ):
+            if settings is None:
+                os.environ.pop(envvar, None)
+            else:
+                os.environ[envvar] = ';'.join(f'{key}={val}'
+                                              for key, val in settings.items())
+
         print(f'{Clr.CYN}Launching server subprocess...{Clr.RST}', flush=True)
         binary_name = ('BallisticaCoreHeadless.exe'
                        if os.name == 'nt' else './ballisticacore_headless')
@@ -359,9 +359,10 @@ void App::PushStringEditCall(const std::string& name, const std::string& value,
   });
 }
 
-void App::PushSetStressTestingCall(bool enable, int player_count) {
-  PushCall([this, enable, player_count] {
-    stress_test_->SetStressTesting(enable, player_count);
+void App::PushSetStressTestingCall(bool enable, int player_count,
+                                   bool churn) {
+  PushCall([this, enable, player_count, churn] {
+    stress_test_->SetStressTesting(enable, player_count, churn);
   });
 }
 
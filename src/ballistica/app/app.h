@@ -115,7 +115,8 @@ class App : public Module {
   auto PushOpenURLCall(const std::string& url) -> void;
   auto PushStringEditCall(const std::string& name, const std::string& value,
                           int max_chars) -> void;
-  auto PushSetStressTestingCall(bool enable, int player_count) -> void;
+  auto PushSetStressTestingCall(bool enable, int player_count, bool churn)
+      -> void;
   auto PushPurchaseCall(const std::string& item) -> void;
   auto PushRestorePurchasesCall() -> void;
   auto PushResetAchievementsCall() -> void;
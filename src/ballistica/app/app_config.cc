@@ -183,6 +183,12 @@ void AppConfig::SetupEntries() {
   float gvrrts_default = g_platform->IsRunningOnDaydream() ? 1.0F : 0.5F;
   float_entries_[FloatID::kGoogleVRRenderTargetScale] =
       FloatEntry("GVR Render Target Scale", gvrrts_default);
+  float_entries_[FloatID::kBGDynamicsStepBudget] =
+      FloatEntry("BG Dynamics Step Budget", 2.0F);
+  float_entries_[FloatID::kCameraRenderScale] =
+      FloatEntry("Camera Render Scale", 1.0F);
+  float_entries_[FloatID::kDynamicResolutionTarget] =
+      FloatEntry("Dynamic Resolution Target", 0.0F);
 
   optional_float_entries_[OptionalFloatID::kIdleExitMinutes] =
       OptionalFloatEntry("Idle Exit Minutes", std::optional<float>());
@@ -213,6 +219,14 @@ void AppConfig::SetupEntries() {
   int_entries_[IntID::kTelnetPort] =
       IntEntry("Telnet Port", kDefaultTelnetPort);
 
+  // In megabytes; zero means no texture budget.
+  int_entries_[IntID::kTextureMemoryBudget] =
+      IntEntry("Texture Memory Budget", 0);
+  int_entries_[IntID::kFrameQueueDepth] = IntEntry("Frame Queue Depth", 1);
+
+  // In megabytes; zero means no overall media budget.
+  int_entries_[IntID::kMediaMemoryBudget] = IntEntry("Media Memory Budget", 0);
+
   bool_entries_[BoolID::kTouchControlsSwipeHidden] =
       BoolEntry("Touch Controls Swipe Hidden", false);
   bool_entries_[BoolID::kFullscreen] = BoolEntry("Fullscreen", false);
@@ -237,6 +251,12 @@ void AppConfig::SetupEntries() {
       BoolEntry("Disable Camera Shake", false);
   bool_entries_[BoolID::kDisableCameraGyro] =
       BoolEntry("Disable Camera Gyro", false);
+  bool_entries_[BoolID::kBGDynamicsDeterministic] =
+      BoolEntry("BG Dynamics Deterministic", false);
+  bool_entries_[BoolID::kShowRenderStats] =
+      BoolEntry("Show Render Stats", false);
+  bool_entries_[BoolID::kSortOpaqueDraws] =
+      BoolEntry("Sort Opaque Draws", true);
 
   // Now add everything to our name map and make sure all is kosher.
   CompleteMap(float_entries_);
@@ -245,7 +265,33 @@ void AppConfig::SetupEntries() {
   CompleteMap(bool_entries_);
 }
 
+void AppConfig::RefreshSnapshot() {
+  assert(InGameThread());
+  auto snapshot = std::make_unique<Snapshot>();
+  for (auto&& i : float_entries_) {
+    snapshot->floats[static_cast<size_t>(i.first)] = i.second.Resolve();
+  }
+  for (auto&& i : optional_float_entries_) {
+    snapshot->optional_floats[static_cast<size_t>(i.first)] =
+        i.second.Resolve();
+  }
+  for (auto&& i : string_entries_) {
+    snapshot->strings[static_cast<size_t>(i.first)] = i.second.Resolve();
+  }
+  for (auto&& i : int_entries_) {
+    snapshot->ints[static_cast<size_t>(i.first)] = i.second.Resolve();
+  }
+  for (auto&& i : bool_entries_) {
+    snapshot->bools[static_cast<size_t>(i.first)] = i.second.Resolve();
+  }
+  snapshot_.store(snapshot.get(), std::memory_order_release);
+  snapshots_.push_back(std::move(snapshot));
+}
+
 auto AppConfig::Resolve(FloatID id) -> float {
+  if (const Snapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+    return snapshot->floats[static_cast<size_t>(id)];
+  }
   auto i = float_entries_.find(id);
   if (i == float_entries_.end()) {
     throw Exception("Invalid config entry");
@@ -254,6 +300,9 @@ auto AppConfig::Resolve(FloatID id) -> float {
 }
 
 auto AppConfig::Resolve(OptionalFloatID id) -> std::optional<float> {
+  if (const Snapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+    return snapshot->optional_floats[static_cast<size_t>(id)];
+  }
   auto i = optional_float_entries_.find(id);
   if (i == optional_float_entries_.end()) {
     throw Exception("Invalid config entry");
@@ -262,6 +311,9 @@ auto AppConfig::Resolve(OptionalFloatID id) -> std::optional<float> {
 }
 
 auto AppConfig::Resolve(StringID id) -> std::string {
+  if (const Snapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+    return snapshot->strings[static_cast<size_t>(id)];
+  }
   auto i = string_entries_.find(id);
   if (i == string_entries_.end()) {
     throw Exception("Invalid config entry");
@@ -270,6 +322,9 @@ auto AppConfig::Resolve(StringID id) -> std::string {
 }
 
 auto AppConfig::Resolve(BoolID id) -> bool {
+  if (const Snapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+    return snapshot->bools[static_cast<size_t>(id)];
+  }
   auto i = bool_entries_.find(id);
   if (i == bool_entries_.end()) {
     throw Exception("Invalid config entry");
@@ -278,6 +333,9 @@ auto AppConfig::Resolve(BoolID id) -> bool {
 }
 
 auto AppConfig::Resolve(IntID id) -> int {
+  if (const Snapshot* snapshot = snapshot_.load(std::memory_order_acquire)) {
+    return snapshot->ints[static_cast<size_t>(id)];
+  }
   auto i = int_entries_.find(id);
   if (i == int_entries_.end()) {
     throw Exception("Invalid config entry");
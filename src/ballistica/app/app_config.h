@@ -3,6 +3,8 @@
 #ifndef BALLISTICA_APP_APP_CONFIG_H_
 #define BALLISTICA_APP_APP_CONFIG_H_
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <optional>
@@ -12,9 +14,10 @@
 namespace ballistica {
 
 // This class wrangles user config values for the app.
-// The underlying config data currently lives in the Python layer,
-// so at the moment these calls are only usable from the game thread,
-// but that may change in the future.
+// The underlying config data currently lives in the Python layer, but
+// resolved values for all our official entries get copied into a typed
+// snapshot each time the config is applied; Resolve() calls read from that
+// and so are usable from any thread without touching Python.
 class AppConfig {
  public:
   // Our official config values:
@@ -28,6 +31,9 @@ class AppConfig {
     kSoundVolume,
     kMusicVolume,
     kGoogleVRRenderTargetScale,
+    kBGDynamicsStepBudget,
+    kCameraRenderScale,
+    kDynamicResolutionTarget,
     kLast  // Sentinel.
   };
 
@@ -52,6 +58,9 @@ class AppConfig {
   enum class IntID {
     kPort,
     kTelnetPort,
+    kTextureMemoryBudget,
+    kFrameQueueDepth,
+    kMediaMemoryBudget,
     kLast  // Sentinel.
   };
 
@@ -69,6 +78,9 @@ class AppConfig {
     kEnableTelnet,
     kDisableCameraShake,
     kDisableCameraGyro,
+    kBGDynamicsDeterministic,
+    kShowRenderStats,
+    kSortOpaqueDraws,
     kLast  // Sentinel.
   };
 
@@ -97,7 +109,15 @@ class AppConfig {
   static void Init();
   AppConfig();
 
+  // Re-resolve all official values from the Python config into a new
+  // snapshot. Must be called from the game thread; happens whenever the
+  // config is applied.
+  auto RefreshSnapshot() -> void;
+
   // Given specific ids, returns resolved values (fastest access).
+  // These come from the latest snapshot, so changes made to the Python
+  // config won't show up here until it is applied. Before the first
+  // snapshot they are resolved directly (game thread only).
   auto Resolve(FloatID id) -> float;
   auto Resolve(OptionalFloatID id) -> std::optional<float>;
   auto Resolve(StringID id) -> std::string;
@@ -128,6 +148,21 @@ class AppConfig {
   template <typename T>
   void CompleteMap(const T& entry_map);
   void SetupEntries();
+
+  struct Snapshot {
+    std::array<float, static_cast<size_t>(FloatID::kLast)> floats{};
+    std::array<std::optional<float>,
+               static_cast<size_t>(OptionalFloatID::kLast)>
+        optional_floats{};
+    std::array<std::string, static_cast<size_t>(StringID::kLast)> strings{};
+    std::array<int, static_cast<size_t>(IntID::kLast)> ints{};
+    std::array<bool, static_cast<size_t>(BoolID::kLast)> bools{};
+  };
+
+  // Readers on other threads may still be looking at older snapshots, so
+  // we hang on to all of them (applies are rare and these are small).
+  std::atomic<const Snapshot*> snapshot_{};
+  std::vector<std::unique_ptr<Snapshot> > snapshots_;
   std::map<std::string, const Entry*> entries_by_name_;
   std::map<FloatID, FloatEntry> float_entries_;
   std::map<OptionalFloatID, OptionalFloatEntry> optional_float_entries_;
@@ -89,6 +89,47 @@ class AppGlobals {
   Object* object_list_first{};
   int object_count{0};
 #endif
+
+  // Headless only: step sessions as fast as possible instead of tracking
+  // real-time (for offline replay processing, bot matches, etc).
+  bool turbo_mode{};
+
+  // Threads used to solve independent physics islands in game scenes
+  // (results are identical regardless; this only affects speed).
+  int physics_island_threads{1};
+
+  // Collision-space type for game scenes (non-hash types get sized to map
+  // bounds when those are set).
+  PhysicsBroadphase physics_broadphase{PhysicsBroadphase::kHash};
+
+  // Draw rigid bodies blended between their last two step states so
+  // motion looks smooth at frame rates above the sim rate (costs up to
+  // one sim step of visual latency).
+  bool physics_render_interpolation{};
+
+  // Fully compute background-dynamics terrain caches for each map we load
+  // and write them out next to its collide-model (an asset build step).
+  bool write_bg_terrain_caches{};
+
+  // Default solver settings for game scene physics; activities can
+  // override these for their own scene (see Dynamics::SetSolverSettings).
+  // Fewer iterations trade stacking/contact accuracy for CPU.
+  int physics_solver_iterations{10};
+  float physics_solver_sor{1.3f};
+  float physics_contact_surface_layer{0.001f};
+  float physics_max_correcting_vel{-1.0f};  // Negative means unlimited.
+
+  // GUI only: if set, every rendered frame gets written here as raw RGBA
+  // (bottom row first) and game time advances exactly 1000/capture_fps
+  // ms per frame instead of tracking real-time, so a replay can be
+  // rendered to video as fast as the GPU allows. Point it at a pipe
+  // feeding an encoder.
+  std::string capture_path;
+  int capture_fps{60};
+
+  // Headless only: stop stepping sessions while no clients have been
+  // connected for a while (see Game::UpdateHeadlessIdle()).
+  bool headless_idle_pause{true};
 };
 
 }  // namespace ballistica
@@ -0,0 +1,178 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/app/config_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ballistica/platform/platform.h"
+
+namespace ballistica {
+
+// We write once commits have stopped coming in for this long...
+const int kConfigWriteQuietMilliseconds = 250;
+
+// ...but never hold off longer than this after the first one.
+const int kConfigWriteMaxDelayMilliseconds = 2000;
+
+struct ConfigWriterState {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool thread_started{};
+  bool has_pending{};
+  std::string pending;
+  uint64_t pending_number{};
+  std::chrono::steady_clock::time_point first_commit_time;
+  std::chrono::steady_clock::time_point last_commit_time;
+
+  // Held while writing; writes of older contents than the last written
+  // get skipped (a flush can overtake our thread).
+  std::mutex write_mutex;
+  uint64_t written_number{};
+};
+static ConfigWriterState* g_config_writer{};
+
+static auto GetConfigWriterState() -> ConfigWriterState* {
+  // Commits all come from the game thread, so no race here.
+  if (g_config_writer == nullptr) {
+    g_config_writer = new ConfigWriterState();
+  }
+  return g_config_writer;
+}
+
+static void WriteConfigFile(ConfigWriterState* state,
+                            const std::string& contents, uint64_t number) {
+  std::lock_guard<std::mutex> lock(state->write_mutex);
+  if (number <= state->written_number) {
+    return;
+  }
+  state->written_number = number;
+
+  std::string path = g_platform->GetConfigFilePath();
+  std::string path_temp = path + ".tmp";
+  std::string path_prev = path + ".prev";
+  FILE* f_out = g_platform->FOpen(path_temp.c_str(), "wb");
+  if (f_out == nullptr) {
+    Log("Error: Unable to open config file for writing: '" + path_temp
+        + "': " + g_platform->GetErrnoString());
+    return;
+  }
+
+  // Write to temp file.
+  size_t result = fwrite(&contents[0], contents.size(), 1, f_out);
+  if (result != 1) {
+    fclose(f_out);
+    Log("Error: Unable to write config file to '" + path_temp
+        + "': " + g_platform->GetErrnoString());
+    return;
+  }
+  fclose(f_out);
+
+  // Now backup any existing config to .prev.
+  if (g_platform->FilePathExists(path)) {
+    // On windows, rename doesn't overwrite existing files.. need to kill
+    // the old explicitly.
+    // (hmm; should we just do this everywhere for consistency?)
+    if (g_buildconfig.ostype_windows()) {
+      if (g_platform->FilePathExists(path_prev)) {
+        if (g_platform->Remove(path_prev.c_str()) != 0) {
+          Log("Error: Unable to remove prev config file '" + path_prev
+              + "': " + g_platform->GetErrnoString());
+          return;
+        }
+      }
+    }
+    if (g_platform->Rename(path.c_str(), path_prev.c_str()) != 0) {
+      Log("Error: Unable to back up config file to '" + path_prev
+          + "': " + g_platform->GetErrnoString());
+      return;
+    }
+  }
+
+  // Now move temp into place.
+  if (g_platform->Rename(path_temp.c_str(), path.c_str()) != 0) {
+    Log("Error: Unable to rename temp config file to final '" + path
+        + "': " + g_platform->GetErrnoString());
+  }
+}
+
+static void RunConfigWriter(ConfigWriterState* state) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  while (true) {
+    state->cv.wait(lock, [state] { return state->has_pending; });
+
+    // Hold off until commits go quiet for a bit.
+    while (state->has_pending) {
+      auto deadline = std::min(
+          state->last_commit_time
+              + std::chrono::milliseconds(kConfigWriteQuietMilliseconds),
+          state->first_commit_time
+              + std::chrono::milliseconds(kConfigWriteMaxDelayMilliseconds));
+      if (std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      state->cv.wait_until(lock, deadline);
+    }
+
+    // May have been flushed out from under us in the meantime.
+    if (!state->has_pending) {
+      continue;
+    }
+    std::string contents = std::move(state->pending);
+    uint64_t number = state->pending_number;
+    state->pending.clear();
+    state->has_pending = false;
+    lock.unlock();
+    WriteConfigFile(state, contents, number);
+    lock.lock();
+  }
+}
+
+void ConfigWriter::Commit(const std::string& contents) {
+  ConfigWriterState* state = GetConfigWriterState();
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (!state->has_pending) {
+      state->first_commit_time = now;
+    }
+    state->last_commit_time = now;
+    state->pending = contents;
+    state->pending_number++;
+    state->has_pending = true;
+    if (!state->thread_started) {
+      state->thread_started = true;
+      std::thread(RunConfigWriter, state).detach();
+    }
+  }
+  state->cv.notify_one();
+}
+
+void ConfigWriter::Flush() {
+  ConfigWriterState* state = g_config_writer;
+  if (state == nullptr) {
+    return;
+  }
+  std::string contents;
+  uint64_t number;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->has_pending) {
+      // Our thread may be mid-write; wait for it.
+      std::lock_guard<std::mutex> write_lock(state->write_mutex);
+      return;
+    }
+    contents = std::move(state->pending);
+    number = state->pending_number;
+    state->pending.clear();
+    state->has_pending = false;
+  }
+  WriteConfigFile(state, contents, number);
+}
+
+}  // namespace ballistica
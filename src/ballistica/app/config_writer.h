@@ -0,0 +1,29 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_APP_CONFIG_WRITER_H_
+#define BALLISTICA_APP_CONFIG_WRITER_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Writes the app config to disk from a background thread. Commits that
+/// come in quick succession (such as from dragging a settings slider)
+/// coalesce into a single write of the latest contents, which goes to a
+/// temp file first and is then renamed into place, with the previous
+/// config kept alongside as a '.prev' backup.
+class ConfigWriter {
+ public:
+  /// Queue contents to be written, replacing any not yet written.
+  static void Commit(const std::string& contents);
+
+  /// Write any pending contents immediately, returning once they're on
+  /// disk. Called when the app is pausing or shutting down.
+  static void Flush();
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_APP_CONFIG_WRITER_H_
@@ -0,0 +1,334 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/app/microbenchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "ballistica/app/app_globals.h"
+#include "ballistica/generic/huffman.h"
+#include "ballistica/generic/json_stream.h"
+#include "ballistica/generic/lambda_runnable.h"
+#include "ballistica/generic/timer_list.h"
+#include "ballistica/generic/utils.h"
+#include "ballistica/graphics/render_command_buffer.h"
+#include "ballistica/math/matrix44f.h"
+#include "ode/ode.h"
+
+namespace ballistica {
+
+// Each benchmark runs this many times and reports its fastest run, which
+// filters out most scheduling noise.
+const int kMicrobenchmarkRuns = 5;
+
+class MicrobenchmarkObject : public Object {
+ public:
+  int value{};
+};
+
+// Keeps the optimizer from throwing away work whose results we ignore.
+static volatile uint64_t g_microbenchmark_sink{};
+
+// Fastest of our runs of f (which does ops operations), in ns per op.
+template <typename F>
+static auto TimeBest(int ops, F&& f) -> double {
+  double best{-1.0};
+  for (int run = 0; run < kMicrobenchmarkRuns; run++) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count()
+                / ops;
+    if (best < 0.0 || ns < best) {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+static void AddResult(JsonWriter* writer, const char* name, double ns_per_op,
+                      int ops) {
+  writer->Key(name)
+      .BeginObject()
+      .Key("ns_per_op")
+      .Number(ns_per_op)
+      .Key("ops")
+      .Int(ops)
+      .EndObject();
+}
+
+// Packet-sized data skewed towards small values the way our stream
+// messages are.
+static auto MakeHuffmanInput() -> std::vector<uint8_t> {
+  std::vector<uint8_t> data(512);
+  uint32_t seed = 12345;
+  for (auto&& val : data) {
+    seed = seed * 1664525u + 1013904223u;
+    uint32_t r = seed >> 24;
+    val = static_cast<uint8_t>(r < 160 ? r % 8 : r);
+  }
+
+  // (our compressor claims the top bit of the first byte)
+  data[0] &= 0x7F;
+  return data;
+}
+
+static void RunHuffmanBenchmarks(JsonWriter* writer) {
+  Huffman huffman;
+  std::vector<uint8_t> input = MakeHuffmanInput();
+  std::vector<uint8_t> compressed = huffman.compress(input);
+  const int kOps = 2000;
+  AddResult(writer, "huffman_compress_512b", TimeBest(kOps, [&] {
+              for (int i = 0; i < kOps; i++) {
+                g_microbenchmark_sink += huffman.compress(input).size();
+              }
+            }),
+            kOps);
+  AddResult(writer, "huffman_decompress_512b", TimeBest(kOps, [&] {
+              for (int i = 0; i < kOps; i++) {
+                g_microbenchmark_sink += huffman.decompress(compressed).size();
+              }
+            }),
+            kOps);
+}
+
+static void RunTimerListBenchmarks(JsonWriter* writer) {
+  const int kOps = 10000;
+  const TimerMedium kSpan = 10000;
+  auto runnable = NewLambdaRunnable([] { g_microbenchmark_sink++; });
+  uint32_t seed = 12345;
+  auto next_length = [&seed, kSpan] {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<TimerMedium>(1 + (seed >> 8) % kSpan);
+  };
+  AddResult(writer, "timer_list_insert", TimeBest(kOps, [&] {
+              TimerList list;
+              for (int i = 0; i < kOps; i++) {
+                list.NewTimer(0, next_length(), 0, 0, runnable);
+              }
+            }),
+            kOps);
+
+  // Time firing separately from setting up.
+  double best{-1.0};
+  for (int run = 0; run < kMicrobenchmarkRuns; run++) {
+    TimerList list;
+    for (int i = 0; i < kOps; i++) {
+      list.NewTimer(0, next_length(), 0, 0, runnable);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (TimerMedium t = 0; t <= kSpan; t += 16) {
+      list.Run(t);
+    }
+    list.Run(kSpan);
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count()
+                / kOps;
+    best = (best < 0.0) ? ns : std::min(best, ns);
+  }
+  AddResult(writer, "timer_list_expire", best, kOps);
+}
+
+static void RunObjectBenchmarks(JsonWriter* writer) {
+  const int kOps = 100000;
+  AddResult(writer, "object_new_release", TimeBest(kOps, [&] {
+              for (int i = 0; i < kOps; i++) {
+                auto obj = Object::New<MicrobenchmarkObject>();
+                g_microbenchmark_sink += obj->value;
+              }
+            }),
+            kOps);
+  auto obj = Object::New<MicrobenchmarkObject>();
+  AddResult(writer, "object_ref_copy", TimeBest(kOps, [&] {
+              for (int i = 0; i < kOps; i++) {
+                Object::Ref<MicrobenchmarkObject> ref(obj);
+                g_microbenchmark_sink += ref->value;
+              }
+            }),
+            kOps);
+  AddResult(writer, "object_weak_ref_copy", TimeBest(kOps, [&] {
+              for (int i = 0; i < kOps; i++) {
+                Object::WeakRef<MicrobenchmarkObject> ref(obj);
+                g_microbenchmark_sink += ref->value;
+              }
+            }),
+            kOps);
+}
+
+static void RunRenderCommandBufferBenchmarks(JsonWriter* writer) {
+  // Roughly what a simple component draw puts in per element.
+  const int kOps = 20000;
+  RenderCommandBuffer buffer;
+  auto encode = [&buffer, kOps] {
+    buffer.Reset();
+    for (int i = 0; i < kOps; i++) {
+      buffer.PutCommand(RenderCommandBuffer::Command::kPushTransform);
+      buffer.PutCommand(RenderCommandBuffer::Command::kTranslate3);
+      buffer.PutFloats(1.0f, 2.0f, 3.0f);
+      buffer.PutCommand(RenderCommandBuffer::Command::kScaleUniform);
+      buffer.PutFloat(0.5f);
+      buffer.PutCommand(RenderCommandBuffer::Command::kPopTransform);
+    }
+    buffer.Finalize();
+  };
+  AddResult(writer, "render_command_buffer_encode", TimeBest(kOps, encode),
+            kOps);
+  AddResult(writer, "render_command_buffer_decode", TimeBest(kOps, [&] {
+              buffer.ReadBegin();
+              float x, y, z;
+              while (true) {
+                RenderCommandBuffer::Command c = buffer.GetCommand();
+                if (c == RenderCommandBuffer::Command::kEnd) {
+                  break;
+                }
+                if (c == RenderCommandBuffer::Command::kTranslate3) {
+                  buffer.GetFloats(&x, &y, &z);
+                  g_microbenchmark_sink += static_cast<uint64_t>(x + y + z);
+                } else if (c == RenderCommandBuffer::Command::kScaleUniform) {
+                  g_microbenchmark_sink +=
+                      static_cast<uint64_t>(buffer.GetFloat());
+                }
+              }
+            }),
+            kOps);
+}
+
+static void RunMatrixBenchmarks(JsonWriter* writer) {
+  const int kOps = 100000;
+  Matrix44f a = Matrix44fRotate(Vector3f(0.0f, 1.0f, 0.0f), 30.0f)
+                * Matrix44fTranslate(1.0f, 2.0f, 3.0f);
+  Matrix44f b = Matrix44fRotate(Vector3f(1.0f, 0.0f, 0.0f), 15.0f);
+  AddResult(writer, "matrix44f_multiply", TimeBest(kOps, [&] {
+              Matrix44f m = a;
+              for (int i = 0; i < kOps; i++) {
+                m = m * b;
+              }
+              g_microbenchmark_sink += static_cast<uint64_t>(m.m[0] * 10.0f);
+            }),
+            kOps);
+  AddResult(writer, "matrix44f_inverse", TimeBest(kOps, [&] {
+              Matrix44f m = a;
+              for (int i = 0; i < kOps; i++) {
+                m = m.Inverse();
+              }
+              g_microbenchmark_sink += static_cast<uint64_t>(m.m[0] * 10.0f);
+            }),
+            kOps);
+  AddResult(writer, "matrix44f_transform_point", TimeBest(kOps, [&] {
+              Vector3f v(1.0f, 2.0f, 3.0f);
+              for (int i = 0; i < kOps; i++) {
+                v = a * v;
+              }
+              g_microbenchmark_sink += static_cast<uint64_t>(v.x);
+            }),
+            kOps);
+}
+
+static void RunUTF8Benchmarks(JsonWriter* writer) {
+  // A chat-message-sized mix of ascii and multi-byte characters.
+  std::string text;
+  for (int i = 0; i < 8; i++) {
+    text += "Player joined: ";
+    text += "\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+  }
+  const int kOps = 20000;
+  AddResult(writer, "utf8_decode_200b", TimeBest(kOps, [&] {
+              for (int i = 0; i < kOps; i++) {
+                g_microbenchmark_sink +=
+                    Utils::UnicodeFromUTF8(text, "microbenchmark").size();
+              }
+            }),
+            kOps);
+}
+
+struct MicrobenchmarkPhysics {
+  dWorldID world;
+  dJointGroupID contact_group;
+};
+
+static void MicrobenchmarkNearCallback(void* data, dGeomID o1, dGeomID o2) {
+  auto* physics = static_cast<MicrobenchmarkPhysics*>(data);
+  dContact contacts[4];
+  int count = dCollide(o1, o2, 4, &contacts[0].geom, sizeof(dContact));
+  for (int i = 0; i < count; i++) {
+    contacts[i].surface.mode = dContactApprox1;
+    contacts[i].surface.mu = 1.0f;
+    dJointID joint = dJointCreateContact(physics->world,
+                                         physics->contact_group, &contacts[i]);
+    dJointAttach(joint, dGeomGetBody(o1), dGeomGetBody(o2));
+  }
+}
+
+// A pile of boxes and spheres dropped onto a plane, stepped with our game
+// scene solver settings.
+static void RunPhysicsBenchmarks(JsonWriter* writer) {
+  const int kOps = 250;
+  const int kBodyCount = 60;
+  double best{-1.0};
+  for (int run = 0; run < kMicrobenchmarkRuns; run++) {
+    MicrobenchmarkPhysics physics{};
+    physics.world = dWorldCreate();
+    physics.contact_group = dJointGroupCreate(0);
+    dSpaceID space = dHashSpaceCreate(nullptr);
+    dWorldSetGravity(physics.world, 0.0f, -20.0f, 0.0f);
+    dWorldSetQuickStepNumIterations(physics.world,
+                                    g_app_globals->physics_solver_iterations);
+    dWorldSetQuickStepW(physics.world, g_app_globals->physics_solver_sor);
+    dWorldSetContactSurfaceLayer(physics.world,
+                                 g_app_globals->physics_contact_surface_layer);
+    dCreatePlane(space, 0.0f, 1.0f, 0.0f, 0.0f);
+    for (int i = 0; i < kBodyCount; i++) {
+      dBodyID body = dBodyCreate(physics.world);
+      dMass mass;
+      dGeomID geom;
+      if (i % 2) {
+        geom = dCreateBox(space, 0.5f, 0.5f, 0.5f);
+        dMassSetBox(&mass, 1.0f, 0.5f, 0.5f, 0.5f);
+      } else {
+        geom = dCreateSphere(space, 0.3f);
+        dMassSetSphere(&mass, 1.0f, 0.3f);
+      }
+      dBodySetMass(body, &mass);
+      dGeomSetBody(geom, body);
+      dBodySetPosition(body, static_cast<float>(i % 5) * 0.6f,
+                       0.5f + static_cast<float>(i / 5) * 0.6f,
+                       static_cast<float>(i % 3) * 0.2f);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kOps; i++) {
+      dSpaceCollide(space, &physics, MicrobenchmarkNearCallback);
+      dWorldQuickStep(physics.world, kGameStepSeconds);
+      dJointGroupEmpty(physics.contact_group);
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count()
+                / kOps;
+    best = (best < 0.0) ? ns : std::min(best, ns);
+    dSpaceDestroy(space);
+    dJointGroupDestroy(physics.contact_group);
+    dWorldDestroy(physics.world);
+  }
+  AddResult(writer, "physics_step_60_bodies", best, kOps);
+}
+
+auto Microbenchmarks::Run() -> std::string {
+  assert(InGameThread());
+  JsonWriter writer;
+  writer.BeginObject().Key("runs").Int(kMicrobenchmarkRuns).Key("results");
+  writer.BeginObject();
+  RunHuffmanBenchmarks(&writer);
+  RunTimerListBenchmarks(&writer);
+  RunObjectBenchmarks(&writer);
+  RunRenderCommandBufferBenchmarks(&writer);
+  RunMatrixBenchmarks(&writer);
+  RunUTF8Benchmarks(&writer);
+  RunPhysicsBenchmarks(&writer);
+  writer.EndObject().EndObject();
+  return writer.str();
+}
+
+}  // namespace ballistica
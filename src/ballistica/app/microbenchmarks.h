@@ -0,0 +1,26 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_APP_MICROBENCHMARKS_H_
+#define BALLISTICA_APP_MICROBENCHMARKS_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Times the low-level primitives hot paths are built on (compression,
+/// timer lists, object refs, render command buffers, matrix math, utf-8
+/// decoding and physics stepping) in isolation, so regressions in them
+/// show up across builds without the noise of a full game benchmark.
+/// Runs synchronously for a few seconds. Game thread only.
+class Microbenchmarks {
+ public:
+  /// Run everything and return results as a json object (nanoseconds per
+  /// operation for each benchmark; best of several runs).
+  static auto Run() -> std::string;
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_APP_MICROBENCHMARKS_H_
@@ -8,10 +8,12 @@
 
 namespace ballistica {
 
-void StressTest::SetStressTesting(bool enable, int player_count) {
+void StressTest::SetStressTesting(bool enable, int player_count,
+                                  bool churn) {
   bool was_stress_testing = stress_testing_;
   stress_testing_ = enable;
   stress_test_player_count_ = player_count;
+  stress_test_churn_ = churn;
 
   // If we're turning on, reset our intervals and things.
   if (!was_stress_testing && stress_testing_) {
@@ -35,7 +37,8 @@ void StressTest::Update() {
   // If we're currently running stress-tests, update that stuff.
   if (stress_testing_ && g_input) {
     // Update our fake inputs to make our dudes run around.
-    g_input->ProcessStressTesting(stress_test_player_count_);
+    g_input->ProcessStressTesting(stress_test_player_count_,
+                                  stress_test_churn_);
 
     // Every 10 seconds update our stress-test stats.
     millisecs_t t = GetRealTime();
@@ -16,13 +16,14 @@ class StressTest {
   // This used to get run from RunEvents() in App.
   void Update();
 
-  void SetStressTesting(bool enable, int player_count);
+  void SetStressTesting(bool enable, int player_count, bool churn);
 
  private:
   FILE* stress_test_stats_file_{};
   millisecs_t last_stress_test_update_time_{};
   bool stress_testing_{};
   int stress_test_player_count_{8};
+  bool stress_test_churn_{true};
   int last_total_frames_rendered_{};
 };
 
@@ -29,6 +29,10 @@ namespace ballistica {
 const int kAudioStreamBufferSize = 4096 * 8;
 const int kAudioStreamBufferCount = 7;
 
+// How many buffers' worth of audio streamers decode ahead in the
+// background.
+const int kAudioStreamDecodeAheadCount = 8;
+
 // Some OpenAL Error handling utils.
 auto GetALErrorString(ALenum err) -> const char*;
 
@@ -16,6 +16,7 @@ void Audio::Init() {
   g_audio = new Audio();
 }
 
+#if BA_ENABLE_AUDIO
 void Audio::Reset() {
   assert(InGameThread());
   g_audio_server->PushResetCall();
@@ -40,12 +41,11 @@ void Audio::SetListenerOrientation(const Vector3f& forward,
 
 // This stops a particular sound play ID only.
 void Audio::PushSourceStopSoundCall(uint32_t play_id) {
-  g_audio_server->PushCall([play_id] { g_audio_server->StopSound(play_id); });
+  g_audio_server->PushStopSoundCall(play_id);
 }
 
 void Audio::PushSourceFadeOutCall(uint32_t play_id, uint32_t time) {
-  g_audio_server->PushCall(
-      [play_id, time] { g_audio_server->FadeSoundOut(play_id, time); });
+  g_audio_server->PushFadeSoundOutCall(play_id, time);
 }
 
 // Seems we get a false alarm here.
@@ -122,12 +122,16 @@ auto Audio::SourceBeginExisting(uint32_t play_id, int debug_id)
   return nullptr;
 }
 
+#endif  // BA_ENABLE_AUDIO
+
 auto Audio::ShouldPlay(SoundData* sound) -> bool {
   millisecs_t time = GetRealTime();
   assert(sound);
   return (time - sound->last_play_time() > 50);
 }
 
+#if BA_ENABLE_AUDIO
+
 void Audio::PlaySound(SoundData* sound, float volume) {
   assert(InGameThread());
   BA_DEBUG_FUNCTION_TIMER_BEGIN();
@@ -174,6 +178,8 @@ void Audio::PlaySoundAtPosition(SoundData* sound, float volume, float x,
   }
 }
 
+#endif  // BA_ENABLE_AUDIO
+
 void Audio::AddClientSource(AudioSource* source) {
   client_sources_.push_back(source);
 }
@@ -17,8 +17,9 @@ namespace ballistica {
 class Audio {
  public:
   static void Init();
-  void Reset();
 
+#if BA_ENABLE_AUDIO
+  void Reset();
   void SetVolumes(float music_volume, float sound_volume);
 
   void SetListenerPosition(const Vector3f& p);
@@ -46,15 +47,34 @@ class Audio {
   void PlaySoundAtPosition(SoundData* sound, float volume, float x, float y,
                            float z);
 
+  // Hmm; shouldn't these be accessed through the Source class?
+  void PushSourceFadeOutCall(uint32_t play_id, uint32_t time);
+  void PushSourceStopSoundCall(uint32_t play_id);
+#else
+  // Builds without audio (headless servers) have no backend at all; these
+  // are all no-ops that compile away at the call site.
+  void Reset() {}
+  void SetVolumes(float music_volume, float sound_volume) {}
+  void SetListenerPosition(const Vector3f& p) {}
+  void SetListenerOrientation(const Vector3f& forward, const Vector3f& up) {}
+  void SetSoundPitch(float pitch) {}
+  auto SourceBeginNew() -> AudioSource* { return nullptr; }
+  auto SourceBeginExisting(uint32_t play_id, int debug_id) -> AudioSource* {
+    return nullptr;
+  }
+  auto IsSoundPlaying(uint32_t play_id) -> bool { return false; }
+  void PlaySound(SoundData* s, float volume = 1.0f) {}
+  void PlaySoundAtPosition(SoundData* sound, float volume, float x, float y,
+                           float z) {}
+  void PushSourceFadeOutCall(uint32_t play_id, uint32_t time) {}
+  void PushSourceStopSoundCall(uint32_t play_id) {}
+#endif  // BA_ENABLE_AUDIO
+
   // Call this if you want to prevent repeated plays of the same sound. It'll
   // tell you if the sound has been played recently.  The one-shot sound-play
   // functions use this under the hood. (PlaySound, PlaySoundAtPosition).
   auto ShouldPlay(SoundData* s) -> bool;
 
-  // Hmm; shouldn't these be accessed through the Source class?
-  void PushSourceFadeOutCall(uint32_t play_id, uint32_t time);
-  void PushSourceStopSoundCall(uint32_t play_id);
-
   void AddClientSource(AudioSource* source);
 
   void MakeSourceAvailable(AudioSource* source);
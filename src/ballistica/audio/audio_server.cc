@@ -2,12 +2,17 @@
 
 #include "ballistica/audio/audio_server.h"
 
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
 #include "ballistica/app/app_globals.h"
 #include "ballistica/audio/al_sys.h"
 #include "ballistica/audio/audio.h"
 #include "ballistica/audio/audio_source.h"
 #include "ballistica/audio/audio_streamer.h"
 #include "ballistica/audio/ogg_stream.h"
+#include "ballistica/core/event_trace.h"
 #include "ballistica/game/game.h"
 #include "ballistica/generic/timer.h"
 #include "ballistica/math/vector3f.h"
@@ -34,14 +39,109 @@ const int kAudioProcessIntervalFade = 50;
 const int kAudioProcessIntervalPendingLoad = 1;
 const bool kShowInUseSounds = false;
 
+// We hand out more voices than we have OpenAL sources; voices without a
+// source keep 'playing' silently and get one back if they become more
+// audible than something that has one.
+const int kVoiceCount = 64;
+const int kTargetALSourceCount = 30;
+
+// How much more audible a voice has to be to take another's source.
+// (Keeps similar voices from trading back and forth).
+const float kVoiceStealMargin = 1.5f;
+
+// Music comes first, then non-positional stuff (UI sounds and such that
+// the player is directly interacting with), then everything else by how
+// loud it should sound.
+const float kMusicVoicePriority = 1000.0f;
+const float kNonPositionalVoicePriority = 2.0f;
+
+// Distance attenuation we have OpenAL apply (AL_INVERSE_DISTANCE_CLAMPED).
+const float kSourceMaxDistance = 100.0f;
+const float kSourceRolloffFactor = 0.3f;
+const float kSourceReferenceDistance = 5.0f;
+
+// In vr mode we keep the microphone a bit closer to the camera
+// for realism purposes, so we need stuff louder in general.
+const float kSourceReferenceDistanceVR = 7.5f;
+
+// How many source commands can be in flight to the audio thread at once.
+// (A flush that doesn't fit leaves the rest for the next one).
+const uint32_t kSourceCommandRingSize = 2048;
+
 int AudioServer::al_source_count_ = 0;
 
+/// A single settings change for a source (or the listener). These are
+/// plain data so they can pass through our command ring as-is.
+struct AudioServer::SourceCommand {
+  enum class Type : uint8_t {
+    kSetIsMusic,
+    kSetPositional,
+    kSetPosition,
+    kSetGain,
+    kSetFade,
+    kSetLooping,
+    kPlay,
+    kStop,
+    kEnd,
+    kStopSound,
+    kFadeSoundOut,
+    kSetListenerPosition,
+    kSetListenerOrientation
+  };
+  Type type;
+  uint32_t play_id;
+  float vals[6];
+  Object::Ref<SoundData>* sound;
+};
+
 struct AudioServer::Impl {
   Impl() = default;
   ~Impl() = default;
 
+  /// Copy as many commands as will fit into the ring (game thread only).
+  auto WriteCommands(const SourceCommand* cmds, size_t count) -> size_t {
+    uint32_t head = ring_head_.load(std::memory_order_relaxed);
+    uint32_t tail = ring_tail_.load(std::memory_order_acquire);
+    size_t room = kSourceCommandRingSize - (head - tail);
+    count = std::min(count, room);
+    for (size_t i = 0; i < count; i++) {
+      ring_[(head + i) % kSourceCommandRingSize] = cmds[i];
+    }
+    ring_head_.store(head + static_cast<uint32_t>(count),
+                     std::memory_order_release);
+    return count;
+  }
+
+  /// Pull the next command from the ring (audio thread only).
+  auto ReadCommand(SourceCommand* cmd) -> bool {
+    uint32_t tail = ring_tail_.load(std::memory_order_relaxed);
+    if (tail == ring_head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *cmd = ring_[tail % kSourceCommandRingSize];
+    ring_tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Commands issued by the game thread since its last flush, and where
+  // the latest mergeable one for each source/type pair sits among them.
+  std::vector<SourceCommand> pending_commands_;
+  std::unordered_map<uint64_t, size_t> pending_command_indices_;
+
+  // Single-producer/single-consumer ring carrying commands from the game
+  // thread to the audio thread. Indices count up forever and wrap.
+  SourceCommand ring_[kSourceCommandRingSize]{};
+  std::atomic<uint32_t> ring_head_{};
+  std::atomic<uint32_t> ring_tail_{};
+
+  // Whether a call to drain the ring is already on its way.
+  std::atomic<bool> drain_pushed_{};
+
 #if BA_ENABLE_AUDIO
   ALCcontext* alc_context_{};
+
+  // OpenAL sources not currently attached to a voice.
+  std::vector<ALuint> free_al_sources_;
 #endif
 };
 
@@ -49,10 +149,9 @@ struct AudioServer::Impl {
 class AudioServer::ThreadSource : public Object {
  public:
   // The id is returned as the lo-word of the identifier
-  // returned by "play". If valid is returned as false, there are no
-  // hardware channels available (or another error) and the source should
-  // not be used.
-  ThreadSource(AudioServer* audio_thread, int id, bool* valid);
+  // returned by "play". Sources start out virtual (without an OpenAL
+  // source); the server attaches one when we're worth hearing.
+  ThreadSource(AudioServer* audio_thread, int id);
   ~ThreadSource() override;
   void Reset() {
     SetIsMusic(false);
@@ -98,13 +197,31 @@ class AudioServer::ThreadSource : public Object {
   void ExecPlay();
   void Update();
 
+#if BA_ENABLE_AUDIO
+  auto has_al_source() const -> bool { return has_al_source_; }
+  void AttachALSource(ALuint source);
+  auto DetachALSource() -> ALuint;
+#endif
+
+  /// How much we matter right now; the server gives its OpenAL sources
+  /// to whoever scores highest.
+  auto GetAudibility() const -> float;
+
+  /// Whether we're still wanting to be heard but have no source.
+  auto IsVirtuallyPlaying() const -> bool;
+
+  /// Start playback on a newly attached source, picking up where we'd be
+  /// if we'd been playing all along.
+  void Revive();
+
  private:
+  void StartPlayback(millisecs_t offset);
+  auto GetPlayTime() const -> millisecs_t;
   bool looping_ = false;
   std::unique_ptr<AudioSource> client_source_;
   float fade_ = 1.0f;
   float gain_ = 1.0f;
   AudioServer* audio_thread_;
-  bool valid_ = false;
   const Object::Ref<SoundData>* source_sound_ = nullptr;
   int id_;
   uint32_t play_count_ = 0;
@@ -112,9 +229,21 @@ class AudioServer::ThreadSource : public Object {
   bool want_to_play_ = false;
 #if BA_ENABLE_AUDIO
   ALuint source_ = 0;
+  bool has_al_source_ = false;
 #endif
   bool is_streamed_ = false;
 
+  // We keep our own copy of everything we've told OpenAL so it can be
+  // reapplied when we get a source back.
+  bool positional_ = true;
+  float position_[3]{};
+
+  // When the current sound started and how long it lasts in real time
+  // (at the pitch it started at). Used to keep virtual voices in sync.
+  millisecs_t play_start_time_ = 0;
+  millisecs_t play_duration_ = 0;
+  float play_pitch_ = 1.0f;
+
   /// Whether we should be designated as "music" next time we play.
   bool is_music_ = false;
 
@@ -195,129 +324,243 @@ void AudioServer::SetPaused(bool pause) {
 }
 
 void AudioServer::PushSourceSetIsMusicCall(uint32_t play_id, bool val) {
-  PushCall([this, play_id, val] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->SetIsMusic(val);
-    }
-  });
+  PushSourceCommand(
+      {SourceCommand::Type::kSetIsMusic, play_id, {val ? 1.0f : 0.0f}});
 }
 
 void AudioServer::PushSourceSetPositionalCall(uint32_t play_id, bool val) {
-  PushCall([this, play_id, val] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->SetPositional(val);
-    }
-  });
+  PushSourceCommand(
+      {SourceCommand::Type::kSetPositional, play_id, {val ? 1.0f : 0.0f}});
 }
 
 void AudioServer::PushSourceSetPositionCall(uint32_t play_id,
                                             const Vector3f& p) {
-  PushCall([this, play_id, p] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->SetPosition(p.x, p.y, p.z);
-    }
-  });
+  PushSourceCommand(
+      {SourceCommand::Type::kSetPosition, play_id, {p.x, p.y, p.z}});
 }
 
 void AudioServer::PushSourceSetGainCall(uint32_t play_id, float val) {
-  PushCall([this, play_id, val] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->SetGain(val);
-    }
-  });
+  PushSourceCommand({SourceCommand::Type::kSetGain, play_id, {val}});
 }
 
 void AudioServer::PushSourceSetFadeCall(uint32_t play_id, float val) {
-  PushCall([this, play_id, val] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->SetFade(val);
-    }
-  });
+  PushSourceCommand({SourceCommand::Type::kSetFade, play_id, {val}});
 }
 
 void AudioServer::PushSourceSetLoopingCall(uint32_t play_id, bool val) {
-  PushCall([this, play_id, val] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->SetLooping(val);
-    }
-  });
+  PushSourceCommand(
+      {SourceCommand::Type::kSetLooping, play_id, {val ? 1.0f : 0.0f}});
 }
 
 void AudioServer::PushSourcePlayCall(uint32_t play_id,
                                      Object::Ref<SoundData>* sound) {
-  PushCall([this, play_id, sound] {
-    ThreadSource* s = GetPlayingSound(play_id);
+  PushSourceCommand({SourceCommand::Type::kPlay, play_id, {}, sound});
+}
 
-    // If this play command is valid, pass it along.
-    // Otherwise, return it immediately for deletion.
-    if (s) {
-      s->Play(sound);
-    } else {
-      AddSoundRefDelete(sound);
+void AudioServer::PushSourceStopCall(uint32_t play_id) {
+  PushSourceCommand({SourceCommand::Type::kStop, play_id});
+}
+
+void AudioServer::PushSourceEndCall(uint32_t play_id) {
+  PushSourceCommand({SourceCommand::Type::kEnd, play_id});
+}
+
+void AudioServer::PushStopSoundCall(uint32_t play_id) {
+  PushSourceCommand({SourceCommand::Type::kStopSound, play_id});
+}
+
+void AudioServer::PushFadeSoundOutCall(uint32_t play_id, uint32_t time) {
+  PushSourceCommand({SourceCommand::Type::kFadeSoundOut, play_id,
+                     {static_cast<float>(time)}});
+}
+
+void AudioServer::PushSourceCommand(const SourceCommand& cmd) {
+  // Only the game thread gets batching; anyone else goes the old way.
+  if (!InGameThread()) {
+    PushCall([this, cmd] {
+      RunSourceCommand(cmd);
+      if (cmd.type == SourceCommand::Type::kPlay) {
+        UpdateAvailableSources();
+      }
+    });
+    return;
+  }
+
+  // Only the final position/gain of a source (or the listener) within a
+  // batch matters, so those just overwrite earlier ones in place.
+  std::vector<SourceCommand>& pending = impl_->pending_commands_;
+  switch (cmd.type) {
+    case SourceCommand::Type::kSetPosition:
+    case SourceCommand::Type::kSetGain:
+    case SourceCommand::Type::kSetListenerPosition:
+    case SourceCommand::Type::kSetListenerOrientation: {
+      uint64_t key = (static_cast<uint64_t>(cmd.type) << 32u) | cmd.play_id;
+      auto i = impl_->pending_command_indices_.find(key);
+      if (i != impl_->pending_command_indices_.end()) {
+        pending[i->second] = cmd;
+        return;
+      }
+      impl_->pending_command_indices_[key] = pending.size();
+      break;
     }
+    default:
+      break;
+  }
+  pending.push_back(cmd);
+}
 
-    // Let's take this opportunity to pass on newly available sources.
-    // This way the more things clients are playing, the more
-    // tight our source availability checking gets (instead of solely relying on
-    // our periodic process() calls).
+void AudioServer::FlushSourceCommands() {
+  assert(InGameThread());
+  std::vector<SourceCommand>& pending = impl_->pending_commands_;
+  if (pending.empty()) {
+    return;
+  }
+  size_t written = impl_->WriteCommands(pending.data(), pending.size());
+  pending.erase(pending.begin(),
+                pending.begin() + static_cast<ptrdiff_t>(written));
+  impl_->pending_command_indices_.clear();
+
+  // One call drains everything that's arrived by the time it runs.
+  if (written && !impl_->drain_pushed_.exchange(true)) {
+    PushCall([this] {
+      impl_->drain_pushed_ = false;
+      RunSourceCommands();
+    });
+  }
+}
+
+void AudioServer::RunSourceCommands() {
+  assert(InAudioThread());
+  SourceCommand cmd{};
+  bool played = false;
+  while (impl_->ReadCommand(&cmd)) {
+    RunSourceCommand(cmd);
+    played = played || cmd.type == SourceCommand::Type::kPlay;
+  }
+
+  // Let's take this opportunity to pass on newly available sources.
+  // This way the more things clients are playing, the more
+  // tight our source availability checking gets (instead of solely relying on
+  // our periodic process() calls).
+  if (played) {
     UpdateAvailableSources();
-  });
+  }
+
+  // Things may have moved in or out of earshot.
+  UpdateVoices();
 }
 
-void AudioServer::PushSourceStopCall(uint32_t play_id) {
-  PushCall([this, play_id] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    if (s) {
-      s->Stop();
+void AudioServer::RunSourceCommand(const SourceCommand& cmd) {
+  assert(InAudioThread());
+  switch (cmd.type) {
+    case SourceCommand::Type::kStopSound:
+      StopSound(cmd.play_id);
+      return;
+    case SourceCommand::Type::kFadeSoundOut:
+      FadeSoundOut(cmd.play_id, static_cast<uint32_t>(cmd.vals[0]));
+      return;
+    case SourceCommand::Type::kSetListenerPosition: {
+      for (int i = 0; i < 3; i++) {
+        listener_position_[i] = cmd.vals[i];
+      }
+#if BA_ENABLE_AUDIO
+      if (!paused_) {
+        alListenerfv(AL_POSITION, cmd.vals);
+        CHECK_AL_ERROR;
+      }
+#endif  // BA_ENABLE_AUDIO
+      return;
     }
-  });
-}
+    case SourceCommand::Type::kSetListenerOrientation: {
+#if BA_ENABLE_AUDIO
+      if (!paused_) {
+        alListenerfv(AL_ORIENTATION, cmd.vals);
+        CHECK_AL_ERROR;
+      }
+#endif  // BA_ENABLE_AUDIO
+      return;
+    }
+    default:
+      break;
+  }
 
-void AudioServer::PushSourceEndCall(uint32_t play_id) {
-  PushCall([this, play_id] {
-    ThreadSource* s = GetPlayingSound(play_id);
-    assert(s);
-    s->client_source()->Lock(5);
-    s->client_source()->set_client_queue_size(
-        s->client_source()->client_queue_size() - 1);
-    assert(s->client_source()->client_queue_size() >= 0);
-    s->client_source()->Unlock();
-  });
+  ThreadSource* s = GetPlayingSound(cmd.play_id);
+  switch (cmd.type) {
+    case SourceCommand::Type::kSetIsMusic:
+      if (s) {
+        s->SetIsMusic(cmd.vals[0] != 0.0f);
+      }
+      break;
+    case SourceCommand::Type::kSetPositional:
+      if (s) {
+        s->SetPositional(cmd.vals[0] != 0.0f);
+      }
+      break;
+    case SourceCommand::Type::kSetPosition:
+      if (s) {
+        s->SetPosition(cmd.vals[0], cmd.vals[1], cmd.vals[2]);
+      }
+      break;
+    case SourceCommand::Type::kSetGain:
+      if (s) {
+        s->SetGain(cmd.vals[0]);
+      }
+      break;
+    case SourceCommand::Type::kSetFade:
+      if (s) {
+        s->SetFade(cmd.vals[0]);
+      }
+      break;
+    case SourceCommand::Type::kSetLooping:
+      if (s) {
+        s->SetLooping(cmd.vals[0] != 0.0f);
+      }
+      break;
+    case SourceCommand::Type::kPlay:
+      // If this play command is valid, pass it along.
+      // Otherwise, return it immediately for deletion.
+      if (s) {
+        s->Play(cmd.sound);
+      } else {
+        AddSoundRefDelete(cmd.sound);
+      }
+      break;
+    case SourceCommand::Type::kStop:
+      if (s) {
+        s->Stop();
+      }
+      break;
+    case SourceCommand::Type::kEnd:
+      assert(s);
+      s->client_source()->Lock(5);
+      s->client_source()->set_client_queue_size(
+          s->client_source()->client_queue_size() - 1);
+      assert(s->client_source()->client_queue_size() >= 0);
+      s->client_source()->Unlock();
+      break;
+    default:
+      throw Exception();
+  }
 }
 
 void AudioServer::PushResetCall() {
+  // Anything batched up beforehand should land before the reset does.
+  if (InGameThread()) {
+    FlushSourceCommands();
+  }
   PushCall([this] { Reset(); });
 }
 
 void AudioServer::PushSetListenerPositionCall(const Vector3f& p) {
-  PushCall([this, p] {
-#if BA_ENABLE_AUDIO
-    if (!paused_) {
-      ALfloat lpos[3] = {p.x, p.y, p.z};
-      alListenerfv(AL_POSITION, lpos);
-      CHECK_AL_ERROR;
-    }
-#endif  // BA_ENABLE_AUDIO
-  });
+  PushSourceCommand(
+      {SourceCommand::Type::kSetListenerPosition, 0, {p.x, p.y, p.z}});
 }
 
 void AudioServer::PushSetListenerOrientationCall(const Vector3f& forward,
                                                  const Vector3f& up) {
-  PushCall([this, forward, up] {
-#if BA_ENABLE_AUDIO
-    if (!paused_) {
-      ALfloat lorient[6] = {forward.x, forward.y, forward.z, up.x, up.y, up.z};
-      alListenerfv(AL_ORIENTATION, lorient);
-      CHECK_AL_ERROR;
-    }
-#endif  // BA_ENABLE_AUDIO
-  });
+  PushSourceCommand({SourceCommand::Type::kSetListenerOrientation,
+                     0,
+                     {forward.x, forward.y, forward.z, up.x, up.y, up.z}});
 }
 
 AudioServer::AudioServer(Thread* thread)
@@ -392,20 +635,37 @@ AudioServer::AudioServer(Thread* thread)
   alListenerfv(AL_ORIENTATION, listener_ori);
   CHECK_AL_ERROR;
 
-  // Create our sources.
-  int target_source_count = 30;
-  for (int i = 0; i < target_source_count; i++) {
-    bool valid = false;
-    auto s(Object::New<AudioServer::ThreadSource>(this, i, &valid));
-    if (valid) {
+  // Create our OpenAL sources.
+  for (int i = 0; i < kTargetALSourceCount; i++) {
+    ALuint source;
+    alGenSources(1, &source);
+    ALenum err = alGetError();
+    if (err != AL_NO_ERROR) {
+      Log(std::string("Error: AL Error ") + GetALErrorString(err)
+          + " on source creation; made " + std::to_string(i)
+          + " sources (wanted " + std::to_string(kTargetALSourceCount)
+          + ").");
+      break;
+    }
+    alSourcef(source, AL_MAX_DISTANCE, kSourceMaxDistance);
+    alSourcef(source, AL_REFERENCE_DISTANCE,
+              IsVRMode() ? kSourceReferenceDistanceVR
+                         : kSourceReferenceDistance);
+    alSourcef(source, AL_ROLLOFF_FACTOR, kSourceRolloffFactor);
+    CHECK_AL_ERROR;
+    impl_->free_al_sources_.push_back(source);
+    al_source_count_++;
+  }
+
+  // ...and the voices we hand out to clients (as long as we got at least
+  // one source to play them through).
+  if (al_source_count_ > 0) {
+    for (int i = 0; i < kVoiceCount; i++) {
+      auto s(Object::New<AudioServer::ThreadSource>(this, i));
       s->client_source_ = std::make_unique<AudioSource>(i);
       g_audio->AddClientSource(&(*s->client_source_));
       sound_source_refs_.push_back(s);
       sources_.push_back(&(*s));
-    } else {
-      Log("Error: Made " + std::to_string(i) + " sources; (wanted "
-          + std::to_string(target_source_count) + ").");
-      break;
     }
   }
   CHECK_AL_ERROR;
@@ -420,6 +680,15 @@ AudioServer::~AudioServer() {
 #if BA_ENABLE_AUDIO
   sound_source_refs_.clear();
 
+  // Our voices have all given their sources back by now.
+  assert(impl_->free_al_sources_.size()
+         == static_cast<size_t>(al_source_count_));
+  for (auto&& source : impl_->free_al_sources_) {
+    alDeleteSources(1, &source);
+    al_source_count_--;
+  }
+  impl_->free_al_sources_.clear();
+
   // Take down AL stuff.
   {
     ALCdevice* device;
@@ -451,9 +720,13 @@ void AudioServer::UpdateAvailableSources() {
 
     int source_count = 0;
     int in_use_source_count = 0;
+    int virtual_source_count = 0;
     std::list<std::string> sounds;
     for (auto&& i : sources_) {
       source_count++;
+      if (i->IsVirtuallyPlaying()) {
+        virtual_source_count++;
+      }
 
       if (!i->client_source()->TryLock(4)) {
         in_use_source_count++;
@@ -481,8 +754,10 @@ void AudioServer::UpdateAvailableSources() {
     if (explicit_bool(kShowInUseSounds)) {
       printf(
           "------------------------------------------\n"
-          "%d out of %d sources in use\n",
-          in_use_source_count, source_count);
+          "%d out of %d voices in use (%d virtual);"
+          " %d stolen, %d revived\n",
+          in_use_source_count, source_count, virtual_source_count,
+          voices_stolen_, voices_revived_);
       for (auto&& i : sounds) {
         printf("%s\n", i.c_str());
       }
@@ -492,6 +767,76 @@ void AudioServer::UpdateAvailableSources() {
 #endif
 }
 
+auto AudioServer::AcquireALSource(ThreadSource* voice) -> bool {
+#if BA_ENABLE_AUDIO
+  assert(InAudioThread());
+  assert(!voice->has_al_source());
+  std::vector<ALuint>& free_sources = impl_->free_al_sources_;
+  if (free_sources.empty()) {
+    // Look for the least audible voice with a source; if we beat it by
+    // enough, it goes virtual and we take its source.
+    ThreadSource* weakest = nullptr;
+    float weakest_audibility = 0.0f;
+    for (auto&& i : sources_) {
+      if (i->has_al_source()) {
+        float audibility = i->want_to_play() ? i->GetAudibility() : 0.0f;
+        if (!weakest || audibility < weakest_audibility) {
+          weakest = i;
+          weakest_audibility = audibility;
+        }
+      }
+    }
+    if (!weakest
+        || voice->GetAudibility() <= weakest_audibility * kVoiceStealMargin) {
+      return false;
+    }
+    free_sources.push_back(weakest->DetachALSource());
+    voices_stolen_++;
+  }
+  voice->AttachALSource(free_sources.back());
+  free_sources.pop_back();
+  return true;
+#else
+  return false;
+#endif  // BA_ENABLE_AUDIO
+}
+
+void AudioServer::UpdateVoices() {
+#if BA_ENABLE_AUDIO
+  assert(InAudioThread());
+  if (paused_) {
+    return;
+  }
+
+  // Gather voices wanting a source (music that's turned off doesn't).
+  bool music_on = music_volume_ > 0.000001f;
+  std::vector<std::pair<float, ThreadSource*> > waiting;
+  for (auto&& i : sources_) {
+    if (i->IsVirtuallyPlaying() && (music_on || !i->current_is_music())) {
+      waiting.emplace_back(i->GetAudibility(), i);
+    }
+  }
+  if (waiting.empty()) {
+    return;
+  }
+  std::sort(waiting.begin(), waiting.end(),
+            [](const std::pair<float, ThreadSource*>& a,
+               const std::pair<float, ThreadSource*>& b) {
+              return a.first > b.first;
+            });
+
+  // Most audible first; as soon as one can't get a source, nobody quieter
+  // will either.
+  for (auto&& i : waiting) {
+    if (!AcquireALSource(i.second)) {
+      break;
+    }
+    i.second->Revive();
+    voices_revived_++;
+  }
+#endif  // BA_ENABLE_AUDIO
+}
+
 void AudioServer::StopSound(uint32_t play_id) {
   uint32_t source = source_id_from_play_id(play_id);
   uint32_t count = play_count_from_play_id(play_id);
@@ -593,6 +938,7 @@ void AudioServer::UpdateMusicPlayState() {
 }
 
 void AudioServer::Process() {
+  BA_TRACE_SCOPE("AudioServer::Process");
   millisecs_t real_time = GetRealTime();
 
   assert(InAudioThread());
@@ -604,6 +950,7 @@ void AudioServer::Process() {
 
     // Keep that available-sources list filled.
     UpdateAvailableSources();
+    UpdateVoices();
 
     // Update our fading sound volumes.
     if (real_time - last_sound_fade_process_time_ > 50) {
@@ -671,65 +1018,118 @@ void AudioServer::DeleteMediaComponent(MediaComponentData* c) {
   delete c;
 }
 
-AudioServer::ThreadSource::ThreadSource(AudioServer* audio_thread_in, int id_in,
-                                        bool* valid_out)
-    : id_(id_in), audio_thread_(audio_thread_in) {
+AudioServer::ThreadSource::ThreadSource(AudioServer* audio_thread_in, int id_in)
+    : id_(id_in), audio_thread_(audio_thread_in) {}
+
+AudioServer::ThreadSource::~ThreadSource() {
 #if BA_ENABLE_AUDIO
-  assert(valid_out != nullptr);
-  CHECK_AL_ERROR;
+  Stop();
 
-  // Generate our sources.
-  alGenSources(1, &source_);
-  ALenum err = alGetError();
-  valid_ = (err == AL_NO_ERROR);
-  if (!valid_) {
-    Log(std::string("Error: AL Error ") + GetALErrorString(err)
-        + " on source creation.");
-  } else {
-    // In vr mode we keep the microphone a bit closer to the camera
-    // for realism purposes, so we need stuff louder in general.
-    if (IsVRMode()) {
-      alSourcef(source_, AL_MAX_DISTANCE, 100);
-      alSourcef(source_, AL_REFERENCE_DISTANCE, 7.5f);
-    } else {
-      // In regular mode our mic is stuck closer to the action
-      // so less loudness is needed.
-      alSourcef(source_, AL_MAX_DISTANCE, 100);
-      alSourcef(source_, AL_REFERENCE_DISTANCE, 5.0f);
+  // Remove us from sources list.
+  for (auto i = audio_thread_->sources_.begin();
+       i != audio_thread_->sources_.end(); ++i) {
+    if (*i == this) {
+      audio_thread_->sources_.erase(i);
+      break;
     }
-    alSourcef(source_, AL_ROLLOFF_FACTOR, 0.3f);
-    CHECK_AL_ERROR;
   }
-  *valid_out = valid_;
-  if (valid_) al_source_count_++;
 
+  // (Stop() can't release our source if we're paused).
+  if (has_al_source_) {
+    has_al_source_ = false;
+    audio_thread_->impl_->free_al_sources_.push_back(source_);
+  }
 #endif  // BA_ENABLE_AUDIO
 }
 
-AudioServer::ThreadSource::~ThreadSource() {
 #if BA_ENABLE_AUDIO
+void AudioServer::ThreadSource::AttachALSource(ALuint source) {
+  assert(InAudioThread());
+  assert(!has_al_source_);
+  source_ = source;
+  has_al_source_ = true;
 
-  if (!valid_) {
-    return;
+  // Bring the source up to date with our settings.
+  if (!g_audio_server->paused()) {
+    alSourcei(source_, AL_LOOPING, looping_);
+    alSourcei(source_, AL_SOURCE_RELATIVE, !positional_);
+    alSourcefv(source_, AL_POSITION, position_);
+    CHECK_AL_ERROR;
+    UpdateVolume();
+    UpdatePitch();
   }
-  Stop();
+}
 
-  // Remove us from sources list.
-  for (auto i = audio_thread_->sources_.begin();
-       i != audio_thread_->sources_.end(); ++i) {
-    if (*i == this) {
-      audio_thread_->sources_.erase(i);
-      break;
+auto AudioServer::ThreadSource::DetachALSource() -> ALuint {
+  assert(InAudioThread());
+  assert(has_al_source_);
+  if (!g_audio_server->paused()) {
+    if (is_actually_playing_) {
+      ExecStop();
     }
+    alSourcei(source_, AL_BUFFER, AL_NONE);
+    CHECK_AL_ERROR;
   }
 
-  assert(!is_actually_playing_ && !want_to_play_);
-  assert(!source_sound_);
+  // Streamers are tied to their source; we'll make a new one if we get
+  // another.
+  if (streamer_.exists()) {
+    streamer_.Clear();
+  }
+  has_al_source_ = false;
+  return source_;
+}
+#endif  // BA_ENABLE_AUDIO
 
-  alDeleteSources(1, &source_);
-  CHECK_AL_ERROR;
-  al_source_count_--;
+auto AudioServer::ThreadSource::GetPlayTime() const -> millisecs_t {
+  return GetRealTime() - play_start_time_;
+}
 
+auto AudioServer::ThreadSource::IsVirtuallyPlaying() const -> bool {
+#if BA_ENABLE_AUDIO
+  if (has_al_source_ || !want_to_play_ || !source_sound_) {
+    return false;
+  }
+  return looping_ || GetPlayTime() < play_duration_;
+#else
+  return false;
+#endif  // BA_ENABLE_AUDIO
+}
+
+auto AudioServer::ThreadSource::GetAudibility() const -> float {
+  // (Streams of unknown length are music files).
+  if (current_is_music_ || (is_streamed_ && play_duration_ == 0)) {
+    return kMusicVoicePriority;
+  }
+  float audibility = gain_ * fade_;
+  if (!positional_) {
+    return audibility * kNonPositionalVoicePriority;
+  }
+
+  // Mirror what OpenAL will do to us with distance.
+  float ref_dist =
+      IsVRMode() ? kSourceReferenceDistanceVR : kSourceReferenceDistance;
+  const float* l = audio_thread_->listener_position_;
+  float dx = position_[0] - l[0];
+  float dy = position_[1] - l[1];
+  float dz = position_[2] - l[2];
+  float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+  dist = std::min(std::max(dist, ref_dist), kSourceMaxDistance);
+  return audibility * ref_dist
+         / (ref_dist + kSourceRolloffFactor * (dist - ref_dist));
+}
+
+void AudioServer::ThreadSource::Revive() {
+#if BA_ENABLE_AUDIO
+  assert(has_al_source_ && want_to_play_ && source_sound_);
+  millisecs_t offset = 0;
+  if (play_duration_ > 0) {
+    offset = GetPlayTime();
+    if (looping_) {
+      offset %= play_duration_;
+    }
+  }
+  StartPlayback(offset);
 #endif  // BA_ENABLE_AUDIO
 }
 
@@ -768,6 +1168,9 @@ void AudioServer::ThreadSource::UpdateAvailability() {
     // (and we can't ask AL cuz we have no context).
     if (g_audio_server->paused()) {
       busy = false;
+    } else if (!has_al_source_) {
+      // Virtual voices are done once their sound would have finished.
+      busy = IsVirtuallyPlaying();
     } else {
       ALint state;
       alGetSourcei(source_, AL_SOURCE_STATE, &state);
@@ -821,17 +1224,18 @@ void AudioServer::ThreadSource::SetFade(float f) {
 
 void AudioServer::ThreadSource::SetLooping(bool loop) {
   looping_ = loop;
-  if (!g_audio_server->paused()) {
 #if BA_ENABLE_AUDIO
+  if (has_al_source_ && !g_audio_server->paused()) {
     alSourcei(source_, AL_LOOPING, loop);
     CHECK_AL_ERROR;
-#endif
   }
+#endif
 }
 
 void AudioServer::ThreadSource::SetPositional(bool p) {
+  positional_ = p;
 #if BA_ENABLE_AUDIO
-  if (!g_audio_server->paused()) {
+  if (has_al_source_ && !g_audio_server->paused()) {
     // TODO(ericf): Don't allow setting of positional
     //  on stereo sounds - we check this at initial play()
     //  but should do it here too.
@@ -842,8 +1246,11 @@ void AudioServer::ThreadSource::SetPositional(bool p) {
 }
 
 void AudioServer::ThreadSource::SetPosition(float x, float y, float z) {
+  position_[0] = x;
+  position_[1] = y;
+  position_[2] = z;
 #if BA_ENABLE_AUDIO
-  if (!g_audio_server->paused()) {
+  if (has_al_source_ && !g_audio_server->paused()) {
     bool oob = false;
     if (x < -500) {
       oob = true;
@@ -888,11 +1295,15 @@ void AudioServer::ThreadSource::ExecPlay() {
   assert(!is_actually_playing_);
   CHECK_AL_ERROR;
 
+  // Virtual voices just keep time until they get a source.
+  if (!has_al_source_) {
+    return;
+  }
+
   if (is_streamed_) {
     // Turn off looping on the source - the streamer handles looping for us.
     alSourcei(source_, AL_LOOPING, false);
     CHECK_AL_ERROR;
-    looping_ = false;
 
     // Push us on the list of streaming sources if we're not on it.
     for (auto&& i : audio_thread_->streaming_sources_) {
@@ -906,18 +1317,26 @@ void AudioServer::ThreadSource::ExecPlay() {
     // This is default behavior on Mac/Win, but we enforce it for linux.
     // (though currently linux stereo sounds play in mono... eww))
 
-    bool do_normal = true;
-    // In vr mode, play non-positional sounds positionally in space roughly
-    // where the menu is.
-    if (IsVRMode()) {
-      do_normal = false;
-      SetPositional(true);
-      SetPosition(0.0f, 4.5f, -3.0f);
-    }
+    // (Long sounds that just stay compressed behave like regular ones).
+    if (play_duration_ > 0) {
+      if (streamer_->al_format() == AL_FORMAT_STEREO16) {
+        SetPositional(false);
+        SetPosition(0, 0, 0);
+      }
+    } else {
+      bool do_normal = true;
+      // In vr mode, play non-positional sounds positionally in space
+      // roughly where the menu is.
+      if (IsVRMode()) {
+        do_normal = false;
+        SetPositional(true);
+        SetPosition(0.0f, 4.5f, -3.0f);
+      }
 
-    if (do_normal) {
-      SetPositional(false);
-      SetPosition(0, 0, 0);
+      if (do_normal) {
+        SetPositional(false);
+        SetPosition(0, 0, 0);
+      }
     }
 
     // Play if we're supposed to.
@@ -963,24 +1382,15 @@ auto AudioServer::ThreadSource::Play(const Object::Ref<SoundData>* sound)
 
     is_streamed_ = (**source_sound_).is_streamed();
     current_is_music_ = is_music_;
-
-    if (is_streamed_) {
-      streamer_ = Object::New<AudioStreamer, OggStream>(
-          (**source_sound_).file_name_full().c_str(), source_, looping_);
-    } else {
-      alSourcei(source_, AL_BUFFER, (**source_sound_).buffer());
-    }
-    CHECK_AL_ERROR;
-
-    // Always update our volume and pitch here (we may be changing from music to
-    // nonMusic, etc.)
-    UpdateVolume();
-    UpdatePitch();
-
-    bool music_should_play = ((g_audio_server->music_volume_ > 0.000001f)
-                              && !g_audio_server->paused());
-    if ((!current_is_music_) || music_should_play) {
-      ExecPlay();
+    play_start_time_ = GetRealTime();
+    play_pitch_ = current_is_music_ ? 1.0f : audio_thread_->sound_pitch();
+    play_duration_ = static_cast<millisecs_t>(
+        static_cast<float>((**source_sound_).duration()) / play_pitch_);
+
+    // If we can't get a source we still count as playing; we may get one
+    // later if we become more audible than someone who has one.
+    if (has_al_source_ || audio_thread_->AcquireALSource(this)) {
+      StartPlayback(0);
     }
   }
   want_to_play_ = true;
@@ -990,6 +1400,42 @@ auto AudioServer::ThreadSource::Play(const Object::Ref<SoundData>* sound)
   return play_id();
 }
 
+void AudioServer::ThreadSource::StartPlayback(millisecs_t offset) {
+#if BA_ENABLE_AUDIO
+  assert(has_al_source_ && source_sound_);
+  if (is_streamed_) {
+    streamer_ = Object::New<AudioStreamer, OggStream>(
+        (**source_sound_).file_name_full().c_str(), source_, looping_,
+        (**source_sound_).compressed_data());
+    if (offset > 0) {
+      streamer_->Seek(static_cast<millisecs_t>(static_cast<float>(offset)
+                                               * play_pitch_));
+    }
+  } else {
+    alSourcei(source_, AL_BUFFER, (**source_sound_).buffer());
+  }
+  CHECK_AL_ERROR;
+
+  // Always update our volume and pitch here (we may be changing from music to
+  // nonMusic, etc.)
+  UpdateVolume();
+  UpdatePitch();
+
+  bool music_should_play = ((g_audio_server->music_volume_ > 0.000001f)
+                            && !g_audio_server->paused());
+  if ((!current_is_music_) || music_should_play) {
+    ExecPlay();
+
+    // Revived voices pick up where they'd be by now.
+    if (offset > 0 && !is_streamed_) {
+      alSourcef(source_, AL_SEC_OFFSET,
+                static_cast<float>(offset) * play_pitch_ / 1000.0f);
+      CHECK_AL_ERROR;
+    }
+  }
+#endif  // BA_ENABLE_AUDIO
+}
+
 void AudioServer::ThreadSource::ExecStop() {
 #if BA_ENABLE_AUDIO
   assert(InAudioThread());
@@ -1038,6 +1484,11 @@ void AudioServer::ThreadSource::Stop() {
       source_sound_ = nullptr;
     }
     want_to_play_ = false;
+
+    // Let someone else use our source.
+    if (has_al_source_) {
+      audio_thread_->impl_->free_al_sources_.push_back(DetachALSource());
+    }
   }
 #endif  // BA_ENABLE_AUDIO
 }
@@ -1045,7 +1496,7 @@ void AudioServer::ThreadSource::Stop() {
 void AudioServer::ThreadSource::UpdateVolume() {
 #if BA_ENABLE_AUDIO
   assert(InAudioThread());
-  if (!g_audio_server->paused()) {
+  if (has_al_source_ && !g_audio_server->paused()) {
     float val = gain_ * fade_;
     if (current_is_music()) {
       val *= audio_thread_->music_volume() / 7.0f;
@@ -1061,7 +1512,7 @@ void AudioServer::ThreadSource::UpdateVolume() {
 void AudioServer::ThreadSource::UpdatePitch() {
 #if BA_ENABLE_AUDIO
   assert(InAudioThread());
-  if (!g_audio_server->paused()) {
+  if (has_al_source_ && !g_audio_server->paused()) {
     float val = 1.0f;
     if (current_is_music()) {
     } else {
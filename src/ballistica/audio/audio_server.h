@@ -56,6 +56,14 @@ class AudioServer : public Module {
   void PushSourcePlayCall(uint32_t play_id, Object::Ref<SoundData>* sound);
   void PushSourceStopCall(uint32_t play_id);
   void PushSourceEndCall(uint32_t play_id);
+  void PushStopSoundCall(uint32_t play_id);
+  void PushFadeSoundOutCall(uint32_t play_id, uint32_t time);
+
+  /// Source and listener commands from the game thread get batched up
+  /// (with redundant position/gain updates merged) and only go to the
+  /// audio thread when this is called; the game calls it once per update.
+  /// Commands from other threads are sent immediately.
+  void FlushSourceCommands();
 
   // Fade a playing sound out over the given time.  If it is already
   // fading or does not exist, does nothing.
@@ -67,6 +75,7 @@ class AudioServer : public Module {
  private:
   class ThreadSource;
   struct Impl;
+  struct SourceCommand;
 
   ~AudioServer() override;
 
@@ -84,12 +93,23 @@ class AudioServer : public Module {
 
   void Reset();
   void Process();
+  void PushSourceCommand(const SourceCommand& cmd);
+  void RunSourceCommand(const SourceCommand& cmd);
+  void RunSourceCommands();
 
   /// Send a component to the audio thread to delete.
   void DeleteMediaComponent(MediaComponentData* c);
 
   void UpdateTimerInterval();
   void UpdateAvailableSources();
+
+  /// Give OpenAL sources to the most audible voices, taking them from
+  /// less audible ones as needed.
+  void UpdateVoices();
+
+  /// Try to get an OpenAL source for a voice (free or taken from a less
+  /// audible voice). Returns true on success.
+  auto AcquireALSource(ThreadSource* voice) -> bool;
   void UpdateMusicPlayState();
   void ProcessSoundFades();
 
@@ -136,6 +156,12 @@ class AudioServer : public Module {
 
   millisecs_t last_sanity_check_time_{};
 
+  // Last position we gave OpenAL for the listener (for judging how
+  // audible positional voices are).
+  float listener_position_[3]{};
+  int voices_stolen_{};
+  int voices_revived_{};
+
   static int al_source_count_;
 };
 
@@ -14,7 +14,10 @@ namespace ballistica {
 
 #if BA_ENABLE_AUDIO
 AudioStreamer::AudioStreamer(const char* file_name, ALuint source_in, bool loop)
-    : source_(source_in), file_name_(file_name), loops_(loop) {
+    : source_(source_in),
+      file_name_(file_name),
+      loops_(loop),
+      decoded_(kAudioStreamDecodeAheadCount) {
   assert(InAudioThread());
   alGenBuffers(kAudioStreamBufferCount, buffers_);
   CHECK_AL_ERROR;
@@ -22,6 +25,7 @@ AudioStreamer::AudioStreamer(const char* file_name, ALuint source_in, bool loop)
 
 AudioStreamer::~AudioStreamer() {
   assert(!playing_);
+  assert(!decode_thread_.joinable());
   assert(g_audio_server);
 
   alDeleteBuffers(kAudioStreamBufferCount, buffers_);
@@ -32,19 +36,23 @@ auto AudioStreamer::Play() -> bool {
   CHECK_AL_ERROR;
   assert(!playing_);
   playing_ = true;
+  eof_ = false;
 
   // In case the source is already attached to something.
   DetachBuffers();
 
-  // Fill all our buffers with data.
-  for (unsigned int buffer : buffers_) {
-    if (!Stream(buffer)) {
-      return false;
-    }
-  }
+  StartDecoding();
 
-  alSourceQueueBuffers(source_, kAudioStreamBufferCount, buffers_);
-  CHECK_AL_ERROR;
+  // Wait until there's enough decoded to fill all our buffers (or we know
+  // there won't be); we need something to start playing with.
+  {
+    std::unique_lock<std::mutex> lock(decode_mutex_);
+    decode_cond_.wait(lock, [this] {
+      return decoded_count_ >= kAudioStreamBufferCount || decode_done_;
+    });
+  }
+  free_buffers_.assign(buffers_, buffers_ + kAudioStreamBufferCount);
+  QueueDecodedBuffers();
 
   alSourcePlay(source_);
   CHECK_AL_ERROR;
@@ -64,9 +72,15 @@ void AudioStreamer::Stop() {
   CHECK_AL_ERROR;
   playing_ = false;
   DetachBuffers();
+  StopDecoding();
   DoStop();
 }
 
+void AudioStreamer::Seek(millisecs_t offset) {
+  assert(!playing_);
+  DoSeek(offset);
+}
+
 void AudioStreamer::Update() {
   if (eof_) return;
 
@@ -91,24 +105,28 @@ void AudioStreamer::Update() {
     processed = queued;
   }
 
-  // Pull the completed ones off, refill them, and queue them back up.
+  // Pull the completed ones off and refill/requeue whatever we have data
+  // for. (Any we don't are left for next time).
   while (processed--) {
     ALuint buffer;
     alSourceUnqueueBuffers(source_, 1, &buffer);
     CHECK_AL_ERROR;
-    Stream(buffer);
-    if (!eof_) {
-      alSourceQueueBuffers(source_, 1, &buffer);
-      CHECK_AL_ERROR;
-    }
+    free_buffers_.push_back(buffer);
+  }
+  QueueDecodedBuffers();
+  if (eof_) {
+    return;
   }
 
-  // Restart playback if need be.
+  // Restart playback if need be (if the decoder fell behind we may have
+  // run dry).
   ALenum state;
   alGetSourcei(source_, AL_SOURCE_STATE, &state);
   CHECK_AL_ERROR;
+  alGetSourcei(source_, AL_BUFFERS_QUEUED, &queued);
+  CHECK_AL_ERROR;
 
-  if (state != AL_PLAYING) {
+  if (state != AL_PLAYING && queued > 0) {
     printf("AudioServer::Streamer: restarting playback\n");
     fflush(stdout);
 
@@ -130,25 +148,100 @@ void AudioStreamer::DetachBuffers() {
   CHECK_AL_ERROR;
 }
 
-auto AudioStreamer::Stream(ALuint buffer) -> bool {
-  char pcm[kAudioStreamBufferSize];
-  int size = 0;
-  unsigned int rate;
-  CHECK_AL_ERROR;
-  DoStream(pcm, &size, &rate);
-  if (size > 0) {
-    alBufferData(buffer, al_format(), pcm, size, static_cast<ALsizei>(rate));
+void AudioStreamer::QueueDecodedBuffers() {
+  while (!free_buffers_.empty()) {
+    DecodedBuffer* decoded;
+    {
+      std::lock_guard<std::mutex> lock(decode_mutex_);
+      if (decoded_count_ == 0) {
+        // Once the decoder is done and we've used everything it made,
+        // we're done too.
+        if (decode_done_) {
+          eof_ = true;
+        }
+        return;
+      }
+      decoded = &decoded_[decoded_front_];
+    }
+
+    // The front slot is ours until we pop it, so no need to hold the lock
+    // while we copy it out.
+    ALuint buffer = free_buffers_.back();
+    free_buffers_.pop_back();
+    alBufferData(buffer, al_format(), decoded->pcm, decoded->size,
+                 static_cast<ALsizei>(decoded->rate));
+    CHECK_AL_ERROR;
+    alSourceQueueBuffers(source_, 1, &buffer);
     CHECK_AL_ERROR;
-  } else {
-    eof_ = true;
+    {
+      std::lock_guard<std::mutex> lock(decode_mutex_);
+      decoded_front_ = (decoded_front_ + 1) % kAudioStreamDecodeAheadCount;
+      decoded_count_--;
+    }
+    decode_cond_.notify_all();
   }
+}
 
-  // Suppress 'always returns true' lint.
-  if (explicit_bool(false)) {
-    return false;
+void AudioStreamer::StartDecoding() {
+  assert(!decode_thread_.joinable());
+  decoded_front_ = 0;
+  decoded_count_ = 0;
+  decode_done_ = false;
+  decode_quit_ = false;
+  decode_thread_ = std::thread([this] { RunDecoder(); });
+}
+
+void AudioStreamer::StopDecoding() {
+  if (!decode_thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(decode_mutex_);
+    decode_quit_ = true;
   }
+  decode_cond_.notify_all();
+  decode_thread_.join();
+}
 
-  return true;
+void AudioStreamer::RunDecoder() {
+  while (true) {
+    DecodedBuffer* decoded;
+    {
+      std::unique_lock<std::mutex> lock(decode_mutex_);
+      decode_cond_.wait(lock, [this] {
+        return decode_quit_ || decoded_count_ < kAudioStreamDecodeAheadCount;
+      });
+      if (decode_quit_) {
+        return;
+      }
+
+      // The slot after the last ready one isn't visible to the consumer
+      // until we bump the count, so we can fill it unlocked.
+      decoded = &decoded_[(decoded_front_ + decoded_count_)
+                          % kAudioStreamDecodeAheadCount];
+    }
+    decoded->size = 0;
+    decoded->rate = 0;
+    try {
+      DoStream(decoded->pcm, &decoded->size, &decoded->rate);
+    } catch (const std::exception& e) {
+      Log("Error decoding audio stream '" + file_name_ + "': " + e.what());
+      decoded->size = 0;
+    }
+    bool done = decoded->size <= 0;
+    {
+      std::lock_guard<std::mutex> lock(decode_mutex_);
+      if (done) {
+        decode_done_ = true;
+      } else {
+        decoded_count_++;
+      }
+    }
+    decode_cond_.notify_all();
+    if (done) {
+      return;
+    }
+  }
 }
 
 #endif  // BA_ENABLE_AUDIO
@@ -3,8 +3,12 @@
 #ifndef BALLISTICA_AUDIO_AUDIO_STREAMER_H_
 #define BALLISTICA_AUDIO_AUDIO_STREAMER_H_
 
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "ballistica/audio/al_sys.h"  // FIXME: shouldn't need this here.
 #include "ballistica/core/object.h"
@@ -12,7 +16,9 @@
 namespace ballistica {
 
 #if BA_ENABLE_AUDIO
-// Provider for streamed audio data.
+// Provider for streamed audio data. Decoding happens in a background
+// thread which keeps a few buffers ready ahead of time; the audio thread
+// just hands those to OpenAL, so slow reads don't hold it up.
 class AudioStreamer : public Object {
  public:
   auto GetDefaultOwnerThread() const -> ThreadIdentifier override {
@@ -22,6 +28,9 @@ class AudioStreamer : public Object {
   ~AudioStreamer() override;
   auto Play() -> bool;
   void Stop();
+
+  /// Start from a given time when next played (must not be playing).
+  void Seek(millisecs_t offset);
   void Update();
   enum Format { INVALID_FORMAT, MONO16_FORMAT, STEREO16_FORMAT };
   auto al_format() const -> ALenum {
@@ -39,20 +48,46 @@ class AudioStreamer : public Object {
   auto file_name() const -> const std::string& { return file_name_; }
 
  protected:
+  // DoStream() gets called from our decode thread; DoStop() and DoSeek()
+  // only get called while that isn't running.
   virtual void DoStop() = 0;
+  virtual void DoSeek(millisecs_t offset) = 0;
   virtual void DoStream(char* pcm, int* size, unsigned int* rate) = 0;
-  auto Stream(ALuint buffer) -> bool;
   void DetachBuffers();
   void set_format(Format format) { format_ = format; }
 
  private:
+  struct DecodedBuffer {
+    char pcm[kAudioStreamBufferSize];
+    int size;
+    unsigned int rate;
+  };
+  void StartDecoding();
+  void StopDecoding();
+  void RunDecoder();
+
+  /// Hand decoded data to any of our OpenAL buffers that are free.
+  void QueueDecodedBuffers();
+
   Format format_ = INVALID_FORMAT;
   bool playing_ = false;
   ALuint buffers_[kAudioStreamBufferCount]{};
+  std::vector<ALuint> free_buffers_;
   ALuint source_ = 0;
   std::string file_name_;
   bool loops_ = false;
   bool eof_ = false;
+
+  // Ring of decoded buffers; the decode thread fills the slot after the
+  // last ready one while we consume from the front.
+  std::vector<DecodedBuffer> decoded_;
+  int decoded_front_ = 0;
+  int decoded_count_ = 0;
+  bool decode_done_ = false;
+  bool decode_quit_ = false;
+  std::mutex decode_mutex_;
+  std::condition_variable decode_cond_;
+  std::thread decode_thread_;
 };
 
 #endif  // BA_ENABLE_AUDIO
@@ -2,6 +2,12 @@
 
 #include "ballistica/audio/ogg_stream.h"
 
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "ballistica/media/media.h"
+#include "ballistica/platform/mapped_file.h"
 #include "ballistica/platform/platform.h"
 
 namespace ballistica {
@@ -25,27 +31,132 @@ static long CallbackTell(void* data_source) {  // NOLINT (ogg wants long)
   return ftell(static_cast<FILE*>(data_source));
 }
 
-OggStream::OggStream(const char* file_name, ALuint source, bool loop)
+// Ogg data we read straight out of memory; either a file in one of our
+// media archives, a loose file we've mapped ourself, or data handed to us.
+struct OggMemorySource {
+  const char* data{};
+  size_t size{};
+  size_t pos{};
+  std::unique_ptr<MappedFile> file;
+  std::shared_ptr<const std::vector<char>> owner;
+};
+
+static auto MemoryCallbackRead(void* ptr, size_t size, size_t nmemb,
+                               void* data_source) -> size_t {
+  auto* source = static_cast<OggMemorySource*>(data_source);
+  if (size == 0) {
+    return 0;
+  }
+  size_t count = std::min(nmemb, (source->size - source->pos) / size);
+  memcpy(ptr, source->data + source->pos, count * size);
+  source->pos += count * size;
+  return count;
+}
+
+static auto MemoryCallbackSeek(void* data_source, ogg_int64_t offset,
+                               int whence) -> int {
+  auto* source = static_cast<OggMemorySource*>(data_source);
+  ogg_int64_t base;
+  switch (whence) {
+    case SEEK_SET:
+      base = 0;
+      break;
+    case SEEK_CUR:
+      base = static_cast<ogg_int64_t>(source->pos);
+      break;
+    case SEEK_END:
+      base = static_cast<ogg_int64_t>(source->size);
+      break;
+    default:
+      return -1;
+  }
+  ogg_int64_t pos = base + offset;
+  if (pos < 0 || pos > static_cast<ogg_int64_t>(source->size)) {
+    return -1;
+  }
+  source->pos = static_cast<size_t>(pos);
+  return 0;
+}
+
+static auto MemoryCallbackClose(void* data_source) -> int {
+  delete static_cast<OggMemorySource*>(data_source);
+  return 0;
+}
+
+static long MemoryCallbackTell(void* data_source) {  // NOLINT
+  return static_cast<long>(  // NOLINT
+      static_cast<OggMemorySource*>(data_source)->pos);
+}
+
+// Returns a source for the file's data if we can get at it in memory, or
+// nullptr if it should just be read as a regular file.
+static auto OpenOggMemorySource(const char* file_name) -> OggMemorySource* {
+  const char* data;
+  size_t size;
+  if (g_media->FindArchivedFile(file_name, &data, &size)) {
+    auto* source = new OggMemorySource();
+    source->data = data;
+    source->size = size;
+    return source;
+  }
+#if BA_MAP_STREAMED_AUDIO
+  auto file = MappedFile::Open(file_name);
+  if (!file || file->size() == 0) {
+    return nullptr;
+  }
+  auto* source = new OggMemorySource();
+  source->data = file->data();
+  source->size = file->size();
+  source->file = std::move(file);
+  return source;
+#else
+  return nullptr;
+#endif
+}
+
+OggStream::OggStream(const char* file_name, ALuint source, bool loop,
+                     std::shared_ptr<const std::vector<char>> data)
     : AudioStreamer(file_name, source, loop), have_ogg_file_(false) {
   int result;
-  FILE* f;
-  if (!(f = g_platform->FOpen(file_name, "rb"))) {
-    throw Exception("can't open ogg file: '" + std::string(file_name) + "'");
-  }
-  ov_callbacks callbacks;
-  callbacks.read_func = CallbackRead;
-  callbacks.seek_func = CallbackSeek;
-  callbacks.close_func = CallbackClose;
-  callbacks.tell_func = CallbackTell;
 
   // Have to use callbacks here as codewarrior's FILE struct doesn't
   // seem to agree with what vorbis expects... oh well.
   // Ericf note Aug 2019: Wow I have comments here old enough to be referencing
   // codewarrior; that's awesome!
-  result = ov_open_callbacks(f, &ogg_file_, nullptr, 0, callbacks);
-  if (result < 0) {
-    fclose(f);
-    throw Exception(GetErrorString(result));
+  ov_callbacks callbacks;
+  OggMemorySource* ogg_source;
+  if (data) {
+    ogg_source = new OggMemorySource();
+    ogg_source->data = data->data();
+    ogg_source->size = data->size();
+    ogg_source->owner = std::move(data);
+  } else {
+    ogg_source = OpenOggMemorySource(file_name);
+  }
+  if (ogg_source) {
+    callbacks.read_func = MemoryCallbackRead;
+    callbacks.seek_func = MemoryCallbackSeek;
+    callbacks.close_func = MemoryCallbackClose;
+    callbacks.tell_func = MemoryCallbackTell;
+    result = ov_open_callbacks(ogg_source, &ogg_file_, nullptr, 0, callbacks);
+    if (result < 0) {
+      MemoryCallbackClose(ogg_source);
+      throw Exception(GetErrorString(result));
+    }
+  } else {
+    FILE* f;
+    if (!(f = g_platform->FOpen(file_name, "rb"))) {
+      throw Exception("can't open ogg file: '" + std::string(file_name) + "'");
+    }
+    callbacks.read_func = CallbackRead;
+    callbacks.seek_func = CallbackSeek;
+    callbacks.close_func = CallbackClose;
+    callbacks.tell_func = CallbackTell;
+    result = ov_open_callbacks(f, &ogg_file_, nullptr, 0, callbacks);
+    if (result < 0) {
+      fclose(f);
+      throw Exception(GetErrorString(result));
+    }
   }
   have_ogg_file_ = true;
 
@@ -67,6 +178,13 @@ void OggStream::DoStop() {
   if (have_ogg_file_) ov_pcm_seek(&ogg_file_, 0);
 }
 
+void OggStream::DoSeek(millisecs_t offset) {
+  if (have_ogg_file_) {
+    ov_pcm_seek(&ogg_file_, static_cast<ogg_int64_t>(offset)
+                                * vorbis_info_->rate / 1000);
+  }
+}
+
 void OggStream::DoStream(char* pcm, int* size, unsigned int* rate) {
   int section;
   int result;
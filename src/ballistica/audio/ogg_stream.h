@@ -13,7 +13,9 @@
 #endif  // BA_OSTYPE_IOS_TVOS
 #endif  // BA_ENABLE_AUDIO
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace ballistica {
 
@@ -22,11 +24,15 @@ namespace ballistica {
 // Handles streaming ogg audio.
 class OggStream : public AudioStreamer {
  public:
-  OggStream(const char* file_name, ALuint source, bool loop);
+  /// If data is passed, it is used in place of the file's contents
+  /// (file_name is then only used for reporting).
+  OggStream(const char* file_name, ALuint source, bool loop,
+            std::shared_ptr<const std::vector<char>> data = {});
   ~OggStream() override;
 
  protected:
   void DoStop() override;
+  void DoSeek(millisecs_t offset) override;
   void DoStream(char* pcm, int* size, unsigned int* rate) override;
 
  private:
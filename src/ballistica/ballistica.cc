@@ -7,7 +7,10 @@
 #include "ballistica/app/app.h"
 #include "ballistica/audio/audio_server.h"
 #include "ballistica/core/fatal_error.h"
+#include "ballistica/core/job_pool.h"
 #include "ballistica/core/logging.h"
+#include "ballistica/core/memory_stats.h"
+#include "ballistica/core/startup_timeline.h"
 #include "ballistica/core/thread.h"
 #include "ballistica/dynamics/bg/bg_dynamics_server.h"
 #include "ballistica/game/account.h"
@@ -43,6 +46,7 @@ UI* g_ui{};
 Graphics* g_graphics{};
 Python* g_python{};
 Input* g_input{};
+JobPool* g_job_pool{};
 GraphicsServer* g_graphics_server{};
 Media* g_media{};
 Audio* g_audio{};
@@ -71,6 +75,7 @@ TextGraphics* g_text_graphics{};
 //    and lastly the initial game session is kicked off.
 
 auto BallisticaMain(int argc, char** argv) -> int {
+  StartupTimeline::Start();
   try {
     // Even at the absolute start of execution we should be able to
     // phone home on errors. Set env var BA_CRASH_TEST=1 to test this.
@@ -84,39 +89,54 @@ auto BallisticaMain(int argc, char** argv) -> int {
     // Phase 1: Create and provision all globals.
     // -------------------------------------------------------------------------
 
+    StartupTimeline::Begin("globals");
     g_app_globals = new AppGlobals(argc, argv);
     g_app_internal = CreateAppInternal();
     g_platform = Platform::Create();
     g_account = new Account();
     g_utils = new Utils();
+    MemoryStats::InstallODEAllocator();
     Scene::Init();
+    JobPool::Init();
+    StartupTimeline::End("globals");
 
     // Create a Thread wrapper around the current (main) thread.
     g_main_thread = new Thread(ThreadIdentifier::kMain, ThreadType::kMain);
 
     // Spin up g_app.
+    StartupTimeline::Begin("create app");
     g_platform->CreateApp();
+    StartupTimeline::End("create app");
 
     // Spin up our other standard threads.
     auto* media_thread = new Thread(ThreadIdentifier::kMedia);
     g_app_globals->pausable_threads.push_back(media_thread);
+#if BA_ENABLE_AUDIO
+    // (Builds without audio don't need an audio thread at all).
     auto* audio_thread = new Thread(ThreadIdentifier::kAudio);
     g_app_globals->pausable_threads.push_back(audio_thread);
+#endif
     auto* game_thread = new Thread(ThreadIdentifier::kGame);
     g_app_globals->pausable_threads.push_back(game_thread);
     auto* network_write_thread = new Thread(ThreadIdentifier::kNetworkWrite);
     g_app_globals->pausable_threads.push_back(network_write_thread);
 
     // And add our other standard modules to them.
+    StartupTimeline::Begin("game module");
     game_thread->AddModule<Game>();
+    StartupTimeline::End("game module");
+    StartupTimeline::Begin("other modules");
     network_write_thread->AddModule<NetworkWriteModule>();
     media_thread->AddModule<MediaServer>();
     g_main_thread->AddModule<GraphicsServer>();
+#if BA_ENABLE_AUDIO
     audio_thread->AddModule<AudioServer>();
+#endif
 
     // Now let the platform spin up any other threads/modules it uses.
     // (bg-dynamics in non-headless builds, stdin/stdout where applicable, etc.)
     g_platform->CreateAuxiliaryModules();
+    StartupTimeline::End("other modules");
 
     // Ok at this point we can be considered up-and-running.
     g_app_globals->is_bootstrapped = true;
@@ -127,8 +147,10 @@ auto BallisticaMain(int argc, char** argv) -> int {
 
     // Let the app and platform do whatever else it wants here such as adding
     // initial input devices/etc.
+    StartupTimeline::Begin("bootstrap complete");
     g_app->OnBootstrapComplete();
     g_platform->OnBootstrapComplete();
+    StartupTimeline::End("bootstrap complete");
 
     // Ok; now that we're bootstrapped, tell the game thread to read and apply
     // the config which should kick off the real action.
@@ -102,6 +102,7 @@ const int kBaseVirtualResY = 680;
 // Magic numbers at the start of our file types.
 const int kBrpFileID = 83749;
 const int kBobFileID = 45623;
+const int kBobLODFileID = 45624;  // Bob with reduced detail levels appended.
 const int kCobFileID = 13466;
 
 const float kPi = 3.1415926535897932384626433832795028841971693993751f;
@@ -131,6 +132,7 @@ extern Game* g_game;
 extern Graphics* g_graphics;
 extern GraphicsServer* g_graphics_server;
 extern Input* g_input;
+extern JobPool* g_job_pool;
 extern Thread* g_main_thread;
 extern Media* g_media;
 extern MediaServer* g_media_server;
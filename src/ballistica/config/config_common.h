@@ -134,10 +134,22 @@ namespace ballistica {
 #define BA_HARDWARE_CURSOR 0
 #endif
 
+// Should BA_TRACE_SCOPE() markers be compiled in? (They're nearly free
+// unless a trace is actually being recorded).
+#ifndef BA_ENABLE_EVENT_TRACING
+#define BA_ENABLE_EVENT_TRACING 1
+#endif
+
 #ifndef BA_ENABLE_OS_FONT_RENDERING
 #define BA_ENABLE_OS_FONT_RENDERING 0
 #endif
 
+// Should streamed audio be read from memory-mapped files instead of
+// through stdio? (Ignored where we don't support mapping).
+#ifndef BA_MAP_STREAMED_AUDIO
+#define BA_MAP_STREAMED_AUDIO 1
+#endif
+
 // Does this build support vr mode? (does not mean vr mode is always on)
 #ifndef BA_VR_BUILD
 #define BA_VR_BUILD 0
@@ -0,0 +1,179 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/core/event_trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "ballistica/core/thread.h"
+#include "ballistica/generic/json_stream.h"
+#include "ballistica/platform/platform.h"
+
+namespace ballistica {
+
+// Events kept per thread (must be a power of 2); once full, the oldest
+// get overwritten so we always have the most recent stretch.
+const uint64_t kEventTraceRingSize = 65536;
+
+struct EventTraceEvent {
+  int64_t nanoseconds;
+  const char* name;
+  char phase;
+};
+
+// Only its own thread writes to a buffer; readers just snapshot it.
+struct EventTraceBuffer {
+  int tid{};
+  std::string thread_name;
+  std::unique_ptr<EventTraceEvent[]> events{
+      new EventTraceEvent[kEventTraceRingSize]};
+  std::atomic<uint64_t> head{};
+};
+
+struct EventTraceState {
+  std::mutex mutex;
+  std::vector<EventTraceBuffer*> buffers;
+  std::string path;
+  int64_t start_nanoseconds{};
+};
+static EventTraceState* g_event_trace{};
+static thread_local EventTraceBuffer* g_event_trace_buffer{};
+
+static auto GetTraceNanoseconds() -> int64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void EventTrace::AddEvent(const char* name, char phase) {
+  EventTraceBuffer* buffer = g_event_trace_buffer;
+
+  // First event from this thread; set it up with a buffer.
+  // (Buffers stick around even if their thread goes away).
+  if (buffer == nullptr) {
+    buffer = new EventTraceBuffer();
+    buffer->thread_name = Thread::GetCurrentThreadName();
+    std::lock_guard<std::mutex> lock(g_event_trace->mutex);
+    buffer->tid = static_cast<int>(g_event_trace->buffers.size()) + 1;
+    g_event_trace->buffers.push_back(buffer);
+    g_event_trace_buffer = buffer;
+  }
+  uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  EventTraceEvent& event = buffer->events[head & (kEventTraceRingSize - 1)];
+  event.nanoseconds = GetTraceNanoseconds();
+  event.name = name;
+  event.phase = phase;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void EventTrace::Start(const std::string& path) {
+  if (recording()) {
+    throw Exception("An event trace is already being recorded.");
+  }
+  if (g_event_trace == nullptr) {
+    g_event_trace = new EventTraceState();
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_event_trace->mutex);
+    g_event_trace->path = path;
+    g_event_trace->start_nanoseconds = GetTraceNanoseconds();
+    for (auto* buffer : g_event_trace->buffers) {
+      buffer->head.store(0, std::memory_order_relaxed);
+    }
+  }
+  recording_.store(true, std::memory_order_release);
+}
+
+void EventTrace::Stop() {
+  if (!recording()) {
+    return;
+  }
+  recording_.store(false, std::memory_order_release);
+  std::lock_guard<std::mutex> lock(g_event_trace->mutex);
+
+  JsonWriter writer;
+  writer.BeginObject().Key("traceEvents").BeginArray();
+  size_t event_count{};
+  std::vector<EventTraceEvent> events;
+  for (auto* buffer : g_event_trace->buffers) {
+    writer.BeginObject()
+        .Key("name")
+        .String("thread_name")
+        .Key("ph")
+        .String("M")
+        .Key("pid")
+        .Int(1)
+        .Key("tid")
+        .Int(buffer->tid)
+        .Key("args")
+        .BeginObject()
+        .Key("name")
+        .String(buffer->thread_name)
+        .EndObject()
+        .EndObject();
+
+    // Copy out everything but the oldest slot (a straggling writer could
+    // be filling it), then drop anything overwritten while we copied.
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t first =
+        head >= kEventTraceRingSize ? head - kEventTraceRingSize + 1 : 0;
+    events.clear();
+    for (uint64_t i = first; i < head; i++) {
+      events.push_back(buffer->events[i & (kEventTraceRingSize - 1)]);
+    }
+    uint64_t new_head = buffer->head.load(std::memory_order_acquire);
+    size_t skip{};
+    if (new_head >= kEventTraceRingSize
+        && new_head - kEventTraceRingSize + 1 > first) {
+      skip = static_cast<size_t>(new_head - kEventTraceRingSize + 1 - first);
+    }
+
+    // Leave out ends whose begins fell off the ring (or came before the
+    // trace started).
+    int depth{};
+    for (size_t i = skip; i < events.size(); i++) {
+      const EventTraceEvent& event = events[i];
+      if (event.phase == 'E') {
+        if (depth == 0) {
+          continue;
+        }
+        depth--;
+      } else {
+        depth++;
+      }
+      writer.BeginObject();
+      if (event.name) {
+        writer.Key("name").String(event.name);
+      }
+      writer.Key("ph")
+          .String(event.phase == 'E' ? "E" : "B")
+          .Key("ts")
+          .Number(static_cast<double>(event.nanoseconds
+                                      - g_event_trace->start_nanoseconds)
+                  * 0.001)
+          .Key("pid")
+          .Int(1)
+          .Key("tid")
+          .Int(buffer->tid)
+          .EndObject();
+      event_count++;
+    }
+  }
+  writer.EndArray().Key("displayTimeUnit").String("ms").EndObject();
+
+  const std::string& path = g_event_trace->path;
+  FILE* f = g_platform->FOpen(path.c_str(), "wb");
+  if (!f) {
+    Log("Error: Unable to write event trace to '" + path + "'.");
+    return;
+  }
+  fprintf(f, "%s\n", writer.str().c_str());
+  fclose(f);
+  Log("Wrote " + std::to_string(event_count) + " trace events to '" + path
+      + "'.");
+}
+
+}  // namespace ballistica
@@ -0,0 +1,68 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_CORE_EVENT_TRACE_H_
+#define BALLISTICA_CORE_EVENT_TRACE_H_
+
+#include <atomic>
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Records begin/end events from any thread into per-thread ring buffers
+/// and writes them out in Chrome trace format, so chrome://tracing or
+/// Perfetto can show cross-thread timelines of hitches. Mark code with
+/// BA_TRACE_SCOPE(); markers cost a single flag check while no trace is
+/// running, and nothing at all in builds with BA_ENABLE_EVENT_TRACING off.
+class EventTrace {
+ public:
+  /// Start recording; results go to path when stopped.
+  static void Start(const std::string& path);
+
+  /// Stop recording and write results (if recording).
+  static void Stop();
+
+  static auto recording() -> bool {
+    return recording_.load(std::memory_order_acquire);
+  }
+
+  /// Names must outlive the trace (so generally string literals).
+  static void Begin(const char* name) {
+    if (recording()) {
+      AddEvent(name, 'B');
+    }
+  }
+  static void End() {
+    if (recording()) {
+      AddEvent(nullptr, 'E');
+    }
+  }
+
+  class Scope {
+   public:
+    explicit Scope(const char* name) { Begin(name); }
+    ~Scope() { End(); }
+
+   private:
+    BA_DISALLOW_CLASS_COPIES(Scope);
+  };
+
+ private:
+  static void AddEvent(const char* name, char phase);
+  static inline std::atomic<bool> recording_{};
+};
+
+#if BA_ENABLE_EVENT_TRACING
+#define BA_TRACE_CONCAT_INNER(a, b) a##b
+#define BA_TRACE_CONCAT(a, b) BA_TRACE_CONCAT_INNER(a, b)
+#define BA_TRACE_SCOPE(name)                                       \
+  ::ballistica::EventTrace::Scope BA_TRACE_CONCAT(ba_trace_scope_, \
+                                                  __LINE__)(name)
+#else
+#define BA_TRACE_SCOPE(name) ((void)0)
+#endif
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_CORE_EVENT_TRACE_H_
@@ -80,6 +80,10 @@ auto FatalError::ReportFatalError(const std::string& message,
 
   Logging::Log(logmsg);
 
+  // We may not be around long enough for the background writer to get to
+  // it.
+  Logging::FlushStdio();
+
   std::string prefix = "FATAL-ERROR-LOG:";
   std::string suffix;
 
@@ -0,0 +1,191 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/core/job_pool.h"
+
+#include <string>
+#include <utility>
+
+#include "ballistica/core/thread.h"
+
+namespace ballistica {
+
+// Which of our workers the current thread is (-1 for non-workers).
+static thread_local int g_job_worker_index = -1;
+
+// Beyond this, more workers mostly just fight our fixed threads for cores.
+const int kMaxJobWorkers = 15;
+
+void JobPool::Init() {
+  assert(g_job_pool == nullptr);
+  g_job_pool = new JobPool();
+}
+
+JobPool::JobPool() {
+  // The thread waiting on a batch always helps run it, so one worker per
+  // additional core keeps everything busy.
+  int cores = static_cast<int>(std::thread::hardware_concurrency());
+  int worker_count = std::min(std::max(cores - 1, 0), kMaxJobWorkers);
+
+  // Create all queues before starting anyone, since workers steal from
+  // each other.
+  for (int i = 0; i < worker_count; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (int i = 0; i < worker_count; i++) {
+    workers_[i]->thread = std::thread([this, i] { RunWorker(i); });
+  }
+}
+
+JobPool::~JobPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutting_down_ = true;
+  }
+  cv_.notify_all();
+  for (auto&& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void JobPool::SetPaused(bool paused) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    paused_ = paused;
+  }
+  cv_.notify_all();
+}
+
+void JobPool::Push(Job job) {
+  int index = g_job_worker_index;
+  if (index >= 0) {
+    // Workers push onto their own queues; they'll likely get to these
+    // themselves while their data is still in cache.
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    workers_[index]->jobs.push_back(std::move(job));
+    queued_job_count_++;
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitted_jobs_.push_back(std::move(job));
+    queued_job_count_++;
+  }
+
+  // (Taking the lock here keeps sleepers from missing this.)
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  cv_.notify_all();
+}
+
+auto JobPool::TakeJob(Job* job) -> bool {
+  if (queued_job_count_.load() <= 0) {
+    return false;
+  }
+  int index = g_job_worker_index;
+  if (index >= 0) {
+    Worker* worker = workers_[index].get();
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (!worker->jobs.empty()) {
+      *job = std::move(worker->jobs.back());
+      worker->jobs.pop_back();
+      queued_job_count_--;
+      return true;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!submitted_jobs_.empty()) {
+      *job = std::move(submitted_jobs_.front());
+      submitted_jobs_.pop_front();
+      queued_job_count_--;
+      return true;
+    }
+  }
+
+  // Steal, starting with our neighbor so thieves spread out.
+  auto count = static_cast<int>(workers_.size());
+  for (int i = 1; i <= count; i++) {
+    int victim = (std::max(index, 0) + i) % count;
+    if (victim == index) {
+      continue;
+    }
+    Worker* worker = workers_[victim].get();
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (!worker->jobs.empty()) {
+      *job = std::move(worker->jobs.front());
+      worker->jobs.pop_front();
+      queued_job_count_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto JobPool::TryRunJob() -> bool {
+  Job job;
+  if (!TakeJob(&job)) {
+    return false;
+  }
+  RunJob(&job);
+  return true;
+}
+
+void JobPool::RunJob(Job* job) {
+  try {
+    job->call();
+  } catch (const std::exception& e) {
+    Log("Error: Unhandled exception in job: " + std::string(e.what()));
+  }
+
+  // The group can die as soon as its waiter sees this hit zero, so we
+  // mustn't touch it afterwards.
+  if (--job->group->pending_ == 0) {
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    cv_.notify_all();
+  }
+}
+
+void JobPool::RunWorker(int index) {
+  g_job_worker_index = index;
+  Thread::AddCurrentThreadName("job" + std::to_string(index));
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] {
+        return shutting_down_ || (!paused_ && queued_job_count_.load() > 0);
+      });
+      if (shutting_down_) {
+        break;
+      }
+    }
+    TryRunJob();
+  }
+  Thread::ClearCurrentThreadName();
+}
+
+JobPool::JobGroup::~JobGroup() { Wait(); }
+
+void JobPool::JobGroup::Run(std::function<void()> job) {
+  // Before the pool exists (or if it never will) just do it now.
+  if (g_job_pool == nullptr) {
+    job();
+    return;
+  }
+  pending_++;
+  g_job_pool->Push(Job{std::move(job), this});
+}
+
+void JobPool::JobGroup::Wait() {
+  JobPool* pool = g_job_pool;
+  while (pending_.load() > 0) {
+    assert(pool);
+
+    // Rather than idling, help out; this may or may not be one of ours.
+    if (pool->TryRunJob()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(pool->mutex_);
+    pool->cv_.wait(lock, [this, pool] {
+      return pending_.load() == 0 || pool->queued_job_count_.load() > 0;
+    });
+  }
+}
+
+}  // namespace ballistica
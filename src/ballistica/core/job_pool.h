@@ -0,0 +1,125 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_CORE_JOB_POOL_H_
+#define BALLISTICA_CORE_JOB_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// A pool of worker threads for data-parallel work (as opposed to our
+/// fixed one-per-purpose Threads). Each worker keeps its own queue of
+/// jobs and steals from the others when it runs dry. Anyone waiting on
+/// jobs helps run them, so work always gets done even while the pool is
+/// paused or on machines with no spare cores (and thus no workers).
+///
+/// Jobs run on arbitrary threads, so they should stick to plain data;
+/// no Objects, Python, etc.
+class JobPool {
+ public:
+  /// A set of jobs that can be waited on together. Jobs can add more
+  /// jobs to groups as they run, so these can express fork/join task
+  /// graphs as well as flat batches.
+  class JobGroup {
+   public:
+    JobGroup() = default;
+    ~JobGroup();
+
+    /// Queue a job in the pool as part of this group.
+    void Run(std::function<void()> job);
+
+    /// Return once all of this group's jobs have finished, helping run
+    /// queued jobs in the meantime.
+    void Wait();
+
+   private:
+    std::atomic<int> pending_{};
+    friend class JobPool;
+    BA_DISALLOW_CLASS_COPIES(JobGroup);
+  };
+
+  static void Init();
+  ~JobPool();
+
+  auto worker_count() const -> int {
+    return static_cast<int>(workers_.size());
+  }
+
+  /// Run fn(begin, end) over ranges covering [0, count) in parallel,
+  /// returning once all have finished. Ranges are at least min_range long
+  /// (except possibly the last). The calling thread takes the first one.
+  template <typename F>
+  void ParallelFor(size_t count, size_t min_range, F&& fn) {
+    if (count == 0) {
+      return;
+    }
+    min_range = std::max(min_range, size_t{1});
+
+    // A few ranges per thread lets stealing even out uneven work.
+    size_t range_count =
+        std::min((count + min_range - 1) / min_range,
+                 static_cast<size_t>(worker_count() + 1) * kRangesPerThread);
+    if (range_count <= 1) {
+      fn(size_t{0}, count);
+      return;
+    }
+    size_t range_size = (count + range_count - 1) / range_count;
+    JobGroup group;
+    for (size_t begin = range_size; begin < count; begin += range_size) {
+      size_t end = std::min(count, begin + range_size);
+      group.Run([&fn, begin, end] { fn(begin, end); });
+    }
+    fn(size_t{0}, range_size);
+    group.Wait();
+  }
+
+  /// Paused workers stop picking up jobs (waiters still run their own).
+  /// This is driven by Thread::SetThreadsPaused().
+  void SetPaused(bool paused);
+
+ private:
+  static const size_t kRangesPerThread = 4;
+  struct Job {
+    std::function<void()> call;
+    JobGroup* group{};
+  };
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::thread thread;
+  };
+  JobPool();
+  void Push(Job job);
+
+  // Grab a job to run: our own newest if we're a worker, then the oldest
+  // submitted from outside, then the oldest of someone else's.
+  auto TakeJob(Job* job) -> bool;
+  auto TryRunJob() -> bool;
+  void RunJob(Job* job);
+  void RunWorker(int index);
+
+  std::vector<std::unique_ptr<Worker> > workers_;
+
+  // Guards our outside-submitted queue and sleeping/waking.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Job> submitted_jobs_;
+  std::atomic<int> queued_job_count_{};
+  bool paused_{};
+  bool shutting_down_{};
+  BA_DISALLOW_CLASS_COPIES(JobPool);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_CORE_JOB_POOL_H_
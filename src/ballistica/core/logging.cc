@@ -2,7 +2,13 @@
 
 #include "ballistica/core/logging.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "ballistica/app/app_globals.h"
 #include "ballistica/game/game.h"
@@ -12,6 +18,120 @@
 
 namespace ballistica {
 
+// If the background writer falls this far behind (say, our stdout pipe
+// isn't being drained) we drop output rather than grow forever.
+const size_t kMaxPendingStdioBytes = 4 * 1024 * 1024;
+
+struct StdioChunk {
+  FILE* stream;
+  std::string text;
+};
+
+// Output waiting for our background stdio writer thread.
+struct StdioSinkState {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<StdioChunk> pending;
+  size_t pending_bytes{};
+  size_t dropped_bytes{};
+
+  // Held while actually writing so flushes and the writer don't overlap.
+  std::mutex write_mutex;
+};
+static StdioSinkState* g_stdio_sink{};
+static std::once_flag g_stdio_sink_once;
+
+// Write whatever is pending; caller must hold write_mutex.
+static void WritePendingStdio(StdioSinkState* sink,
+                              std::vector<StdioChunk>* chunks) {
+  size_t dropped_bytes;
+  {
+    std::lock_guard<std::mutex> lock(sink->mutex);
+    chunks->swap(sink->pending);
+    sink->pending_bytes = 0;
+    dropped_bytes = sink->dropped_bytes;
+    sink->dropped_bytes = 0;
+  }
+  bool wrote_stdout{};
+  bool wrote_stderr{};
+  for (auto& chunk : *chunks) {
+    fwrite(chunk.text.data(), 1, chunk.text.size(), chunk.stream);
+    (chunk.stream == stderr ? wrote_stderr : wrote_stdout) = true;
+  }
+  if (dropped_bytes > 0) {
+    fprintf(stderr, "Warning: dropped %zu bytes of log output.\n",
+            dropped_bytes);
+    wrote_stderr = true;
+  }
+
+  // One flush per batch instead of one per print.
+  if (wrote_stdout) {
+    fflush(stdout);
+  }
+  if (wrote_stderr) {
+    fflush(stderr);
+  }
+  chunks->clear();
+}
+
+static void RunStdioSinkThread(StdioSinkState* sink) {
+  std::vector<StdioChunk> chunks;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(sink->mutex);
+      sink->cv.wait(lock, [sink] {
+        return !sink->pending.empty() || sink->dropped_bytes > 0;
+      });
+    }
+    std::lock_guard<std::mutex> write_lock(sink->write_mutex);
+    WritePendingStdio(sink, &chunks);
+  }
+}
+
+static void StartStdioSink() {
+  g_stdio_sink = new StdioSinkState();
+
+  // The writer runs for the life of the process (so it never gets
+  // joined); whatever is left when we exit gets written synchronously.
+  std::thread(RunStdioSinkThread, g_stdio_sink).detach();
+  atexit([] { Logging::FlushStdio(); });
+}
+
+static void PushStdio(FILE* stream, const std::string& s) {
+  std::call_once(g_stdio_sink_once, StartStdioSink);
+  StdioSinkState* sink = g_stdio_sink;
+  {
+    std::lock_guard<std::mutex> lock(sink->mutex);
+    if (sink->pending_bytes + s.size() > kMaxPendingStdioBytes) {
+      sink->dropped_bytes += s.size();
+      return;
+    }
+    sink->pending_bytes += s.size();
+
+    // Consecutive prints to the same stream share a chunk.
+    if (!sink->pending.empty() && sink->pending.back().stream == stream) {
+      sink->pending.back().text += s;
+    } else {
+      sink->pending.push_back({stream, s});
+    }
+  }
+  sink->cv.notify_one();
+}
+
+void Logging::FlushStdio() {
+  StdioSinkState* sink = g_stdio_sink;
+  if (sink == nullptr) {
+    return;
+  }
+  std::vector<StdioChunk> chunks;
+  std::lock_guard<std::mutex> write_lock(sink->write_mutex);
+  WritePendingStdio(sink, &chunks);
+}
+
+// Set while a handle-log call is queued for the game thread; a burst of
+// logs then only costs Python one call.
+static std::atomic<bool> g_handle_log_call_pending{};
+
 static void PrintCommon(const std::string& s) {
   // Print to in-game console.
   {
@@ -32,18 +152,12 @@ static void PrintCommon(const std::string& s) {
 }
 
 void Logging::PrintStdout(const std::string& s, bool flush) {
-  fprintf(stdout, "%s", s.c_str());
-  if (flush) {
-    fflush(stdout);
-  }
+  PushStdio(stdout, s);
   PrintCommon(s);
 }
 
 void Logging::PrintStderr(const std::string& s, bool flush) {
-  fprintf(stderr, "%s", s.c_str());
-  if (flush) {
-    fflush(stderr);
-  }
+  PushStdio(stderr, s);
   PrintCommon(s);
 }
 
@@ -88,7 +202,13 @@ void Logging::Log(const std::string& msg, bool to_stdout, bool to_server) {
     // master server with various other context info included.
     if (g_app_globals && g_app_globals->is_bootstrapped) {
       assert(g_python != nullptr);
-      g_python->PushObjCall(Python::ObjID::kHandleLogCall);
+      if (!g_handle_log_call_pending.exchange(true)) {
+        g_game->PushCall([] {
+          g_handle_log_call_pending = false;
+          ScopedSetContext cp(g_game->GetUIContext());
+          g_python->obj(Python::ObjID::kHandleLogCall).Call();
+        });
+      }
     } else {
       // For log messages during bootstrapping we ship them immediately since
       // we don't know if the Python layer is (or will be) able to.
@@ -9,14 +9,21 @@ namespace ballistica {
 
 class Logging {
  public:
-  /// Print a string directly to stdout as well as the in-game console
-  /// and any connected telnet consoles.
+  /// Print a string to stdout as well as the in-game console and any
+  /// connected telnet consoles. Stdout writes happen on a background
+  /// thread so a slow reader (such as a server wrapper draining our pipe)
+  /// can't block the caller. (Each batch of output gets flushed, so flush
+  /// no longer changes anything).
   static auto PrintStdout(const std::string& s, bool flush = false) -> void;
 
-  /// Print a string directly to stderr as well as the in-game console
-  /// and any connected telnet consoles.
+  /// Print a string to stderr as well as the in-game console and any
+  /// connected telnet consoles. (Written in the background like stdout).
   static auto PrintStderr(const std::string& s, bool flush = false) -> void;
 
+  /// Synchronously write out anything still queued for stdout/stderr.
+  /// Use before going down hard (queued output is written at exit()).
+  static auto FlushStdio() -> void;
+
   /// Write a string to the debug log.
   /// This will go to stdout, windows debug log, android log, etc. depending
   /// on the platform.
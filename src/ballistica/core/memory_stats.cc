@@ -0,0 +1,108 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/core/memory_stats.h"
+
+#include <atomic>
+#include <cstdlib>
+
+#include "ballistica/generic/json_stream.h"
+#include "ode/ode_memory.h"
+
+namespace ballistica {
+
+static const char* kMemoryStatsTagNames[] = {
+    "ode", "object_pools", "textures", "models", "collide_models", "sounds"};
+static_assert(sizeof(kMemoryStatsTagNames) / sizeof(kMemoryStatsTagNames[0])
+                  == MemoryStats::kTagCount,
+              "Memory tag name list is out of date.");
+
+// Plain arrays of atomics so these are usable before static constructors
+// have run.
+static std::atomic<int64_t> g_memory_stats_bytes[MemoryStats::kTagCount];
+static std::atomic<int64_t> g_memory_stats_max_bytes[MemoryStats::kTagCount];
+
+static void UpdateMaxBytes(int index, int64_t bytes) {
+  int64_t max_bytes = g_memory_stats_max_bytes[index].load();
+  while (bytes > max_bytes
+         && !g_memory_stats_max_bytes[index].compare_exchange_weak(max_bytes,
+                                                                   bytes)) {
+  }
+}
+
+static auto ODEAlloc(size_t size) -> void* {
+  MemoryStats::Add(MemoryStats::Tag::kODE, static_cast<int64_t>(size));
+  return malloc(size);
+}
+
+static auto ODERealloc(void* ptr, size_t old_size, size_t new_size) -> void* {
+  MemoryStats::Add(MemoryStats::Tag::kODE, static_cast<int64_t>(new_size)
+                                               - static_cast<int64_t>(old_size));
+  return realloc(ptr, new_size);
+}
+
+static void ODEFree(void* ptr, size_t size) {
+  MemoryStats::Add(MemoryStats::Tag::kODE, -static_cast<int64_t>(size));
+  free(ptr);
+}
+
+void MemoryStats::InstallODEAllocator() {
+  dSetAllocHandler(ODEAlloc);
+  dSetReallocHandler(ODERealloc);
+  dSetFreeHandler(ODEFree);
+}
+
+void MemoryStats::Add(Tag tag, int64_t bytes) {
+  auto index = static_cast<int>(tag);
+  int64_t total = g_memory_stats_bytes[index].fetch_add(
+                      bytes, std::memory_order_relaxed)
+                  + bytes;
+  if (bytes > 0) {
+    UpdateMaxBytes(index, total);
+  }
+}
+
+void MemoryStats::Set(Tag tag, int64_t bytes) {
+  auto index = static_cast<int>(tag);
+  g_memory_stats_bytes[index].store(bytes, std::memory_order_relaxed);
+  UpdateMaxBytes(index, bytes);
+}
+
+auto MemoryStats::GetBytes(Tag tag) -> int64_t {
+  return g_memory_stats_bytes[static_cast<int>(tag)].load();
+}
+
+auto MemoryStats::GetMaxBytes(Tag tag) -> int64_t {
+  return g_memory_stats_max_bytes[static_cast<int>(tag)].load();
+}
+
+auto MemoryStats::GetTagName(Tag tag) -> const char* {
+  return kMemoryStatsTagNames[static_cast<int>(tag)];
+}
+
+auto MemoryStats::GetStatsString() -> std::string {
+  std::string out = "memory (k, peak):";
+  for (int i = 0; i < kTagCount; i++) {
+    auto tag = static_cast<Tag>(i);
+    out += std::string("\n") + GetTagName(tag) + ": "
+           + std::to_string(GetBytes(tag) / 1024) + " ("
+           + std::to_string(GetMaxBytes(tag) / 1024) + ")";
+  }
+  return out;
+}
+
+void MemoryStats::WriteStatsJson(JsonWriter* writer) {
+  writer->BeginObject();
+  for (int i = 0; i < kTagCount; i++) {
+    auto tag = static_cast<Tag>(i);
+    writer->Key(GetTagName(tag))
+        .BeginObject()
+        .Key("bytes")
+        .Int(GetBytes(tag))
+        .Key("max_bytes")
+        .Int(GetMaxBytes(tag))
+        .EndObject();
+  }
+  writer->EndObject();
+}
+
+}  // namespace ballistica
@@ -0,0 +1,52 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_CORE_MEMORY_STATS_H_
+#define BALLISTICA_CORE_MEMORY_STATS_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Rough byte counts for where our memory goes, with high-water marks, for
+/// watching long-running servers and low-memory devices. ODE and object
+/// pool allocations are counted as they happen; media totals are updated
+/// each prune from the sizes media components already estimate for their
+/// budgets. Safe to use from any thread.
+class MemoryStats {
+ public:
+  enum class Tag {
+    kODE,
+    kObjectPools,
+    kTextures,
+    kModels,
+    kCollideModels,
+    kSounds
+  };
+  static const int kTagCount = 6;
+
+  /// Route ODE's allocations through us so they get counted. Must be
+  /// called before any ODE objects are created.
+  static void InstallODEAllocator();
+
+  /// Adjust a tag's count by bytes (negative to release).
+  static void Add(Tag tag, int64_t bytes);
+
+  /// Set a tag's count outright (for totals tallied elsewhere).
+  static void Set(Tag tag, int64_t bytes);
+
+  static auto GetBytes(Tag tag) -> int64_t;
+  static auto GetMaxBytes(Tag tag) -> int64_t;
+  static auto GetTagName(Tag tag) -> const char*;
+
+  /// A line per tag with current and peak usage; for debug displays.
+  static auto GetStatsString() -> std::string;
+
+  /// Current and peak bytes per tag as a json object value.
+  static void WriteStatsJson(JsonWriter* writer);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_CORE_MEMORY_STATS_H_
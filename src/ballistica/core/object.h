@@ -127,6 +127,29 @@ class Object {
       }
     }
 
+   protected:
+    // Take over another weak-ref's spot in its object's list; for moves.
+    // (Saves unlinking and relinking, and there are no thread checks since
+    // the object is referenced throughout). We must be empty.
+    void TakeOver(WeakRefBase* ref) {
+      assert(obj_ == nullptr && next_ == nullptr && prev_ == nullptr);
+      obj_ = ref->obj_;
+      prev_ = ref->prev_;
+      next_ = ref->next_;
+      if (obj_) {
+        if (next_) {
+          next_->prev_ = this;
+        }
+        if (prev_) {
+          prev_->next_ = this;
+        } else {
+          obj_->object_weak_refs_ = this;
+        }
+      }
+      ref->obj_ = nullptr;
+      ref->prev_ = ref->next_ = nullptr;
+    }
+
    private:
     Object* obj_ = nullptr;
     WeakRefBase* prev_ = nullptr;
@@ -255,6 +278,16 @@ class Object {
     // Copy constructor (only non-explicit one).
     WeakRef(const WeakRef<T>& ref) { *this = ref.get(); }
 
+    // Moves just hand over the list entry.
+    WeakRef(WeakRef<T>&& ref) noexcept { TakeOver(&ref); }
+    auto operator=(WeakRef<T>&& ref) noexcept -> WeakRef<T>& {
+      if (this != &ref) {
+        Release();
+        TakeOver(&ref);
+      }
+      return *this;
+    }
+
     // From a compatible pointer.
     template <typename U>
     explicit WeakRef(U* ptr) {
@@ -406,6 +439,23 @@ class Object {
     // Copy constructor (only non-explicit one).
     Ref(const Ref<T>& ref) { *this = ref.get(); }
 
+    // Moves hand over the reference as-is; no count churn.
+    Ref(Ref<T>&& ref) noexcept : obj_(ref.obj_) { ref.obj_ = nullptr; }
+    auto operator=(Ref<T>&& ref) noexcept -> Ref<T>& {
+      // (Grab theirs first; our release could take them down with it).
+      T* obj = ref.obj_;
+      ref.obj_ = nullptr;
+      Release();
+      obj_ = obj;
+      return *this;
+    }
+
+    // From a compatible strong ref being moved.
+    template <typename U>
+    explicit Ref(Ref<U>&& ref) noexcept : obj_(ref.obj_) {
+      ref.obj_ = nullptr;
+    }
+
     // From a compatible pointer.
     template <typename U>
     explicit Ref(U* ptr) {
@@ -475,6 +525,8 @@ class Object {
       }
     }
     T* obj_ = nullptr;
+    template <typename U>
+    friend class Ref;
   };
 
   /// Object::New<Type>(): The preferred way to create ref-counted Objects.
@@ -0,0 +1,77 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/core/object_pool.h"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "ballistica/core/memory_stats.h"
+
+namespace ballistica {
+
+// Slots per slab, and the most a thread grabs from the depot at once.
+const size_t kObjectPoolSlabSize = 64;
+const size_t kObjectPoolRefillSize = 32;
+
+// All pools, for stats. Pools live forever so we never need to remove any.
+static auto GetObjectPoolRegistry() -> std::vector<ObjectPoolBase*>& {
+  static auto* pools = new std::vector<ObjectPoolBase*>();
+  return *pools;
+}
+static std::mutex g_object_pool_registry_mutex;
+
+ObjectPoolBase::ObjectPoolBase(std::string name, size_t object_size,
+                               size_t alignment)
+    : name_(std::move(name)), alignment_(alignment) {
+  slot_size_ = (object_size + alignment - 1) / alignment * alignment;
+  std::lock_guard<std::mutex> lock(g_object_pool_registry_mutex);
+  GetObjectPoolRegistry().push_back(this);
+}
+
+void ObjectPoolBase::Refill(std::vector<void*>* slots) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (depot_.empty()) {
+    char* slab = static_cast<char*>(::operator new(
+        slot_size_ * kObjectPoolSlabSize, std::align_val_t(alignment_)));
+    slabs_.push_back(slab);
+    MemoryStats::Add(MemoryStats::Tag::kObjectPools,
+                     static_cast<int64_t>(slot_size_ * kObjectPoolSlabSize));
+    slot_count_ += static_cast<int>(kObjectPoolSlabSize);
+
+    // Push in reverse so slots get handed out in address order.
+    for (size_t i = kObjectPoolSlabSize; i > 0; i--) {
+      depot_.push_back(slab + slot_size_ * (i - 1));
+    }
+  }
+  size_t count = std::min(depot_.size(), kObjectPoolRefillSize);
+  slots->insert(slots->end(), depot_.end() - count, depot_.end());
+  depot_.resize(depot_.size() - count);
+}
+
+void ObjectPoolBase::ReturnToDepot(std::vector<void*>* slots, size_t count) {
+  assert(count <= slots->size());
+  if (count == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  depot_.insert(depot_.end(), slots->end() - count, slots->end());
+  slots->resize(slots->size() - count);
+}
+
+auto ObjectPoolBase::GetStatsString() -> std::string {
+  std::string out;
+  std::lock_guard<std::mutex> lock(g_object_pool_registry_mutex);
+  for (auto* pool : GetObjectPoolRegistry()) {
+    if (!out.empty()) {
+      out += "\n";
+    }
+    int slots = pool->slot_count_.load();
+    out += pool->name_ + ": " + std::to_string(pool->live_count_.load()) + "/"
+           + std::to_string(slots) + " ("
+           + std::to_string(slots * pool->slot_size_ / 1024) + "k)";
+  }
+  return out;
+}
+
+}  // namespace ballistica
@@ -0,0 +1,116 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_CORE_OBJECT_POOL_H_
+#define BALLISTICA_CORE_OBJECT_POOL_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Recycles memory for a single Object type (see BA_OBJECT_POOLED).
+/// Each thread keeps its own list of free slots, so objects created and
+/// destroyed in their owner thread (the usual case) never take a lock;
+/// threads only trade slots with a shared depot in batches. Slabs are
+/// never handed back to the heap, which keeps long-running servers that
+/// churn through nodes and collisions from fragmenting it.
+class ObjectPoolBase {
+ public:
+  /// A line per pool describing its current usage; for debug displays.
+  static auto GetStatsString() -> std::string;
+
+ protected:
+  ObjectPoolBase(std::string name, size_t object_size, size_t alignment);
+
+  /// Move up to a batch of slots from the depot into a thread's list,
+  /// adding a slab first if the depot is empty.
+  void Refill(std::vector<void*>* slots);
+
+  /// Move count slots from the end of a thread's list to the depot.
+  void ReturnToDepot(std::vector<void*>* slots, size_t count);
+
+  std::atomic<int> live_count_{};
+
+ private:
+  std::string name_;
+  size_t slot_size_{};
+  size_t alignment_{};
+  std::mutex mutex_;
+  std::vector<void*> depot_;
+  std::vector<void*> slabs_;
+  std::atomic<int> slot_count_{};
+};
+
+template <typename T>
+class ObjectPool : public ObjectPoolBase {
+ public:
+  // Intentionally leaked so we outlive all threads' free lists.
+  static auto Get() -> ObjectPool<T>& {
+    static auto* pool = new ObjectPool<T>();
+    return *pool;
+  }
+
+  auto Allocate() -> void* {
+    std::vector<void*>& slots = FreeList().slots;
+    if (slots.empty()) {
+      Refill(&slots);
+    }
+    void* ptr = slots.back();
+    slots.pop_back();
+    live_count_++;
+    return ptr;
+  }
+
+  void Free(void* ptr) {
+    std::vector<void*>& slots = FreeList().slots;
+    slots.push_back(ptr);
+    live_count_--;
+    if (slots.size() >= kMaxThreadSlots) {
+      ReturnToDepot(&slots, kMaxThreadSlots / 2);
+    }
+  }
+
+ private:
+  static const size_t kMaxThreadSlots = 256;
+  struct ThreadFreeList {
+    ~ThreadFreeList() { Get().ReturnToDepot(&slots, slots.size()); }
+    std::vector<void*> slots;
+  };
+  static auto FreeList() -> ThreadFreeList& {
+    static thread_local ThreadFreeList list;
+    return list;
+  }
+  ObjectPool()
+      : ObjectPoolBase(static_type_name<T>(), sizeof(T), alignof(T)) {}
+};
+
+/// Place this in an Object subclass's public section to give it pooled
+/// allocation. Everything else about New()/Refs stays the same. Only
+/// exact instances are pooled; larger subclasses fall through to the heap
+/// (and can opt in themselves).
+/// Note that this must only be used on classes with an out-of-line virtual
+/// (such as their destructor) in a source file we build, so all deletes of
+/// them are guaranteed to come through here.
+#define BA_OBJECT_POOLED(TYPE)                                \
+  auto operator new(size_t size)->void* {                     \
+    if (size != sizeof(TYPE)) {                               \
+      return ::operator new(size);                            \
+    }                                                         \
+    return ::ballistica::ObjectPool<TYPE>::Get().Allocate();  \
+  }                                                           \
+  void operator delete(void* ptr, size_t size) {              \
+    if (size != sizeof(TYPE)) {                               \
+      ::operator delete(ptr);                                 \
+      return;                                                 \
+    }                                                         \
+    ::ballistica::ObjectPool<TYPE>::Get().Free(ptr);          \
+  }                                                           \
+  using ObjectPoolType = TYPE
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_CORE_OBJECT_POOL_H_
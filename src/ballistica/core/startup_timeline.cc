@@ -0,0 +1,126 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/core/startup_timeline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ballistica/core/thread.h"
+
+namespace ballistica {
+
+struct StartupTimelineEntry {
+  const char* phase{};
+  std::string thread_name;
+  int64_t begin_microseconds{};
+  int64_t end_microseconds{-1};  // Still running while -1.
+};
+
+struct StartupTimelineState {
+  std::mutex mutex;
+  int64_t start_microseconds{};
+  int64_t finish_microseconds{-1};
+  std::thread::id main_thread_id;
+  std::vector<StartupTimelineEntry> entries;
+};
+static StartupTimelineState* g_startup_timeline{};
+
+static auto GetStartupMicroseconds() -> int64_t {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void StartupTimeline::Start() {
+  assert(g_startup_timeline == nullptr);
+  g_startup_timeline = new StartupTimelineState();
+  g_startup_timeline->start_microseconds = GetStartupMicroseconds();
+  g_startup_timeline->main_thread_id = std::this_thread::get_id();
+}
+
+void StartupTimeline::AddEntry(const char* phase, bool begin) {
+  StartupTimelineState* state = g_startup_timeline;
+  if (state == nullptr) {
+    return;
+  }
+  int64_t now = GetStartupMicroseconds() - state->start_microseconds;
+
+  // The main thread doesn't get its name until a ways into bootstrapping.
+  std::string thread_name = std::this_thread::get_id() == state->main_thread_id
+                                ? "main"
+                                : Thread::GetCurrentThreadName();
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (begin) {
+    state->entries.emplace_back();
+    StartupTimelineEntry& entry = state->entries.back();
+    entry.phase = phase;
+    entry.thread_name = std::move(thread_name);
+    entry.begin_microseconds = now;
+    return;
+  }
+
+  // Close the most recent open entry for this phase on this thread.
+  for (auto i = state->entries.rbegin(); i != state->entries.rend(); i++) {
+    if (i->end_microseconds < 0 && !strcmp(i->phase, phase)
+        && i->thread_name == thread_name) {
+      i->end_microseconds = now;
+      return;
+    }
+  }
+}
+
+void StartupTimeline::Finish() {
+  StartupTimelineState* state = g_startup_timeline;
+  if (state == nullptr || finished_.exchange(true)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->finish_microseconds =
+        GetStartupMicroseconds() - state->start_microseconds;
+  }
+  if (const char* env = getenv("BA_STARTUP_TIMELINE")) {
+    if (!strcmp(env, "1")) {
+      Log(GetText());
+    }
+  }
+}
+
+auto StartupTimeline::GetText() -> std::string {
+  StartupTimelineState* state = g_startup_timeline;
+  if (state == nullptr) {
+    return "";
+  }
+  std::lock_guard<std::mutex> lock(state->mutex);
+  std::string out = "Startup timeline (start and duration in ms):\n";
+  char buffer[256];
+  for (auto&& entry : state->entries) {
+    if (entry.end_microseconds < 0) {
+      snprintf(buffer, sizeof(buffer), "  %8.1f %8s  %-28s [%s]\n",
+               static_cast<double>(entry.begin_microseconds) * 0.001, "...",
+               entry.phase, entry.thread_name.c_str());
+    } else {
+      snprintf(buffer, sizeof(buffer), "  %8.1f %8.1f  %-28s [%s]\n",
+               static_cast<double>(entry.begin_microseconds) * 0.001,
+               static_cast<double>(entry.end_microseconds
+                                   - entry.begin_microseconds)
+                   * 0.001,
+               entry.phase, entry.thread_name.c_str());
+    }
+    out += buffer;
+  }
+  if (state->finish_microseconds >= 0) {
+    snprintf(buffer, sizeof(buffer), "  %8.1f  first frame",
+             static_cast<double>(state->finish_microseconds) * 0.001);
+  } else {
+    snprintf(buffer, sizeof(buffer), "  (no frame drawn yet)");
+  }
+  out += buffer;
+  return out;
+}
+
+}  // namespace ballistica
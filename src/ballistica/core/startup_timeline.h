@@ -0,0 +1,69 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_CORE_STARTUP_TIMELINE_H_
+#define BALLISTICA_CORE_STARTUP_TIMELINE_H_
+
+#include <atomic>
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Records when each bootstrapping phase between process start and the
+/// first drawn frame begins and ends (and on which thread), so we can see
+/// which phases dominate launch time on each platform. Recording stops
+/// once the first frame is up; set env var BA_STARTUP_TIMELINE=1 to have
+/// the timeline logged at that point.
+class StartupTimeline {
+ public:
+  /// Called at the very top of BallisticaMain; times are relative to this.
+  static void Start();
+
+  /// Names must outlive the timeline (so generally string literals).
+  static void Begin(const char* phase) {
+    if (!finished()) {
+      AddEntry(phase, true);
+    }
+  }
+  static void End(const char* phase) {
+    if (!finished()) {
+      AddEntry(phase, false);
+    }
+  }
+
+  class Scope {
+   public:
+    explicit Scope(const char* phase) : phase_(phase) { Begin(phase); }
+    ~Scope() { End(phase_); }
+
+   private:
+    const char* phase_;
+    BA_DISALLOW_CLASS_COPIES(Scope);
+  };
+
+  /// Called by GraphicsServer as frames finish (or by Game once launch
+  /// commands have run in headless builds); the first call ends the
+  /// timeline.
+  static void NoteFirstFrame() {
+    if (!finished()) {
+      Finish();
+    }
+  }
+
+  static auto finished() -> bool {
+    return finished_.load(std::memory_order_acquire);
+  }
+
+  /// A human readable table of phases in start order.
+  static auto GetText() -> std::string;
+
+ private:
+  static void AddEntry(const char* phase, bool begin);
+  static void Finish();
+  static inline std::atomic<bool> finished_{};
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_CORE_STARTUP_TIMELINE_H_
@@ -2,8 +2,24 @@
 
 #include "ballistica/core/thread.h"
 
+#if BA_OSTYPE_LINUX
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if BA_OSTYPE_WINDOWS
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
 #include "ballistica/app/app.h"
 #include "ballistica/core/fatal_error.h"
+#include "ballistica/core/job_pool.h"
 #include "ballistica/platform/platform.h"
 #include "ballistica/python/python.h"
 
@@ -11,6 +27,32 @@ namespace ballistica {
 
 bool Thread::threads_paused_ = false;
 
+// All live threads, so telemetry can find them.
+static std::mutex* g_thread_registry_mutex{};
+static std::vector<Thread*>* g_thread_registry{};
+
+static auto LoadSeconds(const std::atomic<uint64_t>& microseconds)
+    -> double {
+  return static_cast<double>(microseconds.load(std::memory_order_relaxed))
+         * 1.0e-6;
+}
+
+// Counters have a single writer, so there's no need for a (pricier)
+// atomic read-modify-write.
+template <typename T>
+static void AddToStat(std::atomic<T>* stat, T amount) {
+  stat->store(stat->load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+}
+
+static auto MicrosecondsBetween(std::chrono::steady_clock::time_point start,
+                                std::chrono::steady_clock::time_point end)
+    -> uint64_t {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count());
+}
+
 void Thread::AddCurrentThreadName(const std::string& name) {
   std::lock_guard<std::mutex> lock(g_app_globals->thread_name_map_mutex);
   std::thread::id thread_id = std::this_thread::get_id();
@@ -68,6 +110,185 @@ void Thread::KillModules() {
   modules_.clear();
 }
 
+// Settings var names; see ApplyThreadScheduling().
+const char* kThreadAffinityEnvVar = "BA_THREAD_AFFINITY";
+const char* kThreadPriorityEnvVar = "BA_THREAD_PRIORITY";
+
+static auto GetThreadSettingsKey(ThreadIdentifier identifier) -> const char* {
+  switch (identifier) {
+    case ThreadIdentifier::kGame:
+      return "game";
+    case ThreadIdentifier::kMedia:
+      return "media";
+    case ThreadIdentifier::kAudio:
+      return "audio";
+    case ThreadIdentifier::kBGDynamics:
+      return "bg-dynamics";
+    case ThreadIdentifier::kNetworkWrite:
+      return "network-write";
+    case ThreadIdentifier::kStdin:
+      return "stdin";
+    default:
+      return "";
+  }
+}
+
+// Pull our thread's entry out of a 'game=2,3;bg-dynamics=4' style
+// setting; entries for 'default' apply to threads not listed.
+static auto GetThreadSetting(const char* env_var, ThreadIdentifier identifier)
+    -> std::string {
+  const char* env_val = getenv(env_var);
+  if (env_val == nullptr) {
+    return "";
+  }
+  std::string key = GetThreadSettingsKey(identifier);
+  std::string fallback;
+  std::istringstream entries(env_val);
+  std::string entry;
+  while (std::getline(entries, entry, ';')) {
+    auto split = entry.find('=');
+    if (split == std::string::npos) {
+      continue;
+    }
+    std::string entry_key = entry.substr(0, split);
+    if (entry_key == key) {
+      return entry.substr(split + 1);
+    }
+    if (entry_key == "default") {
+      fallback = entry.substr(split + 1);
+    }
+  }
+  return fallback;
+}
+
+// Parse a cpu list such as '0-3,6' (or 'node1' for all cpus of a NUMA
+// node, where supported). Returns an empty list on errors.
+static auto ParseThreadCPUList(const std::string& spec) -> std::vector<int> {
+  std::string list = spec;
+  if (list.compare(0, 4, "node") == 0) {
+#if BA_OSTYPE_LINUX
+    std::ifstream node_file("/sys/devices/system/node/" + list + "/cpulist");
+    if (!node_file || !std::getline(node_file, list)) {
+      return {};
+    }
+#else
+    return {};
+#endif
+  }
+  std::vector<int> cpus;
+  std::istringstream ranges(list);
+  std::string range;
+  while (std::getline(ranges, range, ',')) {
+    int first, last;
+    char extra;
+    if (sscanf(range.c_str(), "%d-%d%c", &first, &last, &extra) != 2) {
+      if (sscanf(range.c_str(), "%d%c", &first, &extra) != 1) {
+        return {};
+      }
+      last = first;
+    }
+    if (first < 0 || last < first || last > 1023) {
+      return {};
+    }
+    for (int cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+static void SetCurrentThreadAffinity(const std::string& spec) {
+  std::vector<int> cpus = ParseThreadCPUList(spec);
+  if (cpus.empty()) {
+    Log("Error: Invalid cpu list '" + spec + "' for "
+        + Thread::GetCurrentThreadName() + " thread.");
+    return;
+  }
+  bool success{};
+#if BA_OSTYPE_LINUX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &cpu_set);
+    }
+  }
+  // (pid 0 means the calling thread here).
+  success = (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0);
+#elif BA_OSTYPE_WINDOWS
+  DWORD_PTR mask{};
+  for (int cpu : cpus) {
+    if (cpu < static_cast<int>(sizeof(mask) * 8)) {
+      mask |= (static_cast<DWORD_PTR>(1) << cpu);
+    }
+  }
+  success = (SetThreadAffinityMask(GetCurrentThread(), mask) != 0);
+  if (success) {
+    SetThreadIdealProcessor(GetCurrentThread(),
+                            static_cast<DWORD>(cpus.front()));
+  }
+#endif
+  if (!success) {
+    Log("Warning: Unable to set cpu affinity for "
+        + Thread::GetCurrentThreadName() + " thread.");
+  }
+}
+
+static void SetCurrentThreadPriority(const std::string& priority) {
+  if (priority != "low" && priority != "normal" && priority != "high") {
+    Log("Error: Invalid priority '" + priority + "' for "
+        + Thread::GetCurrentThreadName()
+        + " thread (expected low, normal or high).");
+    return;
+  }
+  bool success{};
+#if BA_OSTYPE_LINUX
+  if (priority == "high") {
+    // Round-robin realtime scheduling needs privileges (CAP_SYS_NICE or
+    // an rtprio rlimit); failing that, try a lower nice value.
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_RR);
+    success = (pthread_setschedparam(pthread_self(), SCHED_RR, &param) == 0);
+    if (!success) {
+      success = (setpriority(PRIO_PROCESS,
+                             static_cast<id_t>(syscall(SYS_gettid)), -5)
+                 == 0);
+    }
+  } else {
+    // Nice values are per-thread on Linux.
+    success = (setpriority(PRIO_PROCESS,
+                           static_cast<id_t>(syscall(SYS_gettid)),
+                           priority == "low" ? 10 : 0)
+               == 0);
+  }
+#elif BA_OSTYPE_WINDOWS
+  int win_priority = priority == "high"  ? THREAD_PRIORITY_ABOVE_NORMAL
+                     : priority == "low" ? THREAD_PRIORITY_BELOW_NORMAL
+                                         : THREAD_PRIORITY_NORMAL;
+  success = (SetThreadPriority(GetCurrentThread(), win_priority) != 0);
+#endif
+  if (!success) {
+    Log("Warning: Unable to set " + priority + " priority for "
+        + Thread::GetCurrentThreadName() + " thread.");
+  }
+}
+
+// Lets hosts pin our threads to cores and tweak their priorities via
+// environment vars (which the server manager sets from its config), such
+// as BA_THREAD_AFFINITY='game=2;bg-dynamics=3;default=4-7' and
+// BA_THREAD_PRIORITY='game=high;media=low'. Only Linux and Windows are
+// supported currently.
+static void ApplyThreadScheduling(ThreadIdentifier identifier) {
+  std::string affinity = GetThreadSetting(kThreadAffinityEnvVar, identifier);
+  if (!affinity.empty()) {
+    SetCurrentThreadAffinity(affinity);
+  }
+  std::string priority = GetThreadSetting(kThreadPriorityEnvVar, identifier);
+  if (!priority.empty()) {
+    SetCurrentThreadPriority(priority);
+  }
+}
+
 // These are all exactly the same, but by running different ones for
 // different thread groups makes its easy to see which thread is which
 // in profilers, backtraces, etc.
@@ -122,14 +343,19 @@ void Thread::WaitForNextEvent(bool single_cycle) {
     g_python->ReleaseGIL();
   }
 
-  // If we've got active timers, wait for messages with a timeout so we can
-  // run the next timer payload.
-  if ((!paused_) && timers_.active_timer_count() > 0) {
-    millisecs_t real_time = GetRealTime();
-    millisecs_t wait_time = timers_.GetTimeToNextExpire(real_time);
-    if (wait_time > 0) {
-      std::unique_lock<std::mutex> lock(thread_message_mutex_);
-      if (thread_message_count_ == 0) {
+  // Let pushers know they need to wake us. (They check this after
+  // queueing, and we check for messages after setting it, so one of us
+  // always sees the other).
+  {
+    std::unique_lock<std::mutex> lock(thread_message_mutex_);
+    thread_message_waiting_ = true;
+
+    // If we've got active timers, wait for messages with a timeout so we
+    // can run the next timer payload.
+    if ((!paused_) && timers_.active_timer_count() > 0) {
+      millisecs_t real_time = GetRealTime();
+      millisecs_t wait_time = timers_.GetTimeToNextExpire(real_time);
+      if (wait_time > 0) {
         thread_message_cv_.wait_for(lock, std::chrono::milliseconds(wait_time),
                                     [this] {
                                       // Go back to sleep on spurious wakeups
@@ -138,17 +364,15 @@ void Thread::WaitForNextEvent(bool single_cycle) {
                                       return (thread_message_count_ > 0);
                                     });
       }
-    }
-  } else {
-    // Not running timers; just wait indefinitely for the next message.
-    std::unique_lock<std::mutex> lock(thread_message_mutex_);
-    if (thread_message_count_ == 0) {
+    } else {
+      // Not running timers; just wait indefinitely for the next message.
       thread_message_cv_.wait(lock, [this] {
         // Go back to sleep on spurious wakeups
         // (if we didn't wind up with any new messages).
         return (thread_message_count_ > 0);
       });
     }
+    thread_message_waiting_ = false;
   }
 
   if (owns_python_) {
@@ -175,14 +399,24 @@ void Thread::LoopUpkeep(bool single_cycle) {
 }
 
 auto Thread::RunEventLoop(bool single_cycle) -> int {
+  auto loop_start_time = std::chrono::steady_clock::now();
   while (true) {
     LoopUpkeep(single_cycle);
 
     WaitForNextEvent(single_cycle);
+    auto wake_time = std::chrono::steady_clock::now();
 
     // Process all queued thread messages.
-    std::list<ThreadMessage> thread_messages;
+    // (Recycle our message buffer; a nested event loop just gets its
+    // own).
+    std::vector<ThreadMessage> thread_messages;
+    thread_messages.swap(thread_message_spare_);
     GetThreadMessages(&thread_messages);
+    auto queue_depth = static_cast<int>(thread_messages.size());
+    if (queue_depth > stats_max_queue_depth_.load(std::memory_order_relaxed)) {
+      stats_max_queue_depth_.store(queue_depth, std::memory_order_relaxed);
+    }
+    uint64_t runnable_count{};
     for (auto& thread_message : thread_messages) {
       switch (thread_message.type) {
         case ThreadMessage::Type::kNewModule: {
@@ -204,6 +438,7 @@ auto Thread::RunEventLoop(bool single_cycle) -> int {
           // Add the event to our list.
           t->PushLocalRunnable(e);
           RunnablesWhilePausedSanityCheck(e);
+          runnable_count++;
 
           break;
         }
@@ -245,6 +480,9 @@ auto Thread::RunEventLoop(bool single_cycle) -> int {
       }
     }
 
+    thread_messages.clear();
+    thread_message_spare_.swap(thread_messages);
+
     // Run timers && queued module runnables unless we're paused.
     if (!paused_) {
       // Run timers.
@@ -255,6 +493,16 @@ auto Thread::RunEventLoop(bool single_cycle) -> int {
         module_entry->RunPendingRunnables();
       }
     }
+
+    auto loop_end_time = std::chrono::steady_clock::now();
+    AddToStat(&stats_loops_, uint64_t{1});
+    AddToStat(&stats_runnables_, runnable_count);
+    AddToStat(&stats_blocked_microseconds_,
+              MicrosecondsBetween(loop_start_time, wake_time));
+    AddToStat(&stats_busy_microseconds_,
+              MicrosecondsBetween(wake_time, loop_end_time));
+    loop_start_time = loop_end_time;
+
     if (done_ || single_cycle) {
       break;
     }
@@ -273,22 +521,56 @@ void Thread::RunnablesWhilePausedSanityCheck(Runnable* e) {
   // see details of what is coming through.  Disabling this check for now.
 }
 
-void Thread::GetThreadMessages(std::list<ThreadMessage>* messages) {
+void Thread::GetThreadMessages(std::vector<ThreadMessage>* messages) {
   assert(messages);
   assert(std::this_thread::get_id() == thread_id());
 
   // Make sure they passed an empty one in.
   assert(messages->empty());
-  if (thread_message_count_ > 0) {
-    std::unique_lock<std::mutex> lock(thread_message_mutex_);
-    assert(thread_messages_.size() == thread_message_count_);
-    messages->swap(thread_messages_);
-    thread_message_count_ = 0;
+
+  // Take everything that's been published, in order. (A pusher may have
+  // counted a message it hasn't published yet; we'll get it next time).
+  const size_t mask = kThreadMessageRingSize - 1;
+  while (true) {
+    ThreadMessageSlot& slot =
+        thread_message_ring_[thread_message_ring_tail_ & mask];
+    if (slot.sequence.load(std::memory_order_acquire)
+        != thread_message_ring_tail_ + 1) {
+      break;
+    }
+    messages->push_back(slot.message);
+    slot.sequence.store(thread_message_ring_tail_ + kThreadMessageRingSize,
+                        std::memory_order_release);
+    thread_message_ring_tail_++;
+  }
+  if (!messages->empty()) {
+    thread_message_count_ -= static_cast<int>(messages->size());
+
+    // If things have gotten badly backed up, let's see what with.
+    if (messages->size() > 1000 && !reported_thread_message_tally_) {
+      reported_thread_message_tally_ = true;
+      Log("Error: ThreadMessage list > 1000 in thread: "
+          + GetCurrentThreadName());
+      LogThreadMessageTally(*messages);
+    }
   }
 }
 
 Thread::Thread(ThreadIdentifier identifier_in, ThreadType type_in)
-    : type_(type_in), identifier_(identifier_in) {
+    : type_(type_in),
+      identifier_(identifier_in),
+      thread_message_ring_(new ThreadMessageSlot[kThreadMessageRingSize]) {
+  for (size_t i = 0; i < kThreadMessageRingSize; i++) {
+    thread_message_ring_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  {
+    if (g_thread_registry_mutex == nullptr) {
+      g_thread_registry_mutex = new std::mutex();
+      g_thread_registry = new std::vector<Thread*>();
+    }
+    std::lock_guard<std::mutex> lock(*g_thread_registry_mutex);
+    g_thread_registry->push_back(this);
+  }
   switch (type_) {
     case ThreadType::kStandard: {
       // Lock down until the thread is up and running. It'll unlock us when
@@ -382,6 +664,7 @@ auto Thread::ThreadMain() -> int {
         throw Exception();
     }
     g_platform->SetCurrentThreadName(id_string);
+    ApplyThreadScheduling(identifier_);
 
     // Send our owner a confirmation that we're alive.
     auto cmd = static_cast<uint32_t>(ThreadMessage::Type::kNewThreadConfirm);
@@ -431,20 +714,49 @@ void Thread::Quit() {
   }
 }
 
-Thread::~Thread() = default;
+Thread::~Thread() {
+  std::lock_guard<std::mutex> lock(*g_thread_registry_mutex);
+  g_thread_registry->erase(std::remove(g_thread_registry->begin(),
+                                       g_thread_registry->end(), this),
+                           g_thread_registry->end());
+}
+
+auto Thread::GetAllStats() -> std::vector<StatsSnapshot> {
+  std::vector<StatsSnapshot> snapshots;
+  if (g_thread_registry_mutex == nullptr) {
+    return snapshots;
+  }
+  std::lock_guard<std::mutex> lock(*g_thread_registry_mutex);
+  for (Thread* thread : *g_thread_registry) {
+    StatsSnapshot snapshot;
+    snapshot.identifier = thread->identifier_;
+    snapshot.loops = thread->stats_loops_.load(std::memory_order_relaxed);
+    snapshot.runnables =
+        thread->stats_runnables_.load(std::memory_order_relaxed);
+    snapshot.busy_seconds = LoadSeconds(thread->stats_busy_microseconds_);
+    snapshot.blocked_seconds =
+        LoadSeconds(thread->stats_blocked_microseconds_);
+    snapshot.queue_depth = thread->thread_message_count_;
+    snapshot.max_queue_depth =
+        thread->stats_max_queue_depth_.load(std::memory_order_relaxed);
+    snapshots.push_back(snapshot);
+  }
+  return snapshots;
+}
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "ConstantConditionsOC"
 
-void Thread::LogThreadMessageTally() {
+void Thread::LogThreadMessageTally(
+    const std::vector<ThreadMessage>& messages) {
   // Prevent recursion.
   if (!writing_tally_) {
     writing_tally_ = true;
 
     std::unordered_map<std::string, int> tally;
-    Log("Thread message tally (" + std::to_string(thread_messages_.size())
+    Log("Thread message tally (" + std::to_string(messages.size())
         + " in list):");
-    for (auto&& m : thread_messages_) {
+    for (auto&& m : messages) {
       std::string s;
       switch (m.type) {
         case ThreadMessage::Type::kShutdown:
@@ -495,59 +807,69 @@ void Thread::LogThreadMessageTally() {
 #pragma clang diagnostic pop
 
 void Thread::PushThreadMessage(const ThreadMessage& t) {
-  {
-    std::unique_lock<std::mutex> lock(thread_message_mutex_);
-
-    // Plop the data on to the list; we're assuming the mutex is locked.
-    thread_messages_.push_back(t);
-
-    // Keep our own count; apparently size() on an stl list involves
-    // iterating.
-    // FIXME: Actually I don't think this is the case anymore; should check.
-    thread_message_count_++;
-    assert(thread_message_count_ == thread_messages_.size());
-
-    // Show message count states.
-    if (explicit_bool(false)) {
-      static int one_off = 0;
-      static int foo = 0;
-      foo++;
-      one_off++;
-
-      // Show momemtary spikes.
-      if (thread_message_count_ > 100 && one_off > 100) {
-        one_off = 0;
-        foo = 999;
-      }
-
-      // Show count periodically.
-      if ((std::this_thread::get_id() == g_app_globals->main_thread_id)
-          && foo > 100) {
-        foo = 0;
-        Log("MSG COUNT " + std::to_string(thread_message_count_));
-      }
+  // Count it first; this way our count never claims fewer messages than
+  // are actually available.
+  int count = ++thread_message_count_;
+
+  // Show message count states.
+  if (explicit_bool(false)) {
+    static int one_off = 0;
+    static int foo = 0;
+    foo++;
+    one_off++;
+
+    // Show momemtary spikes.
+    if (count > 100 && one_off > 100) {
+      one_off = 0;
+      foo = 999;
     }
 
-    if (thread_message_count_ > 1000) {
-      static bool sent_error = false;
-      if (!sent_error) {
-        sent_error = true;
-        Log("Error: ThreadMessage list > 1000 in thread: "
-            + GetCurrentThreadName());
-        LogThreadMessageTally();
-      }
+    // Show count periodically.
+    if ((std::this_thread::get_id() == g_app_globals->main_thread_id)
+        && foo > 100) {
+      foo = 0;
+      Log("MSG COUNT " + std::to_string(count));
     }
+  }
 
-    // Prevent runaway mem usage if the list gets out of control.
-    if (thread_message_count_ > 10000) {
-      throw Exception("KILLING APP: ThreadMessage list > 10000 in thread: "
-                      + GetCurrentThreadName());
-    }
+  // Prevent runaway mem usage if the list gets out of control.
+  // (The thread will tally what it was buried in once it catches up).
+  if (count > 10000) {
+    thread_message_count_--;
+    throw Exception("KILLING APP: ThreadMessage list > 10000 in thread: "
+                    + GetCurrentThreadName());
+  }
 
-    // Unlock thread-message list and inform thread that there's something
-    // available.
+  // Claim a slot (the ring is always big enough for the above limit, so
+  // we never find it full here).
+  const size_t mask = kThreadMessageRingSize - 1;
+  size_t pos = thread_message_ring_head_.load(std::memory_order_relaxed);
+  ThreadMessageSlot* slot;
+  while (true) {
+    slot = &thread_message_ring_[pos & mask];
+    size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    auto diff =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (thread_message_ring_head_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else {
+      assert(diff > 0);
+      pos = thread_message_ring_head_.load(std::memory_order_relaxed);
+    }
+  }
+  slot->message = t;
+  slot->sequence.store(pos + 1, std::memory_order_release);
+
+  // Only bother waking the thread if it's actually asleep.
+  // (Taking the lock means it's either yet to check for messages or fully
+  // asleep, so this can't get lost).
+  if (thread_message_waiting_) {
+    std::lock_guard<std::mutex> lock(thread_message_mutex_);
+    thread_message_cv_.notify_all();
   }
-  thread_message_cv_.notify_all();
 }
 
 #pragma clang diagnostic push
@@ -587,6 +909,9 @@ void Thread::SetThreadsPaused(bool paused) {
   for (auto&& i : g_app_globals->pausable_threads) {
     i->SetPaused(paused);
   }
+  if (g_job_pool) {
+    g_job_pool->SetPaused(paused);
+  }
 }
 
 auto Thread::AreThreadsPaused() -> bool { return threads_paused_; }
@@ -3,8 +3,10 @@
 #ifndef BALLISTICA_CORE_THREAD_H_
 #define BALLISTICA_CORE_THREAD_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -19,6 +21,10 @@ namespace ballistica {
 
 const int kThreadMessageSafetyThreshold{500};
 
+// Capacity of each thread's message ring (must be a power of 2). This is
+// comfortably past the point where we give up and kill the app anyway.
+const int kThreadMessageRingSize{16384};
+
 // A thread with a built-in event loop.
 class Thread {
  public:
@@ -29,8 +35,8 @@ class Thread {
   /// Register a name for the current thread (should generally describe its
   /// purpose). If called multiple times, names will be combined with a '+'. ie:
   /// "graphics+animation+audio".
-  void AddCurrentThreadName(const std::string& name);
-  void ClearCurrentThreadName();
+  static void AddCurrentThreadName(const std::string& name);
+  static void ClearCurrentThreadName();
 
   static auto GetCurrentThreadName() -> std::string;
 
@@ -174,6 +180,21 @@ class Thread {
   auto NewTimer(millisecs_t length, bool repeat,
                 const Object::Ref<Runnable>& runnable) -> Timer*;
 
+  /// A copy of a thread's event loop counters (for telemetry). Counts and
+  /// times are totals since the thread started.
+  struct StatsSnapshot {
+    ThreadIdentifier identifier{};
+    uint64_t loops{};
+    uint64_t runnables{};
+    double busy_seconds{};
+    double blocked_seconds{};
+    int queue_depth{};
+    int max_queue_depth{};
+  };
+
+  /// Snapshot the counters of all existing threads; safe from any thread.
+  static auto GetAllStats() -> std::vector<StatsSnapshot>;
+
  private:
   struct ThreadMessage {
     enum class Type {
@@ -185,17 +206,25 @@ class Thread {
       kPause,
       kResume
     };
-    Type type;
-    void* pval;
-    int ival;
+    Type type{};
+    void* pval{};
+    int ival{};
+    ThreadMessage() = default;
     explicit ThreadMessage(Type type_in, int ival_in = 0,
                            void* pval_in = nullptr)
         : type(type_in), ival(ival_in), pval(pval_in) {}
   };
+
+  // Slot in our message ring. Producers claim slots by bumping the ring
+  // head and publish them by setting their sequence; we consume in order.
+  struct ThreadMessageSlot {
+    std::atomic<size_t> sequence;
+    ThreadMessage message;
+  };
   static void RunnablesWhilePausedSanityCheck(Runnable* r);
   void WaitForNextEvent(bool single_cycle);
   void LoopUpkeep(bool once);
-  void LogThreadMessageTally();
+  void LogThreadMessageTally(const std::vector<ThreadMessage>& messages);
   void ReadFromThread(std::unique_lock<std::mutex>* lock, void* buffer,
                       uint32_t size);
 
@@ -232,12 +261,21 @@ class Thread {
 
   auto ThreadMain() -> int;
   std::thread* thread_;
-  void GetThreadMessages(std::list<ThreadMessage>* messages);
+  void GetThreadMessages(std::vector<ThreadMessage>* messages);
   void PushThreadMessage(const ThreadMessage& t);
+
+  // Bounded lock-free multi-producer/single-consumer message ring. The
+  // mutex/cv are only used when we go to sleep on an empty ring; pushers
+  // skip them entirely unless we're actually waiting.
+  std::unique_ptr<ThreadMessageSlot[]> thread_message_ring_;
+  std::atomic<size_t> thread_message_ring_head_{};
+  size_t thread_message_ring_tail_{};
+  std::atomic<int> thread_message_count_{};
+  std::atomic<bool> thread_message_waiting_{};
   std::condition_variable thread_message_cv_;
   std::mutex thread_message_mutex_;
-  std::list<ThreadMessage> thread_messages_;
-  int thread_message_count_ = 0;
+  std::vector<ThreadMessage> thread_message_spare_;
+  bool reported_thread_message_tally_{};
   std::condition_variable data_to_client_cv_;
   std::mutex data_to_client_mutex_;
   std::list<std::vector<char> > data_to_client_;
@@ -250,6 +288,13 @@ class Thread {
   // Complete list of all timers created by this group's modules.
   TimerList timers_;
   static bool threads_paused_;
+
+  // Event loop counters; written only by our thread but read by others.
+  std::atomic<uint64_t> stats_loops_{};
+  std::atomic<uint64_t> stats_runnables_{};
+  std::atomic<uint64_t> stats_busy_microseconds_{};
+  std::atomic<uint64_t> stats_blocked_microseconds_{};
+  std::atomic<int> stats_max_queue_depth_{};
 };
 
 }  // namespace ballistica
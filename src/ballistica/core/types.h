@@ -93,9 +93,12 @@ class ImageMesh;
 class ImageWidget;
 class Input;
 class InputDevice;
+class JobPool;
 struct JointFixedEF;
 class Joystick;
+class JsonWriter;
 class KeyboardInput;
+class MappedFile;
 class Material;
 class MaterialAction;
 class MaterialComponent;
@@ -103,6 +106,7 @@ class MaterialConditionNode;
 class MaterialContext;
 class Matrix44f;
 class Media;
+class MediaArchive;
 class MediaComponentData;
 class MediaServer;
 class MeshBufferBase;
@@ -856,6 +860,9 @@ enum class LoginState { kSignedOut, kSigningIn, kSignedIn };
 
 enum class CameraMode { kFollow, kOrbit };
 
+/// Collision-space types usable for scene physics.
+enum class PhysicsBroadphase { kHash, kSweepAndPrune, kQuadTree };
+
 enum class MeshDataType {
   kIndexedSimpleSplit,
   kIndexedObjectSplit,
@@ -7,10 +7,13 @@
 #include "ballistica/dynamics/bg/bg_dynamics_fuse_data.h"
 #include "ballistica/dynamics/bg/bg_dynamics_shadow_data.h"
 #include "ballistica/dynamics/bg/bg_dynamics_volume_light_data.h"
+#include "ballistica/game/game.h"
 #include "ballistica/graphics/component/object_component.h"
 #include "ballistica/graphics/component/smoke_component.h"
 #include "ballistica/graphics/component/sprite_component.h"
+#include "ballistica/graphics/graphics.h"
 #include "ballistica/media/component/collide_model.h"
+#include "ballistica/scene/scene.h"
 
 namespace ballistica {
 
@@ -40,9 +43,29 @@ void BGDynamics::RemoveTerrain(CollideModelData* o) {
   g_bg_dynamics_server->PushRemoveTerrainCall(o);
 }
 
+// Seeds for deterministic mode; an emission index of 0 is the step itself.
+static auto GetRandomSeed(millisecs_t scene_time, uint32_t emit_index)
+    -> uint64_t {
+  return (static_cast<uint64_t>(scene_time) << 20u) + emit_index;
+}
+
+static auto GetSceneTime() -> millisecs_t {
+  Scene* scene = g_game->GetForegroundScene();
+  return scene ? scene->time() : 0;
+}
+
 void BGDynamics::Emit(const BGDynamicsEmission& e) {
   assert(InGameThread());
-  g_bg_dynamics_server->PushEmitCall(e);
+  uint64_t seed{};
+  if (deterministic_) {
+    millisecs_t scene_time = GetSceneTime();
+    if (scene_time != emit_time_) {
+      emit_time_ = scene_time;
+      emit_index_ = 0;
+    }
+    seed = GetRandomSeed(scene_time, ++emit_index_);
+  }
+  g_bg_dynamics_server->PushEmitCall(e, seed);
 }
 
 // Call friend client to step our sim.
@@ -51,108 +74,157 @@ void BGDynamics::Step(const Vector3f& cam_pos) {
 
   // The BG dynamics thread just processes steps as fast as it can;
   // we need to throttle what we send or tell it to cut back if its behind
-  int step_count = g_bg_dynamics_server->step_count();
+  // (unless we're deterministic, in which case every step has to happen
+  // and it just lags).
+  if (!deterministic_) {
+    int step_count = g_bg_dynamics_server->step_count();
+
+    // If we're really getting behind, start pruning stuff.
+    if (step_count > 3) {
+      TooSlow();
+    }
 
-  // If we're really getting behind, start pruning stuff.
-  if (step_count > 3) {
-    TooSlow();
+    // If we're slightly behind, just don't send this step; the bg dynamics
+    // will slow down a bit but nothing will disappear this way.
+    if (step_count > 1) return;
   }
 
-  // If we're slightly behind, just don't send this step;
-  // the bg dynamics will slow down a bit but nothing will disappear this way.
-  if (step_count > 1) return;
-
   // Pass a newly allocated raw pointer to the bg-dynamics thread; it takes care
   // of disposing it when done.
   auto d = Object::NewDeferred<BGDynamicsServer::StepData>();
   d->cam_pos = cam_pos;
+  if (deterministic_) {
+    d->random_seed = GetRandomSeed(GetSceneTime(), 0);
+  }
 
   {  // Shadows.
-    BA_DEBUG_TIME_CHECK_BEGIN(bg_dynamic_shadow_list_lock);
-    {
-      std::lock_guard<std::mutex> lock(
-          g_bg_dynamics_server->shadow_list_mutex_);
-      auto size = g_bg_dynamics_server->shadows_.size();
-      d->shadow_step_data_.resize(size);
-      if (size > 0) {
-        BGDynamicsShadowData** sd_client = &(g_bg_dynamics_server->shadows_[0]);
-        std::pair<BGDynamicsShadowData*, BGDynamicsServer::ShadowStepData>* sd =
-            &(d->shadow_step_data_[0]);
-        for (size_t i = 0; i < size; i++) {
-          // Set to nullptr (for ignore) if the client side is dead.
-          sd[i].first = sd_client[i]->client_dead ? nullptr : sd_client[i];
-          sd[i].second.position = sd_client[i]->pos_client;
-        }
-      }
+    auto size = shadows_.size();
+    d->shadow_step_data_.resize(size);
+    for (size_t i = 0; i < size; i++) {
+      auto& sd(d->shadow_step_data_[i]);
+      sd.first = shadows_[i];
+      sd.second.position = shadows_[i]->pos_client;
     }
-    BA_DEBUG_TIME_CHECK_END(bg_dynamic_shadow_list_lock, 10);
   }
   {  // Volume lights.
-    BA_DEBUG_TIME_CHECK_BEGIN(bg_dynamic_volumelights_list_lock);
-    {
-      std::lock_guard<std::mutex> lock(
-          g_bg_dynamics_server->volume_light_list_mutex_);
-      auto size = g_bg_dynamics_server->volume_lights_.size();
-      d->volume_light_step_data_.resize(size);
-      if (size > 0) {
-        BGDynamicsVolumeLightData** vd_client =
-            &(g_bg_dynamics_server->volume_lights_[0]);
-        std::pair<BGDynamicsVolumeLightData*,
-                  BGDynamicsServer::VolumeLightStepData>* vd =
-            &(d->volume_light_step_data_[0]);
-        for (size_t i = 0; i < size; i++) {
-          // Set to nullptr (for ignore) if the client side is dead.
-          vd[i].first = vd_client[i]->client_dead ? nullptr : vd_client[i];
-          vd[i].second.pos = vd_client[i]->pos_client;
-          vd[i].second.radius = vd_client[i]->radius_client;
-          vd[i].second.r = vd_client[i]->r_client;
-          vd[i].second.g = vd_client[i]->g_client;
-          vd[i].second.b = vd_client[i]->b_client;
-        }
-      }
+    auto size = volume_lights_.size();
+    d->volume_light_step_data_.resize(size);
+    for (size_t i = 0; i < size; i++) {
+      BGDynamicsVolumeLightData* vd_client = volume_lights_[i];
+      auto& vd(d->volume_light_step_data_[i]);
+      vd.first = vd_client;
+      vd.second.pos = vd_client->pos_client;
+      vd.second.radius = vd_client->radius_client;
+      vd.second.r = vd_client->r_client;
+      vd.second.g = vd_client->g_client;
+      vd.second.b = vd_client->b_client;
     }
-    BA_DEBUG_TIME_CHECK_END(bg_dynamic_volumelights_list_lock, 10);
   }
   {  // Fuses.
-    BA_DEBUG_TIME_CHECK_BEGIN(bg_dynamic_fuse_list_lock);
-    {
-      std::lock_guard<std::mutex> lock(g_bg_dynamics_server->fuse_list_mutex_);
-      auto size = g_bg_dynamics_server->fuses_.size();
-      d->fuse_step_data_.resize(size);
-      if (size > 0) {
-        BGDynamicsFuseData** fd_client = &(g_bg_dynamics_server->fuses_[0]);
-        std::pair<BGDynamicsFuseData*, BGDynamicsServer::FuseStepData>* fd =
-            &(d->fuse_step_data_[0]);
-        for (size_t i = 0; i < size; i++) {
-          // Set to nullptr (for ignore) if the client side is dead.
-          fd[i].first = fd_client[i]->client_dead_ ? nullptr : fd_client[i];
-          fd[i].second.transform = fd_client[i]->transform_client_;
-          fd[i].second.have_transform = fd_client[i]->have_transform_client_;
-          fd[i].second.length = fd_client[i]->length_client_;
-        }
-      }
+    auto size = fuses_.size();
+    d->fuse_step_data_.resize(size);
+    for (size_t i = 0; i < size; i++) {
+      BGDynamicsFuseData* fd_client = fuses_[i];
+      auto& fd(d->fuse_step_data_[i]);
+      fd.first = fd_client;
+      fd.second.transform = fd_client->transform_client_;
+      fd.second.have_transform = fd_client->have_transform_client_;
+      fd.second.length = fd_client->length_client_;
     }
-    BA_DEBUG_TIME_CHECK_END(bg_dynamic_fuse_list_lock, 10);
   }
 
   // Increase our step count and ship it.
-  {
-    std::lock_guard<std::mutex> lock(g_bg_dynamics_server->step_count_mutex_);
-    g_bg_dynamics_server->step_count_++;
-  }
+  g_bg_dynamics_server->step_count_++;
 
   // Ok send the thread on its way.
   g_bg_dynamics_server->PushStepCall(d);
 }
 
-void BGDynamics::SetDrawSnapshot(BGDynamicsDrawSnapshot* s) {
-  // We were passed a raw pointer; assign it to our unique_ptr which will
-  // take ownership of it and handle disposing it when we get the next one.
-  draw_snapshot_ = std::unique_ptr<BGDynamicsDrawSnapshot>(s);
+auto BGDynamics::AddShadow(float height_scaling) -> BGDynamicsShadowData* {
+  assert(InGameThread());
+  BGDynamicsShadowData* d = shadow_pool_.New(height_scaling);
+  BGDynamicsListAdd(&shadows_, d, &BGDynamicsShadowData::client_index);
+  g_bg_dynamics_server->PushAddShadowCall(d);
+  return d;
+}
+
+void BGDynamics::RemoveShadow(BGDynamicsShadowData* d) {
+  assert(InGameThread());
+  BGDynamicsListRemove(&shadows_, d, &BGDynamicsShadowData::client_index);
+
+  // Any step data already in flight referencing this gets processed
+  // before this call, so the server can release it here safely.
+  g_bg_dynamics_server->PushRemoveShadowCall(d);
+}
+
+void BGDynamics::ReleaseShadow(BGDynamicsShadowData* d) {
+  assert(InBGDynamicsThread());
+  shadow_pool_.Delete(d);
+}
+
+auto BGDynamics::AddVolumeLight() -> BGDynamicsVolumeLightData* {
+  assert(InGameThread());
+  BGDynamicsVolumeLightData* d = volume_light_pool_.New();
+  BGDynamicsListAdd(&volume_lights_, d,
+                    &BGDynamicsVolumeLightData::client_index);
+  g_bg_dynamics_server->PushAddVolumeLightCall(d);
+  return d;
+}
+
+void BGDynamics::RemoveVolumeLight(BGDynamicsVolumeLightData* d) {
+  assert(InGameThread());
+  BGDynamicsListRemove(&volume_lights_, d,
+                       &BGDynamicsVolumeLightData::client_index);
+  g_bg_dynamics_server->PushRemoveVolumeLightCall(d);
+}
+
+void BGDynamics::ReleaseVolumeLight(BGDynamicsVolumeLightData* d) {
+  assert(InBGDynamicsThread());
+  volume_light_pool_.Delete(d);
+}
+
+auto BGDynamics::AddFuse() -> BGDynamicsFuseData* {
+  assert(InGameThread());
+  BGDynamicsFuseData* d = fuse_pool_.New();
+  BGDynamicsListAdd(&fuses_, d, &BGDynamicsFuseData::client_index_);
+  g_bg_dynamics_server->PushAddFuseCall(d);
+  return d;
+}
+
+void BGDynamics::RemoveFuse(BGDynamicsFuseData* d) {
+  assert(InGameThread());
+  BGDynamicsListRemove(&fuses_, d, &BGDynamicsFuseData::client_index_);
+  g_bg_dynamics_server->PushRemoveFuseCall(d);
+}
+
+void BGDynamics::ReleaseFuse(BGDynamicsFuseData* d) {
+  assert(InBGDynamicsThread());
+  fuse_pool_.Delete(d);
+}
+
+void BGDynamics::PublishDrawSnapshot(BGDynamicsDrawSnapshot* s) {
+  assert(InBGDynamicsThread());
+  assert(s);
+
+  // If the last one we published was never picked up, it's stale now;
+  // it never left our ownership so we can just kill it here.
+  BGDynamicsDrawSnapshot* old = pending_draw_snapshot_.exchange(s);
+  delete old;
+}
+
+void BGDynamics::UpdateDrawSnapshot() {
+  assert(InGameThread());
+  BGDynamicsDrawSnapshot* s = pending_draw_snapshot_.exchange(nullptr);
+  if (s) {
+    s->SetGameThreadOwnership();
+
+    // Our unique_ptr takes ownership and disposes of the previous one.
+    draw_snapshot_ = std::unique_ptr<BGDynamicsDrawSnapshot>(s);
+  }
 }
 
 void BGDynamics::TooSlow() {
-  if (!Thread::AreThreadsPaused()) {
+  if (!Thread::AreThreadsPaused() && !deterministic_) {
     g_bg_dynamics_server->PushTooSlowCall();
   }
 }
@@ -167,9 +239,25 @@ void BGDynamics::SetDebrisKillHeight(float val) {
   g_bg_dynamics_server->PushSetDebrisKillHeightCall(val);
 }
 
+void BGDynamics::SetStepBudget(float millisecs) {
+  assert(InGameThread());
+  g_bg_dynamics_server->PushSetStepBudgetCall(millisecs);
+}
+
+void BGDynamics::SetDeterministic(bool deterministic) {
+  assert(InGameThread());
+  if (deterministic == deterministic_) {
+    return;
+  }
+  deterministic_ = deterministic;
+  g_bg_dynamics_server->PushSetDeterministicCall(deterministic);
+}
+
 void BGDynamics::Draw(FrameDef* frame_def) {
   assert(InGameThread());
 
+  UpdateDrawSnapshot();
+
   BGDynamicsDrawSnapshot* ds{draw_snapshot_.get()};
   if (!ds) {
     return;
@@ -195,32 +283,38 @@ void BGDynamics::Draw(FrameDef* frame_def) {
     c.Submit();
   }
 
-  // Draw lights.
+  // Draw lights and shadows. These ride along in the graphics blotch
+  // batches (same textures and passes) when there's room, so they all go
+  // out in a single draw.
   if (ds->light_vertices.exists()) {
     assert(ds->light_indices.exists());
     assert(!ds->light_indices->elements.empty());
     assert(!ds->light_vertices->elements.empty());
-    if (!lights_mesh_.exists()) lights_mesh_ = Object::New<SpriteMesh>();
-    lights_mesh_->SetIndexData(ds->light_indices);
-    lights_mesh_->SetData(
-        Object::Ref<MeshBuffer<VertexSprite>>(ds->light_vertices));
-    SpriteComponent c(frame_def->light_shadow_pass());
-    c.SetTexture(g_media->GetTexture(SystemTextureID::kLightSoft));
-    c.DrawMesh(lights_mesh_.get());
-    c.Submit();
+    if (!g_graphics->AddBlotchesSoft(ds->light_indices->elements,
+                                     ds->light_vertices->elements)) {
+      if (!lights_mesh_.exists()) lights_mesh_ = Object::New<SpriteMesh>();
+      lights_mesh_->SetIndexData(ds->light_indices);
+      lights_mesh_->SetData(
+          Object::Ref<MeshBuffer<VertexSprite>>(ds->light_vertices));
+      SpriteComponent c(frame_def->light_shadow_pass());
+      c.SetTexture(g_media->GetTexture(SystemTextureID::kLightSoft));
+      c.DrawMesh(lights_mesh_.get());
+      c.Submit();
+    }
   }
-
-  // Draw shadows.
   if (ds->shadow_vertices.exists()) {
     assert(ds->shadow_indices.exists());
-    if (!shadows_mesh_.exists()) shadows_mesh_ = Object::New<SpriteMesh>();
-    shadows_mesh_->SetIndexData(ds->shadow_indices);
-    shadows_mesh_->SetData(
-        Object::Ref<MeshBuffer<VertexSprite>>(ds->shadow_vertices));
-    SpriteComponent c(frame_def->light_shadow_pass());
-    c.SetTexture(g_media->GetTexture(SystemTextureID::kLight));
-    c.DrawMesh(shadows_mesh_.get());
-    c.Submit();
+    if (!g_graphics->AddBlotches(ds->shadow_indices->elements,
+                                 ds->shadow_vertices->elements)) {
+      if (!shadows_mesh_.exists()) shadows_mesh_ = Object::New<SpriteMesh>();
+      shadows_mesh_->SetIndexData(ds->shadow_indices);
+      shadows_mesh_->SetData(
+          Object::Ref<MeshBuffer<VertexSprite>>(ds->shadow_vertices));
+      SpriteComponent c(frame_def->light_shadow_pass());
+      c.SetTexture(g_media->GetTexture(SystemTextureID::kLight));
+      c.DrawMesh(shadows_mesh_.get());
+      c.Submit();
+    }
   }
 
   // Draw chunks.
@@ -3,10 +3,12 @@
 #ifndef BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_H_
 #define BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
 #include "ballistica/core/object.h"
+#include "ballistica/dynamics/bg/bg_dynamics_data_pool.h"
 #include "ballistica/math/vector3f.h"
 
 namespace ballistica {
@@ -61,14 +63,40 @@ class BGDynamics {
   void Draw(FrameDef* frame_def);
   void SetDebrisFriction(float val);
   void SetDebrisKillHeight(float val);
+
+  // Milliseconds per step the bg dynamics thread should try to stay under;
+  // it scales debris detail down smoothly when it goes over.
+  void SetStepBudget(float millisecs);
+
+  // In deterministic mode, randomness is seeded from scene time and
+  // emission order and steps are never dropped or thinned for load, so
+  // identical replays produce identical debris.
+  void SetDeterministic(bool deterministic);
   void AddTerrain(CollideModelData* o);
   void RemoveTerrain(CollideModelData* o);
 
-  // (sent to us by the bg dynamics server)
-  void SetDrawSnapshot(BGDynamicsDrawSnapshot* s);
+  // Registration for client-side shadow/light/fuse objects. We keep our own
+  // lists of these so building step data never touches the server's lists.
+  // Data comes from pools; once removed, the server hands it back to us
+  // with the Release calls after any steps using it are done.
+  auto AddShadow(float height_scaling) -> BGDynamicsShadowData*;
+  void RemoveShadow(BGDynamicsShadowData* d);
+  void ReleaseShadow(BGDynamicsShadowData* d);
+  auto AddVolumeLight() -> BGDynamicsVolumeLightData*;
+  void RemoveVolumeLight(BGDynamicsVolumeLightData* d);
+  void ReleaseVolumeLight(BGDynamicsVolumeLightData* d);
+  auto AddFuse() -> BGDynamicsFuseData*;
+  void RemoveFuse(BGDynamicsFuseData* d);
+  void ReleaseFuse(BGDynamicsFuseData* d);
+
+  // Called by the bg dynamics server (in its own thread) to hand us a new
+  // snapshot. This never blocks; if we haven't picked up the previous one
+  // yet it is simply replaced.
+  void PublishDrawSnapshot(BGDynamicsDrawSnapshot* s);
 
  private:
   BGDynamics();
+  void UpdateDrawSnapshot();
   void DrawChunks(FrameDef* frame_def, std::vector<Matrix44f>* instances,
                   BGDynamicsChunkType chunk_type);
   Object::Ref<SpriteMesh> lights_mesh_;
@@ -77,6 +105,22 @@ class BGDynamics {
   Object::Ref<MeshIndexedSmokeFull> tendrils_mesh_;
   Object::Ref<MeshIndexedSimpleFull> fuses_mesh_;
   std::unique_ptr<BGDynamicsDrawSnapshot> draw_snapshot_;
+  std::vector<BGDynamicsShadowData*> shadows_;
+  std::vector<BGDynamicsVolumeLightData*> volume_lights_;
+  std::vector<BGDynamicsFuseData*> fuses_;
+  BGDynamicsDataPool<BGDynamicsShadowData> shadow_pool_;
+  BGDynamicsDataPool<BGDynamicsVolumeLightData> volume_light_pool_;
+  BGDynamicsDataPool<BGDynamicsFuseData> fuse_pool_;
+  bool deterministic_{};
+
+  // Emissions so far at the current scene time (keys our random seeds).
+  millisecs_t emit_time_{-1};
+  uint32_t emit_index_{};
+
+  // Latest snapshot published by the server and not yet picked up by us.
+  // Together with the one the server is building and the one we are
+  // drawing this gives us a triple-buffered handoff with no waiting.
+  std::atomic<BGDynamicsDrawSnapshot*> pending_draw_snapshot_{};
 };
 
 }  // namespace ballistica
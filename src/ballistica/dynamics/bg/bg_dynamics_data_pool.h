@@ -0,0 +1,92 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_DATA_POOL_H_
+#define BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_DATA_POOL_H_
+
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+// Slab allocator for the little data blocks clients share with the bg
+// dynamics thread (shadows, lights, fuses). These get created in the game
+// thread and freed in the bg dynamics thread constantly as bombs and such
+// come and go, so we recycle their memory instead of hitting the heap.
+// (The lock is only taken once per creation/free; never during steps).
+template <typename T>
+class BGDynamicsDataPool {
+ public:
+  BGDynamicsDataPool() = default;
+  ~BGDynamicsDataPool() {
+    for (auto&& slab : slabs_) {
+      ::operator delete(slab, std::align_val_t(alignof(T)));
+    }
+  }
+
+  template <typename... ARGS>
+  auto New(ARGS&&... args) -> T* {
+    void* slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_.empty()) {
+        AddSlab();
+      }
+      slot = free_.back();
+      free_.pop_back();
+    }
+    return new (slot) T(std::forward<ARGS>(args)...);
+  }
+
+  void Delete(T* obj) {
+    assert(obj);
+    obj->~T();
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(obj);
+  }
+
+ private:
+  static const size_t kSlabSize = 32;
+
+  void AddSlab() {
+    void* slab =
+        ::operator new(sizeof(T) * kSlabSize, std::align_val_t(alignof(T)));
+    slabs_.push_back(slab);
+
+    // Push in reverse so we hand slots out in address order.
+    for (size_t i = kSlabSize; i > 0; i--) {
+      free_.push_back(static_cast<char*>(slab) + sizeof(T) * (i - 1));
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<void*> free_;
+  std::vector<void*> slabs_;
+  BA_DISALLOW_CLASS_COPIES(BGDynamicsDataPool);
+};
+
+// Add/remove entries to/from one of our data lists, keeping an index in
+// each entry current so removal is a quick swap-and-pop. (This reorders
+// the list, which is fine for all our uses).
+template <typename T>
+void BGDynamicsListAdd(std::vector<T*>* list, T* obj, size_t T::*index) {
+  obj->*index = list->size();
+  list->push_back(obj);
+}
+
+template <typename T>
+void BGDynamicsListRemove(std::vector<T*>* list, T* obj, size_t T::*index) {
+  size_t i = obj->*index;
+  assert(i < list->size() && (*list)[i] == obj);
+  T* last = list->back();
+  (*list)[i] = last;
+  last->*index = i;
+  list->pop_back();
+}
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_DATA_POOL_H_
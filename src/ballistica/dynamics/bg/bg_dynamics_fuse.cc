@@ -2,29 +2,27 @@
 
 #include "ballistica/dynamics/bg/bg_dynamics_fuse.h"
 
+#include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/dynamics/bg/bg_dynamics_fuse_data.h"
 
 namespace ballistica {
 
 BGDynamicsFuse::BGDynamicsFuse() {
-  assert(g_bg_dynamics_server);
+  assert(g_bg_dynamics);
   assert(InGameThread());
 
-  // Allocate our data. We'll pass this to the BGDynamics thread, and
-  // it'll then own it.
-  data_ = new BGDynamicsFuseData();
-  g_bg_dynamics_server->PushAddFuseCall(data_);
+  // Grab our data; this gets shared with the BGDynamics thread, which
+  // releases it once we're gone.
+  data_ = g_bg_dynamics->AddFuse();
 }
 
 BGDynamicsFuse::~BGDynamicsFuse() {
-  assert(g_bg_dynamics_server);
+  assert(g_bg_dynamics);
   assert(InGameThread());
 
-  // Let the data know the client side is dead
-  // so that we're no longer included in step messages.
-  // (since by the time the worker gets it the data will be gone).
-  data_->client_dead_ = true;
-  g_bg_dynamics_server->PushRemoveFuseCall(data_);
+  // This drops us from the step data we send; the worker frees the data
+  // once it has processed any steps already in flight.
+  g_bg_dynamics->RemoveFuse(data_);
 }
 
 void BGDynamicsFuse::SetTransform(const Matrix44f& t) {
@@ -74,7 +74,8 @@ struct BGDynamicsFuseData {
         a = 0.3f;
       }
       int count = 2;
-      if (dyn->graphics_quality() <= GraphicsQuality::kLow) {
+      if (dyn->graphics_quality() <= GraphicsQuality::kLow
+          || dyn->lod_scale() < 0.75f) {
         count = 1;
       }
 
@@ -91,7 +92,6 @@ struct BGDynamicsFuseData {
     }
   }
 
-  bool client_dead_{};
   float seg_len_{};
   Vector3f target_pts_[kFusePointCount]{};
   Vector3f dyn_pts_[kFusePointCount]{};
@@ -106,6 +106,10 @@ struct BGDynamicsFuseData {
   bool have_transform_client_{};
   bool have_transform_worker_{};
   bool initial_position_set_{};
+
+  // Our spots in the client and worker lists.
+  size_t client_index_{};
+  size_t worker_index_{};
 };
 
 }  // namespace ballistica
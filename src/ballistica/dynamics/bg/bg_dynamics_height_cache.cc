@@ -103,6 +103,64 @@ void BGDynamicsHeightCache::SetGeoms(const std::vector<dGeomID>& geoms) {
   geoms_ = geoms;
 }
 
+void BGDynamicsHeightCache::PrecalcAll() {
+  if (dirty_) {
+    Update();
+  }
+  for (int z = 0; z < grid_height_; z++) {
+    for (int x = 0; x < grid_width_; x++) {
+      SampleCell(x, z);
+    }
+  }
+}
+
+void BGDynamicsHeightCache::Write(std::vector<uint8_t>* buffer) {
+  if (dirty_) {
+    Update();
+  }
+  float bounds[6] = {x_min_, x_max_, y_min_, y_max_, z_min_, z_max_};
+  int32_t dims[2] = {grid_width_, grid_height_};
+  size_t offset = buffer->size();
+  size_t cells_size = heights_.size() * sizeof(float);
+  buffer->resize(offset + sizeof(bounds) + sizeof(dims) + cells_size);
+  uint8_t* out = buffer->data() + offset;
+  memcpy(out, bounds, sizeof(bounds));
+  memcpy(out + sizeof(bounds), dims, sizeof(dims));
+  memcpy(out + sizeof(bounds) + sizeof(dims), heights_.data(), cells_size);
+}
+
+auto BGDynamicsHeightCache::Read(const uint8_t** data,
+                                 const uint8_t* data_end) -> bool {
+  if (dirty_) {
+    Update();
+  }
+  float bounds[6];
+  int32_t dims[2];
+  size_t header_size = sizeof(bounds) + sizeof(dims);
+  size_t cells_size = heights_.size() * sizeof(float);
+  if (static_cast<size_t>(data_end - *data) < header_size + cells_size) {
+    return false;
+  }
+  memcpy(bounds, *data, sizeof(bounds));
+  memcpy(dims, *data + sizeof(bounds), sizeof(dims));
+  if (dims[0] != grid_width_ || dims[1] != grid_height_) {
+    return false;
+  }
+
+  // Our bounds come straight from geom AABBs, but allow for a bit of
+  // float slop between the machine that wrote this and us.
+  float our_bounds[6] = {x_min_, x_max_, y_min_, y_max_, z_min_, z_max_};
+  for (int i = 0; i < 6; i++) {
+    if (std::abs(bounds[i] - our_bounds[i]) > 0.001f) {
+      return false;
+    }
+  }
+  memcpy(heights_.data(), *data + header_size, cells_size);
+  memset(heights_valid_.data(), 1, heights_valid_.size());
+  *data += header_size + cells_size;
+  return true;
+}
+
 void BGDynamicsHeightCache::Update() {
   // Calc our full dimensions.
   if (geoms_.empty()) {
@@ -19,6 +19,15 @@ class BGDynamicsHeightCache {
   auto Sample(const Vector3f& pos) -> float;
   void SetGeoms(const std::vector<dGeomID>& geoms);
 
+  // Sample every cell now instead of as they're needed.
+  void PrecalcAll();
+
+  // Append our cells to a buffer or load them back from one (advancing
+  // the data pointer). Reading fails and leaves us untouched if the data
+  // was made for a different set of geoms.
+  void Write(std::vector<uint8_t>* buffer);
+  auto Read(const uint8_t** data, const uint8_t* data_end) -> bool;
+
  private:
   auto SampleCell(int x, int y) -> float;
   void Update();
@@ -2,6 +2,14 @@
 
 #include "ballistica/dynamics/bg/bg_dynamics_server.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+#include "ballistica/app/app_globals.h"
+#include "ballistica/core/event_trace.h"
 #include "ballistica/dynamics/bg/bg_dynamics_draw_snapshot.h"
 #include "ballistica/dynamics/bg/bg_dynamics_fuse_data.h"
 #include "ballistica/dynamics/bg/bg_dynamics_height_cache.h"
@@ -12,6 +20,7 @@
 #include "ballistica/generic/utils.h"
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/media/component/collide_model.h"
+#include "ballistica/platform/platform.h"
 
 namespace ballistica {
 
@@ -29,6 +38,18 @@ const float kShadowOccludeDistance = 0.5f;
 // How big the shadow gets at its max dist.
 const float kMaxShadowScale = 3.0f;
 
+// Detail level never drops below this, however far over budget we are.
+const float kMinLODScale = 0.2f;
+
+// Detail lost per step while over budget and regained per step while
+// comfortably under it; we drop fast and recover slowly so we don't
+// oscillate.
+const float kLODDropRate = 0.01f;
+const float kLODRecoverRate = 0.002f;
+
+// Fraction of our budget we must be under before we start recovering.
+const float kLODRecoverThreshold = 0.7f;
+
 const float kSmokeBaseGlow = 0.0f;
 const float kSmokeGlow = 400.0f;
 
@@ -101,6 +122,15 @@ class BGDynamicsServer::Terrain {
   dGeomID geom_;
 };
 
+// Fields get bucketed into a grid of these (on the ground plane) each step
+// so points only need to look at fields in their own cell.
+const float kFieldCellSize = 5.0f;
+
+static auto FieldCellKey(int x, int z) -> uint64_t {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32u)
+         | static_cast<uint32_t>(z);
+}
+
 class BGDynamicsServer::Field {
  public:
   Field(BGDynamicsServer* t, const Vector3f& pos, float mag)
@@ -152,7 +182,11 @@ class BGDynamicsServer::Tendril {
     }
     void UpdateDistortion(const BGDynamicsServer& d) {
       p_distorted = p;
-      for (auto&& fi : d.fields_) {
+      const std::vector<Field*>* fields = d.FieldsNear(p);
+      if (!fields) {
+        return;
+      }
+      for (auto&& fi : *fields) {
         const Field& f(*fi);
         float fRad = f.rad();
         float fRadSquared = fRad * fRad;
@@ -224,10 +258,10 @@ class BGDynamicsServer::Tendril {
       : has_updated_{false},
         controller_{nullptr},
         emitting_{true},
-        emit_rate_{0.8f + 0.4f * RandomFloat()},
+        emit_rate_{0.8f + 0.4f * t->Rand()},
         birth_time_{t->time()},
-        radius_{0.1f + RandomFloat() * 0.1f},
-        tex_coord_{RandomFloat()},
+        radius_{0.1f + t->Rand() * 0.1f},
+        tex_coord_{t->Rand()},
         start_erode_{0.1f},
         start_spread_{4.0f},
         side_spread_rate_{1.0f},
@@ -386,17 +420,17 @@ class BGDynamicsServer::Chunk {
         birth_time_{t->time()},
         flicker_{1.0f},
         flicker_scale_{1.0f} {
-    flicker_scale_ = RandomFloat();                             // NOLINT
+    flicker_scale_ = t->Rand();                             // NOLINT
     flicker_scale_ = 1.0f - (flicker_scale_ * flicker_scale_);  // NOLINT
     if (type_ != BGDynamicsChunkType::kFlagStand) {
       if (type_ == BGDynamicsChunkType::kSplinter) {
-        size_[0] = event.scale * 0.15f * (0.4f + 0.6f * RandomFloat());
-        size_[1] = event.scale * 0.15f * (0.4f + 0.6f * RandomFloat());
-        size_[2] = event.scale * 0.15f * (0.4f + 0.6f * RandomFloat()) * 5.0f;
+        size_[0] = event.scale * 0.15f * (0.4f + 0.6f * t->Rand());
+        size_[1] = event.scale * 0.15f * (0.4f + 0.6f * t->Rand());
+        size_[2] = event.scale * 0.15f * (0.4f + 0.6f * t->Rand()) * 5.0f;
       } else {
-        size_[0] = event.scale * 0.15f * (0.3f + 0.7f * RandomFloat());
-        size_[1] = event.scale * 0.15f * (0.3f + 0.7f * RandomFloat());
-        size_[2] = event.scale * 0.15f * (0.3f + 0.7f * RandomFloat());
+        size_[0] = event.scale * 0.15f * (0.3f + 0.7f * t->Rand());
+        size_[1] = event.scale * 0.15f * (0.3f + 0.7f * t->Rand());
+        size_[2] = event.scale * 0.15f * (0.3f + 0.7f * t->Rand());
       }
     } else {
       size_[0] = size_[1] = size_[2] = 1.0f;
@@ -404,11 +438,11 @@ class BGDynamicsServer::Chunk {
 
     lifespan_ = 10000;
     if (type_ == BGDynamicsChunkType::kSpark) {
-      lifespan_ = 500 + RandomFloat() * 1500;
-      if (RandomFloat() < 0.1f) lifespan_ *= 3.0f;
+      lifespan_ = 500 + t->Rand() * 1500;
+      if (t->Rand() < 0.1f) lifespan_ *= 3.0f;
     } else if (type_ == BGDynamicsChunkType::kSweat) {
-      lifespan_ = 200 + RandomFloat() * 400;
-      if (RandomFloat() < 0.1f) lifespan_ *= 2.0f;
+      lifespan_ = 200 + t->Rand() * 400;
+      if (t->Rand() < 0.1f) lifespan_ *= 2.0f;
     } else if (type_ == BGDynamicsChunkType::kFlagStand) {
       lifespan_ = 99999999.0f;
     }
@@ -424,24 +458,24 @@ class BGDynamicsServer::Chunk {
 
       Vector3f v = event.velocity;
       float spread = event.spread;
-      Vector3f v_rand = (Utils::Sphrand() + d_bias).Normalized() * RandomFloat()
+      Vector3f v_rand = (t->RandSphere() + d_bias).Normalized() * t->Rand()
                         * 40.0f * spread;
 
       dBodySetPosition(body_, event.position.x, event.position.y,
                        event.position.z);
       dBodySetLinearVel(body_, v.x + v_rand.x, v.y + v_rand.y, v.z + v_rand.z);
-      dBodySetAngularVel(body_, (RandomFloat() - 0.5f) * 5.0f,
-                         (RandomFloat() - 0.5f) * 5.0f,
-                         (RandomFloat() - 0.5f) * 5.0f);
+      dBodySetAngularVel(body_, (t->Rand() - 0.5f) * 5.0f,
+                         (t->Rand() - 0.5f) * 5.0f,
+                         (t->Rand() - 0.5f) * 5.0f);
     } else {
       Vector3f axis{};
       if (type_ == BGDynamicsChunkType::kFlagStand) {
         axis = Vector3f(0, 1, 0);
       } else {
-        axis = Utils::Sphrand();
+        axis = t->RandSphere();
       }
       Matrix44f m = Matrix44fScale(Vector3f(size_[0], size_[1], size_[2]))
-                    * Matrix44fRotate(axis, RandomFloat() * 360.0f)
+                    * Matrix44fRotate(axis, t->Rand() * 360.0f)
                     * Matrix44fTranslate(event.position);
       for (int i = 0; i < 16; i++) {
         static_transform_[i] = m.m[i];
@@ -493,158 +527,227 @@ class BGDynamicsServer::Chunk {
   friend class BGDynamicsServer;
 };  // Chunk
 
-// Contains 2 ping-ponging particle buffers.
+void BGDynamicsServer::ParticleSet::Resize(size_t count) {
+  for (auto* v : {&x_, &y_, &z_, &vx_, &vy_, &vz_, &r_, &g_, &b_, &a_, &life_,
+                  &d_life_, &flicker_, &flicker_scale_, &size_, &d_size_}) {
+    v->resize(count);
+  }
+}
+
 void BGDynamicsServer::ParticleSet::Emit(const Vector3f& pos,
                                          const Vector3f& vel, float r, float g,
                                          float b, float a, float dlife,
                                          float size, float d_size,
                                          float flicker) {
-  particles[current_set].resize(particles[current_set].size() + 1);
-  Particle& p(particles[current_set].back());
-  p.x = pos.x;
-  p.y = pos.y;
-  p.z = pos.z;
-  p.vx = vel.x * 1.0f + 0.02f * (RandomFloat() - 0.5f);
-  p.vy = vel.y * 1.0f + 0.02f * (RandomFloat() - 0.5f);
-  p.vz = vel.z * 1.0f + 0.02f * (RandomFloat() - 0.5f);
-  p.r = r;
-  p.g = g;
-  p.b = b;
-  p.a = a;
-  p.life = 1.0f;
   assert(dlife < 0.0f);
-  p.d_life = dlife;
-  p.size = size;
-  p.flicker = 1.0f;
-  p.flicker_scale = flicker;
-  p.d_size = d_size;
+  x_.push_back(pos.x);
+  y_.push_back(pos.y);
+  z_.push_back(pos.z);
+  vx_.push_back(vel.x * 1.0f + 0.02f * (Random() - 0.5f));
+  vy_.push_back(vel.y * 1.0f + 0.02f * (Random() - 0.5f));
+  vz_.push_back(vel.z * 1.0f + 0.02f * (Random() - 0.5f));
+  r_.push_back(r);
+  g_.push_back(g);
+  b_.push_back(b);
+  a_.push_back(a);
+  life_.push_back(1.0f);
+  d_life_.push_back(dlife);
+  size_.push_back(size);
+  flicker_.push_back(1.0f);
+  flicker_scale_.push_back(flicker);
+  d_size_.push_back(d_size);
 }
 
 void BGDynamicsServer::ParticleSet::UpdateAndCreateSnapshot(
     Object::Ref<MeshIndexBuffer16>* index_buffer,
     Object::Ref<MeshBufferVertexSprite>* buffer) {
-  auto p_count = static_cast<uint32_t>(particles[current_set].size());
+  PrepareSnapshot(index_buffer, buffer);
+  Update();
+  FinishSnapshot(index_buffer, buffer);
+}
+
+void BGDynamicsServer::ParticleSet::PrepareSnapshot(
+    Object::Ref<MeshIndexBuffer16>* index_buffer,
+    Object::Ref<MeshBufferVertexSprite>* buffer) {
+  pending_count_ = static_cast<uint32_t>(x_.size());
+  pending_remaining_ = pending_rendered_ = 0;
+  pending_indices_ = nullptr;
+  pending_vertices_ = nullptr;
 
   // Quick-out: return empty.
-  if (p_count == 0) {
+  if (pending_count_ == 0) {
+    *index_buffer = Object::Ref<MeshIndexBuffer16>();
+    *buffer = Object::Ref<MeshBufferVertexSprite>();
     return;
   }
 
-  Particle* p_src = &particles[current_set][0];
-
-  // Resize target to fit if all particles stay alive.
-  particles[!current_set].resize(particles[current_set].size());
-  Particle* p_dst = &particles[!current_set][0];
-
-  auto* ibuf = Object::NewDeferred<MeshIndexBuffer16>(p_count * 6);
+  // Size for the case where all particles stay alive and visible.
+  auto* ibuf = Object::NewDeferred<MeshIndexBuffer16>(pending_count_ * 6);
 
   // Game thread is default owner; needs to be us until we hand it over.
   ibuf->SetThreadOwnership(Object::ThreadOwnership::kNextReferencing);
   *index_buffer = Object::MakeRefCounted(ibuf);
-  auto* vbuf = Object::NewDeferred<MeshBufferVertexSprite>(p_count * 4);
+  auto* vbuf = Object::NewDeferred<MeshBufferVertexSprite>(pending_count_ * 4);
 
   // Game thread is default owner; needs to be us until we hand it over.
   vbuf->SetThreadOwnership(Object::ThreadOwnership::kNextReferencing);
   *buffer = Object::MakeRefCounted(vbuf);
 
-  uint16_t* i_render = &(*index_buffer)->elements[0];
-  VertexSprite* p_render = &(*buffer)->elements[0];
+  pending_indices_ = &(*index_buffer)->elements[0];
+  pending_vertices_ = &(*buffer)->elements[0];
+}
+
+void BGDynamicsServer::ParticleSet::Update() {
+  uint32_t p_count = pending_count_;
+  if (p_count == 0) {
+    return;
+  }
+  assert(pending_indices_ && pending_vertices_);
+
+  // First integrate everything in straight passes over each array
+  // (these vectorize nicely). Dead particles get culled below.
+  {
+    float* x = x_.data();
+    float* y = y_.data();
+    float* z = z_.data();
+    float* vy = vy_.data();
+    float* life = life_.data();
+    float* size = size_.data();
+    const float* vx = vx_.data();
+    const float* vz = vz_.data();
+    const float* d_life = d_life_.data();
+    const float* d_size = d_size_.data();
+    for (uint32_t i = 0; i < p_count; i++) {
+      life[i] += d_life[i];
+      size[i] = std::max(0.0f, size[i] + d_size[i]);
+    }
+    for (uint32_t i = 0; i < p_count; i++) {
+      x[i] += vx[i];
+      y[i] += vy[i];
+      z[i] += vz[i];
+      vy[i] -= 0.00001f;
+    }
+  }
+
+  // Now cull dead particles (compacting survivors in place), update
+  // flicker, and write sprites for anything visible.
+  uint16_t* i_render = pending_indices_;
+  VertexSprite* p_render = pending_vertices_;
   uint32_t p_index = 0;
   uint32_t p_count_remaining = 0;
   uint32_t p_count_rendered = 0;
   for (uint32_t i = 0; i < p_count; i++) {
-    float life = p_src->life + p_src->d_life;
-
-    // Our opacity drops rapidly at the end.
-    float o = 1.0f - life;
-    o = 1.0f - (o * o * o);
-    float size = std::max(0.0f, p_src->size + p_src->d_size);
+    float life = life_[i];
+    float size = size_[i];
 
     // Kill the particle if life or size falls to 0.
-    if (life > 0.0f && size > 0) {
-      p_count_remaining++;
-      p_dst->life = life;
-      p_dst->size = size;
-      p_dst->x = p_src->x + p_src->vx;
-      p_dst->y = p_src->y + p_src->vy;
-      p_dst->z = p_src->z + p_src->vz;
-      p_dst->r = p_src->r;
-      p_dst->g = p_src->g;
-      p_dst->b = p_src->b;
-      p_dst->a = p_src->a;
-      p_dst->vx = p_src->vx;
-      p_dst->vy = p_src->vy - 0.00001f;
-      p_dst->vz = p_src->vz;
-      p_dst->d_life = p_src->d_life;
-      p_dst->d_size = p_src->d_size;
-      p_dst->flicker_scale = p_src->flicker_scale;
-
-      // Every so often update our flicker value if we're flickering.
-      if (p_src->flicker_scale != 0.0f) {
-        if (RandomFloat() < 0.2f) {
-          p_dst->flicker = std::max(
-              0.0f, 1.0f + (RandomFloat() - 0.5f) * p_src->flicker_scale);
-        } else {
-          p_dst->flicker = p_src->flicker;
-        }
-      } else {
-        p_dst->flicker = 1.0f;
+    if (!(life > 0.0f && size > 0)) {
+      continue;
+    }
+    uint32_t d = p_count_remaining++;
+    if (d != i) {
+      x_[d] = x_[i];
+      y_[d] = y_[i];
+      z_[d] = z_[i];
+      vx_[d] = vx_[i];
+      vy_[d] = vy_[i];
+      vz_[d] = vz_[i];
+      r_[d] = r_[i];
+      g_[d] = g_[i];
+      b_[d] = b_[i];
+      a_[d] = a_[i];
+      life_[d] = life;
+      d_life_[d] = d_life_[i];
+      size_[d] = size;
+      d_size_[d] = d_size_[i];
+      flicker_[d] = flicker_[i];
+      flicker_scale_[d] = flicker_scale_[i];
+    }
+
+    // Every so often update our flicker value if we're flickering.
+    float flicker_scale = flicker_scale_[d];
+    if (flicker_scale != 0.0f) {
+      if (Random() < 0.2f) {
+        flicker_[d] =
+            std::max(0.0f, 1.0f + (Random() - 0.5f) * flicker_scale);
+      }
+    } else {
+      flicker_[d] = 1.0f;
+    }
+
+    // Render this point if it's got a positive size.
+    float flicker = flicker_[d];
+    if (flicker > 0.0f) {
+      p_count_rendered++;
+
+      // Our opacity drops rapidly at the end.
+      float o = 1.0f - life;
+      o = 1.0f - (o * o * o);
+
+      // Add our 6 indices.
+      {
+        i_render[0] = static_cast<uint16_t>(p_index);
+        i_render[1] = static_cast<uint16_t>(p_index + 1);
+        i_render[2] = static_cast<uint16_t>(p_index + 2);
+        i_render[3] = static_cast<uint16_t>(p_index + 1);
+        i_render[4] = static_cast<uint16_t>(p_index + 3);
+        i_render[5] = static_cast<uint16_t>(p_index + 2);
       }
 
-      // Render this point if it's got a positive size.
-      if (p_dst->flicker > 0.0f && p_dst->size > 0.0f) {
-        p_count_rendered++;
-
-        // Add our 6 indices.
-        {
-          i_render[0] = static_cast<uint16_t>(p_index);
-          i_render[1] = static_cast<uint16_t>(p_index + 1);
-          i_render[2] = static_cast<uint16_t>(p_index + 2);
-          i_render[3] = static_cast<uint16_t>(p_index + 1);
-          i_render[4] = static_cast<uint16_t>(p_index + 3);
-          i_render[5] = static_cast<uint16_t>(p_index + 2);
-        }
-
-        p_render[0].uv[0] = 0;
-        p_render[0].uv[1] = 0;
-        p_render[1].uv[0] = 0;
-        p_render[1].uv[1] = 65535;
-        p_render[2].uv[0] = 65535;
-        p_render[2].uv[1] = 0;
-        p_render[3].uv[0] = 65535;
-        p_render[3].uv[1] = 65535;
-
-        p_render[0].position[0] = p_render[1].position[0] =
-            p_render[2].position[0] = p_render[3].position[0] = p_dst->x;
-        p_render[0].position[1] = p_render[1].position[1] =
-            p_render[2].position[1] = p_render[3].position[1] = p_dst->y;
-        p_render[0].position[2] = p_render[1].position[2] =
-            p_render[2].position[2] = p_render[3].position[2] = p_dst->z;
-        p_render[0].size = p_render[1].size = p_render[2].size =
-            p_render[3].size = p_dst->size * p_dst->flicker;
-        p_render[0].color[0] = p_render[1].color[0] = p_render[2].color[0] =
-            p_render[3].color[0] = p_dst->r * o;
-        p_render[0].color[1] = p_render[1].color[1] = p_render[2].color[1] =
-            p_render[3].color[1] = p_dst->g * o;
-        p_render[0].color[2] = p_render[1].color[2] = p_render[2].color[2] =
-            p_render[3].color[2] = p_dst->b * o;
-        p_render[0].color[3] = p_render[1].color[3] = p_render[2].color[3] =
-            p_render[3].color[3] = p_dst->a * o;
-
-        i_render += 6;
-        p_render += 4;
-        p_index += 4;
+      p_render[0].uv[0] = 0;
+      p_render[0].uv[1] = 0;
+      p_render[1].uv[0] = 0;
+      p_render[1].uv[1] = 65535;
+      p_render[2].uv[0] = 65535;
+      p_render[2].uv[1] = 0;
+      p_render[3].uv[0] = 65535;
+      p_render[3].uv[1] = 65535;
+
+      float px = x_[d];
+      float py = y_[d];
+      float pz = z_[d];
+      float psize = size * flicker;
+      float cr = r_[d] * o;
+      float cg = g_[d] * o;
+      float cb = b_[d] * o;
+      float ca = a_[d] * o;
+      for (int v = 0; v < 4; v++) {
+        p_render[v].position[0] = px;
+        p_render[v].position[1] = py;
+        p_render[v].position[2] = pz;
+        p_render[v].size = psize;
+        p_render[v].color[0] = cr;
+        p_render[v].color[1] = cg;
+        p_render[v].color[2] = cb;
+        p_render[v].color[3] = ca;
       }
-      p_dst++;
+
+      i_render += 6;
+      p_render += 4;
+      p_index += 4;
     }
-    p_src++;
   }
 
-  // Clamp dst and render sets to account for deaths.
+
+  // Clamp our arrays to account for deaths.
   if (p_count != p_count_remaining) {
-    particles[!current_set].resize(p_count_remaining);
+    Resize(p_count_remaining);
   }
+  pending_remaining_ = p_count_remaining;
+  pending_rendered_ = p_count_rendered;
+}
 
+void BGDynamicsServer::ParticleSet::FinishSnapshot(
+    Object::Ref<MeshIndexBuffer16>* index_buffer,
+    Object::Ref<MeshBufferVertexSprite>* buffer) {
+  uint32_t p_count = pending_count_;
+  uint32_t p_count_rendered = pending_rendered_;
+  pending_count_ = 0;
+  pending_indices_ = nullptr;
+  pending_vertices_ = nullptr;
+  if (p_count == 0) {
+    return;
+  }
   if (p_count != p_count_rendered) {
     // If we dropped all the way to zero, return empty.
     // Otherwise, return a downsized buffer.
@@ -656,9 +759,63 @@ void BGDynamicsServer::ParticleSet::UpdateAndCreateSnapshot(
       (*buffer)->elements.resize(p_count_rendered * 4);
     }
   }
-  current_set = !current_set;
 }
 
+// A single persistent worker we can hand one job at a time.
+class BGDynamicsServer::HelperThread {
+ public:
+  HelperThread() : thread_([this] { Run(); }) {}
+  ~HelperThread() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      shutting_down_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  // Start running a job; Wait() must be called before the next one.
+  void Start(std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      assert(!job_ && !busy_);
+      job_ = std::move(job);
+      busy_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !busy_; });
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return job_ || shutting_down_; });
+      if (shutting_down_) {
+        return;
+      }
+      std::function<void()> job = std::move(job_);
+      job_ = nullptr;
+      lock.unlock();
+      job();
+      lock.lock();
+      busy_ = false;
+      cv_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::function<void()> job_;
+  bool busy_{};
+  bool shutting_down_{};
+  std::thread thread_;
+};
+
 BGDynamicsServer::BGDynamicsServer(Thread* thread)
     : Module("bgDynamics", thread),
       height_cache_(new BGDynamicsHeightCache()),
@@ -666,6 +823,16 @@ BGDynamicsServer::BGDynamicsServer(Thread* thread)
   BA_PRECONDITION(g_bg_dynamics_server == nullptr);
   g_bg_dynamics_server = this;
 
+  // The game, render, and our own thread are already busy; only spin up a
+  // helper if there's a core left over to run it.
+  if (std::thread::hardware_concurrency() >= 4) {
+    helper_thread_ = std::make_unique<HelperThread>();
+  }
+
+  // Outside of deterministic mode we want different results each run.
+  random_.Seed(static_cast<uint64_t>(
+      std::chrono::steady_clock::now().time_since_epoch().count()));
+
   // NOLINTNEXTLINE(cppcoreguidelines-prefer-member-initializer)
   ode_world_ = dWorldCreate();
   assert(ode_world_);
@@ -775,7 +942,8 @@ void BGDynamicsServer::UpdateTendrils() {
       float fade_rate_randomness = 2.0f;
 
       if (dist > 0.001f) {
-        float span = 0.5f;
+        // Use coarser segments when we're over budget.
+        float span = 0.5f / std::max(0.5f, lod_scale_);
         march_dir = march_dir.Normalized() * span;
         Vector3f from_cam = cam_pos_ - p;
         Vector3f side_vec = Vector3f::Cross(march_dir, from_cam).Normalized();
@@ -784,7 +952,7 @@ void BGDynamicsServer::UpdateTendrils() {
 
         // If this is our first step, drop a span immediately.
         if (!t.has_updated_) {
-          Vector3f r_uniform = Utils::Sphrand(0.2f * t.slice_rand_scale_);
+          Vector3f r_uniform = RandSphere(0.2f * t.slice_rand_scale_);
           float density = emit_rate > 0.1f ? 1.0f : emit_rate / 0.1f;
 
           t.slices_.emplace_back();
@@ -796,39 +964,39 @@ void BGDynamicsServer::UpdateTendrils() {
           slice.p1.v = t.medium_velocity_ * 0.3f
                        + t.velocity_ * inherit_velocity * 0.1f
                        - side_vec * t.radius_ * t.side_spread_rate_ + r_uniform
-                       + Utils::Sphrand(0.13f * t.point_rand_scale_);
+                       + RandSphere(0.13f * t.point_rand_scale_);
           slice.p1.tex_coords[0] = 0.0f;
           slice.p1.tex_coords[1] = tex_coord;
           slice.p1.erode = t.start_erode_;
           slice.p1.erode_rate = std::max(
-              0.0f, density + erode_rate_randomness * (RandomFloat() - 0.5f));
+              0.0f, density + erode_rate_randomness * (Rand() - 0.5f));
           slice.p1.age = 0.0f;
-          slice.p1.bouyancy = 0.3f + 0.2f * RandomFloat();
+          slice.p1.bouyancy = 0.3f + 0.2f * Rand();
           slice.p1.brightness = std::max(
               0.0f, start_brightness
-                        + (RandomFloat() - 0.5f) * start_brightness_rand);
+                        + (Rand() - 0.5f) * start_brightness_rand);
           slice.p1.fade = 0.0f;
           slice.p1.glow_r = slice.p1.glow_g = slice.p1.glow_b = 0.0f;
-          slice.p1.fade_rate = 1.0f + fade_rate_randomness * (RandomFloat());
+          slice.p1.fade_rate = 1.0f + fade_rate_randomness * (Rand());
 
           slice.p2.p = p + t.radius_ * side_vec * start_spread;
           slice.p2.v = t.medium_velocity_ * 0.3f
                        + t.velocity_ * inherit_velocity * 0.1f
                        + side_vec * t.radius_ * t.side_spread_rate_ + r_uniform
-                       + Utils::Sphrand(0.13f * t.point_rand_scale_);
+                       + RandSphere(0.13f * t.point_rand_scale_);
           slice.p2.tex_coords[0] = 0.25f;
           slice.p2.tex_coords[1] = tex_coord;
           slice.p2.erode = t.start_erode_;
           slice.p2.erode_rate = std::max(
-              0.0f, density + erode_rate_randomness * (RandomFloat() - 0.5f));
+              0.0f, density + erode_rate_randomness * (Rand() - 0.5f));
           slice.p2.age = 0.0f;
-          slice.p2.bouyancy = 0.3f + 0.2f * RandomFloat();
+          slice.p2.bouyancy = 0.3f + 0.2f * Rand();
           slice.p2.brightness = std::max(
               0.0f, start_brightness_2
-                        + (RandomFloat() - 0.5f) * start_brightness_rand);
+                        + (Rand() - 0.5f) * start_brightness_rand);
           slice.p2.fade = 0.0f;
           slice.p2.glow_r = slice.p2.glow_g = slice.p2.glow_b = 0.0f;
-          slice.p2.fade_rate = 1.0f + fade_rate_randomness * (RandomFloat());
+          slice.p2.fade_rate = 1.0f + fade_rate_randomness * (Rand());
         }
 
         t.has_updated_ = true;
@@ -850,7 +1018,7 @@ void BGDynamicsServer::UpdateTendrils() {
           // General density stays high until emit rate gets low.
           float density = emit_rate > 0.1f ? 1.0f : emit_rate / 0.1f;
 
-          Vector3f r_uniform = Utils::Sphrand(0.2f * t.slice_rand_scale_);
+          Vector3f r_uniform = RandSphere(0.2f * t.slice_rand_scale_);
           t.slices_.emplace_back();
           Tendril::Slice& slice(t.slices_.back());
           slice.emit_rate = emit_rate;
@@ -860,39 +1028,39 @@ void BGDynamicsServer::UpdateTendrils() {
           slice.p1.v = t.medium_velocity_ * 0.3f
                        + t.velocity_ * inherit_velocity
                        - side_vec * t.radius_ * t.side_spread_rate_ + r_uniform
-                       + Utils::Sphrand(0.2f * t.point_rand_scale_);
+                       + RandSphere(0.2f * t.point_rand_scale_);
           slice.p1.tex_coords[0] = 0.0f;
           slice.p1.tex_coords[1] = tex_coord;
           slice.p1.erode = start_erode;
           slice.p1.erode_rate = std::max(
-              0.0f, density + erode_rate_randomness * (RandomFloat() - 0.5f));
+              0.0f, density + erode_rate_randomness * (Rand() - 0.5f));
           slice.p1.age = 0.0f;
-          slice.p1.bouyancy = 0.3f + 0.2f * RandomFloat();
+          slice.p1.bouyancy = 0.3f + 0.2f * Rand();
           slice.p1.brightness = std::max(
               0.0f, start_brightness
-                        + (RandomFloat() - 0.5f) * start_brightness_rand);
+                        + (Rand() - 0.5f) * start_brightness_rand);
           slice.p1.fade = density * t.start_fade_scale_;
           slice.p1.glow_r = slice.p1.glow_g = slice.p1.glow_b = 0.0f;
-          slice.p1.fade_rate = 1.0f + fade_rate_randomness * (RandomFloat());
+          slice.p1.fade_rate = 1.0f + fade_rate_randomness * (Rand());
 
           slice.p2.p = p + t.radius_ * side_vec * start_spread;
           slice.p2.v = t.medium_velocity_ * 0.3f
                        + t.velocity_ * inherit_velocity
                        + side_vec * t.radius_ * t.side_spread_rate_ + r_uniform
-                       + Utils::Sphrand(0.2f * t.point_rand_scale_);
+                       + RandSphere(0.2f * t.point_rand_scale_);
           slice.p2.tex_coords[0] = 0.25f;
           slice.p2.tex_coords[1] = tex_coord;
           slice.p2.erode = start_erode;
           slice.p2.erode_rate = std::max(
-              0.0f, density + erode_rate_randomness * (RandomFloat() - 0.5f));
+              0.0f, density + erode_rate_randomness * (Rand() - 0.5f));
           slice.p2.age = 0.0f;
-          slice.p2.bouyancy = 0.3f + 0.2f * RandomFloat();
+          slice.p2.bouyancy = 0.3f + 0.2f * Rand();
           slice.p2.brightness = std::max(
               0.0f, start_brightness_2
-                        + (RandomFloat() - 0.5f) * start_brightness_rand);
+                        + (Rand() - 0.5f) * start_brightness_rand);
           slice.p2.fade = density * t.start_fade_scale_;
           slice.p2.glow_r = slice.p2.glow_g = slice.p2.glow_b = 0.0f;
-          slice.p2.fade_rate = 1.0f + fade_rate_randomness * (RandomFloat());
+          slice.p2.fade_rate = 1.0f + fade_rate_randomness * (Rand());
 
           // If our emit rate has dropped to zero, this will be our last span.
           if (t.emit_rate_ <= 0.001f) t.emitting_ = false;
@@ -913,14 +1081,14 @@ void BGDynamicsServer::UpdateTendrils() {
         t.cur_slice_.p1.tex_coords[1] = t.tex_coord_;
         t.cur_slice_.p1.erode = t.start_erode_;
         t.cur_slice_.p1.erode_rate = std::max(
-            0.0f, density + erode_rate_randomness * (RandomFloat() - 0.5f));
+            0.0f, density + erode_rate_randomness * (Rand() - 0.5f));
         t.cur_slice_.p1.age = 0.0f;
         t.cur_slice_.p1.brightness = start_brightness;
         t.cur_slice_.p1.fade = density * t.start_fade_scale_;
         t.cur_slice_.p1.glow_r = t.cur_slice_.p1.glow_g =
             t.cur_slice_.p1.glow_b = 0.0f;
         t.cur_slice_.p1.fade_rate =
-            1.0f + fade_rate_randomness * (RandomFloat());
+            1.0f + fade_rate_randomness * (Rand());
 
         t.cur_slice_.p2.p =
             t.position_ + t.radius_ * side_vec * t.start_spread_;
@@ -928,14 +1096,14 @@ void BGDynamicsServer::UpdateTendrils() {
         t.cur_slice_.p2.tex_coords[1] = t.tex_coord_;
         t.cur_slice_.p2.erode = t.start_erode_;
         t.cur_slice_.p2.erode_rate = std::max(
-            0.0f, density + erode_rate_randomness * (RandomFloat() - 0.5f));
+            0.0f, density + erode_rate_randomness * (Rand() - 0.5f));
         t.cur_slice_.p2.age = 0.0f;
         t.cur_slice_.p2.brightness = start_brightness_2;
         t.cur_slice_.p2.fade = density * t.start_fade_scale_;
         t.cur_slice_.p2.glow_r = t.cur_slice_.p2.glow_g =
             t.cur_slice_.p2.glow_b = 0.0f;
         t.cur_slice_.p2.fade_rate =
-            1.0f + fade_rate_randomness * (RandomFloat());
+            1.0f + fade_rate_randomness * (Rand());
       }
     }
 
@@ -963,14 +1131,12 @@ void BGDynamicsServer::UpdateTendrils() {
 void BGDynamicsServer::Clear() {
   // Clear chunks.
   {
-    auto i = chunks_.begin();
-    while (i != chunks_.end()) {
-      delete *i;
-      chunks_.erase(i);
+    for (auto&& c : chunks_) {
+      delete c;
       chunk_count_--;
-      i = chunks_.begin();
       assert(chunk_count_ >= 0);
     }
+    chunks_.clear();
     assert(chunk_count_ == 0);
   }
 
@@ -991,8 +1157,25 @@ void BGDynamicsServer::Clear() {
   }
 }
 
-void BGDynamicsServer::PushEmitCall(const BGDynamicsEmission& def) {
-  PushCall([this, def] { Emit(def); });
+void BGDynamicsServer::PushEmitCall(const BGDynamicsEmission& def,
+                                    uint64_t random_seed) {
+  PushCall([this, def, random_seed] {
+    if (deterministic_) {
+      random_.Seed(random_seed);
+    }
+    Emit(def);
+  });
+}
+
+auto BGDynamicsServer::RandSphere(float radius) -> Vector3f {
+  while (true) {
+    float x = -1.0f + Rand() * 2.0f;
+    float y = -1.0f + Rand() * 2.0f;
+    float z = -1.0f + Rand() * 2.0f;
+    if (x * x + y * y + z * z <= 1.0f) {
+      return {x * radius, y * radius, z * radius};
+    }
+  }
 }
 
 void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
@@ -1059,6 +1242,16 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
 #endif
   }
 
+  // Scale everything back further if our steps are running over budget.
+  if (lod_scale_ < 1.0f) {
+    emit_count = static_cast<int>(static_cast<float>(emit_count) * lod_scale_);
+    chunk_max = static_cast<int>(static_cast<float>(chunk_max) * lod_scale_);
+    tendril_thick_max =
+        static_cast<int>(static_cast<float>(tendril_thick_max) * lod_scale_);
+    tendril_thin_max =
+        static_cast<int>(static_cast<float>(tendril_thin_max) * lod_scale_);
+  }
+
   if (def.emit_type == BGDynamicsEmitType::kTendrils) {
     if (def.tendril_type == BGDynamicsTendrilType::kThinSmoke) {
       // For thin tendrils, start scaling back once we pass 8 tendrils.
@@ -1113,7 +1306,7 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
     dGeomID ray = dCreateRay(nullptr, 2.0f);
     dGeomRaySetClosestHit(ray, true);
     Vector3f dir = def.velocity;
-    dir.y -= RandomFloat() * 10.0f;  // bias downward
+    dir.y -= Rand() * 10.0f;  // bias downward
     dGeomRaySet(ray, def.position.x, def.position.y, def.position.z, dir.x,
                 dir.y, dir.z);
     dContact contact[1];
@@ -1135,7 +1328,7 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
 
   Vector3f d_bias = {0.0f, 0.0f, 0.0f};
   if (near_surface)
-    d_bias = surface_normal * RandomFloat() * 6.0f * surface_closeness;
+    d_bias = surface_normal * Rand() * 6.0f * surface_closeness;
 
   switch (def.emit_type) {
     case BGDynamicsEmitType::kChunks: {
@@ -1150,14 +1343,14 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
         // going one direction).
 
         auto* chunk = new Chunk(this, def, true, true,
-                                RandomFloat() < 0.8f ? d_bias : kVector3f0);
+                                Rand() < 0.8f ? d_bias : kVector3f0);
 
         bool do_tendril = false;
         if (def.chunk_type == BGDynamicsChunkType::kSpark
-            && RandomFloat() < 0.13f) {  // NOLINT(bugprone-branch-clone)
+            && Rand() < 0.13f) {  // NOLINT(bugprone-branch-clone)
           do_tendril = true;
         } else if (def.chunk_type == BGDynamicsChunkType::kSplinter
-                   && RandomFloat() < 0.2f) {
+                   && Rand() < 0.2f) {
           do_tendril = true;
         }
 
@@ -1172,19 +1365,19 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
             auto* t = new Tendril(this);
             t->type_ = tendril_type;
             t->shading_flip_ = false;
-            t->wind_amt_ = 0.4f + RandomFloat() * 1.6f;
+            t->wind_amt_ = 0.4f + Rand() * 1.6f;
             t->shadow_density_ = 1.0f;
             {
               t->radius_ *= 0.15f;
               t->side_spread_rate_ = 0.3f;
               t->point_rand_scale_ = 0.5f;
               t->slice_rand_scale_ = 0.5f;
-              t->tex_change_rate_ = 1.5f + RandomFloat() * 2.0f;
-              t->emit_rate_falloff_rate_ = 0.2f + RandomFloat() * 0.6f;
+              t->tex_change_rate_ = 1.5f + Rand() * 2.0f;
+              t->emit_rate_falloff_rate_ = 0.2f + Rand() * 0.6f;
               t->start_brightness_max_ = 0.92f;
               t->start_brightness_min_ = 0.9f;
               t->brightness_rand_ = 0.1f;
-              t->start_fade_scale_ = 0.15f + RandomFloat() * 0.2f;
+              t->start_fade_scale_ = 0.15f + Rand() * 0.2f;
               t->glow_scale_ = 1.0f;
             }
             tendrils_.push_back(t);
@@ -1204,8 +1397,8 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
       dGeomID ray = dCreateRay(nullptr, 4.0f);
       dGeomRaySetClosestHit(ray, true);
       for (int i = 0; i < emit_count; i++) {
-        Vector3f dir = Utils::Sphrand(def.spread);
-        dir.y -= def.spread * 2.5f * RandomFloat();  // bias downward
+        Vector3f dir = RandSphere(def.spread);
+        dir.y -= def.spread * 2.5f * Rand();  // bias downward
         dGeomRaySet(ray, def.position.x, def.position.y + 0.5f, def.position.z,
                     dir.x, dir.y, dir.z);
         dContact contact[1];
@@ -1234,7 +1427,7 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
       dGeomID ray = dCreateRay(nullptr, ray_len);
       dGeomRaySetClosestHit(ray, true);
       for (int i = 0; i < emit_count; i++) {
-        Vector3f dir = (Utils::Sphrand() + d_bias * 0.5f).Normalized();
+        Vector3f dir = (RandSphere() + d_bias * 0.5f).Normalized();
         dGeomRaySet(ray, def.position.x, def.position.y + ray_offset,
                     def.position.z, dir.x, dir.y, dir.z);
         dContact contact[1];
@@ -1249,7 +1442,7 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
             // bias direction up a bit... this way it'll hopefully be less
             // likely to point underground when we smash it down on the
             // camera plane
-            vel.y += RandomFloat() * def.spread * 1.0f;
+            vel.y += Rand() * def.spread * 1.0f;
             hit = true;
             break;
           }
@@ -1258,7 +1451,7 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
           // since dbias pushes us all in a direction away from a surface,
           // nudge our start pos in the opposite dir a bit so that we butt up
           // against the surface more
-          pos = def.position + d_bias * RandomFloat() * -0.3f;
+          pos = def.position + d_bias * Rand() * -0.3f;
           vel = dir;
         }
 #if BA_DEBUG_BUILD
@@ -1280,7 +1473,7 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
         pos += to_cam * 0.8f;
 
         // Now that we've got direction, assign random velocity.
-        vel = vel.Normalized() * (10.0f + RandomFloat() * 30.0f);
+        vel = vel.Normalized() * (10.0f + Rand() * 30.0f);
 
         {
           auto* t = new Tendril(this);
@@ -1288,24 +1481,24 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
           t->prev_pos_ = t->position_ = pos;
           t->shadow_position_ = pos;
           t->shading_flip_ = (vel.x > 0.0f);
-          t->wind_amt_ = 0.4f + RandomFloat() * 1.6f;
+          t->wind_amt_ = 0.4f + Rand() * 1.6f;
           t->shadow_density_ = 1.0f;
           t->velocity_ = vel;
           if (def.tendril_type == BGDynamicsTendrilType::kThinSmoke) {
             t->radius_ *= 0.2f;
             t->side_spread_rate_ = 0.3f;
             t->point_rand_scale_ = 0.3f;
-            t->tex_change_rate_ = 1.0f + RandomFloat() * 2.0f;
-            t->emit_rate_falloff_rate_ = 0.45f + RandomFloat() * 0.2f;
+            t->tex_change_rate_ = 1.0f + Rand() * 2.0f;
+            t->emit_rate_falloff_rate_ = 0.45f + Rand() * 0.2f;
             t->start_brightness_max_ = 0.82f;
             t->start_brightness_min_ = 0.8f;
             t->brightness_rand_ = 0.1f;
-            t->start_fade_scale_ = 0.1f + RandomFloat() * 0.2f;
+            t->start_fade_scale_ = 0.1f + Rand() * 0.2f;
             t->glow_scale_ = 0.15f;
           } else {
-            t->radius_ *= 0.7f + RandomFloat() * 0.2f;
-            t->side_spread_rate_ = 0.2f + 4.0f * RandomFloat();
-            t->emit_rate_falloff_rate_ = 0.9f + RandomFloat() * 0.6f;
+            t->radius_ *= 0.7f + Rand() * 0.2f;
+            t->side_spread_rate_ = 0.2f + 4.0f * Rand();
+            t->emit_rate_falloff_rate_ = 0.9f + Rand() * 0.6f;
             t->glow_scale_ = 1.0f;
           }
           tendrils_.push_back(t);
@@ -1342,14 +1535,17 @@ void BGDynamicsServer::Emit(const BGDynamicsEmission& def) {
       break;
     }
     case BGDynamicsEmitType::kFairyDust: {
+      if (lod_scale_ < 1.0f && Rand() > lod_scale_) {
+        break;
+      }
       spark_particles_->Emit(
-          Vector3f(def.position.x + 0.9f * (RandomFloat() - 0.5f),
-                   def.position.y + 0.9f * (RandomFloat() - 0.5f),
-                   def.position.z + 0.9f * (RandomFloat() - 0.5f)),
-          0.001f * def.velocity, 0.8f + 3.0f * +RandomFloat(),
-          0.8f + 3.0f * RandomFloat(), 0.8f + 3.0f * RandomFloat(), 0,
+          Vector3f(def.position.x + 0.9f * (Rand() - 0.5f),
+                   def.position.y + 0.9f * (Rand() - 0.5f),
+                   def.position.z + 0.9f * (Rand() - 0.5f)),
+          0.001f * def.velocity, 0.8f + 3.0f * +Rand(),
+          0.8f + 3.0f * Rand(), 0.8f + 3.0f * Rand(), 0,
           -0.01f,                         // dlife
-          0.05f + 0.05f * RandomFloat(),  // size
+          0.05f + 0.05f * Rand(),  // size
           -0.001f,                        // dsize
           5.0f                            // flicker intensity
       );                                  // NOLINT(whitespace/parens)
@@ -1387,6 +1583,7 @@ void BGDynamicsServer::PushRemoveTerrainCall(CollideModelData* collide_model) {
     }
     height_cache_->SetGeoms(geoms);
     collision_cache_->SetGeoms(geoms);
+    terrain_caches_pending_ = true;
 
     // Clear existing stuff whenever this changes.
     Clear();
@@ -1396,27 +1593,17 @@ void BGDynamicsServer::PushRemoveTerrainCall(CollideModelData* collide_model) {
 void BGDynamicsServer::PushAddShadowCall(BGDynamicsShadowData* shadow_data) {
   PushCall([this, shadow_data] {
     assert(InBGDynamicsThread());
-    std::lock_guard<std::mutex> lock(shadow_list_mutex_);
-    shadows_.push_back(shadow_data);
+    BGDynamicsListAdd(&shadows_, shadow_data,
+                      &BGDynamicsShadowData::worker_index);
   });
 }
 
 void BGDynamicsServer::PushRemoveShadowCall(BGDynamicsShadowData* shadow_data) {
   PushCall([this, shadow_data] {
     assert(InBGDynamicsThread());
-    bool found = false;
-    {
-      std::lock_guard<std::mutex> lock(shadow_list_mutex_);
-      for (auto i = shadows_.begin(); i != shadows_.end(); ++i) {
-        if ((*i) == shadow_data) {
-          found = true;
-          shadows_.erase(i);
-          break;
-        }
-      }
-    }
-    assert(found);
-    delete shadow_data;
+    BGDynamicsListRemove(&shadows_, shadow_data,
+                         &BGDynamicsShadowData::worker_index);
+    g_bg_dynamics->ReleaseShadow(shadow_data);
   });
 }
 
@@ -1424,8 +1611,8 @@ void BGDynamicsServer::PushAddVolumeLightCall(
     BGDynamicsVolumeLightData* volume_light_data) {
   PushCall([this, volume_light_data] {
     // Add to our internal list.
-    std::lock_guard<std::mutex> lock(volume_light_list_mutex_);
-    volume_lights_.push_back(volume_light_data);
+    BGDynamicsListAdd(&volume_lights_, volume_light_data,
+                      &BGDynamicsVolumeLightData::worker_index);
   });
 }
 
@@ -1433,44 +1620,23 @@ void BGDynamicsServer::PushRemoveVolumeLightCall(
     BGDynamicsVolumeLightData* volume_light_data) {
   PushCall([this, volume_light_data] {
     // Remove from our list and kill.
-    bool found = false;
-    {
-      std::lock_guard<std::mutex> lock(volume_light_list_mutex_);
-      for (auto i = volume_lights_.begin(); i != volume_lights_.end(); ++i) {
-        if ((*i) == volume_light_data) {
-          found = true;
-          volume_lights_.erase(i);
-          break;
-        }
-      }
-    }
-    assert(found);
-    delete volume_light_data;
+    BGDynamicsListRemove(&volume_lights_, volume_light_data,
+                         &BGDynamicsVolumeLightData::worker_index);
+    g_bg_dynamics->ReleaseVolumeLight(volume_light_data);
   });
 }
 
 void BGDynamicsServer::PushAddFuseCall(BGDynamicsFuseData* fuse_data) {
   PushCall([this, fuse_data] {
-    std::lock_guard<std::mutex> lock(fuse_list_mutex_);
-    fuses_.push_back(fuse_data);
+    BGDynamicsListAdd(&fuses_, fuse_data, &BGDynamicsFuseData::worker_index_);
   });
 }
 
 void BGDynamicsServer::PushRemoveFuseCall(BGDynamicsFuseData* fuse_data) {
   PushCall([this, fuse_data] {
-    bool found = false;
-    {
-      std::lock_guard<std::mutex> lock(fuse_list_mutex_);
-      for (auto i = fuses_.begin(); i != fuses_.end(); i++) {
-        if ((*i) == fuse_data) {
-          found = true;
-          fuses_.erase(i);
-          break;
-        }
-      }
-    }
-    assert(found);
-    delete fuse_data;
+    BGDynamicsListRemove(&fuses_, fuse_data,
+                         &BGDynamicsFuseData::worker_index_);
+    g_bg_dynamics->ReleaseFuse(fuse_data);
   });
 }
 
@@ -1544,6 +1710,10 @@ auto BGDynamicsServer::CreateDrawSnapshot() -> BGDynamicsDrawSnapshot* {
     }
   }
 
+  // When over budget, only the oldest chunks get shadows.
+  auto shadow_limit = static_cast<uint32_t>(
+      lod_scale_ * static_cast<float>(shadow_max_count) + 0.5f);
+
   Matrix44f* c_rock = nullptr;
   Matrix44f* c_ice = nullptr;
   Matrix44f* c_slime = nullptr;
@@ -1737,7 +1907,7 @@ auto BGDynamicsServer::CreateDrawSnapshot() -> BGDynamicsDrawSnapshot* {
         draw_light = false;
         break;  // These have no shadows.
       default: {
-        draw_shadow = true;
+        draw_shadow = shadow_drawn_count < shadow_limit;
         draw_light = false;
       }
     }
@@ -2204,12 +2374,13 @@ auto BGDynamicsServer::CreateDrawSnapshot() -> BGDynamicsDrawSnapshot* {
     }
   }
 
-  // Now sparks.
-  if (!spark_particles_) {
-    spark_particles_ = std::make_unique<ParticleSet>();
+  // Now sparks (updated in parallel with the rest of our step).
+  if (helper_thread_) {
+    helper_thread_->Wait();
   }
-  spark_particles_->UpdateAndCreateSnapshot(&ss->spark_indices,
-                                            &ss->spark_vertices);
+  spark_particles_->FinishSnapshot(&spark_indices_, &spark_vertices_);
+  ss->spark_indices = std::move(spark_indices_);
+  ss->spark_vertices = std::move(spark_vertices_);
 
   return ss;
 }  // NOLINT (yes this should be shorter)
@@ -2222,21 +2393,18 @@ void BGDynamicsServer::PushTooSlowCall() {
       int killcount =
           static_cast<int>(0.1f * static_cast<float>(chunks_.size()));
       int killed = 0;
-      auto i = chunks_.begin();
-      while (i != chunks_.end()) {
-        if (killed >= killcount) break;
-        auto i_next = i;
-        i_next++;
-
-        // Kill it if its killable; otherwise move to next.
-        if ((**i).can_die()) {
-          delete (*i);
-          chunks_.erase(i);
+      size_t write_index = 0;
+      for (auto&& c : chunks_) {
+        // Kill it if its killable; otherwise keep it.
+        if (killed < killcount && c->can_die()) {
+          delete c;
           chunk_count_--;
           killed++;
+        } else {
+          chunks_[write_index++] = c;
         }
-        i = i_next;
       }
+      chunks_.resize(write_index);
       // ...and tendrils.
       killcount = static_cast<int>(0.2f * static_cast<float>(tendrils_.size()));
       for (int j = 0; j < killcount; j++) {
@@ -2254,14 +2422,56 @@ void BGDynamicsServer::PushTooSlowCall() {
   });
 }
 
+void BGDynamicsServer::PushSetStepBudgetCall(float millisecs) {
+  PushCall([this, millisecs] { step_budget_ = std::max(0.1f, millisecs); });
+}
+
+void BGDynamicsServer::PushSetDeterministicCall(bool deterministic) {
+  PushCall([this, deterministic] {
+    deterministic_ = deterministic;
+    if (deterministic_) {
+      lod_scale_ = 1.0f;
+      step_time_smoothed_ = 0.0f;
+    }
+  });
+}
+
+void BGDynamicsServer::UpdateLOD(float step_millisecs) {
+  // Results can't depend on how fast we happen to be running.
+  if (deterministic_) {
+    return;
+  }
+  step_time_smoothed_ = 0.9f * step_time_smoothed_ + 0.1f * step_millisecs;
+  if (step_time_smoothed_ > step_budget_) {
+    lod_scale_ = std::max(kMinLODScale, lod_scale_ - kLODDropRate);
+  } else if (step_time_smoothed_ < step_budget_ * kLODRecoverThreshold) {
+    lod_scale_ = std::min(1.0f, lod_scale_ + kLODRecoverRate);
+  }
+}
+
 void BGDynamicsServer::Step(StepData* step_data) {
+  BA_TRACE_SCOPE("BGDynamicsServer::Step");
   assert(InBGDynamicsThread());
   assert(step_data);
 
+  auto start_time = std::chrono::steady_clock::now();
+
   // Grab a ref to the raw StepData pointer we were passed... we now own the
   // data.
   auto ref(Object::MakeRefCounted(step_data));
 
+  if (deterministic_) {
+    random_.Seed(step_data->random_seed);
+    spark_particles_->Seed(step_data->random_seed ^ 0x5bd1e995u);
+  }
+
+  // Terrain calls arrive in bunches when maps load; handle their caches
+  // once for the final set.
+  if (terrain_caches_pending_) {
+    terrain_caches_pending_ = false;
+    UpdateTerrainCaches();
+  }
+
   // Keep this in sync with the game thread's.
   graphics_quality_ = g_graphics_server->graphics_quality_requested();
 
@@ -2300,23 +2510,36 @@ void BGDynamicsServer::Step(StepData* step_data) {
   // as soon as possible.
   UpdateShadows();
 
+  // Fuses emit sparks, so get them done before sparks update.
+  UpdateFuses();
+
+  // Spark particles only touch their own state, so they can update
+  // alongside everything else here; CreateDrawSnapshot() collects them.
+  // Everything else shares our ODE world, caches, and random state (and
+  // chunks/fields drive tendrils), so it stays in order on this thread.
+  if (!spark_particles_) {
+    spark_particles_ = std::make_unique<ParticleSet>();
+  }
+  spark_particles_->PrepareSnapshot(&spark_indices_, &spark_vertices_);
+  if (helper_thread_) {
+    ParticleSet* sparks = spark_particles_.get();
+    helper_thread_->Start([sparks] { sparks->Update(); });
+  } else {
+    spark_particles_->Update();
+  }
+
   // Go ahead and run this step for all our existing stuff.
   dJointGroupEmpty(ode_contact_group_);
   UpdateFields();
   UpdateChunks();
   UpdateTendrils();
-  UpdateFuses();
 
   // Step the world.
   dWorldQuickStep(ode_world_, kGameStepSeconds);
 
   // Now generate a snapshot of our state and send it to the game thread,
   // so they can draw us.
-  BGDynamicsDrawSnapshot* snapshot = CreateDrawSnapshot();
-  g_game->PushCall([snapshot] {
-    snapshot->SetGameThreadOwnership();
-    g_bg_dynamics->SetDrawSnapshot(snapshot);
-  });
+  g_bg_dynamics->PublishDrawSnapshot(CreateDrawSnapshot());
 
   time_ += kGameStepMilliseconds;  // milliseconds per step
 
@@ -2324,12 +2547,13 @@ void BGDynamicsServer::Step(StepData* step_data) {
   // there to fill itself in slowly.
   collision_cache_->Precalc();
 
+  UpdateLOD(std::chrono::duration<float, std::milli>(
+                std::chrono::steady_clock::now() - start_time)
+                .count());
+
   // Job's done!
-  {
-    std::lock_guard<std::mutex> lock(step_count_mutex_);
-    step_count_--;
-  }
-  assert(step_count_ >= 0);
+  [[maybe_unused]] int step_count = --step_count_;
+  assert(step_count >= 0);
 }
 
 void BGDynamicsServer::PushStepCall(StepData* data) {
@@ -2356,30 +2580,138 @@ void BGDynamicsServer::PushAddTerrainCall(
     }
     height_cache_->SetGeoms(geoms);
     collision_cache_->SetGeoms(geoms);
+    terrain_caches_pending_ = true;
 
     // Reset our chunks whenever anything changes.
     Clear();
   });
 }
 
+// Precomputed terrain caches live in a '.bgcache' file beside the
+// collide-model that sorts first in the set; they're keyed by the names
+// of all models in the set so a different combo just ignores them
+// and falls back to filling in at runtime.
+static const uint32_t kBGTerrainCacheFileMagic = 0x42474331;  // 'BGC1'
+static const uint32_t kBGTerrainCacheFileVersion = 1;
+
+void BGDynamicsServer::UpdateTerrainCaches() {
+  if (terrains_.empty()) {
+    return;
+  }
+  std::vector<CollideModelData*> models;
+  models.reserve(terrains_.size());
+  for (auto&& t : terrains_) {
+    models.push_back(t->GetCollideModel());
+  }
+  std::sort(models.begin(), models.end(),
+            [](CollideModelData* a, CollideModelData* b) {
+              return a->file_name() < b->file_name();
+            });
+  std::string signature;
+  for (auto&& m : models) {
+    signature += m->file_name() + "\n";
+  }
+  std::string path = models.front()->GetName();
+  if (path.size() > 4 && path.compare(path.size() - 4, 4, ".cob") == 0) {
+    path.resize(path.size() - 4);
+  }
+  path += ".bgcache";
+
+  if (g_app_globals->write_bg_terrain_caches) {
+    height_cache_->PrecalcAll();
+    collision_cache_->PrecalcAll();
+    std::vector<uint8_t> buffer(sizeof(uint32_t) * 3 + signature.size());
+    uint32_t header[3] = {kBGTerrainCacheFileMagic, kBGTerrainCacheFileVersion,
+                          static_cast<uint32_t>(signature.size())};
+    memcpy(buffer.data(), header, sizeof(header));
+    memcpy(buffer.data() + sizeof(header), signature.data(), signature.size());
+    height_cache_->Write(&buffer);
+    collision_cache_->Write(&buffer);
+    FILE* f = g_platform->FOpen(path.c_str(), "wb");
+    if (!f || fwrite(buffer.data(), buffer.size(), 1, f) != 1) {
+      Log("Error writing bg terrain cache '" + path + "'.");
+    } else {
+      Log("Wrote bg terrain cache '" + path + "'.");
+    }
+    if (f) {
+      fclose(f);
+    }
+    return;
+  }
+
+  // Note: our caches go on refining cells as they're used so we read into
+  // our own copy instead of mapping the file.
+  FILE* f = g_platform->FOpen(path.c_str(), "rb");
+  if (!f) {
+    return;
+  }
+  std::vector<uint8_t> buffer;
+  if (fseek(f, 0, SEEK_END) == 0) {
+    long size = ftell(f);  // NOLINT (ftell returns long)
+    if (size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+      buffer.resize(static_cast<size_t>(size));
+      if (fread(buffer.data(), buffer.size(), 1, f) != 1) {
+        buffer.clear();
+      }
+    }
+  }
+  fclose(f);
+  uint32_t header[3];
+  if (buffer.size() < sizeof(header)) {
+    return;
+  }
+  memcpy(header, buffer.data(), sizeof(header));
+  if (header[0] != kBGTerrainCacheFileMagic
+      || header[1] != kBGTerrainCacheFileVersion
+      || header[2] != signature.size()
+      || buffer.size() < sizeof(header) + signature.size()
+      || memcmp(buffer.data() + sizeof(header), signature.data(),
+                signature.size())
+             != 0) {
+    return;
+  }
+  const uint8_t* data = buffer.data() + sizeof(header) + signature.size();
+  const uint8_t* data_end = buffer.data() + buffer.size();
+  if (!height_cache_->Read(&data, data_end)
+      || !collision_cache_->Read(&data, data_end)) {
+    Log("Ignoring stale bg terrain cache '" + path + "'.");
+  }
+}
+
+auto BGDynamicsServer::FieldsNear(const Vector3f& pos) const
+    -> const std::vector<Field*>* {
+  if (field_cells_.empty()) {
+    return nullptr;
+  }
+  auto i = field_cells_.find(
+      FieldCellKey(static_cast<int>(floorf(pos.x / kFieldCellSize)),
+                   static_cast<int>(floorf(pos.z / kFieldCellSize))));
+  return i == field_cells_.end() ? nullptr : &i->second;
+}
+
 void BGDynamicsServer::UpdateFields() {
-  auto i = fields_.begin();
-  while (i != fields_.end()) {
-    Field& f(**i);
+  field_cells_.clear();
+  size_t write_index = 0;
+  for (auto&& fi : fields_) {
+    Field& f(*fi);
 
     // First off, kill this field if its time has come.
-    {
-      bool kill = false;
-      if (static_cast<float>(time_ - f.birth_time()) > f.lifespan()) {
-        kill = true;
-      }
-      if (kill) {
-        auto i_next = i;
-        i_next++;
-        delete *i;
-        fields_.erase(i);
-        i = i_next;
-        continue;
+    if (static_cast<float>(time_ - f.birth_time()) > f.lifespan()) {
+      delete fi;
+      continue;
+    }
+    fields_[write_index++] = fi;
+
+    // Add it to each cell it reaches into.
+    Vector3f pos = f.pos();
+    float rad = f.rad();
+    int x_min = static_cast<int>(floorf((pos.x - rad) / kFieldCellSize));
+    int x_max = static_cast<int>(floorf((pos.x + rad) / kFieldCellSize));
+    int z_min = static_cast<int>(floorf((pos.z - rad) / kFieldCellSize));
+    int z_max = static_cast<int>(floorf((pos.z + rad) / kFieldCellSize));
+    for (int z = z_min; z <= z_max; z++) {
+      for (int x = x_min; x <= x_max; x++) {
+        field_cells_[FieldCellKey(x, z)].push_back(fi);
       }
     }
 
@@ -2416,8 +2748,8 @@ void BGDynamicsServer::UpdateFields() {
                       * Utils::SmoothStep(suck_2_end_time, 1.0f, age));
     }
     f.set_amt(f.amt() * f.mag());
-    i++;
   }
+  fields_.resize(write_index);
 }
 
 void BGDynamicsServer::TerrainCollideCallback(void* data, dGeomID geom1,
@@ -2483,8 +2815,9 @@ void BGDynamicsServer::UpdateChunks() {
   // rather we explicitly test everything against our terrain objects;
   // this keeps things simple.
 
-  for (auto i = chunks_.begin(); i != chunks_.end();) {
-    Chunk& c(**i);
+  size_t write_index = 0;
+  for (auto&& ci : chunks_) {
+    Chunk& c(*ci);
 
     // first off, kill this chunk if its time has come
     {
@@ -2499,28 +2832,25 @@ void BGDynamicsServer::UpdateChunks() {
         if (pos[1] < debris_kill_height_) kill = true;
       }
       if (kill) {
-        auto i_next = i;
-        i_next++;
-        delete *i;
-        chunks_.erase(i);
+        delete ci;
         chunk_count_--;
         assert(chunk_count_ >= 0);
-        i = i_next;
         continue;
       }
     }
+    chunks_[write_index++] = ci;
     BGDynamicsChunkType type = c.type();
 
     // Some spark-specific stuff.
     if (type == BGDynamicsChunkType::kSpark) {
-      if (RandomFloat() < 0.1f) {
+      if (Rand() < 0.1f) {
         float fs = c.flicker_scale_;
-        c.flicker_ = fs * RandomFloat() + (1.0f - fs) * 0.8f;
+        c.flicker_ = fs * Rand() + (1.0f - fs) * 0.8f;
       }
     } else if (type == BGDynamicsChunkType::kSweat) {
       // Some sweat-specific stuff.
-      if (RandomFloat() < 0.25f) {
-        c.flicker_ = RandomFloat();
+      if (Rand() < 0.25f) {
+        c.flicker_ = Rand();
       }
     }
 
@@ -2601,8 +2931,8 @@ void BGDynamicsServer::UpdateChunks() {
         c.UpdateTendril();
       }
     }
-    i++;
   }
+  chunks_.resize(write_index);
 }
 
 void BGDynamicsServer::UpdateShadows() {
@@ -2639,7 +2969,6 @@ void BGDynamicsServer::UpdateShadows() {
   {
     BA_DEBUG_TIME_CHECK_BEGIN(bg_dynamic_shadow_list_lock);
     {
-      std::lock_guard<std::mutex> lock(shadow_list_mutex_);
       for (auto&& s : shadows_) {
         s->UpdateClientData();
       }
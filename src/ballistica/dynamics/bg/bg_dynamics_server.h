@@ -3,14 +3,17 @@
 #ifndef BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_SERVER_H_
 #define BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_SERVER_H_
 
+#include <atomic>
 #include <list>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "ballistica/core/module.h"
 #include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/math/matrix44f.h"
+#include "ballistica/math/random.h"
 #include "ballistica/math/vector3f.h"
 #include "ode/ode.h"
 
@@ -18,36 +21,57 @@ namespace ballistica {
 
 class BGDynamicsServer : public Module {
  public:
-  struct Particle {
-    float x;
-    float y;
-    float z;
-    // Note that velocities here are in units-per-step (avoids a mult).
-    float vx;
-    float vy;
-    float vz;
-    float r;
-    float g;
-    float b;
-    float a;
-    float life;
-    float d_life;
-    float flicker;
-    float flicker_scale;
-    float size;
-    float d_size;
-  };
-
+  // Particle state is stored structure-of-arrays style so the bulk
+  // per-step integration vectorizes well.
+  // Note that velocities here are in units-per-step (avoids a mult).
   class ParticleSet {
    public:
-    std::vector<Particle> particles[2];
-    int current_set;
-    ParticleSet() : current_set(0) {}
     void Emit(const Vector3f& pos, const Vector3f& vel, float r, float g,
               float b, float a, float dlife, float size, float d_size,
               float flicker);
     void UpdateAndCreateSnapshot(Object::Ref<MeshIndexBuffer16>* index_buffer,
                                  Object::Ref<MeshBufferVertexSprite>* buffer);
+
+    // The above, split up so the bulk of the work can happen off the BG
+    // dynamics thread: Update() touches nothing but our own state and the
+    // buffers handed out by PrepareSnapshot(), while PrepareSnapshot() and
+    // FinishSnapshot() need to run on the BG dynamics thread.
+    void PrepareSnapshot(Object::Ref<MeshIndexBuffer16>* index_buffer,
+                         Object::Ref<MeshBufferVertexSprite>* buffer);
+    void Update();
+    void FinishSnapshot(Object::Ref<MeshIndexBuffer16>* index_buffer,
+                        Object::Ref<MeshBufferVertexSprite>* buffer);
+    auto size() const -> size_t { return x_.size(); }
+    void Seed(uint64_t seed) { random_.Seed(seed); }
+
+   private:
+    void Resize(size_t count);
+
+    // We keep our own random generator so updating doesn't touch
+    // global state.
+    auto Random() -> float { return random_.NextFloat(); }
+    SeededRandom random_{0x2545f491};
+    uint16_t* pending_indices_{};
+    VertexSprite* pending_vertices_{};
+    uint32_t pending_count_{};
+    uint32_t pending_remaining_{};
+    uint32_t pending_rendered_{};
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> z_;
+    std::vector<float> vx_;
+    std::vector<float> vy_;
+    std::vector<float> vz_;
+    std::vector<float> r_;
+    std::vector<float> g_;
+    std::vector<float> b_;
+    std::vector<float> a_;
+    std::vector<float> life_;
+    std::vector<float> d_life_;
+    std::vector<float> flicker_;
+    std::vector<float> flicker_scale_;
+    std::vector<float> size_;
+    std::vector<float> d_size_;
   };
   struct ShadowStepData {
     Vector3f position;
@@ -71,6 +95,9 @@ class BGDynamicsServer : public Module {
     }
     Vector3f cam_pos{0.0f, 0.0f, 0.0f};
 
+    // In deterministic mode we reseed with this at the start of the step.
+    uint64_t random_seed{};
+
     // Basically a bit list of pointers to the current set of
     // shadows/volumes/fuses and client values for them.
     std::vector<std::pair<BGDynamicsShadowData*, ShadowStepData> >
@@ -93,12 +120,16 @@ class BGDynamicsServer : public Module {
   void PushRemoveShadowCall(BGDynamicsShadowData* shadow_data);
   void PushAddTerrainCall(Object::Ref<CollideModelData>* collide_model);
   void PushRemoveTerrainCall(CollideModelData* collide_model);
-  void PushEmitCall(const BGDynamicsEmission& def);
+  void PushEmitCall(const BGDynamicsEmission& def, uint64_t random_seed);
   auto spark_particles() const -> ParticleSet* {
     return spark_particles_.get();
   }
   auto step_count() const -> int { return step_count_; }
 
+  // Detail level (0-1) we're currently running at to stay in our step
+  // budget.
+  auto lod_scale() const -> float { return lod_scale_; }
+
  private:
   class Terrain;
   class Chunk;
@@ -109,13 +140,22 @@ class BGDynamicsServer : public Module {
   static void TerrainCollideCallback(void* data, dGeomID o1, dGeomID o2);
 
   void Emit(const BGDynamicsEmission& def);
+
+  // All our randomness comes from these so it can be made repeatable.
+  auto Rand() -> float { return random_.NextFloat(); }
+  auto RandSphere(float radius = 1.0f) -> Vector3f;
   void PushStepCall(StepData* data);
   void Step(StepData* data);
   void PushTooSlowCall();
   void PushSetDebrisFrictionCall(float friction);
   void PushSetDebrisKillHeightCall(float height);
+  void PushSetStepBudgetCall(float millisecs);
+  void PushSetDeterministicCall(bool deterministic);
+  void UpdateLOD(float step_millisecs);
+  void UpdateTerrainCaches();
   void Clear();
   void UpdateFields();
+  auto FieldsNear(const Vector3f& pos) const -> const std::vector<Field*>*;
   void UpdateChunks();
   void UpdateTendrils();
   void UpdateFuses();
@@ -142,26 +182,46 @@ class BGDynamicsServer : public Module {
   dWorldID ode_world_{nullptr};
   dJointGroupID ode_contact_group_{nullptr};
 
-  // Held by the dynamics module when changing any of these lists.
-  // Should be grabbed by a client if they need to access the list safely.
-  std::mutex shadow_list_mutex_;
-  std::mutex volume_light_list_mutex_;
-  std::mutex fuse_list_mutex_;
-  int step_count_{0};
-  std::mutex step_count_mutex_;
+  // Steps sent by the game thread and not yet completed by us.
+  std::atomic<int> step_count_{0};
   std::unique_ptr<ParticleSet> spark_particles_{nullptr};
-  std::list<Chunk*> chunks_;
-  std::list<Field*> fields_;
+
+  // Runs spark particle updates alongside the rest of each step on
+  // machines with cores to spare.
+  class HelperThread;
+  std::unique_ptr<HelperThread> helper_thread_;
+  Object::Ref<MeshIndexBuffer16> spark_indices_;
+  Object::Ref<MeshBufferVertexSprite> spark_vertices_;
+  std::vector<Chunk*> chunks_;
+  std::vector<Field*> fields_;
+
+  // Live fields by ground-plane grid cell (rebuilt each step).
+  std::unordered_map<uint64_t, std::vector<Field*> > field_cells_;
   std::list<Tendril*> tendrils_;
   int tendril_count_thick_{0};
   int tendril_count_thin_{0};
   int chunk_count_{0};
   std::unique_ptr<BGDynamicsHeightCache> height_cache_;
   std::unique_ptr<CollisionCache> collision_cache_;
+
+  // Our terrain set changed and we should look for a precomputed cache
+  // file for it.
+  bool terrain_caches_pending_{};
   uint32_t time_{0};  // Internal time step.
   float debris_friction_{1.0f};
   float debris_kill_height_{-50.0f};
   GraphicsQuality graphics_quality_{GraphicsQuality::kLow};
+
+  // Milliseconds of work per step we aim to stay under, how long steps
+  // have actually been taking, and the detail level that results.
+  float step_budget_{2.0f};
+  float step_time_smoothed_{};
+  float lod_scale_{1.0f};
+
+  // When set, we reseed from values keyed on scene time so identical
+  // inputs give identical results, and we don't adapt to load.
+  bool deterministic_{};
+  SeededRandom random_;
   friend class BGDynamics;
 };
 
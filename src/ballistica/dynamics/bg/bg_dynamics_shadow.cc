@@ -2,7 +2,7 @@
 
 #include "ballistica/dynamics/bg/bg_dynamics_shadow.h"
 
-#include "ballistica/dynamics/bg/bg_dynamics_server.h"
+#include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/dynamics/bg/bg_dynamics_shadow_data.h"
 #include "ballistica/graphics/graphics.h"
 
@@ -11,22 +11,19 @@ namespace ballistica {
 BGDynamicsShadow::BGDynamicsShadow(float height_scaling) {
   assert(InGameThread());
 
-  // allocate our shadow data... we'll pass this to the BGDynamics thread,
-  // which will then own it.
-  data_ = new BGDynamicsShadowData(height_scaling);
-  assert(g_bg_dynamics_server);
-  g_bg_dynamics_server->PushAddShadowCall(data_);
+  // Grab our shadow data; this gets shared with the BGDynamics thread,
+  // which releases it once we're gone.
+  assert(g_bg_dynamics);
+  data_ = g_bg_dynamics->AddShadow(height_scaling);
 }
 
 BGDynamicsShadow::~BGDynamicsShadow() {
   assert(InGameThread());
-  assert(g_bg_dynamics_server);
+  assert(g_bg_dynamics);
 
-  // let the data know the client side is dead,
-  // so we're no longer included in step messages
-  // (since by the time the worker gets it the data will be gone)
-  data_->client_dead = true;
-  g_bg_dynamics_server->PushRemoveShadowCall(data_);
+  // This drops us from the step data we send; the worker frees the data
+  // once it has processed any steps already in flight.
+  g_bg_dynamics->RemoveShadow(data_);
 }
 
 void BGDynamicsShadow::SetPosition(const Vector3f& pos) {
@@ -44,8 +41,8 @@ void BGDynamicsShadow::GetValues(float* scale, float* density) const {
   assert(scale);
   assert(density);
 
-  *scale = data_->shadow_scale_client;
-  *density = data_->shadow_density_client
+  *scale = data_->shadow_scale_client.load(std::memory_order_relaxed);
+  *density = data_->shadow_density_client.load(std::memory_order_relaxed)
              * g_graphics->GetShadowDensity(
                  data_->pos_client.x, data_->pos_client.y, data_->pos_client.z);
 }
@@ -3,6 +3,8 @@
 #ifndef BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_SHADOW_DATA_H_
 #define BALLISTICA_DYNAMICS_BG_BG_DYNAMICS_SHADOW_DATA_H_
 
+#include <atomic>
+
 namespace ballistica {
 
 struct BGDynamicsShadowData {
@@ -12,16 +14,20 @@ struct BGDynamicsShadowData {
   void UpdateClientData() {
     // Copy data over with a bit of smoothing
     // (so our shadow doesn't jump instantly when we go over and edge/etc.)
+    // Only we write these; the client just reads whatever is there.
     float smoothing{0.8f};
-    shadow_scale_client = smoothing * shadow_scale_client
-                          + (1.0f - smoothing) * shadow_scale_worker;
-    shadow_density_client = smoothing * shadow_density_client
-                            + (1.0f - smoothing) * shadow_density_worker;
+    shadow_scale_client.store(
+        smoothing * shadow_scale_client.load(std::memory_order_relaxed)
+            + (1.0f - smoothing) * shadow_scale_worker,
+        std::memory_order_relaxed);
+    shadow_density_client.store(
+        smoothing * shadow_density_client.load(std::memory_order_relaxed)
+            + (1.0f - smoothing) * shadow_density_worker,
+        std::memory_order_relaxed);
   }
 
   void Synchronize() { pos_worker = pos_client; }
 
-  bool client_dead{};
   float height_scaling{};
 
   // For use by worker:
@@ -37,8 +43,12 @@ struct BGDynamicsShadowData {
   float shadow_density_worker{0.0f};
 
   // Result values owned by the client (read-only).
-  float shadow_scale_client{1.0f};
-  float shadow_density_client{0.0f};
+  std::atomic<float> shadow_scale_client{1.0f};
+  std::atomic<float> shadow_density_client{0.0f};
+
+  // Our spots in the client and worker lists.
+  size_t client_index{};
+  size_t worker_index{};
 };
 
 }  // namespace ballistica
@@ -2,29 +2,26 @@
 
 #include "ballistica/dynamics/bg/bg_dynamics_volume_light.h"
 
+#include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/dynamics/bg/bg_dynamics_volume_light_data.h"
 
 namespace ballistica {
 
 BGDynamicsVolumeLight::BGDynamicsVolumeLight() {
   assert(InGameThread());
-  // allocate our light data... we'll pass this to the BGDynamics thread,
-  // which will then own it
-  data_ = new BGDynamicsVolumeLightData();
-  assert(g_bg_dynamics_server);
-  g_bg_dynamics_server->PushAddVolumeLightCall(data_);
+  // Grab our light data; this gets shared with the BGDynamics thread,
+  // which releases it once we're gone.
+  assert(g_bg_dynamics);
+  data_ = g_bg_dynamics->AddVolumeLight();
 }
 
 BGDynamicsVolumeLight::~BGDynamicsVolumeLight() {
   assert(InGameThread());
 
-  // let the data know the client side is dead,
-  // so we're no longer included in step messages
-  // (since by the time the worker gets it the data will be gone)
-  data_->client_dead = true;
-
-  assert(g_bg_dynamics_server);
-  g_bg_dynamics_server->PushRemoveVolumeLightCall(data_);
+  // This drops us from the step data we send; the worker frees the data
+  // once it has processed any steps already in flight.
+  assert(g_bg_dynamics);
+  g_bg_dynamics->RemoveVolumeLight(data_);
 }
 
 void BGDynamicsVolumeLight::SetPosition(const Vector3f& pos) {
@@ -8,8 +8,6 @@
 namespace ballistica {
 
 struct BGDynamicsVolumeLightData {
-  bool client_dead{};
-
   // Position value owned by the client.
   Vector3f pos_client{0.0f, 0.0f, 0.0f};
   float radius_client{};
@@ -23,6 +21,10 @@ struct BGDynamicsVolumeLightData {
   float r_worker{};
   float g_worker{};
   float b_worker{};
+
+  // Our spots in the client and worker lists.
+  size_t client_index{};
+  size_t worker_index{};
 };
 
 }  // namespace ballistica
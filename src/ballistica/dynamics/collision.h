@@ -7,6 +7,7 @@
 
 #include "ballistica/ballistica.h"
 #include "ballistica/core/object.h"
+#include "ballistica/core/object_pool.h"
 #include "ballistica/dynamics/material/material_context.h"
 #include "ode/ode.h"
 
@@ -19,7 +20,9 @@ namespace ballistica {
 // overlapping in the simulation.
 class Collision : public Object {
  public:
+  BA_OBJECT_POOLED(Collision);
   explicit Collision(Scene* scene) : src_context(scene), dst_context(scene) {}
+  ~Collision() override;
   int claim_count{};  // Used when checking for out-of-date-ness.
   bool collide{true};
   int contact_count{};  // Current number of contacts.
@@ -2,6 +2,8 @@
 
 #include "ballistica/dynamics/collision_cache.h"
 
+#include <algorithm>
+
 #include "ballistica/graphics/component/simple_component.h"
 #include "ode/ode_collision_kernel.h"
 #include "ode/ode_collision_space_internal.h"
@@ -18,8 +20,69 @@ CollisionCache::~CollisionCache() {
 }
 
 void CollisionCache::SetGeoms(const std::vector<dGeomID>& geoms) {
-  dirty_ = true;
+  // Note: we store AABBs as of now so we can invalidate cells for geoms
+  // after they're removed (they may be dead by then).
+  std::vector<std::array<dReal, 6> > aabbs(geoms.size());
+  for (size_t i = 0; i < geoms.size(); i++) {
+    dGeomGetAABB(geoms[i], aabbs[i].data());
+  }
+
+  // If we've not built our grid yet (or need a full rebuild anyway)
+  // there's nothing to selectively invalidate.
+  if (!dirty_) {
+    for (size_t i = 0; i < geoms_.size() && !dirty_; i++) {
+      if (std::find(geoms.begin(), geoms.end(), geoms_[i]) == geoms.end()) {
+        dirty_ = !InvalidateCells(geom_aabbs_[i].data(), false);
+      }
+    }
+    for (size_t i = 0; i < geoms.size() && !dirty_; i++) {
+      if (std::find(geoms_.begin(), geoms_.end(), geoms[i]) == geoms_.end()) {
+        dirty_ = !InvalidateCells(aabbs[i].data(), true);
+      }
+    }
+  }
   geoms_ = geoms;
+  geom_aabbs_ = std::move(aabbs);
+}
+
+auto CollisionCache::GetCellRange(const dReal* aabb, int* x_min, int* x_max,
+                                  int* z_min, int* z_max) const -> void {
+  *x_min = static_cast<int>(static_cast<float>(grid_width_)
+                            * ((aabb[0] - x_min_) / (x_max_ - x_min_)));
+  *x_min = std::max(0, std::min(grid_width_ - 1, *x_min));
+  *z_min = static_cast<int>(static_cast<float>(grid_height_)
+                            * ((aabb[4] - z_min_) / (z_max_ - z_min_)));
+  *z_min = std::max(0, std::min(grid_height_ - 1, *z_min));
+  *x_max = static_cast<int>(static_cast<float>(grid_width_)
+                            * ((aabb[1] - x_min_) / (x_max_ - x_min_)));
+  *x_max = std::max(0, std::min(grid_width_ - 1, *x_max));
+  *z_max = static_cast<int>(static_cast<float>(grid_height_)
+                            * ((aabb[5] - z_min_) / (z_max_ - z_min_)));
+  *z_max = std::max(0, std::min(grid_height_ - 1, *z_max));
+}
+
+auto CollisionCache::InvalidateCells(const dReal* aabb, bool added) -> bool {
+  // Removed geometry can only shrink our bounds, so leaving them as they
+  // are stays correct. Added geometry beyond them needs a full rebuild.
+  if (added
+      && (aabb[0] < x_min_ || aabb[1] > x_max_ || aabb[2] < y_min_
+          || aabb[3] > y_max_ || aabb[4] < z_min_ || aabb[5] > z_max_)) {
+    return false;
+  }
+  int x_min, x_max, z_min, z_max;
+  GetCellRange(aabb, &x_min, &x_max, &z_min, &z_max);
+  for (int z = z_min; z <= z_max; z++) {
+    int base_index = z * grid_width_;
+    for (int x = x_min; x <= x_max; x++) {
+      Cell& cell = cells_[base_index + x];
+      if (added) {
+        cell.height_confirmed_empty_ = y_max_;
+      } else {
+        cell.height_confirmed_collide_ = y_min_;
+      }
+    }
+  }
+  return true;
 }
 
 void CollisionCache::Draw(FrameDef* frame_def) {
@@ -138,6 +201,76 @@ void CollisionCache::Precalc() {
   TestCell(precalc_index_++, x, z);
 }
 
+auto CollisionCache::PrecalcAll() -> void {
+  Update();
+
+  // Each test halves a cell's unknown range; this is plenty to get any
+  // sane map down to TestCell's cutoff.
+  for (int pass = 0; pass < 32; pass++) {
+    for (int z = 0; z < grid_height_; z++) {
+      for (int x = 0; x < grid_width_; x++) {
+        TestCell(static_cast<size_t>(z * grid_width_ + x), x, z);
+      }
+    }
+  }
+}
+
+auto CollisionCache::Write(std::vector<uint8_t>* buffer) -> void {
+  Update();
+  float bounds[6] = {x_min_, x_max_, y_min_, y_max_, z_min_, z_max_};
+  int32_t dims[2] = {grid_width_, grid_height_};
+  size_t offset = buffer->size();
+  buffer->resize(offset + sizeof(bounds) + sizeof(dims)
+                 + cells_.size() * sizeof(float) * 2);
+  uint8_t* out = buffer->data() + offset;
+  memcpy(out, bounds, sizeof(bounds));
+  out += sizeof(bounds);
+  memcpy(out, dims, sizeof(dims));
+  out += sizeof(dims);
+  for (auto&& cell : cells_) {
+    float heights[2] = {cell.height_confirmed_empty_,
+                        cell.height_confirmed_collide_};
+    memcpy(out, heights, sizeof(heights));
+    out += sizeof(heights);
+  }
+}
+
+auto CollisionCache::Read(const uint8_t** data, const uint8_t* data_end)
+    -> bool {
+  Update();
+  float bounds[6];
+  int32_t dims[2];
+  size_t header_size = sizeof(bounds) + sizeof(dims);
+  size_t cells_size = cells_.size() * sizeof(float) * 2;
+  if (static_cast<size_t>(data_end - *data) < header_size + cells_size) {
+    return false;
+  }
+  memcpy(bounds, *data, sizeof(bounds));
+  memcpy(dims, *data + sizeof(bounds), sizeof(dims));
+  if (dims[0] != grid_width_ || dims[1] != grid_height_) {
+    return false;
+  }
+
+  // Our bounds come straight from geom AABBs, but allow for a bit of
+  // float slop between the machine that wrote this and us.
+  float our_bounds[6] = {x_min_, x_max_, y_min_, y_max_, z_min_, z_max_};
+  for (int i = 0; i < 6; i++) {
+    if (std::abs(bounds[i] - our_bounds[i]) > 0.001f) {
+      return false;
+    }
+  }
+  const uint8_t* in = *data + header_size;
+  for (auto&& cell : cells_) {
+    float heights[2];
+    memcpy(heights, in, sizeof(heights));
+    in += sizeof(heights);
+    cell.height_confirmed_empty_ = heights[0];
+    cell.height_confirmed_collide_ = heights[1];
+  }
+  *data = in;
+  return true;
+}
+
 void CollisionCache::CollideAgainstGeom(dGeomID g1, void* data,
                                         dNearCallback* callback) {
   // Update bounds, test for quick out against our height map,
@@ -153,19 +286,8 @@ void CollisionCache::CollideAgainstGeom(dGeomID g1, void* data,
     return;
   }
 
-  int x_min = static_cast<int>(static_cast<float>(grid_width_)
-                               * ((g1->aabb[0] - x_min_) / (x_max_ - x_min_)));
-  x_min = std::max(0, std::min(grid_width_ - 1, x_min));
-  int z_min = static_cast<int>(static_cast<float>(grid_height_)
-                               * ((g1->aabb[4] - z_min_) / (z_max_ - z_min_)));
-  z_min = std::max(0, std::min(grid_height_ - 1, z_min));
-
-  int x_max = static_cast<int>(static_cast<float>(grid_width_)
-                               * ((g1->aabb[1] - x_min_) / (x_max_ - x_min_)));
-  x_max = std::max(0, std::min(grid_width_ - 1, x_max));
-  int z_max = static_cast<int>(static_cast<float>(grid_height_)
-                               * ((g1->aabb[5] - z_min_) / (z_max_ - z_min_)));
-  z_max = std::max(0, std::min(grid_height_ - 1, z_max));
+  int x_min, x_max, z_min, z_max;
+  GetCellRange(bounds1, &x_min, &x_max, &z_min, &z_max);
 
   // If all cells are confirmed empty to the bottom of our AABB, we're done.
   bool possible_hit = false;
@@ -258,8 +380,18 @@ void CollisionCache::CollideAgainstSpace(dSpaceID space, void* data,
   // caching into play.
   if (!geoms_.empty()) {
     // Intersect all geoms in the space against all terrains.
-    for (dxGeom* g1 = space->first; g1; g1 = g1->next) {
-      CollideAgainstGeom(g1, data, callback);
+    // (Only plain/hash spaces keep their geoms in a linked list; other
+    // types need to go through the generic accessors).
+    int space_class = dGeomGetClass(space);
+    if (space_class == dSimpleSpaceClass || space_class == dHashSpaceClass) {
+      for (dxGeom* g1 = space->first; g1; g1 = g1->next) {
+        CollideAgainstGeom(g1, data, callback);
+      }
+    } else {
+      int geom_count = dSpaceGetNumGeoms(space);
+      for (int i = 0; i < geom_count; i++) {
+        CollideAgainstGeom(dSpaceGetGeom(space, i), data, callback);
+      }
     }
   }
 }
@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_DYNAMICS_COLLISION_CACHE_H_
 #define BALLISTICA_DYNAMICS_COLLISION_CACHE_H_
 
+#include <array>
 #include <vector>
 
 #include "ballistica/ballistica.h"
@@ -17,7 +18,9 @@ class CollisionCache {
   CollisionCache();
   ~CollisionCache();
 
-  // If returns true, the provided AABB *may* intersect the geoms.
+  // Set the (static) geoms we cover. When called with a small change to our
+  // existing set (a terrain being added, removed or moved), only cells
+  // under the affected geoms are invalidated instead of the whole grid.
   auto SetGeoms(const std::vector<dGeomID>& geoms) -> void;
   auto Draw(FrameDef* f) -> void;  // For debugging.
   auto CollideAgainstSpace(dSpaceID space, void* data, dNearCallback* callback)
@@ -29,11 +32,31 @@ class CollisionCache {
   // the cache so there's less to do during spurts of activity;
   void Precalc();
 
+  // Fully resolve every cell now instead of bit by bit.
+  auto PrecalcAll() -> void;
+
+  // Append our cells to a buffer or load them back from one (advancing
+  // the data pointer). Reading fails and leaves us untouched if the data
+  // was made for a different set of geoms.
+  auto Write(std::vector<uint8_t>* buffer) -> void;
+  auto Read(const uint8_t** data, const uint8_t* data_end) -> bool;
+
  private:
   auto TestCell(size_t cell_index, int x, int z) -> void;
   auto Update() -> void;
+
+  // Get the range of cells overlapped by an AABB (clamped to our grid).
+  auto GetCellRange(const dReal* aabb, int* x_min, int* x_max, int* z_min,
+                    int* z_max) const -> void;
+
+  // Forget what we know about cells under an AABB. Adding geometry voids
+  // 'confirmed empty' heights and removing it voids 'confirmed collide'
+  // ones. Returns false if the AABB is not fully within our bounds (in
+  // which case the caller needs to do a full update).
+  auto InvalidateCells(const dReal* aabb, bool added) -> bool;
   uint32_t precalc_index_{};
   std::vector<dGeomID> geoms_;
+  std::vector<std::array<dReal, 6> > geom_aabbs_;  // As of SetGeoms().
   struct Cell {
     float height_confirmed_empty_;
     float height_confirmed_collide_;
@@ -2,14 +2,22 @@
 
 #include "ballistica/dynamics/dynamics.h"
 
+#include <algorithm>
+
+#include "ballistica/app/app_globals.h"
 #include "ballistica/audio/audio.h"
 #include "ballistica/audio/audio_source.h"
+#include "ballistica/core/event_trace.h"
 #include "ballistica/dynamics/collision.h"
 #include "ballistica/dynamics/collision_cache.h"
+#include "ballistica/dynamics/material/material.h"
 #include "ballistica/dynamics/material/material_action.h"
+#include "ballistica/dynamics/material/material_component.h"
 #include "ballistica/dynamics/part.h"
 #include "ballistica/graphics/renderer.h"
 #include "ballistica/media/component/sound.h"
+#include "ballistica/python/python_context_call.h"
+#include "ballistica/python/python_sys.h"
 #include "ballistica/scene/scene.h"
 #include "ode/ode_collision_kernel.h"
 #include "ode/ode_collision_util.h"
@@ -22,6 +30,16 @@ namespace ballistica {
 //  we may get contacts only at one end of an object, etc.
 #define MAX_CONTACTS 20
 
+// Material sounds of the same type this close together in a step (or
+// shortly after one already played) get merged into a single sound.
+const float kSoundClusterRadius = 1.5f;
+const millisecs_t kSoundClusterTime = 100;
+const millisecs_t kLoopingSoundClusterTime = 250;
+
+// A pile of things hitting at once should sound a bit louder than one of
+// them; not louder by the size of the pile.
+const float kSoundClusterMaxGainBoost = 1.5f;
+
 // Given two parts, returns true if part1 is major in
 // the storage order.
 static auto IsInStoreOrder(int64_t node1, int part1, int64_t node2, int part2)
@@ -90,48 +108,325 @@ class Dynamics::CollisionEvent {
         collision(collision_in) {}
 };
 
-class Dynamics::SrcPartCollideMap {
+class Dynamics::Impl {
  public:
-  std::unordered_map<int, Object::Ref<Collision> > dst_part_collisions;
-};
+  explicit Impl(Dynamics* dynamics) : dynamics_(dynamics) {}
 
-class Dynamics::DstNodeCollideMap {
- public:
-  std::unordered_map<int, SrcPartCollideMap> src_parts;
-  int collideDisabled;
-  DstNodeCollideMap() : collideDisabled(0) {}
-  ~DstNodeCollideMap() = default;
-};
+  // Identifies a collision between two parts (always in store order).
+  struct PartPairKey {
+    int64_t node1;
+    int part1;
+    int64_t node2;
+    int part2;
+    auto operator==(const PartPairKey& other) const -> bool {
+      return node1 == other.node1 && part1 == other.part1
+             && node2 == other.node2 && part2 == other.part2;
+    }
+    auto Hash() const -> size_t {
+      return MixHash(static_cast<uint64_t>(node1) * 31u
+                     + static_cast<uint64_t>(part1)
+                     + (static_cast<uint64_t>(node2) << 32u)
+                     + (static_cast<uint64_t>(part2) << 20u));
+    }
+  };
+
+  // Identifies a pair of colliding nodes (always in store order).
+  struct NodePairKey {
+    int64_t node1;
+    int64_t node2;
+    auto operator==(const NodePairKey& other) const -> bool {
+      return node1 == other.node1 && node2 == other.node2;
+    }
+    auto Hash() const -> size_t {
+      return MixHash(static_cast<uint64_t>(node1) * 31u
+                     + (static_cast<uint64_t>(node2) << 32u));
+    }
+  };
+
+  // State shared by all part collisions between a pair of nodes; lives
+  // as long as any such collisions do.
+  struct NodePairState {
+    int collision_count{};
+    bool collide_disabled{};
+  };
+
+  // Identifies the material sets of a src part and the dst part it hits.
+  struct MaterialSetPairKey {
+    std::vector<Material*> src;
+    std::vector<Material*> dst;
+    auto operator==(const MaterialSetPairKey& other) const -> bool {
+      return src == other.src && dst == other.dst;
+    }
+    auto Hash() const -> size_t {
+      uint64_t val = src.size();
+      for (auto* m : src) {
+        val = MixHash(val * 31u + reinterpret_cast<uintptr_t>(m));
+      }
+      for (auto* m : dst) {
+        val = MixHash(val * 37u + reinterpret_cast<uintptr_t>(m));
+      }
+      return static_cast<size_t>(val);
+    }
+  };
+
+  // The material components that can apply between a pair of material
+  // sets, in application order, with conditions pre-evaluated as far as
+  // the sets allow. Components with a negative program offset apply
+  // unconditionally; others run their compiled conditions first.
+  struct MaterialSetPairActions {
+    struct Entry {
+      MaterialComponent* component;
+      int32_t program_offset;
+    };
+    std::vector<Entry> entries;
+    std::vector<int32_t> program;
+  };
+
+  // A simple open-addressed (linear-probing) hash map. Entries are stored
+  // densely so walking all of them is a straight pass through memory; the
+  // slot table just holds indices into that storage. Erasing moves the
+  // last entry into the erased one's place, so indices are not stable
+  // across erases and value pointers are invalidated by any insert/erase.
+  template <typename K, typename V>
+  class FlatMap {
+   public:
+    auto size() const -> size_t { return entries_.size(); }
+    auto key(size_t index) const -> const K& { return entries_[index].key; }
+    auto value(size_t index) -> V& { return entries_[index].value; }
+
+    // Return the index of a key's entry, or -1 if not present.
+    auto FindIndex(const K& key) const -> int32_t {
+      int32_t slot = FindSlot(key);
+      return slot < 0 ? -1 : slots_[slot];
+    }
 
-class Dynamics::SrcNodeCollideMap {
- public:
-  std::unordered_map<int64_t, DstNodeCollideMap> dst_nodes;
-};
+    auto Find(const K& key) -> V* {
+      int32_t slot = FindSlot(key);
+      return slot < 0 ? nullptr : &entries_[slots_[slot]].value;
+    }
 
-class Dynamics::Impl {
- public:
-  explicit Impl(Dynamics* dynamics) : dynamics_(dynamics) {}
+    // Return the value for a key (default-constructing it if need be)
+    // and whether it was newly added.
+    auto Insert(const K& key) -> std::pair<V*, bool> {
+      int32_t slot = FindSlot(key);
+      if (slot >= 0) {
+        return {&entries_[slots_[slot]].value, false};
+      }
+      if ((entries_.size() + 1) * 2 > slots_.size()) {
+        Rehash(std::max(size_t{64}, slots_.size() * 2));
+      }
+      size_t mask = slots_.size() - 1;
+      size_t s = key.Hash() & mask;
+      while (slots_[s] != kEmptySlot) {
+        s = (s + 1) & mask;
+      }
+      slots_[s] = static_cast<int32_t>(entries_.size());
+      entries_.push_back({key, V()});
+      return {&entries_.back().value, true};
+    }
+
+    auto Erase(const K& key) -> void {
+      int32_t slot = FindSlot(key);
+      if (slot >= 0) {
+        EraseSlot(static_cast<size_t>(slot));
+      }
+    }
+
+    auto Clear() -> void {
+      entries_.clear();
+      slots_.clear();
+    }
+
+    auto EraseAt(size_t index) -> void {
+      int32_t slot = FindSlot(entries_[index].key);
+      assert(slot >= 0 && slots_[slot] == static_cast<int32_t>(index));
+      EraseSlot(static_cast<size_t>(slot));
+    }
+
+   private:
+    struct Entry {
+      K key;
+      V value;
+    };
+    static constexpr int32_t kEmptySlot{-1};
+
+    auto FindSlot(const K& key) const -> int32_t {
+      if (slots_.empty()) {
+        return -1;
+      }
+      size_t mask = slots_.size() - 1;
+      for (size_t s = key.Hash() & mask;; s = (s + 1) & mask) {
+        int32_t index = slots_[s];
+        if (index == kEmptySlot) {
+          return -1;
+        }
+        if (entries_[index].key == key) {
+          return static_cast<int32_t>(s);
+        }
+      }
+    }
+
+    auto EraseSlot(size_t slot) -> void {
+      auto index = static_cast<size_t>(slots_[slot]);
+
+      // Close the gap in the probe sequence by shifting later entries
+      // back (so we never need tombstones). Entries whose home slot lies
+      // cyclically within (hole, s] have to stay where they are.
+      size_t mask = slots_.size() - 1;
+      size_t hole = slot;
+      for (size_t s = (slot + 1) & mask; slots_[s] != kEmptySlot;
+           s = (s + 1) & mask) {
+        size_t home = entries_[slots_[s]].key.Hash() & mask;
+        bool stays = (hole <= s) ? (hole < home && home <= s)
+                                 : (hole < home || home <= s);
+        if (!stays) {
+          slots_[hole] = slots_[s];
+          hole = s;
+        }
+      }
+      slots_[hole] = kEmptySlot;
+
+      // Now fill the vacated storage with our last entry.
+      size_t last = entries_.size() - 1;
+      if (index != last) {
+        int32_t moved_slot = FindSlot(entries_[last].key);
+        assert(moved_slot >= 0);
+        slots_[moved_slot] = static_cast<int32_t>(index);
+        entries_[index] = entries_[last];
+      }
+      entries_.pop_back();
+    }
+
+    auto Rehash(size_t slot_count) -> void {
+      assert((slot_count & (slot_count - 1)) == 0);
+      slots_.assign(slot_count, kEmptySlot);
+      size_t mask = slot_count - 1;
+      for (size_t i = 0; i < entries_.size(); i++) {
+        size_t s = entries_[i].key.Hash() & mask;
+        while (slots_[s] != kEmptySlot) {
+          s = (s + 1) & mask;
+        }
+        slots_[s] = static_cast<int32_t>(i);
+      }
+    }
+
+    std::vector<Entry> entries_;
+    std::vector<int32_t> slots_;
+  };
+
+  // Run disconnect logic for the collision at the provided index and
+  // remove it.
+  auto HandleDisconnect(size_t index) -> void;
+
+  // Remove the collision at the provided index (and its node-pair state
+  // if it was the last collision between those nodes).
+  auto RemoveCollision(size_t index) -> void;
 
-  // NOTE: we need to implement this here in an Impl class because
-  // gcc currently chokes on unordered_maps with forward-declared types,
-  // so we can't have this in our header without pushing all our map/collision
-  // types there too.
-  auto HandleDisconnect(
-      const std::unordered_map<
-          int64_t, ballistica::Dynamics::SrcNodeCollideMap>::iterator& i,
-      const std::unordered_map<
-          int64_t, ballistica::Dynamics::DstNodeCollideMap>::iterator& j,
-      const std::unordered_map<int, SrcPartCollideMap>::iterator& k,
-      const std::unordered_map<int, Object::Ref<Collision> >::iterator& l)
+  // Apply src_part's materials to a context the same way
+  // Part::ApplyMaterials() would, but using cached per-material-set
+  // results.
+  auto ApplyMaterials(MaterialContext* context, const Part* src_part,
+                      const Part* dst_part) -> void;
+
+  // Hand any queued collision actions to the batch call.
+  auto RunCollisionBatch() -> void;
+
+  // Gather a one-shot material sound (impact or connect); these get
+  // played at the end of collision processing, one per cluster of like
+  // sounds, with their gains summed.
+  auto AddClusteredSound(Sound* sound, float x, float y, float z, float gain)
       -> void;
+  auto PlayClusteredSounds() -> void;
+
+  // Whether a looping material sound (skid or roll) should start at a
+  // spot. Returns false if the same sound started nearby very recently;
+  // whatever is already going covers this one too.
+  auto ShouldStartLoopingSound(Sound* sound, float x, float y, float z)
+      -> bool;
 
  private:
+  struct BatchedCollisionAction {
+    Object::WeakRef<Node> node;
+    Object::WeakRef<Node> opposing_node;
+    PythonRef action;
+    bool at_disconnect{};
+  };
+
+  struct SoundCluster {
+    Object::Ref<Sound> sound;
+
+    // Gain-weighted position sum; divide by gain for the center.
+    float position[3];
+    float gain;
+    float max_gain;
+  };
+
+  struct RecentSound {
+    Sound* sound;  // (Just for comparisons; never dereferenced)
+    float position[3];
+    millisecs_t time;
+  };
+
+  auto CompileMaterialSetPair(const Part* src_part, const Part* dst_part,
+                              MaterialSetPairActions* actions) -> void;
+
+  // Whether the same sound started near a spot within the given time.
+  auto IsNearRecentSound(Sound* sound, const float* position,
+                         millisecs_t time) const -> bool;
+
+  // Our linear-probing tables use low bits directly, so scramble well.
+  static auto MixHash(uint64_t val) -> size_t {
+    val ^= val >> 33u;
+    val *= 0xff51afd7ed558ccdULL;
+    val ^= val >> 33u;
+    val *= 0xc4ceb9fe1a85ec53ULL;
+    val ^= val >> 33u;
+    return static_cast<size_t>(val);
+  }
+
   Dynamics* dynamics_{};
-  // Contains in-progress collisions for current nodes.
-  std::unordered_map<int64_t, SrcNodeCollideMap> node_collisions_;
+
+  // In-progress collisions for current nodes.
+  FlatMap<PartPairKey, Object::Ref<Collision> > collisions_;
+  FlatMap<NodePairKey, NodePairState> node_pairs_;
+
+  // Compiled material results; flushed whenever any material changes.
+  FlatMap<MaterialSetPairKey, MaterialSetPairActions> material_set_pairs_;
+  MaterialSetPairKey material_set_pair_lookup_;
+  uint32_t material_revision_{};
+
+  Object::Ref<PythonContextCall> collision_batch_call_;
+  std::vector<BatchedCollisionAction> batched_collision_actions_;
+  std::vector<SoundCluster> sound_clusters_;
+  std::vector<RecentSound> recent_sounds_;
+
+  // Recycled ODE objects; pooled bodies sit disabled and unowned in the
+  // world and pooled geoms sit outside of any space.
+  auto GeomPool(int geom_class) -> std::vector<dGeomID>* {
+    switch (geom_class) {
+      case dSphereClass:
+        return &sphere_pool_;
+      case dBoxClass:
+        return &box_pool_;
+      case dCCylinderClass:
+        return &capsule_pool_;
+      default:
+        return nullptr;
+    }
+  }
+  std::vector<dBodyID> body_pool_;
+  std::vector<dGeomID> sphere_pool_;
+  std::vector<dGeomID> box_pool_;
+  std::vector<dGeomID> capsule_pool_;
   friend class Dynamics;
 };
 
+// Most we keep around of each pooled thing; enough to cover a good burst
+// of bombs without holding onto much once things calm down.
+const size_t kMaxPooledODEObjects = 64;
+
+Collision::~Collision() = default;
+
 Dynamics::Dynamics(Scene* scene_in)
     : scene_(scene_in),
       collision_cache_(new CollisionCache()),
@@ -177,6 +472,74 @@ void Dynamics::ResetCollision(int64_t node1, int part1, int64_t node2,
   collision_resets_.emplace_back(node1, part1, node2, part2);
 }
 
+void Dynamics::SetBroadphase(PhysicsBroadphase type, const float* bounds_min,
+                             const float* bounds_max) {
+  BA_PRECONDITION(!in_process_);
+  dSpaceID space{};
+  switch (type) {
+    case PhysicsBroadphase::kHash:
+      space = dHashSpaceCreate(nullptr);
+      break;
+    case PhysicsBroadphase::kSweepAndPrune:
+      // Y is up, so it's our least useful axis to sort on.
+      space = dSweepAndPruneSpaceCreate(nullptr, dSAP_AXES_XZY);
+      break;
+    case PhysicsBroadphase::kQuadTree: {
+      // Our quad tree works in the x/z plane (ODE's quadtree splits on its
+      // first and third axes).
+      dVector3 center;
+      dVector3 extents;
+      for (int i = 0; i < 3; i++) {
+        center[i] = 0.5f * (bounds_min[i] + bounds_max[i]);
+        extents[i] = std::max(0.5f * (bounds_max[i] - bounds_min[i]), 1.0f);
+      }
+      center[3] = extents[3] = 0.0f;
+      space = dQuadTreeSpaceCreate(nullptr, center, extents, 6);
+      break;
+    }
+    default:
+      throw Exception("Invalid broadphase type.");
+  }
+  assert(space);
+
+  // Carry our existing geoms over (in their existing order).
+  std::vector<dGeomID> geoms;
+  int geom_count = dSpaceGetNumGeoms(ode_space_);
+  geoms.reserve(static_cast<size_t>(geom_count));
+  for (int i = 0; i < geom_count; i++) {
+    geoms.push_back(dSpaceGetGeom(ode_space_, i));
+  }
+  for (auto&& g : geoms) {
+    dSpaceRemove(ode_space_, g);
+    dSpaceAdd(space, g);
+  }
+  dSpaceDestroy(ode_space_);
+  ode_space_ = space;
+  broadphase_ = type;
+}
+
+auto Dynamics::SetSolverSettings(int iterations, float sor,
+                                 float surface_layer, float max_correcting_vel)
+    -> void {
+  BA_PRECONDITION(iterations > 0);
+  BA_PRECONDITION(sor > 0.0f && sor < 2.0f);
+  BA_PRECONDITION(surface_layer >= 0.0f);
+  dWorldSetQuickStepNumIterations(ode_world_, iterations);
+  dWorldSetQuickStepW(ode_world_, sor);
+  dWorldSetContactSurfaceLayer(ode_world_, surface_layer);
+  dWorldSetContactMaxCorrectingVel(
+      ode_world_, max_correcting_vel < 0.0f ? dInfinity : max_correcting_vel);
+}
+
+auto Dynamics::SpaceForGeoms(uint32_t collide_type, uint32_t collide_mask)
+    -> dSpaceID {
+  if (!(collide_type & RigidBody::kCollideActive)
+      && (collide_mask & ~RigidBody::kCollideActive) == 0) {
+    return region_space_;
+  }
+  return ode_space_;
+}
+
 void Dynamics::AddTrimesh(dGeomID g) {
   assert(dGeomGetClass(g) == dTriMeshClass);
   trimeshes_.push_back(g);
@@ -185,6 +548,13 @@ void Dynamics::AddTrimesh(dGeomID g) {
   g->recomputeAABB();
   g->gflags &= (~(GEOM_DIRTY | GEOM_AABB_BAD));  // NOLINT
 
+  // Sphere and box queries reuse last step's nearby triangles while the
+  // geom stays within a slightly fattened copy of last step's volume
+  // (capsules go through the box path). The triangles are still tested
+  // exactly; only the order contacts come out in can differ.
+  dGeomTriMeshEnableTC(g, dSphereClass, 1);
+  dGeomTriMeshEnableTC(g, dBoxClass, 1);
+
   // Update our collision cache.
   collision_cache_->SetGeoms(trimeshes_);
 }
@@ -203,6 +573,102 @@ void Dynamics::RemoveTrimesh(dGeomID g) {
   throw Exception("trimesh not found");
 }
 
+void Dynamics::RemoveTrimeshCaches(dGeomID g) {
+  for (auto&& trimesh : trimeshes_) {
+    dGeomTriMeshRemoveTCGeom(trimesh, g);
+  }
+}
+
+auto Dynamics::AcquireBody() -> dBodyID {
+  auto& pool = impl_->body_pool_;
+  if (pool.empty()) {
+    return dBodyCreate(ode_world_);
+  }
+  dBodyID b = pool.back();
+  pool.pop_back();
+
+  // Reset everything anyone may have touched back to creation defaults.
+  // (Mass gets set by all users so we skip that).
+  dQuaternion q{1.0f, 0.0f, 0.0f, 0.0f};
+  dBodySetPosition(b, 0.0f, 0.0f, 0.0f);
+  dBodySetQuaternion(b, q);
+  dBodySetLinearVel(b, 0.0f, 0.0f, 0.0f);
+  dBodySetAngularVel(b, 0.0f, 0.0f, 0.0f);
+  dBodySetForce(b, 0.0f, 0.0f, 0.0f);
+  dBodySetTorque(b, 0.0f, 0.0f, 0.0f);
+  dBodySetFiniteRotationAxis(b, 0.0f, 0.0f, 0.0f);
+  dBodySetFiniteRotationMode(b, 0);
+  dBodySetGravityMode(b, 1);
+  dBodySetAutoDisableDefaults(b);
+  dBodyEnable(b);
+  return b;
+}
+
+auto Dynamics::ReleaseBody(dBodyID body) -> void {
+  assert(body);
+  auto& pool = impl_->body_pool_;
+  if (pool.size() >= kMaxPooledODEObjects) {
+    dBodyDestroy(body);
+    return;
+  }
+
+  // Cut all ties the same way dBodyDestroy() would.
+  while (body->geom) {
+    dGeomSetBody(body->geom, nullptr);
+  }
+  while (dBodyGetNumJoints(body) > 0) {
+    dJointAttach(dBodyGetJoint(body, 0), nullptr, nullptr);
+  }
+
+  // Disabled bodies are skipped by stepping, and no data keeps us from
+  // snapshotting it for interpolation.
+  dBodySetData(body, nullptr);
+  dBodyDisable(body);
+  pool.push_back(body);
+}
+
+auto Dynamics::AcquireGeom(int geom_class, dSpaceID space) -> dGeomID {
+  std::vector<dGeomID>* pool = impl_->GeomPool(geom_class);
+  BA_PRECONDITION(pool);
+  if (pool->empty()) {
+    switch (geom_class) {
+      case dSphereClass:
+        return dCreateSphere(space, 1.0f);
+      case dBoxClass:
+        return dCreateBox(space, 1.0f, 1.0f, 1.0f);
+      default:
+        assert(geom_class == dCCylinderClass);
+        return dCreateCCylinder(space, 1.0f, 1.0f);
+    }
+  }
+  dGeomID g = pool->back();
+  pool->pop_back();
+  dMatrix3 r;
+  dRSetIdentity(r);
+  dGeomSetPosition(g, 0.0f, 0.0f, 0.0f);
+  dGeomSetRotation(g, r);
+  if (space) {
+    dSpaceAdd(space, g);
+  }
+  return g;
+}
+
+auto Dynamics::ReleaseGeom(dGeomID geom) -> void {
+  assert(geom);
+  std::vector<dGeomID>* pool = impl_->GeomPool(dGeomGetClass(geom));
+  assert(pool);
+  if (pool == nullptr || pool->size() >= kMaxPooledODEObjects) {
+    dGeomDestroy(geom);
+    return;
+  }
+  dGeomSetBody(geom, nullptr);
+  if (dSpaceID space = dGeomGetSpace(geom)) {
+    dSpaceRemove(space, geom);
+  }
+  dGeomSetData(geom, nullptr);
+  pool->push_back(geom);
+}
+
 auto Dynamics::AreColliding(const Part& p1_in, const Part& p2_in) -> bool {
   const Part* p1;
   const Part* p2;
@@ -215,20 +681,9 @@ auto Dynamics::AreColliding(const Part& p1_in, const Part& p2_in) -> bool {
     p2 = &p1_in;
   }
 
-  // Go down the hierarchy until we either find a missing level or
-  // find the collision.
-  auto i = impl_->node_collisions_.find(p1->node()->id());
-  if (i != impl_->node_collisions_.end()) {
-    auto j = i->second.dst_nodes.find(p2->node()->id());
-    if (j != i->second.dst_nodes.end()) {
-      auto k = j->second.src_parts.find(p1->id());
-      if (k != j->second.src_parts.end()) {
-        auto l = k->second.dst_part_collisions.find(p2->id());
-        if (l != k->second.dst_part_collisions.end()) return true;
-      }
-    }
-  }
-  return false;
+  return impl_->collisions_.Find(
+             {p1->node()->id(), p1->id(), p2->node()->id(), p2->id()})
+         != nullptr;
 }
 
 auto Dynamics::GetCollision(Part* p1_in, Part* p2_in, MaterialContext** cc1,
@@ -245,25 +700,18 @@ auto Dynamics::GetCollision(Part* p1_in, Part* p2_in, MaterialContext** cc1,
     p2 = p1_in;
   }
 
-  std::pair<std::unordered_map<int, Object::Ref<Collision> >::iterator, bool>
-      i = impl_->node_collisions_[p1->node()->id()]
-              .dst_nodes[p2->node()->id()]
-              .src_parts[p1->id()]
-              .dst_part_collisions.insert(
-                  std::make_pair(p2->id(), Object::Ref<Collision>()));
-
-  Collision* new_collision;
+  auto i = impl_->collisions_.Insert(
+      {p1->node()->id(), p1->id(), p2->node()->id(), p2->id()});
 
   // If it didnt exist, go ahead and set up the collision.
   if (i.second) {
-    i.first->second = Object::New<Collision>(scene_);
-    new_collision = i.first->second.get();
-  } else {
-    new_collision = nullptr;
+    *i.first = Object::New<Collision>(scene_);
   }
+  Collision* collision = i.first->get();
+  Collision* new_collision = i.second ? collision : nullptr;
 
-  (*cc1) = &i.first->second->src_context;
-  (*cc2) = &i.first->second->dst_context;
+  (*cc1) = &collision->src_context;
+  (*cc2) = &collision->dst_context;
 
   // Continue setting it up.
   if (new_collision) {
@@ -275,14 +723,15 @@ auto Dynamics::GetCollision(Part* p1_in, Part* p2_in, MaterialContext** cc1,
     (*cc2)->collide = p2->default_collides();
 
     // Apply each part's materials to its context.
-    p1->ApplyMaterials(*cc1, p1, p2);
-    p2->ApplyMaterials(*cc2, p2, p1);
+    impl_->ApplyMaterials(*cc1, p1, p2);
+    impl_->ApplyMaterials(*cc2, p2, p1);
 
     // If either disabled collisions between these two nodes, store that.
-    DstNodeCollideMap* dncm =
-        &impl_->node_collisions_[p1->node()->id()].dst_nodes[p2->node()->id()];
+    Impl::NodePairState* node_pair =
+        impl_->node_pairs_.Insert({p1->node()->id(), p2->node()->id()}).first;
+    node_pair->collision_count++;
     if (!(*cc1)->node_collide || !(*cc2)->node_collide) {
-      dncm->collideDisabled = true;
+      node_pair->collide_disabled = true;
     }
 
     // Don't collide if either context doesnt want us to or if the nodes
@@ -290,7 +739,7 @@ auto Dynamics::GetCollision(Part* p1_in, Part* p2_in, MaterialContext** cc1,
     // collision status).
     new_collision->collide =
         ((*cc1)->collide && (*cc2)->collide
-         && (!dncm->collideDisabled || !(*cc1)->use_node_collide
+         && (!node_pair->collide_disabled || !(*cc1)->use_node_collide
              || !(*cc2)->use_node_collide));
 
     // If theres a physical collision involved, inform the parts
@@ -314,65 +763,273 @@ auto Dynamics::GetCollision(Part* p1_in, Part* p2_in, MaterialContext** cc1,
   }
 
   // Regardless, set it as claimed so we know its current.
-  i.first->second->claim_count++;
+  collision->claim_count++;
 
-  return &(*(i.first->second));
+  return collision;
 }
 
-void Dynamics::Impl::HandleDisconnect(
-    const std::unordered_map<
-        int64_t, ballistica::Dynamics::SrcNodeCollideMap>::iterator& i,
-    const std::unordered_map<
-        int64_t, ballistica::Dynamics::DstNodeCollideMap>::iterator& j,
-    const std::unordered_map<int, SrcPartCollideMap>::iterator& k,
-    const std::unordered_map<int, Object::Ref<Collision> >::iterator& l) {
+void Dynamics::Impl::ApplyMaterials(MaterialContext* context,
+                                    const Part* src_part,
+                                    const Part* dst_part) {
+  // Keep this from growing without bound if material sets churn.
+  const size_t kMaxMaterialSetPairs{4096};
+  if (material_revision_ != Material::revision()
+      || material_set_pairs_.size() >= kMaxMaterialSetPairs) {
+    material_set_pairs_.Clear();
+    material_revision_ = Material::revision();
+  }
+
+  MaterialSetPairKey& key = material_set_pair_lookup_;
+  key.src.clear();
+  for (auto&& m : src_part->materials()) {
+    key.src.push_back(m.get());
+  }
+  key.dst.clear();
+  for (auto&& m : dst_part->materials()) {
+    key.dst.push_back(m.get());
+  }
+  auto i = material_set_pairs_.Insert(key);
+  MaterialSetPairActions* actions = i.first;
+  if (i.second) {
+    CompileMaterialSetPair(src_part, dst_part, actions);
+  }
+
+  for (auto&& entry : actions->entries) {
+    if (entry.program_offset < 0
+        || MaterialComponent::EvalCompiledConditions(
+            &actions->program[entry.program_offset], src_part, dst_part,
+            *context)) {
+      entry.component->Apply(context, src_part, dst_part);
+    }
+  }
+}
+
+void Dynamics::Impl::CompileMaterialSetPair(const Part* src_part,
+                                            const Part* dst_part,
+                                            MaterialSetPairActions* actions) {
+  for (auto&& m : src_part->materials()) {
+    assert(m.exists());
+    for (auto&& component : m->components()) {
+      auto offset = static_cast<int32_t>(actions->program.size());
+      switch (component->CompileConditions(*m, dst_part->materials(),
+                                           &actions->program)) {
+        case MaterialComponent::CompiledResult::kFalse:
+          break;
+        case MaterialComponent::CompiledResult::kTrue:
+          actions->entries.push_back({component.get(), -1});
+          break;
+        case MaterialComponent::CompiledResult::kDynamic:
+          actions->entries.push_back({component.get(), offset});
+          break;
+      }
+    }
+  }
+}
+
+void Dynamics::SetCollisionBatchCall(PyObject* call) {
+  if (call == nullptr || call == Py_None) {
+    impl_->collision_batch_call_.Clear();
+  } else {
+    impl_->collision_batch_call_ = Object::New<PythonContextCall>(call);
+  }
+  collision_batching_ = impl_->collision_batch_call_.exists();
+}
+
+void Dynamics::AddBatchedCollisionAction(Node* node, Node* opposing_node,
+                                         PyObject* action, bool at_disconnect) {
+  assert(collision_batching_ && action);
+  impl_->batched_collision_actions_.emplace_back();
+  Impl::BatchedCollisionAction& entry =
+      impl_->batched_collision_actions_.back();
+  entry.node = node;
+  entry.opposing_node = opposing_node;
+  entry.action.Acquire(action);
+  entry.at_disconnect = at_disconnect;
+}
+
+void Dynamics::Impl::RunCollisionBatch() {
+  if (batched_collision_actions_.empty()) {
+    return;
+  }
+
+  // Apply the same liveness rules individual actions would; earlier
+  // non-batched actions this step may have killed nodes since queuing.
+  PythonRef records(PyList_New(0), PythonRef::kSteal);
+  for (auto&& i : batched_collision_actions_) {
+    Node* node = i.node.get();
+    Node* opposing_node = i.opposing_node.get();
+    if (!node || (!i.at_disconnect && !opposing_node)) {
+      continue;
+    }
+    PythonRef record(
+        Py_BuildValue("(OOO)", node->BorrowPyRef(),
+                      opposing_node ? opposing_node->BorrowPyRef() : Py_None,
+                      i.action.get()),
+        PythonRef::kSteal);
+    PyList_Append(records.get(), record.get());
+  }
+  batched_collision_actions_.clear();
+
+  if (PyList_GET_SIZE(records.get()) > 0 && collision_batch_call_.exists()) {
+    PyObject* args[] = {records.get()};
+    collision_batch_call_->Run(args, 1);
+  }
+}
+
+static auto SoundClusterDistanceSquared(const float* a, const float* b)
+    -> float {
+  float dx = a[0] - b[0];
+  float dy = a[1] - b[1];
+  float dz = a[2] - b[2];
+  return dx * dx + dy * dy + dz * dz;
+}
+
+auto Dynamics::Impl::IsNearRecentSound(Sound* sound, const float* position,
+                                       millisecs_t time) const -> bool {
+  millisecs_t real_time = dynamics_->real_time_;
+  for (auto&& i : recent_sounds_) {
+    if (i.sound == sound && real_time - i.time < time
+        && SoundClusterDistanceSquared(i.position, position)
+               < kSoundClusterRadius * kSoundClusterRadius) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Dynamics::Impl::AddClusteredSound(Sound* sound, float x, float y,
+                                       float z, float gain) {
+  assert(sound);
+  if (gain <= 0.0f) {
+    return;
+  }
+  float position[3] = {x, y, z};
+  for (auto&& c : sound_clusters_) {
+    if (c.sound.get() != sound) {
+      continue;
+    }
+    float center[3] = {c.position[0] / c.gain, c.position[1] / c.gain,
+                       c.position[2] / c.gain};
+    if (SoundClusterDistanceSquared(center, position)
+        < kSoundClusterRadius * kSoundClusterRadius) {
+      for (int i = 0; i < 3; i++) {
+        c.position[i] += position[i] * gain;
+      }
+      c.gain += gain;
+      c.max_gain = std::max(c.max_gain, gain);
+      return;
+    }
+  }
+  sound_clusters_.emplace_back();
+  SoundCluster& c = sound_clusters_.back();
+  c.sound = sound;
+  for (int i = 0; i < 3; i++) {
+    c.position[i] = position[i] * gain;
+  }
+  c.gain = gain;
+  c.max_gain = gain;
+}
+
+void Dynamics::Impl::PlayClusteredSounds() {
+  millisecs_t real_time = dynamics_->real_time_;
+
+  // Forget plays that are too old to merge with anything.
+  recent_sounds_.erase(
+      std::remove_if(recent_sounds_.begin(), recent_sounds_.end(),
+                     [real_time](const RecentSound& s) {
+                       return real_time - s.time >= kLoopingSoundClusterTime;
+                     }),
+      recent_sounds_.end());
+
+  for (auto&& c : sound_clusters_) {
+    float center[3] = {c.position[0] / c.gain, c.position[1] / c.gain,
+                       c.position[2] / c.gain};
+
+    // If one of these just went off here, it's already covering us.
+    if (IsNearRecentSound(c.sound.get(), center, kSoundClusterTime)) {
+      continue;
+    }
+    if (AudioSource* source = g_audio->SourceBeginNew()) {
+      source->SetGain(std::min(c.gain, c.max_gain * kSoundClusterMaxGainBoost));
+      source->SetPosition(center[0], center[1], center[2]);
+      source->Play(c.sound->GetSoundData());
+      source->End();
+      recent_sounds_.push_back(
+          {c.sound.get(), {center[0], center[1], center[2]}, real_time});
+    }
+  }
+  sound_clusters_.clear();
+}
+
+auto Dynamics::Impl::ShouldStartLoopingSound(Sound* sound, float x, float y,
+                                             float z) -> bool {
+  float position[3] = {x, y, z};
+  if (IsNearRecentSound(sound, position, kLoopingSoundClusterTime)) {
+    return false;
+  }
+  recent_sounds_.push_back({sound, {x, y, z}, dynamics_->real_time_});
+  return true;
+}
+
+void Dynamics::Impl::HandleDisconnect(size_t index) {
+  const PartPairKey& key = collisions_.key(index);
+  Collision* c = collisions_.value(index).get();
+
   // Handle disconnect equivalents if they were colliding.
-  if (l->second->collide) {
+  if (c->collide) {
     // Add the contexts' disconnect commands to be executed.
-    for (auto m = l->second->src_context.disconnect_actions.begin();
-         m != l->second->src_context.disconnect_actions.end(); m++) {
-      Part* src_part = l->second->src_part.get();
-      Part* dst_part = l->second->dst_part.get();
+    for (auto m = c->src_context.disconnect_actions.begin();
+         m != c->src_context.disconnect_actions.end(); m++) {
+      Part* src_part = c->src_part.get();
+      Part* dst_part = c->dst_part.get();
       dynamics_->collision_events_.emplace_back(
           src_part ? src_part->node() : nullptr,
-          dst_part ? dst_part->node() : nullptr, *m, l->second);
+          dst_part ? dst_part->node() : nullptr, *m, collisions_.value(index));
     }
 
-    for (auto m = l->second->dst_context.disconnect_actions.begin();
-         m != l->second->dst_context.disconnect_actions.end(); m++) {
-      Part* src_part = l->second->src_part.get();
-      Part* dst_part = l->second->dst_part.get();
+    for (auto m = c->dst_context.disconnect_actions.begin();
+         m != c->dst_context.disconnect_actions.end(); m++) {
+      Part* src_part = c->src_part.get();
+      Part* dst_part = c->dst_part.get();
       dynamics_->collision_events_.emplace_back(
           dst_part ? dst_part->node() : nullptr,
-          src_part ? src_part->node() : nullptr, *m, l->second);
+          src_part ? src_part->node() : nullptr, *m, collisions_.value(index));
     }
 
     // Now see if either of the two parts involved still exist and if they do,
     // tell them they're no longer colliding with the other.
-    bool physical =
-        l->second->src_context.physical && l->second->dst_context.physical;
-    Part* p1 = l->second->dst_part.get();
-    Part* p2 = l->second->src_part.get();
+    bool physical = c->src_context.physical && c->dst_context.physical;
+    Part* p1 = c->dst_part.get();
+    Part* p2 = c->src_part.get();
     if (p1) {
-      assert(p1 == l->second->dst_part.get());
-      p1->SetCollidingWith(i->first, k->first, false, physical);  // NOLINT
-    }
-    if (p2) {
-      assert(p2 == l->second->src_part.get());
+      p1->SetCollidingWith(key.node1, key.part1, false, physical);
     }
     if (p2 && (p2 != p1)) {
-      p2->SetCollidingWith(j->first, l->first, false, physical);  // NOLINT
+      p2->SetCollidingWith(key.node2, key.part2, false, physical);
     }
   }
 
   // Remove this particular collision.
-  k->second.dst_part_collisions.erase(l);
+  RemoveCollision(index);
+}
+
+void Dynamics::Impl::RemoveCollision(size_t index) {
+  NodePairKey node_key{collisions_.key(index).node1,
+                       collisions_.key(index).node2};
+  collisions_.EraseAt(index);
+  NodePairState* node_pair = node_pairs_.Find(node_key);
+  assert(node_pair && node_pair->collision_count > 0);
+  if (--node_pair->collision_count == 0) {
+    node_pairs_.Erase(node_key);
+  }
 }
 
 void Dynamics::ProcessCollisions() {
   processing_collisions_ = true;
 
   collision_count_ = 0;
+  broadphase_pair_count_ = 0;
+  narrowphase_pair_count_ = 0;
 
   // First handle our explicitly reset collisions.
   // For each reset request, we check if the surfaces are colliding and if so
@@ -395,34 +1052,10 @@ void Dynamics::ProcessCollisions() {
         p2 = collision_reset.part1;
       }
 
-      // Go down the hierarchy until we either find a missing level or
-      // find the collision to reset.
-      {
-        auto i = impl_->node_collisions_.find(n1);
-        if (i != impl_->node_collisions_.end()) {
-          auto j = i->second.dst_nodes.find(n2);
-          if (j != i->second.dst_nodes.end()) {
-            auto k = j->second.src_parts.find(p1);
-            if (k != j->second.src_parts.end()) {
-              auto l = k->second.dst_part_collisions.find(p2);
-              if (l != k->second.dst_part_collisions.end()) {
-                // They were colliding - separate them.
-                impl_->HandleDisconnect(i, j, k, l);
-              }
-
-              // Erase if none left.
-              if (k->second.dst_part_collisions.empty()) {
-                j->second.src_parts.erase(k);
-              }
-            }
-
-            // Erase if none left.
-            if (j->second.src_parts.empty()) i->second.dst_nodes.erase(j);
-          }
-
-          // Erase if none left.
-          if (i->second.dst_nodes.empty()) impl_->node_collisions_.erase(i);
-        }
+      // If they were colliding, separate them.
+      int32_t index = impl_->collisions_.FindIndex({n1, p1, n2, p2});
+      if (index >= 0) {
+        impl_->HandleDisconnect(static_cast<size_t>(index));
       }
     }
     collision_resets_.clear();
@@ -430,14 +1063,8 @@ void Dynamics::ProcessCollisions() {
 
   // Reset our claim counts. When we run collision tests, claim counts
   // will be incremented for things that are still in contact.
-  for (auto& node_collision : impl_->node_collisions_) {
-    for (auto& dst_node : node_collision.second.dst_nodes) {
-      for (auto& src_part : dst_node.second.src_parts) {
-        for (auto& dst_part_collision : src_part.second.dst_part_collisions) {
-          dst_part_collision.second->claim_count = 0;
-        }
-      }
-    }
+  for (size_t i = 0; i < impl_->collisions_.size(); i++) {
+    impl_->collisions_.value(i)->claim_count = 0;
   }
 
   // Process all standard collisions. This will trigger our callback which
@@ -445,6 +1072,9 @@ void Dynamics::ProcessCollisions() {
   // called, etc).
   dSpaceCollide(ode_space_, this, &DoCollideCallback);
 
+  // Regions and such only need testing against what's in the main space.
+  dSpaceCollide2(region_space_, ode_space_, this, &DoCollideCallback);
+
   // Collide our trimeshes against everything.
   collision_cache_->CollideAgainstSpace(ode_space_, this, &DoCollideCallback);
 
@@ -454,43 +1084,15 @@ void Dynamics::ProcessCollisions() {
   // Now go through our list of currently-colliding stuff,
   // setting parts' currently-colliding-with lists
   // based on current info,
-  // removing unclaimed collisions and empty groups.
-  std::unordered_map<int64_t, SrcNodeCollideMap>::iterator i_next;
-  std::unordered_map<int64_t, DstNodeCollideMap>::iterator j_next;
-  std::unordered_map<int, SrcPartCollideMap>::iterator k_next;
-  std::unordered_map<int, Object::Ref<Collision> >::iterator l_next;
-  for (auto i = impl_->node_collisions_.begin();
-       i != impl_->node_collisions_.end(); i = i_next) {
-    i_next = i;
-    i_next++;
-    for (auto j = i->second.dst_nodes.begin(); j != i->second.dst_nodes.end();
-         j = j_next) {
-      j_next = j;
-      j_next++;
-      for (auto k = j->second.src_parts.begin(); k != j->second.src_parts.end();
-           k = k_next) {
-        k_next = k;
-        k_next++;
-        for (auto l = k->second.dst_part_collisions.begin();
-             l != k->second.dst_part_collisions.end(); l = l_next) {
-          l_next = l;
-          l_next++;
-
-          // Not claimed; separating.
-          if (!l->second->claim_count) {
-            impl_->HandleDisconnect(i, j, k, l);
-          }
-        }
-        if (k->second.dst_part_collisions.empty()) {
-          j->second.src_parts.erase(k);
-        }
-      }
-      if (j->second.src_parts.empty()) {
-        i->second.dst_nodes.erase(j);
-      }
-    }
-    if (i->second.dst_nodes.empty()) {
-      impl_->node_collisions_.erase(i);
+  // and removing unclaimed collisions.
+  // (Removal moves the last entry into the removed one's place, so we
+  // only advance when keeping an entry).
+  for (size_t i = 0; i < impl_->collisions_.size();) {
+    // Not claimed; separating.
+    if (!impl_->collisions_.value(i)->claim_count) {
+      impl_->HandleDisconnect(i);
+    } else {
+      i++;
     }
   }
 
@@ -498,6 +1100,8 @@ void Dynamics::ProcessCollisions() {
   // collisions, etc. since we're no longer going through the lists.
   processing_collisions_ = false;
 
+  impl_->PlayClusteredSounds();
+
   // Execute all events that we built up due to collisions.
   for (auto&& i : collision_events_) {
     active_collision_ = i.collision.get();
@@ -507,9 +1111,14 @@ void Dynamics::ProcessCollisions() {
   }
   active_collision_ = nullptr;
   collision_events_.clear();
+
+  if (collision_batching_) {
+    impl_->RunCollisionBatch();
+  }
 }
 
 void Dynamics::process() {
+  BA_TRACE_SCOPE("Dynamics::process");
   in_process_ = true;
   real_time_ = GetRealTime();  // Update this once so we can recycle results.
   ProcessCollisions();
@@ -518,6 +1127,23 @@ void Dynamics::process() {
   in_process_ = false;
 }
 
+void Dynamics::StoreInterpolationStates(millisecs_t base_time) {
+  for (dxBody* b = ode_world_->firstbody; b;
+       b = static_cast<dxBody*>(b->next)) {
+    if (auto* body = static_cast<RigidBody*>(dBodyGetData(b))) {
+      body->StoreInterpolationState();
+    }
+  }
+  interpolation_base_time_ = base_time;
+}
+
+void Dynamics::UpdateRenderInterpolation(millisecs_t frame_base_time) {
+  render_interpolation_ = std::min(
+      1.0f, std::max(0.0f, static_cast<float>(frame_base_time
+                                              - interpolation_base_time_)
+                               / static_cast<float>(kGameStepMilliseconds)));
+}
+
 void Dynamics::DoCollideCallback(void* data, dGeomID o1, dGeomID o2) {
   auto* d = static_cast<Dynamics*>(data);
   d->CollideCallback(o1, o2);
@@ -528,6 +1154,8 @@ void Dynamics::DoCollideCallback(void* data, dGeomID o1, dGeomID o2) {
 // This way we know all bodies and their associated nodes, etc are valid
 // throughout collision processing.
 void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
+  broadphase_pair_count_++;
+
   dBodyID b1 = dGeomGetBody(o1);
   dBodyID b2 = dGeomGetBody(o2);
 
@@ -555,21 +1183,9 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
       p1 = p2_in;
       p2 = p1_in;
     }
-    auto i = impl_->node_collisions_.find(p1->node()->id());
-    if (i != impl_->node_collisions_.end()) {
-      auto j = i->second.dst_nodes.find(p2->node()->id());
-      if (j != i->second.dst_nodes.end()) {
-        auto k = j->second.src_parts.find(p1->id());
-        if (k != j->second.src_parts.end()) {
-          auto l = k->second.dst_part_collisions.find(p2->id());
-          if (l != k->second.dst_part_collisions.end()) {
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "UnusedValue"
-            l->second->claim_count++;
-#pragma clang diagnostic pop
-          }
-        }
-      }
+    if (Object::Ref<Collision>* c = impl_->collisions_.Find(
+            {p1->node()->id(), p1->id(), p2->node()->id(), p2->id()})) {
+      (*c)->claim_count++;
     }
     return;
   }
@@ -599,6 +1215,8 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
   dContact contact[MAX_CONTACTS];  // up to MAX_CONTACTS contacts per pair
   if (int numc =
           dCollide(o1, o2, MAX_CONTACTS, &contact[0].geom, sizeof(dContact))) {
+    narrowphase_pair_count_++;
+
     MaterialContext* cc1;
     MaterialContext* cc2;
 
@@ -872,15 +1490,11 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
 
                 if (volume > 1) volume = 1;
                 assert(i.sound.exists());
-                if (AudioSource* source = g_audio->SourceBeginNew()) {
-                  source->SetGain(volume * i.volume);
-                  source->SetPosition(apx, apy, apz);
-                  source->Play(i.sound->GetSoundData());
-                  p1->set_last_impact_sound_time(real_time);
-                  p2->set_last_impact_sound_time(real_time);
-                  last_impact_sound_time_ = real_time;
-                  source->End();
-                }
+                impl_->AddClusteredSound(i.sound.get(), apx, apy, apz,
+                                         volume * i.volume);
+                p1->set_last_impact_sound_time(real_time);
+                p2->set_last_impact_sound_time(real_time);
+                last_impact_sound_time_ = real_time;
               }
             }
           }
@@ -911,8 +1525,10 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
                     // Spare ourself some trouble next time.
                     i.playing = false;
                   }
-                } else if (real_time - p1->last_skid_sound_time() >= 250
-                           || real_time - p2->last_skid_sound_time() > 250) {
+                } else if ((real_time - p1->last_skid_sound_time() >= 250
+                            || real_time - p2->last_skid_sound_time() > 250)
+                           && impl_->ShouldStartLoopingSound(i.sound.get(),
+                                                             apx, apy, apz)) {
                   assert(i.sound.exists());
                   if (AudioSource* source = g_audio->SourceBeginNew()) {
                     source->SetLooping(true);
@@ -961,8 +1577,10 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
                     // spare ourself some trouble next time
                     i.playing = false;
                   }
-                } else if (real_time - p1->last_roll_sound_time() >= 250
-                           || real_time - p2->last_roll_sound_time() > 250) {
+                } else if ((real_time - p1->last_roll_sound_time() >= 250
+                            || real_time - p2->last_roll_sound_time() > 250)
+                           && impl_->ShouldStartLoopingSound(i.sound.get(),
+                                                             apx, apy, apz)) {
                   assert(i.sound.exists());
                   if (AudioSource* source = g_audio->SourceBeginNew()) {
                     source->SetLooping(true);
@@ -1010,21 +1628,11 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
     if (play_collide_sounds) {
       for (auto&& i : cc1->connect_sounds) {
         assert(i.sound.exists());
-        if (AudioSource* source = g_audio->SourceBeginNew()) {
-          source->SetPosition(apx, apy, apz);
-          source->SetGain(i.volume);
-          source->Play(i.sound->GetSoundData());
-          source->End();
-        }
+        impl_->AddClusteredSound(i.sound.get(), apx, apy, apz, i.volume);
       }
       for (auto&& i : cc2->connect_sounds) {
         assert(i.sound.exists());
-        if (AudioSource* source = g_audio->SourceBeginNew()) {
-          source->SetPosition(apx, apy, apz);
-          source->SetGain(i.volume);
-          source->Play(i.sound->GetSoundData());
-          source->End();
-        }
+        impl_->AddClusteredSound(i.sound.get(), apx, apy, apz, i.volume);
       }
     }
 
@@ -1100,6 +1708,20 @@ void Dynamics::CollideCallback(dGeomID o1, dGeomID o2) {
 }
 
 void Dynamics::ShutdownODE() {
+  // Pooled geoms aren't in any space so nothing else will clean them up.
+  // (Pooled bodies go down with the world).
+  for (auto* pool :
+       {&impl_->sphere_pool_, &impl_->box_pool_, &impl_->capsule_pool_}) {
+    for (auto* g : *pool) {
+      dGeomDestroy(g);
+    }
+    pool->clear();
+  }
+  impl_->body_pool_.clear();
+  if (region_space_) {
+    dSpaceDestroy(region_space_);
+    region_space_ = nullptr;
+  }
   if (ode_space_) {
     dSpaceDestroy(ode_space_);
     ode_space_ = nullptr;
@@ -1119,16 +1741,21 @@ void Dynamics::ResetODE() {
   ode_world_ = dWorldCreate();
   assert(ode_world_);
   dWorldSetGravity(ode_world_, 0, -20, 0);
-  dWorldSetContactSurfaceLayer(ode_world_, 0.001f);
   dWorldSetAutoDisableFlag(ode_world_, true);
   dWorldSetAutoDisableSteps(ode_world_, 5);
   dWorldSetAutoDisableLinearThreshold(ode_world_, 0.1f);
   dWorldSetAutoDisableAngularThreshold(ode_world_, 0.1f);
   dWorldSetAutoDisableSteps(ode_world_, 10);
   dWorldSetAutoDisableTime(ode_world_, 0);
-  dWorldSetQuickStepNumIterations(ode_world_, 10);
+  SetSolverSettings(g_app_globals->physics_solver_iterations,
+                    g_app_globals->physics_solver_sor,
+                    g_app_globals->physics_contact_surface_layer,
+                    g_app_globals->physics_max_correcting_vel);
+  dWorldSetIslandThreadCount(ode_world_, g_app_globals->physics_island_threads);
   ode_space_ = dHashSpaceCreate(nullptr);
   assert(ode_space_);
+  region_space_ = dHashSpaceCreate(nullptr);
+  assert(region_space_);
   ode_contact_group_ = dJointGroupCreate(0);
   assert(ode_contact_group_);
   dRandSetSeed(5432);
@@ -21,6 +21,14 @@ class Dynamics : public Object {
   auto getContactGroup() -> dJointGroupID { return ode_contact_group_; }
   auto space() -> dSpaceID { return ode_space_; }
 
+  /// The space new geoms with the given collide type/mask should go in.
+  /// Ones that can only ever touch active bodies (regions, punch/pickup
+  /// volumes, etc.) are kept in a side space that just gets tested against
+  /// the main one, so they never get paired with each other or with
+  /// terrain and don't clutter up the main broadphase.
+  auto SpaceForGeoms(uint32_t collide_type, uint32_t collide_mask)
+      -> dSpaceID;
+
   // Discontinues a collision. Used by parts when changing materials
   // so that new collisions may enter effect.
   auto ResetCollision(int64_t node1, int part1, int64_t node2, int part2)
@@ -54,6 +62,21 @@ class Dynamics : public Object {
     collide_message_reverse_order_ = target_other_in;
   }
   auto in_collide_message() const -> bool { return in_collide_message_; }
+
+  /// Opt-in batching of collision-triggered Python work. While a batch
+  /// call is set (in the current context), 'call' and 'message' material
+  /// actions are queued during each step and handed to it in one call at
+  /// the end of collision processing as a list of (node, opposingnode,
+  /// action) tuples, in the order they would otherwise have run. Pass
+  /// nullptr to go back to running them individually.
+  auto SetCollisionBatchCall(PyObject* call) -> void;
+  auto collision_batching() const -> bool { return collision_batching_; }
+
+  /// Used by material actions when batching is on. 'action' is a callable
+  /// or a message to deliver to 'node'.
+  auto AddBatchedCollisionAction(Node* node, Node* opposing_node,
+                                 PyObject* action, bool at_disconnect)
+      -> void;
   auto process() -> void;
   auto increment_skid_sound_count() -> void { skid_sound_count_++; }
   auto decrement_skid_sound_count() -> void { skid_sound_count_--; }
@@ -68,18 +91,59 @@ class Dynamics : public Object {
   auto AddTrimesh(dGeomID g) -> void;
   auto RemoveTrimesh(dGeomID g) -> void;
 
+  /// Trimeshes keep per-geom temporal-coherence caches (the triangles
+  /// near each geom last step) so bodies resting on or rolling across
+  /// terrain can skip tree queries; geoms must be dropped from them here
+  /// before they're destroyed.
+  auto RemoveTrimeshCaches(dGeomID g) -> void;
+
+  /// Bodies and simple (sphere, box and capsule) geoms come and go
+  /// constantly with bombs, powerups, punches and whatnot, so we recycle
+  /// them instead of going back to ODE each time. Acquired bodies come
+  /// back in the state dBodyCreate() would give, and geoms in the space
+  /// given (sizes are up to the caller). Only simple geom classes may be
+  /// passed here.
+  auto AcquireBody() -> dBodyID;
+  auto ReleaseBody(dBodyID body) -> void;
+  auto AcquireGeom(int geom_class, dSpaceID space) -> dGeomID;
+  auto ReleaseGeom(dGeomID geom) -> void;
+
   auto collision_count() const -> int { return collision_count_; }
+
+  /// Pairs handed to us by the broadphase during the last step, and how
+  /// many of those actually yielded contacts in narrowphase testing.
+  auto broadphase_pair_count() const -> int { return broadphase_pair_count_; }
+  auto narrowphase_pair_count() const -> int {
+    return narrowphase_pair_count_;
+  }
+
+  /// Rebuild our collision space as the given type, sized to the provided
+  /// bounds where applicable. Existing geoms are carried over.
+  auto SetBroadphase(PhysicsBroadphase type, const float* bounds_min,
+                     const float* bounds_max) -> void;
+  auto broadphase() const -> PhysicsBroadphase { return broadphase_; }
+
+  /// Set how hard the solver works each step: QuickStep iterations, its
+  /// SOR over-relaxation factor, how deep contacts may sink before being
+  /// pushed apart, and a cap on the velocity used to push them apart
+  /// (negative for unlimited).
+  auto SetSolverSettings(int iterations, float sor, float surface_layer,
+                         float max_correcting_vel) -> void;
   auto process_real_time() const -> millisecs_t { return real_time_; }
   auto last_impact_sound_time() const -> millisecs_t {
     return last_impact_sound_time_;
   }
   auto in_process() const -> bool { return in_process_; }
 
+  /// Render interpolation: snapshot all body states ahead of a step, and
+  /// set how far between that snapshot and the current state bodies
+  /// should draw based on a frame's base time.
+  auto StoreInterpolationStates(millisecs_t base_time) -> void;
+  auto UpdateRenderInterpolation(millisecs_t frame_base_time) -> void;
+  auto render_interpolation() const -> float { return render_interpolation_; }
+
  private:
   auto AreColliding(const Part& p1, const Part& p2) -> bool;
-  class SrcNodeCollideMap;
-  class DstNodeCollideMap;
-  class SrcPartCollideMap;
   class CollisionEvent;
   class CollisionReset;
   class Impl;
@@ -116,6 +180,13 @@ class Dynamics : public Object {
   Object::WeakRef<Node> active_collide_src_node_;
   Object::WeakRef<Node> active_collide_dst_node_;
   std::unique_ptr<CollisionCache> collision_cache_;
+  PhysicsBroadphase broadphase_{PhysicsBroadphase::kHash};
+  int broadphase_pair_count_{};
+  int narrowphase_pair_count_{};
+  bool collision_batching_{};
+  millisecs_t interpolation_base_time_{};
+  float render_interpolation_{1.0f};
+  dSpaceID region_space_{};
   friend class Impl;
 };
 
@@ -11,6 +11,8 @@
 
 namespace ballistica {
 
+uint32_t Material::revision_{};
+
 Material::Material(std::string name_in, Scene* scene)
     : label_(std::move(name_in)), scene_(scene) {
   // If we're being made in a scene with an output stream,
@@ -26,6 +28,7 @@ void Material::MarkDead() {
     return;
   }
   components_.clear();
+  revision_++;
 
   // If we're in a scene with an output-stream, inform them of our demise.
   Scene* scene = scene_.get();
@@ -47,7 +50,12 @@ auto Material::GetPyRef(bool new_ref) -> PyObject* {
   return py_object_;
 }
 
-Material::~Material() { MarkDead(); }
+Material::~Material() {
+  MarkDead();
+
+  // Our address may get reused; make sure nothing cached outlives us.
+  revision_++;
+}
 
 void Material::Apply(MaterialContext* s, const Part* src_part,
                      const Part* dst_part) {
@@ -66,6 +74,7 @@ void Material::AddComponent(const Object::Ref<MaterialComponent>& c) {
     output_stream->AddMaterialComponent(this, c.get());
   }
   components_.push_back(c);
+  revision_++;
 }
 
 void Material::DumpComponents(GameStream* out) {
@@ -31,6 +31,10 @@ class Material : public Object {
   void MarkDead();
   auto scene() const -> Scene* { return scene_.get(); }
   void DumpComponents(GameStream* out);
+  auto components() const
+      -> const std::vector<Object::Ref<MaterialComponent> >& {
+    return components_;
+  }
   auto stream_id() const -> int64_t { return stream_id_; }
   void set_stream_id(int64_t val) {
     assert(stream_id_ == -1);
@@ -41,10 +45,16 @@ class Material : public Object {
     stream_id_ = -1;
   }
   void set_py_object(PyObject* obj) { py_object_ = obj; }
+
+  /// Bumped whenever any material's components change or a material
+  /// goes away; anything caching results of material evaluation should
+  /// flush itself when this changes.
+  static auto revision() -> uint32_t { return revision_; }
   auto has_py_object() const -> bool { return (py_object_ != nullptr); }
   auto py_object() const -> PyObject* { return py_object_; }
 
  private:
+  static uint32_t revision_;
   bool dead_{};
   int64_t stream_id_{-1};
   Object::WeakRef<Scene> scene_;
@@ -119,6 +119,191 @@ auto MaterialComponent::eval_conditions(
   }
 }
 
+// Opcodes for compiled conditions beyond the MaterialCondition leaf values.
+// Each instruction is an (opcode, arg) pair; for binary operators arg is the
+// offset from the instruction to its right operand (the left operand
+// immediately follows). Offsets are relative so code can be shifted freely.
+static const int32_t kCompiledOpAnd{-1};
+static const int32_t kCompiledOpOr{-2};
+static const int32_t kCompiledOpXor{-3};
+static const int32_t kCompiledOpNot{-4};
+
+static auto DstMaterialsContain(
+    const std::vector<Object::Ref<Material> >& dst_materials,
+    const Material* m) -> bool {
+  for (auto&& i : dst_materials) {
+    if (i.get() == m) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto MaterialComponent::CompileConditions(
+    const Material& c, const std::vector<Object::Ref<Material> >& dst_materials,
+    std::vector<int32_t>* program) -> CompiledResult {
+  if (!conditions.exists()) {
+    return CompiledResult::kTrue;
+  }
+  return CompileCondition(conditions.get(), c, dst_materials, program);
+}
+
+auto MaterialComponent::CompileCondition(
+    const MaterialConditionNode* condition, const Material& c,
+    const std::vector<Object::Ref<Material> >& dst_materials,
+    std::vector<int32_t>* program) -> CompiledResult {
+  auto known = [](bool val) {
+    return val ? CompiledResult::kTrue : CompiledResult::kFalse;
+  };
+
+  if (condition->opmode == MaterialConditionNode::OpMode::LEAF_NODE) {
+    switch (condition->cond) {
+      case MaterialCondition::kTrue:
+        return CompiledResult::kTrue;
+      case MaterialCondition::kFalse:
+        return CompiledResult::kFalse;
+      case MaterialCondition::kDstIsMaterial:
+        return known(DstMaterialsContain(dst_materials,
+                                         condition->val1_material.get()));
+      case MaterialCondition::kDstNotMaterial:
+        return known(!DstMaterialsContain(dst_materials,
+                                          condition->val1_material.get()));
+      case MaterialCondition::kSrcDstSameMaterial:
+        return known(DstMaterialsContain(dst_materials, &c));
+      case MaterialCondition::kSrcDstDiffMaterial:
+        return known(!DstMaterialsContain(dst_materials, &c));
+      default:
+        // Everything else depends on the parts or the context.
+        program->push_back(static_cast<int32_t>(condition->cond));
+        program->push_back(condition->val1);
+        return CompiledResult::kDynamic;
+    }
+  }
+
+  assert(condition->left_child.exists());
+  assert(condition->right_child.exists());
+  size_t start = program->size();
+  switch (condition->opmode) {
+    case MaterialConditionNode::OpMode::AND_OPERATOR:
+      program->push_back(kCompiledOpAnd);
+      break;
+    case MaterialConditionNode::OpMode::OR_OPERATOR:
+      program->push_back(kCompiledOpOr);
+      break;
+    case MaterialConditionNode::OpMode::XOR_OPERATOR:
+      program->push_back(kCompiledOpXor);
+      break;
+    default:
+      throw Exception();
+  }
+  program->push_back(0);
+  CompiledResult left =
+      CompileCondition(condition->left_child.get(), c, dst_materials, program);
+  size_t right_start = program->size();
+  CompiledResult right =
+      CompileCondition(condition->right_child.get(), c, dst_materials, program);
+
+  if (left == CompiledResult::kDynamic && right == CompiledResult::kDynamic) {
+    (*program)[start + 1] = static_cast<int32_t>(right_start - start);
+    return CompiledResult::kDynamic;
+  }
+
+  // At least one side is known, so we can lose the operator. Known sides
+  // emit no code, so whatever follows is the other side's code (if any).
+  // Conditions have no side effects so dropping a dynamic side is safe.
+  CompiledResult known_side = (left == CompiledResult::kDynamic) ? right : left;
+  CompiledResult other_side = (left == CompiledResult::kDynamic) ? left : right;
+  auto drop_all = [program, start] { program->resize(start); };
+  auto drop_op = [program, start] {
+    program->erase(program->begin() + static_cast<ptrdiff_t>(start),
+                   program->begin() + static_cast<ptrdiff_t>(start) + 2);
+  };
+  switch (condition->opmode) {
+    case MaterialConditionNode::OpMode::AND_OPERATOR:
+      if (known_side == CompiledResult::kFalse) {
+        drop_all();
+        return CompiledResult::kFalse;
+      }
+      drop_op();
+      return other_side;
+    case MaterialConditionNode::OpMode::OR_OPERATOR:
+      if (known_side == CompiledResult::kTrue) {
+        drop_all();
+        return CompiledResult::kTrue;
+      }
+      drop_op();
+      return other_side;
+    case MaterialConditionNode::OpMode::XOR_OPERATOR:
+      if (other_side != CompiledResult::kDynamic) {
+        drop_all();
+        return known(left != right);
+      }
+      if (known_side == CompiledResult::kFalse) {
+        drop_op();
+      } else {
+        // Xor with true is just a not.
+        (*program)[start] = kCompiledOpNot;
+      }
+      return CompiledResult::kDynamic;
+    default:
+      throw Exception();
+  }
+}
+
+auto MaterialComponent::EvalCompiledConditions(const int32_t* program,
+                                               const Part* part,
+                                               const Part* opposing_part,
+                                               const MaterialContext& s)
+    -> bool {
+  switch (program[0]) {
+    case kCompiledOpAnd:
+      return EvalCompiledConditions(program + 2, part, opposing_part, s)
+             && EvalCompiledConditions(program + program[1], part,
+                                       opposing_part, s);
+    case kCompiledOpOr:
+      return EvalCompiledConditions(program + 2, part, opposing_part, s)
+             || EvalCompiledConditions(program + program[1], part,
+                                       opposing_part, s);
+    case kCompiledOpXor:
+      return EvalCompiledConditions(program + 2, part, opposing_part, s)
+             != EvalCompiledConditions(program + program[1], part,
+                                       opposing_part, s);
+    case kCompiledOpNot:
+      return !EvalCompiledConditions(program + 2, part, opposing_part, s);
+    default:
+      break;
+  }
+  int32_t val1 = program[1];
+  switch (static_cast<MaterialCondition>(program[0])) {
+    case MaterialCondition::kDstIsPart:
+      return opposing_part->id() == val1;
+    case MaterialCondition::kDstNotPart:
+      return opposing_part->id() != val1;
+    case MaterialCondition::kSrcDstSameNode:
+      return opposing_part->node() == part->node();
+    case MaterialCondition::kSrcDstDiffNode:
+      return opposing_part->node() != part->node();
+    case MaterialCondition::kSrcYoungerThan:
+      return part->GetAge() < val1;
+    case MaterialCondition::kSrcOlderThan:
+      return part->GetAge() >= val1;
+    case MaterialCondition::kDstYoungerThan:
+      return opposing_part->GetAge() < val1;
+    case MaterialCondition::kDstOlderThan:
+      return opposing_part->GetAge() >= val1;
+    case MaterialCondition::kCollidingDstNode:
+      return part->IsCollidingWith(opposing_part->node()->id());
+    case MaterialCondition::kNotCollidingDstNode:
+      return !part->IsCollidingWith(opposing_part->node()->id());
+    case MaterialCondition::kEvalColliding:
+      return s.collide && s.node_collide;
+    case MaterialCondition::kEvalNotColliding:
+      return !s.collide || !s.node_collide;
+    default:
+      throw Exception();
+  }
+}
+
 auto MaterialComponent::GetFlattenedSize() -> size_t {
   size_t size{};
 
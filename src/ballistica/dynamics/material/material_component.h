@@ -33,11 +33,33 @@ class MaterialComponent : public Object {
 
   // Apply the component to a context.
   void Apply(MaterialContext* c, const Part* src_part, const Part* dst_part);
+
+  // Result of compiling conditions against a known pair of material sets.
+  enum class CompiledResult { kFalse, kTrue, kDynamic };
+
+  // Partially evaluate our conditions for material 'c' on a part colliding
+  // with a part holding 'dst_materials'. Anything depending only on those
+  // material sets gets folded away; if the result isn't fully known, the
+  // remainder is appended to 'program' as flat bytecode for
+  // EvalCompiledConditions().
+  auto CompileConditions(
+      const Material& c,
+      const std::vector<Object::Ref<Material> >& dst_materials,
+      std::vector<int32_t>* program) -> CompiledResult;
+  static auto EvalCompiledConditions(const int32_t* program, const Part* part,
+                                     const Part* opposing_part,
+                                     const MaterialContext& s) -> bool;
   MaterialComponent();
   MaterialComponent(
       const Object::Ref<MaterialConditionNode>& conditions_in,
       const std::vector<Object::Ref<MaterialAction> >& actions_in);
   ~MaterialComponent();
+
+ private:
+  static auto CompileCondition(
+      const MaterialConditionNode* condition, const Material& c,
+      const std::vector<Object::Ref<Material> >& dst_materials,
+      std::vector<int32_t>* program) -> CompiledResult;
 };
 
 }  // namespace ballistica
@@ -34,6 +34,14 @@ void NodeUserMessageMaterialAction::Execute(Node* node1, Node* node2,
   // See who they want to send the message to.
   Node* target_node = target_other ? node2 : node1;
 
+  if (scene->dynamics()->collision_batching()) {
+    // Liveness gets checked when the batch runs.
+    scene->dynamics()->AddBatchedCollisionAction(
+        target_node, target_other ? node1 : node2, user_message_obj.get(),
+        at_disconnect);
+    return;
+  }
+
   if (!at_disconnect) {
     // Only deliver 'connect' messages if both nodes still exist.
     // This way handlers can avoid having to deal with that ultra-rare
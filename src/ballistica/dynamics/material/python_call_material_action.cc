@@ -25,6 +25,16 @@ void PythonCallMaterialAction::Apply(MaterialContext* context,
 }
 
 void PythonCallMaterialAction::Execute(Node* node1, Node* node2, Scene* scene) {
+  Dynamics* dynamics = scene->dynamics();
+  if (dynamics->collision_batching()) {
+    // Liveness gets checked when the batch runs.
+    if (call->Exists()) {
+      dynamics->AddBatchedCollisionAction(node1, node2, call->object().get(),
+                                          at_disconnect);
+    }
+    return;
+  }
+
   scene->dynamics()->set_collide_message_state(true, false);
 
   // Only run connect commands if both nodes still exist.
@@ -54,6 +54,9 @@ class Part : public Object {
   // collision)
   void SetMaterials(const std::vector<Material*>& vals);
   auto GetMaterials() const -> std::vector<Material*>;
+  auto materials() const -> const std::vector<Object::Ref<Material> >& {
+    return materials_;
+  }
 
   // Apply this part's materials to a context.
   void ApplyMaterials(MaterialContext* s, const Part* src_part,
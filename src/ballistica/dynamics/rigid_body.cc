@@ -2,6 +2,9 @@
 
 #include "ballistica/dynamics/rigid_body.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "ballistica/dynamics/dynamics.h"
 #include "ballistica/dynamics/part.h"
 #include "ballistica/generic/utils.h"
@@ -59,27 +62,26 @@ RigidBody::RigidBody(int id_in, Part* part_in, Type type_in, Shape shape_in,
   part_->AddBody(this);
 
   // Create the geom(s).
+  dSpaceID space = dynamics_->SpaceForGeoms(collide_type_, collide_mask_);
   switch (shape_) {
     case Shape::kSphere: {
       dimensions_[0] = dimensions_[1] = dimensions_[2] = 0.3f;
       geoms_.resize(1);
-      geoms_[0] = dCreateSphere(dynamics_->space(), dimensions_[0]);
+      geoms_[0] = dynamics_->AcquireGeom(dSphereClass, space);
       break;
     }
 
     case Shape::kBox: {
       dimensions_[0] = dimensions_[1] = dimensions_[2] = 0.6f;
       geoms_.resize(1);
-      geoms_[0] = dCreateBox(dynamics_->space(), dimensions_[0], dimensions_[1],
-                             dimensions_[2]);
+      geoms_[0] = dynamics_->AcquireGeom(dBoxClass, space);
       break;
     }
 
     case Shape::kCapsule: {
       dimensions_[0] = dimensions_[1] = 0.3f;
       geoms_.resize(1);
-      geoms_[0] =
-          dCreateCCylinder(dynamics_->space(), dimensions_[0], dimensions_[1]);
+      geoms_[0] = dynamics_->AcquireGeom(dCCylinderClass, space);
       break;
     }
 
@@ -96,14 +98,14 @@ RigidBody::RigidBody(int id_in, Part* part_in, Type type_in, Shape shape_in,
         Vector3f p =
             Matrix44fRotate(Vector3f(0, 1, 0), static_cast<float>(i) * inc)
             * Vector3f(offset, 0, 0);
-        geoms_[i * 2] = dCreateGeomTransform(dynamics_->space());
+        geoms_[i * 2] = dCreateGeomTransform(space);
         geoms_[i * 2 + 1] = dCreateSphere(nullptr, sub_rad);
         dGeomTransformSetGeom(geoms_[i * 2], geoms_[i * 2 + 1]);
         dGeomSetPosition(geoms_[i * 2 + 1], p.v[0], p.v[1], p.v[2]);
       }
 
       // One last center sphere to keep stuff from getting stuck in our middle.
-      geoms_[geoms_.size() - 1] = dCreateSphere(dynamics_->space(), sub_rad);
+      geoms_[geoms_.size() - 1] = dCreateSphere(space, sub_rad);
 
       break;
     }
@@ -128,11 +130,21 @@ RigidBody::RigidBody(int id_in, Part* part_in, Type type_in, Shape shape_in,
 
   for (auto&& i : geoms_) {
     dGeomSetData(i, this);
+
+    // Let spaces throw out pairs that can't collide before even checking
+    // bounds. (They pass pairs where either side wants the other,
+    // which is looser than our both-sides test in Dynamics, so this never
+    // drops anything we'd keep).
+    if (dGeomGetSpace(i)) {
+      dGeomSetCategoryBits(i, collide_type_);
+      dGeomSetCollideBits(i, collide_mask_);
+    }
   }
 
   if (type_ == Type::kBody) {
     assert(body_ == nullptr);
-    body_ = dBodyCreate(dynamics_->ode_world());
+    body_ = dynamics_->AcquireBody();
+    dBodySetData(body_, this);
 
     // For cylinders we only set the transform geoms, not the spheres.
     if (shape_ == Shape::kCylinder) {
@@ -193,15 +205,26 @@ RigidBody::~RigidBody() {
   if (part_.exists()) {
     part_->RemoveBody(this);
   }
+  // Simple shapes hand their geoms (and any body) back to dynamics for
+  // reuse; we let go of geoms first so bodies go back bare.
+  bool pooled = (shape_ == Shape::kSphere || shape_ == Shape::kBox
+                 || shape_ == Shape::kCapsule);
+  assert(!geoms_.empty());
+  for (auto&& i : geoms_) {
+    if (shape_ != Shape::kTrimesh) {
+      dynamics_->RemoveTrimeshCaches(i);
+    }
+    if (pooled) {
+      dynamics_->ReleaseGeom(i);
+    } else {
+      dGeomDestroy(i);
+    }
+  }
   if (type_ == Type::kBody) {
     assert(body_);
-    dBodyDestroy(body_);
+    dynamics_->ReleaseBody(body_);
     body_ = nullptr;
   }
-  assert(!geoms_.empty());
-  for (auto&& i : geoms_) {
-    dGeomDestroy(i);
-  }
 }
 
 auto RigidBody::KillConstraints() -> void {
@@ -242,6 +265,11 @@ auto RigidBody::EmbedFull(char** buffer) -> void {
   bool lv_changed[3];
   bool av_changed[3];
 
+  embedded_asleep_ = !enabled;
+  embedded_time_ = GetRealTime();
+  memcpy(embedded_pos_, p, sizeof(embedded_pos_));
+  memcpy(embedded_quat_, q, sizeof(embedded_quat_));
+
   // only send velocities that are non-zero.
   // we always send position/rotation since that's not likely to be zero
   for (int i = 0; i < 3; i++) {
@@ -273,6 +301,52 @@ auto RigidBody::EmbedFull(char** buffer) -> void {
   }
 }
 
+// How often we re-embed bodies that are lying still.
+const millisecs_t kSleepingBodyEmbedInterval = 5000;
+
+auto RigidBody::IsAsleepSinceLastEmbed() const -> bool {
+  assert(type_ == Type::kBody);
+  // We still send sleeping bodies every now and then for the benefit
+  // of anyone who may have missed it.
+  if (!embedded_asleep_ || dBodyIsEnabled(body_)
+      || GetRealTime() - embedded_time_ > kSleepingBodyEmbedInterval) {
+    return false;
+  }
+
+  // Sleeping bodies don't move on their own but they can still be
+  // explicitly repositioned.
+  return !memcmp(embedded_pos_, dBodyGetPosition(body_), sizeof(embedded_pos_))
+         && !memcmp(embedded_quat_, dBodyGetQuaternion(body_),
+                    sizeof(embedded_quat_));
+}
+
+auto RigidBody::GetEmbedDivergence() const -> float {
+  assert(type_ == Type::kBody);
+
+  // Distance moved plus rotation (as quaternion difference; near enough
+  // for ranking) plus a bit for age so unchanging bodies still rotate
+  // through eventually. Bodies that were never embedded go first.
+  if (embedded_time_ == 0) {
+    return std::numeric_limits<float>::max();
+  }
+  const dReal* p = dBodyGetPosition(body_);
+  const dReal* q = dBodyGetQuaternion(body_);
+  float pos_diff = 0.0f;
+  for (int i = 0; i < 3; i++) {
+    pos_diff += std::abs(p[i] - embedded_pos_[i]);
+  }
+
+  // q and -q are the same rotation.
+  float quat_diff = 0.0f;
+  float quat_diff_neg = 0.0f;
+  for (int i = 0; i < 4; i++) {
+    quat_diff += std::abs(q[i] - embedded_quat_[i]);
+    quat_diff_neg += std::abs(q[i] + embedded_quat_[i]);
+  }
+  float age = static_cast<float>(GetRealTime() - embedded_time_) * 0.001f;
+  return pos_diff + std::min(quat_diff, quat_diff_neg) + 0.1f * age;
+}
+
 // Position a body from buffer data.
 auto RigidBody::ExtractFull(const char** buffer) -> void {
   assert(type_ == Type::kBody);
@@ -324,6 +398,46 @@ auto RigidBody::ExtractFull(const char** buffer) -> void {
   }
 }
 
+auto RigidBody::GetSnapshot(uint8_t* buffer) const -> void {
+  assert(type_ == Type::kBody);
+  const size_t kVecSize = 3 * sizeof(dReal);
+  memcpy(buffer, dBodyGetPosition(body_), kVecSize);
+  buffer += kVecSize;
+  memcpy(buffer, dBodyGetQuaternion(body_), sizeof(dQuaternion));
+  buffer += sizeof(dQuaternion);
+  memcpy(buffer, dBodyGetLinearVel(body_), kVecSize);
+  buffer += kVecSize;
+  memcpy(buffer, dBodyGetAngularVel(body_), kVecSize);
+  buffer += kVecSize;
+  *buffer = static_cast<uint8_t>(dBodyIsEnabled(body_) != 0);
+}
+
+auto RigidBody::ApplySnapshot(const uint8_t* buffer) -> void {
+  assert(type_ == Type::kBody);
+  dReal p[3], lv[3], av[3];
+  dQuaternion q;
+  memcpy(p, buffer, sizeof(p));
+  buffer += sizeof(p);
+  memcpy(q, buffer, sizeof(q));
+  buffer += sizeof(q);
+  memcpy(lv, buffer, sizeof(lv));
+  buffer += sizeof(lv);
+  memcpy(av, buffer, sizeof(av));
+  buffer += sizeof(av);
+  dBodySetPosition(body_, p[0], p[1], p[2]);
+  dBodySetQuaternion(body_, q);
+  dBodySetLinearVel(body_, lv[0], lv[1], lv[2]);
+  dBodySetAngularVel(body_, av[0], av[1], av[2]);
+  if (*buffer) {
+    dBodyEnable(body_);
+  } else {
+    dBodyDisable(body_);
+  }
+
+  // Don't draw a blend from wherever we were before.
+  interpolation_valid_ = false;
+}
+
 auto RigidBody::Draw(RenderPass* pass, bool shaded) -> void {
   assert(pass);
   RenderPass::Type pass_type = pass->type();
@@ -670,6 +784,71 @@ auto RigidBody::GetTransform() -> Matrix44f {
   return matrix;
 }
 
+auto RigidBody::StoreInterpolationState() -> void {
+  if (type_ != Type::kBody) {
+    return;
+  }
+  memcpy(interpolation_pos_, dBodyGetPosition(body_),
+         sizeof(interpolation_pos_));
+  memcpy(interpolation_quat_, dBodyGetQuaternion(body_),
+         sizeof(interpolation_quat_));
+  interpolation_valid_ = true;
+}
+
+auto RigidBody::GetRenderState(float* pos, float* r) const -> void {
+  const dReal* pos_in;
+  const dReal* r_in;
+  if (type_ == Type::kBody) {
+    pos_in = dBodyGetPosition(body_);
+    r_in = dBodyGetRotation(body_);
+  } else {
+    pos_in = dGeomGetPosition(geom());
+    r_in = dGeomGetRotation(geom());
+  }
+  float t = dynamics_->render_interpolation();
+
+  // Anything covering this much ground in one step was most likely
+  // teleported; just snap it.
+  const dReal kMaxInterpolationDistSquared{1.0f};
+  dVector3 delta{pos_in[0] - interpolation_pos_[0],
+                 pos_in[1] - interpolation_pos_[1],
+                 pos_in[2] - interpolation_pos_[2]};
+  if (type_ == Type::kBody && interpolation_valid_ && t < 1.0f
+      && dDOT(delta, delta) < kMaxInterpolationDistSquared) {
+    // Normalized lerp is plenty for the small rotations within a step;
+    // flip as needed to take the short way around.
+    const dReal* q = dBodyGetQuaternion(body_);
+    dReal dot{};
+    for (int x = 0; x < 4; x++) {
+      dot += interpolation_quat_[x] * q[x];
+    }
+    dReal sign = dot < 0.0f ? -1.0f : 1.0f;
+    dQuaternion q_interp;
+    for (int x = 0; x < 4; x++) {
+      q_interp[x] = interpolation_quat_[x] * (1.0f - t) + q[x] * sign * t;
+    }
+    dNormalize4(q_interp);
+    dMatrix3 r_interp;
+    dRfromQ(r_interp, q_interp);
+    for (int x = 0; x < 3; x++) {
+      pos[x] = interpolation_pos_[x] + delta[x] * t;
+    }
+    for (int x = 0; x < 12; x++) {
+      r[x] = r_interp[x];
+    }
+  } else {
+    for (int x = 0; x < 3; x++) {
+      pos[x] = pos_in[x];
+    }
+    for (int x = 0; x < 12; x++) {
+      r[x] = r_in[x];
+    }
+  }
+  pos[0] += blend_offset().x;
+  pos[1] += blend_offset().y;
+  pos[2] += blend_offset().z;
+}
+
 auto RigidBody::AddBlendOffset(float x, float y, float z) -> void {
   //  blend_offset_.x += x;
   //  blend_offset_.y += y;
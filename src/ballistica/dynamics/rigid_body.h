@@ -80,6 +80,21 @@ class RigidBody : public Object {
   auto GetEmbeddedSizeFull() -> int;
   auto ExtractFull(const char** buffer) -> void;
   auto EmbedFull(char** buffer) -> void;
+
+  // Exact state for scene snapshots (see Scene::GetSnapshot()). Unlike the
+  // embed calls these are lossless and don't affect what gets sent in
+  // correction messages.
+  static const int kSnapshotSize = 13 * sizeof(dReal) + 1;
+  auto GetSnapshot(uint8_t* buffer) const -> void;
+  auto ApplySnapshot(const uint8_t* buffer) -> void;
+
+  // Returns true if this body is asleep and has not moved since it was
+  // recently embedded (meaning there's little point embedding it again).
+  auto IsAsleepSinceLastEmbed() const -> bool;
+
+  // Roughly how far clients' copy of this body may have drifted from ours
+  // since it was last embedded; used to decide what to correct first.
+  auto GetEmbedDivergence() const -> float;
   RigidBody(int id_in, Part* part_in, Type type_in, Shape shape_in,
             uint32_t collide_type_in, uint32_t collide_mask_in,
             CollideModel* collide_model_in = nullptr, uint32_t flags = 0);
@@ -178,6 +193,15 @@ class RigidBody : public Object {
   // Applies to spheres.
   auto radius() const -> float { return dimensions_[0]; }
   auto GetTransform() -> Matrix44f;
+
+  /// Render interpolation: record our current state as the start point
+  /// for blending towards the next step's state.
+  auto StoreInterpolationState() -> void;
+
+  /// Position (including blend offset) and rotation to draw at. These
+  /// blend between our last two step states when render interpolation
+  /// is enabled. 'r' is in ODE's 3x4 rotation layout.
+  auto GetRenderState(float* pos, float* r) const -> void;
   auto UpdateBlending() -> void;
   auto AddBlendOffset(float x, float y, float z) -> void;
   auto blend_offset() const -> const Vector3f& { return blend_offset_; }
@@ -212,6 +236,17 @@ class RigidBody : public Object {
   };
   std::vector<CollideCallback> collide_callbacks_;
   uint32_t flags_{};
+
+  // State as of our last EmbedFull() call.
+  bool embedded_asleep_{};
+  millisecs_t embedded_time_{};
+  dReal embedded_pos_[3]{};
+  dReal embedded_quat_[4]{};
+
+  // Start point for render interpolation.
+  bool interpolation_valid_{};
+  dReal interpolation_pos_[3]{};
+  dReal interpolation_quat_[4]{};
 };
 
 }  // namespace ballistica
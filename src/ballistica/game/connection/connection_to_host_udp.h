@@ -22,6 +22,7 @@ class ConnectionToHostUDP : public ConnectionToHost {
   auto request_id() const -> uint8_t { return request_id_; }
   void set_client_id(int val) { client_id_ = val; }
   auto client_id() const -> int { return client_id_; }
+  auto addr() const -> const SockAddr& { return *addr_; }
 
   // Attempt connecting via a different protocol.  If none are left to try,
   // returns false.
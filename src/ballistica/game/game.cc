@@ -2,9 +2,16 @@
 
 #include "ballistica/game/game.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "ballistica/app/app.h"
 #include "ballistica/app/app_config.h"
+#include "ballistica/app/config_writer.h"
 #include "ballistica/audio/audio.h"
+#include "ballistica/audio/audio_server.h"
+#include "ballistica/core/event_trace.h"
+#include "ballistica/core/startup_timeline.h"
 #include "ballistica/core/thread.h"
 #include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/game/account.h"
@@ -13,13 +20,17 @@
 #include "ballistica/game/connection/connection_to_host_udp.h"
 #include "ballistica/game/friend_score_set.h"
 #include "ballistica/game/host_activity.h"
+#include "ballistica/game/load_test.h"
+#include "ballistica/game/net_stats.h"
 #include "ballistica/game/player.h"
 #include "ballistica/game/score_to_beat.h"
 #include "ballistica/game/session/client_session.h"
 #include "ballistica/game/session/host_session.h"
 #include "ballistica/game/session/net_client_session.h"
 #include "ballistica/game/session/replay_client_session.h"
+#include "ballistica/game/telemetry.h"
 #include "ballistica/generic/json.h"
+#include "ballistica/generic/json_stream.h"
 #include "ballistica/generic/timer.h"
 #include "ballistica/graphics/graphics.h"
 #include "ballistica/graphics/graphics_server.h"
@@ -27,12 +38,16 @@
 #include "ballistica/input/device/client_input_device.h"
 #include "ballistica/input/device/keyboard_input.h"
 #include "ballistica/input/device/touch_input.h"
+#include "ballistica/media/component/collide_model.h"
+#include "ballistica/media/component/sound.h"
+#include "ballistica/media/media_server.h"
 #include "ballistica/networking/network_write_module.h"
 #include "ballistica/networking/sockaddr.h"
 #include "ballistica/networking/telnet_server.h"
 #include "ballistica/python/python.h"
 #include "ballistica/python/python_command.h"
 #include "ballistica/python/python_context_call.h"
+#include "ballistica/python/python_gc.h"
 #include "ballistica/python/python_sys.h"
 #include "ballistica/scene/node/globals_node.h"
 #include "ballistica/ui/console.h"
@@ -44,6 +59,11 @@
 namespace ballistica {
 
 /// How long a kick vote lasts.
+// Young-generation Python garbage collection gets to use whatever is
+// left of this much time per update, up to a cap.
+const double kPythonGCUpdateTargetSeconds = 0.010;
+const double kPythonGCMaxIdleSeconds = 0.002;
+
 const int kKickVoteDuration = 30000;
 
 /// How long everyone has to wait to start a new kick vote after a failed one.
@@ -61,9 +81,17 @@ const int kKickVoteMinimumClients = (g_buildconfig.headless_build() ? 3 : 4);
 
 const int kMaxChatMessages = 40;
 
+// How many compiled Lstr values we hang on to.
+const size_t kLstrCacheSize = 512;
+
 // Go with 5 minute ban.
 const int kKickBanSeconds = 5 * 60;
 
+// How long a headless server sits empty before pausing its sessions, and
+// how often it checks in while paused.
+const millisecs_t kHeadlessIdleDelay = 10000;
+const millisecs_t kHeadlessIdleUpdateInterval = 100;
+
 Game::Game(Thread* thread)
     : Module("game", thread),
       game_roster_(cJSON_CreateArray()),
@@ -74,6 +102,7 @@ Game::Game(Thread* thread)
 
   try {
     // Spin up some other game-thread-based stuff.
+    StartupTimeline::Begin("game globals");
     AppConfig::Init();
     assert(g_graphics == nullptr);
     g_graphics = g_platform->CreateGraphics();
@@ -99,13 +128,16 @@ Game::Game(Thread* thread)
 
     assert(g_input == nullptr);
     g_input = new Input();
+    StartupTimeline::End("game globals");
 
     // Init python and apply our settings immediately.
     // This way we can get started loading stuff in the background
     // and it'll come in with the correct texture quality etc.
+    StartupTimeline::Begin("python init");
     assert(g_python == nullptr);
     g_python = new Python();
     g_python->Reset(true);
+    StartupTimeline::End("python init");
 
     // We're the thread that 'owns' python so we need to wrangle the GIL.
     thread->SetOwnsPython();
@@ -231,6 +263,9 @@ void Game::SetGameRoster(cJSON* r) {
     cJSON_Delete(game_roster_);
   }
   game_roster_ = r;
+
+  // Whatever we last built ourself no longer applies.
+  game_roster_json_.clear();
 }
 
 void Game::ResetActivityTracking() {
@@ -277,7 +312,9 @@ void Game::InitialScreenCreated() {
 
   // We can now let the media thread go to town pre-loading system media
   // while we wait.
+  StartupTimeline::Begin("system media");
   g_media->LoadSystemMedia();
+  StartupTimeline::End("system media");
 
   // FIXME: ideally we should create this as part of bootstrapping, but
   // we need it to be possible to load textures/etc. before the renderer
@@ -296,9 +333,11 @@ void Game::InitialScreenCreated() {
   // Normally we schedule updates when we're asked to draw a frame.
   // In headless mode, however, we're not drawing, so we need a dedicated
   // timer to take its place.
+  // In turbo mode we update on every event loop cycle.
   if (HeadlessMode()) {
     headless_update_timer_ =
-        NewThreadTimer(8, true, NewLambdaRunnable([this] { Update(); }));
+        NewThreadTimer(g_app_globals->turbo_mode ? 0 : 8, true,
+                       NewLambdaRunnable([this] { Update(); }));
   }
 
   RunAppLaunchCommands();
@@ -313,6 +352,8 @@ void Game::RunAppLaunchCommands() {
 
   // First off, run our python app-launch call.
   {
+    StartupTimeline::Scope timeline_scope("python app launch");
+
     // Run this in the UI context.
     ScopedSetContext cp(GetUIContext());
     g_python->obj(Python::ObjID::kFinishBootstrappingCall).Call();
@@ -333,6 +374,12 @@ void Game::RunAppLaunchCommands() {
   }
 
   UpdateProcessTimer();
+
+  // There are no frames to wait on in headless builds; this is as far as
+  // startup goes.
+  if (HeadlessMode()) {
+    StartupTimeline::NoteFirstFrame();
+  }
 }
 
 Game::~Game() = default;
@@ -359,12 +406,87 @@ void Game::UpdateProcessTimer() {
   }
 }
 
+// How many hosts we remember client-session media for.
+const size_t kClientJoinMediaCacheSize = 8;
+
+// Media used by sessions with recently visited hosts, so rejoining can
+// start loading it before the host's scene dump arrives.
+struct ClientJoinMedia {
+  std::string host_key;
+  std::vector<std::string> textures;
+  std::vector<std::string> models;
+  std::vector<std::string> collide_models;
+  std::vector<std::string> sounds;
+};
+static std::list<ClientJoinMedia>* g_client_join_media{};  // Newest first.
+static std::string* g_client_session_host_key{};
+
+template <typename T>
+static auto GetClientSessionMediaNames(const std::vector<Object::Ref<T>>& list)
+    -> std::vector<std::string> {
+  std::vector<std::string> names;
+  for (auto&& i : list) {
+    if (i.exists()) {
+      names.push_back(i->name());
+    }
+  }
+  return names;
+}
+
+// Called as a net client session dies.
+static void RememberClientJoinMedia(ClientSession* session) {
+  if (g_client_session_host_key == nullptr
+      || g_client_session_host_key->empty()) {
+    return;
+  }
+  ClientJoinMedia media;
+  media.host_key.swap(*g_client_session_host_key);
+  media.textures = GetClientSessionMediaNames(session->textures());
+  media.models = GetClientSessionMediaNames(session->models());
+  media.collide_models = GetClientSessionMediaNames(session->collide_models());
+  media.sounds = GetClientSessionMediaNames(session->sounds());
+  g_client_join_media->remove_if([&media](const ClientJoinMedia& m) {
+    return m.host_key == media.host_key;
+  });
+  g_client_join_media->push_front(std::move(media));
+  if (g_client_join_media->size() > kClientJoinMediaCacheSize) {
+    g_client_join_media->pop_back();
+  }
+}
+
+// Called as a net client session launches.
+static void PrefetchClientJoinMedia(ConnectionToHost* connection) {
+  if (g_client_join_media == nullptr) {
+    g_client_join_media = new std::list<ClientJoinMedia>();
+    g_client_session_host_key = new std::string();
+  }
+  g_client_session_host_key->clear();
+  ConnectionToHostUDP* udp = connection ? connection->GetAsUDP() : nullptr;
+  if (udp == nullptr) {
+    return;
+  }
+  const SockAddr& addr = udp->addr();
+  g_client_session_host_key->assign(
+      reinterpret_cast<const char*>(addr.GetSockAddr()),
+      addr.GetSockAddrLen());
+  for (auto&& media : *g_client_join_media) {
+    if (media.host_key == *g_client_session_host_key) {
+      g_media->PrefetchMedia(media.textures, media.models,
+                             media.collide_models, media.sounds, {});
+      return;
+    }
+  }
+}
+
 void Game::PruneSessions() {
   bool have_dead_session = false;
   for (auto&& i : sessions_) {
     if (i.exists()) {
       // If this session is no longer foreground and is ready to die, kill it.
       if (i.exists() && i.get() != foreground_session_.get()) {
+        if (auto* client_session = dynamic_cast<NetClientSession*>(i.get())) {
+          RememberClientJoinMedia(client_session);
+        }
         try {
           i.Clear();
         } catch (const std::exception& e) {
@@ -514,8 +636,22 @@ void Game::HandleQuitOnIdle() {
 }
 
 // Bring our scenes, real-time timers, etc up to date.
+// Give Python's cyclic GC its chance to run with what's left of an update.
+static void RunIdlePythonGC(std::chrono::steady_clock::time_point start) {
+  if (g_python == nullptr || !g_python->inited()) {
+    return;
+  }
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  PythonGC::RunIdle(std::clamp(kPythonGCUpdateTargetSeconds - elapsed, 0.0,
+                               kPythonGCMaxIdleSeconds));
+}
+
 void Game::Update() {
+  BA_TRACE_SCOPE("Game::Update");
   assert(InGameThread());
+  auto update_start_time = std::chrono::steady_clock::now();
   millisecs_t real_time = GetRealTime();
   g_platform->SetDebugKey("LastUpdateTime",
                           std::to_string(Platform::GetCurrentMilliseconds()));
@@ -543,6 +679,33 @@ void Game::Update() {
   }
 
   connections_->Update();
+  NetStats::Update(real_time);
+
+  if (g_app_globals->turbo_mode) {
+    UpdateTurbo(real_time);
+#if BA_ENABLE_AUDIO
+    g_audio_server->FlushSourceCommands();
+#endif
+    RunIdlePythonGC(update_start_time);
+    in_update_ = false;
+    return;
+  }
+
+  if (HeadlessMode() && UpdateHeadlessIdle(real_time)) {
+    RunIdlePythonGC(update_start_time);
+    in_update_ = false;
+    return;
+  }
+
+  if (!g_app_globals->capture_path.empty()) {
+    UpdateCapture(real_time);
+#if BA_ENABLE_AUDIO
+    g_audio_server->FlushSourceCommands();
+#endif
+    RunIdlePythonGC(update_start_time);
+    in_update_ = false;
+    return;
+  }
 
   // Ok, here's the deal:
   // This is where we regulate the speed of everything that's running under us
@@ -630,22 +793,7 @@ void Game::Update() {
       }
     }
 
-    // Update our UI scene/etc.
-    g_ui->Update(8);
-
-    // Update all of our sessions.
-    for (auto&& i : sessions_) {
-      assert(i.exists());
-      i->Update(8);
-    }
-
-    last_session_update_master_time_ = master_time_;
-
-    // Go ahead and prune dead ones.
-    PruneSessions();
-
-    // Advance master time..
-    master_time_ += 8;
+    StepSessions();
 
     // Bail if we spend too much time in here.
     millisecs_t new_real_time = GetRealTime();
@@ -654,9 +802,143 @@ void Game::Update() {
     }
     step++;
   }
+
+  // Send along all the sound changes from this update in one go.
+#if BA_ENABLE_AUDIO
+  g_audio_server->FlushSourceCommands();
+#endif
+  RunIdlePythonGC(update_start_time);
   in_update_ = false;
 }
 
+// Advance our UI and sessions by a single 8ms step.
+auto Game::StepSessions() -> void {
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Update our UI scene/etc.
+  g_ui->Update(8);
+
+  // Update all of our sessions.
+  for (auto&& i : sessions_) {
+    assert(i.exists());
+    i->Update(8);
+  }
+
+  last_session_update_master_time_ = master_time_;
+
+  // Go ahead and prune dead ones.
+  PruneSessions();
+
+  // Advance master time..
+  master_time_ += 8;
+
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start_time)
+                       .count();
+  Telemetry::AddGameStep(seconds);
+  if (LoadTest::running()) {
+    LoadTest::AddStep(seconds);
+  }
+}
+
+// In turbo mode we don't try to match real-time at all; we just step as
+// many times as we can fit in a brief slice of real-time and then return
+// so our thread can process its other events before the next update.
+auto Game::UpdateTurbo(millisecs_t real_time) -> void {
+  assert(g_app_globals->turbo_mode);
+  if (turbo_master_steps_ == 0) {
+    turbo_start_real_time_ = real_time;
+    turbo_start_master_time_ = master_time_;
+  }
+
+  realtimers_->Run(real_time);
+
+  do {
+    StepSessions();
+    turbo_master_steps_++;
+  } while (GetRealTime() - real_time < 30);
+
+  // Keep our offset current so things behave sanely if we ever stop.
+  master_time_offset_ = master_time_ - GetRealTime();
+}
+
+// A server with nobody connected has nobody to show anything to, so once
+// it's been empty for a bit we stop stepping sessions and only check in a
+// few times a second (real-time timers and connection handling keep
+// going, so server housekeeping still runs and arrivals wake us).
+// Returns true while idle.
+auto Game::UpdateHeadlessIdle(millisecs_t real_time) -> bool {
+  assert(HeadlessMode());
+  if (!g_app_globals->headless_idle_pause || g_app_globals->turbo_mode) {
+    return false;
+  }
+  if (last_client_present_time_ < 0
+      || !connections()->GetConnectionsToClients().empty()) {
+    last_client_present_time_ = real_time;
+  }
+  bool idle = real_time - last_client_present_time_ > kHeadlessIdleDelay;
+  if (idle != headless_idle_) {
+    headless_idle_ = idle;
+    assert(headless_update_timer_);
+    headless_update_timer_->SetLength(idle ? kHeadlessIdleUpdateInterval : 8);
+  }
+  if (!idle) {
+    return false;
+  }
+  realtimers_->Run(real_time);
+
+  // Pick back up from wherever we are when we wake instead of racing to
+  // catch up.
+  master_time_offset_ = master_time_ - real_time;
+  return true;
+}
+
+// In capture mode we're called once per drawn frame and advance to exactly
+// where that frame falls on a fixed timeline, regardless of how long it
+// took to render. Since we step in 8ms increments, frame rates that
+// divide evenly into 125 give the cleanest step cadence.
+auto Game::UpdateCapture(millisecs_t real_time) -> void {
+  assert(!g_app_globals->capture_path.empty());
+  if (capture_frame_count_ == 0) {
+    capture_start_master_time_ = master_time_;
+  }
+  capture_frame_count_++;
+  millisecs_t target_master_time =
+      capture_start_master_time_
+      + capture_frame_count_ * 1000 / g_app_globals->capture_fps;
+
+  realtimers_->Run(real_time);
+
+  // Step to whichever side of the target is nearer.
+  while (master_time_ + 4 <= target_master_time) {
+    StepSessions();
+  }
+
+  // Keep our offset current so things behave sanely if we ever stop.
+  master_time_offset_ = master_time_ - GetRealTime();
+}
+
+auto Game::LogTurboStats() -> void {
+  millisecs_t real_duration = GetRealTime() - turbo_start_real_time_;
+  millisecs_t master_duration = master_time_ - turbo_start_master_time_;
+  double real_seconds = std::max(real_duration, millisecs_t{1}) * 0.001;
+  auto scene_steps = std::max(turbo_scene_steps_, uint64_t{1});
+  char buffer[512];
+  snprintf(buffer, sizeof(buffer),
+           "Turbo stats: %.1fs of game time in %.1fs real (%.1fx);"
+           " %llu steps (%.0f/s); %llu scene steps (%.0f/s);"
+           " %.1f nodes and %.1f collisions per scene step.",
+           master_duration * 0.001, real_seconds,
+           master_duration * 0.001 / real_seconds,
+           static_cast<unsigned long long>(turbo_master_steps_),  // NOLINT
+           turbo_master_steps_ / real_seconds,
+           static_cast<unsigned long long>(turbo_scene_steps_),  // NOLINT
+           turbo_scene_steps_ / real_seconds,
+           static_cast<double>(turbo_node_steps_) / scene_steps,
+           static_cast<double>(turbo_collisions_) / scene_steps);
+  Log(buffer);
+}
+
 // Reset the game to a blank slate.
 void Game::Reset() {
   assert(InGameThread());
@@ -800,6 +1082,7 @@ void Game::LaunchClientSession() {
   try {
     auto s(Object::New<Session, NetClientSession>());
     sessions_.push_back(s);
+    PrefetchClientJoinMedia(connections_->connection_to_host());
 
     // It should have set itself as FG.
     assert(foreground_session_ == s);
@@ -985,6 +1268,9 @@ void Game::HandleThreadPause() {
 
   // Tell our account client to commit any outstanding changes to disk.
   AppInternalOnGameThreadPause();
+
+  // We may not get another chance at pending config writes.
+  ConfigWriter::Flush();
 }
 
 void Game::PushPythonCall(const Object::Ref<PythonContextCall>& call) {
@@ -1262,6 +1548,10 @@ void Game::PushOnAppResumeCall() {
 void Game::ApplyConfig() {
   assert(InGameThread());
 
+  // Grab fresh values for any AppConfig::Resolve() calls (here or in other
+  // threads).
+  g_app_config->RefreshSnapshot();
+
   // Not relevant for fullscreen anymore
   // since we're fullscreen windows everywhere.
   int width = 800;
@@ -1306,6 +1596,25 @@ void Game::ApplyConfig() {
     graphics_quality_requested = GraphicsQuality::kAuto;
   }
 
+  // Results of any earlier auto quality calibration; the graphics server
+  // decides whether they still apply to the hardware we're on.
+  std::string calibration_key =
+      g_python->GetRawConfigValue("Graphics Calibration Key", "");
+  std::string calibration_qualstr =
+      g_python->GetRawConfigValue("Graphics Calibration Quality", "");
+  GraphicsQuality calibration_quality{GraphicsQuality::kAuto};
+  if (calibration_qualstr == "Higher") {
+    calibration_quality = GraphicsQuality::kHigher;
+  } else if (calibration_qualstr == "High") {
+    calibration_quality = GraphicsQuality::kHigh;
+  } else if (calibration_qualstr == "Medium") {
+    calibration_quality = GraphicsQuality::kMedium;
+  } else if (calibration_qualstr == "Low") {
+    calibration_quality = GraphicsQuality::kLow;
+  }
+  g_graphics_server->PushSetQualityCalibrationCall(calibration_key,
+                                                   calibration_quality);
+
   // Android res string.
   std::string android_res =
       g_app_config->Resolve(AppConfig::StringID::kResolutionAndroid);
@@ -1334,6 +1643,20 @@ void Game::ApplyConfig() {
 
   chat_muted_ = g_app_config->Resolve(AppConfig::BoolID::kChatMuted);
   g_graphics->set_show_fps(g_app_config->Resolve(AppConfig::BoolID::kShowFPS));
+  g_graphics->set_show_render_stats(
+      g_app_config->Resolve(AppConfig::BoolID::kShowRenderStats));
+  g_graphics->set_sort_opaque_draws(
+      g_app_config->Resolve(AppConfig::BoolID::kSortOpaqueDraws));
+  g_media->set_texture_memory_budget(
+      static_cast<size_t>(std::max(
+          0, g_app_config->Resolve(AppConfig::IntID::kTextureMemoryBudget)))
+      * 1024 * 1024);
+  g_media->set_media_memory_budget(
+      static_cast<size_t>(std::max(
+          0, g_app_config->Resolve(AppConfig::IntID::kMediaMemoryBudget)))
+      * 1024 * 1024);
+  g_graphics_server->SetFrameQueueDepth(
+      g_app_config->Resolve(AppConfig::IntID::kFrameQueueDepth));
 
   // Set tv border (for both client and server).
   // FIXME: this should exist either on the client or the server; not both.
@@ -1347,6 +1670,9 @@ void Game::ApplyConfig() {
       g_app_config->Resolve(AppConfig::FloatID::kScreenGamma));
   g_graphics_server->PushSetScreenPixelScaleCall(
       g_app_config->Resolve(AppConfig::FloatID::kScreenPixelScale));
+  g_graphics_server->PushSetCameraRenderScaleCall(
+      g_app_config->Resolve(AppConfig::FloatID::kCameraRenderScale),
+      g_app_config->Resolve(AppConfig::FloatID::kDynamicResolutionTarget));
 
   TextWidget::set_always_use_internal_keyboard(
       g_app_config->Resolve(AppConfig::BoolID::kAlwaysUseInternalKeyboard));
@@ -1370,6 +1696,12 @@ void Game::ApplyConfig() {
     auto_v_sync = false;
     Log("Error: Invalid 'Vertical Sync' value: '" + v_sync + "'");
   }
+
+  // No reason to wait on the display when capturing frames.
+  if (!g_app_globals->capture_path.empty()) {
+    do_v_sync = false;
+    auto_v_sync = false;
+  }
   g_graphics_server->PushSetVSyncCall(do_v_sync, auto_v_sync);
 
   g_audio->SetVolumes(g_app_config->Resolve(AppConfig::FloatID::kMusicVolume),
@@ -1413,8 +1745,23 @@ void Game::ApplyConfig() {
   idle_exit_minutes_ =
       g_app_config->Resolve(AppConfig::OptionalFloatID::kIdleExitMinutes);
 
+  if (g_bg_dynamics) {
+    g_bg_dynamics->SetStepBudget(
+        g_app_config->Resolve(AppConfig::FloatID::kBGDynamicsStepBudget));
+    g_bg_dynamics->SetDeterministic(
+        g_app_config->Resolve(AppConfig::BoolID::kBGDynamicsDeterministic));
+  }
+
   // Any platform-specific settings.
   g_platform->ApplyConfig();
+
+  // The first time through, our screen and shaders are now being set up in
+  // the graphics thread; get media that doesn't depend on them loading in
+  // the meantime.
+  if (!g_media->early_system_media_loaded()) {
+    StartupTimeline::Scope timeline_scope("early system media");
+    g_media->LoadEarlySystemMedia();
+  }
 }
 
 void Game::PushApplyConfigCall() {
@@ -1483,6 +1830,10 @@ void Game::Shutdown(bool soft) {
     // Nuke the app if we get stuck shutting down.
     Utils::StartSuicideTimer("shutdown", 10000);
 
+    if (g_app_globals->turbo_mode) {
+      LogTurboStats();
+    }
+
     // Call our shutdown callback.
     g_python->obj(Python::ObjID::kShutdownCall).Call();
 
@@ -1548,6 +1899,22 @@ void Game::SetLanguageKeys(
     language_ = language;
   }
 
+  // Compiled strings from the old language are no good now.
+  lstr_cache_index_.clear();
+  lstr_cache_.clear();
+
+  // Get the glyph pages the new language needs loaded in the background
+  // so laying out its text doesn't stall on disk loads later.
+  if (g_media_server) {
+    std::string all_text;
+    for (auto&& i : language) {
+      all_text += i.second;
+    }
+    g_media_server->PushCall([all_text] {
+      g_text_graphics->PreloadGlyphPagesForText(all_text);
+    });
+  }
+
   // Let's also inform existing session stuff so it can update itself.
   if (Session* session = GetForegroundSession()) {
     session->LanguageChanged();
@@ -1762,6 +2129,17 @@ auto Game::CompileResourceString(const std::string& s, const std::string& loc,
     return s;
   }
 
+  // The same few values tend to get compiled over and over (text nodes,
+  // screen messages, etc.) so keep recent results around.
+  auto cached = lstr_cache_index_.find(s);
+  if (cached != lstr_cache_index_.end()) {
+    lstr_cache_.splice(lstr_cache_.begin(), lstr_cache_, cached->second);
+    Telemetry::AddLstrCacheLookup(true);
+    *valid = true;
+    return cached->second->second;
+  }
+  Telemetry::AddLstrCacheLookup(false);
+
   cJSON* root = cJSON_Parse(s.c_str());
   if (root == nullptr) {
     Log("CompileResourceString failed (loc " + loc + "); invalid json: '" + s
@@ -1780,6 +2158,16 @@ auto Game::CompileResourceString(const std::string& s, const std::string& loc,
     *valid = false;
   }
   cJSON_Delete(root);
+
+  // Only successes get cached so failures keep getting logged.
+  if (*valid) {
+    lstr_cache_.emplace_front(s, result);
+    lstr_cache_index_[lstr_cache_.front().first] = lstr_cache_.begin();
+    if (lstr_cache_.size() > kLstrCacheSize) {
+      lstr_cache_index_.erase(lstr_cache_.back().first);
+      lstr_cache_.pop_back();
+    }
+  }
   return result;
 }
 
@@ -1900,8 +2288,14 @@ void Game::LocalDisplayChatMessage(const std::vector<uint8_t>& buffer) {
 auto Game::GetGameRosterMessage() -> std::vector<uint8_t> {
   // This message is simply a flattened json string of our roster (including
   // terminating char).
+  if (!game_roster_json_.empty()) {
+    std::vector<uint8_t> msg(1 + game_roster_json_.size() + 1);
+    msg[0] = BA_MESSAGE_PARTY_ROSTER;
+    memcpy(&(msg[1]), game_roster_json_.c_str(),
+           game_roster_json_.size() + 1);
+    return msg;
+  }
   char* s = cJSON_PrintUnformatted(game_roster_);
-  // printf("ROSTER MESSAGE %s\n", s);
   auto s_len = strlen(s);
   std::vector<uint8_t> msg(1 + s_len + 1);
   msg[0] = BA_MESSAGE_PARTY_ROSTER;
@@ -1911,6 +2305,19 @@ auto Game::GetGameRosterMessage() -> std::vector<uint8_t> {
   return msg;
 }
 
+auto Game::GetGameRosterJson() -> std::string {
+  if (!game_roster_json_.empty()) {
+    return game_roster_json_;
+  }
+  if (game_roster_ == nullptr) {
+    return "[]";
+  }
+  char* s = cJSON_PrintUnformatted(game_roster_);
+  std::string json = s;
+  free(s);
+  return json;
+}
+
 auto Game::IsPlayerBanned(const PlayerSpec& spec) -> bool {
   millisecs_t current_time = GetRealTime();
 
@@ -2031,16 +2438,26 @@ void Game::BanPlayer(const PlayerSpec& spec, millisecs_t duration) {
   banned_players_.emplace_back(GetRealTime() + duration, spec);
 }
 
+// Add a roster entry for a player.
+static void WriteRosterPlayer(JsonWriter* writer, Player* p) {
+  writer->BeginObject()
+      .Key("n")
+      .String(p->GetName())
+      .Key("nf")
+      .String(p->GetName(true))
+      .Key("i")
+      .Int(p->id())
+      .EndObject();
+}
+
 void Game::UpdateGameRoster() {
   assert(InGameThread());
 
-  assert(game_roster_ != nullptr);
-  if (game_roster_ != nullptr) {
-    cJSON_Delete(game_roster_);
-  }
-
   // Our party-roster is just a json array of dicts containing player-specs.
-  game_roster_ = cJSON_CreateArray();
+  // We write it out directly; it only gets parsed back into game_roster_
+  // (for local queries) when it actually changes.
+  JsonWriter roster;
+  roster.BeginArray();
 
   int total_party_size = 1;  // include ourself here..
 
@@ -2059,14 +2476,11 @@ void Game::UpdateGameRoster() {
   if (auto* hs = dynamic_cast<HostSession*>(GetForegroundSession())) {
     // Add our host-y self.
     if (include_self) {
-      cJSON* client_dict = cJSON_CreateObject();
-      cJSON_AddItemToObject(
-          client_dict, "spec",
-          cJSON_CreateString(
-              PlayerSpec::GetAccountPlayerSpec().GetSpecString().c_str()));
+      roster.BeginObject().Key("spec").String(
+          PlayerSpec::GetAccountPlayerSpec().GetSpecString());
 
       // Add our list of local players.
-      cJSON* player_array = cJSON_CreateArray();
+      roster.Key("p").BeginArray();
       for (auto&& p : hs->players()) {
         InputDevice* input_device = p->GetInputDevice();
 
@@ -2074,32 +2488,23 @@ void Game::UpdateGameRoster() {
         // names though; don't wanna send <selecting character>, etc).
         if (p->accepted() && p->name_is_real() && input_device != nullptr
             && !input_device->IsRemoteClient()) {
-          cJSON* player_dict = cJSON_CreateObject();
-          cJSON_AddItemToObject(player_dict, "n",
-                                cJSON_CreateString(p->GetName().c_str()));
-          cJSON_AddItemToObject(player_dict, "nf",
-                                cJSON_CreateString(p->GetName(true).c_str()));
-          cJSON_AddItemToObject(player_dict, "i", cJSON_CreateNumber(p->id()));
-          cJSON_AddItemToArray(player_array, player_dict);
+          WriteRosterPlayer(&roster, p.get());
         }
       }
-      cJSON_AddItemToObject(client_dict, "p", player_array);
-      cJSON_AddItemToObject(
-          client_dict, "i",
-          cJSON_CreateNumber(-1));  // -1 client_id means we're the host.
-      cJSON_AddItemToArray(game_roster_, client_dict);
+      roster.EndArray();
+
+      // -1 client_id means we're the host.
+      roster.Key("i").Int(-1).EndObject();
     }
 
     // Add all connected clients.
     for (auto&& i : connections()->connections_to_clients()) {
       if (i.second->can_communicate()) {
-        cJSON* client_dict = cJSON_CreateObject();
-        cJSON_AddItemToObject(
-            client_dict, "spec",
-            cJSON_CreateString(i.second->peer_spec().GetSpecString().c_str()));
+        roster.BeginObject().Key("spec").String(
+            i.second->peer_spec().GetSpecString());
 
         // Add their list of players.
-        cJSON* player_array = cJSON_CreateArray();
+        roster.Key("p").BeginArray();
 
         // Include all players that are remote and coming from this same
         // client connection.
@@ -2112,32 +2517,39 @@ void Game::UpdateGameRoster() {
 
             // Add some basic info for each remote player.
             if (ctc != nullptr && ctc == i.second.get()) {
-              cJSON* player_dict = cJSON_CreateObject();
-              cJSON_AddItemToObject(player_dict, "n",
-                                    cJSON_CreateString(p->GetName().c_str()));
-              cJSON_AddItemToObject(
-                  player_dict, "nf",
-                  cJSON_CreateString(p->GetName(true).c_str()));
-              cJSON_AddItemToObject(player_dict, "i",
-                                    cJSON_CreateNumber(p->id()));
-              cJSON_AddItemToArray(player_array, player_dict);
+              WriteRosterPlayer(&roster, p.get());
             }
           }
         }
-        cJSON_AddItemToObject(client_dict, "p", player_array);
-        cJSON_AddItemToObject(client_dict, "i",
-                              cJSON_CreateNumber(i.second->id()));
-        cJSON_AddItemToArray(game_roster_, client_dict);
+        roster.EndArray();
+        roster.Key("i").Int(i.second->id()).EndObject();
         total_party_size += 1;
       }
     }
   }
+  roster.EndArray();
 
   // Keep the Python layer informed on our number of connections; it may want
   // to pass the info along to the master server if we're hosting a public
   // party.
   SetPublicPartySize(total_party_size);
 
+  // We get asked to update for all sorts of events that don't change
+  // anything visible here; no need to rebuild or resend in those cases.
+  if (roster.str() == game_roster_json_) {
+    return;
+  }
+  cJSON* parsed = cJSON_Parse(roster.str().c_str());
+  assert(parsed != nullptr);
+  if (parsed == nullptr) {
+    parsed = cJSON_CreateArray();
+  }
+  if (game_roster_ != nullptr) {
+    cJSON_Delete(game_roster_);
+  }
+  game_roster_ = parsed;
+  game_roster_json_ = roster.str();
+
   // Mark the roster as dirty so we know we need to send it to everyone soon.
   game_roster_dirty_ = true;
 }
@@ -9,6 +9,7 @@
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -249,6 +250,17 @@ class Game : public Module {
   }
   auto mark_game_roster_dirty() -> void { game_roster_dirty_ = true; }
 
+  /// Our current roster as flattened json.
+  auto GetGameRosterJson() -> std::string;
+
+  /// Called by scenes after each step when running in turbo mode.
+  auto AddTurboSceneStepStats(size_t node_count, int collision_count)
+      -> void {
+    turbo_scene_steps_++;
+    turbo_node_steps_ += node_count;
+    turbo_collisions_ += collision_count;
+  }
+
  private:
   auto HandleQuitOnIdle() -> void;
   auto InitSpecialChars() -> void;
@@ -267,6 +279,11 @@ class Game : public Module {
 
   auto Prune() -> void;  // Periodic pruning of dead stuff.
   auto Update() -> void;
+  auto UpdateTurbo(millisecs_t real_time) -> void;
+  auto UpdateCapture(millisecs_t real_time) -> void;
+  auto UpdateHeadlessIdle(millisecs_t real_time) -> bool;
+  auto StepSessions() -> void;
+  auto LogTurboStats() -> void;
   auto Process() -> void;
   auto UpdateKickVote() -> void;
   auto RunAppLaunchCommands() -> void;
@@ -341,6 +358,32 @@ class Game : public Module {
   std::string public_party_name_;
   std::string public_party_min_league_;
   std::string public_party_stats_url_;
+
+  // Turbo-mode stats (see LogTurboStats()).
+  millisecs_t turbo_start_real_time_{};
+  millisecs_t turbo_start_master_time_{};
+  uint64_t turbo_master_steps_{};
+  uint64_t turbo_scene_steps_{};
+  uint64_t turbo_node_steps_{};
+  uint64_t turbo_collisions_{};
+
+  // Flattened form of game_roster_ when we built it ourself (as host).
+  std::string game_roster_json_;
+
+  // Recently compiled Lstr values and their results, most recently used
+  // first; see CompileResourceString(). Cleared when the language changes.
+  std::list<std::pair<std::string, std::string>> lstr_cache_;
+  std::unordered_map<std::string_view,
+                     std::list<std::pair<std::string, std::string>>::iterator>
+      lstr_cache_index_;
+
+  // Frame-capture mode pacing (see UpdateCapture()).
+  millisecs_t capture_start_master_time_{};
+  int64_t capture_frame_count_{};
+
+  // Headless idle pausing (see UpdateHeadlessIdle()).
+  millisecs_t last_client_present_time_{-1};
+  bool headless_idle_{};
 };
 
 }  // namespace ballistica
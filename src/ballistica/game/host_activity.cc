@@ -15,6 +15,7 @@
 #include "ballistica/media/component/texture.h"
 #include "ballistica/python/python.h"
 #include "ballistica/python/python_context_call.h"
+#include "ballistica/python/python_media_handles.h"
 #include "ballistica/python/python_sys.h"
 #include "ballistica/scene/node/globals_node.h"
 #include "ballistica/scene/node/node_type.h"
@@ -44,6 +45,10 @@ HostActivity::HostActivity(HostSession* host_session) {
 HostActivity::~HostActivity() {
   shutting_down_ = true;
 
+  // Let go of media objects handed out to Python so they can die normally
+  // while our scene is still intact.
+  PythonMediaHandles::ClearActivity(this);
+
   // Put the scene in shut-down mode before we start killing stuff.
   // (this generates warnings, suppresses messages, etc)
   scene_->set_shutting_down(true);
@@ -214,6 +219,31 @@ auto HostActivity::GetCollideModel(const std::string& name)
   return Media::GetMedia(&collide_models_, name, scene());
 }
 
+template <class T>
+static auto GetMediaMapNames(
+    const std::unordered_map<std::string, Object::WeakRef<T> >& map,
+    std::vector<std::string>* names) -> void {
+  assert(names);
+  names->clear();
+  names->reserve(map.size());
+  for (auto&& i : map) {
+    names->push_back(i.first);
+  }
+}
+
+auto HostActivity::GetMediaNames(std::vector<std::string>* textures,
+                                 std::vector<std::string>* models,
+                                 std::vector<std::string>* collide_models,
+                                 std::vector<std::string>* sounds,
+                                 std::vector<std::string>* datas) const
+    -> void {
+  GetMediaMapNames(textures_, textures);
+  GetMediaMapNames(models_, models);
+  GetMediaMapNames(collide_models_, collide_models);
+  GetMediaMapNames(sounds_, sounds);
+  GetMediaMapNames(datas_, datas);
+}
+
 void HostActivity::SetPaused(bool val) {
   if (paused_ == val) {
     return;
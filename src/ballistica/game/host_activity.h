@@ -6,6 +6,7 @@
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "ballistica/core/context.h"
 #include "ballistica/generic/timer_list.h"
@@ -39,6 +40,14 @@ class HostActivity : public ContextTarget {
   auto GetModel(const std::string& name) -> Object::Ref<Model> override;
   auto GetCollideModel(const std::string& name)
       -> Object::Ref<CollideModel> override;
+
+  // Names of all media this activity has requested so far, so the same
+  // set can be prefetched the next time around.
+  auto GetMediaNames(std::vector<std::string>* textures,
+                     std::vector<std::string>* models,
+                     std::vector<std::string>* collide_models,
+                     std::vector<std::string>* sounds,
+                     std::vector<std::string>* datas) const -> void;
   auto Update(millisecs_t time_advance) -> millisecs_t;
   auto base_time() const -> millisecs_t { return base_time_; }
   auto scene() -> Scene* {
@@ -0,0 +1,187 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/game/load_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ballistica/game/connection/connection_set.h"
+#include "ballistica/game/connection/connection_to_client.h"
+#include "ballistica/game/game.h"
+#include "ballistica/generic/json_stream.h"
+#include "ballistica/generic/utils.h"
+#include "ballistica/platform/platform.h"
+#include "ballistica/python/python_context_call.h"
+
+namespace ballistica {
+
+// How often we sample per-client network traffic (connections only
+// tally it per second anyway).
+const millisecs_t kLoadTestClientSampleInterval = 1000;
+
+struct LoadTestState {
+  std::string path;
+  int steps_remaining{};
+  std::chrono::steady_clock::time_point start_time;
+  Object::Ref<PythonContextCall> done_call;
+  std::vector<float> step_milliseconds;
+  uint64_t scene_steps{};
+  uint64_t total_nodes{};
+  uint64_t total_collisions{};
+  size_t max_nodes{};
+  int max_collisions{};
+  millisecs_t last_client_sample_time{};
+  double total_client_bytes_per_second{};
+  int client_samples{};
+};
+static LoadTestState* g_load_test{};
+
+static void WriteLoadTestStats(LoadTestState* state) {
+  auto duration = std::chrono::steady_clock::now() - state->start_time;
+  double real_seconds = std::chrono::duration<double>(duration).count();
+  std::vector<float> sorted = state->step_milliseconds;
+  std::sort(sorted.begin(), sorted.end());
+  double total_ms{};
+  for (float ms : sorted) {
+    total_ms += ms;
+  }
+  auto steps = static_cast<double>(std::max(sorted.size(), size_t{1}));
+  auto scene_steps = static_cast<double>(
+      std::max(state->scene_steps, uint64_t{1}));
+
+  JsonWriter writer;
+  writer.BeginObject()
+      .Key("steps")
+      .Int(static_cast<int64_t>(sorted.size()))
+      .Key("real_seconds")
+      .Number(real_seconds);
+  writer.Key("step_ms")
+      .BeginObject()
+      .Key("mean")
+      .Number(total_ms / steps)
+      .Key("p50")
+      .Number(Utils::SortedPercentile(sorted, 0.5))
+      .Key("p90")
+      .Number(Utils::SortedPercentile(sorted, 0.9))
+      .Key("p99")
+      .Number(Utils::SortedPercentile(sorted, 0.99))
+      .Key("max")
+      .Number(sorted.empty() ? 0.0 : sorted.back())
+      .EndObject();
+  writer.Key("scene_steps")
+      .Int(static_cast<int64_t>(state->scene_steps))
+      .Key("nodes_per_scene_step")
+      .BeginObject()
+      .Key("mean")
+      .Number(static_cast<double>(state->total_nodes) / scene_steps)
+      .Key("max")
+      .Int(static_cast<int64_t>(state->max_nodes))
+      .EndObject();
+  writer.Key("collisions_per_scene_step")
+      .BeginObject()
+      .Key("mean")
+      .Number(static_cast<double>(state->total_collisions) / scene_steps)
+      .Key("max")
+      .Int(state->max_collisions)
+      .EndObject();
+
+  // Only meaningful when real clients are connected to the host.
+  writer.Key("client_bytes_out_per_second")
+      .BeginObject()
+      .Key("mean")
+      .Number(state->client_samples > 0 ? state->total_client_bytes_per_second
+                                              / state->client_samples
+                                        : 0.0)
+      .Key("samples")
+      .Int(state->client_samples)
+      .EndObject();
+  writer.EndObject();
+
+  FILE* f = g_platform->FOpen(state->path.c_str(), "wb");
+  if (!f) {
+    Log("Error: Unable to write load test stats to '" + state->path + "'.");
+    return;
+  }
+  fprintf(f, "%s\n", writer.str().c_str());
+  fclose(f);
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "Load test done: %d steps in %.1fs; step ms p50 %.2f p99 %.2f"
+           " max %.2f. Wrote stats to '",
+           static_cast<int>(sorted.size()), real_seconds,
+           Utils::SortedPercentile(sorted, 0.5),
+           Utils::SortedPercentile(sorted, 0.99),
+           sorted.empty() ? 0.0 : sorted.back());
+  Log(buffer + state->path + "'.");
+}
+
+void LoadTest::Start(const std::string& path, int step_count, uint32_t seed,
+                     const Object::Ref<PythonContextCall>& done_call) {
+  assert(InGameThread());
+  if (running()) {
+    throw Exception("A load test is already running.");
+  }
+  if (step_count <= 0) {
+    throw Exception("Step count must be positive.", PyExcType::kValue);
+  }
+  if (g_load_test == nullptr) {
+    g_load_test = new LoadTestState();
+  }
+  LoadTestState* state = g_load_test;
+  *state = LoadTestState();
+  state->path = path;
+  state->steps_remaining = step_count;
+  state->start_time = std::chrono::steady_clock::now();
+  state->done_call = done_call;
+  state->step_milliseconds.reserve(static_cast<size_t>(step_count));
+  state->last_client_sample_time = GetRealTime();
+  srand(seed);  // NOLINT
+}
+
+auto LoadTest::running() -> bool {
+  return g_load_test != nullptr && g_load_test->steps_remaining > 0;
+}
+
+void LoadTest::AddStep(double seconds) {
+  assert(InGameThread());
+  assert(running());
+  LoadTestState* state = g_load_test;
+  state->step_milliseconds.push_back(static_cast<float>(seconds * 1000.0));
+
+  millisecs_t real_time = GetRealTime();
+  if (real_time - state->last_client_sample_time
+      >= kLoadTestClientSampleInterval) {
+    state->last_client_sample_time = real_time;
+    for (auto* connection :
+         g_game->connections()->GetConnectionsToClients()) {
+      state->total_client_bytes_per_second +=
+          static_cast<double>(connection->GetBytesOutPerSecond());
+      state->client_samples++;
+    }
+  }
+
+  state->steps_remaining--;
+  if (state->steps_remaining == 0) {
+    WriteLoadTestStats(state);
+    state->step_milliseconds = std::vector<float>();
+    if (state->done_call.exists()) {
+      g_game->PushPythonCall(state->done_call);
+      state->done_call.Clear();
+    }
+  }
+}
+
+void LoadTest::AddSceneStep(size_t node_count, int collision_count) {
+  assert(running());
+  LoadTestState* state = g_load_test;
+  state->scene_steps++;
+  state->total_nodes += node_count;
+  state->total_collisions += static_cast<uint64_t>(collision_count);
+  state->max_nodes = std::max(state->max_nodes, node_count);
+  state->max_collisions = std::max(state->max_collisions, collision_count);
+}
+
+}  // namespace ballistica
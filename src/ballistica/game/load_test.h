@@ -0,0 +1,34 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_GAME_LOAD_TEST_H_
+#define BALLISTICA_GAME_LOAD_TEST_H_
+
+#include <string>
+
+#include "ballistica/core/object.h"
+
+namespace ballistica {
+
+/// Collects performance stats over a fixed number of game steps and
+/// writes them as JSON; the measuring half of ba.internal.run_load_test(),
+/// which sets up a session full of stress-test players to measure.
+class LoadTest {
+ public:
+  /// Start measuring. After step_count steps, stats are written to path
+  /// and done_call (if any) is pushed. The seed is applied to rand() so
+  /// test inputs behave the same from run to run.
+  static void Start(const std::string& path, int step_count, uint32_t seed,
+                    const Object::Ref<PythonContextCall>& done_call);
+
+  static auto running() -> bool;
+
+  /// Called by Game after each step of all sessions.
+  static void AddStep(double seconds);
+
+  /// Called by scenes after each step.
+  static void AddSceneStep(size_t node_count, int collision_count);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_GAME_LOAD_TEST_H_
@@ -0,0 +1,277 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/game/net_stats.h"
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+#include "ballistica/game/connection/connection_set.h"
+#include "ballistica/game/connection/connection_to_client.h"
+#include "ballistica/game/connection/connection_to_host.h"
+#include "ballistica/game/game.h"
+#include "ballistica/game/session/net_client_session.h"
+#include "ballistica/generic/json_stream.h"
+
+namespace ballistica {
+
+const millisecs_t kNetStatsSampleInterval = 1000;
+
+// Samples kept per connection (5 minutes' worth).
+const size_t kNetStatsHistorySize = 300;
+
+// Closed connections we hang on to.
+const size_t kNetStatsMaxClosedConnections = 16;
+
+struct NetStatsSample {
+  float ping_ms{};
+  int64_t bytes_out{};
+  int64_t bytes_in{};
+  int64_t messages_out{};
+  int64_t resends{};
+  int buffered_ms{-1};  // Only for our host connection.
+};
+
+struct NetStatsConnection {
+  Object::WeakRef<Connection> connection;
+  bool is_host{};
+  int client_id{-1};
+  std::string name;
+  millisecs_t open_time{};
+  millisecs_t close_time{};
+  bool closed{};
+  bool seen{};
+
+  // A ring of the last kNetStatsHistorySize samples.
+  std::vector<NetStatsSample> samples;
+  size_t sample_count{};
+
+  template <typename F>
+  void ForEachSample(F&& f) const {
+    // Once the ring is full, the oldest sample is the next to go.
+    size_t start = sample_count > samples.size() ? sample_count : 0;
+    for (size_t i = 0; i < samples.size(); i++) {
+      f(samples[(start + i) % samples.size()]);
+    }
+  }
+};
+
+struct NetStatsState {
+  millisecs_t last_sample_time{};
+  std::list<NetStatsConnection> connections;
+};
+static NetStatsState* g_net_stats{};
+
+static void AddNetStatsSample(NetStatsState* state, Connection* connection,
+                              bool is_host, int client_id,
+                              millisecs_t real_time) {
+  auto entry = std::find_if(state->connections.begin(),
+                            state->connections.end(),
+                            [connection](const NetStatsConnection& c) {
+                              return c.connection.get() == connection;
+                            });
+  if (entry == state->connections.end()) {
+    state->connections.emplace_back();
+    entry = std::prev(state->connections.end());
+    entry->connection = connection;
+    entry->is_host = is_host;
+    entry->client_id = client_id;
+    entry->open_time = real_time;
+  }
+  entry->seen = true;
+
+  // Peer info can arrive a bit after connecting.
+  entry->name = connection->peer_spec().GetDisplayString();
+
+  NetStatsSample sample;
+  sample.ping_ms = connection->average_ping();
+  sample.bytes_out = connection->GetBytesOutPerSecond();
+  sample.bytes_in = connection->GetBytesInPerSecond();
+  sample.messages_out = connection->GetMessagesOutPerSecond();
+  sample.resends = connection->GetMessageResendsPerSecond();
+  if (is_host) {
+    if (auto* session =
+            dynamic_cast<NetClientSession*>(g_game->GetForegroundSession())) {
+      if (session->connection_to_host() == connection) {
+        sample.buffered_ms = session->base_time_buffered();
+      }
+    }
+  }
+  if (entry->samples.size() < kNetStatsHistorySize) {
+    entry->samples.push_back(sample);
+  } else {
+    entry->samples[entry->sample_count % kNetStatsHistorySize] = sample;
+  }
+  entry->sample_count++;
+}
+
+void NetStats::Update(millisecs_t real_time) {
+  assert(InGameThread());
+  if (g_net_stats == nullptr) {
+    g_net_stats = new NetStatsState();
+  }
+  NetStatsState* state = g_net_stats;
+  if (real_time - state->last_sample_time < kNetStatsSampleInterval) {
+    return;
+  }
+  state->last_sample_time = real_time;
+
+  for (auto&& c : state->connections) {
+    c.seen = false;
+  }
+  ConnectionSet* connections = g_game->connections();
+  for (auto* client : connections->GetConnectionsToClients()) {
+    AddNetStatsSample(state, client, false, client->id(), real_time);
+  }
+  if (ConnectionToHost* host = connections->connection_to_host()) {
+    AddNetStatsSample(state, host, true, -1, real_time);
+  }
+
+  // Note newly closed connections and drop the oldest closed ones.
+  size_t closed_count{};
+  for (auto&& c : state->connections) {
+    if (!c.seen && !c.closed) {
+      c.closed = true;
+      c.close_time = real_time;
+    }
+    closed_count += c.closed;
+  }
+  for (auto i = state->connections.begin();
+       i != state->connections.end()
+       && closed_count > kNetStatsMaxClosedConnections;) {
+    if (i->closed) {
+      i = state->connections.erase(i);
+      closed_count--;
+    } else {
+      i++;
+    }
+  }
+}
+
+static void WriteNetStatsPercentiles(JsonWriter* writer,
+                                     std::vector<double>* values) {
+  if (values->empty()) {
+    writer->Null();
+    return;
+  }
+  std::sort(values->begin(), values->end());
+  auto percentile = [values](double fraction) {
+    return (*values)[static_cast<size_t>(fraction * (values->size() - 1))];
+  };
+  writer->BeginObject()
+      .Key("p50")
+      .Number(percentile(0.5))
+      .Key("p90")
+      .Number(percentile(0.9))
+      .Key("p99")
+      .Number(percentile(0.99))
+      .Key("max")
+      .Number(values->back())
+      .EndObject();
+}
+
+template <typename F>
+static void WriteNetStatsSamples(JsonWriter* writer,
+                                 const NetStatsConnection& connection,
+                                 F&& get_value) {
+  writer->BeginArray();
+  connection.ForEachSample([writer, &get_value](const NetStatsSample& s) {
+    writer->Number(get_value(s));
+  });
+  writer->EndArray();
+}
+
+static void WriteNetStatsConnection(JsonWriter* writer,
+                                    const NetStatsConnection& c,
+                                    bool include_samples) {
+  std::vector<double> pings, bytes_out, bytes_in, resends, buffered;
+  int64_t total_messages_out{};
+  int64_t total_resends{};
+  c.ForEachSample([&](const NetStatsSample& s) {
+    pings.push_back(s.ping_ms);
+    bytes_out.push_back(static_cast<double>(s.bytes_out));
+    bytes_in.push_back(static_cast<double>(s.bytes_in));
+    resends.push_back(static_cast<double>(s.resends));
+    if (s.buffered_ms >= 0) {
+      buffered.push_back(s.buffered_ms);
+    }
+    total_messages_out += s.messages_out;
+    total_resends += s.resends;
+  });
+  writer->BeginObject()
+      .Key("name")
+      .String(c.name)
+      .Key("kind")
+      .String(c.is_host ? "host" : "client")
+      .Key("client_id")
+      .Int(c.client_id)
+      .Key("connected")
+      .Bool(!c.closed)
+      .Key("age_seconds")
+      .Number(static_cast<double>(GetRealTime() - c.open_time) * 0.001);
+  if (c.closed) {
+    writer->Key("closed_seconds_ago")
+        .Number(static_cast<double>(GetRealTime() - c.close_time) * 0.001);
+  }
+
+  // Resends per message sent stands in for packet loss.
+  writer->Key("resend_ratio")
+      .Number(static_cast<double>(total_resends)
+              / static_cast<double>(std::max(total_messages_out, int64_t{1})))
+      .Key("ping_ms");
+  WriteNetStatsPercentiles(writer, &pings);
+  writer->Key("resends_per_second");
+  WriteNetStatsPercentiles(writer, &resends);
+  writer->Key("bytes_out_per_second");
+  WriteNetStatsPercentiles(writer, &bytes_out);
+  writer->Key("bytes_in_per_second");
+  WriteNetStatsPercentiles(writer, &bytes_in);
+  if (c.is_host) {
+    writer->Key("buffered_ms");
+    WriteNetStatsPercentiles(writer, &buffered);
+  }
+  if (include_samples) {
+    writer->Key("samples").BeginObject().Key("ping_ms");
+    WriteNetStatsSamples(writer, c,
+                         [](const NetStatsSample& s) { return s.ping_ms; });
+    writer->Key("bytes_out");
+    WriteNetStatsSamples(writer, c, [](const NetStatsSample& s) {
+      return static_cast<double>(s.bytes_out);
+    });
+    writer->Key("bytes_in");
+    WriteNetStatsSamples(writer, c, [](const NetStatsSample& s) {
+      return static_cast<double>(s.bytes_in);
+    });
+    writer->Key("resends");
+    WriteNetStatsSamples(writer, c, [](const NetStatsSample& s) {
+      return static_cast<double>(s.resends);
+    });
+    if (c.is_host) {
+      writer->Key("buffered_ms");
+      WriteNetStatsSamples(writer, c, [](const NetStatsSample& s) {
+        return static_cast<double>(s.buffered_ms);
+      });
+    }
+    writer->EndObject();
+  }
+  writer->EndObject();
+}
+
+auto NetStats::GetStatsJson(bool include_samples) -> std::string {
+  assert(InGameThread());
+  JsonWriter writer;
+  writer.BeginObject()
+      .Key("sample_interval_seconds")
+      .Number(static_cast<double>(kNetStatsSampleInterval) * 0.001)
+      .Key("connections")
+      .BeginArray();
+  if (g_net_stats) {
+    for (auto&& c : g_net_stats->connections) {
+      WriteNetStatsConnection(&writer, c, include_samples);
+    }
+  }
+  writer.EndArray().EndObject();
+  return writer.str();
+}
+
+}  // namespace ballistica
@@ -0,0 +1,28 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_GAME_NET_STATS_H_
+#define BALLISTICA_GAME_NET_STATS_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Keeps a few minutes of once-a-second samples of each connection's ping,
+/// traffic, resends and (for our host connection) buffering delay, so lag
+/// complaints can be looked into after the fact. Recently closed
+/// connections stick around for a while too. Game thread only.
+class NetStats {
+ public:
+  /// Called by Game each update; samples when a second has passed.
+  static void Update(millisecs_t real_time);
+
+  /// Percentiles for each connection as json; optionally including the
+  /// raw samples (oldest first).
+  static auto GetStatsJson(bool include_samples) -> std::string;
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_GAME_NET_STATS_H_
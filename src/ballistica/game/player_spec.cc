@@ -4,7 +4,7 @@
 
 #include "ballistica/app/app_globals.h"
 #include "ballistica/game/account.h"
-#include "ballistica/generic/json.h"
+#include "ballistica/generic/json_stream.h"
 #include "ballistica/generic/utils.h"
 #include "ballistica/platform/platform.h"
 
@@ -12,23 +12,68 @@ namespace ballistica {
 
 PlayerSpec::PlayerSpec() = default;
 
+// Pulls the top-level string members out of a spec string.
+class PlayerSpecJsonHandler : public JsonReader::Handler {
+ public:
+  auto OnBeginObject() -> bool override {
+    depth_++;
+    return true;
+  }
+  auto OnEndObject() -> bool override {
+    depth_--;
+    return true;
+  }
+  auto OnBeginArray() -> bool override {
+    depth_++;
+    return true;
+  }
+  auto OnEndArray() -> bool override {
+    depth_--;
+    return true;
+  }
+  auto OnKey(const std::string& key) -> bool override {
+    // (We only care about keys on the root object).
+    key_ = depth_ == 1 ? key : std::string();
+    return true;
+  }
+  auto OnString(const std::string& val) -> bool override {
+    if (key_ == "n") {
+      name = val;
+      have_name = true;
+    } else if (key_ == "sn") {
+      short_name = val;
+      have_short_name = true;
+    } else if (key_ == "a") {
+      account = val;
+      have_account = true;
+    }
+    return true;
+  }
+
+  std::string name;
+  std::string short_name;
+  std::string account;
+  bool have_name{};
+  bool have_short_name{};
+  bool have_account{};
+
+ private:
+  int depth_{};
+  std::string key_;
+};
+
 PlayerSpec::PlayerSpec(const std::string& s) {
-  cJSON* root_obj = cJSON_Parse(s.c_str());
+  PlayerSpecJsonHandler handler;
   bool success = false;
-  if (root_obj) {
-    cJSON* name_obj = cJSON_GetObjectItem(root_obj, "n");
-    cJSON* short_name_obj = cJSON_GetObjectItem(root_obj, "sn");
-    cJSON* account_obj = cJSON_GetObjectItem(root_obj, "a");
-    if (name_obj && short_name_obj && account_obj) {
-      name_ = Utils::GetValidUTF8(name_obj->valuestring, "psps");
-      short_name_ = Utils::GetValidUTF8(short_name_obj->valuestring, "psps2");
-
-      // Account type may technically be something we don't recognize,
-      // but that's ok.. it'll just be 'invalid' to us in that case
-      account_type_ = Account::AccountTypeFromString(account_obj->valuestring);
-      success = true;
-    }
-    cJSON_Delete(root_obj);
+  if (JsonReader::Parse(s.c_str(), &handler) && handler.have_name
+      && handler.have_short_name && handler.have_account) {
+    name_ = Utils::GetValidUTF8(handler.name.c_str(), "psps");
+    short_name_ = Utils::GetValidUTF8(handler.short_name.c_str(), "psps2");
+
+    // Account type may technically be something we don't recognize,
+    // but that's ok.. it'll just be 'invalid' to us in that case
+    account_type_ = Account::AccountTypeFromString(handler.account);
+    success = true;
   }
   if (!success) {
     Log("Error creating PlayerSpec from string: '" + s + "'");
@@ -56,16 +101,16 @@ auto PlayerSpec::operator==(const PlayerSpec& spec) const -> bool {
 }
 
 auto PlayerSpec::GetSpecString() const -> std::string {
-  cJSON* root;
-  root = cJSON_CreateObject();
-  cJSON_AddStringToObject(root, "n", name_.c_str());
-  cJSON_AddStringToObject(root, "a",
-                          Account::AccountTypeToString(account_type_).c_str());
-  cJSON_AddStringToObject(root, "sn", short_name_.c_str());
-  char* out = cJSON_PrintUnformatted(root);
-  std::string out_s = out;
-  free(out);
-  cJSON_Delete(root);
+  JsonWriter writer;
+  writer.BeginObject()
+      .Key("n")
+      .String(name_)
+      .Key("a")
+      .String(Account::AccountTypeToString(account_type_))
+      .Key("sn")
+      .String(short_name_)
+      .EndObject();
+  const std::string& out_s = writer.str();
 
   // We should never allow ourself to have all this add up to more than 256.
   assert(out_s.size() < 256);
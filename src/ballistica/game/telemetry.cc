@@ -0,0 +1,366 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/game/telemetry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "ballistica/core/memory_stats.h"
+#include "ballistica/core/thread.h"
+#include "ballistica/generic/json_stream.h"
+
+namespace ballistica {
+
+static const char* kTelemetryScenePhaseNames[] = {"nodes", "output_stream",
+                                                  "bg_dynamics", "dynamics"};
+static_assert(sizeof(kTelemetryScenePhaseNames)
+                      / sizeof(kTelemetryScenePhaseNames[0])
+                  == Telemetry::kScenePhaseCount,
+              "Scene phase name list is out of date.");
+
+struct TelemetryState {
+  // Totals since launch.
+  uint64_t game_steps{};
+  double game_step_seconds{};
+  double game_step_max_seconds{};
+  uint64_t scene_steps{};
+  double scene_phase_seconds[Telemetry::kScenePhaseCount]{};
+  uint64_t input_events{};
+  uint64_t input_raw_events{};
+  double input_latency_seconds{};
+  double input_latency_max_seconds{};
+  uint64_t lstr_cache_hits{};
+  uint64_t lstr_cache_misses{};
+
+  // Where things stood at our last log line.
+  millisecs_t log_interval{};
+  millisecs_t last_log_time{};
+  uint64_t last_log_game_steps{};
+  double last_log_game_step_seconds{};
+  double log_game_step_max_seconds{};
+  uint64_t last_log_scene_steps{};
+  double last_log_scene_phase_seconds[Telemetry::kScenePhaseCount]{};
+  std::vector<Thread::StatsSnapshot> last_log_threads;
+};
+static TelemetryState* g_telemetry{};
+
+static auto GetTelemetryState() -> TelemetryState* {
+  if (g_telemetry == nullptr) {
+    g_telemetry = new TelemetryState();
+  }
+  return g_telemetry;
+}
+
+static auto GetThreadLabel(ThreadIdentifier identifier) -> const char* {
+  switch (identifier) {
+    case ThreadIdentifier::kGame:
+      return "game";
+    case ThreadIdentifier::kMedia:
+      return "media";
+    case ThreadIdentifier::kFileOut:
+      return "file_out";
+    case ThreadIdentifier::kMain:
+      return "main";
+    case ThreadIdentifier::kAudio:
+      return "audio";
+    case ThreadIdentifier::kNetworkWrite:
+      return "network_write";
+    case ThreadIdentifier::kStdin:
+      return "stdin";
+    case ThreadIdentifier::kBGDynamics:
+      return "bg_dynamics";
+    default:
+      return "unknown";
+  }
+}
+
+static void LogTelemetryLine(TelemetryState* state, millisecs_t real_time) {
+  double seconds =
+      std::max(real_time - state->last_log_time, millisecs_t{1}) * 0.001;
+  uint64_t steps = state->game_steps - state->last_log_game_steps;
+  double step_seconds =
+      state->game_step_seconds - state->last_log_game_step_seconds;
+  uint64_t scene_steps = state->scene_steps - state->last_log_scene_steps;
+  auto scene_step_divisor =
+      static_cast<double>(std::max(scene_steps, uint64_t{1}));
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "Telemetry: game step ms avg %.2f max %.2f (%.0f/s);"
+           " scene step ms",
+           steps > 0 ? step_seconds * 1000.0 / steps : 0.0,
+           state->log_game_step_max_seconds * 1000.0, steps / seconds);
+  std::string line = buffer;
+  for (int i = 0; i < Telemetry::kScenePhaseCount; i++) {
+    snprintf(buffer, sizeof(buffer), " %s %.2f", kTelemetryScenePhaseNames[i],
+             (state->scene_phase_seconds[i]
+              - state->last_log_scene_phase_seconds[i])
+                 * 1000.0 / scene_step_divisor);
+    line += buffer;
+    state->last_log_scene_phase_seconds[i] = state->scene_phase_seconds[i];
+  }
+
+  // Busy percentages, runnables per second, and queued messages per thread.
+  line += "; threads";
+  std::vector<Thread::StatsSnapshot> threads = Thread::GetAllStats();
+  for (const auto& thread : threads) {
+    Thread::StatsSnapshot last;
+    for (const auto& last_thread : state->last_log_threads) {
+      if (last_thread.identifier == thread.identifier) {
+        last = last_thread;
+        break;
+      }
+    }
+    snprintf(buffer, sizeof(buffer), " %s %.0f%% %.0f/s q%d",
+             GetThreadLabel(thread.identifier),
+             (thread.busy_seconds - last.busy_seconds) * 100.0 / seconds,
+             (thread.runnables - last.runnables) / seconds,
+             thread.queue_depth);
+    line += buffer;
+  }
+  Log(line);
+
+  state->last_log_time = real_time;
+  state->last_log_game_steps = state->game_steps;
+  state->last_log_game_step_seconds = state->game_step_seconds;
+  state->log_game_step_max_seconds = 0.0;
+  state->last_log_scene_steps = state->scene_steps;
+  state->last_log_threads = std::move(threads);
+}
+
+void Telemetry::AddGameStep(double seconds) {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  state->game_steps++;
+  state->game_step_seconds += seconds;
+  state->game_step_max_seconds =
+      std::max(state->game_step_max_seconds, seconds);
+  state->log_game_step_max_seconds =
+      std::max(state->log_game_step_max_seconds, seconds);
+  if (state->log_interval > 0) {
+    millisecs_t real_time = GetRealTime();
+    if (real_time - state->last_log_time >= state->log_interval) {
+      LogTelemetryLine(state, real_time);
+    }
+  }
+}
+
+void Telemetry::AddScenePhase(ScenePhase phase, double seconds) {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  if (phase == ScenePhase::kNodes) {
+    state->scene_steps++;
+  }
+  state->scene_phase_seconds[static_cast<int>(phase)] += seconds;
+}
+
+void Telemetry::AddInputEvent(double latency_seconds, int event_count) {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  state->input_events++;
+  state->input_raw_events += static_cast<uint64_t>(event_count);
+  state->input_latency_seconds += latency_seconds;
+  state->input_latency_max_seconds =
+      std::max(state->input_latency_max_seconds, latency_seconds);
+}
+
+void Telemetry::AddLstrCacheLookup(bool hit) {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  if (hit) {
+    state->lstr_cache_hits++;
+  } else {
+    state->lstr_cache_misses++;
+  }
+}
+
+void Telemetry::SetLogInterval(double seconds) {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  state->log_interval =
+      static_cast<millisecs_t>(std::max(seconds, 0.0) * 1000.0);
+
+  // Our first line covers the time from now.
+  state->last_log_time = GetRealTime();
+  state->last_log_game_steps = state->game_steps;
+  state->last_log_game_step_seconds = state->game_step_seconds;
+  state->log_game_step_max_seconds = 0.0;
+  state->last_log_scene_steps = state->scene_steps;
+  std::copy(std::begin(state->scene_phase_seconds),
+            std::end(state->scene_phase_seconds),
+            state->last_log_scene_phase_seconds);
+  state->last_log_threads = Thread::GetAllStats();
+}
+
+static void AddMetricHeader(std::string* out, const char* name,
+                            const char* type, const char* help) {
+  *out += std::string("# HELP ") + name + " " + help + "\n# TYPE " + name + " "
+          + type + "\n";
+}
+
+static void AddMetric(std::string* out, const char* name, const char* labels,
+                      double value) {
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer), "%s%s %.6f\n", name, labels, value);
+  *out += buffer;
+}
+
+auto Telemetry::GetPrometheusText() -> std::string {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  std::vector<Thread::StatsSnapshot> threads = Thread::GetAllStats();
+  std::string out;
+  char labels[64];
+
+  struct ThreadMetric {
+    const char* name;
+    const char* type;
+    const char* help;
+    double (*get)(const Thread::StatsSnapshot&);
+  };
+  const ThreadMetric thread_metrics[] = {
+      {"ballistica_thread_loops_total", "counter", "Event loop cycles run.",
+       [](const Thread::StatsSnapshot& s) {
+         return static_cast<double>(s.loops);
+       }},
+      {"ballistica_thread_runnables_total", "counter",
+       "Runnables received from other threads.",
+       [](const Thread::StatsSnapshot& s) {
+         return static_cast<double>(s.runnables);
+       }},
+      {"ballistica_thread_busy_seconds_total", "counter",
+       "Time spent running events.",
+       [](const Thread::StatsSnapshot& s) { return s.busy_seconds; }},
+      {"ballistica_thread_blocked_seconds_total", "counter",
+       "Time spent waiting for events.",
+       [](const Thread::StatsSnapshot& s) { return s.blocked_seconds; }},
+      {"ballistica_thread_queue_depth", "gauge",
+       "Messages waiting in the thread's queue.",
+       [](const Thread::StatsSnapshot& s) {
+         return static_cast<double>(s.queue_depth);
+       }},
+      {"ballistica_thread_queue_depth_max", "gauge",
+       "Most messages ever taken from the queue at once.",
+       [](const Thread::StatsSnapshot& s) {
+         return static_cast<double>(s.max_queue_depth);
+       }}};
+  for (const auto& metric : thread_metrics) {
+    AddMetricHeader(&out, metric.name, metric.type, metric.help);
+    for (const auto& thread : threads) {
+      snprintf(labels, sizeof(labels), "{thread=\"%s\"}",
+               GetThreadLabel(thread.identifier));
+      AddMetric(&out, metric.name, labels, metric.get(thread));
+    }
+  }
+
+  AddMetricHeader(&out, "ballistica_game_steps_total", "counter",
+                  "Game steps run.");
+  AddMetric(&out, "ballistica_game_steps_total", "",
+            static_cast<double>(state->game_steps));
+  AddMetricHeader(&out, "ballistica_game_step_seconds_total", "counter",
+                  "Time spent in game steps.");
+  AddMetric(&out, "ballistica_game_step_seconds_total", "",
+            state->game_step_seconds);
+  AddMetricHeader(&out, "ballistica_game_step_seconds_max", "gauge",
+                  "Longest game step.");
+  AddMetric(&out, "ballistica_game_step_seconds_max", "",
+            state->game_step_max_seconds);
+  AddMetricHeader(&out, "ballistica_scene_steps_total", "counter",
+                  "Scene steps run.");
+  AddMetric(&out, "ballistica_scene_steps_total", "",
+            static_cast<double>(state->scene_steps));
+  AddMetricHeader(&out, "ballistica_scene_step_phase_seconds_total", "counter",
+                  "Time spent in each phase of scene steps.");
+  for (int i = 0; i < kScenePhaseCount; i++) {
+    snprintf(labels, sizeof(labels), "{phase=\"%s\"}",
+             kTelemetryScenePhaseNames[i]);
+    AddMetric(&out, "ballistica_scene_step_phase_seconds_total", labels,
+              state->scene_phase_seconds[i]);
+  }
+  AddMetricHeader(&out, "ballistica_input_events_total", "counter",
+                  "Input events handled.");
+  AddMetric(&out, "ballistica_input_events_total", "",
+            static_cast<double>(state->input_events));
+  AddMetricHeader(&out, "ballistica_input_raw_events_total", "counter",
+                  "Input events received, counting ones folded together.");
+  AddMetric(&out, "ballistica_input_raw_events_total", "",
+            static_cast<double>(state->input_raw_events));
+  AddMetricHeader(&out, "ballistica_input_latency_seconds_total", "counter",
+                  "Time input events waited to be handled.");
+  AddMetric(&out, "ballistica_input_latency_seconds_total", "",
+            state->input_latency_seconds);
+  AddMetricHeader(&out, "ballistica_input_latency_seconds_max", "gauge",
+                  "Longest wait for an input event to be handled.");
+  AddMetric(&out, "ballistica_input_latency_seconds_max", "",
+            state->input_latency_max_seconds);
+  AddMetricHeader(&out, "ballistica_lstr_cache_hits_total", "counter",
+                  "Lstr compiles served from the cache.");
+  AddMetric(&out, "ballistica_lstr_cache_hits_total", "",
+            static_cast<double>(state->lstr_cache_hits));
+  AddMetricHeader(&out, "ballistica_lstr_cache_misses_total", "counter",
+                  "Lstr compiles that had to parse their json.");
+  AddMetric(&out, "ballistica_lstr_cache_misses_total", "",
+            static_cast<double>(state->lstr_cache_misses));
+  AddMetricHeader(&out, "ballistica_memory_bytes", "gauge",
+                  "Estimated bytes held by each subsystem.");
+  for (int i = 0; i < MemoryStats::kTagCount; i++) {
+    auto tag = static_cast<MemoryStats::Tag>(i);
+    snprintf(labels, sizeof(labels), "{tag=\"%s\"}",
+             MemoryStats::GetTagName(tag));
+    AddMetric(&out, "ballistica_memory_bytes", labels,
+              static_cast<double>(MemoryStats::GetBytes(tag)));
+  }
+  AddMetricHeader(&out, "ballistica_memory_bytes_max", "gauge",
+                  "Most bytes each subsystem has held.");
+  for (int i = 0; i < MemoryStats::kTagCount; i++) {
+    auto tag = static_cast<MemoryStats::Tag>(i);
+    snprintf(labels, sizeof(labels), "{tag=\"%s\"}",
+             MemoryStats::GetTagName(tag));
+    AddMetric(&out, "ballistica_memory_bytes_max", labels,
+              static_cast<double>(MemoryStats::GetMaxBytes(tag)));
+  }
+  return out;
+}
+
+void Telemetry::WriteStatsJson(JsonWriter* writer) {
+  assert(InGameThread());
+  TelemetryState* state = GetTelemetryState();
+  auto steps = static_cast<double>(std::max(state->game_steps, uint64_t{1}));
+  writer->BeginObject()
+      .Key("game_steps")
+      .Int(static_cast<int64_t>(state->game_steps))
+      .Key("game_step_ms_avg")
+      .Number(state->game_step_seconds * 1000.0 / steps)
+      .Key("game_step_ms_max")
+      .Number(state->game_step_max_seconds * 1000.0)
+      .Key("input_events")
+      .Int(static_cast<int64_t>(state->input_events))
+      .Key("input_raw_events")
+      .Int(static_cast<int64_t>(state->input_raw_events))
+      .Key("input_latency_ms_avg")
+      .Number(state->input_latency_seconds * 1000.0
+              / static_cast<double>(std::max(state->input_events, uint64_t{1})))
+      .Key("input_latency_ms_max")
+      .Number(state->input_latency_max_seconds * 1000.0)
+      .Key("lstr_cache_hit_rate")
+      .Number(static_cast<double>(state->lstr_cache_hits)
+              / static_cast<double>(std::max(
+                  state->lstr_cache_hits + state->lstr_cache_misses,
+                  uint64_t{1})))
+      .Key("threads")
+      .BeginObject();
+  for (const auto& thread : Thread::GetAllStats()) {
+    writer->Key(GetThreadLabel(thread.identifier))
+        .BeginObject()
+        .Key("busy_seconds")
+        .Number(thread.busy_seconds)
+        .Key("blocked_seconds")
+        .Number(thread.blocked_seconds)
+        .Key("queue_depth")
+        .Int(thread.queue_depth)
+        .EndObject();
+  }
+  writer->EndObject().EndObject();
+}
+
+}  // namespace ballistica
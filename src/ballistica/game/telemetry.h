@@ -0,0 +1,50 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_GAME_TELEMETRY_H_
+#define BALLISTICA_GAME_TELEMETRY_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Always-on load counters for watching live servers: per-thread event
+/// loop stats (from Thread), game step and Scene::Step() phase times, and
+/// input event latency, and Lstr compile cache hits (plus MemoryStats in
+/// the Prometheus text). Available as Prometheus-style text or as a
+/// periodic log line.
+/// Game thread only.
+class Telemetry {
+ public:
+  /// The parts of Scene::Step() we time.
+  enum class ScenePhase { kNodes, kOutputStream, kBGDynamics, kDynamics };
+  static const int kScenePhaseCount = 4;
+
+  /// Called by Game after each step of all sessions.
+  static void AddGameStep(double seconds);
+
+  /// Called by scenes for each phase of each step.
+  static void AddScenePhase(ScenePhase phase, double seconds);
+
+  /// Called by Input as it handles each event; event_count is how many raw
+  /// events were folded into it and latency is the wait since the first.
+  static void AddInputEvent(double latency_seconds, int event_count);
+
+  /// Called by Game::CompileResourceString() for each value it looks up
+  /// in its cache.
+  static void AddLstrCacheLookup(bool hit);
+
+  /// Log a line of stats every so many real seconds (0 to stop).
+  static void SetLogInterval(double seconds);
+
+  /// All counters in Prometheus text exposition format.
+  static auto GetPrometheusText() -> std::string;
+
+  /// Headline counters as a json object value.
+  static void WriteStatsJson(JsonWriter* writer);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_GAME_TELEMETRY_H_
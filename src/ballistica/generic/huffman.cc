@@ -2,6 +2,8 @@
 
 #include "ballistica/generic/huffman.h"
 
+#include <limits>
+
 #include "ballistica/networking/networking.h"
 
 namespace ballistica {
@@ -46,17 +48,202 @@ static void DoWriteBits(char** ptr, int* bit, int val, int val_bits) {
   }
 }
 
+// Total that trained tables get normalized to (in the same ballpark as our
+// hard-coded table so tree-building sums comfortably fit in an int).
+const uint64_t kTrainedFrequencyTotal = 200000;
+
 Huffman::Huffman() : built(false) {
-  static_assert(sizeof(g_freqs) == sizeof(int) * 256);
+  static_assert(sizeof(g_freqs) == sizeof(int) * kFrequencyCount);
   build();
 }
 
+Huffman::Huffman(const std::vector<int>& frequencies) : built(false) {
+  // Tables may come from peers, so make sure they can't overflow our
+  // tree-building sums.
+  BA_PRECONDITION(frequencies.size() == kFrequencyCount);
+  int64_t total{};
+  for (int i = 0; i < kFrequencyCount; i++) {
+    BA_PRECONDITION(frequencies[i] >= 0);
+    total += frequencies[i];
+    nodes_[i].frequency = frequencies[i];
+  }
+  BA_PRECONDITION(total <= std::numeric_limits<int>::max());
+  BuildTree();
+}
+
 Huffman::~Huffman() = default;
 
 auto Huffman::compress(const std::vector<uint8_t>& src)
     -> std::vector<uint8_t> {
 #if BA_HUFFMAN_NET_COMPRESSION
 
+  // Same output as CompressReference(), but we gather codes into a 64 bit
+  // accumulator and write them out 32 bits at a time instead of
+  // twiddling individual bits.
+  auto length = static_cast<uint32_t>(src.size());
+  const uint8_t* data = src.data();
+
+  // See CompressReference() about our use of the topmost bit.
+  BA_PRECONDITION(data[0] >> 7 == 0);
+
+  uint32_t bit_count = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    bit_count += nodes_[data[i]].bits;
+  }
+
+  // Round up to next byte and add our one-byte header.
+  uint32_t length_out = bit_count / 8 + 1;
+  if (bit_count % 8) {
+    length_out++;
+  }
+
+  // If compressed is bigger than uncompressed, go with uncompressed.
+  if (length_out >= length) {
+    return src;
+  }
+  std::vector<uint8_t> out(length_out);
+  uint8_t* ptr = out.data();
+
+  // First byte gives our number of empty trailing bits.
+  *ptr = static_cast<uint8_t>((8 - bit_count % 8) % 8);
+  ptr++;
+
+  // Codes are at most 9 bits, so the accumulator never holds more than
+  // 40 bits between flushes.
+  uint64_t accum = 0;
+  int accum_bits = 0;
+  for (uint32_t i = 0; i < length; i++) {
+    const Node& node = nodes_[data[i]];
+    accum |= static_cast<uint64_t>(node.val) << accum_bits;
+    accum_bits += node.bits;
+    if (accum_bits >= 32) {
+      ptr[0] = static_cast<uint8_t>(accum);
+      ptr[1] = static_cast<uint8_t>(accum >> 8);
+      ptr[2] = static_cast<uint8_t>(accum >> 16);
+      ptr[3] = static_cast<uint8_t>(accum >> 24);
+      ptr += 4;
+      accum >>= 32;
+      accum_bits -= 32;
+    }
+  }
+  while (accum_bits > 0) {
+    *ptr = static_cast<uint8_t>(accum);
+    ptr++;
+    accum >>= 8;
+    accum_bits -= 8;
+  }
+  assert(ptr - out.data() == length_out);
+
+  // Mark it as compressed.
+  out[0] |= (0x01 << 7);
+  return out;
+#else
+  return src;
+#endif
+}
+
+auto Huffman::decompress(const std::vector<uint8_t>& src)
+    -> std::vector<uint8_t> {
+#if BA_HUFFMAN_NET_COMPRESSION
+
+  // Accepts the same data as DecompressReference(), but decodes a whole
+  // symbol per step using decode_table_ and a 64 bit bit-buffer.
+  auto length = static_cast<uint32_t>(src.size());
+  BA_PRECONDITION(length > 0);
+
+  const uint8_t* data = src.data();
+  auto remainder = static_cast<uint8_t>(data[0] & 0x0F);
+  bool compressed = data[0] >> 7;
+  if (!compressed) {
+    return src;
+  }
+
+  std::vector<uint8_t> out;
+  out.reserve(src.size() * 2);
+
+  uint32_t bit_length = ((length - 1) * 8);
+  if (remainder > bit_length) {
+    throw Exception("invalid huffman data");
+  }
+  bit_length -= remainder;
+
+  const uint8_t* ptr = data + 1;
+  const uint8_t* ptr_end = data + length;
+  uint64_t accum = 0;
+  int accum_bits = 0;
+  uint32_t bit = 0;
+
+  while (bit < bit_length) {
+    // Keep at least one full code's worth of bits available (past the end
+    // of the data we just see zeros, which the length checks below catch).
+    while (accum_bits <= 56 && ptr < ptr_end) {
+      accum |= static_cast<uint64_t>(*ptr) << accum_bits;
+      ptr++;
+      accum_bits += 8;
+    }
+
+    // 1 in first bit denotes huffman compressed.
+    if (accum & 0x01) {
+      uint16_t entry = decode_table_[(accum >> 1) & 0x7F];
+      if (entry != 0) {
+        int code_bits = entry >> 8;
+        bit += code_bits;
+        if (bit > bit_length) {
+          throw Exception("huffman decompress got bit > bitlength");
+        }
+        out.push_back(static_cast<uint8_t>(entry & 0xFF));
+        accum >>= code_bits;
+        accum_bits -= code_bits;
+        continue;
+      }
+
+      // Codes deeper than our table covers are never produced by our
+      // compressor, but the reference decoder accepts them so we walk the
+      // tree for those to stay compatible.
+      bit++;
+      accum >>= 1;
+      accum_bits--;
+      int n = 510;
+      while (nodes_[n].left_child != -1) {
+        if (bit >= bit_length) {
+          throw Exception("huffman decompress got bit > bitlength");
+        }
+        if (accum_bits == 0) {
+          BA_PRECONDITION(ptr < ptr_end);
+          accum = *ptr;
+          ptr++;
+          accum_bits = 8;
+        }
+
+        // 1 for right, 0 for left.
+        n = (accum & 0x01) ? nodes_[n].right_child : nodes_[n].left_child;
+        accum >>= 1;
+        accum_bits--;
+        bit++;
+      }
+      out.push_back(static_cast<uint8_t>(n));
+    } else {
+      // Just read next 8 bits as value.
+      bit += 9;
+      if (bit > bit_length) {
+        throw Exception("huffman decompress got bit > bitlength b");
+      }
+      out.push_back(static_cast<uint8_t>(accum >> 1));
+      accum >>= 9;
+      accum_bits -= 9;
+    }
+  }
+  BA_PRECONDITION(bit == bit_length);
+  return out;
+#else
+  return src;
+#endif
+}
+
+auto Huffman::CompressReference(const std::vector<uint8_t>& src)
+    -> std::vector<uint8_t> {
+#if BA_HUFFMAN_NET_COMPRESSION
+
   auto length = static_cast<uint32_t>(src.size());
   const char* data = (const char*)src.data();
 
@@ -127,7 +314,7 @@ auto Huffman::compress(const std::vector<uint8_t>& src)
 
 // hmmm - I saw a crash logged in this function; need to make sure this is
 // bulletproof since untrusted data is coming through here..
-auto Huffman::decompress(const std::vector<uint8_t>& src)
+auto Huffman::DecompressReference(const std::vector<uint8_t>& src)
     -> std::vector<uint8_t> {
 #if BA_HUFFMAN_NET_COMPRESSION
 
@@ -475,6 +662,19 @@ void Huffman::train(const char* buffer, int len) {
 }
 #endif  // HUFFMAN_TRAINING_MODE
 
+auto Huffman::GetFrequencies() const -> std::vector<int> {
+  std::vector<int> frequencies(kFrequencyCount);
+  for (int i = 0; i < kFrequencyCount; i++) {
+    frequencies[i] = nodes_[i].frequency;
+  }
+  return frequencies;
+}
+
+auto Huffman::GetStaticTableID() -> uint32_t {
+  static uint32_t static_id = Huffman().table_id();
+  return static_id;
+}
+
 void Huffman::build() {
   assert(!built);
 
@@ -483,6 +683,7 @@ void Huffman::build() {
   for (int i = 0; i < 256; i++) {
     nodes_[i].frequency = g_freqs[i];
   }
+  BuildTree();
 #else
   // go through and set all but the top 15 or so to zero
   // this is because all smaller values will be provided in full binary
@@ -499,7 +700,12 @@ void Huffman::build() {
       }
     }
   }
+  BuildTree();
 #endif
+}
+
+auto Huffman::BuildTree() -> void {
+  assert(!built);
 
   // first 256 nodes are leaves
   int node_count = 256;
@@ -579,9 +785,64 @@ void Huffman::build() {
     nodes_[i].bits += 1;
   }
 
+  // Build our decode lookup table; for each possible set of 7 bits
+  // following a 'compressed' flag bit, store the symbol they lead to and
+  // the total code length including the flag (or 0 if they don't reach a
+  // leaf within 7 bits).
+  for (int pattern = 0; pattern < 128; pattern++) {
+    decode_table_[pattern] = 0;
+    int n = 510;
+    for (int depth = 0; depth < 7; depth++) {
+      n = ((pattern >> depth) & 0x01) ? nodes_[n].right_child
+                                       : nodes_[n].left_child;
+      if (nodes_[n].left_child == -1) {
+        assert(n < 256);
+        decode_table_[pattern] = static_cast<uint16_t>(n | ((depth + 2) << 8));
+        break;
+      }
+    }
+  }
+
+  // Checksum our leaf frequencies (FNV-1a) so peers can verify they agree.
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < kFrequencyCount; i++) {
+    auto freq = static_cast<uint32_t>(nodes_[i].frequency);
+    for (int j = 0; j < 4; j++) {
+      hash ^= (freq >> (j * 8)) & 0xFFu;
+      hash *= 16777619u;
+    }
+  }
+  table_id_ = hash;
+
   built = true;
 }
 
+auto HuffmanTrainer::AddData(const std::vector<uint8_t>& data) -> void {
+  for (auto&& val : data) {
+    counts_[val]++;
+  }
+  total_bytes_ += data.size();
+}
+
+auto HuffmanTrainer::GetFrequencies() const -> std::vector<int> {
+  std::vector<int> frequencies(Huffman::kFrequencyCount);
+  if (total_bytes_ == 0) {
+    return frequencies;
+  }
+  for (int i = 0; i < Huffman::kFrequencyCount; i++) {
+    // Round up so any byte we've actually seen keeps a nonzero weight.
+    frequencies[i] = static_cast<int>(
+        (counts_[i] * kTrainedFrequencyTotal + total_bytes_ - 1)
+        / total_bytes_);
+  }
+  return frequencies;
+}
+
+auto HuffmanTrainer::Reset() -> void {
+  counts_.fill(0);
+  total_bytes_ = 0;
+}
+
 #pragma clang diagnostic pop
 
 }  // namespace ballistica
@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_GENERIC_HUFFMAN_H_
 #define BALLISTICA_GENERIC_HUFFMAN_H_
 
+#include <array>
 #include <vector>
 
 #include "ballistica/core/object.h"
@@ -11,7 +12,16 @@ namespace ballistica {
 
 class Huffman {
  public:
+  // Number of entries in a frequency table (one per byte value).
+  static const int kFrequencyCount = 256;
+
+  // Creates a compressor using our hard-coded frequency table.
   Huffman();
+
+  // Creates a compressor using a custom frequency table; used for tables
+  // trained at runtime (see HuffmanTrainer) and advertised to peers.
+  // The table must have kFrequencyCount entries.
+  explicit Huffman(const std::vector<int>& frequencies);
   ~Huffman();
 
 #if HUFFMAN_TRAINING_MODE
@@ -24,8 +34,29 @@ class Huffman {
   // (see details in implementation).
   auto compress(const std::vector<uint8_t>& src) -> std::vector<uint8_t>;
   auto decompress(const std::vector<uint8_t>& src) -> std::vector<uint8_t>;
+
+  // Original bit-at-a-time implementations of the above; these produce and
+  // accept identical data and are kept around for verification and
+  // benchmarking.
+  auto CompressReference(const std::vector<uint8_t>& src)
+      -> std::vector<uint8_t>;
+  auto DecompressReference(const std::vector<uint8_t>& src)
+      -> std::vector<uint8_t>;
   auto get_built() const -> bool { return built; }
 
+  // Returns the frequency table this instance was built from (suitable for
+  // sending to a peer so it can build a matching instance).
+  auto GetFrequencies() const -> std::vector<int>;
+
+  // A checksum of the frequency table; two instances with the same id will
+  // produce and accept identical data. Peers can compare these to verify
+  // they agree on a table before using it.
+  auto table_id() const -> uint32_t { return table_id_; }
+
+  // The id of the hard-coded table; a peer that does not advertise a
+  // custom table is assumed to be using this.
+  static auto GetStaticTableID() -> uint32_t;
+
  private:
   bool built;
 #if HUFFMAN_TRAINING_MODE
@@ -53,7 +84,33 @@ class Huffman {
     int frequency = 0;
   };
 
+  auto BuildTree() -> void;
+
   Node nodes_[511];
+  uint32_t table_id_{};
+
+  // Symbol/code-length lookup for codes of up to 7 bits (after the flag
+  // bit); see BuildTree().
+  uint16_t decode_table_[128]{};
+};
+
+// Gathers byte frequencies from real traffic so a host can build a table
+// that better matches its own data than the hard-coded one.
+class HuffmanTrainer {
+ public:
+  auto AddData(const std::vector<uint8_t>& data) -> void;
+  auto total_bytes() const -> uint64_t { return total_bytes_; }
+
+  // Returns a frequency table suitable for passing to Huffman's
+  // constructor, normalized so that it sums to roughly the same total as
+  // our hard-coded table regardless of how much data has been added.
+  auto GetFrequencies() const -> std::vector<int>;
+
+  auto Reset() -> void;
+
+ private:
+  std::array<uint64_t, Huffman::kFrequencyCount> counts_{};
+  uint64_t total_bytes_{};
 };
 
 }  // namespace ballistica
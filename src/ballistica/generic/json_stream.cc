@@ -0,0 +1,416 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/generic/json_stream.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ballistica {
+
+// Deeper documents than this get rejected rather than risking our stack.
+const int kJsonReaderMaxDepth = 64;
+
+void JsonWriter::BeginValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (!has_entry_.empty()) {
+    if (has_entry_.back()) {
+      out_ += ',';
+    }
+    has_entry_.back() = true;
+  }
+}
+
+auto JsonWriter::BeginObject() -> JsonWriter& {
+  BeginValue();
+  out_ += '{';
+  has_entry_.push_back(false);
+  return *this;
+}
+
+auto JsonWriter::EndObject() -> JsonWriter& {
+  assert(!has_entry_.empty() && !after_key_);
+  has_entry_.pop_back();
+  out_ += '}';
+  return *this;
+}
+
+auto JsonWriter::BeginArray() -> JsonWriter& {
+  BeginValue();
+  out_ += '[';
+  has_entry_.push_back(false);
+  return *this;
+}
+
+auto JsonWriter::EndArray() -> JsonWriter& {
+  assert(!has_entry_.empty() && !after_key_);
+  has_entry_.pop_back();
+  out_ += ']';
+  return *this;
+}
+
+auto JsonWriter::Key(const char* key) -> JsonWriter& {
+  assert(!has_entry_.empty() && !after_key_);
+  BeginValue();
+  AppendString(&out_, key);
+  out_ += ':';
+  after_key_ = true;
+  return *this;
+}
+
+auto JsonWriter::String(const char* val) -> JsonWriter& {
+  BeginValue();
+  AppendString(&out_, val);
+  return *this;
+}
+
+auto JsonWriter::Int(int64_t val) -> JsonWriter& {
+  BeginValue();
+  out_ += std::to_string(val);
+  return *this;
+}
+
+auto JsonWriter::Number(double val) -> JsonWriter& {
+  BeginValue();
+
+  // Same formatting choices as cJSON.
+  char buffer[64];
+  if (std::fabs(std::floor(val) - val) <= DBL_EPSILON && val <= INT_MAX
+      && val >= INT_MIN) {
+    snprintf(buffer, sizeof(buffer), "%d", static_cast<int>(val));
+  } else if (std::fabs(std::floor(val) - val) <= DBL_EPSILON
+             && std::fabs(val) < 1.0e60) {
+    snprintf(buffer, sizeof(buffer), "%.0f", val);
+  } else if (std::fabs(val) < 1.0e-6 || std::fabs(val) > 1.0e9) {
+    snprintf(buffer, sizeof(buffer), "%e", val);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%f", val);
+  }
+  out_ += buffer;
+  return *this;
+}
+
+auto JsonWriter::Bool(bool val) -> JsonWriter& {
+  BeginValue();
+  out_ += val ? "true" : "false";
+  return *this;
+}
+
+auto JsonWriter::Null() -> JsonWriter& {
+  BeginValue();
+  out_ += "null";
+  return *this;
+}
+
+auto JsonWriter::Raw(const std::string& json) -> JsonWriter& {
+  BeginValue();
+  out_ += json;
+  return *this;
+}
+
+void JsonWriter::AppendString(std::string* out, const char* val) {
+  assert(out);
+  *out += '"';
+
+  // Copy runs of plain characters in one go; escape the rest like cJSON.
+  const char* run = val;
+  for (const char* c = val; *c; c++) {
+    auto token = static_cast<unsigned char>(*c);
+    if (token > 31 && token != '"' && token != '\\') {
+      continue;
+    }
+    out->append(run, static_cast<size_t>(c - run));
+    run = c + 1;
+    switch (token) {
+      case '"':
+        *out += "\\\"";
+        break;
+      case '\\':
+        *out += "\\\\";
+        break;
+      case '\b':
+        *out += "\\b";
+        break;
+      case '\f':
+        *out += "\\f";
+        break;
+      case '\n':
+        *out += "\\n";
+        break;
+      case '\r':
+        *out += "\\r";
+        break;
+      case '\t':
+        *out += "\\t";
+        break;
+      default: {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "\\u%04x", token);
+        *out += buffer;
+        break;
+      }
+    }
+  }
+  *out += run;
+  *out += '"';
+}
+
+namespace {
+
+class JsonParser {
+ public:
+  JsonParser(const char* json, JsonReader::Handler* handler)
+      : c_(json), handler_(handler) {}
+
+  auto ParseDocument() -> bool {
+    SkipWhitespace();
+    if (!ParseValue(0)) {
+      return false;
+    }
+    SkipWhitespace();
+    return *c_ == 0;
+  }
+
+ private:
+  void SkipWhitespace() {
+    while (*c_ && static_cast<unsigned char>(*c_) <= 32) {
+      c_++;
+    }
+  }
+
+  auto Match(const char* literal) -> bool {
+    size_t len = strlen(literal);
+    if (strncmp(c_, literal, len) != 0) {
+      return false;
+    }
+    c_ += len;
+    return true;
+  }
+
+  auto ParseValue(int depth) -> bool {
+    if (depth > kJsonReaderMaxDepth) {
+      return false;
+    }
+    switch (*c_) {
+      case '{':
+        return ParseObject(depth);
+      case '[':
+        return ParseArray(depth);
+      case '"': {
+        std::string val;
+        return ParseString(&val) && handler_->OnString(val);
+      }
+      case 't':
+        return Match("true") && handler_->OnBool(true);
+      case 'f':
+        return Match("false") && handler_->OnBool(false);
+      case 'n':
+        return Match("null") && handler_->OnNull();
+      default: {
+        if (*c_ != '-' && (*c_ < '0' || *c_ > '9')) {
+          return false;
+        }
+        char* end;
+        double val = strtod(c_, &end);
+        if (end == c_) {
+          return false;
+        }
+        c_ = end;
+        return handler_->OnNumber(val);
+      }
+    }
+  }
+
+  auto ParseObject(int depth) -> bool {
+    assert(*c_ == '{');
+    c_++;
+    if (!handler_->OnBeginObject()) {
+      return false;
+    }
+    SkipWhitespace();
+    if (*c_ == '}') {
+      c_++;
+      return handler_->OnEndObject();
+    }
+    std::string key;
+    while (true) {
+      if (*c_ != '"' || !ParseString(&key) || !handler_->OnKey(key)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (*c_ != ':') {
+        return false;
+      }
+      c_++;
+      SkipWhitespace();
+      if (!ParseValue(depth + 1)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (*c_ == '}') {
+        c_++;
+        return handler_->OnEndObject();
+      }
+      if (*c_ != ',') {
+        return false;
+      }
+      c_++;
+      SkipWhitespace();
+    }
+  }
+
+  auto ParseArray(int depth) -> bool {
+    assert(*c_ == '[');
+    c_++;
+    if (!handler_->OnBeginArray()) {
+      return false;
+    }
+    SkipWhitespace();
+    if (*c_ == ']') {
+      c_++;
+      return handler_->OnEndArray();
+    }
+    while (true) {
+      if (!ParseValue(depth + 1)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (*c_ == ']') {
+        c_++;
+        return handler_->OnEndArray();
+      }
+      if (*c_ != ',') {
+        return false;
+      }
+      c_++;
+      SkipWhitespace();
+    }
+  }
+
+  auto ParseHex4(uint32_t* val) -> bool {
+    *val = 0;
+    for (int i = 0; i < 4; i++) {
+      char h = *c_++;
+      *val <<= 4;
+      if (h >= '0' && h <= '9') {
+        *val += static_cast<uint32_t>(h - '0');
+      } else if (h >= 'a' && h <= 'f') {
+        *val += static_cast<uint32_t>(h - 'a' + 10);
+      } else if (h >= 'A' && h <= 'F') {
+        *val += static_cast<uint32_t>(h - 'A' + 10);
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static void AppendUTF8(std::string* out, uint32_t code) {
+    if (code < 0x80) {
+      *out += static_cast<char>(code);
+    } else if (code < 0x800) {
+      *out += static_cast<char>(0xC0 | (code >> 6));
+      *out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      *out += static_cast<char>(0xE0 | (code >> 12));
+      *out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      *out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      *out += static_cast<char>(0xF0 | (code >> 18));
+      *out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      *out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      *out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  auto ParseString(std::string* out) -> bool {
+    assert(*c_ == '"');
+    c_++;
+    out->clear();
+    while (true) {
+      const char* run = c_;
+      while (*c_ && *c_ != '"' && *c_ != '\\') {
+        c_++;
+      }
+      out->append(run, static_cast<size_t>(c_ - run));
+      if (*c_ == '"') {
+        c_++;
+        return true;
+      }
+      if (*c_ == 0) {
+        return false;
+      }
+      c_++;
+      switch (*c_++) {
+        case '"':
+          *out += '"';
+          break;
+        case '\\':
+          *out += '\\';
+          break;
+        case '/':
+          *out += '/';
+          break;
+        case 'b':
+          *out += '\b';
+          break;
+        case 'f':
+          *out += '\f';
+          break;
+        case 'n':
+          *out += '\n';
+          break;
+        case 'r':
+          *out += '\r';
+          break;
+        case 't':
+          *out += '\t';
+          break;
+        case 'u': {
+          uint32_t code;
+          if (!ParseHex4(&code)) {
+            return false;
+          }
+
+          // Combine surrogate pairs; lone halves are invalid.
+          if (code >= 0xDC00 && code <= 0xDFFF) {
+            return false;
+          }
+          if (code >= 0xD800 && code <= 0xDBFF) {
+            uint32_t low;
+            if (c_[0] != '\\' || c_[1] != 'u') {
+              return false;
+            }
+            c_ += 2;
+            if (!ParseHex4(&low) || low < 0xDC00 || low > 0xDFFF) {
+              return false;
+            }
+            code = 0x10000 + (((code & 0x3FF) << 10) | (low & 0x3FF));
+          }
+          AppendUTF8(out, code);
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+  }
+
+  const char* c_;
+  JsonReader::Handler* handler_;
+};
+
+}  // namespace
+
+auto JsonReader::Parse(const char* json, Handler* handler) -> bool {
+  assert(json && handler);
+  return JsonParser(json, handler).ParseDocument();
+}
+
+}  // namespace ballistica
@@ -0,0 +1,77 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_GENERIC_JSON_STREAM_H_
+#define BALLISTICA_GENERIC_JSON_STREAM_H_
+
+#include <string>
+#include <vector>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Writes compact JSON straight into a string, without building a cJSON
+/// tree first. Output matches cJSON_PrintUnformatted() for the same data,
+/// so the two can be used interchangeably on the wire.
+class JsonWriter {
+ public:
+  auto BeginObject() -> JsonWriter&;
+  auto EndObject() -> JsonWriter&;
+  auto BeginArray() -> JsonWriter&;
+  auto EndArray() -> JsonWriter&;
+
+  /// Start a member of the current object; follow with its value.
+  auto Key(const char* key) -> JsonWriter&;
+
+  auto String(const char* val) -> JsonWriter&;
+  auto String(const std::string& val) -> JsonWriter& {
+    return String(val.c_str());
+  }
+  auto Int(int64_t val) -> JsonWriter&;
+  auto Number(double val) -> JsonWriter&;
+  auto Bool(bool val) -> JsonWriter&;
+  auto Null() -> JsonWriter&;
+
+  /// Add an already-serialized JSON value as-is.
+  auto Raw(const std::string& json) -> JsonWriter&;
+
+  auto str() const -> const std::string& { return out_; }
+
+  /// Append val as a quoted, escaped JSON string.
+  static void AppendString(std::string* out, const char* val);
+
+ private:
+  void BeginValue();
+  std::string out_;
+
+  // Per open container: whether it has had an entry yet.
+  std::vector<bool> has_entry_;
+  bool after_key_{};
+};
+
+/// Event-based JSON parsing; calls a handler for each key and value as it
+/// goes rather than building a tree. Handlers return false to stop early.
+class JsonReader {
+ public:
+  class Handler {
+   public:
+    virtual ~Handler() = default;
+    virtual auto OnBeginObject() -> bool { return true; }
+    virtual auto OnEndObject() -> bool { return true; }
+    virtual auto OnBeginArray() -> bool { return true; }
+    virtual auto OnEndArray() -> bool { return true; }
+    virtual auto OnKey(const std::string& key) -> bool { return true; }
+    virtual auto OnString(const std::string& val) -> bool { return true; }
+    virtual auto OnNumber(double val) -> bool { return true; }
+    virtual auto OnBool(bool val) -> bool { return true; }
+    virtual auto OnNull() -> bool { return true; }
+  };
+
+  /// Parse a complete JSON document. Returns false if it was malformed or
+  /// the handler stopped early.
+  static auto Parse(const char* json, Handler* handler) -> bool;
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_GENERIC_JSON_STREAM_H_
@@ -22,7 +22,7 @@ class Timer {
   virtual ~Timer();
   TimerList* list_{};
   bool on_list_{};
-  Timer* next_{};
+  size_t list_index_{};  // Our slot in our list's heap (or inactive set).
   bool initial_{};
   bool dead_{};
   bool list_died_{};
@@ -32,6 +32,7 @@ class Timer {
   TimerMedium length_{};
   int repeat_count_{};
   Object::Ref<Runnable> runnable_;
+  uint64_t list_order_{};  // Breaks expire-time ties first-come-first-served.
   // FIXME: Shouldn't have friend classes in different files.
   friend class TimerList;
 };
@@ -2,12 +2,106 @@
 
 #include "ballistica/generic/timer_list.h"
 
+#include <unordered_map>
+
 #include "ballistica/generic/runnable.h"
 #include "ballistica/generic/timer.h"
 
 namespace ballistica {
 
-TimerList::TimerList() = default;
+// Active timers live in a binary min-heap ordered by expire time (with
+// ties going first-come-first-served, as they always have), and an id
+// index lets us find any timer without searching for it.
+class TimerList::Impl {
+ public:
+  static auto ExpiresBefore(const Timer* a, const Timer* b) -> bool {
+    if (a->expire_time_ != b->expire_time_) {
+      return a->expire_time_ < b->expire_time_;
+    }
+    return a->list_order_ < b->list_order_;
+  }
+
+  void Place(size_t index, Timer* t) {
+    heap[index] = t;
+    t->list_index_ = index;
+  }
+
+  void SiftUp(size_t index) {
+    Timer* t = heap[index];
+    while (index > 0) {
+      size_t parent = (index - 1) / 2;
+      if (!ExpiresBefore(t, heap[parent])) {
+        break;
+      }
+      Place(index, heap[parent]);
+      index = parent;
+    }
+    Place(index, t);
+  }
+
+  void SiftDown(size_t index) {
+    Timer* t = heap[index];
+    size_t size = heap.size();
+    while (true) {
+      size_t child = index * 2 + 1;
+      if (child >= size) {
+        break;
+      }
+      if (child + 1 < size && ExpiresBefore(heap[child + 1], heap[child])) {
+        child++;
+      }
+      if (!ExpiresBefore(heap[child], t)) {
+        break;
+      }
+      Place(index, heap[child]);
+      index = child;
+    }
+    Place(index, t);
+  }
+
+  void HeapPush(Timer* t) {
+    t->list_order_ = next_order++;
+    heap.push_back(t);
+    SiftUp(heap.size() - 1);
+  }
+
+  void HeapRemove(Timer* t) {
+    size_t index = t->list_index_;
+    assert(index < heap.size() && heap[index] == t);
+    Timer* last = heap.back();
+    heap.pop_back();
+    if (last != t) {
+      Place(index, last);
+      SiftDown(index);
+      SiftUp(last->list_index_);
+    }
+  }
+
+  // Timers set to never go off; these don't need ordering.
+  void InactiveAdd(Timer* t) {
+    t->list_index_ = inactive.size();
+    inactive.push_back(t);
+  }
+
+  void InactiveRemove(Timer* t) {
+    size_t index = t->list_index_;
+    assert(index < inactive.size() && inactive[index] == t);
+    Timer* last = inactive.back();
+    inactive[index] = last;
+    last->list_index_ = index;
+    inactive.pop_back();
+  }
+
+  auto first() const -> Timer* { return heap.empty() ? nullptr : heap[0]; }
+
+  std::vector<Timer*> heap;
+  std::vector<Timer*> inactive;
+  std::unordered_map<int, Timer*> timers_by_id;
+  std::vector<size_t> scratch;
+  uint64_t next_order{};
+};
+
+TimerList::TimerList() : impl_(std::make_unique<Impl>()) {}
 
 TimerList::~TimerList() {
   Clear();
@@ -35,62 +129,45 @@ TimerList::~TimerList() {
 void TimerList::Clear() {
   assert(!are_clearing_);
   are_clearing_ = true;
-  while (timers_) {
-    Timer* t = timers_;
-    t->on_list_ = false;
-    timer_count_active_--;
-    timers_ = t->next_;
+
+  // Pulling from the back keeps things valid for anything dying timers
+  // may do to us.
+  while (!impl_->heap.empty()) {
+    Timer* t = impl_->heap.back();
+    RemoveTimer(t);
     delete t;
   }
-  while (timers_inactive_) {
-    Timer* t = timers_inactive_;
-    t->on_list_ = false;
-    timer_count_inactive_--;
-    timers_inactive_ = t->next_;
+  while (!impl_->inactive.empty()) {
+    Timer* t = impl_->inactive.back();
+    RemoveTimer(t);
     delete t;
   }
   are_clearing_ = false;
 }
 
-// Pull a timer out of the list.
-auto TimerList::PullTimer(int timer_id, bool remove) -> Timer* {
-  Timer* t = timers_;
-  Timer* p = nullptr;
-  while (t) {
-    if (t->id_ == timer_id) {
-      if (remove) {
-        if (p) {
-          p->next_ = t->next_;
-        } else {
-          timers_ = t->next_;
-        }
-        t->on_list_ = false;
-        timer_count_active_--;
-      }
-      return t;
-    }
-    p = t;
-    t = t->next_;
+void TimerList::RemoveTimer(Timer* t) {
+  assert(t->on_list_);
+  if (t->length_ == -1) {
+    impl_->InactiveRemove(t);
+    timer_count_inactive_--;
+  } else {
+    impl_->HeapRemove(t);
+    timers_ = impl_->first();
+    timer_count_active_--;
   }
+  impl_->timers_by_id.erase(t->id_);
+  t->on_list_ = false;
+}
 
-  // Didn't find it. check the inactive list.
-  t = timers_inactive_;
-  p = nullptr;
-  while (t) {
-    if (t->id_ == timer_id) {
-      if (remove) {
-        if (p) {
-          p->next_ = t->next_;
-        } else {
-          timers_inactive_ = t->next_;
-        }
-        t->on_list_ = false;
-        timer_count_inactive_--;
-      }
-      return t;
+// Pull a timer out of the list.
+auto TimerList::PullTimer(int timer_id, bool remove) -> Timer* {
+  auto i = impl_->timers_by_id.find(timer_id);
+  if (i != impl_->timers_by_id.end()) {
+    Timer* t = i->second;
+    if (remove) {
+      RemoveTimer(t);
     }
-    p = t;
-    t = t->next_;
+    return t;
   }
 
   // Not on either list; only other possibility is the current client timer.
@@ -137,11 +214,22 @@ void TimerList::Run(TimerMedium target_time) {
 auto TimerList::GetExpiredCount(TimerMedium target_time) -> int {
   assert(!are_clearing_);
 
-  Timer* t = timers_;
+  // Expired timers form a subtree at the top of the heap; walk just that.
+  std::vector<Timer*>& heap = impl_->heap;
+  std::vector<size_t>& pending = impl_->scratch;
   int count = 0;
-  while (t && t->expire_time_ <= target_time) {
+  if (!heap.empty() && heap[0]->expire_time_ <= target_time) {
+    pending.push_back(0);
+  }
+  while (!pending.empty()) {
+    size_t index = pending.back();
+    pending.pop_back();
     count++;
-    t = t->next_;
+    for (size_t child = index * 2 + 1; child <= index * 2 + 2; child++) {
+      if (child < heap.size() && heap[child]->expire_time_ <= target_time) {
+        pending.push_back(child);
+      }
+    }
   }
   return count;
 }
@@ -156,9 +244,7 @@ auto TimerList::GetExpiredTimer(TimerMedium target_time) -> Timer* {
   if (timers_ != nullptr && timers_->expire_time_ <= target_time) {
     t = timers_;
     t->last_run_time_ = target_time;
-    timers_ = timers_->next_;
-    timer_count_active_--;
-    t->on_list_ = false;
+    RemoveTimer(t);
 
     // Exactly one timer at a time can be out in userland and not on
     // any list - this is now that one.
@@ -249,22 +335,14 @@ void TimerList::AddTimer(Timer* t) {
 
   // If its set to never go off, throw it on the inactive list.
   if (t->length_ == -1) {
-    t->next_ = timers_inactive_;
-    timers_inactive_ = t;
+    impl_->InactiveAdd(t);
     timer_count_inactive_++;
   } else {
-    Timer** list = &timers_;
-
-    // Go along till we find an expire time later than ourself.
-    while (*list != nullptr) {
-      if ((*list)->expire_time_ > t->expire_time_) break;
-      list = &((*list)->next_);
-    }
-    Timer* tmp = (*list);
-    (*list) = t;
-    t->next_ = tmp;
+    impl_->HeapPush(t);
+    timers_ = impl_->first();
     timer_count_active_++;
   }
+  impl_->timers_by_id[t->id_] = t;
   t->on_list_ = true;
 }
 
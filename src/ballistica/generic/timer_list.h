@@ -4,6 +4,7 @@
 #define BALLISTICA_GENERIC_TIMER_LIST_H_
 
 #include <cstdio>
+#include <memory>
 #include <vector>
 
 #include "ballistica/ballistica.h"
@@ -51,12 +52,14 @@ class TimerList {
   auto PullTimer(int timer_id, bool remove = true) -> Timer*;
   auto SubmitTimer(Timer* t) -> Timer*;
   void AddTimer(Timer* t);
+  void RemoveTimer(Timer* t);
+  class Impl;
   int timer_count_active_ = 0;
   int timer_count_inactive_ = 0;
   int timer_count_total_ = 0;
   Timer* client_timer_ = nullptr;
-  Timer* timers_ = nullptr;
-  Timer* timers_inactive_ = nullptr;
+  Timer* timers_ = nullptr;  // The next active timer to expire.
+  std::unique_ptr<Impl> impl_;
   int next_timer_id_ = 1;
   bool running_ = false;
   bool are_clearing_ = false;
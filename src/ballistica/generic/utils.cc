@@ -7,12 +7,22 @@
 
 #include "ballistica/app/app_globals.h"
 #include "ballistica/generic/huffman.h"
-#include "ballistica/generic/json.h"
+#include "ballistica/generic/json_stream.h"
 #include "ballistica/generic/utf8.h"
 #include "ballistica/math/vector3f.h"
 #include "ballistica/platform/platform.h"
 #include "ballistica/scene/scene.h"
 
+// Use SIMD for scanning runs of ascii in utf8 strings where available.
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BA_UTF8_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BA_UTF8_NEON 1
+#include <arm_neon.h>
+#endif
+
 // FIXME: Cleaner to add the lib to the project(s) instead?
 #if BA_OSTYPE_WINDOWS
 #pragma comment(lib, "Ws2_32.lib")
@@ -186,19 +196,88 @@ auto Utils::StringReplaceAll(std::string* target, const std::string& key,
   target->swap(ws_ret);  // faster than str = ws_ret;
 }
 
+// Returns the length of the run of ascii (bytes below 128) that s starts
+// with.
+static auto ASCIIRunLength(const char* s, size_t len) -> size_t {
+  size_t i = 0;
+#if BA_UTF8_SSE2
+  for (; i + 16 <= len; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    if (_mm_movemask_epi8(v) != 0) {
+      break;
+    }
+  }
+#elif BA_UTF8_NEON
+  for (; i + 16 <= len; i += 16) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i));
+    if (vmaxvq_u8(v) >= 0x80) {
+      break;
+    }
+  }
+#endif
+  while (i < len && static_cast<unsigned char>(s[i]) < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+// Returns the length of the run of bytes that s starts with which
+// GetValidUTF8() passes through untouched on their own: printable ascii
+// plus tab, newline and carriage return.
+static auto CleanASCIIRunLength(const char* s, size_t len) -> size_t {
+  size_t i = 0;
+  while (i < len) {
+#if BA_UTF8_SSE2
+    if (i + 16 <= len) {
+      // Bytes 128 and up are negative as signed; they fail the first test.
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+      __m128i ok = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(31)),
+                                 _mm_cmplt_epi8(v, _mm_set1_epi8(127)));
+      if (_mm_movemask_epi8(ok) == 0xFFFF) {
+        i += 16;
+        continue;
+      }
+    }
+#elif BA_UTF8_NEON
+    if (i + 16 <= len) {
+      uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i));
+      uint8x16_t ok =
+          vandq_u8(vcgtq_u8(v, vdupq_n_u8(31)), vcltq_u8(v, vdupq_n_u8(127)));
+      if (vminvq_u8(ok) == 0xFF) {
+        i += 16;
+        continue;
+      }
+    }
+#endif
+    auto c = static_cast<unsigned char>(s[i]);
+    if ((c < 32 || c > 126) && c != 9 && c != 10 && c != 13) {
+      break;
+    }
+    i++;
+  }
+  return i;
+}
+
 auto Utils::IsValidUTF8(const std::string& val) -> bool {
+  // Quick out for plain ascii (the vast majority of what we see).
+  if (CleanASCIIRunLength(val.data(), val.size()) == val.size()) {
+    return true;
+  }
   std::string out = Utils::GetValidUTF8(val.c_str(), "bsivu8");
   return (out == val);
 }
 
-static auto utf8_check_is_valid(const std::string& string) -> bool {
+static auto utf8_check_is_valid(const char* string, int length) -> bool {
   int c, i, ix, n, j;
-  for (i = 0, ix = static_cast<int>(string.length()); i < ix; i++) {
+  for (i = 0, ix = length; i < ix; i++) {
     c = (unsigned char)string[i];
     // if (c==0x09 || c==0x0a || c==0x0d
     // || (0x20 <= c && c <= 0x7e) ) n = 0;  // is_printable_ascii
-    if (0x00 <= c && c <= 0x7f) {
-      n = 0;                          // 0bbbbbbb
+    if (0x00 <= c && c <= 0x7f) {  // 0bbbbbbb
+      // Skip over the rest of any ascii run in one go.
+      auto run = ASCIIRunLength(string + i, static_cast<size_t>(ix - i));
+      i += static_cast<int>(run) - 1;
+      continue;
     } else if ((c & 0xE0) == 0xC0) {  // NOLINT
       n = 1;                          // 110bbbbb
     } else if (c == 0xed && i < (ix - 1)
@@ -238,7 +317,14 @@ auto Utils::GetValidUTF8(const char* str, const char* loc) -> std::string {
   // ok, it seems we're somehow letting some funky utf8 through that's
   // causing crashes.. for now lets try this all-or-nothing func and return
   // ascii only if it fails
-  if (!utf8_check_is_valid(str)) {
+  // Plain ascii comes through as-is; no need to look any closer.
+  size_t clean_length = CleanASCIIRunLength(str, static_cast<size_t>(f_size));
+  if (clean_length == static_cast<size_t>(f_size)) {
+    to.assign(str, clean_length);
+    return to;
+  }
+
+  if (!utf8_check_is_valid(str, f_size)) {
     // now strip out anything but normal ascii...
     for (i = 0; i < f_size; i++) {
       c = (unsigned char)(str)[i];
@@ -271,8 +357,11 @@ auto Utils::GetValidUTF8(const char* str, const char* loc) -> std::string {
           to.append(1, static_cast<char>(c));
         }
         continue;
-      } else if (c < 127) {  // normal ASCII
-        to.append(1, static_cast<char>(c));
+      } else if (c < 127) {  // normal ASCII (likely with more following)
+        size_t run =
+            CleanASCIIRunLength(str + i, static_cast<size_t>(f_size - i));
+        to.append(str + i, run);
+        i += static_cast<int>(run) - 1;
         continue;
       } else if (c < 160) {
         // control char (nothing should be defined here either
@@ -374,9 +463,17 @@ auto Utils::UnicodeFromUTF8(const std::string& s_in, const char* loc)
   std::string s = GetValidUTF8(s_in.c_str(), loc);
   // worst case every char is a character (plus trailing 0)
   std::vector<uint32_t> vals(s.size() + 1);
-  int converted = u8_toucs(&vals[0], static_cast<int>(vals.size()), s.c_str(),
-                           static_cast<int>(s.size()));
-  vals.resize(static_cast<size_t>(converted));
+
+  // Widen any leading ascii directly and decode only what's left.
+  size_t ascii_length = ASCIIRunLength(s.data(), s.size());
+  for (size_t i = 0; i < ascii_length; i++) {
+    vals[i] = static_cast<unsigned char>(s[i]);
+  }
+  int converted = u8_toucs(&vals[ascii_length],
+                           static_cast<int>(vals.size() - ascii_length),
+                           s.c_str() + ascii_length,
+                           static_cast<int>(s.size() - ascii_length));
+  vals.resize(ascii_length + static_cast<size_t>(converted));
   return vals;
 }
 
@@ -394,11 +491,7 @@ void Utils::AdvanceUTF8(const char** c) {
 
 auto Utils::GetJSONString(const char* s) -> std::string {
   std::string str;
-  cJSON* str_obj = cJSON_CreateString(s);
-  char* str_buffer = cJSON_PrintUnformatted(str_obj);
-  str = str_buffer;
-  free(str_buffer);
-  cJSON_Delete(str_obj);
+  JsonWriter::AppendString(&str, s);
   return str;
 }
 
@@ -369,6 +369,17 @@ class Utils {
     return t * t * (3.0f - 2.0f * t);
   }
 
+  /// Nearest-rank percentile (fraction in [0,1]) of an already-sorted
+  /// list; 0 if empty.
+  static auto SortedPercentile(const std::vector<float>& sorted,
+                               double fraction) -> double {
+    if (sorted.empty()) {
+      return 0.0;
+    }
+    auto index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+  }
+
  private:
   static float precalc_rands_1_[];
   static float precalc_rands_2_[];
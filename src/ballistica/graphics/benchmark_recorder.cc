@@ -0,0 +1,256 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/graphics/benchmark_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#if BA_OSTYPE_WINDOWS
+#include <windows.h>
+// (needs to come after windows.h)
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "ballistica/generic/json_stream.h"
+#include "ballistica/generic/utils.h"
+#include "ballistica/graphics/graphics.h"
+#include "ballistica/graphics/graphics_server.h"
+#include "ballistica/graphics/renderer.h"
+#include "ballistica/input/input_latency.h"
+#include "ballistica/platform/platform.h"
+
+namespace ballistica {
+
+// Names for RenderPass::Type values in results.
+static const char* kBenchmarkPassNames[] = {
+    "light_shadow", "light",      "beauty",       "beauty_bg",
+    "blit",         "overlay",    "overlay_front", "overlay_3d",
+    "overlay_flat", "vr_cover",   "overlay_fixed"};
+static_assert(sizeof(kBenchmarkPassNames) / sizeof(kBenchmarkPassNames[0])
+                  == Renderer::kRenderPassTypeCount,
+              "Pass name list is out of date.");
+
+struct BenchmarkPassStats {
+  double total_ms{};
+  float max_ms{};
+  int frames{};
+};
+
+// Frames come in from both the game and graphics threads.
+struct BenchmarkRecorderState {
+  std::mutex mutex;
+  std::atomic<bool> recording{};
+  std::string path;
+  std::chrono::steady_clock::time_point start_time;
+  std::vector<float> build_ms;
+  std::vector<float> render_ms;
+  BenchmarkPassStats passes[Renderer::kRenderPassTypeCount];
+};
+static BenchmarkRecorderState* g_benchmark_recorder{};
+
+// Peak resident memory of our process in kilobytes (or -1 if unknown).
+static auto GetPeakMemoryKB() -> int64_t {
+#if BA_OSTYPE_WINDOWS
+  PROCESS_MEMORY_COUNTERS counters;
+  if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters))) {
+    return static_cast<int64_t>(counters.PeakWorkingSetSize / 1024);
+  }
+  return -1;
+#else
+  struct rusage usage {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+#if BA_OSTYPE_MACOS || BA_OSTYPE_IOS_TVOS
+  // Apple reports bytes; everyone else kilobytes.
+  return static_cast<int64_t>(usage.ru_maxrss / 1024);
+#else
+  return static_cast<int64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+static void SetGPUPassTimersEnabled(bool enabled) {
+  g_graphics_server->PushCall([enabled] {
+    if (Renderer* renderer = g_graphics_server->renderer()) {
+      renderer->set_gpu_pass_timers_enabled(enabled);
+    }
+  });
+}
+
+static void WriteFrameTimes(JsonWriter* writer, const char* key,
+                            const std::vector<float>& frame_ms) {
+  double total{};
+  for (float ms : frame_ms) {
+    total += ms;
+  }
+  std::vector<float> sorted = frame_ms;
+  std::sort(sorted.begin(), sorted.end());
+  writer->Key(key)
+      .BeginObject()
+      .Key("mean")
+      .Number(frame_ms.empty() ? 0.0 : total / frame_ms.size())
+      .Key("p50")
+      .Number(Utils::SortedPercentile(sorted, 0.5))
+      .Key("p90")
+      .Number(Utils::SortedPercentile(sorted, 0.9))
+      .Key("p99")
+      .Number(Utils::SortedPercentile(sorted, 0.99))
+      .Key("max")
+      .Number(sorted.empty() ? 0.0 : sorted.back())
+      .Key("frames")
+      .BeginArray();
+  for (float ms : frame_ms) {
+    writer->Number(ms);
+  }
+  writer->EndArray().EndObject();
+}
+
+void BenchmarkRecorder::Start(const std::string& path) {
+  assert(InGameThread());
+  if (recording()) {
+    throw Exception("A benchmark is already being recorded.");
+  }
+  if (g_benchmark_recorder == nullptr) {
+    g_benchmark_recorder = new BenchmarkRecorderState();
+  }
+  BenchmarkRecorderState* state = g_benchmark_recorder;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->path = path;
+    state->start_time = std::chrono::steady_clock::now();
+    state->build_ms.clear();
+    state->render_ms.clear();
+    for (auto& pass : state->passes) {
+      pass = BenchmarkPassStats();
+    }
+    state->recording = true;
+  }
+  InputLatency::Reset();
+  if (!HeadlessMode() && g_graphics_server) {
+    SetGPUPassTimersEnabled(true);
+  }
+}
+
+void BenchmarkRecorder::Stop() {
+  assert(InGameThread());
+  if (!recording()) {
+    return;
+  }
+  BenchmarkRecorderState* state = g_benchmark_recorder;
+  std::vector<float> build_ms;
+  std::vector<float> render_ms;
+  BenchmarkPassStats passes[Renderer::kRenderPassTypeCount];
+  double real_seconds;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->recording = false;
+    build_ms.swap(state->build_ms);
+    render_ms.swap(state->render_ms);
+    std::copy(std::begin(state->passes), std::end(state->passes), passes);
+    real_seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - state->start_time)
+                       .count();
+  }
+
+  // Leave timers going if the debug display is still showing them.
+  if (!HeadlessMode() && g_graphics_server
+      && !g_graphics->network_debug_info_display_enabled()) {
+    SetGPUPassTimersEnabled(false);
+  }
+
+  JsonWriter writer;
+  writer.BeginObject().Key("real_seconds").Number(real_seconds);
+  writer.Key("fps").Number(
+      real_seconds > 0.0 ? render_ms.size() / real_seconds : 0.0);
+  WriteFrameTimes(&writer, "frame_build_ms", build_ms);
+  WriteFrameTimes(&writer, "frame_render_ms", render_ms);
+
+  // Only passes the renderer could time show up here.
+  writer.Key("gpu_pass_ms").BeginObject();
+  for (int i = 0; i < Renderer::kRenderPassTypeCount; i++) {
+    const BenchmarkPassStats& pass = passes[i];
+    if (pass.frames == 0) {
+      continue;
+    }
+    writer.Key(kBenchmarkPassNames[i])
+        .BeginObject()
+        .Key("mean")
+        .Number(pass.total_ms / pass.frames)
+        .Key("max")
+        .Number(pass.max_ms)
+        .Key("frames")
+        .Int(pass.frames)
+        .EndObject();
+  }
+  writer.EndObject();
+  writer.Key("input_latency_ms");
+  InputLatency::WriteStatsJson(&writer);
+  writer.Key("peak_memory_kb")
+      .Int(GetPeakMemoryKB())
+      .Key("platform_memory_info")
+      .String(g_platform->GetMemUsageInfo())
+      .EndObject();
+
+  FILE* f = g_platform->FOpen(state->path.c_str(), "wb");
+  if (!f) {
+    Log("Error: Unable to write benchmark results to '" + state->path + "'.");
+    return;
+  }
+  fprintf(f, "%s\n", writer.str().c_str());
+  fclose(f);
+  Log("Wrote benchmark results (" + std::to_string(render_ms.size())
+      + " frames rendered) to '" + state->path + "'.");
+}
+
+auto BenchmarkRecorder::recording() -> bool {
+  return g_benchmark_recorder != nullptr
+         && g_benchmark_recorder->recording.load();
+}
+
+void BenchmarkRecorder::AddFrameBuild(double seconds) {
+  assert(InGameThread());
+  BenchmarkRecorderState* state = g_benchmark_recorder;
+  assert(state);
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (state->recording) {
+    state->build_ms.push_back(static_cast<float>(seconds * 1000.0));
+  }
+}
+
+void BenchmarkRecorder::AddFrameRender(double seconds) {
+  assert(InGraphicsThread());
+  BenchmarkRecorderState* state = g_benchmark_recorder;
+  assert(state);
+
+  // Pass times lag a few frames behind; close enough for totals.
+  float pass_ms[Renderer::kRenderPassTypeCount];
+  Renderer* renderer = g_graphics_server->renderer();
+  for (int i = 0; i < Renderer::kRenderPassTypeCount; i++) {
+    pass_ms[i] = renderer
+                     ? renderer->gpu_pass_time(static_cast<RenderPass::Type>(i))
+                     : -1.0f;
+  }
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (!state->recording) {
+    return;
+  }
+  state->render_ms.push_back(static_cast<float>(seconds * 1000.0));
+  for (int i = 0; i < Renderer::kRenderPassTypeCount; i++) {
+    if (pass_ms[i] >= 0.0f) {
+      BenchmarkPassStats& pass = state->passes[i];
+      pass.total_ms += pass_ms[i];
+      pass.max_ms = std::max(pass.max_ms, pass_ms[i]);
+      pass.frames++;
+    }
+  }
+}
+
+}  // namespace ballistica
@@ -0,0 +1,37 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_GRAPHICS_BENCHMARK_RECORDER_H_
+#define BALLISTICA_GRAPHICS_BENCHMARK_RECORDER_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Records per-frame timings while a benchmark runs and writes them out
+/// as JSON when stopped, so results can be compared between devices and
+/// builds by tools instead of read off the screen. Covers time spent
+/// building each FrameDef (game thread), rendering it (graphics thread),
+/// per-pass GPU times where the renderer supports timer queries,
+/// InputLatency percentiles, and peak process memory.
+class BenchmarkRecorder {
+ public:
+  /// Start recording; results go to path when stopped. Game thread only.
+  static void Start(const std::string& path);
+
+  /// Stop recording and write results (if recording).
+  static void Stop();
+
+  static auto recording() -> bool;
+
+  /// Called by Graphics for each FrameDef it builds.
+  static void AddFrameBuild(double seconds);
+
+  /// Called by GraphicsServer for each FrameDef it renders.
+  static void AddFrameRender(double seconds);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_GRAPHICS_BENCHMARK_RECORDER_H_
@@ -221,6 +221,7 @@ void Camera::UpdatePosition() {
 
         float x_min, y_min, z_min, x_max, y_max, z_max;
 
+        have_area_of_interest_extents_ = false;
         if (!areas_of_interest_.empty()) {
           float angle_x_min = 0.0f, angle_x_max = 0.0f, angle_y_min = 0.0f,
                 angle_y_max = 0.0f;
@@ -230,61 +231,23 @@ void Camera::UpdatePosition() {
           x_max = y_max = z_max = -99999;
 
           // Find the center of all AOI points (clamped to our bounds plus their
-          // radius as a buffer)
+          // radius as a buffer). We keep the clamped points for the aiming
+          // pass below, which clamps them the same way.
+          area_of_interest_clamped_.clear();
           for (auto&& i : areas_of_interest_) {
-            float x_clamped, y_clamped, z_clamped;
-            float diameter = i.radius() * 2.0f;
-
-            if (diameter
-                > (area_of_interest_bounds_[3] - area_of_interest_bounds_[0])) {
-              x_clamped =
-                  0.5f
-                  * (area_of_interest_bounds_[3] + area_of_interest_bounds_[0]);
-            } else {
-              x_clamped =
-                  std::min(area_of_interest_bounds_[3] - i.radius(),
-                           std::max(area_of_interest_bounds_[0] + i.radius(),
-                                    i.position().x));
-            }
-
-            if (diameter
-                > (area_of_interest_bounds_[4] - area_of_interest_bounds_[1])) {
-              y_clamped =
-                  0.5f
-                  * (area_of_interest_bounds_[4] + area_of_interest_bounds_[1]);
-            } else {
-              y_clamped =
-                  std::min(area_of_interest_bounds_[4] - i.radius(),
-                           std::max(area_of_interest_bounds_[1] + i.radius(),
-                                    i.position().y));
-            }
-
-            if (diameter
-                > (area_of_interest_bounds_[5] - area_of_interest_bounds_[2])) {
-              z_clamped = 0.5f
-                          * ((area_of_interest_bounds_[5]
-                              + area_of_interest_bounds_[2]));
-            } else {
-              z_clamped =
-                  std::min(area_of_interest_bounds_[5] - i.radius(),
-                           std::max(area_of_interest_bounds_[2] + i.radius(),
-                                    i.position().z));
-            }
-
-            x_min = std::min(x_min, x_clamped - i.radius());
-            y_min = std::min(y_min, y_clamped - i.radius());
-            z_min = std::min(z_min, z_clamped - i.radius());
-            x_max = std::max(x_max, x_clamped - i.radius());
-            y_max = std::max(y_max, y_clamped - i.radius());
-            z_max = std::max(z_max, z_clamped - i.radius());
-
-            x_min = std::min(x_min, x_clamped + i.radius());
-            y_min = std::min(y_min, y_clamped + i.radius());
-            z_min = std::min(z_min, z_clamped + i.radius());
-            x_max = std::max(x_max, x_clamped + i.radius());
-            y_max = std::max(y_max, y_clamped + i.radius());
-            z_max = std::max(z_max, z_clamped + i.radius());
+            area_of_interest_clamped_.push_back(
+                ClampAreaOfInterest(i.position(), i.radius()));
+            const Vector3f& clamped = area_of_interest_clamped_.back();
+            x_min = std::min(x_min, clamped.x - i.radius());
+            y_min = std::min(y_min, clamped.y - i.radius());
+            z_min = std::min(z_min, clamped.z - i.radius());
+            x_max = std::max(x_max, clamped.x + i.radius());
+            y_max = std::max(y_max, clamped.y + i.radius());
+            z_max = std::max(z_max, clamped.z + i.radius());
           }
+          area_of_interest_extents_min_ = Vector3f(x_min, y_min, z_min);
+          area_of_interest_extents_max_ = Vector3f(x_max, y_max, z_max);
+          have_area_of_interest_extents_ = true;
 
           center_x = 0.5f * (x_min + x_max);
           center_y = 0.5f * (y_min + y_max);
@@ -306,6 +269,7 @@ void Camera::UpdatePosition() {
 
           int num = 0;
 
+          auto clamped = area_of_interest_clamped_.begin();
           for (auto&& i : areas_of_interest_) {
             // If this point is used for focusing, add it to that list.
             if (i.in_focus()) {
@@ -324,48 +288,14 @@ void Camera::UpdatePosition() {
                   x_clamped_focus, y_clamped_focus, z_clamped_focus);
             }
 
-            // Now, for camera aiming purposes, add some of their velocity and
-            // clamp to the bounds, taking their radius into account. if our AOI
-            // sphere is bigger than a given dimension, center it; otherwise
-            // clamp to the box inset by our radius.
-            float x_clamped, y_clamped, z_clamped, x_mirrored_clamped;
+            // Now, for camera aiming purposes, clamp to the bounds, taking
+            // their radius into account (as above).
+            float x_mirrored_clamped;
             float diameter = i.radius() * 2.0f;
-
-            if (diameter
-                > (area_of_interest_bounds_[3] - area_of_interest_bounds_[0])) {
-              x_clamped =
-                  0.5f
-                  * (area_of_interest_bounds_[3] + area_of_interest_bounds_[0]);
-            } else {
-              x_clamped =
-                  std::min(area_of_interest_bounds_[3] - i.radius(),
-                           std::max(area_of_interest_bounds_[0] + i.radius(),
-                                    i.position().x));
-            }
-
-            if (diameter
-                > (area_of_interest_bounds_[4] - area_of_interest_bounds_[1])) {
-              y_clamped =
-                  0.5f
-                  * (area_of_interest_bounds_[4] + area_of_interest_bounds_[1]);
-            } else {
-              y_clamped =
-                  std::min(area_of_interest_bounds_[4] - i.radius(),
-                           std::max(area_of_interest_bounds_[1] + i.radius(),
-                                    i.position().y));
-            }
-
-            if (diameter
-                > (area_of_interest_bounds_[5] - area_of_interest_bounds_[2])) {
-              z_clamped = 0.5f
-                          * ((area_of_interest_bounds_[5]
-                              + area_of_interest_bounds_[2]));
-            } else {
-              z_clamped =
-                  std::min(area_of_interest_bounds_[5] - i.radius(),
-                           std::max(area_of_interest_bounds_[2] + i.radius(),
-                                    i.position().z));
-            }
+            float x_clamped = clamped->x;
+            float y_clamped = clamped->y;
+            float z_clamped = clamped->z;
+            ++clamped;
 
             // Let's also do a version mirrored across the camera's x coordinate
             // (adding this to our tracked point set causes us zoom out instead
@@ -744,7 +674,7 @@ void Camera::Update(millisecs_t elapsed) {
       do_regular_update = false;
       Vector3f listener_pos = vrgraphics->vr_head_translate()
                               + vrgraphics->vr_head_forward() * 5.0f;
-      assert(g_audio_server);
+      assert(g_audio);
       g_audio->SetListenerPosition(listener_pos);
       g_audio->SetListenerOrientation(vrgraphics->vr_head_forward(),
                                       vrgraphics->vr_head_up());
@@ -756,7 +686,7 @@ void Camera::Update(millisecs_t elapsed) {
           position_.x + to_target * (target_smoothed_.x - position_.x),
           position_.y + to_target * (target_smoothed_.y - position_.y),
           position_.z + to_target * (target_smoothed_.z - position_.z));
-      assert(g_audio_server);
+      assert(g_audio);
       g_audio->SetListenerPosition(listener_pos);
     }
   }
@@ -851,6 +781,34 @@ void Camera::ManualHandleMouseMove(float move_h, float move_v) {
   }
 }
 
+// If an AOI sphere is bigger than a given dimension of our bounds, center
+// it; otherwise clamp it to the bounds inset by its radius.
+auto Camera::ClampAreaOfInterest(const Vector3f& position, float radius) const
+    -> Vector3f {
+  const float* bounds = area_of_interest_bounds_;
+  Vector3f clamped;
+  for (int axis = 0; axis < 3; axis++) {
+    if (radius * 2.0f > bounds[axis + 3] - bounds[axis]) {
+      clamped.v[axis] = 0.5f * (bounds[axis + 3] + bounds[axis]);
+    } else {
+      clamped.v[axis] = std::min(bounds[axis + 3] - radius,
+                                 std::max(bounds[axis] + radius,
+                                          position.v[axis]));
+    }
+  }
+  return clamped;
+}
+
+auto Camera::GetAreaOfInterestExtents(Vector3f* min, Vector3f* max) const
+    -> bool {
+  if (!have_area_of_interest_extents_) {
+    return false;
+  }
+  *min = area_of_interest_extents_min_;
+  *max = area_of_interest_extents_max_;
+  return true;
+}
+
 auto Camera::NewAreaOfInterest(bool in_focus) -> AreaOfInterest* {
   assert(InGameThread());
   areas_of_interest_.emplace_back(in_focus);
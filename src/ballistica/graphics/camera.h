@@ -81,6 +81,11 @@ class Camera : public Object {
   auto happy_thoughts_mode() const -> bool { return happy_thoughts_mode_; }
   auto NewAreaOfInterest(bool inFocus = true) -> AreaOfInterest*;
   void DeleteAreaOfInterest(AreaOfInterest* a);
+
+  /// The world-space box around our areas-of-interest (clamped to the
+  /// bounds and padded by their radii) as of the last follow-mode update.
+  /// Returns false if there is none.
+  auto GetAreaOfInterestExtents(Vector3f* min, Vector3f* max) const -> bool;
   auto mode() const -> CameraMode { return mode_; }
   void set_vr_offset(const Vector3f& val) { vr_offset_ = val; }
   void set_vr_extra_offset(const Vector3f& val) { vr_extra_offset_ = val; }
@@ -145,6 +150,14 @@ class Camera : public Object {
   bool x_constrained_{true};
   float xy_constrain_blend_{0.5f};
   std::vector<Vector3f> area_of_interest_points_{{0.0f, 0.0f, 0.0f}};
+
+  // Each AOI's clamped position from this update; reused between updates.
+  std::vector<Vector3f> area_of_interest_clamped_;
+  Vector3f area_of_interest_extents_min_{0.0f, 0.0f, 0.0f};
+  Vector3f area_of_interest_extents_max_{0.0f, 0.0f, 0.0f};
+  bool have_area_of_interest_extents_{};
+  auto ClampAreaOfInterest(const Vector3f& position, float radius) const
+      -> Vector3f;
 };
 
 }  // namespace ballistica
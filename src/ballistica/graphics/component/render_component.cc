@@ -37,29 +37,15 @@ void RenderComponent::ConfigForShadingDebugChecks(ShadingType shading_type) {
 #endif  // BA_DEBUG_BUILD
 
 void RenderComponent::TransformToBody(const RigidBody& b) {
-  dBodyID body = b.body();
-  dGeomID geom = b.geom();
-  const dReal* pos_in;
-  const dReal* r_in;
-  if (b.type() == RigidBody::Type::kBody) {
-    pos_in = dBodyGetPosition(body);
-    r_in = dBodyGetRotation(body);
-  } else {
-    pos_in = dGeomGetPosition(geom);
-    r_in = dGeomGetRotation(geom);
-  }
+  float matrix[16];
+  GetBodyMatrix(b, matrix);
+  MultMatrix(matrix);
+}
+
+void RenderComponent::GetBodyMatrix(const RigidBody& b, float* matrix) {
   float pos[3];
   float r[12];
-  for (int x = 0; x < 3; x++) {
-    pos[x] = pos_in[x];
-  }
-  pos[0] += b.blend_offset().x;
-  pos[1] += b.blend_offset().y;
-  pos[2] += b.blend_offset().z;
-  for (int x = 0; x < 12; x++) {
-    r[x] = r_in[x];
-  }
-  float matrix[16];
+  b.GetRenderState(pos, r);
   matrix[0] = r[0];
   matrix[1] = r[4];
   matrix[2] = r[8];
@@ -76,7 +62,13 @@ void RenderComponent::TransformToBody(const RigidBody& b) {
   matrix[13] = pos[1];
   matrix[14] = pos[2];
   matrix[15] = 1;
-  MultMatrix(matrix);
+}
+
+auto RenderComponent::IsBodyCulled(const RigidBody& b, float radius) -> bool {
+  float pos[3];
+  float r[12];
+  b.GetRenderState(pos, r);
+  return IsSphereCulled(Vector3f(pos), radius);
 }
 
 }  // namespace ballistica
@@ -20,6 +20,9 @@ class RenderComponent {
   }
   void DrawModel(ModelData* model, uint32_t flags = 0) {
     EnsureDrawing();
+    if (reflection_culled_) {
+      flags |= kModelDrawFlagNoReflection;
+    }
     cmd_buffer_->PutCommand(RenderCommandBuffer::Command::kDrawModel);
     cmd_buffer_->PutInt(flags);
     cmd_buffer_->PutModel(model);
@@ -29,6 +32,9 @@ class RenderComponent {
                           int flags = 0) {
     assert(!matrices.empty());
     EnsureDrawing();
+    if (reflection_culled_) {
+      flags |= kModelDrawFlagNoReflection;
+    }
     cmd_buffer_->PutCommand(RenderCommandBuffer::Command::kDrawModelInstanced);
     cmd_buffer_->PutInt(flags);
     cmd_buffer_->PutModel(model);
@@ -36,6 +42,9 @@ class RenderComponent {
   }
   void DrawMesh(Mesh* m, int flags = 0) {
     EnsureDrawing();
+    if (reflection_culled_) {
+      flags |= kModelDrawFlagNoReflection;
+    }
     if (m->IsValid()) {
       cmd_buffer_->frame_def()->AddMesh(m);
       cmd_buffer_->PutCommand(RenderCommandBuffer::Command::kDrawMesh);
@@ -120,6 +129,21 @@ class RenderComponent {
     cmd_buffer_->PutFloatArray16(t);
   }
   void TransformToBody(const RigidBody& b);
+
+  /// The matrix TransformToBody() applies for a body (16 floats).
+  static void GetBodyMatrix(const RigidBody& b, float* matrix);
+
+  // Returns true if a world-space bounding sphere for what we're about to
+  // draw lies completely out of view in our pass. Callers can then skip
+  // their draw calls (the component still needs to be submitted).
+  // If only its floor reflection is out of view, our subsequent draws
+  // skip the reflection.
+  auto IsSphereCulled(const Vector3f& center, float radius) -> bool {
+    return pass_->CullSphere(center, radius, &reflection_culled_);
+  }
+
+  // Same thing for a sphere around a body's interpolated render position.
+  auto IsBodyCulled(const RigidBody& b, float radius) -> bool;
 #if BA_VR_BUILD
   void VRTransformToRightHand() {
     EnsureDrawing();
@@ -255,6 +279,7 @@ class RenderComponent {
   RenderCommandBuffer* cmd_buffer_;
   State state_;
   RenderPass* pass_;
+  bool reflection_culled_{};  // Per our last IsSphereCulled() check.
 };
 
 }  // namespace ballistica
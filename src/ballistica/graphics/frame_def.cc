@@ -34,6 +34,8 @@ void FrameDef::Reset() {
   base_time_ = 0;
   base_time_elapsed_ = 0;
   frame_number_ = 0;
+  input_timestamp_ = 0;
+  control_input_timestamp_ = 0;
 
 #if BA_DEBUG_BUILD
   defining_component_ = false;
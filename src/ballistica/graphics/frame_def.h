@@ -122,6 +122,17 @@ class FrameDef {
   void set_base_time(millisecs_t val) { base_time_ = val; }
   void set_frame_number(int64_t val) { frame_number_ = val; }
 
+  // InputLatency stamps for the earliest input this frame is the first
+  // to reflect (0 if none).
+  auto input_timestamp() const -> int64_t { return input_timestamp_; }
+  void set_input_timestamp(int64_t val) { input_timestamp_ = val; }
+  auto control_input_timestamp() const -> int64_t {
+    return control_input_timestamp_;
+  }
+  void set_control_input_timestamp(int64_t val) {
+    control_input_timestamp_ = val;
+  }
+
   auto overlay_flat_pass() const -> RenderPass* {
     return overlay_flat_pass_.get();
   }
@@ -173,6 +184,8 @@ class FrameDef {
 
  private:
   bool needs_clear_{};
+  int64_t input_timestamp_{};
+  int64_t control_input_timestamp_{};
   BenchmarkType benchmark_type_{BenchmarkType::kNone};
   bool rendering_{};
   CameraMode camera_mode_{CameraMode::kFollow};
@@ -76,6 +76,9 @@ PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers = nullptr;
 PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer = nullptr;
 PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
 PFNGLBUFFERDATAPROC glBufferData = nullptr;
+PFNGLBUFFERSUBDATAPROC glBufferSubData = nullptr;
+PFNGLMAPBUFFERPROC glMapBuffer = nullptr;
+PFNGLUNMAPBUFFERPROC glUnmapBuffer = nullptr;
 PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage = nullptr;
 PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC glRenderbufferStorageMultisample =
     nullptr;
@@ -93,6 +96,17 @@ PFNGLGETSHADERIVPROC glGetShaderiv = nullptr;
 PFNGLGETPROGRAMIVPROC glGetProgramiv = nullptr;
 PFNGLDELETESHADERPROC glDeleteShader = nullptr;
 PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = nullptr;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstanced = nullptr;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisor = nullptr;
+PFNGLGETPROGRAMBINARYPROC glGetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC glProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC glProgramParameteri = nullptr;
+PFNGLGENQUERIESPROC glGenQueries = nullptr;
+PFNGLDELETEQUERIESPROC glDeleteQueries = nullptr;
+PFNGLBEGINQUERYPROC glBeginQuery = nullptr;
+PFNGLENDQUERYPROC glEndQuery = nullptr;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv = nullptr;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = nullptr;
 PFNGLDELETEBUFFERSPROC glDeleteBuffers = nullptr;
 PFNGLDELETEPROGRAMPROC glDeleteProgram = nullptr;
 PFNGLDETACHSHADERPROC glDetachShader = nullptr;
@@ -250,6 +264,9 @@ GLContext::GLContext(int target_res_x, int target_res_y, bool fullscreen)
   GET(PFNGLBINDRENDERBUFFERPROC, glBindRenderbuffer, true);
   GET(PFNGLBINDBUFFERPROC, glBindBuffer, true);
   GET(PFNGLBUFFERDATAPROC, glBufferData, true);
+  GET(PFNGLBUFFERSUBDATAPROC, glBufferSubData, true);
+  GET(PFNGLMAPBUFFERPROC, glMapBuffer, true);
+  GET(PFNGLUNMAPBUFFERPROC, glUnmapBuffer, true);
   GET(PFNGLRENDERBUFFERSTORAGEPROC, glRenderbufferStorage, true);
   GET(PFNGLFRAMEBUFFERRENDERBUFFERPROC, glFramebufferRenderbuffer, true);
   GET(PFNGLCHECKFRAMEBUFFERSTATUSPROC, glCheckFramebufferStatus, true);
@@ -274,9 +291,20 @@ GLContext::GLContext(int target_res_x, int target_res_y, bool fullscreen)
   GET(PFNGLBINDVERTEXARRAYPROC, glBindVertexArray, false);
   GET(PFNGLGENVERTEXARRAYSPROC, glGenVertexArrays, false);
   GET(PFNGLDELETEVERTEXARRAYSPROC, glDeleteVertexArrays, false);
+  GET(PFNGLDRAWELEMENTSINSTANCEDPROC, glDrawElementsInstanced, false);
+  GET(PFNGLVERTEXATTRIBDIVISORPROC, glVertexAttribDivisor, false);
   GET(PFNGLBLITFRAMEBUFFERPROC, glBlitFramebuffer, false);
   GET(PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC, glRenderbufferStorageMultisample,
       false);
+  GET(PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary, false);
+  GET(PFNGLPROGRAMBINARYPROC, glProgramBinary, false);
+  GET(PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri, false);
+  GET(PFNGLGENQUERIESPROC, glGenQueries, false);
+  GET(PFNGLDELETEQUERIESPROC, glDeleteQueries, false);
+  GET(PFNGLBEGINQUERYPROC, glBeginQuery, false);
+  GET(PFNGLENDQUERYPROC, glEndQuery, false);
+  GET(PFNGLGETQUERYOBJECTIVPROC, glGetQueryObjectiv, false);
+  GET(PFNGLGETQUERYOBJECTUI64VPROC, glGetQueryObjectui64v, false);
 
 #undef GET
 #endif  // BA_OSTYPE_WINDOWS
@@ -3,11 +3,17 @@
 #if BA_ENABLE_OPENGL
 #include "ballistica/graphics/gl/renderer_gl.h"
 
+#include <algorithm>
+#include <chrono>
+
+#include "ballistica/app/app_globals.h"
+#include "ballistica/core/event_trace.h"
 #include "ballistica/graphics/component/special_component.h"
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/graphics/mesh/mesh_renderer_data.h"
 #include "ballistica/media/data/texture_preload_data.h"
 #include "ballistica/media/data/texture_renderer_data.h"
+#include "ballistica/platform/platform.h"
 
 #if BA_OSTYPE_IOS_TVOS
 #include "ballistica/platform/apple/apple_utils.h"
@@ -37,6 +43,8 @@
 #define glGenVertexArrays glGenVertexArraysAPPLE
 #define glDeleteVertexArrays glDeleteVertexArraysAPPLE
 #define glBindVertexArray glBindVertexArrayAPPLE
+#define glDrawElementsInstanced glDrawElementsInstancedARB
+#define glVertexAttribDivisor glVertexAttribDivisorARB
 #endif  // BA_OSTYPE_MACOS
 
 #if BA_OSTYPE_IOS_TVOS
@@ -46,9 +54,62 @@ void (*glInvalidateFramebuffer)(GLenum target, GLsizei num_attachments,
 #define glGenVertexArrays glGenVertexArraysOES
 #define glDeleteVertexArrays glDeleteVertexArraysOES
 #define glBindVertexArray glBindVertexArrayOES
+#define glDrawElementsInstanced glDrawElementsInstancedEXT
+#define glVertexAttribDivisor glVertexAttribDivisorEXT
 #define glClearDepth glClearDepthf
 #endif  // BA_OSTYPE_IOS_TVOS
 
+// Linked programs can be saved out and reloaded on these platforms, which
+// saves us compiling and linking every shader at each launch.
+// (Apple's GL/ES2 variants don't give us the program binary calls).
+#if BA_OSTYPE_WINDOWS || BA_OSTYPE_LINUX || BA_OSTYPE_ANDROID
+#define ENABLE_PROGRAM_BINARY_CACHE 1
+#else
+#define ENABLE_PROGRAM_BINARY_CACHE 0
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+
+// Timer queries for profiling render passes come from ARB_timer_query
+// (core in GL 3.3) here. ES would need EXT_disjoint_timer_query and its
+// disjoint handling, which we don't currently bother with.
+#if BA_OSTYPE_WINDOWS || BA_OSTYPE_LINUX
+#define ENABLE_GPU_TIMERS 1
+#else
+#define ENABLE_GPU_TIMERS 0
+#endif
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+
+// Frame capture can read back through pixel-buffer-objects (core in GL
+// 2.1) so frames come back a frame late without stalling the pipeline.
+// ES2 doesn't have them so we fall back to plain blocking reads there.
+#if BA_OSTYPE_WINDOWS || BA_OSTYPE_LINUX || BA_OSTYPE_MACOS
+#define ENABLE_ASYNC_FRAME_CAPTURE 1
+#else
+#define ENABLE_ASYNC_FRAME_CAPTURE 0
+#endif
+
+// Bump this when the calibration workload changes so that existing results
+// get thrown out and measured again.
+const int kQualityCalibrationVersion = 1;
+
+// A quality tier passes calibration if its workload renders in this long
+// (median of a few frames). It's just the fill-heavy part of a frame so
+// we leave plenty of a 60hz frame for geometry, shadows and the cpu side.
+const float kQualityCalibrationTargetMilliseconds = 6.0f;
+const int kQualityCalibrationFrames = 5;
+
 // Turn this off to see how much blend overdraw is occurring.
 #define ENABLE_BLEND 1
 
@@ -122,6 +183,7 @@ bool RendererGL::draws_shields_funny_set_{};
 GLint g_combined_texture_image_unit_count{};
 bool g_anisotropic_support{};
 bool g_vao_support{};
+bool g_instancing_support{};
 float g_max_anisotropy{};
 bool g_discard_framebuffer_support{};
 bool g_invalidate_framebuffer_support{};
@@ -129,9 +191,24 @@ bool g_blit_framebuffer_support{};
 bool g_framebuffer_multisample_support{};
 bool g_running_es3{};
 bool g_seamless_cube_maps{};
+bool g_program_binary_support{};
+bool g_gpu_timer_support{};
 int g_msaa_max_samples_rgb565{};
 int g_msaa_max_samples_rgb8{};
 
+// Tiled GPUs can render multisampled straight into a single-sampled
+// texture, resolving on the way out of tile memory; no separate msaa
+// surface and no resolve blit. (We need the '2' version of the extension
+// since our camera target's depth is a texture too).
+bool g_msaa_render_to_texture_support{};
+int g_msaa_render_to_texture_max_samples{};
+#if BA_OSTYPE_ANDROID
+PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC
+    g_glFramebufferTexture2DMultisampleEXT{};
+PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC
+    g_glRenderbufferStorageMultisampleEXT{};
+#endif  // BA_OSTYPE_ANDROID
+
 #if BA_OSTYPE_ANDROID
 bool RendererGL::is_speedy_android_device_{};
 bool RendererGL::is_extra_speedy_android_device_{};
@@ -176,7 +253,8 @@ enum ShaderFlag {
   SHD_MASK_UV2 = 1 << 21,
   SHD_CONDITIONAL = 1 << 22,
   SHD_FLATNESS = 1 << 23,
-  SHD_DEPTH_BUG_TEST = 1 << 24
+  SHD_DEPTH_BUG_TEST = 1 << 24,
+  SHD_INSTANCED = 1 << 25
 };
 
 // Flags used internally by shaders.
@@ -194,7 +272,8 @@ enum ShaderPrivateFlags {
   PFLAG_USES_DIFFUSE_ATTR = 1 << 10,
   PFLAG_USES_CAM_ORIENT_MATRIX = 1 << 11,
   PFLAG_USES_MODEL_VIEW_MATRIX = 1 << 12,
-  PFLAG_USES_UV2_ATTR = 1 << 13
+  PFLAG_USES_UV2_ATTR = 1 << 13,
+  PFLAG_USES_INSTANCE_MATRIX_ATTR = 1 << 14
 };
 
 // Look for a gl extension prefixed by "GL_ARB", "GL_EXT", etc
@@ -422,6 +501,52 @@ void RendererGL::CheckGLExtensions() {
        && glBindVertexArray != nullptr
        && (g_running_es3 || CheckGLExtension(ex, "vertex_array_object")));
 
+  // Hardware instancing comes with ES3 or an extension pair elsewhere.
+  // We only bother with it alongside real VAOs.
+#if BA_OSTYPE_ANDROID
+  g_instancing_support = g_running_es3;
+#elif BA_OSTYPE_IOS_TVOS
+  g_instancing_support = CheckGLExtension(ex, "instanced_arrays");
+#else
+  g_instancing_support = (CheckGLExtension(ex, "instanced_arrays")
+                          && CheckGLExtension(ex, "draw_instanced"));
+#endif
+#if BA_OSTYPE_WINDOWS
+  g_instancing_support =
+      (g_instancing_support && glDrawElementsInstanced != nullptr
+       && glVertexAttribDivisor != nullptr);
+#endif
+
+  // Program binaries come with ES3 or GL 4.1 (or the extension elsewhere).
+  // Drivers are free to support zero formats, in which case we can't save
+  // anything.
+#if ENABLE_PROGRAM_BINARY_CACHE
+  g_program_binary_support =
+      (g_running_es3 || CheckGLExtension(ex, "get_program_binary"));
+#if BA_OSTYPE_WINDOWS
+  g_program_binary_support =
+      (g_program_binary_support && glGetProgramBinary != nullptr
+       && glProgramBinary != nullptr && glProgramParameteri != nullptr);
+#endif
+  if (g_program_binary_support) {
+    GLint format_count{};
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    g_program_binary_support = (format_count > 0);
+  }
+  DEBUG_CHECK_GL_ERROR;
+#endif  // ENABLE_PROGRAM_BINARY_CACHE
+
+#if ENABLE_GPU_TIMERS
+  g_gpu_timer_support = CheckGLExtension(ex, "timer_query");
+#if BA_OSTYPE_WINDOWS
+  g_gpu_timer_support =
+      (g_gpu_timer_support && glGenQueries != nullptr
+       && glDeleteQueries != nullptr && glBeginQuery != nullptr
+       && glEndQuery != nullptr && glGetQueryObjectiv != nullptr
+       && glGetQueryObjectui64v != nullptr);
+#endif
+#endif  // ENABLE_GPU_TIMERS
+
 #if BA_OSTYPE_IOS_TVOS
   g_blit_framebuffer_support = false;
   g_framebuffer_multisample_support = false;
@@ -476,6 +601,10 @@ void RendererGL::CheckGLExtensions() {
   }
 #endif
 
+  if (!g_vao_support) {
+    g_instancing_support = false;
+  }
+
   glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS,
                 &g_combined_texture_image_unit_count);
 
@@ -535,6 +664,25 @@ void RendererGL::CheckGLExtensions() {
     }
   }
 
+#if BA_OSTYPE_ANDROID
+  g_msaa_render_to_texture_support = false;
+  g_msaa_render_to_texture_max_samples = 0;
+  if (CheckGLExtension(ex, "multisampled_render_to_texture2")) {
+    g_glFramebufferTexture2DMultisampleEXT =
+        (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC)eglGetProcAddress(
+            "glFramebufferTexture2DMultisampleEXT");
+    g_glRenderbufferStorageMultisampleEXT =
+        (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)eglGetProcAddress(
+            "glRenderbufferStorageMultisampleEXT");
+    if (g_glFramebufferTexture2DMultisampleEXT != nullptr
+        && g_glRenderbufferStorageMultisampleEXT != nullptr) {
+      glGetIntegerv(GL_MAX_SAMPLES_EXT, &g_msaa_render_to_texture_max_samples);
+      g_msaa_render_to_texture_support =
+          (g_msaa_render_to_texture_max_samples > 1);
+    }
+  }
+#endif  // BA_OSTYPE_ANDROID
+
 #if MSAA_ERROR_TEST
   if (enable_msaa_) {
     ScreenMessage("MSAA ENABLED");
@@ -590,11 +738,22 @@ void RendererGL::UpdateMSAAEnabled() {
     enable_msaa_ = false;
   }
 
+  // Implicit resolves don't blit at all, so anything offering them is fair
+  // game.
+  if (g_msaa_render_to_texture_support) {
+    enable_msaa_ = (screen_render_target()->physical_height()
+                    <= static_cast<float>(max_msaa_res));
+  }
+
 #endif  // BA_RIFT_BUILD
 }
 
 auto RendererGL::IsMSAAEnabled() const -> bool { return enable_msaa_; }
 
+auto RendererGL::IsMSAAResolveImplicit() const -> bool {
+  return enable_msaa_ && g_msaa_render_to_texture_support;
+}
+
 static auto GetGLTextureFormat(TextureFormat f) -> GLenum {
   switch (f) {
     case TextureFormat::kDXT1:
@@ -732,13 +891,15 @@ class RendererGL::FramebufferObjectGL : public Framebuffer {
     if (force_low_quality) do_high_quality = false;
     int samples = 0;
     if (msaa_) {
-      // Can't multisample with texture buffers currently.
-      assert(!is_texture_ && !depth_is_texture_);
-
       int target_samples =
           renderer_->GetMSAASamplesForFramebuffer(width_, height_);
 
-      if (do_high_quality) {
+      // Texture buffers can only multisample with implicit resolves.
+      if (is_texture_ || depth_is_texture_) {
+        assert(g_msaa_render_to_texture_support);
+        samples =
+            std::min(target_samples, g_msaa_render_to_texture_max_samples);
+      } else if (do_high_quality) {
         samples = std::min(target_samples, g_msaa_max_samples_rgb8);
       } else {
         samples = std::min(target_samples, g_msaa_max_samples_rgb565);
@@ -775,8 +936,7 @@ class RendererGL::FramebufferObjectGL : public Framebuffer {
       glTexImage2D(GL_TEXTURE_2D, 0, alpha_ ? GL_RGBA : GL_RGB, width_, height_,
                    0, alpha_ ? GL_RGBA : GL_RGB, format, nullptr);
       // }
-      glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                             GL_TEXTURE_2D, texture_, 0);
+      AttachTexture(GL_COLOR_ATTACHMENT0, texture_, samples);
     } else {
       // Regular renderbuffer.
       assert(!alpha_);  // fixme
@@ -839,8 +999,7 @@ class RendererGL::FramebufferObjectGL : public Framebuffer {
 
         DEBUG_CHECK_GL_ERROR;
 
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
-                               GL_TEXTURE_2D, depth_texture_, 0);
+        AttachTexture(GL_DEPTH_ATTACHMENT, depth_texture_, samples);
 
         DEBUG_CHECK_GL_ERROR;
       } else {
@@ -863,10 +1022,19 @@ class RendererGL::FramebufferObjectGL : public Framebuffer {
           do24 = do_high_quality;
 #endif
 
-          glRenderbufferStorageMultisample(
-              GL_RENDERBUFFER, samples,
-              do24 ? GL_DEPTH_COMPONENT24 : GL_DEPTH_COMPONENT16, width_,
-              height_);
+#if BA_OSTYPE_ANDROID
+          // Alongside an implicitly-resolved texture this has to be an
+          // implicit one too; it then never leaves tile memory at all.
+          decltype(g_glRenderbufferStorageMultisampleEXT) storage_multisample =
+              is_texture_ ? g_glRenderbufferStorageMultisampleEXT
+                          : glRenderbufferStorageMultisample;
+#else
+          auto storage_multisample = glRenderbufferStorageMultisample;
+#endif  // BA_OSTYPE_ANDROID
+          storage_multisample(GL_RENDERBUFFER, samples,
+                              do24 ? GL_DEPTH_COMPONENT24
+                                   : GL_DEPTH_COMPONENT16,
+                              width_, height_);
           // (do_high_quality &&
           // g_running_es3)?GL_DEPTH_COMPONENT24:GL_DEPTH_COMPONENT16, _width,
           // _height);
@@ -918,6 +1086,22 @@ class RendererGL::FramebufferObjectGL : public Framebuffer {
     loaded_ = true;
   }
 
+  // Attach a texture to our framebuffer, multisampled with implicit
+  // resolve if samples is nonzero.
+  void AttachTexture(GLenum attachment, GLuint texture, int samples) {
+#if BA_OSTYPE_ANDROID
+    if (samples > 0) {
+      g_glFramebufferTexture2DMultisampleEXT(GL_FRAMEBUFFER, attachment,
+                                             GL_TEXTURE_2D, texture, 0,
+                                             samples);
+      return;
+    }
+#endif  // BA_OSTYPE_ANDROID
+    assert(samples == 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture,
+                           0);
+  }
+
   void Unload() {
     assert(InGraphicsThread());
     if (!loaded_) return;
@@ -1004,14 +1188,35 @@ class RendererGL::ShaderGL : public Object {
     return ThreadIdentifier::kMain;
   }
 
-  ShaderGL(GLenum type_in, const std::string& src_in) : type_(type_in) {
+  // Note that we don't compile until someone asks for our shader; programs
+  // loaded from the binary cache never need to.
+  ShaderGL(GLenum type_in, std::string src_in)
+      : type_(type_in), src_(std::move(src_in)) {
+    assert(type_ == GL_FRAGMENT_SHADER || type_ == GL_VERTEX_SHADER);
+  }
+  ~ShaderGL() override {
+    assert(InGraphicsThread());
+    if (shader_ && !g_graphics_server->renderer_context_lost()) {
+      glDeleteShader(shader_);
+      DEBUG_CHECK_GL_ERROR;
+    }
+  }
+  auto shader() -> GLuint {
+    if (!shader_) {
+      Compile();
+    }
+    return shader_;
+  }
+  auto source() const -> const std::string& { return src_; }
+
+ private:
+  void Compile() {
     assert(InGraphicsThread());
     DEBUG_CHECK_GL_ERROR;
-    assert(type_ == GL_FRAGMENT_SHADER || type_ == GL_VERTEX_SHADER);
     shader_ = glCreateShader(type_);
     DEBUG_CHECK_GL_ERROR;
     BA_PRECONDITION(shader_);
-    const char* s = src_in.c_str();
+    const char* s = src_.c_str();
     glShaderSource(shader_, 1, &s, nullptr);
     glCompileShader(shader_);
     GLint compile_status;
@@ -1023,7 +1228,7 @@ class RendererGL::ShaderGL : public Object {
       // Let's not crash here. We have a better chance of calling home this way
       // and theres a chance the game will still be playable.
       Log(std::string("Compile failed for ") + GetTypeName()
-          + " shader:\n------------SOURCE BEGIN-------------\n" + src_in
+          + " shader:\n------------SOURCE BEGIN-------------\n" + src_
           + "\n-----------SOURCE END-------------\n" + GetInfo()
           + "\nrenderer: " + renderer + "\nvendor: " + vendor
           + "\nversion:" + version);
@@ -1038,23 +1243,13 @@ class RendererGL::ShaderGL : public Object {
         const char* vendor = (const char*)glGetString(GL_VENDOR);
         const char* renderer = (const char*)glGetString(GL_RENDERER);
         Log(std::string("WARNING: info returned for ") + GetTypeName()
-            + " shader:\n------------SOURCE BEGIN-------------\n" + src_in
+            + " shader:\n------------SOURCE BEGIN-------------\n" + src_
             + "\n-----------SOURCE END-------------\n" + info + "\nrenderer: "
             + renderer + "\nvendor: " + vendor + "\nversion:" + version);
       }
     }
     DEBUG_CHECK_GL_ERROR;
   }
-  ~ShaderGL() override {
-    assert(InGraphicsThread());
-    if (!g_graphics_server->renderer_context_lost()) {
-      glDeleteShader(shader_);
-      DEBUG_CHECK_GL_ERROR;
-    }
-  }
-  auto shader() const -> GLuint { return shader_; }
-
- private:
   auto GetTypeName() const -> const char* {
     if (type_ == GL_VERTEX_SHADER) {
       return "vertex";
@@ -1068,9 +1263,9 @@ class RendererGL::ShaderGL : public Object {
     glGetShaderInfoLog(shader_, sizeof(log), &log_size, log);
     return log;
   }
-  std::string name_;
-  GLuint shader_{};
   GLenum type_{};
+  std::string src_;
+  GLuint shader_{};
   BA_DISALLOW_CLASS_COPIES(ShaderGL);
 };  // ShaderGL
 
@@ -1107,40 +1302,13 @@ class RendererGL::ProgramGL {
     DEBUG_CHECK_GL_ERROR;
     program_ = glCreateProgram();
     BA_PRECONDITION(program_);
-    glAttachShader(program_, fragment_shader_->shader());
-    glAttachShader(program_, vertex_shader_->shader());
-    assert(pflags_ & PFLAG_USES_POSITION_ATTR);
-    if (pflags_ & PFLAG_USES_POSITION_ATTR)
-      glBindAttribLocation(program_, kVertexAttrPosition, "position");
-    if (pflags_ & PFLAG_USES_UV_ATTR)
-      glBindAttribLocation(program_, kVertexAttrUV, "uv");
-    if (pflags_ & PFLAG_USES_NORMAL_ATTR)
-      glBindAttribLocation(program_, kVertexAttrNormal, "normal");
-    if (pflags_ & PFLAG_USES_ERODE_ATTR)
-      glBindAttribLocation(program_, kVertexAttrErode, "erode");
-    if (pflags_ & PFLAG_USES_COLOR_ATTR)
-      glBindAttribLocation(program_, kVertexAttrColor, "color");
-    if (pflags_ & PFLAG_USES_SIZE_ATTR)
-      glBindAttribLocation(program_, kVertexAttrSize, "size");
-    if (pflags_ & PFLAG_USES_DIFFUSE_ATTR)
-      glBindAttribLocation(program_, kVertexAttrDiffuse, "diffuse");
-    if (pflags_ & PFLAG_USES_UV2_ATTR)
-      glBindAttribLocation(program_, kVertexAttrUV2, "uv2");
-    glLinkProgram(program_);
-    GLint linkStatus;
-    glGetProgramiv(program_, GL_LINK_STATUS, &linkStatus);
-    if (linkStatus == GL_FALSE) {
-      Log("Link failed for program '" + name_ + "':\n" + GetInfo());
-    } else {
-      assert(linkStatus == GL_TRUE);
 
-      std::string info = GetInfo();
-      if (!info.empty()
-          && (strstr(info.c_str(), "error:") || strstr(info.c_str(), "warning:")
-              || strstr(info.c_str(), "Error:")
-              || strstr(info.c_str(), "Warning:"))) {
-        Log("WARNING: program using frag shader '" + name_
-            + "' returned info:\n" + info);
+    // If we've linked this exact program on this exact driver before,
+    // just hand the driver back what it gave us last time.
+    std::string cache_path = GetBinaryCachePath();
+    if (cache_path.empty() || !LoadBinary(cache_path)) {
+      if (Link() && !cache_path.empty()) {
+        SaveBinary(cache_path);
       }
     }
 
@@ -1178,8 +1346,10 @@ class RendererGL::ProgramGL {
   virtual ~ProgramGL() {
     assert(InGraphicsThread());
     if (!g_graphics_server->renderer_context_lost()) {
-      glDetachShader(program_, fragment_shader_->shader());
-      glDetachShader(program_, vertex_shader_->shader());
+      if (shaders_attached_) {
+        glDetachShader(program_, fragment_shader_->shader());
+        glDetachShader(program_, vertex_shader_->shader());
+      }
       glDeleteProgram(program_);
       DEBUG_CHECK_GL_ERROR;
     }
@@ -1206,8 +1376,9 @@ class RendererGL::ProgramGL {
     uint32_t mvpState = g_graphics_server->GetModelViewProjectionMatrixState();
     if (mvpState != mvp_state_) {
       mvp_state_ = mvpState;
-      glUniformMatrix4fv(mvp_uniform_, 1, 0,
-                         g_graphics_server->GetModelViewProjectionMatrix().m);
+      UpdateMatrixUniform(mvp_uniform_,
+                          g_graphics_server->GetModelViewProjectionMatrix(),
+                          &mvp_value_);
     }
     DEBUG_CHECK_GL_ERROR;
 
@@ -1218,8 +1389,9 @@ class RendererGL::ProgramGL {
       uint32_t state = g_graphics_server->GetModelWorldMatrixState();
       if (state != model_world_matrix_state_) {
         model_world_matrix_state_ = state;
-        glUniformMatrix4fv(model_world_matrix_uniform_, 1, 0,
-                           g_graphics_server->GetModelWorldMatrix().m);
+        UpdateMatrixUniform(model_world_matrix_uniform_,
+                            g_graphics_server->GetModelWorldMatrix(),
+                            &model_world_matrix_value_);
       }
     }
     DEBUG_CHECK_GL_ERROR;
@@ -1232,8 +1404,9 @@ class RendererGL::ProgramGL {
       uint32_t state = g_graphics_server->GetModelViewProjectionMatrixState();
       if (state != model_view_matrix_state_) {
         model_view_matrix_state_ = state;
-        glUniformMatrix4fv(model_view_matrix_uniform_, 1, 0,
-                           g_graphics_server->model_view_matrix().m);
+        UpdateMatrixUniform(model_view_matrix_uniform_,
+                            g_graphics_server->model_view_matrix(),
+                            &model_view_matrix_value_);
       }
     }
     DEBUG_CHECK_GL_ERROR;
@@ -1243,7 +1416,11 @@ class RendererGL::ProgramGL {
       if (state != cam_pos_state_) {
         cam_pos_state_ = state;
         const Vector3f& p(g_graphics_server->cam_pos());
-        glUniform4f(cam_pos_uniform_, p.x, p.y, p.z, 1.0f);
+        if (p.x != cam_pos_value_.x || p.y != cam_pos_value_.y
+            || p.z != cam_pos_value_.z) {
+          cam_pos_value_ = p;
+          glUniform4f(cam_pos_uniform_, p.x, p.y, p.z, 1.0f);
+        }
       }
     }
     DEBUG_CHECK_GL_ERROR;
@@ -1252,8 +1429,9 @@ class RendererGL::ProgramGL {
       uint32_t state = g_graphics_server->GetCamOrientMatrixState();
       if (state != cam_orient_matrix_state_) {
         cam_orient_matrix_state_ = state;
-        glUniformMatrix4fv(cam_orient_matrix_uniform_, 1, 0,
-                           g_graphics_server->GetCamOrientMatrix().m);
+        UpdateMatrixUniform(cam_orient_matrix_uniform_,
+                            g_graphics_server->GetCamOrientMatrix(),
+                            &cam_orient_matrix_value_);
       }
     }
     DEBUG_CHECK_GL_ERROR;
@@ -1263,9 +1441,10 @@ class RendererGL::ProgramGL {
           g_graphics_server->light_shadow_projection_matrix_state();
       if (state != light_shadow_projection_matrix_state_) {
         light_shadow_projection_matrix_state_ = state;
-        glUniformMatrix4fv(
-            light_shadow_projection_matrix_uniform_, 1, 0,
-            g_graphics_server->light_shadow_projection_matrix().m);
+        UpdateMatrixUniform(
+            light_shadow_projection_matrix_uniform_,
+            g_graphics_server->light_shadow_projection_matrix(),
+            &light_shadow_projection_matrix_value_);
       }
     }
     DEBUG_CHECK_GL_ERROR;
@@ -1296,12 +1475,197 @@ class RendererGL::ProgramGL {
   auto renderer() const -> RendererGL* { return renderer_; }
 
  private:
+  // The graphics-server state counters bump whenever a matrix is touched,
+  // even if it winds up where it was (pushes/pops around each draw, etc.),
+  // so we also hold on to the last values we sent and skip re-uploading
+  // identical ones. (Caches start zeroed, which matches GL's initial
+  // uniform values).
+  static void UpdateMatrixUniform(GLint location, const Matrix44f& m,
+                                  Matrix44f* cache) {
+    if (memcmp(m.m, cache->m, sizeof(m.m)) != 0) {
+      *cache = m;
+      glUniformMatrix4fv(location, 1, 0, m.m);
+    }
+  }
+
+  // Attach our shaders (compiling them if need be) and link.
+  auto Link() -> bool {
+    glAttachShader(program_, fragment_shader_->shader());
+    glAttachShader(program_, vertex_shader_->shader());
+    shaders_attached_ = true;
+    assert(pflags_ & PFLAG_USES_POSITION_ATTR);
+    if (pflags_ & PFLAG_USES_POSITION_ATTR)
+      glBindAttribLocation(program_, kVertexAttrPosition, "position");
+    if (pflags_ & PFLAG_USES_UV_ATTR)
+      glBindAttribLocation(program_, kVertexAttrUV, "uv");
+    if (pflags_ & PFLAG_USES_NORMAL_ATTR)
+      glBindAttribLocation(program_, kVertexAttrNormal, "normal");
+    if (pflags_ & PFLAG_USES_ERODE_ATTR)
+      glBindAttribLocation(program_, kVertexAttrErode, "erode");
+    if (pflags_ & PFLAG_USES_COLOR_ATTR)
+      glBindAttribLocation(program_, kVertexAttrColor, "color");
+    if (pflags_ & PFLAG_USES_SIZE_ATTR)
+      glBindAttribLocation(program_, kVertexAttrSize, "size");
+    if (pflags_ & PFLAG_USES_DIFFUSE_ATTR)
+      glBindAttribLocation(program_, kVertexAttrDiffuse, "diffuse");
+    if (pflags_ & PFLAG_USES_UV2_ATTR)
+      glBindAttribLocation(program_, kVertexAttrUV2, "uv2");
+    if (pflags_ & PFLAG_USES_INSTANCE_MATRIX_ATTR) {
+      for (GLuint i = 0; i < 4; i++) {
+        glBindAttribLocation(program_, kVertexAttrInstanceMatrix + i,
+                             ("instanceMatrix" + std::to_string(i)).c_str());
+      }
+    }
+#if ENABLE_PROGRAM_BINARY_CACHE
+    if (g_program_binary_support) {
+      glProgramParameteri(program_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                          GL_TRUE);
+    }
+#endif
+    glLinkProgram(program_);
+    GLint linkStatus;
+    glGetProgramiv(program_, GL_LINK_STATUS, &linkStatus);
+    if (linkStatus == GL_FALSE) {
+      Log("Link failed for program '" + name_ + "':\n" + GetInfo());
+      return false;
+    } else {
+      assert(linkStatus == GL_TRUE);
+
+      std::string info = GetInfo();
+      if (!info.empty()
+          && (strstr(info.c_str(), "error:") || strstr(info.c_str(), "warning:")
+              || strstr(info.c_str(), "Error:")
+              || strstr(info.c_str(), "Warning:"))) {
+        Log("WARNING: program using frag shader '" + name_
+            + "' returned info:\n" + info);
+      }
+    }
+    return true;
+  }
+
+  // Returns where a binary for this program on this driver would live, or
+  // an empty string if we can't do binaries here. The driver strings and
+  // our full source go into the key so a driver update or shader change
+  // simply misses the cache.
+  auto GetBinaryCachePath() -> std::string {
+#if ENABLE_PROGRAM_BINARY_CACHE
+    if (!g_program_binary_support) {
+      return "";
+    }
+    static std::string cache_dir;
+    if (cache_dir.empty()) {
+      cache_dir = g_platform->GetConfigDirectory() + BA_DIRSLASH + "glcache";
+      g_platform->MakeDir(cache_dir, true);
+    }
+    auto gl_str = [](GLenum name) -> std::string {
+      auto* val = reinterpret_cast<const char*>(glGetString(name));
+      return val ? val : "";
+    };
+    std::string key = gl_str(GL_VENDOR) + "\n" + gl_str(GL_RENDERER) + "\n"
+                      + gl_str(GL_VERSION) + "\n" + std::to_string(pflags_)
+                      + "\n" + vertex_shader_->source() + "\n"
+                      + fragment_shader_->source();
+    binary_key_size_ = static_cast<uint32_t>(key.size());
+    char hash[32];
+    snprintf(hash, sizeof(hash), "%016llx",
+             static_cast<unsigned long long>(  // NOLINT
+                 std::hash<std::string>{}(key)));
+    return cache_dir + BA_DIRSLASH + name_ + "_" + hash + ".bin";
+#else
+    return "";
+#endif
+  }
+
+  struct BinaryHeader {
+    uint32_t magic;
+    uint32_t key_size;
+    uint32_t format;
+    uint32_t length;
+  };
+  static const uint32_t kBinaryMagic = 0x42414750;
+
+  auto LoadBinary(const std::string& path) -> bool {
+#if ENABLE_PROGRAM_BINARY_CACHE
+    FILE* f = g_platform->FOpen(path.c_str(), "rb");
+    if (!f) {
+      return false;
+    }
+    BinaryHeader header{};
+    std::vector<char> data;
+    bool read_ok = (fread(&header, sizeof(header), 1, f) == 1
+                    && header.magic == kBinaryMagic
+                    && header.key_size == binary_key_size_
+                    && header.length > 0);
+    if (read_ok) {
+      data.resize(header.length);
+      read_ok = (fread(data.data(), header.length, 1, f) == 1);
+    }
+    fclose(f);
+    if (!read_ok) {
+      return false;
+    }
+    glProgramBinary(program_, header.format, data.data(),
+                    static_cast<GLsizei>(data.size()));
+
+    // Drivers are allowed to reject binaries for any reason they like;
+    // that's fine, we just build it the old fashioned way instead.
+    GLint link_status{};
+    glGetProgramiv(program_, GL_LINK_STATUS, &link_status);
+    if (link_status != GL_TRUE) {
+      while (glGetError() != GL_NO_ERROR) {
+      }
+      return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void SaveBinary(const std::string& path) {
+#if ENABLE_PROGRAM_BINARY_CACHE
+    GLint length{};
+    glGetProgramiv(program_, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+      return;
+    }
+    std::vector<char> data(static_cast<size_t>(length));
+    GLenum format{};
+    GLsizei written{};
+    glGetProgramBinary(program_, length, &written, &format, data.data());
+    DEBUG_CHECK_GL_ERROR;
+    if (written <= 0) {
+      return;
+    }
+    BinaryHeader header{kBinaryMagic, binary_key_size_,
+                        static_cast<uint32_t>(format),
+                        static_cast<uint32_t>(written)};
+
+    // Write to a temp file and move it into place so a crash mid-write
+    // can't leave a truncated binary for next time.
+    std::string tmp_path = path + ".tmp";
+    FILE* f = g_platform->FOpen(tmp_path.c_str(), "wb");
+    if (!f) {
+      return;
+    }
+    bool write_ok = (fwrite(&header, sizeof(header), 1, f) == 1
+                     && fwrite(data.data(), static_cast<size_t>(written), 1, f)
+                            == 1);
+    fclose(f);
+    if (!write_ok || g_platform->Rename(tmp_path.c_str(), path.c_str()) != 0) {
+      g_platform->Unlink(tmp_path.c_str());
+    }
+#endif
+  }
+
   RendererGL* renderer_{};
   Object::Ref<FragmentShaderGL> fragment_shader_;
   Object::Ref<VertexShaderGL> vertex_shader_;
   std::string name_;
   GLuint program_{};
   int pflags_{};
+  bool shaders_attached_{};
+  uint32_t binary_key_size_{};
   uint32_t mvp_state_{};
   GLint mvp_uniform_{};
   GLint model_world_matrix_uniform_{};
@@ -1314,6 +1678,12 @@ class RendererGL::ProgramGL {
   uint32_t cam_pos_state_{};
   GLint cam_orient_matrix_uniform_{};
   GLuint cam_orient_matrix_state_{};
+  Matrix44f mvp_value_{};
+  Matrix44f model_world_matrix_value_{};
+  Matrix44f model_view_matrix_value_{};
+  Matrix44f cam_orient_matrix_value_{};
+  Matrix44f light_shadow_projection_matrix_value_{};
+  Vector3f cam_pos_value_{-9999.0f, -9999.0f, -9999.0f};
   BA_DISALLOW_CLASS_COPIES(ProgramGL);
 };  // ProgramGL
 
@@ -1778,7 +2148,59 @@ class RendererGL::ObjectProgramGL : public RendererGL::ProgramGL {
     renderer()->BindTexture(GL_TEXTURE_2D, t, kColorizeTexUnit);
   }
 
+  // Returns a variant of us that takes its model matrix per-instance from
+  // vertex attrs, bound and with our current uniform values applied.
+  // (created on first use; requires hardware instancing support)
+  auto BindInstancedVariant() -> ObjectProgramGL* {
+    assert(g_instancing_support);
+    assert(!(flags_ & (SHD_INSTANCED | SHD_WORLD_SPACE_PTS)));
+    if (!instanced_variant_) {
+      instanced_variant_ =
+          std::make_unique<ObjectProgramGL>(renderer(), flags_ | SHD_INSTANCED);
+    }
+    instanced_variant_->Bind();
+    instanced_variant_->SyncUniforms(*this);
+    return instanced_variant_.get();
+  }
+
  private:
+  // Copy already-tinted uniform values straight across from another variant.
+  void SyncUniforms(const ObjectProgramGL& o) {
+    assert(IsBound());
+    if (o.r_ != r_ || o.g_ != g_ || o.b_ != b_ || o.a_ != a_) {
+      r_ = o.r_;
+      g_ = o.g_;
+      b_ = o.b_;
+      a_ = o.a_;
+      glUniform4f(color_location_, r_, g_, b_, a_);
+    }
+    if ((flags_ & SHD_ADD)
+        && (o.add_r_ != add_r_ || o.add_g_ != add_g_ || o.add_b_ != add_b_)) {
+      add_r_ = o.add_r_;
+      add_g_ = o.add_g_;
+      add_b_ = o.add_b_;
+      glUniform4f(color_add_location_, add_r_, add_g_, add_b_, 0.0f);
+    }
+    if ((flags_ & SHD_REFLECTION)
+        && (o.r_mult_r_ != r_mult_r_ || o.r_mult_g_ != r_mult_g_
+            || o.r_mult_b_ != r_mult_b_ || o.r_mult_a_ != r_mult_a_)) {
+      r_mult_r_ = o.r_mult_r_;
+      r_mult_g_ = o.r_mult_g_;
+      r_mult_b_ = o.r_mult_b_;
+      r_mult_a_ = o.r_mult_a_;
+      glUniform4f(reflect_mult_location_, r_mult_r_, r_mult_g_, r_mult_b_,
+                  r_mult_a_);
+    }
+    if (flags_ & SHD_COLORIZE) {
+      SetColorizeColor(o.colorize_r_, o.colorize_g_, o.colorize_b_,
+                       o.colorize_a_);
+    }
+    if (flags_ & SHD_COLORIZE2) {
+      SetColorize2Color(o.colorize2_r_, o.colorize2_g_, o.colorize2_b_,
+                        o.colorize2_a_);
+    }
+  }
+
   auto GetName(int flags) -> std::string {
     return std::string("ObjectProgramGL")
            + " reflect:" + std::to_string((flags & SHD_REFLECTION) != 0)
@@ -1787,7 +2209,8 @@ class RendererGL::ObjectProgramGL : public RendererGL::ProgramGL {
            + std::to_string((flags & SHD_COLORIZE) != 0) + " colorize2:"
            + std::to_string((flags & SHD_COLORIZE2) != 0) + " transparent:"
            + std::to_string((flags & SHD_OBJ_TRANSPARENT) != 0) + " worldSpace:"
-           + std::to_string((flags & SHD_WORLD_SPACE_PTS) != 0);
+           + std::to_string((flags & SHD_WORLD_SPACE_PTS) != 0) + " instanced:"
+           + std::to_string((flags & SHD_INSTANCED) != 0);
   }
   auto GetPFlags(int flags) -> int {
     int pflags = PFLAG_USES_POSITION_ATTR | PFLAG_USES_UV_ATTR;
@@ -1798,10 +2221,18 @@ class RendererGL::ObjectProgramGL : public RendererGL::ProgramGL {
       pflags |= PFLAG_USES_MODEL_WORLD_MATRIX;
     if (flags & SHD_LIGHT_SHADOW) pflags |= PFLAG_USES_SHADOW_PROJECTION_MATRIX;
     if (flags & SHD_WORLD_SPACE_PTS) pflags |= PFLAG_WORLD_SPACE_PTS;
+    if (flags & SHD_INSTANCED) pflags |= PFLAG_USES_INSTANCE_MATRIX_ATTR;
     return pflags;
   }
   auto GetVertexCode(int flags) -> std::string {
     std::string s;
+
+    // With instancing, points and normals go through the per-instance
+    // matrix before anything else.
+    bool instanced = (flags & SHD_INSTANCED) != 0;
+    std::string pos = instanced ? "instancePos" : "position";
+    std::string nrm = instanced ? "(instanceMatrix * vec4(normal,0.0))"
+                                : "vec4(normal,0.0)";
     s = "uniform mat4 modelViewProjectionMatrix;\n"
         "uniform vec4 camPos;\n"
         "attribute vec4 position;\n"
@@ -1819,16 +2250,25 @@ class RendererGL::ObjectProgramGL : public RendererGL::ProgramGL {
     if (flags & SHD_LIGHT_SHADOW)
       s += "uniform mat4 lightShadowProjectionMatrix;\n"
            "varying " MEDIUMP "vec4 vLightShadowUV;\n";
+    if (instanced)
+      s += "attribute vec4 instanceMatrix0;\n"
+           "attribute vec4 instanceMatrix1;\n"
+           "attribute vec4 instanceMatrix2;\n"
+           "attribute vec4 instanceMatrix3;\n";
+    s += "void main() {\n";
+    if (instanced)
+      s += "   mat4 instanceMatrix = mat4(instanceMatrix0, instanceMatrix1,"
+           " instanceMatrix2, instanceMatrix3);\n"
+           "   vec4 instancePos = instanceMatrix*position;\n";
     s +=
-        "void main() {\n"
         "   vUV = uv;\n"
-        "   gl_Position = modelViewProjectionMatrix*position;\n"
+        "   gl_Position = modelViewProjectionMatrix*" + pos + ";\n"
         "   vScreenCoord = vec4(gl_Position.xy/gl_Position.w,gl_Position.zw);\n"
         "   vScreenCoord.xy += vec2(1.0);\n"
         "   vScreenCoord.xy *= vec2(0.5*vScreenCoord.w);\n";
     if (((flags & SHD_LIGHT_SHADOW) || (flags & SHD_REFLECTION))
         && !(flags & SHD_WORLD_SPACE_PTS)) {
-      s += "   vec4 worldPos = modelWorldMatrix*position;\n";
+      s += "   vec4 worldPos = modelWorldMatrix*" + pos + ";\n";
     }
     if (flags & SHD_LIGHT_SHADOW) {
       if (flags & SHD_WORLD_SPACE_PTS)
@@ -1841,7 +2281,8 @@ class RendererGL::ObjectProgramGL : public RendererGL::ProgramGL {
         s += "   vReflect = reflect(vec3(position - camPos),normal);\n";
       else
         s += "   vReflect = reflect(vec3(worldPos - "
-             "camPos),normalize(vec3(modelWorldMatrix * vec4(normal,0.0))));\n";
+             "camPos),normalize(vec3(modelWorldMatrix * "
+             + nrm + ")));\n";
     }
     s += "}";
     if (flags & SHD_DEBUG_PRINT)
@@ -1931,6 +2372,7 @@ class RendererGL::ObjectProgramGL : public RendererGL::ProgramGL {
   GLint color_add_location_;
   GLint reflect_mult_location_;
   int flags_;
+  std::unique_ptr<ObjectProgramGL> instanced_variant_;
 };  // ObjectProgramGL
 
 class RendererGL::SmokeProgramGL : public RendererGL::ProgramGL {
@@ -3166,6 +3608,7 @@ void RendererGL::BindTexture(GLuint type, GLuint tex, GLuint tex_unit) {
       if (tex != bound_textures_2d_[tex_unit]) {
         BindTextureUnit(tex_unit);
         glBindTexture(type, tex);
+        state_change_counts_.textures++;
         bound_textures_2d_[tex_unit] = tex;
       }
       break;
@@ -3174,6 +3617,7 @@ void RendererGL::BindTexture(GLuint type, GLuint tex, GLuint tex_unit) {
       if (tex != bound_textures_cube_map_[tex_unit]) {
         BindTextureUnit(tex_unit);
         glBindTexture(type, tex);
+        state_change_counts_.textures++;
         bound_textures_cube_map_[tex_unit] = tex;
       }
       break;
@@ -3183,53 +3627,52 @@ void RendererGL::BindTexture(GLuint type, GLuint tex, GLuint tex_unit) {
   }
 }
 
-class RendererGL::ModelDataGL : public ModelRendererData {
+// Small static models all get their vertices and indices suballocated out
+// of a few big shared buffers (and thus share a single vertex array), so
+// runs of draws between them don't need any rebinding. Indices get rebased
+// to 16 bit at upload time so we don't need base-vertex draws (which ES2
+// and ES3.0 lack). Space is bump-allocated; a block starts over once all of
+// its models have gone away.
+class RendererGL::ModelArenaBlockGL : public Object {
  public:
   enum BufferType { kVertices, kIndices, kBufferCount };
+  static const uint32_t kVertexCapacity = 65536;
+  static const uint32_t kIndexCapacity = 3 * 65536;
 
-  ModelDataGL(const ModelData& model, RendererGL* renderer)
-      : renderer_(renderer), fake_vao_(nullptr) {
-#if BA_DEBUG_BUILD
-    name_ = model.GetName();
-#endif  // BA_DEBUG_BUILD
+  // Models bigger than this get buffers of their own.
+  static const uint32_t kMaxModelVertices = 8192;
 
-    assert(InGraphicsThread());
-    DEBUG_CHECK_GL_ERROR;
+  auto GetDefaultOwnerThread() const -> ThreadIdentifier override {
+    return ThreadIdentifier::kMain;
+  }
 
-    // Create our vertex array to hold all this state (if supported).
+  // Set up a vertex array (real or fake) pointing at model vertex/index
+  // buffers. Leaves it bound.
+  static void SetUpVertexArray(RendererGL* renderer, GLuint vertex_buffer,
+                               GLuint index_buffer, GLuint* vao,
+                               FakeVertexArrayObject** fake_vao) {
+    DEBUG_CHECK_GL_ERROR;
     if (g_vao_support) {
-      glGenVertexArrays(1, &vao_);
+      glGenVertexArrays(1, vao);
       DEBUG_CHECK_GL_ERROR;
-      renderer->BindVertexArray(vao_);
+      renderer->BindVertexArray(*vao);
       DEBUG_CHECK_GL_ERROR;
     } else {
-      fake_vao_ = new FakeVertexArrayObject(renderer_);
-    }
-
-    glGenBuffers(kBufferCount, vbos_);
-
-    DEBUG_CHECK_GL_ERROR;
-
-    // Fill our vertex data buffer.
-    renderer_->BindArrayBuffer(vbos_[kVertices]);
-    DEBUG_CHECK_GL_ERROR;
-    glBufferData(GL_ARRAY_BUFFER,
-                 static_cast_check_fit<GLsizeiptr>(model.vertices().size()
-                                                   * sizeof(VertexObjectFull)),
-                 &(model.vertices()[0]), GL_STATIC_DRAW);
-    DEBUG_CHECK_GL_ERROR;
-
-    // ..and point our array at its members.
-    if (fake_vao_) {
-      fake_vao_->SetAttribBuffer(vbos_[kVertices], kVertexAttrPosition, 3,
-                                 GL_FLOAT, GL_FALSE, sizeof(VertexObjectFull),
-                                 offsetof(VertexObjectFull, position));
-      fake_vao_->SetAttribBuffer(
-          vbos_[kVertices], kVertexAttrUV, 2, GL_UNSIGNED_SHORT, GL_TRUE,
-          sizeof(VertexObjectFull), offsetof(VertexObjectFull, uv));
-      fake_vao_->SetAttribBuffer(vbos_[kVertices], kVertexAttrNormal, 3,
-                                 GL_SHORT, GL_TRUE, sizeof(VertexObjectFull),
-                                 offsetof(VertexObjectFull, normal));
+      *fake_vao = new FakeVertexArrayObject(renderer);
+    }
+    renderer->BindArrayBuffer(vertex_buffer);
+    if (*fake_vao) {
+      (*fake_vao)->SetAttribBuffer(
+          vertex_buffer, kVertexAttrPosition, 3, GL_FLOAT, GL_FALSE,
+          sizeof(VertexObjectFull), offsetof(VertexObjectFull, position));
+      (*fake_vao)->SetAttribBuffer(vertex_buffer, kVertexAttrUV, 2,
+                                   GL_UNSIGNED_SHORT, GL_TRUE,
+                                   sizeof(VertexObjectFull),
+                                   offsetof(VertexObjectFull, uv));
+      (*fake_vao)->SetAttribBuffer(
+          vertex_buffer, kVertexAttrNormal, 3, GL_SHORT, GL_TRUE,
+          sizeof(VertexObjectFull), offsetof(VertexObjectFull, normal));
+      (*fake_vao)->SetElementBuffer(index_buffer);
       DEBUG_CHECK_GL_ERROR;
     } else {
       glVertexAttribPointer(
@@ -3247,34 +3690,209 @@ class RendererGL::ModelDataGL : public ModelRendererData {
       glEnableVertexAttribArray(kVertexAttrNormal);
       DEBUG_CHECK_GL_ERROR;
     }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    DEBUG_CHECK_GL_ERROR;
+  }
 
-    // fill our index data buffer
+  // Tear down what SetUpVertexArray() made (plus the buffers themselves).
+  static void TearDownVertexArray(RendererGL* renderer, GLuint* buffers,
+                                  int buffer_count, GLuint vao,
+                                  FakeVertexArrayObject** fake_vao) {
+    assert(InGraphicsThread());
+    DEBUG_CHECK_GL_ERROR;
+
+    // Unbind if we're bound; otherwise if a new vao pops up with our same
+    // ID it'd be prevented from binding
+    if (g_vao_support) {
+      if (vao == renderer->current_vertex_array_) {
+        renderer->BindVertexArray(0);
+      }
+      if (!g_graphics_server->renderer_context_lost()) {
+        glDeleteVertexArrays(1, &vao);
+      }
+    } else {
+      assert(*fake_vao);
+      delete *fake_vao;
+      *fake_vao = nullptr;
+    }
+    // make sure our dying buffer isn't current..
+    // (don't wanna prevent binding to a new buffer with a recycled id)
+    for (int i = 0; i < buffer_count; i++) {
+      if (buffers[i] == renderer->active_array_buffer_) {
+        renderer->active_array_buffer_ = -1;
+      }
+    }
+    if (!g_graphics_server->renderer_context_lost()) {
+      glDeleteBuffers(buffer_count, buffers);
+      DEBUG_CHECK_GL_ERROR;
+    }
+  }
+
+  explicit ModelArenaBlockGL(RendererGL* renderer) : renderer_(renderer) {
+    assert(InGraphicsThread());
+    glGenBuffers(kBufferCount, vbos_);
+    SetUpVertexArray(renderer_, vbos_[kVertices], vbos_[kIndices], &vao_,
+                     &fake_vao_);
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast_check_fit<GLsizeiptr>(kVertexCapacity
+                                                   * sizeof(VertexObjectFull)),
+                 nullptr, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+                 static_cast_check_fit<GLsizeiptr>(kIndexCapacity
+                                                   * sizeof(uint16_t)),
+                 nullptr, GL_STATIC_DRAW);
+    DEBUG_CHECK_GL_ERROR;
+  }
+
+  ~ModelArenaBlockGL() override {
+    assert(live_count_ == 0);
+    TearDownVertexArray(renderer_, vbos_, kBufferCount, vao_, &fake_vao_);
+  }
+
+  // Upload a model into this block if there's room. Returns the offset of
+  // its first index on success or -1 on failure.
+  auto Allocate(const ModelData& model) -> int {
+    assert(InGraphicsThread());
+    if (live_count_ == 0) {
+      vertex_count_ = 0;
+      index_count_ = 0;
+    }
+    uint32_t model_vertex_count = model.GetVertexCount();
+    uint32_t model_index_count = model.GetIndexCount();
+    if (model.GetIndexSize() > 2 || model_vertex_count == 0
+        || vertex_count_ + model_vertex_count > kVertexCapacity
+        || index_count_ + model_index_count > kIndexCapacity) {
+      return -1;
+    }
+
+    // Rebase indices to where our vertices are landing.
+    indices_.resize(model_index_count);
+    if (model.GetIndexSize() == 1) {
+      auto* indices = static_cast<const uint8_t*>(model.GetIndexData());
+      for (uint32_t i = 0; i < model_index_count; i++) {
+        indices_[i] = static_cast<uint16_t>(indices[i] + vertex_count_);
+      }
+    } else {
+      auto* indices = static_cast<const uint16_t*>(model.GetIndexData());
+      for (uint32_t i = 0; i < model_index_count; i++) {
+        indices_[i] = static_cast<uint16_t>(indices[i] + vertex_count_);
+      }
+    }
+
+    // Bind ourself first so the element buffer binding lands on our vao.
+    Bind();
+    renderer_->BindArrayBuffer(vbos_[kVertices]);
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    static_cast_check_fit<GLintptr>(vertex_count_
+                                                    * sizeof(VertexObjectFull)),
+                    static_cast_check_fit<GLsizeiptr>(
+                        model_vertex_count * sizeof(VertexObjectFull)),
+                    model.GetVertexData());
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos_[kIndices]);
-    if (!g_vao_support) {
+    if (model_index_count > 0) {
+      glBufferSubData(
+          GL_ELEMENT_ARRAY_BUFFER,
+          static_cast_check_fit<GLintptr>(index_count_ * sizeof(uint16_t)),
+          static_cast_check_fit<GLsizeiptr>(model_index_count
+                                            * sizeof(uint16_t)),
+          indices_.data());
+    }
+    DEBUG_CHECK_GL_ERROR;
+    int offset = static_cast<int>(index_count_);
+    vertex_count_ += model_vertex_count;
+    index_count_ += model_index_count;
+    live_count_++;
+    return offset;
+  }
+
+  void Release() {
+    assert(live_count_ > 0);
+    live_count_--;
+  }
+
+  void Bind() {
+    if (g_vao_support) {
+      renderer_->BindVertexArray(vao_);
+      DEBUG_CHECK_GL_ERROR;
+    } else {
       assert(fake_vao_);
-      fake_vao_->SetElementBuffer(vbos_[kIndices]);
+      fake_vao_->Bind();
+      DEBUG_CHECK_GL_ERROR;
+    }
+  }
+
+ private:
+  RendererGL* renderer_{};
+  GLuint vao_{};
+  GLuint vbos_[kBufferCount]{};
+  FakeVertexArrayObject* fake_vao_{};
+  uint32_t vertex_count_{};
+  uint32_t index_count_{};
+  int live_count_{};
+  std::vector<uint16_t> indices_;
+};
+
+class RendererGL::ModelDataGL : public ModelRendererData {
+ public:
+  enum BufferType { kVertices, kIndices, kBufferCount };
+
+  ModelDataGL(const ModelData& model, RendererGL* renderer)
+      : renderer_(renderer), fake_vao_(nullptr) {
+#if BA_DEBUG_BUILD
+    name_ = model.GetName();
+#endif  // BA_DEBUG_BUILD
+
+    assert(InGraphicsThread());
+    DEBUG_CHECK_GL_ERROR;
+
+    // Small guys go in a shared arena if possible.
+    if (model.GetVertexCount() <= ModelArenaBlockGL::kMaxModelVertices
+        && model.GetIndexSize() <= 2) {
+      int index_offset{-1};
+      arena_block_ = renderer_->AllocateModelArenaSpace(model, &index_offset);
+      if (arena_block_.exists()) {
+        assert(index_offset >= 0);
+        index_type_ = GL_UNSIGNED_SHORT;
+        SetUpLODs(model, static_cast<size_t>(index_offset) * sizeof(uint16_t),
+                  sizeof(uint16_t));
+        return;
+      }
     }
 
-    const GLvoid* index_data;
+    glGenBuffers(kBufferCount, vbos_);
+    DEBUG_CHECK_GL_ERROR;
+
+    // Create our vertex array to hold all this state (if supported)
+    // and point it at our buffers.
+    ModelArenaBlockGL::SetUpVertexArray(renderer_, vbos_[kVertices],
+                                        vbos_[kIndices], &vao_, &fake_vao_);
+
+    // Fill our vertex data buffer.
+    renderer_->BindArrayBuffer(vbos_[kVertices]);
+    DEBUG_CHECK_GL_ERROR;
+    glBufferData(GL_ARRAY_BUFFER,
+                 static_cast_check_fit<GLsizeiptr>(model.GetVertexCount()
+                                                   * sizeof(VertexObjectFull)),
+                 model.GetVertexData(), GL_STATIC_DRAW);
+    DEBUG_CHECK_GL_ERROR;
+
+    // fill our index data buffer
+    const GLvoid* index_data = model.GetIndexData();
+    uint32_t elem_count = model.GetIndexCount();
+    SetUpLODs(model, 0, static_cast<size_t>(model.GetIndexSize()));
     switch (model.GetIndexSize()) {
       case 1: {
-        elem_count_ = static_cast<uint32_t>(model.indices8().size());
         index_type_ = GL_UNSIGNED_BYTE;
-        index_data = static_cast<const GLvoid*>(model.indices8().data());
         break;
       }
       case 2: {
-        elem_count_ = static_cast<uint32_t>(model.indices16().size());
         index_type_ = GL_UNSIGNED_SHORT;
-        index_data = static_cast<const GLvoid*>(model.indices16().data());
         break;
       }
       case 4: {
         BA_LOG_ONCE(
             "GL WARNING - USING 32 BIT INDICES WHICH WONT WORK IN ES2!!");
-        elem_count_ = static_cast<uint32_t>(model.indices32().size());
         index_type_ = GL_UNSIGNED_INT;
-        index_data = static_cast<const GLvoid*>(model.indices32().data());
         break;
       }
       default:
@@ -3282,7 +3900,7 @@ class RendererGL::ModelDataGL : public ModelRendererData {
     }
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        static_cast_check_fit<GLsizeiptr>(elem_count_ * model.GetIndexSize()),
+        static_cast_check_fit<GLsizeiptr>(elem_count * model.GetIndexSize()),
         index_data, GL_STATIC_DRAW);
 
     DEBUG_CHECK_GL_ERROR;
@@ -3290,37 +3908,18 @@ class RendererGL::ModelDataGL : public ModelRendererData {
 
   ~ModelDataGL() override {
     assert(InGraphicsThread());
-    DEBUG_CHECK_GL_ERROR;
-
-    // Unbind if we're bound; otherwise if a new vao pops up with our same ID
-    // it'd be prevented from binding
-    if (g_vao_support) {
-      if (vao_ == renderer_->current_vertex_array_) {
-        renderer_->BindVertexArray(0);
-      }
-      if (!g_graphics_server->renderer_context_lost()) {
-        glDeleteVertexArrays(1, &vao_);
-      }
-    } else {
-      assert(fake_vao_);
-      delete fake_vao_;
-      fake_vao_ = nullptr;
-    }
-    // make sure our dying buffer isn't current..
-    // (don't wanna prevent binding to a new buffer with a recycled id)
-    for (unsigned int vbo : vbos_) {
-      if (vbo == renderer_->active_array_buffer_) {
-        renderer_->active_array_buffer_ = -1;
-      }
-    }
-    if (!g_graphics_server->renderer_context_lost()) {
-      glDeleteBuffers(kBufferCount, vbos_);
-      DEBUG_CHECK_GL_ERROR;
+    if (arena_block_.exists()) {
+      arena_block_->Release();
+      return;
     }
+    ModelArenaBlockGL::TearDownVertexArray(renderer_, vbos_, kBufferCount,
+                                           vao_, &fake_vao_);
   }
 
   void Bind() {
-    if (g_vao_support) {
+    if (arena_block_.exists()) {
+      arena_block_->Bind();
+    } else if (g_vao_support) {
       renderer_->BindVertexArray(vao_);
       DEBUG_CHECK_GL_ERROR;
     } else {
@@ -3329,10 +3928,23 @@ class RendererGL::ModelDataGL : public ModelRendererData {
       DEBUG_CHECK_GL_ERROR;
     }
   }
-  void Draw() {
+  void Draw(int lod = 0) {
     DEBUG_CHECK_GL_ERROR;
-    if (elem_count_ > 0) {
-      glDrawElements(GL_TRIANGLES, elem_count_, index_type_, nullptr);
+    assert(lod >= 0 && lod <= lod_count_);
+    if (elem_counts_[lod] > 0) {
+      glDrawElements(GL_TRIANGLES, elem_counts_[lod], index_type_,
+                     reinterpret_cast<void*>(index_data_offsets_[lod]));
+    }
+    DEBUG_CHECK_GL_ERROR;
+  }
+  void DrawInstanced(int count, int lod = 0) {
+    DEBUG_CHECK_GL_ERROR;
+    assert(g_instancing_support);
+    assert(lod >= 0 && lod <= lod_count_);
+    if (elem_counts_[lod] > 0 && count > 0) {
+      glDrawElementsInstanced(
+          GL_TRIANGLES, elem_counts_[lod], index_type_,
+          reinterpret_cast<void*>(index_data_offsets_[lod]), count);
     }
     DEBUG_CHECK_GL_ERROR;
   }
@@ -3346,12 +3958,26 @@ class RendererGL::ModelDataGL : public ModelRendererData {
   std::string name_;
 #endif
 
+  // Where each detail level's indices live in our index buffer.
+  void SetUpLODs(const ModelData& model, size_t base_offset,
+                 size_t index_size) {
+    lod_count_ = model.lod_count();
+    for (int i = 0; i <= lod_count_; i++) {
+      elem_counts_[i] = model.GetLODIndexCount(i);
+      index_data_offsets_[i] =
+          base_offset + model.GetLODIndexOffset(i) * index_size;
+    }
+  }
+
   RendererGL* renderer_{};
-  uint32_t elem_count_{};
+  int lod_count_{};
+  uint32_t elem_counts_[ModelData::kMaxLODs + 1]{};
+  size_t index_data_offsets_[ModelData::kMaxLODs + 1]{};
   GLuint index_type_{};
   GLuint vao_{};
   GLuint vbos_[kBufferCount]{};
   FakeVertexArrayObject* fake_vao_{};
+  Object::Ref<ModelArenaBlockGL> arena_block_;
 };  // ModelDataGL
 
 class RendererGL::MeshDataGL : public MeshRendererData {
@@ -3465,7 +4091,7 @@ class RendererGL::MeshDataGL : public MeshRendererData {
       glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos_[kIndexBuffer]);
       elem_count_ = static_cast<uint32_t>(data->elements.size());
       assert(elem_count_ > 0);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+      UploadBuffer(GL_ELEMENT_ARRAY_BUFFER, kIndexBuffer,
                    static_cast_check_fit<GLsizeiptr>(
                        data->elements.size() * sizeof(data->elements[0])),
                    &data->elements[0],
@@ -3488,7 +4114,7 @@ class RendererGL::MeshDataGL : public MeshRendererData {
       glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos_[kIndexBuffer]);
       elem_count_ = static_cast<uint32_t>(data->elements.size());
       assert(elem_count_ > 0);
-      glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+      UploadBuffer(GL_ELEMENT_ARRAY_BUFFER, kIndexBuffer,
                    static_cast_check_fit<GLsizeiptr>(
                        data->elements.size() * sizeof(data->elements[0])),
                    &data->elements[0],
@@ -3525,7 +4151,7 @@ class RendererGL::MeshDataGL : public MeshRendererData {
       if (!uses_index_data_ && buffer_type == kVertexBufferPrimary) {
         elem_count_ = static_cast<uint32_t>(data->elements.size());
       }
-      glBufferData(GL_ARRAY_BUFFER,
+      UploadBuffer(GL_ARRAY_BUFFER, buffer_type,
                    static_cast<GLsizeiptr>(data->elements.size()
                                            * sizeof(data->elements[0])),
                    &(data->elements[0]), draw_type);
@@ -3537,8 +4163,28 @@ class RendererGL::MeshDataGL : public MeshRendererData {
     }
   }
 
-  // FIXME - we should do some sort of ring-buffer system.
+  // Static data simply gets (re)allocated at its exact size. Dynamic data
+  // (text, sprites, smoke, shadows, etc. that change most frames) goes into
+  // an allocation we only ever grow; each update orphans the old storage
+  // (so we never wait on the gpu for draws still using it) and streams the
+  // new contents in without the driver having to reallocate.
+  void UploadBuffer(GLenum target, BufferType buffer_type, GLsizeiptr size,
+                    const GLvoid* data, GLenum usage) {
+    GLsizeiptr& capacity{buffer_capacities_[buffer_type]};
+    if (usage != GL_DYNAMIC_DRAW) {
+      glBufferData(target, size, data, usage);
+      capacity = size;
+      return;
+    }
+    if (size > capacity) {
+      capacity = size + size / 2;
+    }
+    glBufferData(target, capacity, nullptr, usage);
+    glBufferSubData(target, 0, size, data);
+  }
+
   GLuint vbos_[3]{};
+  GLsizeiptr buffer_capacities_[3]{};
   GLuint vao_{};
   auto GetBufferCount() const -> int {
     return uses_secondary_data_ ? 3 : (uses_index_data_ ? 2 : 1);
@@ -4107,10 +4753,80 @@ RendererGL::~RendererGL() {
   DEBUG_CHECK_GL_ERROR;
 }
 
+auto RendererGL::AllocateModelArenaSpace(const ModelData& model,
+                                         int* index_offset)
+    -> Object::Ref<ModelArenaBlockGL> {
+  assert(index_offset);
+  for (auto&& block : model_arena_blocks_) {
+    int offset = block->Allocate(model);
+    if (offset >= 0) {
+      *index_offset = offset;
+      return block;
+    }
+  }
+
+  // Don't let the arena grow without bounds; past this point models just
+  // get their own buffers.
+  if (model_arena_blocks_.size() >= kMaxModelArenaBlocks) {
+    return {};
+  }
+  auto block(Object::New<ModelArenaBlockGL>(this));
+  int offset = block->Allocate(model);
+  if (offset < 0) {
+    return {};
+  }
+  model_arena_blocks_.push_back(block);
+  *index_offset = offset;
+  return block;
+}
+
+void RendererGL::DrawModelInstanced(const ModelData& model_data,
+                                    ModelDataGL* model, ObjectProgramGL* p,
+                                    const Matrix44f* mats, int count) {
+  assert(g_instancing_support);
+  DEBUG_CHECK_GL_ERROR;
+
+  // All instances go out at one level; the most detailed any of them
+  // calls for.
+  int lod = model_data.lod_count();
+  for (int i = 0; i < count && lod > 0; i++) {
+    g_graphics_server->PushTransform();
+    g_graphics_server->MultMatrix(mats[i]);
+    lod = std::min(lod, GetModelLOD(model_data));
+    g_graphics_server->PopTransform();
+  }
+  BindArrayBuffer(instance_buffer_);
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast_check_fit<GLsizeiptr>(sizeof(Matrix44f) * count),
+               mats, GL_STREAM_DRAW);
+
+  // Point our instance attrs at the buffer within the model's vao only for
+  // the duration of this draw.
+  model->Bind();
+  for (GLuint i = 0; i < 4; i++) {
+    GLuint attr = kVertexAttrInstanceMatrix + i;
+    glVertexAttribPointer(attr, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix44f),
+                          reinterpret_cast<void*>(sizeof(float) * 4 * i));
+    glVertexAttribDivisor(attr, 1);
+    glEnableVertexAttribArray(attr);
+  }
+  ObjectProgramGL* ip = p->BindInstancedVariant();
+  ip->PrepareToDraw();
+  model->DrawInstanced(count, lod);
+  for (GLuint i = 0; i < 4; i++) {
+    glDisableVertexAttribArray(kVertexAttrInstanceMatrix + i);
+  }
+
+  // Subsequent state changes in this component go to the original program.
+  p->Bind();
+  DEBUG_CHECK_GL_ERROR;
+}
+
 void RendererGL::UseProgram(ProgramGL* p) {
   if (p != current_program_) {
     glUseProgram(p->program());
     current_program_ = p;
+    state_change_counts_.programs++;
   }
 }
 
@@ -4368,6 +5084,7 @@ void RendererGL::StandardPostProcessSetup(PostProcessProgramGL* p,
 void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
                                             const RenderPass& pass,
                                             RenderTarget* render_target) {
+  BA_TRACE_SCOPE("RendererGL::ProcessRenderCommandBuffer");
   buffer->ReadBegin();
   RenderCommandBuffer::Command cmd;
   while ((cmd = buffer->GetCommand()) != RenderCommandBuffer::Command::kEnd) {
@@ -4697,12 +5414,14 @@ void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
           }
           case ShadingType::kPostProcessNormalDistort: {
             float distort = buffer->GetFloat();
+            assert(postprocess_distort_prog_);
             PostProcessProgramGL* p = postprocess_distort_prog_;
             StandardPostProcessSetup(p, pass);
             p->SetDistort(distort);
             break;
           }
           case ShadingType::kPostProcess: {
+            assert(postprocess_prog_);
             PostProcessProgramGL* p = postprocess_prog_;
             StandardPostProcessSetup(p, pass);
             break;
@@ -5176,6 +5895,7 @@ void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
             SetDoubleSided(true);
             SetBlend(true);
             SetBlendPremult(true);
+            assert(shield_prog_);
             ShieldProgramGL* p = shield_prog_;
             p->Bind();
             p->SetDepthTexture(
@@ -5266,7 +5986,8 @@ void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
         }
         GetActiveProgram()->PrepareToDraw();
         model->Bind();
-        model->Draw();
+        model->Draw(GetModelLOD(*m));
+        state_change_counts_.draws++;
         break;
       }
       case RenderCommandBuffer::Command::kDrawModelInstanced: {
@@ -5282,14 +6003,25 @@ void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
         if ((flags & kModelDrawFlagNoReflection) && drawing_reflection()) {
           break;
         }
+
+        // Where we can, stream the matrices to the gpu and draw them all
+        // in one go.
+        if (g_instancing_support && count > 1) {
+          if (auto* p = dynamic_cast<ObjectProgramGL*>(GetActiveProgram())) {
+            DrawModelInstanced(*m, model, p, mats, count);
+            state_change_counts_.draws++;
+            break;
+          }
+        }
         model->Bind();
         for (int i = 0; i < count; i++) {
           g_graphics_server->PushTransform();
           g_graphics_server->MultMatrix(mats[i]);
           GetActiveProgram()->PrepareToDraw();
-          model->Draw();
+          model->Draw(GetModelLOD(*m));
           g_graphics_server->PopTransform();
         }
+        state_change_counts_.draws += count;
         break;
       }
         // NOLINTNEXTLINE(bugprone-branch-clone)
@@ -5331,6 +6063,7 @@ void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
         GetActiveProgram()->PrepareToDraw();
         mesh->Bind();
         mesh->Draw(DrawType::kTriangles);
+        state_change_counts_.draws++;
         break;
       }
       case RenderCommandBuffer::Command::kDrawScreenQuad: {
@@ -5345,6 +6078,7 @@ void RendererGL::ProcessRenderCommandBuffer(RenderCommandBuffer* buffer,
         GetActiveProgram()->PrepareToDraw();
         screen_mesh_->Bind();
         screen_mesh_->Draw(DrawType::kTriangles);
+        state_change_counts_.draws++;
         g_graphics_server->SetModelViewMatrix(old_model_view_matrix);
         g_graphics_server->SetProjectionMatrix(old_projection_matrix);
         break;
@@ -5632,6 +6366,7 @@ void RendererGL::SetBlend(bool b) {
 #endif
   if (blend_ != b) {
     blend_ = b;
+    state_change_counts_.blend_states++;
     if (blend_) {
       glEnable(GL_BLEND);
     } else {
@@ -5642,6 +6377,7 @@ void RendererGL::SetBlend(bool b) {
 void RendererGL::SetBlendPremult(bool b) {
   if (blend_premult_ != b) {
     blend_premult_ = b;
+    state_change_counts_.blend_states++;
     if (blend_premult_) {
       glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
     } else {
@@ -5669,6 +6405,7 @@ void RendererGL::BindVertexArray(GLuint v) {
 void RendererGL::SetDoubleSided(bool d) {
   if (double_sided_ != d) {
     double_sided_ = d;
+    state_change_counts_.blend_states++;
     if (double_sided_) {
       glDisable(GL_CULL_FACE);
     } else {
@@ -5936,6 +6673,204 @@ auto RendererGL::GetAutoGraphicsQuality() -> GraphicsQuality {
   return q;
 }
 
+auto RendererGL::GetQualityCalibrationKey() -> std::string {
+  assert(InMainThread());
+
+  // VR rendering draws everything twice to its own targets; our heuristics
+  // know about that and our calibration doesn't.
+  if (IsVRMode()) {
+    return "";
+  }
+  auto gl_str = [](GLenum name) -> std::string {
+    auto* val = reinterpret_cast<const char*>(glGetString(name));
+    return val ? val : "";
+  };
+  std::string key = std::to_string(kQualityCalibrationVersion) + "\n"
+                    + gl_str(GL_VENDOR) + "\n" + gl_str(GL_RENDERER) + "\n"
+                    + gl_str(GL_VERSION) + "\n"
+                    + g_platform->GetOSVersionString();
+  char hash[32];
+  snprintf(hash, sizeof(hash), "%016llx",
+           static_cast<unsigned long long>(  // NOLINT
+               std::hash<std::string>{}(key)));
+  return hash;
+}
+
+auto RendererGL::CalibrateGraphicsQuality() -> GraphicsQuality {
+  assert(InGraphicsThread());
+  assert(!data_loaded_);
+  auto width = static_cast<int>(g_graphics_server->screen_pixel_width());
+  auto height = static_cast<int>(g_graphics_server->screen_pixel_height());
+  if (width <= 0 || height <= 0) {
+    return GetAutoGraphicsQuality();
+  }
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Load() grabs whatever is bound at that point as our screen framebuffer,
+  // so make sure we leave that as we found it.
+  GLint prev_framebuffer{};
+  glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prev_framebuffer);
+  SyncGLState();
+
+  // Nothing is loaded yet so we bring our own programs and quad.
+  // These are all ones we'd load anyway, so the binary cache keeps them
+  // cheap to make.
+  auto tex_prog =
+      std::make_unique<SimpleProgramGL>(this, SHD_TEXTURE | SHD_MODULATE);
+  auto copy_prog = std::make_unique<SimpleProgramGL>(this, SHD_TEXTURE);
+  auto blur_prog = std::make_unique<BlurProgramGL>(this, 0);
+  auto quad = std::make_unique<MeshDataSimpleFullGL>(this);
+  VertexSimpleFull v[] = {{{-1, -1, 0}, {0, 0}},
+                          {{1, -1, 0}, {65535, 0}},
+                          {{1, 1, 0}, {65535, 65535}},
+                          {{-1, 1, 0}, {0, 65535}}};
+  const uint16_t indices[] = {0, 1, 2, 0, 2, 3};
+  MeshBuffer<VertexSimpleFull> buffer(4, v);
+  buffer.state = 1;  // Necessary for this to set properly.
+  MeshIndexBuffer16 i_buffer(6, indices);
+  i_buffer.state = 1;  // Necessary for this to set properly.
+  quad->SetData(&buffer);
+  quad->SetIndexData(&i_buffer);
+
+  // A noisy texture so texture fetches actually cost something.
+  GLuint noise_tex;
+  glGenTextures(1, &noise_tex);
+  BindTexture(GL_TEXTURE_2D, noise_tex);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  {
+    const int tex_buffer_size = 256 * 256 * 4;
+    std::vector<unsigned char> data(tex_buffer_size);
+    for (unsigned char& i : data) {
+      i = static_cast<unsigned char>(rand());  // NOLINT
+    }
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 256, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, data.data());
+  }
+
+  // Stand-ins for the screen and for the camera buffer and blur chain that
+  // high quality and up render through.
+  auto screen_fb = Object::New<FramebufferObjectGL>(
+      this, width, height, false, true, false, false, false, false, false);
+  auto camera_fb = Object::New<FramebufferObjectGL>(
+      this, width, height, true, true, true, true, false, false, false);
+  auto blur_fb =
+      Object::New<FramebufferObjectGL>(this, std::max(1, width / 2),
+                                       std::max(1, height / 2), true, false,
+                                       true, false, false, false, false);
+  DEBUG_CHECK_GL_ERROR;
+
+  auto draw_quad = [&quad, this] {
+    g_graphics_server->ModelViewReset();
+    g_graphics_server->SetOrthoProjection(-1, 1, -1, 1, -1, 1);
+    GetActiveProgram()->PrepareToDraw();
+    quad->Bind();
+    quad->Draw(DrawType::kTriangles);
+  };
+
+  // Blended full-screen layers (our stand-in for the world and its
+  // overdraw) followed by blur passes and a composite when the tier
+  // post-processes.
+  auto draw_tier = [&](int layers, int blur_passes) {
+    FramebufferObjectGL* target =
+        blur_passes > 0 ? camera_fb.get() : screen_fb.get();
+    target->Bind();
+    SetViewport(0, 0, target->width(), target->height());
+    SetDepthWriting(true);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    SetDepthTesting(false);
+    SetDoubleSided(false);
+    SetBlend(true);
+    tex_prog->Bind();
+    tex_prog->SetColorTexture(noise_tex);
+    for (int i = 0; i < layers; i++) {
+      tex_prog->SetColor(1.0f, 1.0f, 1.0f, 0.5f);
+      draw_quad();
+    }
+    SetBlend(false);
+    if (blur_passes > 0) {
+      blur_fb->Bind();
+      SetViewport(0, 0, blur_fb->width(), blur_fb->height());
+      blur_prog->Bind();
+      blur_prog->SetPixelSize(1.0f / static_cast<float>(blur_fb->width()),
+                              1.0f / static_cast<float>(blur_fb->height()));
+      for (int i = 0; i < blur_passes; i++) {
+        blur_prog->SetColorTexture(camera_fb->texture());
+        draw_quad();
+      }
+      screen_fb->Bind();
+      SetViewport(0, 0, width, height);
+      copy_prog->Bind();
+      copy_prog->SetColorTexture(camera_fb->texture());
+      draw_quad();
+    }
+  };
+
+  struct Tier {
+    GraphicsQuality quality;
+    int layers;
+    int blur_passes;
+  };
+  const Tier tiers[] = {{GraphicsQuality::kMedium, 4, 0},
+                        {GraphicsQuality::kHigh, 5, 2},
+                        {GraphicsQuality::kHigher, 6, 4}};
+
+  // Low always passes; beyond that each tier costs more than the last so
+  // we can stop at the first miss.
+  GraphicsQuality result{GraphicsQuality::kLow};
+  std::string timings;
+  for (const Tier& tier : tiers) {
+    // Warm up so driver-side shader and target setup isn't counted.
+    draw_tier(tier.layers, tier.blur_passes);
+    glFinish();
+    std::vector<float> frame_times;
+    for (int i = 0; i < kQualityCalibrationFrames; i++) {
+      auto frame_start = std::chrono::steady_clock::now();
+      draw_tier(tier.layers, tier.blur_passes);
+      glFinish();
+      frame_times.push_back(
+          std::chrono::duration<float, std::milli>(
+              std::chrono::steady_clock::now() - frame_start)
+              .count());
+    }
+    std::sort(frame_times.begin(), frame_times.end());
+    float median = frame_times[frame_times.size() / 2];
+    char buf[64];
+    snprintf(buf, sizeof(buf), " %.2fms", median);
+    timings += buf;
+    if (median > kQualityCalibrationTargetMilliseconds) {
+      break;
+    }
+    result = tier.quality;
+  }
+  glDeleteTextures(1, &noise_tex);
+  DEBUG_CHECK_GL_ERROR;
+
+  // Clean up after ourself before Load() takes a look around.
+  glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prev_framebuffer));
+  screen_fb.Clear();
+  camera_fb.Clear();
+  blur_fb.Clear();
+  quad.reset();
+  tex_prog.reset();
+  copy_prog.reset();
+  blur_prog.reset();
+  SyncGLState();
+
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start_time)
+                      .count();
+  Log("Calibrated graphics quality at " + std::to_string(width) + "x"
+          + std::to_string(height) + " in " + std::to_string(duration)
+          + "ms;" + timings + " -> "
+          + GraphicsServer::GetGraphicsQualityName(result),
+      true, false);
+  return result;
+}
+
 void RendererGL::RetainShader(ProgramGL* p) { shaders_.emplace_back(p); }
 
 void RendererGL::Load() {
@@ -6068,25 +7003,40 @@ void RendererGL::Load() {
   p = sprite_camalign_overlay_prog_ =
       new SpriteProgramGL(this, SHD_CAMERA_ALIGNED | SHD_OVERLAY | SHD_COLOR);
   RetainShader(p);
-  p = blur_prog_ = new BlurProgramGL(this, 0);
-  RetainShader(p);
-  p = shield_prog_ = new ShieldProgramGL(this, 0);
-  RetainShader(p);
 
-  // Conditional seems to be a *very* slight win on some architectures (A7), a
-  // loss on some (A5) and a wash on some (Adreno 320).
-  // Gonna wait before a clean win before turning it on.
-  p = postprocess_prog_ = new PostProcessProgramGL(this, high_qual_pp_flag);
-  RetainShader(p);
+  // Everything below works off the camera buffer (and its depth texture),
+  // which only exists in high quality and up; quality is fixed for the life
+  // of a load so there's no point compiling these otherwise.
+  if (g_graphics_server->quality() >= GraphicsQuality::kHigh) {
+    p = blur_prog_ = new BlurProgramGL(this, 0);
+    RetainShader(p);
+    p = shield_prog_ = new ShieldProgramGL(this, 0);
+    RetainShader(p);
+
+    // Conditional seems to be a *very* slight win on some architectures
+    // (A7), a loss on some (A5) and a wash on some (Adreno 320).
+    // Gonna wait before a clean win before turning it on.
+    p = postprocess_prog_ = new PostProcessProgramGL(this, high_qual_pp_flag);
+    RetainShader(p);
+    p = postprocess_distort_prog_ =
+        new PostProcessProgramGL(this, SHD_DISTORT | high_qual_pp_flag);
+    RetainShader(p);
+  } else {
+    blur_prog_ = nullptr;
+    shield_prog_ = nullptr;
+    postprocess_prog_ = nullptr;
+    postprocess_distort_prog_ = nullptr;
+  }
   if (g_graphics_server->quality() >= GraphicsQuality::kHigher) {
     p = postprocess_eyes_prog_ = new PostProcessProgramGL(this, SHD_EYES);
     RetainShader(p);
   } else {
     postprocess_eyes_prog_ = nullptr;
   }
-  p = postprocess_distort_prog_ =
-      new PostProcessProgramGL(this, SHD_DISTORT | high_qual_pp_flag);
-  RetainShader(p);
+
+  if (g_instancing_support) {
+    glGenBuffers(1, &instance_buffer_);
+  }
 
   // Generate our random value texture.
   {
@@ -6168,6 +7118,19 @@ void RendererGL::Unload() {
   DEBUG_CHECK_GL_ERROR;
   assert(data_loaded_);
   Renderer::Unload();
+#if ENABLE_GPU_TIMERS
+  for (auto&& frame : gpu_pass_timer_frames_) {
+    for (auto&& query : frame) {
+      gpu_pass_timer_query_pool_.push_back(query.query);
+    }
+    frame.clear();
+  }
+  if (!gpu_pass_timer_query_pool_.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(gpu_pass_timer_query_pool_.size()),
+                    gpu_pass_timer_query_pool_.data());
+    gpu_pass_timer_query_pool_.clear();
+  }
+#endif  // ENABLE_GPU_TIMERS
   // clear out recycle-mesh-datas
   for (auto&& i : recycle_mesh_datas_simple_split_) {
     delete i;
@@ -6193,11 +7156,34 @@ void RendererGL::Unload() {
     delete i;
   }
   recycle_mesh_datas_sprite_.clear();
+
+  // Any models still alive keep their blocks around; we just stop handing
+  // out space from them.
+  model_arena_blocks_.clear();
   screen_mesh_.reset();
+#if ENABLE_ASYNC_FRAME_CAPTURE
+  // Get our in-flight frame written while we still can; we'll carry on
+  // with new buffers once reloaded.
+  if (capture_pbos_[0] != 0) {
+    if (!g_graphics_server->renderer_context_lost()) {
+      WritePendingCaptureFrame();
+      glDeleteBuffers(2, capture_pbos_);
+    }
+    capture_pbos_[0] = capture_pbos_[1] = 0;
+    capture_pbo_pending_ = false;
+  }
+#endif  // ENABLE_ASYNC_FRAME_CAPTURE
   if (!g_graphics_server->renderer_context_lost()) {
     glDeleteTextures(1, &random_tex_);
     glDeleteTextures(1, &vignette_tex_);
+    if (instance_buffer_ != 0) {
+      glDeleteBuffers(1, &instance_buffer_);
+    }
   }
+  if (instance_buffer_ == static_cast<GLuint>(active_array_buffer_)) {
+    active_array_buffer_ = -1;
+  }
+  instance_buffer_ = 0;
   blur_buffers_.clear();
   shaders_.clear();
   simple_color_prog_ = nullptr;
@@ -6538,6 +7524,7 @@ void RendererGL::GenerateCameraBufferBlurPasses() {
   SetDoubleSided(false);
   SetBlend(false);
 
+  assert(blur_prog_);
   BlurProgramGL* p = blur_prog_;
   p->Bind();
 
@@ -6590,7 +7577,202 @@ void RendererGL::VRSyncRenderStates() {
 }
 #endif  // BA_VR_BUILD
 
+void RendererGL::BeginGPUPassTimer(RenderPass::Type type) {
+#if ENABLE_GPU_TIMERS
+  // Only one of these can be running at once.
+  if (!gpu_pass_timers_enabled_ || !g_gpu_timer_support
+      || gpu_pass_timer_running_) {
+    return;
+  }
+  GLuint query;
+  if (gpu_pass_timer_query_pool_.empty()) {
+    glGenQueries(1, &query);
+  } else {
+    query = gpu_pass_timer_query_pool_.back();
+    gpu_pass_timer_query_pool_.pop_back();
+  }
+  glBeginQuery(GL_TIME_ELAPSED, query);
+  gpu_pass_timer_frames_[gpu_pass_timer_frame_].push_back({type, query});
+  gpu_pass_timer_running_ = true;
+#endif  // ENABLE_GPU_TIMERS
+}
+
+void RendererGL::EndGPUPassTimer() {
+#if ENABLE_GPU_TIMERS
+  if (gpu_pass_timer_running_) {
+    glEndQuery(GL_TIME_ELAPSED);
+    gpu_pass_timer_running_ = false;
+  }
+#endif  // ENABLE_GPU_TIMERS
+}
+
+void RendererGL::UpdateGPUPassTimers() {
+#if ENABLE_GPU_TIMERS
+  // Move on to our oldest frame's queries; they should have results by now.
+  // (if not, we just skip them rather than stalling on them)
+  gpu_pass_timer_frame_ = (gpu_pass_timer_frame_ + 1) % kGPUPassTimerLatency;
+  std::vector<GPUPassTimerQuery>& queries(
+      gpu_pass_timer_frames_[gpu_pass_timer_frame_]);
+  if (queries.empty()) {
+    if (!gpu_pass_timers_enabled_) {
+      for (auto&& time : gpu_pass_times_) {
+        time.store(-1.0f);
+      }
+    }
+    return;
+  }
+  bool available = true;
+  for (auto&& query : queries) {
+    GLint query_available{};
+    glGetQueryObjectiv(query.query, GL_QUERY_RESULT_AVAILABLE,
+                       &query_available);
+    if (!query_available) {
+      available = false;
+      break;
+    }
+  }
+  if (available) {
+    float times[kRenderPassTypeCount];
+    for (float& time : times) {
+      time = -1.0f;
+    }
+    for (auto&& query : queries) {
+      GLuint64 elapsed{};
+      glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &elapsed);
+      float& time(times[static_cast<int>(query.type)]);
+      time = std::max(0.0f, time) + static_cast<float>(elapsed) / 1000000.0f;
+    }
+    for (int i = 0; i < kRenderPassTypeCount; i++) {
+      gpu_pass_times_[i].store(times[i]);
+    }
+  }
+  for (auto&& query : queries) {
+    gpu_pass_timer_query_pool_.push_back(query.query);
+  }
+  queries.clear();
+  DEBUG_CHECK_GL_ERROR;
+#endif  // ENABLE_GPU_TIMERS
+}
+
+void RendererGL::CaptureFrame() {
+  assert(!g_app_globals->capture_path.empty());
+  if (capture_failed_) {
+    return;
+  }
+  auto width = static_cast<int>(screen_render_target()->physical_width());
+  auto height = static_cast<int>(screen_render_target()->physical_height());
+  if (capture_file_ == nullptr) {
+    const std::string& path = g_app_globals->capture_path;
+    capture_file_ = g_platform->FOpen(path.c_str(), "wb");
+    if (capture_file_ == nullptr) {
+      Log("Error: Unable to open frame capture output '" + path
+          + "': " + g_platform->GetErrnoString());
+      capture_failed_ = true;
+      return;
+    }
+    capture_width_ = width;
+    capture_height_ = height;
+    Log("Capturing " + std::to_string(width) + "x" + std::to_string(height)
+        + " rgba frames at " + std::to_string(g_app_globals->capture_fps)
+        + " fps (bottom row first; use a vflip filter when encoding).");
+  }
+
+  // Raw output has no way to express a size change.
+  if (width != capture_width_ || height != capture_height_) {
+    Log("Error: Screen size changed during frame capture; stopping.");
+    FinishCapture();
+    return;
+  }
+  size_t frame_size = static_cast<size_t>(width) * height * 4;
+
+  // We come here from the end of the frame, with the screen still bound.
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+#if ENABLE_ASYNC_FRAME_CAPTURE
+  if (capture_pbos_[0] == 0) {
+    glGenBuffers(2, capture_pbos_);
+    for (GLuint pbo : capture_pbos_) {
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+      glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(frame_size),
+                   nullptr, GL_STREAM_READ);
+    }
+    capture_pbo_index_ = 0;
+    capture_pbo_pending_ = false;
+  }
+
+  // Kick off this frame's read and then write out the last one, which
+  // should have landed by now.
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, capture_pbos_[capture_pbo_index_]);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  capture_pbo_index_ = !capture_pbo_index_;
+  if (capture_pbo_pending_) {
+    WriteCapturePBO(capture_pbos_[capture_pbo_index_]);
+  }
+  capture_pbo_pending_ = true;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#else
+  capture_buffer_.resize(frame_size);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+               capture_buffer_.data());
+  WriteCaptureFrame(capture_buffer_.data());
+#endif  // ENABLE_ASYNC_FRAME_CAPTURE
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  DEBUG_CHECK_GL_ERROR;
+}
+
+void RendererGL::WriteCapturePBO(GLuint pbo) {
+#if ENABLE_ASYNC_FRAME_CAPTURE
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+  auto* data = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (data == nullptr) {
+    Log("Error: Unable to map frame capture buffer; stopping.");
+    capture_pbo_pending_ = false;
+    FinishCapture();
+    return;
+  }
+  WriteCaptureFrame(data);
+  glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+#endif  // ENABLE_ASYNC_FRAME_CAPTURE
+}
+
+void RendererGL::WriteCaptureFrame(const void* data) {
+  if (capture_file_ == nullptr) {
+    return;
+  }
+  size_t frame_size = static_cast<size_t>(capture_width_) * capture_height_ * 4;
+  if (fwrite(data, frame_size, 1, capture_file_) != 1) {
+    Log("Error: Unable to write frame capture output: "
+        + g_platform->GetErrnoString());
+    FinishCapture();
+  }
+}
+
+void RendererGL::WritePendingCaptureFrame() {
+#if ENABLE_ASYNC_FRAME_CAPTURE
+  if (capture_pbo_pending_) {
+    capture_pbo_pending_ = false;
+    WriteCapturePBO(capture_pbos_[!capture_pbo_index_]);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+#endif  // ENABLE_ASYNC_FRAME_CAPTURE
+}
+
+// Writes out any frame still in flight and closes our output. Our PBOs
+// stay around until we unload.
+void RendererGL::FinishCapture() {
+  WritePendingCaptureFrame();
+  if (capture_file_ != nullptr) {
+    fclose(capture_file_);
+    capture_file_ = nullptr;
+  }
+  capture_failed_ = true;
+}
+
 void RendererGL::RenderFrameDefEnd() {
+  UpdateGPUPassTimers();
+  if (!g_app_globals->capture_path.empty() && !IsVRMode()) {
+    CaptureFrame();
+  }
+
   // Need to set some states to keep cardboard happy.
 #if BA_CARDBOARD_BUILD
   if (IsVRMode()) {
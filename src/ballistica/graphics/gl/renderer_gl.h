@@ -25,6 +25,7 @@ class RendererGL : public Renderer {
   class FakeVertexArrayObject;
   class TextureDataGL;
   class ModelDataGL;
+  class ModelArenaBlockGL;
   class MeshDataGL;
   class MeshDataSimpleSplitGL;
   class MeshDataObjectSplitGL;
@@ -63,12 +64,19 @@ class RendererGL : public Renderer {
     kVertexAttrSize,
     kVertexAttrDiffuse,
     kVertexAttrUV2,
-    kVertexAttrCount
+    kVertexAttrCount,
+
+    // First of 4 consecutive attrs holding per-instance model-matrix
+    // columns. These are only touched when hardware instancing is available
+    // so they live outside the set the fake-vao path manages.
+    kVertexAttrInstanceMatrix = kVertexAttrCount
   };
 
   void CheckCapabilities() override;
   auto GetAutoGraphicsQuality() -> GraphicsQuality override;
   auto GetAutoTextureQuality() -> TextureQuality override;
+  auto GetQualityCalibrationKey() -> std::string override;
+  auto CalibrateGraphicsQuality() -> GraphicsQuality override;
 #if BA_OSTYPE_ANDROID
   std::string GetAutoAndroidRes() override;
 #endif  // BA_OSTYPE_ANDROID
@@ -107,12 +115,15 @@ class RendererGL : public Renderer {
   void PushGroupMarker(const char* label) override;
   void PopGroupMarker() override;
   auto IsMSAAEnabled() const -> bool override;
+  auto IsMSAAResolveImplicit() const -> bool override;
   void InvalidateFramebuffer(bool color, bool depth,
                              bool target_read_framebuffer) override;
   void VREyeRenderBegin() override;
   void CardboardDisableScissor() override;
   void CardboardEnableScissor() override;
   void RenderFrameDefEnd() override;
+  void BeginGPUPassTimer(RenderPass::Type type) override;
+  void EndGPUPassTimer() override;
 
 #if BA_VR_BUILD
   void VRSyncRenderStates() override;
@@ -129,8 +140,16 @@ class RendererGL : public Renderer {
   void UpdateVignetteTex(bool force) override;
   void StandardPostProcessSetup(PostProcessProgramGL* p,
                                 const RenderPass& pass);
+  void CaptureFrame();
+  void WriteCapturePBO(GLuint pbo);
+  void WriteCaptureFrame(const void* data);
+  void WritePendingCaptureFrame();
+  void FinishCapture();
   void SyncGLState();
   void RetainShader(ProgramGL* p);
+  void UpdateGPUPassTimers();
+  auto AllocateModelArenaSpace(const ModelData& model, int* index_offset)
+      -> Object::Ref<ModelArenaBlockGL>;
   void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
   void UseProgram(ProgramGL* p);
   auto GetActiveProgram() const -> ProgramGL* {
@@ -149,6 +168,9 @@ class RendererGL : public Renderer {
   void BindTextureUnit(uint32_t tex_unit);
   void BindFramebuffer(GLuint fb);
   void BindArrayBuffer(GLuint b);
+  void DrawModelInstanced(const ModelData& model_data, ModelDataGL* model,
+                          ObjectProgramGL* p, const Matrix44f* mats,
+                          int count);
   void SetBlend(bool b);
   void SetBlendPremult(bool b);
   millisecs_t dof_update_time_{};
@@ -180,6 +202,9 @@ class RendererGL : public Renderer {
   bool got_screen_framebuffer_{};
   GLuint random_tex_{};
   GLuint vignette_tex_{};
+
+  // Streamed per-instance matrices for instanced model draws.
+  GLuint instance_buffer_{};
   GraphicsQuality vignette_quality_{};
   std::vector<std::unique_ptr<ProgramGL> > shaders_;
   GLint viewport_x_{};
@@ -254,6 +279,31 @@ class RendererGL : public Renderer {
   std::vector<MeshDataSmokeFullGL*> recycle_mesh_datas_smoke_full_;
   std::vector<MeshDataSpriteGL*> recycle_mesh_datas_sprite_;
   int error_check_counter_{};
+  static const size_t kMaxModelArenaBlocks = 8;
+  std::vector<Object::Ref<ModelArenaBlockGL> > model_arena_blocks_;
+
+  // In-flight pass timer queries for our last few frames, and a pool of
+  // spare query objects.
+  struct GPUPassTimerQuery {
+    RenderPass::Type type;
+    GLuint query;
+  };
+  static const int kGPUPassTimerLatency = 3;
+  std::vector<GPUPassTimerQuery> gpu_pass_timer_frames_[kGPUPassTimerLatency];
+  std::vector<GLuint> gpu_pass_timer_query_pool_;
+  int gpu_pass_timer_frame_{};
+  bool gpu_pass_timer_running_{};
+
+  // Frame capture output (see AppGlobals::capture_path). We read into
+  // alternating pixel buffers and write each out a frame later.
+  FILE* capture_file_{};
+  bool capture_failed_{};
+  int capture_width_{};
+  int capture_height_{};
+  GLuint capture_pbos_[2]{};
+  int capture_pbo_index_{};
+  bool capture_pbo_pending_{};
+  std::vector<uint8_t> capture_buffer_;
 };
 
 }  // namespace ballistica
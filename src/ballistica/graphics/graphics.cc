@@ -2,14 +2,19 @@
 
 #include "ballistica/graphics/graphics.h"
 
+#include <chrono>
+
 #include "ballistica/app/app.h"
 #include "ballistica/app/app_globals.h"
+#include "ballistica/core/memory_stats.h"
+#include "ballistica/core/object_pool.h"
 #include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/game/connection/connection_set.h"
 #include "ballistica/game/connection/connection_to_client.h"
 #include "ballistica/game/connection/connection_to_host.h"
 #include "ballistica/game/session/session.h"
 #include "ballistica/generic/utils.h"
+#include "ballistica/graphics/benchmark_recorder.h"
 #include "ballistica/graphics/camera.h"
 #include "ballistica/graphics/component/empty_component.h"
 #include "ballistica/graphics/component/object_component.h"
@@ -22,6 +27,7 @@
 #include "ballistica/graphics/net_graph.h"
 #include "ballistica/graphics/text/text_graphics.h"
 #include "ballistica/input/input.h"
+#include "ballistica/input/input_latency.h"
 #include "ballistica/python/python.h"
 #include "ballistica/python/python_context_call.h"
 #include "ballistica/scene/node/globals_node.h"
@@ -243,12 +249,32 @@ void Graphics::DrawMiscOverlays(RenderPass* pass) {
         g_graphics_server->renderer()->total_frames_rendered();
     last_fps_ = total_frames_rendered - last_total_frames_rendered_;
     last_total_frames_rendered_ = total_frames_rendered;
+    const Renderer::StateChangeCounts& counts =
+        g_graphics_server->renderer()->last_state_change_counts();
+    last_render_draws_ = counts.draws;
+    last_render_programs_ = counts.programs;
+    last_render_textures_ = counts.textures;
+    last_render_blend_states_ = counts.blend_states;
+    last_culled_draws_ = pass->frame_def()->beauty_pass()->culled_count();
+    if (network_debug_display_enabled_) {
+      UpdateGPUTimerString();
+    }
   }
   float v{};
 
-  if (show_fps_) {
-    char fps_str[32];
-    snprintf(fps_str, sizeof(fps_str), "%d", last_fps_);
+  if (show_fps_ || show_render_stats_) {
+    char fps_str[128];
+    if (show_render_stats_) {
+      snprintf(fps_str, sizeof(fps_str),
+               "%d  draws:%d prg:%d tex:%d st:%d culled:%d texmem:%dM",
+               last_fps_, last_render_draws_, last_render_programs_,
+               last_render_textures_, last_render_blend_states_,
+               last_culled_draws_,
+               static_cast<int>(g_media->texture_memory_resident()
+                                / (1024 * 1024)));
+    } else {
+      snprintf(fps_str, sizeof(fps_str), "%d", last_fps_);
+    }
     if (fps_str != fps_string_) {
       fps_string_ = fps_str;
       if (!fps_text_group_.exists()) {
@@ -382,6 +408,103 @@ void Graphics::DrawMiscOverlays(RenderPass* pass) {
     }
   }
 
+  // Per-pass gpu times (when the renderer can give them to us).
+  if (network_debug_display_enabled_ && !gpu_timer_string_.empty()) {
+    if (!gpu_timer_text_group_.exists()) {
+      gpu_timer_text_group_ = Object::New<TextGroup>();
+    }
+    gpu_timer_text_group_->SetText(gpu_timer_string_);
+    SimpleComponent c(pass);
+    c.SetTransparent(true);
+    c.SetColor(0.8f, 0.8f, 0.8f, 1.0f);
+    int text_elem_count = gpu_timer_text_group_->GetElementCount();
+    for (int e = 0; e < text_elem_count; e++) {
+      c.SetTexture(gpu_timer_text_group_->GetElementTexture(e));
+      c.SetFlatness(1.0f);
+      c.PushTransform();
+      c.Translate(4.0f, screen_virtual_height() - 20.0f,
+                  kScreenMessageZDepth);
+      c.Scale(0.7f, 0.7f);
+      c.DrawMesh(gpu_timer_text_group_->GetElementMesh(e));
+      c.PopTransform();
+    }
+    c.Submit();
+  }
+
+  // Object pool usage (refreshed once a second; it doesn't move much).
+  if (network_debug_display_enabled_) {
+    auto now = GetRealTime();
+    if (now - last_object_pool_string_time_ > 1000) {
+      last_object_pool_string_time_ = now;
+      object_pool_string_ = ObjectPoolBase::GetStatsString();
+      if (!object_pool_text_group_.exists()) {
+        object_pool_text_group_ = Object::New<TextGroup>();
+      }
+      object_pool_text_group_->SetText(object_pool_string_);
+      input_latency_string_ = InputLatency::GetStatsString();
+      if (!input_latency_text_group_.exists()) {
+        input_latency_text_group_ = Object::New<TextGroup>();
+      }
+      input_latency_text_group_->SetText(input_latency_string_);
+      memory_stats_string_ = MemoryStats::GetStatsString();
+      if (!memory_stats_text_group_.exists()) {
+        memory_stats_text_group_ = Object::New<TextGroup>();
+      }
+      memory_stats_text_group_->SetText(memory_stats_string_);
+    }
+    if (input_latency_text_group_.exists() && !input_latency_string_.empty()) {
+      SimpleComponent c(pass);
+      c.SetTransparent(true);
+      c.SetColor(0.8f, 0.8f, 0.8f, 1.0f);
+      int text_elem_count = input_latency_text_group_->GetElementCount();
+      for (int e = 0; e < text_elem_count; e++) {
+        c.SetTexture(input_latency_text_group_->GetElementTexture(e));
+        c.SetFlatness(1.0f);
+        c.PushTransform();
+        c.Translate(4.0f, screen_virtual_height() - 36.0f,
+                    kScreenMessageZDepth);
+        c.Scale(0.7f, 0.7f);
+        c.DrawMesh(input_latency_text_group_->GetElementMesh(e));
+        c.PopTransform();
+      }
+      c.Submit();
+    }
+    if (object_pool_text_group_.exists() && !object_pool_string_.empty()) {
+      SimpleComponent c(pass);
+      c.SetTransparent(true);
+      c.SetColor(0.8f, 0.8f, 0.8f, 1.0f);
+      int text_elem_count = object_pool_text_group_->GetElementCount();
+      for (int e = 0; e < text_elem_count; e++) {
+        c.SetTexture(object_pool_text_group_->GetElementTexture(e));
+        c.SetFlatness(1.0f);
+        c.PushTransform();
+        c.Translate(screen_virtual_width() - 250.0f,
+                    screen_virtual_height() - 20.0f, kScreenMessageZDepth);
+        c.Scale(0.7f, 0.7f);
+        c.DrawMesh(object_pool_text_group_->GetElementMesh(e));
+        c.PopTransform();
+      }
+      c.Submit();
+    }
+    if (memory_stats_text_group_.exists() && !memory_stats_string_.empty()) {
+      SimpleComponent c(pass);
+      c.SetTransparent(true);
+      c.SetColor(0.8f, 0.8f, 0.8f, 1.0f);
+      int text_elem_count = memory_stats_text_group_->GetElementCount();
+      for (int e = 0; e < text_elem_count; e++) {
+        c.SetTexture(memory_stats_text_group_->GetElementTexture(e));
+        c.SetFlatness(1.0f);
+        c.PushTransform();
+        c.Translate(screen_virtual_width() - 250.0f, 110.0f,
+                    kScreenMessageZDepth);
+        c.Scale(0.7f, 0.7f);
+        c.DrawMesh(memory_stats_text_group_->GetElementMesh(e));
+        c.PopTransform();
+      }
+      c.Submit();
+    }
+  }
+
   // Draw any debug graphs.
   {
     float debug_graph_y = 50.0;
@@ -996,6 +1119,12 @@ void Graphics::BuildAndPushFrameDef() {
   // This should no longer be necessary..
   WaitForRendererToExist();
 
+  bool benchmarking = BenchmarkRecorder::recording();
+  std::chrono::steady_clock::time_point build_start_time;
+  if (benchmarking) {
+    build_start_time = std::chrono::steady_clock::now();
+  }
+
   Session* session = g_game->GetForegroundSession();
   bool session_fills_screen = session ? session->DoesFillScreen() : false;
   millisecs_t real_time = GetRealTime();
@@ -1008,6 +1137,10 @@ void Graphics::BuildAndPushFrameDef() {
 
   UpdateGyro(real_time, elapsed);
 
+  // Recycle whatever the graphics thread has finished with first so the
+  // frame_def we just got back gets reused here instead of a new one
+  // being allocated.
+  ClearFrameDefDeleteList();
   FrameDef* frame_def = GetEmptyFrameDef();
   frame_def->set_real_time(real_time);
   frame_def->set_base_time(g_game->master_time());
@@ -1095,10 +1228,15 @@ void Graphics::BuildAndPushFrameDef() {
   frame_def->set_mesh_data_destroys(mesh_data_destroys_);
   mesh_data_destroys_.clear();
 
-  g_graphics_server->SetFrameDef(frame_def);
+  if (benchmarking) {
+    BenchmarkRecorder::AddFrameBuild(
+        std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                      - build_start_time)
+            .count());
+  }
 
-  // Clean up frame_defs awaiting deletion.
-  ClearFrameDefDeleteList();
+  InputLatency::NoteFrameBuilt(frame_def);
+  g_graphics_server->SetFrameDef(frame_def);
 
   // Clear our blotches out regardless of whether we rendered them.
   blotch_indices_.clear();
@@ -1363,48 +1501,55 @@ void Graphics::DrawCursor(RenderPass* pass, millisecs_t real_time) {
   }
 }
 
-void Graphics::DrawBlotches(FrameDef* frame_def) {
-  if (!this->blotch_verts_.empty()) {
-    if (!this->shadow_blotch_mesh_.exists())
-      this->shadow_blotch_mesh_ = Object::New<SpriteMesh>();
-    this->shadow_blotch_mesh_->SetIndexData(Object::New<MeshIndexBuffer16>(
-        this->blotch_indices_.size(), &this->blotch_indices_[0]));
-    this->shadow_blotch_mesh_->SetData(Object::New<MeshBuffer<VertexSprite>>(
-        this->blotch_verts_.size(), &this->blotch_verts_[0]));
-    SpriteComponent c(frame_def->light_shadow_pass());
-    c.SetTexture(g_media->GetTexture(SystemTextureID::kLight));
-    c.DrawMesh(this->shadow_blotch_mesh_.get());
-    c.Submit();
-  }
-  if (!this->blotch_soft_verts_.empty()) {
-    if (!this->shadow_blotch_soft_mesh_.exists())
-      this->shadow_blotch_soft_mesh_ = Object::New<SpriteMesh>();
-    this->shadow_blotch_soft_mesh_->SetIndexData(Object::New<MeshIndexBuffer16>(
-        this->blotch_soft_indices_.size(), &this->blotch_soft_indices_[0]));
-    this->shadow_blotch_soft_mesh_->SetData(
-        Object::New<MeshBuffer<VertexSprite>>(this->blotch_soft_verts_.size(),
-                                              &this->blotch_soft_verts_[0]));
-    SpriteComponent c(frame_def->light_shadow_pass());
-    c.SetTexture(g_media->GetTexture(SystemTextureID::kLightSoft));
-    c.DrawMesh(this->shadow_blotch_soft_mesh_.get());
-    c.Submit();
-  }
-  if (!this->blotch_soft_obj_verts_.empty()) {
-    if (!this->shadow_blotch_soft_obj_mesh_.exists()) {
-      this->shadow_blotch_soft_obj_mesh_ = Object::New<SpriteMesh>();
+// Refill a blotch buffer nobody is using anymore (or make a new one).
+template <typename B, typename T>
+static auto GetBlotchBuffer(std::vector<Object::Ref<B> >* pool,
+                            const std::vector<T>& data) -> Object::Ref<B> {
+  // If our pool holds the only ref, no mesh or in-flight frame-def is
+  // still looking at it.
+  for (auto&& buffer : *pool) {
+    if (buffer->object_strong_ref_count() == 1) {
+      buffer->elements.assign(data.begin(), data.end());
+      return buffer;
     }
-    this->shadow_blotch_soft_obj_mesh_->SetIndexData(
-        Object::New<MeshIndexBuffer16>(this->blotch_soft_obj_indices_.size(),
-                                       &this->blotch_soft_obj_indices_[0]));
-    this->shadow_blotch_soft_obj_mesh_->SetData(
-        Object::New<MeshBuffer<VertexSprite>>(
-            this->blotch_soft_obj_verts_.size(),
-            &this->blotch_soft_obj_verts_[0]));
-    SpriteComponent c(frame_def->light_pass());
-    c.SetTexture(g_media->GetTexture(SystemTextureID::kLightSoft));
-    c.DrawMesh(this->shadow_blotch_soft_obj_mesh_.get());
-    c.Submit();
   }
+  auto buffer = Object::New<B>(data.size(), data.data());
+
+  // Should only ever need a few per mesh per frame in flight.
+  if (pool->size() < 16) {
+    pool->push_back(buffer);
+  }
+  return buffer;
+}
+
+void Graphics::DrawBlotchMesh(RenderPass* pass, SystemTextureID texture,
+                              const std::vector<uint16_t>& indices,
+                              const std::vector<VertexSprite>& verts,
+                              Object::Ref<SpriteMesh>* mesh) {
+  if (verts.empty()) {
+    return;
+  }
+  if (!mesh->exists()) {
+    *mesh = Object::New<SpriteMesh>();
+  }
+  (*mesh)->SetIndexData(GetBlotchBuffer(&blotch_index_buffers_, indices));
+  (*mesh)->SetData(Object::Ref<MeshBuffer<VertexSprite> >(
+      GetBlotchBuffer(&blotch_vertex_buffers_, verts)));
+  SpriteComponent c(pass);
+  c.SetTexture(g_media->GetTexture(texture));
+  c.DrawMesh(mesh->get());
+  c.Submit();
+}
+
+void Graphics::DrawBlotches(FrameDef* frame_def) {
+  DrawBlotchMesh(frame_def->light_shadow_pass(), SystemTextureID::kLight,
+                 blotch_indices_, blotch_verts_, &shadow_blotch_mesh_);
+  DrawBlotchMesh(frame_def->light_shadow_pass(), SystemTextureID::kLightSoft,
+                 blotch_soft_indices_, blotch_soft_verts_,
+                 &shadow_blotch_soft_mesh_);
+  DrawBlotchMesh(frame_def->light_pass(), SystemTextureID::kLightSoft,
+                 blotch_soft_obj_indices_, blotch_soft_obj_verts_,
+                 &shadow_blotch_soft_obj_mesh_);
 }
 
 void Graphics::SetSupportsHighQualityGraphics(bool s) {
@@ -1476,9 +1621,53 @@ void Graphics::LocalCameraShake(float mag) {
   }
 }
 
+void Graphics::UpdateGPUTimerString() {
+  Renderer* renderer = g_graphics_server->renderer();
+  if (renderer == nullptr) {
+    return;
+  }
+  auto time = [renderer](RenderPass::Type type) {
+    return renderer->gpu_pass_time(type);
+  };
+  float beauty = time(RenderPass::Type::kBeautyPass);
+  if (beauty < 0.0f) {
+    // No timer support (or no results yet).
+    gpu_timer_string_.clear();
+    return;
+  }
+  float overlay = 0.0f;
+  for (auto type :
+       {RenderPass::Type::kOverlayPass, RenderPass::Type::kOverlayFrontPass,
+        RenderPass::Type::kOverlay3DPass, RenderPass::Type::kOverlayFlatPass,
+        RenderPass::Type::kVRCoverPass, RenderPass::Type::kOverlayFixedPass}) {
+    overlay += std::max(0.0f, time(type));
+  }
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "gpu ms  shadow:%.2f light:%.2f beauty:%.2f bg:%.2f overlay:%.2f "
+           "blit:%.2f",
+           std::max(0.0f, time(RenderPass::Type::kLightShadowPass)),
+           std::max(0.0f, time(RenderPass::Type::kLightPass)), beauty,
+           std::max(0.0f, time(RenderPass::Type::kBeautyPassBG)), overlay,
+           std::max(0.0f, time(RenderPass::Type::kBlitPass)));
+  gpu_timer_string_ = buffer;
+}
+
 void Graphics::ToggleNetworkDebugDisplay() {
   assert(InGameThread());
   network_debug_display_enabled_ = !network_debug_display_enabled_;
+
+  // Pass timing isn't free, so we only have the renderer do it while
+  // we're showing it.
+  bool enabled = network_debug_display_enabled_;
+  g_graphics_server->PushCall([enabled] {
+    if (Renderer* renderer = g_graphics_server->renderer()) {
+      renderer->set_gpu_pass_timers_enabled(enabled);
+    }
+  });
+  if (!enabled) {
+    gpu_timer_string_.clear();
+  }
   if (network_debug_display_enabled_) {
     ScreenMessage("Network Debug Display Enabled");
   } else {
@@ -1596,6 +1785,25 @@ void Graphics::DoDrawBlotch(std::vector<uint16_t>* indices,
   }
 }
 
+auto Graphics::DoAddBlotches(std::vector<uint16_t>* indices,
+                             std::vector<VertexSprite>* verts,
+                             const std::vector<uint16_t>& src_indices,
+                             const std::vector<VertexSprite>& src_verts)
+    -> bool {
+  assert(InGameThread());
+  assert(indices && verts);
+  size_t base = verts->size();
+  if (base + src_verts.size() > 65536) {
+    return false;
+  }
+  verts->insert(verts->end(), src_verts.begin(), src_verts.end());
+  indices->reserve(indices->size() + src_indices.size());
+  for (auto&& i : src_indices) {
+    indices->push_back(static_cast<uint16_t>(base + i));
+  }
+  return true;
+}
+
 void Graphics::DrawRadialMeter(MeshIndexedSimpleFull* m, float amt) {
   // FIXME - we're updating this every frame so we should use pure dynamic data;
   //  not a mix of static and dynamic.
@@ -123,6 +123,19 @@ class Graphics {
                  r, g, b, a);
   }
 
+  // Add already-built blotch quads (such as bg-dynamics shadows) to the
+  // batches above so they go out in the same draw. Returns false if they
+  // won't fit, in which case the caller should draw them itself.
+  auto AddBlotches(const std::vector<uint16_t>& indices,
+                   const std::vector<VertexSprite>& verts) -> bool {
+    return DoAddBlotches(&blotch_indices_, &blotch_verts_, indices, verts);
+  }
+  auto AddBlotchesSoft(const std::vector<uint16_t>& indices,
+                       const std::vector<VertexSprite>& verts) -> bool {
+    return DoAddBlotches(&blotch_soft_indices_, &blotch_soft_verts_, indices,
+                         verts);
+  }
+
   // Enable progress bar drawing locally.
   auto EnableProgressBar(bool fade_in) -> void;
 
@@ -206,6 +219,9 @@ class Graphics {
                       float upper_top) -> void;
   auto ReleaseFadeEndCommand() -> void;
   auto set_show_fps(bool val) -> void { show_fps_ = val; }
+  auto set_show_render_stats(bool val) -> void { show_render_stats_ = val; }
+  auto set_sort_opaque_draws(bool val) -> void { sort_opaque_draws_ = val; }
+  auto sort_opaque_draws() const -> bool { return sort_opaque_draws_; }
 
   // FIXME - move to graphics_server
   auto set_tv_border(bool val) -> void {
@@ -304,6 +320,10 @@ class Graphics {
   class ScreenMessageEntry;
   auto DrawBoxingGlovesTest(FrameDef* frame_def) -> void;
   auto DrawBlotches(FrameDef* frame_def) -> void;
+  auto DrawBlotchMesh(RenderPass* pass, SystemTextureID texture,
+                      const std::vector<uint16_t>& indices,
+                      const std::vector<VertexSprite>& verts,
+                      Object::Ref<SpriteMesh>* mesh) -> void;
   auto DrawCursor(RenderPass* pass, millisecs_t real_time) -> void;
   auto DrawFades(FrameDef* frame_def, millisecs_t real_time) -> void;
   auto DrawDebugBuffers(RenderPass* pass) -> void;
@@ -314,9 +334,14 @@ class Graphics {
   auto DoDrawBlotch(std::vector<uint16_t>* indices,
                     std::vector<VertexSprite>* verts, const Vector3f& pos,
                     float size, float r, float g, float b, float a) -> void;
+  auto DoAddBlotches(std::vector<uint16_t>* indices,
+                     std::vector<VertexSprite>* verts,
+                     const std::vector<uint16_t>& src_indices,
+                     const std::vector<VertexSprite>& src_verts) -> bool;
   auto GetEmptyFrameDef() -> FrameDef*;
   auto InitInternalComponents(FrameDef* frame_def) -> void;
   auto DrawMiscOverlays(RenderPass* pass) -> void;
+  auto UpdateGPUTimerString() -> void;
   auto DrawLoadDot(RenderPass* pass) -> void;
   auto ClearFrameDefDeleteList() -> void;
   auto DrawProgressBar(RenderPass* pass, float opacity) -> void;
@@ -359,11 +384,20 @@ class Graphics {
   Object::Ref<ImageMesh> load_dot_mesh_;
   Object::Ref<TextGroup> fps_text_group_;
   Object::Ref<TextGroup> net_info_text_group_;
+  Object::Ref<TextGroup> gpu_timer_text_group_;
+  Object::Ref<TextGroup> object_pool_text_group_;
+  Object::Ref<TextGroup> memory_stats_text_group_;
+  Object::Ref<TextGroup> input_latency_text_group_;
   Object::Ref<SpriteMesh> shadow_blotch_mesh_;
   Object::Ref<SpriteMesh> shadow_blotch_soft_mesh_;
   Object::Ref<SpriteMesh> shadow_blotch_soft_obj_mesh_;
   std::string fps_string_;
   std::string net_info_string_;
+  std::string gpu_timer_string_;
+  std::string object_pool_string_;
+  std::string memory_stats_string_;
+  millisecs_t last_object_pool_string_time_{};
+  std::string input_latency_string_;
   std::vector<uint16_t> blotch_indices_;
   std::vector<VertexSprite> blotch_verts_;
   std::vector<uint16_t> blotch_soft_indices_;
@@ -371,18 +405,30 @@ class Graphics {
   std::vector<uint16_t> blotch_soft_obj_indices_;
   std::vector<VertexSprite> blotch_soft_obj_verts_;
   bool show_fps_{};
+  bool show_render_stats_{};
+  bool sort_opaque_draws_{true};
   bool show_net_info_{};
   bool tv_border_{};
   bool floor_reflection_{};
   std::map<std::string, Object::Ref<NetGraph> > debug_graphs_;
   std::mutex frame_def_delete_list_mutex_;
   std::vector<FrameDef*> frame_def_delete_list_;
+
+  // Buffers we've handed to blotch meshes. Once nothing else references
+  // one (mesh or in-flight frame-def) we refill it instead of allocating.
+  std::vector<Object::Ref<MeshIndexBuffer16> > blotch_index_buffers_;
+  std::vector<Object::Ref<MeshBufferVertexSprite> > blotch_vertex_buffers_;
   bool debug_draw_{};
   bool network_debug_display_enabled_{};
   Object::Ref<Camera> camera_;
   millisecs_t next_stat_update_time_{};
   int last_total_frames_rendered_{};
   int last_fps_{};
+  int last_render_draws_{};
+  int last_render_programs_{};
+  int last_render_textures_{};
+  int last_render_blend_states_{};
+  int last_culled_draws_{};
   std::list<ScreenMessageEntry> screen_messages_;
   std::list<ScreenMessageEntry> screen_messages_top_;
   bool set_fade_start_on_next_draw_{};
@@ -2,8 +2,15 @@
 
 #include "ballistica/graphics/graphics_server.h"
 
+#include <chrono>
+
+#include "ballistica/core/event_trace.h"
+#include "ballistica/core/startup_timeline.h"
 #include "ballistica/core/thread.h"
+#include "ballistica/graphics/benchmark_recorder.h"
 #include "ballistica/graphics/gl/renderer_gl.h"
+#include "ballistica/input/input_latency.h"
+#include "ballistica/python/python.h"
 #include "ballistica/scene/scene.h"
 
 // FIXME: clear out this conditional stuff.
@@ -50,19 +57,29 @@ void GraphicsServer::SetRenderHold() {
 }
 
 void GraphicsServer::SetFrameDef(FrameDef* framedef) {
-  // Note: we're just setting the framedef directly here
-  // even though this gets called from the game thread.
-  // Ideally it would seem we should push these to our thread
-  // event list, but currently we spin-lock waiting for new
-  // frames to appear which would prevent that from working;
-  // we would need to change that code.
-  assert(frame_def_ == nullptr);
-  frame_def_ = framedef;
+  // Note: this gets called from the game thread; we hand the frame-def
+  // across under our lock and wake the graphics thread if it is waiting
+  // on it.
+  {
+    std::lock_guard<std::mutex> lock(frame_def_mutex_);
+    assert(frame_defs_.size() < kMaxFrameQueueDepth);
+    frame_defs_.push_back(framedef);
+
+    // (The first frame-def is pushed unrequested).
+    if (frame_def_requests_ > 0) {
+      frame_def_requests_--;
+    }
+  }
+  frame_def_cv_.notify_one();
+}
+
+void GraphicsServer::SetFrameQueueDepth(int depth) {
+  std::lock_guard<std::mutex> lock(frame_def_mutex_);
+  frame_queue_depth_ = std::min(kMaxFrameQueueDepth, std::max(1, depth));
 }
 
 auto GraphicsServer::GetRenderFrameDef() -> FrameDef* {
   assert(InGraphicsThread());
-  millisecs_t real_time = GetRealTime();
 
   if (!renderer_) {
     return nullptr;
@@ -77,32 +94,36 @@ auto GraphicsServer::GetRenderFrameDef() -> FrameDef* {
   // Do some incremental loading every time we try to render.
   g_media->RunPendingGraphicsLoads();
 
-  // Spin and wait for a short bit for a frame_def to appear. If it does, we
-  // grab it, render it, and also message the game thread to start generating
-  // another one.
-  while (true) {
-    if (frame_def_) {
-      FrameDef* frame_def = frame_def_;
-      frame_def_ = nullptr;
-
-      // Tell the game thread we're ready for the next frame_def so it can start
-      // building it while we render this one.
-      g_game->PushFrameDefRequest();
-      return frame_def;
+  // Wait a short bit for a frame_def to appear. If it does, we grab it,
+  // render it, and also message the game thread to start generating more.
+  // If we've been waiting for too long, give up. On some platforms such as
+  // android, this frame will still get flipped whether we draw in it or
+  // not, so we really dont want to not draw if we can help it.
+  FrameDef* frame_def{};
+  int requests{};
+  {
+    std::unique_lock<std::mutex> lock(frame_def_mutex_);
+    if (!frame_def_cv_.wait_for(lock, std::chrono::seconds(1),
+                                [this] { return !frame_defs_.empty(); })) {
+      return nullptr;  // Fail.
     }
-
-    // If there's no frame_def for us, sleep for a bit and wait for it.
-    // But if we've been waiting for too long, give up.
-    // On some platforms such as android, this frame will still get flipped
-    // whether we draw in it or not, so we really dont want to not draw if we
-    // can help it.
-    millisecs_t t = GetRealTime() - real_time;
-    if (t >= 1000) {
-      break;  // Fail.
+    frame_def = frame_defs_.front();
+    frame_defs_.pop_front();
+
+    // Keep the game thread working on as many as our depth allows.
+    requests = frame_queue_depth_ - static_cast<int>(frame_defs_.size())
+               - frame_def_requests_;
+    if (requests > 0) {
+      frame_def_requests_ += requests;
     }
-    Platform::SleepMS(2);
   }
-  return nullptr;
+
+  // Tell the game thread we're ready for the next frame_def(s) so it can
+  // start building while we render this one.
+  for (int i = 0; i < requests; i++) {
+    g_game->PushFrameDefRequest();
+  }
+  return frame_def;
 }
 
 // Runs any mesh updates contained in the frame-def.
@@ -133,6 +154,7 @@ void GraphicsServer::PreprocessRenderFrameDef(FrameDef* frame_def) {
 // Does the default drawing to the screen, either from the left or right stereo
 // eye or in mono.
 void GraphicsServer::DrawRenderFrameDef(FrameDef* frame_def, int eye) {
+  BA_TRACE_SCOPE("GraphicsServer::DrawRenderFrameDef");
   renderer_->RenderFrameDef(frame_def);
 }
 
@@ -142,6 +164,8 @@ void GraphicsServer::FinishRenderFrameDef(FrameDef* frame_def) {
 
   // Let the app know a frame render is complete (it may need to do a swap/etc).
   g_app->DidFinishRenderingFrame(frame_def);
+  InputLatency::NoteFrameSwapped(frame_def);
+  StartupTimeline::NoteFirstFrame();
 }
 
 void GraphicsServer::TryRender() {
@@ -159,9 +183,20 @@ void GraphicsServer::TryRender() {
     // Only actually render if we have a screen and aren't in a hold.
     auto target = renderer()->screen_render_target();
     if (target != nullptr && render_hold_ == 0) {
+      bool benchmarking = BenchmarkRecorder::recording();
+      std::chrono::steady_clock::time_point render_start_time;
+      if (benchmarking) {
+        render_start_time = std::chrono::steady_clock::now();
+      }
       PreprocessRenderFrameDef(frame_def);
       DrawRenderFrameDef(frame_def);
       FinishRenderFrameDef(frame_def);
+      if (benchmarking) {
+        BenchmarkRecorder::AddFrameRender(
+            std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                          - render_start_time)
+                .count());
+      }
     }
 
     // Send this frame_def back to the game thread for deletion.
@@ -251,6 +286,7 @@ void GraphicsServer::SetScreen(bool fullscreen, int width, int height,
                                GraphicsQuality graphics_quality_requested,
                                const std::string& android_res) {
   assert(InGraphicsThread());
+  StartupTimeline::Scope timeline_scope("set screen");
 
   // If we know what we support, filter out requests we don't support
   // (will keep us from rebuilding contexts due to our requested and actual
@@ -410,8 +446,9 @@ void GraphicsServer::HandleFullContextScreenRebuild(
 
   // Update graphics quality.
   quality_requested_ = graphics_quality_requested;
+  quality_calibrated_ = false;
   if (quality_requested_ == GraphicsQuality::kAuto) {
-    quality_actual_ = renderer_->GetAutoGraphicsQuality();
+    quality_actual_ = GetAutoGraphicsQuality();
   } else {
     quality_actual_ = quality_requested_;
   }
@@ -429,13 +466,22 @@ void GraphicsServer::HandleFullContextScreenRebuild(
   texture_quality_requested_ = texture_quality_requested;
   if (texture_quality_requested_ == TextureQuality::kAuto) {
     texture_quality_actual_ = renderer_->GetAutoTextureQuality();
+
+    // Hardware that only measured up to low quality probably shouldn't be
+    // spending its bandwidth on full-res textures either.
+    if (quality_calibrated_ && quality_actual_ == GraphicsQuality::kLow
+        && texture_quality_actual_ == TextureQuality::kHigh) {
+      texture_quality_actual_ = TextureQuality::kMedium;
+    }
   } else {
     texture_quality_actual_ = texture_quality_requested_;
   }
   texture_quality_set_ = true;
 
   // Ok we've got our qualities figured out; now load/update the renderer.
+  StartupTimeline::Begin("renderer load");
   renderer_->Load();
+  StartupTimeline::End("renderer load");
 
   // Also (re)load all existing dynamic meshes.
   for (auto&& i : mesh_datas_) {
@@ -463,6 +509,49 @@ void GraphicsServer::HandleFullContextScreenRebuild(
 
 #pragma clang diagnostic pop
 
+auto GraphicsServer::GetAutoGraphicsQuality() -> GraphicsQuality {
+  assert(InGraphicsThread());
+  std::string key = renderer_->GetQualityCalibrationKey();
+  if (key.empty()) {
+    return renderer_->GetAutoGraphicsQuality();
+  }
+
+  // Only measure on first launch or after the gpu, driver or os changes.
+  if (key != quality_calibration_key_
+      || quality_calibration_ == GraphicsQuality::kAuto) {
+    quality_calibration_ = renderer_->CalibrateGraphicsQuality();
+    quality_calibration_key_ = key;
+
+    // Store the results so we don't measure again next launch.
+    std::string quality_name = GetGraphicsQualityName(quality_calibration_);
+    g_game->PushCall([key, quality_name] {
+      g_python->SetRawConfigValue("Graphics Calibration Key", key);
+      g_python->SetRawConfigValue("Graphics Calibration Quality",
+                                  quality_name);
+      g_python->obj(Python::ObjID::kConfig).GetAttr("commit").Call();
+    });
+  }
+  quality_calibrated_ = true;
+  return quality_calibration_;
+}
+
+auto GraphicsServer::GetGraphicsQualityName(GraphicsQuality quality)
+    -> std::string {
+  switch (quality) {
+    case GraphicsQuality::kLow:
+      return "Low";
+    case GraphicsQuality::kMedium:
+      return "Medium";
+    case GraphicsQuality::kHigh:
+      return "High";
+    case GraphicsQuality::kHigher:
+      return "Higher";
+    case GraphicsQuality::kAuto:
+      return "Auto";
+  }
+  return "Auto";
+}
+
 // Given physical res, calculate virtual res.
 void GraphicsServer::CalcVirtualRes(float* x, float* y) {
   float x_in = (*x);
@@ -700,6 +789,15 @@ void GraphicsServer::PushSetScreenCall(bool fullscreen, int width, int height,
   });
 }
 
+void GraphicsServer::PushSetQualityCalibrationCall(const std::string& key,
+                                                   GraphicsQuality quality) {
+  PushCall([this, key, quality] {
+    assert(InGraphicsThread());
+    quality_calibration_key_ = key;
+    quality_calibration_ = quality;
+  });
+}
+
 void GraphicsServer::PushReloadMediaCall() {
   PushCall([this] { ReloadMedia(); });
 }
@@ -724,6 +822,18 @@ void GraphicsServer::PushSetScreenPixelScaleCall(float pixel_scale) {
   });
 }
 
+void GraphicsServer::PushSetCameraRenderScaleCall(float scale,
+                                                  float dynamic_target) {
+  PushCall([this, scale, dynamic_target] {
+    assert(InGraphicsThread());
+    if (!renderer_) {
+      return;
+    }
+    renderer_->set_camera_render_scale(scale);
+    renderer_->set_dynamic_resolution_target(dynamic_target);
+  });
+}
+
 void GraphicsServer::PushSetVSyncCall(bool sync, bool auto_sync) {
   PushCall([this, sync, auto_sync] {
     assert(InGraphicsThread());
@@ -766,6 +876,17 @@ void GraphicsServer::PushComponentUnloadCall(
   });
 }
 
+void GraphicsServer::PushComponentReloadCall(
+    const std::vector<Object::Ref<MediaComponentData>*>& components) {
+  PushCall([components] {
+    for (auto&& i : components) {
+      (**i).Unload();
+    }
+    g_game->PushCall(
+        [components] { g_media->MarkComponentsForReload(components); });
+  });
+}
+
 void GraphicsServer::PushRemoveRenderHoldCall() {
   PushCall([this] {
     assert(render_hold_);
@@ -3,8 +3,11 @@
 #ifndef BALLISTICA_GRAPHICS_GRAPHICS_SERVER_H_
 #define BALLISTICA_GRAPHICS_GRAPHICS_SERVER_H_
 
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -22,15 +25,28 @@ class GraphicsServer : public Module {
   explicit GraphicsServer(Thread* thread);
   auto PushSetScreenGammaCall(float gamma) -> void;
   auto PushSetScreenPixelScaleCall(float pixel_scale) -> void;
+  auto PushSetCameraRenderScaleCall(float scale, float dynamic_target)
+      -> void;
   auto PushSetVSyncCall(bool sync, bool auto_sync) -> void;
   auto PushSetScreenCall(bool fullscreen, int width, int height,
                          TextureQuality texture_quality,
                          GraphicsQuality graphics_quality,
                          const std::string& android_res) -> void;
+
+  /// Pass along the results of a previous graphics quality calibration
+  /// (from the config) so auto quality can skip measuring again when the
+  /// key still matches. Should be pushed before the screen is set.
+  auto PushSetQualityCalibrationCall(const std::string& key,
+                                     GraphicsQuality quality) -> void;
   auto PushReloadMediaCall() -> void;
   auto PushRemoveRenderHoldCall() -> void;
   auto PushComponentUnloadCall(
       const std::vector<Object::Ref<MediaComponentData>*>& components) -> void;
+
+  /// Like PushComponentUnloadCall but hands the components to Media to be
+  /// loaded again afterwards instead of freeing them.
+  auto PushComponentReloadCall(
+      const std::vector<Object::Ref<MediaComponentData>*>& components) -> void;
   auto SetRenderHold() -> void;
 
   // Used by the game thread to pass frame-defs to the graphics server
@@ -43,6 +59,13 @@ class GraphicsServer : public Module {
   // of using the RenderFrameDef* calls
   auto GetRenderFrameDef() -> FrameDef*;
 
+  // How many frame-defs the game thread may have built or be building ahead
+  // of the one we're rendering (1 or 2). 1 gives the least latency; 2 can
+  // smooth over uneven game-thread frame times. Can be called from any
+  // thread.
+  static const int kMaxFrameQueueDepth = 2;
+  auto SetFrameQueueDepth(int depth) -> void;
+
   auto RunFrameDefMeshUpdates(FrameDef* frame_def) -> void;
 
   // renders shadow passes and other common parts of a frame_def
@@ -238,6 +261,8 @@ class GraphicsServer : public Module {
   auto gl_context() const -> GLContext* { return gl_context_.get(); }
 #endif
 
+  static auto GetGraphicsQualityName(GraphicsQuality quality) -> std::string;
+
   auto graphics_quality_requested() const { return quality_requested_; }
   auto texture_quality_requested() const { return texture_quality_requested_; }
   auto renderer() const { return renderer_; }
@@ -252,6 +277,9 @@ class GraphicsServer : public Module {
       GraphicsQuality graphics_quality_requested,
       TextureQuality texture_quality_requested) -> void;
 
+  // Auto graphics quality; calibrated if the renderer supports it.
+  auto GetAutoGraphicsQuality() -> GraphicsQuality;
+
   // Update virtual screen dimensions based on the current physical ones.
   static auto CalcVirtualRes(float* x, float* y) -> void;
 
@@ -289,6 +317,9 @@ class GraphicsServer : public Module {
   GraphicsQuality quality_actual_{GraphicsQuality::kLow};
   bool graphics_quality_set_{};
   bool texture_quality_set_{};
+  std::string quality_calibration_key_;
+  GraphicsQuality quality_calibration_{GraphicsQuality::kAuto};
+  bool quality_calibrated_{};
   bool fullscreen_enabled_{};
   float target_res_x_{800.0f};
   float target_res_y_{600.0f};
@@ -321,7 +352,13 @@ class GraphicsServer : public Module {
                  const std::string& android_res) -> void;
   Timer* render_timer_{};
   Renderer* renderer_{};
-  FrameDef* frame_def_{};
+
+  // Frame-defs handed over by the game thread; guarded by frame_def_mutex_.
+  std::mutex frame_def_mutex_;
+  std::condition_variable frame_def_cv_;
+  std::deque<FrameDef*> frame_defs_;
+  int frame_def_requests_{};
+  int frame_queue_depth_{1};
   bool initial_screen_created_{};
   int render_hold_{};
 #if BA_OSTYPE_MACOS && BA_XCODE_BUILD
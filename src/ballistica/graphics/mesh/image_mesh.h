@@ -17,6 +17,14 @@ class ImageMesh : public MeshIndexedSimpleSplit {
                                            {x + width, y, z},
                                            {x, y + height, z},
                                            {x + width, y + height, z}};
+
+    // Most users set this every frame with the same values; in that case
+    // just keep our existing data so it doesn't get re-uploaded.
+    if (dynamic_data().exists() && dynamic_data()->elements.size() == 4
+        && !memcmp(dynamic_data()->elements.data(), vdynamic,
+                   sizeof(vdynamic))) {
+      return;
+    }
     SetDynamicData(
         Object::New<MeshBuffer<VertexSimpleSplitDynamic>>(4, vdynamic));
   }
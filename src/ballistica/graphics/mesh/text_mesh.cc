@@ -9,6 +9,10 @@
 
 namespace ballistica {
 
+// Strings longer than this don't get glyph-run caching; they're
+// generally one-off blocks of text that won't be set again.
+const int kMaxCachedGlyphRunSize = 256;
+
 TextMesh::TextMesh() : MeshIndexedDualTextureFull(MeshDrawType::kStatic) {}
 
 void TextMesh::SetText(const std::string& text_in, HAlign alignment_h,
@@ -38,12 +42,37 @@ void TextMesh::SetText(const std::string& text_in, HAlign alignment_h,
     assert(packer != nullptr);
   }
 
-  // Start buffers big enough to handle the worst case
-  // (every char being a discrete letter).
   int text_size = static_cast<int>(text_in.size());
   assert(text_size > 0);
   Object::Ref<MeshIndexBuffer16> indices16;
   Object::Ref<MeshIndexBuffer32> indices32;
+  auto vertices(Object::New<MeshBuffer<VertexDualTextureFull>>());
+
+  // Glyph layout for anything not involving the OS depends only on our
+  // args, so short strings get looked up in (and added to) the glyph-run
+  // cache. (OS-rendered text has to go through its packer each time).
+  std::string cache_key;
+  if (packer == nullptr && text_size <= kMaxCachedGlyphRunSize) {
+    cache_key = text_in;
+    cache_key.push_back('\0');
+    cache_key.push_back(static_cast<char>(alignment_h));
+    cache_key.push_back(static_cast<char>(alignment_v));
+    cache_key.push_back(static_cast<char>(big));
+    cache_key.push_back(static_cast<char>(entry_type));
+    cache_key.append(reinterpret_cast<const char*>(&min_val), sizeof(min_val));
+    cache_key.append(reinterpret_cast<const char*>(&max_val), sizeof(max_val));
+    indices16 = Object::New<MeshIndexBuffer16>();
+    if (g_text_graphics->GetCachedGlyphRun(cache_key, &vertices->elements,
+                                           &indices16->elements)) {
+      if (indices16->elements.empty()) {
+        SetEmpty();
+      } else {
+        SetIndexData(indices16);
+        SetData(vertices);
+      }
+      return;
+    }
+  }
 
   // Go with 32 bit indices if there's any chance we'll have over 65535 pts;
   // otherwise go with 16 bit.
@@ -52,11 +81,17 @@ void TextMesh::SetText(const std::string& text_in, HAlign alignment_h,
   // It may be worth adding logic to split up meshes into multiple
   // draw-calls. (or we can just wait until ES2 is dead).
   if (explicit_bool(false) && 4 * text_size > 65535) {
+    indices16.Clear();
     indices32 = Object::New<MeshIndexBuffer32>(6 * (text_size));
   } else {
-    indices16 = Object::New<MeshIndexBuffer16>(6 * (text_size));
+    // Start buffers big enough to handle the worst case
+    // (every char being a discrete letter).
+    if (!indices16.exists()) {
+      indices16 = Object::New<MeshIndexBuffer16>();
+    }
+    indices16->elements.resize(6 * text_size);
   }
-  auto vertices(Object::New<MeshBuffer<VertexDualTextureFull>>(4 * text_size));
+  vertices->elements.resize(4 * text_size);
 
   uint16_t* index16 = indices16.exists() ? indices16->elements.data() : nullptr;
   uint32_t* index32 = indices32.exists() ? indices32->elements.data() : nullptr;
@@ -535,6 +570,11 @@ void TextMesh::SetText(const std::string& text_in, HAlign alignment_h,
   }
   vertices->elements.resize(v - (&(vertices->elements[0])));
 
+  if (index16 && !cache_key.empty()) {
+    g_text_graphics->CacheGlyphRun(cache_key, vertices->elements,
+                                   indices16->elements);
+  }
+
   // Either set data or abort if empty.
   if (index16 && !indices16->elements.empty()) {
     SetIndexData(indices16);
@@ -0,0 +1,127 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/graphics/render_command_buffer.h"
+
+#include <algorithm>
+
+namespace ballistica {
+
+auto RenderCommandBuffer::SortSegments() -> bool {
+  assert(finalized_);
+  segment_order_.resize(0);
+  if (segments_.size() < 2 || segments_[0].commands != 0) {
+    return false;
+  }
+
+  // Make sure each segment cleans up after itself; otherwise its neighbors
+  // depend on it and we can't move things around.
+  uint32_t seg_index{};
+  int depth{};
+  bool flipped{};
+  for (uint32_t i = 0; i < commands_.size(); i++) {
+    if (seg_index + 1 < segments_.size()
+        && segments_[seg_index + 1].commands == i) {
+      if (depth != 0 || flipped) {
+        return false;
+      }
+      seg_index++;
+    }
+    switch (commands_[i]) {
+      case Command::kPushTransform:
+        depth++;
+        break;
+      case Command::kPopTransform:
+        if (depth == 0) {
+          return false;
+        }
+        depth--;
+        break;
+      case Command::kTranslate2:
+      case Command::kTranslate3:
+      case Command::kCursorTranslate:
+      case Command::kScaleUniform:
+      case Command::kTranslateToProjectedPoint:
+#if BA_VR_BUILD
+      case Command::kTransformToRightHand:
+      case Command::kTransformToLeftHand:
+      case Command::kTransformToHead:
+#endif
+      case Command::kScale2:
+      case Command::kScale3:
+      case Command::kRotate:
+      case Command::kMultMatrix:
+        if (depth == 0) {
+          return false;
+        }
+        break;
+      case Command::kFlipCullFace:
+        flipped = !flipped;
+        break;
+      case Command::kScissorPush:
+      case Command::kScissorPop:
+        return false;
+      default:
+        break;
+    }
+  }
+  if (depth != 0 || flipped) {
+    return false;
+  }
+
+  // Key each segment by the textures it binds and the first thing it draws;
+  // those are the state changes the renderer can skip when neighbors match.
+  // (Everything in a single list shares a shader and blend/depth state).
+  // The key list is a member so it keeps its capacity across frames.
+  std::vector<SortKey>& keys{sort_keys_};
+  keys.resize(segments_.size());
+  for (uint32_t s = 0; s < segments_.size(); s++) {
+    bool last = (s + 1 == segments_.size());
+    auto tex_end = static_cast<uint32_t>(last ? textures_.size()
+                                              : segments_[s + 1].textures);
+    auto models_end = static_cast<uint32_t>(last ? models_.size()
+                                                 : segments_[s + 1].models);
+    auto meshes_end = static_cast<uint32_t>(
+        last ? mesh_datas_.size() : segments_[s + 1].mesh_datas);
+    const Segment& seg{segments_[s]};
+    SortKey& key{keys[s]};
+    key.tex0 = (seg.textures < tex_end)
+                   ? reinterpret_cast<uintptr_t>(textures_[seg.textures])
+                   : 0;
+    key.tex1 = (seg.textures + 1 < tex_end)
+                   ? reinterpret_cast<uintptr_t>(textures_[seg.textures + 1])
+                   : 0;
+    if (seg.models < models_end) {
+      key.geom = reinterpret_cast<uintptr_t>(models_[seg.models]);
+    } else if (seg.mesh_datas < meshes_end) {
+      key.geom = reinterpret_cast<uintptr_t>(mesh_datas_[seg.mesh_datas]);
+    } else {
+      key.geom = 0;
+    }
+  }
+
+  segment_order_.resize(segments_.size());
+  for (uint32_t s = 0; s < segments_.size(); s++) {
+    segment_order_[s] = s;
+  }
+
+  // Ties fall back to submission order, which keeps this stable without
+  // the temp buffer std::stable_sort allocates on every call.
+  std::sort(segment_order_.begin(), segment_order_.end(),
+            [&keys](uint32_t a, uint32_t b) {
+              const SortKey& ka{keys[a]};
+              const SortKey& kb{keys[b]};
+              if (ka.tex0 != kb.tex0) {
+                return ka.tex0 < kb.tex0;
+              }
+              if (ka.tex1 != kb.tex1) {
+                return ka.tex1 < kb.tex1;
+              }
+              if (ka.geom != kb.geom) {
+                return ka.geom < kb.geom;
+              }
+              return a < b;
+            });
+  return true;
+}
+
+}  // namespace ballistica
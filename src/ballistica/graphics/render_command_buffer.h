@@ -16,7 +16,7 @@ namespace ballistica {
 
 class RenderCommandBuffer {
  public:
-  // IMPORTANT: make sure to update has_draw_commands with any new
+  // IMPORTANT: make sure to update IsDrawCommand() with any new
   // ones added here.
   enum class Command {
     kEnd,
@@ -56,6 +56,21 @@ class RenderCommandBuffer {
   RenderCommandBuffer() = default;
   void PutCommand(Command c) {
     assert(!finalized_);
+
+    // Each shader command begins a new segment (one component's worth of
+    // config and draws); we keep track of where these start so we can
+    // optionally reorder them later.
+    if (c == Command::kShader) {
+      segments_.push_back({static_cast<uint32_t>(commands_.size()),
+                           static_cast<uint32_t>(fvals_.size()),
+                           static_cast<uint32_t>(ivals_.size()),
+                           static_cast<uint32_t>(models_.size()),
+                           static_cast<uint32_t>(textures_.size()),
+                           static_cast<uint32_t>(mesh_datas_.size())});
+    }
+    if (IsDrawCommand(c)) {
+      has_draw_commands_ = true;
+    }
     commands_.push_back(c);
   }
 
@@ -289,9 +304,17 @@ class RenderCommandBuffer {
   // Return next item.
   auto GetCommand() -> Command {
     assert(finalized_);
-    assert(commands_index_ <= commands_.size());
-    return (commands_index_ == commands_.size()) ? Command::kEnd
-                                                 : commands_[commands_index_++];
+    assert(commands_index_ <= commands_end_);
+    if (commands_index_ == commands_end_) {
+      // If we've been sorted, hop to the next segment in our order.
+      if (segment_order_.empty()
+          || read_segment_ + 1 >= segment_order_.size()) {
+        return Command::kEnd;
+      }
+      read_segment_++;
+      ReadSegment(segment_order_[read_segment_]);
+    }
+    return commands_[commands_index_++];
   }
 
   auto GetInt() -> int {
@@ -504,9 +527,19 @@ class RenderCommandBuffer {
     models_.resize(0);
     textures_.resize(0);
     mesh_datas_.resize(0);
+    segments_.resize(0);
+    segment_order_.resize(0);
+    has_draw_commands_ = false;
     finalized_ = false;
   }
 
+  // Reorder our segments to minimize texture and geometry changes between
+  // them. This should only be used on opaque lists where draw order does
+  // not affect the result. Must be called after Finalize(). Returns false
+  // (and leaves the order untouched) if any segment leaks state into the
+  // ones after it (unbalanced transforms, cull flips, scissoring, etc.).
+  auto SortSegments() -> bool;
+
   // Call once done writing to buffer.
   void Finalize() {
     assert(!finalized_);
@@ -516,30 +549,28 @@ class RenderCommandBuffer {
   // Set up iterators to read back data.
   void ReadBegin() {
     assert(finalized_);
+    if (!segment_order_.empty()) {
+      read_segment_ = 0;
+      ReadSegment(segment_order_[0]);
+      return;
+    }
     commands_index_ = 0;
+    commands_end_ = static_cast<uint32_t>(commands_.size());
     fvals_index_ = 0;
     ivals_index_ = 0;
     models_index_ = 0;
     textures_index_ = 0;
     mesh_datas_index_ = 0;
   }
-  auto has_draw_commands() const -> bool {
-    for (auto& command : commands_) {
-      switch (command) {
-        case Command::kDrawModel:
-        case Command::kDrawModelInstanced:
-        case Command::kDrawMesh:
-        case Command::kDrawScreenQuad:
-          return true;
-        default:
-          break;
-      }
-    }
-    return false;
-  }
+  auto has_draw_commands() const -> bool { return has_draw_commands_; }
 
   // Sanity check: Makes sure all buffer iterators are at their end.
   auto IsEmpty() -> bool {
+    // When reading in sorted order we end wherever the last segment does.
+    if (!segment_order_.empty()) {
+      return read_segment_ + 1 == segment_order_.size()
+             && commands_index_ == commands_end_;
+    }
     return (
         (commands_index_ == commands_.size()) && (fvals_index_ == fvals_.size())
         && (ivals_index_ == ivals_.size()) && (models_index_ == models_.size())
@@ -555,18 +586,67 @@ class RenderCommandBuffer {
   void set_frame_def(FrameDef* f) { frame_def_ = f; }
 
  private:
+  struct Segment {
+    uint32_t commands;
+    uint32_t fvals;
+    uint32_t ivals;
+    uint32_t models;
+    uint32_t textures;
+    uint32_t mesh_datas;
+  };
+
+  // What SortSegments() orders segments by.
+  struct SortKey {
+    uintptr_t tex0;
+    uintptr_t tex1;
+    uintptr_t geom;
+  };
+
+  static auto IsDrawCommand(Command c) -> bool {
+    switch (c) {
+      case Command::kDrawModel:
+      case Command::kDrawModelInstanced:
+      case Command::kDrawMesh:
+      case Command::kDrawScreenQuad:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Point our read iterators at the start of a segment.
+  void ReadSegment(uint32_t index) {
+    assert(index < segments_.size());
+    const Segment& seg{segments_[index]};
+    commands_index_ = seg.commands;
+    commands_end_ = (index + 1 < segments_.size())
+                        ? segments_[index + 1].commands
+                        : static_cast<uint32_t>(commands_.size());
+    fvals_index_ = seg.fvals;
+    ivals_index_ = seg.ivals;
+    models_index_ = seg.models;
+    textures_index_ = seg.textures;
+    mesh_datas_index_ = seg.mesh_datas;
+  }
+
   std::vector<Command> commands_;
   std::vector<float> fvals_;
   std::vector<int> ivals_;
   std::vector<ModelData*> models_{};
   std::vector<TextureData*> textures_{};
   std::vector<MeshData*> mesh_datas_{};
+  std::vector<Segment> segments_;
+  std::vector<uint32_t> segment_order_;
+  std::vector<SortKey> sort_keys_;
+  uint32_t read_segment_{};
+  uint32_t commands_end_{};
   unsigned int commands_index_{};
   unsigned int fvals_index_{};
   unsigned int ivals_index_{};
   unsigned int models_index_{};
   unsigned int textures_index_{};
   unsigned int mesh_datas_index_{};
+  bool has_draw_commands_{};
   bool finalized_{};
   FrameDef* frame_def_{};
 };
@@ -13,6 +13,10 @@ namespace ballistica {
 const float kCamNearClip = 4.0f;
 const float kCamFarClip = 1000.0f;
 
+// In reduced-quality reflections, we skip reflecting things whose radius
+// is less than this fraction of their distance from the camera.
+const float kReflectionMinSizeRatio = 0.02f;
+
 RenderPass::RenderPass(RenderPass::Type type_in, FrameDef* frame_def_in)
     : type_(type_in), frame_def_(frame_def_in) {
   // Create/init our command buffers.
@@ -44,6 +48,7 @@ void RenderPass::Render(RenderTarget* render_target, bool transparent) {
 #undef DRAW_TRANSPRENT
 
   Renderer* renderer = g_graphics_server->renderer();
+  renderer->BeginGPUPassTimer(type());
 
   // Set up camera & depth.
   switch (type()) {
@@ -268,9 +273,13 @@ void RenderPass::Render(RenderTarget* render_target, bool transparent) {
       bool doing_reflection = false;
       if (reflection_sub_pass == ReflectionSubPass::kMirrored) {
         // Only actually draw reflection pass if quality >= high
-        // and floor-reflections are on.
+        // and floor-reflections are on. High quality gets reduced
+        // reflections (opaque stuff only, and see IsReflectionCulled());
+        // higher gets everything.
         if (floor_reflection()
-            && frame_def()->quality() >= GraphicsQuality::kHigher) {
+            && frame_def()->quality() >= GraphicsQuality::kHigh
+            && (!transparent
+                || frame_def()->quality() >= GraphicsQuality::kHigher)) {
           doing_reflection = true;
           renderer->set_drawing_reflection(true);
           g_graphics_server->PushTransform();
@@ -360,6 +369,7 @@ void RenderPass::Render(RenderTarget* render_target, bool transparent) {
                                            render_target);
     }
   }
+  renderer->EndGPUPassTimer();
 }
 
 void RenderPass::SetCamera(
@@ -380,9 +390,104 @@ void RenderPass::SetCamera(
   cam_fov_b_tan_ = fov_tan_b;
   cam_fov_t_tan_ = fov_tan_t;
   cam_area_of_interest_points_ = area_of_interest_points;
+  UpdateCullPlanes();
+}
+
+void RenderPass::UpdateCullPlanes() {
+  cull_enabled_ = false;
+  if (type_ != Type::kBeautyPass || IsVRMode()) {
+    return;
+  }
+  Vector3f forward = (cam_target_ - cam_pos_).Normalized();
+  Vector3f side = Vector3f::Cross(forward, cam_up_).Normalized();
+  Vector3f up = Vector3f::Cross(side, forward);
+
+  // Same frustum shape SetFrustum() will give the renderer.
+  float tan_l, tan_r, tan_b, tan_t;
+  if (cam_use_fov_tangents_) {
+    tan_l = cam_fov_l_tan_;
+    tan_r = cam_fov_r_tan_;
+    tan_b = cam_fov_b_tan_;
+    tan_t = cam_fov_t_tan_;
+  } else {
+    tan_b = tan_t = tanf((cam_fov_y_ / 2.0f) * kPi / 180.0f);
+    if (cam_fov_x_ > 0.0f) {
+      tan_l = tan_r = tanf((cam_fov_x_ / 2.0f) * kPi / 180.0f);
+    } else {
+      tan_l = tan_r = tan_t * GetPhysicalAspectRatio();
+    }
+  }
+  cull_normals_[0] = (side - forward * tan_r).Normalized();
+  cull_normals_[1] = (-side - forward * tan_l).Normalized();
+  cull_normals_[2] = (up - forward * tan_t).Normalized();
+  cull_normals_[3] = (-up - forward * tan_b).Normalized();
+  cull_normals_[4] = -forward;
+  cull_normals_[5] = forward;
+  for (int i = 0; i < 6; i++) {
+    cull_offsets_[i] = -cull_normals_[i].Dot(cam_pos_);
+  }
+  cull_offsets_[4] += cam_near_clip_;
+  cull_offsets_[5] -= cam_far_clip_;
+  cull_enabled_ = true;
+}
+
+auto RenderPass::SphereOutsideCullPlanes(const Vector3f& center,
+                                         float radius) const -> bool {
+  for (int i = 0; i < 6; i++) {
+    if (cull_normals_[i].Dot(center) + cull_offsets_[i] > radius) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto RenderPass::IsReflectionCulled(const Vector3f& center,
+                                    float radius) const -> bool {
+  // Reflections get mirrored across y=0.
+  Vector3f mirrored{center.x, -center.y, center.z};
+  if (SphereOutsideCullPlanes(mirrored, radius)) {
+    return true;
+  }
+
+  // Reduced reflections also leave out stuff too small on screen to
+  // notice.
+  if (frame_def()->quality() < GraphicsQuality::kHigher) {
+    float dist = (mirrored - cam_pos_).Length();
+    if (radius < dist * kReflectionMinSizeRatio) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto RenderPass::CullSphere(const Vector3f& center, float radius,
+                            bool* reflection_culled) -> bool {
+  if (reflection_culled) {
+    *reflection_culled = false;
+  }
+  if (!cull_enabled_) {
+    return false;
+  }
+  bool culled = SphereOutsideCullPlanes(center, radius);
+
+  // If we draw a floor reflection, stuff needs to be out of view there
+  // too.
+  if (floor_reflection_ && frame_def()->quality() >= GraphicsQuality::kHigh) {
+    bool reflection_out = IsReflectionCulled(center, radius);
+    if (reflection_culled) {
+      *reflection_culled = reflection_out;
+    }
+    culled = culled && reflection_out;
+  }
+  if (culled) {
+    culled_count_++;
+  }
+  return culled;
 }
 
 void RenderPass::Reset() {
+  cull_enabled_ = false;
+  culled_count_ = 0;
   virtual_width_ = 0;
   virtual_height_ = 0;
   physical_width_ = 0;
@@ -486,6 +591,22 @@ void RenderPass::Finalize() {
     for (auto& command : commands_) {
       command->Finalize();
     }
+
+    // Draw order doesn't matter for opaque world stuff (we've got depth
+    // testing), so optionally group those by texture/geometry to cut down
+    // on state changes in the renderer. (The bg pass is left alone; skies
+    // and such there may be layered).
+    if (type_ == Type::kBeautyPass && g_graphics->sort_opaque_draws()) {
+      for (int i = 0; i < static_cast<int>(ShadingType::kCount); i++) {
+        auto shading_type = static_cast<ShadingType>(i);
+        if (shading_type != ShadingType::kPostProcess
+            && shading_type != ShadingType::kPostProcessEyes
+            && shading_type != ShadingType::kPostProcessNormalDistort
+            && !Graphics::IsShaderTransparent(shading_type)) {
+          commands_[i]->SortSegments();
+        }
+      }
+    }
   } else {
     commands_flat_->Finalize();
     commands_flat_transparent_->Finalize();
@@ -123,8 +123,25 @@ class RenderPass {
     return cam_area_of_interest_points_;
   }
 
+  // Returns true if a world-space sphere is guaranteed to be invisible in
+  // this pass (including its floor reflection if there is one), in which
+  // case callers can skip drawing whatever it bounds. This always returns
+  // false for passes we can't cull in (only the beauty pass culls, and not
+  // in VR where eye cameras get applied later).
+  // If reflection_culled is passed, it is set to whether just the sphere's
+  // floor reflection can be skipped (see kModelDrawFlagNoReflection).
+  auto CullSphere(const Vector3f& center, float radius,
+                  bool* reflection_culled = nullptr) -> bool;
+
+  // Number of CullSphere() calls that returned true since our last reset.
+  auto culled_count() const -> int { return culled_count_; }
+
  private:
   void SetFrustum(float near_val, float far_val);
+  void UpdateCullPlanes();
+  auto SphereOutsideCullPlanes(const Vector3f& center, float radius) const
+      -> bool;
+  auto IsReflectionCulled(const Vector3f& center, float radius) const -> bool;
 
   // Our pass holds sets of draw-commands bucketed by section and
   // component-type.
@@ -160,6 +177,12 @@ class RenderPass {
   float physical_height_{};
   float virtual_width_{};
   float virtual_height_{};
+
+  // World-space frustum planes for culling (normals point outward).
+  bool cull_enabled_{};
+  Vector3f cull_normals_[6]{};
+  float cull_offsets_[6]{};
+  int culled_count_{};
 };
 
 }  // namespace ballistica
@@ -3,6 +3,7 @@
 #include "ballistica/graphics/renderer.h"
 
 #include "ballistica/graphics/graphics_server.h"
+#include "ballistica/media/data/model_data.h"
 
 // FIXME: Clear out conditional stuff.
 #if BA_OSTYPE_MACOS && BA_SDL_BUILD && !BA_SDL2_BUILD
@@ -21,12 +22,29 @@ const float kBaseVRWorldScale = 1.38f;
 const float kInvVRHeadScale = 1.0f / (kBaseVRWorldScale * kDefaultVRHeadScale);
 #endif
 
+// Dynamic resolution: how far and in what steps we'll drop our camera
+// buffer res, and how often we let ourself change it (each change means
+// recreating the camera buffer and its blur chain).
+const float kDynamicResolutionMinScale = 0.5f;
+const float kDynamicResolutionStep = 0.1f;
+const millisecs_t kDynamicResolutionChangeInterval = 1000;
+const millisecs_t kDynamicResolutionProbeInterval = 5000;
+const millisecs_t kDynamicResolutionMaxProbeInterval = 60000;
+
+// Models drop to each successive detail level once their bounding sphere's
+// radius falls below these fractions of half the screen height (scaled by
+// quality; see GetModelLOD()).
+const float kModelLODScreenSizes[ModelData::kMaxLODs] = {0.08f, 0.04f, 0.02f};
+
 // There can be only one!.. at a time.
 static bool have_renderer = false;
 
 Renderer::Renderer() {
   assert(!have_renderer);
   have_renderer = true;
+  for (auto&& time : gpu_pass_times_) {
+    time.store(-1.0f);
+  }
 }
 
 Renderer::~Renderer() {
@@ -239,6 +257,8 @@ void Renderer::RenderFrameDef(FrameDef* frame_def) {
 
 void Renderer::FinishFrameDef(FrameDef* frame_def) {
   frames_rendered_count_++;
+  last_state_change_counts_ = state_change_counts_;
+  state_change_counts_ = StateChangeCounts();
 
   // Give the renderer a chance to check for/report errors.
   CheckForErrors();
@@ -500,6 +520,8 @@ void Renderer::UpdateLightAndShadowBuffers(FrameDef* frame_def) {
                                    false,      // msaa
                                    false       // alpha
                                    ));         // NOLINT(whitespace/parens)
+    light_render_target_neutral_ = false;
+    light_shadow_render_target_neutral_ = false;
   }
 }
 
@@ -513,27 +535,106 @@ void Renderer::RenderLightAndShadowPasses(FrameDef* frame_def) {
   SetDepthWriting(false);
   SetDepthTesting(false);
   SetDrawAtEqualDepth(false);
-  PushGroupMarker("Light Pass");
-  RenderTarget* r_target = light_render_target();
-  r_target->DrawBegin(true, kShadowNeutral, kShadowNeutral, kShadowNeutral,
-                      1.0f);
-  frame_def->light_pass()->Render(r_target, true);
-  PopGroupMarker();
-  PushGroupMarker("LightShadow Pass");
-  r_target = light_shadow_render_target();
-  r_target->DrawBegin(true, kShadowNeutral, kShadowNeutral, kShadowNeutral,
-                      1.0f);
-  frame_def->light_shadow_pass()->Render(r_target, true);
-  PopGroupMarker();
+  // Nothing static ever draws into these (terrain only receives), so the
+  // only thing we can reuse from frame to frame is an empty buffer; skip
+  // touching them entirely when they're already clear and stay that way.
+  bool light_empty = !frame_def->light_pass()->HasDrawCommands();
+  if (!(light_empty && light_render_target_neutral_)) {
+    PushGroupMarker("Light Pass");
+    RenderTarget* r_target = light_render_target();
+    r_target->DrawBegin(true, kShadowNeutral, kShadowNeutral, kShadowNeutral,
+                        1.0f);
+    frame_def->light_pass()->Render(r_target, true);
+    PopGroupMarker();
+    light_render_target_neutral_ = light_empty;
+  }
+  bool light_shadow_empty = !frame_def->light_shadow_pass()->HasDrawCommands();
+  if (!(light_shadow_empty && light_shadow_render_target_neutral_)) {
+    PushGroupMarker("LightShadow Pass");
+    RenderTarget* r_target = light_shadow_render_target();
+    r_target->DrawBegin(true, kShadowNeutral, kShadowNeutral, kShadowNeutral,
+                        1.0f);
+    frame_def->light_shadow_pass()->Render(r_target, true);
+    PopGroupMarker();
+    light_shadow_render_target_neutral_ = light_shadow_empty;
+  }
+}
+
+void Renderer::UpdateDynamicResolution() {
+  millisecs_t real_time = GetRealTime();
+  millisecs_t frame_time = real_time - dynamic_resolution_last_frame_time_;
+  dynamic_resolution_last_frame_time_ = real_time;
+
+  if (dynamic_resolution_target_ <= 0.0f) {
+    dynamic_resolution_scale_ = 1.0f;
+    dynamic_resolution_probing_ = false;
+    return;
+  }
+
+  // Ignore big hitches (loading, etc); they're not our problem.
+  if (frame_time > 250) {
+    return;
+  }
+  dynamic_resolution_frame_time_ = 0.9f * dynamic_resolution_frame_time_
+                                   + 0.1f * static_cast<float>(frame_time);
+  millisecs_t since_change = real_time - dynamic_resolution_last_change_time_;
+  if (since_change < kDynamicResolutionChangeInterval) {
+    return;
+  }
+
+  // Frame time is our only measure of gpu load here, and vsync keeps it
+  // from ever dipping below the refresh interval. So to climb back up we
+  // periodically probe the next step up and drop back if it doesn't hold
+  // (backing off further each time that happens).
+  if (dynamic_resolution_probe_interval_ == 0) {
+    dynamic_resolution_probe_interval_ = kDynamicResolutionProbeInterval;
+  }
+  if (dynamic_resolution_frame_time_ > dynamic_resolution_target_ * 1.1f) {
+    if (dynamic_resolution_scale_ > kDynamicResolutionMinScale) {
+      dynamic_resolution_scale_ =
+          std::max(kDynamicResolutionMinScale,
+                   dynamic_resolution_scale_ - kDynamicResolutionStep);
+      dynamic_resolution_last_change_time_ = real_time;
+      if (dynamic_resolution_probing_) {
+        dynamic_resolution_probe_interval_ =
+            std::min(kDynamicResolutionMaxProbeInterval,
+                     dynamic_resolution_probe_interval_ * 2);
+      }
+    }
+    dynamic_resolution_probing_ = false;
+  } else if (dynamic_resolution_scale_ < 1.0f
+             && since_change >= dynamic_resolution_probe_interval_) {
+    dynamic_resolution_scale_ =
+        std::min(1.0f, dynamic_resolution_scale_ + kDynamicResolutionStep);
+    dynamic_resolution_last_change_time_ = real_time;
+    dynamic_resolution_probing_ = true;
+  } else if (dynamic_resolution_probing_
+             && since_change >= 2 * kDynamicResolutionChangeInterval) {
+    // Our last step up has held; reset our backoff.
+    dynamic_resolution_probing_ = false;
+    dynamic_resolution_probe_interval_ = kDynamicResolutionProbeInterval;
+  }
 }
 
 void Renderer::UpdateCameraRenderTargets(FrameDef* frame_def) {
+  UpdateDynamicResolution();
+
+  // If our camera scale has changed, rebuild at the new size.
+  float camera_scale = std::min(1.0f, std::max(0.1f, camera_render_scale_))
+                       * dynamic_resolution_scale_;
+  if (camera_scale != camera_render_target_scale_) {
+    camera_render_target_.Clear();
+    camera_msaa_render_target_.Clear();
+  }
+
   // Create or destroy our camera render-target as necessary.
   // In higher-quality modes we render the world into a buffer
   // so we can do depth-of-field filtering and whatnot.
   if (frame_def->quality() >= GraphicsQuality::kHigh) {
     if (!camera_render_target_.exists()) {
-      float pixel_scale_fin = std::min(1.0f, std::max(0.1f, pixel_scale_));
+      camera_render_target_scale_ = camera_scale;
+      float pixel_scale_fin =
+          std::min(1.0f, std::max(0.1f, pixel_scale_ * camera_scale));
       int w = static_cast<int>(screen_render_target_->physical_width()
                                * pixel_scale_fin);
       int h = static_cast<int>(screen_render_target_->physical_height()
@@ -568,16 +669,6 @@ void Renderer::UpdateCameraRenderTargets(FrameDef* frame_def) {
       }
       w = ((w % foo == 0) ? w : (w + (foo - (w % foo))));
       h = ((h % foo == 0) ? h : (h + (foo - (h % foo))));
-      camera_render_target_ = Object::MakeRefCounted(NewFramebufferRenderTarget(
-          w, h,
-          true,   // linear-interp
-          true,   // depth
-          true,   // tex
-          true,   // depth-tex
-          false,  // high-qual
-          false,  // msaa
-          false   // alpha
-          ));     // NOLINT(whitespace/parens)
 
       // If screen size just changed or whatnot,
       // update whether we should do msaa.
@@ -586,10 +677,24 @@ void Renderer::UpdateCameraRenderTargets(FrameDef* frame_def) {
         msaa_enabled_dirty_ = false;
       }
 
-      // If we're doing msaa, also create a multi-sample version of the same.
-      // We'll draw into this and then blit it to our normal texture-backed
-      // camera-target.
-      if (IsMSAAEnabled()) {
+      // Where msaa resolves implicitly, our texture-backed target can just
+      // be multisampled itself.
+      bool implicit_msaa = IsMSAAEnabled() && IsMSAAResolveImplicit();
+      camera_render_target_ = Object::MakeRefCounted(NewFramebufferRenderTarget(
+          w, h,
+          true,           // linear-interp
+          true,           // depth
+          true,           // tex
+          true,           // depth-tex
+          false,          // high-qual
+          implicit_msaa,  // msaa
+          false           // alpha
+          ));             // NOLINT(whitespace/parens)
+
+      // Otherwise if we're doing msaa, also create a multi-sample version of
+      // the same. We'll draw into this and then blit it to our normal
+      // texture-backed camera-target.
+      if (IsMSAAEnabled() && !implicit_msaa) {
         camera_msaa_render_target_ =
             NewFramebufferRenderTarget(w, h,
                                        false,  // linear-interp
@@ -839,6 +944,57 @@ auto Renderer::GetZBufferValue(RenderPass* pass, float dist) -> float {
   return z;
 }
 
+auto Renderer::GetModelLOD(const ModelData& model) -> int {
+  int lod_count = model.lod_count();
+  if (lod_count == 0) {
+    return 0;
+  }
+  const Matrix44f& model_view = g_graphics_server->model_view_matrix();
+  const Matrix44f& projection = g_graphics_server->projection_matrix();
+  Vector3f center = model_view * model.bounds_center();
+  float w = center.x * projection.m[3] + center.y * projection.m[7]
+            + center.z * projection.m[11] + projection.m[15];
+
+  // Anything reaching back to the camera gets full detail.
+  if (w <= 0.0f) {
+    return 0;
+  }
+  float scale_squared =
+      std::max(model_view.LocalXAxis().LengthSquared(),
+               std::max(model_view.LocalYAxis().LengthSquared(),
+                        model_view.LocalZAxis().LengthSquared()));
+  float size = model.bounds_radius() * sqrtf(scale_squared)
+               * std::abs(projection.m[5]) / w;
+
+  // Higher qualities hold on to detail longer.
+  float bias;
+  switch (g_graphics_server->quality()) {
+    case GraphicsQuality::kHigher:
+      bias = 0.5f;
+      break;
+    case GraphicsQuality::kHigh:
+      bias = 0.75f;
+      break;
+    case GraphicsQuality::kMedium:
+      bias = 1.0f;
+      break;
+    default:
+      bias = 1.5f;
+      break;
+  }
+  int level = 0;
+  while (level < lod_count && size < kModelLODScreenSizes[level] * bias) {
+    level++;
+  }
+  return level;
+}
+
+auto Renderer::GetQualityCalibrationKey() -> std::string { return ""; }
+
+auto Renderer::CalibrateGraphicsQuality() -> GraphicsQuality {
+  return GetAutoGraphicsQuality();
+}
+
 auto Renderer::GetAutoAndroidRes() -> std::string {
   throw Exception("This should be overridden.");
 }
@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_GRAPHICS_RENDERER_H_
 #define BALLISTICA_GRAPHICS_RENDERER_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,6 +48,14 @@ namespace ballistica {
 // The renderer is responsible for converting a frame_def to onscreen pixels
 class Renderer {
  public:
+  // Counts of redundant-state-filtered changes the renderer made in a frame.
+  struct StateChangeCounts {
+    int programs{};
+    int textures{};
+    int blend_states{};
+    int draws{};
+  };
+
   Renderer();
   virtual ~Renderer();
 
@@ -83,6 +92,18 @@ class Renderer {
   auto light_pitch() const -> float { return light_pitch_; }
   auto light_heading() const -> float { return light_heading_; }
   void set_pixel_scale(float s) { pixel_scale_requested_ = s; }
+
+  // Scale for our camera buffer (world drawing, blurs, dof) relative to
+  // the screen; it gets upscaled when composited. If a dynamic-resolution
+  // target frame time (in milliseconds) is set, we'll further drop this as
+  // needed to try to hold that time.
+  void set_camera_render_scale(float s) { camera_render_scale_ = s; }
+  void set_dynamic_resolution_target(float ms) {
+    dynamic_resolution_target_ = ms;
+  }
+  auto dynamic_resolution_scale() const -> float {
+    return dynamic_resolution_scale_;
+  }
   void set_screen_gamma(float val) { screen_gamma_requested_ = val; }
   void set_debug_draw_mode(bool debugModeIn) { debug_draw_mode_ = debugModeIn; }
   auto debug_draw_mode() -> bool { return debug_draw_mode_; }
@@ -95,6 +116,20 @@ class Renderer {
   virtual auto GetAutoGraphicsQuality() -> GraphicsQuality = 0;
   virtual auto GetAutoTextureQuality() -> TextureQuality = 0;
 
+  // Which of a model's detail levels to draw it at under the current
+  // transforms (0 being full detail).
+  static auto GetModelLOD(const ModelData& model) -> int;
+
+  // Identifies the gpu/driver/os combo we're running on for the purpose of
+  // caching calibration results; an empty string means this renderer
+  // doesn't calibrate and GetAutoGraphicsQuality() should be used.
+  virtual auto GetQualityCalibrationKey() -> std::string;
+
+  // Measure what the hardware can handle by rendering a representative
+  // offscreen workload for each quality tier and return the highest one
+  // meeting our frame-time target. Runs before Load().
+  virtual auto CalibrateGraphicsQuality() -> GraphicsQuality;
+
   virtual auto GetAutoAndroidRes() -> std::string;
 
   void ScreenSizeChanged();
@@ -140,6 +175,25 @@ class Renderer {
   auto dof_far_smoothed() const -> float { return dof_far_smoothed_; }
   auto total_frames_rendered() -> int { return frames_rendered_count_; }
 
+  // State changes for the most recently completed frame.
+  auto last_state_change_counts() const -> const StateChangeCounts& {
+    return last_state_change_counts_;
+  }
+
+  // Optional gpu timing of render passes (for profiling). Times are in
+  // milliseconds summed over each pass type for a frame, and lag a few
+  // frames behind; negative values mean we have no data.
+  virtual void BeginGPUPassTimer(RenderPass::Type type) {}
+  virtual void EndGPUPassTimer() {}
+  void set_gpu_pass_timers_enabled(bool val) {
+    gpu_pass_timers_enabled_ = val;
+  }
+  auto gpu_pass_time(RenderPass::Type type) const -> float {
+    return gpu_pass_times_[static_cast<int>(type)].load();
+  }
+  static const int kRenderPassTypeCount =
+      static_cast<int>(RenderPass::Type::kOverlayFixedPass) + 1;
+
 #if BA_VR_BUILD
   void VRSetHead(float tx, float ty, float tz, float yaw, float pitch,
                  float roll);
@@ -189,6 +243,10 @@ class Renderer {
                           bool linear_interpolation, bool force_shader_blit,
                           bool invalidate_source) = 0;
   virtual auto IsMSAAEnabled() const -> bool = 0;
+
+  // Whether msaa targets can be textures that resolve implicitly as
+  // they're drawn (so no separate msaa target or resolve blit is needed).
+  virtual auto IsMSAAResolveImplicit() const -> bool = 0;
   virtual void UpdateMSAAEnabled() = 0;
   virtual void VREyeRenderBegin() = 0;
   virtual void RenderFrameDefEnd() = 0;
@@ -201,6 +259,11 @@ class Renderer {
   virtual void VRSyncRenderStates() = 0;
 #endif
 
+  // Renderer subclasses bump these as they go; they get reset each frame.
+  StateChangeCounts state_change_counts_;
+  bool gpu_pass_timers_enabled_{};
+  std::atomic<float> gpu_pass_times_[kRenderPassTypeCount]{};
+
  private:
   void UpdateLightAndShadowBuffers(FrameDef* frame_def);
   void RenderLightAndShadowPasses(FrameDef* frame_def);
@@ -208,6 +271,7 @@ class Renderer {
   void DrawWorldToCameraBuffer(FrameDef* frame_def);
   void UpdatePixelScaleAndBackingBuffer(FrameDef* frame_def);
   void UpdateCameraRenderTargets(FrameDef* frame_def);
+  void UpdateDynamicResolution();
 #if BA_OSTYPE_MACOS && BA_SDL_BUILD && !BA_SDL2_BUILD
   void HandleFunkyMacGammaIssue(FrameDef* frame_def);
 #endif
@@ -272,12 +336,26 @@ class Renderer {
   float screen_gamma_{1.0f};
   float pixel_scale_requested_{1.0f};
   float pixel_scale_{1.0f};
+  float camera_render_scale_{1.0f};
+  float camera_render_target_scale_{1.0f};
+  float dynamic_resolution_target_{};
+  float dynamic_resolution_scale_{1.0f};
+  float dynamic_resolution_frame_time_{};
+  millisecs_t dynamic_resolution_last_frame_time_{};
+  millisecs_t dynamic_resolution_last_change_time_{};
+  millisecs_t dynamic_resolution_probe_interval_{};
+  bool dynamic_resolution_probing_{};
   Object::Ref<RenderTarget> screen_render_target_;
   Object::Ref<RenderTarget> backing_render_target_;
   Object::Ref<RenderTarget> camera_render_target_;
   Object::Ref<RenderTarget> camera_msaa_render_target_;
   Object::Ref<RenderTarget> light_render_target_;
   Object::Ref<RenderTarget> light_shadow_render_target_;
+
+  // Whether these currently hold nothing but their clear color; if so,
+  // frames with nothing to draw into them can skip re-clearing them.
+  bool light_render_target_neutral_{};
+  bool light_shadow_render_target_neutral_{};
   Object::Ref<RenderTarget> vr_overlay_flat_render_target_;
   millisecs_t last_screen_gamma_update_time_{};
   int last_commands_buffer_size_{};
@@ -287,6 +365,7 @@ class Renderer {
   int last_textures_buffer_size_{};
   bool debug_draw_mode_{};
   int frames_rendered_count_{};
+  StateChangeCounts last_state_change_counts_;
 
   // The *actual* current quality (set based on the
   // currently-rendering frame_def)
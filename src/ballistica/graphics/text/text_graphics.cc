@@ -2,21 +2,21 @@
 
 #include "ballistica/graphics/text/text_graphics.h"
 
+#include <algorithm>
+
 #include "ballistica/generic/utils.h"
 #include "ballistica/graphics/text/font_page_map_data.h"
 #include "ballistica/platform/platform.h"
 
 namespace ballistica {
 
-class TextGraphics::TextSpanBoundsCacheEntry : public Object {
+class TextGraphics::GlyphRunCacheEntry : public Object {
  public:
-  std::string string;
-  Rect r;
-  float width{};
-  std::unordered_map<std::string,
-                     Object::Ref<TextSpanBoundsCacheEntry>>::iterator
+  std::vector<VertexDualTextureFull> vertices;
+  std::vector<uint16_t> indices;
+  std::unordered_map<std::string, Object::Ref<GlyphRunCacheEntry>>::iterator
       map_iterator_;
-  std::list<Object::Ref<TextSpanBoundsCacheEntry>>::iterator list_iterator_;
+  std::list<Object::Ref<GlyphRunCacheEntry>>::iterator list_iterator_;
 };
 
 void TextGraphics::Init() {
@@ -818,11 +818,15 @@ auto TextGraphics::GetBigCharIndex(int c) -> int {
   return index;
 }
 
+static_assert(BA_GLYPH_PAGE_COUNT == kTextGlyphPageCount,
+              "glyph page count mismatch");
+
 void TextGraphics::LoadGlyphPage(uint32_t index) {
-  std::lock_guard<std::mutex> lock(glyph_load_mutex_);
+  assert(index < kTextGlyphPageCount);
+  std::lock_guard<std::mutex> lock(glyph_page_load_mutexes_[index]);
 
   // Its possible someone else coulda loaded it since we last checked.
-  if (g_glyph_pages[index] == nullptr) {
+  if (!glyph_pages_loaded_[index].load(std::memory_order_acquire)) {
     char buffer[256];
     snprintf(buffer, sizeof(buffer), "ba_data/fonts/fontSmall%d.fdata", index);
     FILE* f = g_platform->FOpen(buffer, "rb");
@@ -833,6 +837,18 @@ void TextGraphics::LoadGlyphPage(uint32_t index) {
     BA_PRECONDITION(g_glyph_pages[index]);
     BA_PRECONDITION(fread(g_glyph_pages[index], total_size, 1, f) == 1);
     fclose(f);
+    glyph_pages_loaded_[index].store(true, std::memory_order_release);
+  }
+}
+
+void TextGraphics::PreloadGlyphPagesForText(const std::string& text) {
+  std::vector<int> font_pages;
+  GetFontPagesForText(text, &font_pages);
+  for (int page : font_pages) {
+    if (page < kTextGlyphPageCount
+        && !glyph_pages_loaded_[page].load(std::memory_order_acquire)) {
+      LoadGlyphPage(static_cast<uint32_t>(page));
+    }
   }
 }
 
@@ -880,7 +896,9 @@ void TextGraphics::GetFontPageCharRange(int page, uint32_t* first_char,
 }
 
 void TextGraphics::GetFontPagesForText(const std::string& text,
-                                       std::set<int>* font_pages) {
+                                       std::vector<int>* font_pages) {
+  assert(font_pages);
+  font_pages->clear();
   int last_page = -1;
   std::vector<uint32_t> unicode = Utils::UnicodeFromUTF8(text, "c03853");
   for (uint32_t val : unicode) {
@@ -926,10 +944,14 @@ void TextGraphics::GetFontPagesForText(const std::string& text,
       // yay we cover it!
       page = g_glyph_map[val];
     }
-    // compare to lastPage to avoid doing a set insert for *everything* since
-    // most will be the same
+    // Compare to last_page to avoid searching the list for *everything*
+    // since most will be the same. (There's only ever a handful of pages
+    // so a sorted vector beats a set here).
     if (page != last_page) {
-      (*font_pages).insert(page);
+      auto i = std::lower_bound(font_pages->begin(), font_pages->end(), page);
+      if (i == font_pages->end() || *i != page) {
+        font_pages->insert(i, page);
+      }
       last_page = page;
     }
   }
@@ -984,7 +1006,7 @@ auto TextGraphics::GetGlyph(uint32_t val, bool big) -> TextGraphics::Glyph* {
     uint32_t page = g_glyph_map[val];
     uint32_t start_index = g_glyph_page_start_index_map[page];
     uint32_t local_index = val - start_index;
-    if (g_glyph_pages[page] == nullptr) {
+    if (!glyph_pages_loaded_[page].load(std::memory_order_acquire)) {
       LoadGlyphPage(page);
     }
     return &g_glyph_pages[page][local_index];
@@ -997,48 +1019,109 @@ void TextGraphics::GetOSTextSpanBoundsAndWidth(const std::string& s, Rect* r,
 
   // Asking the OS to calculate text bounds sounds expensive,
   // so let's use a cache of recent results.
-  auto i = text_span_bounds_cache_map_.find(s);
-  if (i != text_span_bounds_cache_map_.end()) {
-    Object::Ref<TextSpanBoundsCacheEntry> entry = i->second;
-    *r = entry->r;
-    *width = entry->width;
+  // This is a fixed-size open-addressed table; each string can live in any
+  // of a few slots following its hash slot, and when those are all full we
+  // pick a victim among them CLOCK-style (skipping recently-hit entries).
+  size_t hash = std::hash<std::string>()(s);
+  size_t base = hash & (kTextSpanBoundsCacheSize - 1);
+  for (int probe = 0; probe < kTextSpanBoundsCacheProbes; probe++) {
+    TextSpanBoundsCacheEntry& entry(
+        text_span_bounds_cache_[(base + probe)
+                                & (kTextSpanBoundsCacheSize - 1)]);
 
-    // Send this entry to the back of the list since we used it.
-    text_span_bounds_cache_.erase(entry->list_iterator_);
-
-    // I guess inspection doesn't realize entry lives on after this?...
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "UnusedValue"
-    entry->list_iterator_ =
-        text_span_bounds_cache_.insert(text_span_bounds_cache_.end(), entry);
-#pragma clang diagnostic pop
-    return;
+    // Slots never go back to unused, so a free one ends our search.
+    if (!entry.used) {
+      break;
+    }
+    if (entry.hash == hash && entry.string == s) {
+      entry.referenced = true;
+      *r = entry.r;
+      *width = entry.width;
+      text_span_bounds_cache_hits_++;
+      return;
+    }
   }
-  auto entry(Object::New<TextSpanBoundsCacheEntry>());
-  entry->string = s;
+  text_span_bounds_cache_misses_++;
+
+  Rect new_r;
+  float new_width;
   if (g_buildconfig.enable_os_font_rendering()) {
-    g_platform->GetTextBoundsAndWidth(s, &entry->r, &entry->width);
+    g_platform->GetTextBoundsAndWidth(s, &new_r, &new_width);
   } else {
     BA_LOG_ONCE(
         "FIXME: GetOSTextSpanBoundsAndWidth unimplemented on this platform");
-    r->l = 0.0f;
-    r->r = 1.0f;
-    r->t = 1.0f;
-    r->b = 0.0f;
-    *width = 1.0f;
+    new_r.l = 0.0f;
+    new_r.r = 1.0f;
+    new_r.t = 1.0f;
+    new_r.b = 0.0f;
+    new_width = 1.0f;
+  }
+
+  // Find a home for the result; the first free slot in our probe range, or
+  // failing that the first one that hasn't been hit since we last passed
+  // it by. (Worst case we've cleared everyone's bits on the first sweep
+  // and take the first slot on the second).
+  TextSpanBoundsCacheEntry* victim{};
+  for (int probe = 0; probe < kTextSpanBoundsCacheProbes * 2; probe++) {
+    TextSpanBoundsCacheEntry& entry(
+        text_span_bounds_cache_[(base + probe % kTextSpanBoundsCacheProbes)
+                                & (kTextSpanBoundsCacheSize - 1)]);
+    if (!entry.used || !entry.referenced) {
+      victim = &entry;
+      break;
+    }
+    entry.referenced = false;
+  }
+  assert(victim);
+  victim->used = true;
+  victim->referenced = false;
+  victim->hash = hash;
+  victim->string = s;
+  victim->r = new_r;
+  victim->width = new_width;
+  *r = new_r;
+  *width = new_width;
+}
+
+auto TextGraphics::GetCachedGlyphRun(
+    const std::string& key, std::vector<VertexDualTextureFull>* vertices,
+    std::vector<uint16_t>* indices) -> bool {
+  assert(InGameThread());
+  assert(vertices && indices);
+  auto i = glyph_run_cache_map_.find(key);
+  if (i == glyph_run_cache_map_.end()) {
+    return false;
+  }
+  Object::Ref<GlyphRunCacheEntry> entry = i->second;
+  *vertices = entry->vertices;
+  *indices = entry->indices;
+
+  // Send this entry to the back of the list since we used it.
+  glyph_run_cache_.erase(entry->list_iterator_);
+  entry->list_iterator_ =
+      glyph_run_cache_.insert(glyph_run_cache_.end(), entry);
+  return true;
+}
+
+void TextGraphics::CacheGlyphRun(
+    const std::string& key, const std::vector<VertexDualTextureFull>& vertices,
+    const std::vector<uint16_t>& indices) {
+  assert(InGameThread());
+  if (glyph_run_cache_map_.find(key) != glyph_run_cache_map_.end()) {
+    return;
   }
+  auto entry(Object::New<GlyphRunCacheEntry>());
+  entry->vertices = vertices;
+  entry->indices = indices;
   entry->list_iterator_ =
-      text_span_bounds_cache_.insert(text_span_bounds_cache_.end(), entry);
+      glyph_run_cache_.insert(glyph_run_cache_.end(), entry);
   entry->map_iterator_ =
-      text_span_bounds_cache_map_.insert(std::make_pair(s, entry)).first;
-  *r = entry->r;
-  *width = entry->width;
+      glyph_run_cache_map_.insert(std::make_pair(key, entry)).first;
 
   // Keep cache from growing too large.
-  while (text_span_bounds_cache_.size() > 300) {
-    text_span_bounds_cache_map_.erase(
-        text_span_bounds_cache_.front()->map_iterator_);
-    text_span_bounds_cache_.pop_front();
+  while (glyph_run_cache_.size() > 200) {
+    glyph_run_cache_map_.erase(glyph_run_cache_.front()->map_iterator_);
+    glyph_run_cache_.pop_front();
   }
 }
 
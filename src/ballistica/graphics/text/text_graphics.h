@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_GRAPHICS_TEXT_TEXT_GRAPHICS_H_
 #define BALLISTICA_GRAPHICS_TEXT_TEXT_GRAPHICS_H_
 
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <set>
@@ -19,6 +20,9 @@ namespace ballistica {
 const int kTextMaxUnicodeVal = 999999;
 const float kTextRowHeight = 32.0f;
 
+// Number of dynamically-loaded glyph pages we ship.
+const int kTextGlyphPageCount = 8;
+
 // Encapsulates text-display functionality used by the game thread.
 class TextGraphics {
  public:
@@ -52,7 +56,26 @@ class TextGraphics {
   auto GetGlyph(uint32_t value, bool big) -> Glyph*;
   static auto HaveBigChars(const std::string& string) -> bool;
   static auto HaveChars(const std::string& string) -> bool;
-  void GetFontPagesForText(const std::string& text, std::set<int>* font_pages);
+  // Fills out the ids of all font pages needed to draw the given text,
+  // in ascending order.
+  void GetFontPagesForText(const std::string& text,
+                           std::vector<int>* font_pages);
+
+  // Loads glyph data for all font pages the given text touches, so that
+  // laying it out later won't have to hit the disk. Can be called from
+  // any thread.
+  void PreloadGlyphPagesForText(const std::string& text);
+
+  // Cache of recently laid-out glyph meshes, so that text which gets set
+  // repeatedly (counters, timers, names, etc.) can skip glyph layout.
+  // Keys should incorporate everything that affects the layout.
+  // Returns true and fills out the given buffers on a hit.
+  auto GetCachedGlyphRun(const std::string& key,
+                         std::vector<VertexDualTextureFull>* vertices,
+                         std::vector<uint16_t>* indices) -> bool;
+  void CacheGlyphRun(const std::string& key,
+                     const std::vector<VertexDualTextureFull>& vertices,
+                     const std::vector<uint16_t>& indices);
   void GetFontPageCharRange(int page, uint32_t* first_char,
                             uint32_t* last_char);
   auto GetOSTextSpanWidth(const std::string& s) -> float {
@@ -63,6 +86,14 @@ class TextGraphics {
   }
   void GetOSTextSpanBoundsAndWidth(const std::string& s, Rect* r, float* width);
 
+  // Stats for tuning our OS text span bounds cache.
+  auto text_span_bounds_cache_hits() const -> uint64_t {
+    return text_span_bounds_cache_hits_;
+  }
+  auto text_span_bounds_cache_misses() const -> uint64_t {
+    return text_span_bounds_cache_misses_;
+  }
+
   // Returns the width of a string
   auto GetStringWidth(const char* s, bool big = false) -> float;
   auto GetStringWidth(const std::string& s, bool big = false) -> float {
@@ -92,18 +123,35 @@ class TextGraphics {
   }
 
  private:
-  class TextSpanBoundsCacheEntry;
-  void LoadGlyphPage(uint32_t index);
+  class GlyphRunCacheEntry;
+  struct TextSpanBoundsCacheEntry {
+    size_t hash{};
+    std::string string;
+    Rect r;
+    float width{};
+    bool used{};
+    bool referenced{};
+  };
 
-  // Map of entries for fast lookup.
-  std::unordered_map<std::string, Object::Ref<TextSpanBoundsCacheEntry> >
-      text_span_bounds_cache_map_;
+  // Must be a power of 2.
+  static const int kTextSpanBoundsCacheSize = 512;
+  static const int kTextSpanBoundsCacheProbes = 8;
+  void LoadGlyphPage(uint32_t index);
 
-  // List of entries for sorting by last-use-time
-  std::list<Object::Ref<TextSpanBoundsCacheEntry> > text_span_bounds_cache_;
-  std::mutex glyph_load_mutex_;
+  // Fixed-size table of recent OS span bounds results (the strings involved
+  // are nearly always short enough to live inline in their std::string).
+  TextSpanBoundsCacheEntry text_span_bounds_cache_[kTextSpanBoundsCacheSize];
+  uint64_t text_span_bounds_cache_hits_{};
+  uint64_t text_span_bounds_cache_misses_{};
+  // Pages only ever go from unloaded to loaded, so lookups just check an
+  // atomic flag; the per-page locks are only taken while loading.
+  std::mutex glyph_page_load_mutexes_[kTextGlyphPageCount];
+  std::atomic<bool> glyph_pages_loaded_[kTextGlyphPageCount]{};
   Glyph glyphs_extras_[100]{};
   Glyph glyphs_big_[64]{};
+  std::unordered_map<std::string, Object::Ref<GlyphRunCacheEntry> >
+      glyph_run_cache_map_;
+  std::list<Object::Ref<GlyphRunCacheEntry> > glyph_run_cache_;
 };
 
 }  // namespace ballistica
@@ -2,6 +2,10 @@
 
 #include "ballistica/graphics/text/text_group.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
 #include "ballistica/generic/utils.h"
 #include "ballistica/graphics/graphics.h"
 #include "ballistica/graphics/text/text_graphics.h"
@@ -9,25 +13,136 @@
 
 namespace ballistica {
 
+// Most texts we hold onto once nobody is showing them anymore.
+const size_t kMaxCachedTexts = 256;
+
+// Built entries for recently set texts, keyed by everything that goes
+// into building them. Game thread only.
+class TextGroup::Cache {
+ public:
+  struct Item {
+    std::vector<std::shared_ptr<TextMeshEntry>> entries;
+    bool big{};
+    uint64_t last_used{};
+  };
+
+  // Never going down; entries dying at exit would be unhappy.
+  static auto Instance() -> Cache& {
+    static auto* cache = new Cache();
+    return *cache;
+  }
+
+  static auto Key(const std::string& text, TextMesh::HAlign alignment_h,
+                  TextMesh::VAlign alignment_v, bool big,
+                  float resolution_scale) -> std::string {
+    std::string key;
+    key.reserve(text.size() + 4 + sizeof(resolution_scale));
+    key.append(text);
+    key.push_back('\0');
+    key.push_back(static_cast<char>(alignment_h));
+    key.push_back(static_cast<char>(alignment_v));
+    key.push_back(static_cast<char>(big));
+    key.append(reinterpret_cast<const char*>(&resolution_scale),
+               sizeof(resolution_scale));
+    return key;
+  }
+
+  auto Get(const std::string& key) -> const Item* {
+    assert(InGameThread());
+    auto i = items_.find(key);
+    if (i == items_.end()) {
+      return nullptr;
+    }
+    i->second.last_used = ++use_count_;
+    return &i->second;
+  }
+
+  auto Store(const std::string& key,
+             const std::vector<std::shared_ptr<TextMeshEntry>>& entries,
+             bool big) -> void {
+    assert(InGameThread());
+    Item& item = items_[key];
+    item.entries = entries;
+    item.big = big;
+    item.last_used = ++use_count_;
+    if (items_.size() > kMaxCachedTexts) {
+      Prune();
+    }
+  }
+
+ private:
+  // Drop the least recently used texts nobody is showing until we're
+  // comfortably under our limit.
+  auto Prune() -> void {
+    std::vector<std::pair<uint64_t, const std::string*>> unused;
+    for (auto&& i : items_) {
+      bool in_use{};
+      for (auto&& entry : i.second.entries) {
+        if (entry.use_count() > 1) {
+          in_use = true;
+          break;
+        }
+      }
+      if (!in_use) {
+        unused.emplace_back(i.second.last_used, &i.first);
+      }
+    }
+    std::sort(unused.begin(), unused.end());
+    size_t target = kMaxCachedTexts * 3 / 4;
+    std::vector<std::string> doomed;
+    for (auto&& i : unused) {
+      if (items_.size() - doomed.size() <= target) {
+        break;
+      }
+      doomed.push_back(*i.second);
+    }
+    for (auto&& key : doomed) {
+      items_.erase(key);
+    }
+  }
+
+  std::unordered_map<std::string, Item> items_;
+  uint64_t use_count_{};
+};
+
 void TextGroup::SetText(const std::string& text, TextMesh::HAlign alignment_h,
                         TextMesh::VAlign alignment_v, bool big,
                         float resolution_scale) {
+  // Nothing to do if we're already set up for this.
+  if (!entries_.empty() && text == text_ && alignment_h == alignment_h_
+      && alignment_v == alignment_v_ && big == big_requested_
+      && resolution_scale == resolution_scale_) {
+    return;
+  }
   text_ = text;
+  alignment_h_ = alignment_h;
+  alignment_v_ = alignment_v;
+  big_requested_ = big;
+  resolution_scale_ = resolution_scale;
+
+  // Use already-built entries for this if there are any.
+  std::string key =
+      Cache::Key(text, alignment_h, alignment_v, big, resolution_scale);
+  if (const Cache::Item* item = Cache::Instance().Get(key)) {
+    entries_ = item->entries;
+    big_ = item->big;
+    return;
+  }
 
   // In order to *actually* draw big, all our letters
   // must be available in the big font.
   big_ = (big && TextGraphics::HaveBigChars(text));
 
-  // If we had an OS texture for custom drawing, release it.
-  // (it should stick around for a while; we'll be able to re-grab
-  // the same one if we havn't changed)
-  os_texture_.Clear();
+  // Any OS texture for custom drawing we had goes away with our old
+  // entries. (it should stick around for a while; we'll be able to
+  // re-grab the same one if we havn't changed)
+  Object::Ref<TextureData> os_texture;
 
   // If we're drawing big we always just need 1 font page (the big one).
   if (big_) {
     // Now create entries for each page we use.
     entries_.clear();
-    std::unique_ptr<TextMeshEntry> entry(new TextMeshEntry());
+    auto entry = std::make_shared<TextMeshEntry>();
     entry->u_scale = entry->v_scale = 1.5f;
     entry->can_color = true;
     entry->max_flatness = 1.0f;
@@ -40,7 +155,7 @@ void TextGroup::SetText(const std::string& text, TextMesh::HAlign alignment_h,
     // Drawing non-big; we might use any number of font pages.
 
     // First, calc which font pages we'll need to draw this text.
-    std::set<int> font_pages;
+    std::vector<int> font_pages;
     g_text_graphics->GetFontPagesForText(text, &font_pages);
 
     // Now create entries for each page we use.
@@ -51,7 +166,7 @@ void TextGroup::SetText(const std::string& text, TextMesh::HAlign alignment_h,
     for (auto i = font_pages.rbegin(); i != font_pages.rend(); i++) {
       uint32_t min, max;
       g_text_graphics->GetFontPageCharRange(*i, &min, &max);
-      std::unique_ptr<TextMeshEntry> entry(new TextMeshEntry());
+      auto entry = std::make_shared<TextMeshEntry>();
 
       // Our custom font page IDs start at value 9990 (kExtras1);
       // make sure for all private-use unicode chars (U+E000–U+F8FF)
@@ -107,10 +222,10 @@ void TextGroup::SetText(const std::string& text, TextMesh::HAlign alignment_h,
         // If we made a text-packer, we need to fetch/generate a texture
         // that matches it.
         // There should only ever be one of these.
-        assert(!os_texture_.exists());
+        assert(!os_texture.exists());
         {
           Media::MediaListsLock lock;
-          os_texture_ = g_media->GetTextureData(packer.get());
+          os_texture = g_media->GetTextureData(packer.get());
         }
 
         // We also need to know what uv-scales to use for shadows/etc.
@@ -146,7 +261,7 @@ void TextGroup::SetText(const std::string& text, TextMesh::HAlign alignment_h,
           entry->tex = g_media->GetTexture(SystemTextureID::kFontSmall7);
           break;
         case static_cast<int>(TextGraphics::FontPage::kOSRendered):
-          entry->tex = os_texture_;
+          entry->tex = os_texture;
           break;
         case static_cast<int>(TextGraphics::FontPage::kExtras1):
           entry->tex = g_media->GetTexture(SystemTextureID::kFontExtras);
@@ -166,6 +281,12 @@ void TextGroup::SetText(const std::string& text, TextMesh::HAlign alignment_h,
       entries_.push_back(std::move(entry));
     }
   }
+
+  // OS-rendered text holds onto a texture of its own; we leave pruning
+  // those to media instead of keeping them alive here.
+  if (!os_texture.exists()) {
+    Cache::Instance().Store(key, entries_, big_);
+  }
 }
 
 void TextGroup::GetCaratPts(const std::string& text_in,
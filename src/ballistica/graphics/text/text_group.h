@@ -16,7 +16,10 @@ namespace ballistica {
 
 // encapsulates the multiple meshes and textures necessary to
 // draw arbitrary text. To actually draw the text, iterate over the meshes
-// and textures this class provides to you, drawing each in the same manner
+// and textures this class provides to you, drawing each in the same manner.
+// Groups set to identical text share their meshes, and recently used text
+// is kept around, so coming back to it (scores, timers, etc) doesn't
+// rebuild or re-upload anything.
 class TextGroup : public Object {
  public:
   // the number of meshes needing to be drawn for this text
@@ -74,10 +77,19 @@ class TextGroup : public Object {
     bool can_color;
     float max_flatness;
   };
-  Object::Ref<TextureData> os_texture_;
-  std::vector<std::unique_ptr<TextMeshEntry>> entries_;
+  class Cache;
+
+  // Entries may be shared with other groups showing the same thing.
+  std::vector<std::shared_ptr<TextMeshEntry>> entries_;
   std::string text_;
   bool big_;
+
+  // Args from our last SetText() call; lets us skip rebuilding our meshes
+  // when callers set the same thing repeatedly.
+  TextMesh::HAlign alignment_h_{};
+  TextMesh::VAlign alignment_v_{};
+  bool big_requested_{};
+  float resolution_scale_{};
 };
 
 }  // namespace ballistica
@@ -0,0 +1,109 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_GRAPHICS_TEXTURE_BLOCK_DECODE_H_
+#define BALLISTICA_GRAPHICS_TEXTURE_BLOCK_DECODE_H_
+
+#include <algorithm>
+
+#include "ballistica/ballistica.h"
+#include "ballistica/core/job_pool.h"
+
+// Use SIMD for palette expansion where available; the scalar version
+// remains the reference (and the fallback everywhere else).
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BA_BLOCK_DECODE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BA_BLOCK_DECODE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace ballistica {
+
+// Helpers for decoding block-compressed textures in software, for when
+// the hardware doesn't support a format.
+
+// Expand a 4x4 block of 2 bit palette indices (row-major, pixel 0 in the
+// low bits; as in DXT color data) into 32 bit pixels. Rows are written
+// stride pixels apart.
+inline void ExpandBlockPalette(const uint32_t palette[4], uint32_t codes,
+                               uint32_t* out, uint32_t stride) {
+#if BA_BLOCK_DECODE_SSE2
+  // Each lane tests its own index bits against the row's codes and
+  // selects between palette entries accordingly.
+  const __m128i bit0 = _mm_set_epi32(0x40, 0x10, 0x04, 0x01);
+  const __m128i bit1 = _mm_set_epi32(0x80, 0x20, 0x08, 0x02);
+  const __m128i p0 = _mm_set1_epi32(static_cast<int>(palette[0]));
+  const __m128i p1 = _mm_set1_epi32(static_cast<int>(palette[1]));
+  const __m128i p2 = _mm_set1_epi32(static_cast<int>(palette[2]));
+  const __m128i p3 = _mm_set1_epi32(static_cast<int>(palette[3]));
+  for (int j = 0; j < 4; j++) {
+    __m128i v = _mm_set1_epi32(static_cast<int>((codes >> (8 * j)) & 0xFF));
+    __m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(v, bit0), bit0);
+    __m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(v, bit1), bit1);
+    __m128i lo = _mm_or_si128(_mm_and_si128(m0, p1), _mm_andnot_si128(m0, p0));
+    __m128i hi = _mm_or_si128(_mm_and_si128(m0, p3), _mm_andnot_si128(m0, p2));
+    __m128i result =
+        _mm_or_si128(_mm_and_si128(m1, hi), _mm_andnot_si128(m1, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + stride * j), result);
+  }
+#elif BA_BLOCK_DECODE_NEON
+  const uint32_t bit0_vals[4] = {0x01, 0x04, 0x10, 0x40};
+  const uint32_t bit1_vals[4] = {0x02, 0x08, 0x20, 0x80};
+  const uint32x4_t bit0 = vld1q_u32(bit0_vals);
+  const uint32x4_t bit1 = vld1q_u32(bit1_vals);
+  const uint32x4_t p0 = vdupq_n_u32(palette[0]);
+  const uint32x4_t p1 = vdupq_n_u32(palette[1]);
+  const uint32x4_t p2 = vdupq_n_u32(palette[2]);
+  const uint32x4_t p3 = vdupq_n_u32(palette[3]);
+  for (int j = 0; j < 4; j++) {
+    uint32x4_t v = vdupq_n_u32((codes >> (8 * j)) & 0xFF);
+    uint32x4_t m0 = vtstq_u32(v, bit0);
+    uint32x4_t m1 = vtstq_u32(v, bit1);
+    uint32x4_t lo = vbslq_u32(m0, p1, p0);
+    uint32x4_t hi = vbslq_u32(m0, p3, p2);
+    vst1q_u32(out + stride * j, vbslq_u32(m1, hi, lo));
+  }
+#else
+  for (uint32_t j = 0; j < 4; j++) {
+    for (uint32_t i = 0; i < 4; i++) {
+      out[stride * j + i] = palette[(codes >> (2 * (4 * j + i))) & 0x03];
+    }
+  }
+#endif
+}
+
+// Copy a decoded 4x4 block into an image, clipping at its edges.
+inline void StoreBlock(const uint32_t block[16], uint32_t x, uint32_t y,
+                       uint32_t width, uint32_t height, uint32_t* image) {
+  for (uint32_t j = 0; j < 4 && y + j < height; j++) {
+    for (uint32_t i = 0; i < 4 && x + i < width; i++) {
+      image[(y + j) * width + (x + i)] = block[4 * j + i];
+    }
+  }
+}
+
+// Run fn(begin, end) over ranges of block rows covering [0, block_rows).
+// Blocks decode independently, so big images get split across the job
+// pool (small ones aren't worth the overhead).
+template <typename F>
+void ForEachBlockRowRange(uint32_t block_rows, uint32_t block_columns,
+                          F&& fn) {
+  const uint32_t kMinParallelBlocks = 128 * 128;
+  const uint32_t kMinRowsPerJob = 16;
+  if (g_job_pool == nullptr
+      || block_rows * block_columns < kMinParallelBlocks) {
+    fn(0u, block_rows);
+    return;
+  }
+  g_job_pool->ParallelFor(block_rows, kMinRowsPerJob,
+                          [&fn](size_t begin, size_t end) {
+                            fn(static_cast<uint32_t>(begin),
+                               static_cast<uint32_t>(end));
+                          });
+}
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_GRAPHICS_TEXTURE_BLOCK_DECODE_H_
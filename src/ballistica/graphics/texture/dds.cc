@@ -2,6 +2,7 @@
 
 #include "ballistica/graphics/texture/dds.h"
 
+#include "ballistica/media/media_archive.h"
 #include "ballistica/platform/platform.h"
 
 #if BA_ENABLE_OPENGL
@@ -39,13 +40,13 @@ void LoadDDS(const std::string& file_name, unsigned char** buffers, int* widths,
              TextureQuality texture_quality, int min_quality, int* base_level) {
   (*base_level) = 0;
 
-  FILE* f = g_platform->FOpen(file_name.c_str(), "rb");
-  if (!f) throw Exception("can't open file: \"" + file_name + "\"");
+  MediaFileReader f(file_name);
+  if (!f.is_open()) throw Exception("can't open file: \"" + file_name + "\"");
 
   DDS_header hdr{};
 
   //  DDS is so simple to read, too
-  BA_PRECONDITION(fread(&hdr, sizeof(hdr), 1, f) == 1);
+  BA_PRECONDITION(f.Read(&hdr, sizeof(hdr)));
   BA_PRECONDITION(hdr.dwMagic == DDS_MAGIC);
   BA_PRECONDITION(hdr.dwSize == 124);
 
@@ -69,7 +70,7 @@ void LoadDDS(const std::string& file_name, unsigned char** buffers, int* widths,
   } else if (PF_IS_EXTENDED(hdr.sPixelFormat)) {
     DDS_header_DX10 hExt;
 
-    BA_PRECONDITION(fread(&hExt, sizeof(hExt), 1, f) == 1);
+    BA_PRECONDITION(f.Read(&hExt, sizeof(hExt)));
 
     // Format should be unknown.
     // Hmmm we have no way of determining that this is etc1 data so we just
@@ -117,12 +118,10 @@ void LoadDDS(const std::string& file_name, unsigned char** buffers, int* widths,
         widths[ix] = static_cast<int>(x);
         heights[ix] = static_cast<int>(y);
         formats[ix] = li->internal_format;
-        BA_PRECONDITION(fread(buffers[ix], size, 1, f) == 1);
+        BA_PRECONDITION(f.Read(buffers[ix], size));
       } else {
         buffers[ix] = nullptr;
-        BA_PRECONDITION(fseek(f, static_cast_check_fit<long>(size),  // NOLINT
-                              SEEK_CUR)
-                        == 0);
+        BA_PRECONDITION(f.Skip(size));
       }
 
       x = (x + 1u) >> 1u;
@@ -135,7 +134,6 @@ void LoadDDS(const std::string& file_name, unsigned char** buffers, int* widths,
   } else {
     throw Exception("regular tex dds support disabled");
   }
-  fclose(f);
 }
 
 #pragma clang diagnostic pop
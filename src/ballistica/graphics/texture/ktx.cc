@@ -2,6 +2,10 @@
 
 #include "ballistica/graphics/texture/ktx.h"
 
+#include <mutex>
+
+#include "ballistica/graphics/texture/block_decode.h"
+#include "ballistica/media/media_archive.h"
 #include "ballistica/platform/platform.h"
 
 #if !BA_HEADLESS_BUILD
@@ -71,12 +75,12 @@ typedef struct KTX_header_t {
 void LoadKTX(const std::string& file_name, unsigned char** buffers, int* widths,
              int* heights, TextureFormat* formats, size_t* sizes,
              TextureQuality texture_quality, int min_quality, int* base_level) {
-  FILE* f = g_platform->FOpen(file_name.c_str(), "rb");
-  if (!f) throw Exception("can't open file: \"" + file_name + "\"");
+  MediaFileReader f(file_name);
+  if (!f.is_open()) throw Exception("can't open file: \"" + file_name + "\"");
 
   KTX_header_t header{};
   static_assert(sizeof(header) == KTX_HEADER_SIZE);
-  BA_PRECONDITION(fread(&header, sizeof(header), 1, f) == 1);
+  BA_PRECONDITION(f.Read(&header, sizeof(header)));
 
   // Make some assumptions; we don't support arrays, more than 1 face, or kv
   // data of any form.
@@ -128,7 +132,7 @@ void LoadKTX(const std::string& file_name, unsigned char** buffers, int* widths,
   }
 
   for (uint32_t level = 0; level < header.numberOfMipmapLevels; ++level) {
-    if (fread(&size, sizeof(size), 1, f) != 1)
+    if (!f.Read(&size, sizeof(size)))
       throw Exception("Error reading texture: '" + file_name + "'");
     sizeRounded = (size + 3) & ~(uint32_t)3;
     BA_PRECONDITION(
@@ -141,16 +145,14 @@ void LoadKTX(const std::string& file_name, unsigned char** buffers, int* widths,
       widths[level] = static_cast<uint32_t>(x);
       heights[level] = static_cast<uint32_t>(y);
       formats[level] = internal_format;
-      BA_PRECONDITION(fread(buffers[level], size, 1, f) == 1);
+      BA_PRECONDITION(f.Read(buffers[level], size));
     } else {
       buffers[level] = nullptr;
-      BA_PRECONDITION(fseek(f, static_cast_check_fit<long>(size), SEEK_CUR)
-                      == 0);
+      BA_PRECONDITION(f.Skip(size));
     }
     x = (x + 1) >> 1;
     y = (y + 1) >> 1;
   }
-  fclose(f);
 }
 
 /**
@@ -2057,8 +2059,6 @@ void KTXUnpackETC(const GLubyte* srcETC, const GLenum srcFormat,
                   GLubyte** dstImage, GLenum* format, GLenum* internal_format,
                   GLenum* type, GLint R16Formats, bool supportsSRGB) {
   unsigned int width, height;
-  unsigned int block_part1, block_part2;
-  unsigned int x, y;
   /*const*/ auto* src = (GLubyte*)srcETC;
   // AF_11BIT is used to compress R11 & RG11 though its not alpha data.
   enum { AF_NONE, AF_1BIT, AF_8BIT, AF_11BIT } alphaFormat = AF_NONE;
@@ -2203,7 +2203,11 @@ void KTXUnpackETC(const GLubyte* srcETC, const GLenum srcFormat,
     // return KTX_OUT_OF_MEMORY;
   }
 
-  if (alphaFormat != AF_NONE) setupAlphaTable();
+  // (Preloads can run on several threads at once).
+  if (alphaFormat != AF_NONE) {
+    static std::once_flag alpha_table_once;
+    std::call_once(alpha_table_once, setupAlphaTable);
+  }
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "ConstantConditionsOC"
@@ -2229,28 +2233,36 @@ void KTXUnpackETC(const GLubyte* srcETC, const GLenum srcFormat,
     //      }
     //    }
   } else {
-    for (y = 0; y < height / 4; y++) {
-      for (x = 0; x < width / 4; x++) {
-        // Decode alpha channel for RGBA
-        if (alphaFormat == AF_8BIT) {
-          decompressBlockAlphaC(src, *dstImage + 3, width, height, 4 * x, 4 * y,
-                                dstChannels);
-          src += 8;
-        }
-        // Decode color dstChannels
-        readBigEndian4byteWord(&block_part1, src);
-        src += 4;
-        readBigEndian4byteWord(&block_part2, src);
-        src += 4;
-        if (alphaFormat == AF_1BIT)
-          decompressBlockETC21BitAlphaC(block_part1, block_part2, *dstImage,
-                                        nullptr, width, height, 4 * x, 4 * y,
-                                        dstChannels);
-        else
-          decompressBlockETC2c(block_part1, block_part2, *dstImage, width,
-                               height, 4 * x, 4 * y, dstChannels);
-      }
-    }
+    // Blocks are independent, so we can split rows of them across threads.
+    uint32_t block_bytes = (alphaFormat == AF_8BIT) ? 16 : 8;
+    GLubyte* dst = *dstImage;
+    ForEachBlockRowRange(
+        height / 4, width / 4, [&](uint32_t begin, uint32_t end) {
+          unsigned int block_part1, block_part2;
+          for (uint32_t y = begin; y < end; y++) {
+            GLubyte* src_row = src + y * (width / 4) * block_bytes;
+            for (uint32_t x = 0; x < width / 4; x++) {
+              GLubyte* block = src_row + x * block_bytes;
+
+              // Decode alpha channel for RGBA
+              if (alphaFormat == AF_8BIT) {
+                decompressBlockAlphaC(block, dst + 3, width, height, 4 * x,
+                                      4 * y, dstChannels);
+                block += 8;
+              }
+              // Decode color dstChannels
+              readBigEndian4byteWord(&block_part1, block);
+              readBigEndian4byteWord(&block_part2, block + 4);
+              if (alphaFormat == AF_1BIT)
+                decompressBlockETC21BitAlphaC(block_part1, block_part2, dst,
+                                              nullptr, width, height, 4 * x,
+                                              4 * y, dstChannels);
+              else
+                decompressBlockETC2c(block_part1, block_part2, dst, width,
+                                     height, 4 * x, 4 * y, dstChannels);
+            }
+          }
+        });
   }
 
 #pragma clang diagnostic pop
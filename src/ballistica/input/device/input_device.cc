@@ -273,6 +273,34 @@ void InputDevice::UpdateLastInputTime() {
   g_input->mark_input_active();
 }
 
+// Commands whose values just replace the previous ones (as opposed to
+// presses/releases, which are events).
+static auto IsAxisInputType(InputType type) -> bool {
+  return type == InputType::kUpDown || type == InputType::kLeftRight
+         || type == InputType::kRun;
+}
+
+// The host applies a whole input-commands message at once, so an axis
+// value is dead if a newer value for the same axis follows it with only
+// other axis values in between. Analog sticks generate lots of these;
+// this overwrites one in place if possible, returning success.
+static auto ReplaceBufferedAxisValue(std::vector<uint8_t>* buffer,
+                                     InputType type, float value) -> bool {
+  // Entries are 5 bytes (type + value) following a 2 byte header.
+  for (size_t i = buffer->size(); i >= 2 + 5; i -= 5) {
+    size_t entry = i - 5;
+    auto entry_type = static_cast<InputType>((*buffer)[entry]);
+    if (!IsAxisInputType(entry_type)) {
+      return false;
+    }
+    if (entry_type == type) {
+      memcpy(&((*buffer)[entry + 1]), &value, 4);
+      return true;
+    }
+  }
+  return false;
+}
+
 void InputDevice::InputCommand(InputType type, float value) {
   assert(InGameThread());
 
@@ -293,6 +321,10 @@ void InputDevice::InputCommand(InputType type, float value) {
             BA_MESSAGE_REMOTE_PLAYER_INPUT_COMMANDS;
         remote_input_commands_buffer_[1] =
             static_cast_check_fit<uint8_t>(index());
+      } else if (IsAxisInputType(type)
+                 && ReplaceBufferedAxisValue(&remote_input_commands_buffer_,
+                                             type, value)) {
+        return;
       }
       // Now add this command; add 1 byte for type, 4 for value.
       remote_input_commands_buffer_.resize(remote_input_commands_buffer_.size()
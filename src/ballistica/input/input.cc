@@ -2,15 +2,20 @@
 
 #include "ballistica/input/input.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "ballistica/app/app_config.h"
 #include "ballistica/app/app_globals.h"
 #include "ballistica/audio/audio.h"
 #include "ballistica/game/player.h"
+#include "ballistica/game/telemetry.h"
 #include "ballistica/graphics/camera.h"
 #include "ballistica/input/device/joystick.h"
 #include "ballistica/input/device/keyboard_input.h"
 #include "ballistica/input/device/test_input.h"
 #include "ballistica/input/device/touch_input.h"
+#include "ballistica/input/input_latency.h"
 #include "ballistica/python/python.h"
 #include "ballistica/ui/console.h"
 #include "ballistica/ui/root_ui.h"
@@ -1005,7 +1010,7 @@ void Input::PrintLockLabels() {
   Log(s);
 }
 
-void Input::ProcessStressTesting(int player_count) {
+void Input::ProcessStressTesting(int player_count, bool churn) {
   assert(InMainThread());
   assert(player_count >= 0);
 
@@ -1021,13 +1026,17 @@ void Input::ProcessStressTesting(int player_count) {
   }
 
   // If we have less than full test-inputs, add one randomly.
-  if (static_cast<int>(test_inputs_.size()) < player_count
-      && ((rand() % 1000 < 10))) {  // NOLINT
+  if (!churn) {
+    while (static_cast<int>(test_inputs_.size()) < player_count) {
+      test_inputs_.push_back(new TestInput());
+    }
+  } else if (static_cast<int>(test_inputs_.size()) < player_count
+             && ((rand() % 1000 < 10))) {  // NOLINT
     test_inputs_.push_back(new TestInput());
   }
 
   // Every so often lets kill the oldest one off.
-  if (explicit_bool(true)) {
+  if (churn) {
     if (test_inputs_.size() > 0 && (rand() % 2000 < 3)) {  // NOLINT
       stress_test_last_leave_time_ = time;
 
@@ -1087,6 +1096,7 @@ void Input::HandleBackPress(bool from_toolbar) {
 }
 
 void Input::PushTextInputEvent(const std::string& text) {
+  EndInputCoalescing();
   g_game->PushCall([this, text] {
     mark_input_active();
 
@@ -1103,10 +1113,84 @@ void Input::PushTextInputEvent(const std::string& text) {
   });
 }
 
+static void NoteInputHandled(int64_t timestamp, int event_count) {
+  Telemetry::AddInputEvent(
+      static_cast<double>(InputLatency::GetTimestamp() - timestamp) * 0.000001,
+      event_count);
+}
+
+struct Input::PendingInput {
+  int64_t timestamp{};  // When the first event folded into us arrived.
+  int event_count{1};
+  bool taken{};
+  SDL_Event event{};
+  InputDevice* input_device{};
+  Vector2f value{0.0f, 0.0f};
+  bool momentum{};
+};
+
+auto Input::EndInputCoalescing() -> void {
+  std::lock_guard<std::mutex> lock(pending_input_mutex_);
+  pending_mouse_motion_.reset();
+  pending_smooth_scroll_.reset();
+  pending_joystick_axes_.clear();
+}
+
 auto Input::PushJoystickEvent(const SDL_Event& event, InputDevice* input_device)
     -> void {
-  g_game->PushCall([this, event, input_device] {
-    HandleJoystickEvent(event, input_device);
+  int64_t timestamp = InputLatency::GetTimestamp();
+
+  // Anything but stick motion needs handling exactly as it came.
+  if (event.type != SDL_JOYAXISMOTION) {
+    EndInputCoalescing();
+    g_game->PushCall([this, event, input_device, timestamp] {
+      InputLatency::BeginInput(timestamp);
+      HandleJoystickEvent(event, input_device);
+      InputLatency::EndInput();
+      NoteInputHandled(timestamp, 1);
+    });
+    return;
+  }
+
+  // For stick motion only the latest value for each axis matters.
+  std::shared_ptr<PendingInput> pending;
+  {
+    std::lock_guard<std::mutex> lock(pending_input_mutex_);
+    for (auto&& axis : pending_joystick_axes_) {
+      if (!axis->taken && axis->input_device == input_device
+          && axis->event.jaxis.which == event.jaxis.which
+          && axis->event.jaxis.axis == event.jaxis.axis) {
+        axis->event = event;
+        axis->event_count++;
+        return;
+      }
+    }
+    pending_joystick_axes_.erase(
+        std::remove_if(pending_joystick_axes_.begin(),
+                       pending_joystick_axes_.end(),
+                       [](const std::shared_ptr<PendingInput>& axis) {
+                         return axis->taken;
+                       }),
+        pending_joystick_axes_.end());
+    pending = std::make_shared<PendingInput>();
+    pending->timestamp = timestamp;
+    pending->event = event;
+    pending->input_device = input_device;
+    pending_joystick_axes_.push_back(pending);
+  }
+  g_game->PushCall([this, pending] {
+    SDL_Event event;
+    int event_count;
+    {
+      std::lock_guard<std::mutex> lock(pending_input_mutex_);
+      pending->taken = true;
+      event = pending->event;
+      event_count = pending->event_count;
+    }
+    InputLatency::BeginInput(pending->timestamp);
+    HandleJoystickEvent(event, pending->input_device);
+    InputLatency::EndInput();
+    NoteInputHandled(pending->timestamp, event_count);
   });
 }
 
@@ -1137,11 +1221,25 @@ void Input::HandleJoystickEvent(const SDL_Event& event,
 }
 
 void Input::PushKeyPressEvent(const SDL_Keysym& keysym) {
-  g_game->PushCall([this, keysym] { HandleKeyPress(&keysym); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  EndInputCoalescing();
+  g_game->PushCall([this, keysym, timestamp] {
+    InputLatency::BeginInput(timestamp);
+    HandleKeyPress(&keysym);
+    InputLatency::EndInput();
+    NoteInputHandled(timestamp, 1);
+  });
 }
 
 void Input::PushKeyReleaseEvent(const SDL_Keysym& keysym) {
-  g_game->PushCall([this, keysym] { HandleKeyRelease(&keysym); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  EndInputCoalescing();
+  g_game->PushCall([this, keysym, timestamp] {
+    InputLatency::BeginInput(timestamp);
+    HandleKeyRelease(&keysym);
+    InputLatency::EndInput();
+    NoteInputHandled(timestamp, 1);
+  });
 }
 
 void Input::HandleKeyPress(const SDL_Keysym* keysym) {
@@ -1392,7 +1490,12 @@ auto Input::UpdateModKeyStates(const SDL_Keysym* keysym, bool press) -> void {
 }
 
 auto Input::PushMouseScrollEvent(const Vector2f& amount) -> void {
-  g_game->PushCall([this, amount] { HandleMouseScroll(amount); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  EndInputCoalescing();
+  g_game->PushCall([this, amount, timestamp] {
+    HandleMouseScroll(amount);
+    NoteInputHandled(timestamp, 1);
+  });
 }
 
 auto Input::HandleMouseScroll(const Vector2f& amount) -> void {
@@ -1425,8 +1528,35 @@ auto Input::HandleMouseScroll(const Vector2f& amount) -> void {
 
 auto Input::PushSmoothMouseScrollEvent(const Vector2f& velocity, bool momentum)
     -> void {
-  g_game->PushCall([this, velocity, momentum] {
-    HandleSmoothMouseScroll(velocity, momentum);
+  int64_t timestamp = InputLatency::GetTimestamp();
+  std::shared_ptr<PendingInput> pending;
+  {
+    // Only the latest velocity matters (until momentum kicks in or out).
+    std::lock_guard<std::mutex> lock(pending_input_mutex_);
+    if (pending_smooth_scroll_ && !pending_smooth_scroll_->taken
+        && pending_smooth_scroll_->momentum == momentum) {
+      pending_smooth_scroll_->value = velocity;
+      pending_smooth_scroll_->event_count++;
+      return;
+    }
+    pending_mouse_motion_.reset();
+    pending = std::make_shared<PendingInput>();
+    pending->timestamp = timestamp;
+    pending->value = velocity;
+    pending->momentum = momentum;
+    pending_smooth_scroll_ = pending;
+  }
+  g_game->PushCall([this, pending] {
+    Vector2f velocity;
+    int event_count;
+    {
+      std::lock_guard<std::mutex> lock(pending_input_mutex_);
+      pending->taken = true;
+      velocity = pending->value;
+      event_count = pending->event_count;
+    }
+    HandleSmoothMouseScroll(velocity, pending->momentum);
+    NoteInputHandled(pending->timestamp, event_count);
   });
 }
 
@@ -1460,7 +1590,34 @@ auto Input::HandleSmoothMouseScroll(const Vector2f& velocity, bool momentum)
 }
 
 auto Input::PushMouseMotionEvent(const Vector2f& position) -> void {
-  g_game->PushCall([this, position] { HandleMouseMotion(position); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  std::shared_ptr<PendingInput> pending;
+  {
+    // Only the latest position matters.
+    std::lock_guard<std::mutex> lock(pending_input_mutex_);
+    if (pending_mouse_motion_ && !pending_mouse_motion_->taken) {
+      pending_mouse_motion_->value = position;
+      pending_mouse_motion_->event_count++;
+      return;
+    }
+    pending_smooth_scroll_.reset();
+    pending = std::make_shared<PendingInput>();
+    pending->timestamp = timestamp;
+    pending->value = position;
+    pending_mouse_motion_ = pending;
+  }
+  g_game->PushCall([this, pending] {
+    Vector2f position;
+    int event_count;
+    {
+      std::lock_guard<std::mutex> lock(pending_input_mutex_);
+      pending->taken = true;
+      position = pending->value;
+      event_count = pending->event_count;
+    }
+    HandleMouseMotion(position);
+    NoteInputHandled(pending->timestamp, event_count);
+  });
 }
 
 auto Input::HandleMouseMotion(const Vector2f& position) -> void {
@@ -1511,8 +1668,12 @@ auto Input::HandleMouseMotion(const Vector2f& position) -> void {
 }
 
 auto Input::PushMouseDownEvent(int button, const Vector2f& position) -> void {
-  g_game->PushCall(
-      [this, button, position] { HandleMouseDown(button, position); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  EndInputCoalescing();
+  g_game->PushCall([this, button, position, timestamp] {
+    HandleMouseDown(button, position);
+    NoteInputHandled(timestamp, 1);
+  });
 }
 
 auto Input::HandleMouseDown(int button, const Vector2f& position) -> void {
@@ -1588,8 +1749,12 @@ auto Input::HandleMouseDown(int button, const Vector2f& position) -> void {
 }
 
 auto Input::PushMouseUpEvent(int button, const Vector2f& position) -> void {
-  g_game->PushCall(
-      [this, button, position] { HandleMouseUp(button, position); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  EndInputCoalescing();
+  g_game->PushCall([this, button, position, timestamp] {
+    HandleMouseUp(button, position);
+    NoteInputHandled(timestamp, 1);
+  });
 }
 
 auto Input::HandleMouseUp(int button, const Vector2f& position) -> void {
@@ -1637,7 +1802,12 @@ auto Input::HandleMouseUp(int button, const Vector2f& position) -> void {
 }
 
 void Input::PushTouchEvent(const TouchEvent& e) {
-  g_game->PushCall([e, this] { HandleTouchEvent(e); });
+  int64_t timestamp = InputLatency::GetTimestamp();
+  EndInputCoalescing();
+  g_game->PushCall([e, this, timestamp] {
+    HandleTouchEvent(e);
+    NoteInputHandled(timestamp, 1);
+  });
 }
 
 void Input::HandleTouchEvent(const TouchEvent& e) {
@@ -4,6 +4,8 @@
 #define BALLISTICA_INPUT_INPUT_H_
 
 #include <list>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -105,7 +107,10 @@ class Input {
   auto HaveControllerWithPlayer() -> bool;
   auto HaveRemoteAppController() -> bool;
   auto HandleBackPress(bool from_toolbar) -> void;
-  auto ProcessStressTesting(int player_count) -> void;
+  /// Drive test inputs for stress testing. Without churn we keep exactly
+  /// player_count of them around instead of randomly adding and dropping
+  /// some (for more repeatable load tests).
+  auto ProcessStressTesting(int player_count, bool churn) -> void;
   auto keyboard_input() const -> KeyboardInput* { return keyboard_input_; }
   auto keyboard_input_2() const -> KeyboardInput* { return keyboard_input_2_; }
   auto CreateTouchInput() -> void;
@@ -155,6 +160,7 @@ class Input {
   auto UpdateModKeyStates(const SDL_Keysym* keysym, bool press) -> void;
   auto CreateKeyboardInputDevices() -> void;
   auto DestroyKeyboardInputDevices() -> void;
+  auto EndInputCoalescing() -> void;
 
   bool input_active_{};
   millisecs_t input_idle_time_{};
@@ -197,6 +203,15 @@ class Input {
   millisecs_t stress_test_time_{};
   millisecs_t stress_test_last_leave_time_{};
   void* single_touch_{};
+
+  // Motion-type events waiting on the game thread. Pushed events of the
+  // same kind fold into these until they're handled or until some other
+  // event gets pushed after them, so button edges keep their order.
+  struct PendingInput;
+  std::mutex pending_input_mutex_;
+  std::shared_ptr<PendingInput> pending_mouse_motion_;
+  std::shared_ptr<PendingInput> pending_smooth_scroll_;
+  std::vector<std::shared_ptr<PendingInput> > pending_joystick_axes_;
 };
 
 }  // namespace ballistica
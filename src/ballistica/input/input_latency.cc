@@ -0,0 +1,206 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/input/input_latency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include "ballistica/generic/json_stream.h"
+#include "ballistica/generic/utils.h"
+#include "ballistica/graphics/benchmark_recorder.h"
+#include "ballistica/graphics/frame_def.h"
+#include "ballistica/graphics/graphics.h"
+
+namespace ballistica {
+
+// Samples kept for each stage.
+const size_t kInputLatencySampleCount = 256;
+
+struct InputLatencySamples {
+  std::vector<float> ms;
+  size_t next{};
+
+  void Add(int64_t microseconds) {
+    auto val = static_cast<float>(microseconds) * 0.001f;
+    if (ms.size() < kInputLatencySampleCount) {
+      ms.push_back(val);
+    } else {
+      ms[next] = val;
+      next = (next + 1) % kInputLatencySampleCount;
+    }
+  }
+  auto Sorted() const -> std::vector<float> {
+    std::vector<float> sorted = ms;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+  }
+};
+
+struct InputLatencyState {
+  // Game thread only.
+  bool handling_input{};
+  int64_t handling_timestamp{};
+  int64_t pending_input{};          // Oldest input not in a frame yet.
+  int64_t pending_control_input{};  // Same but only those changing controls.
+
+  // Swaps come in from the graphics thread.
+  std::mutex mutex;
+  InputLatencySamples control;       // Input to control change.
+  InputLatencySamples frame;         // Input to FrameDef built.
+  InputLatencySamples swap;          // Input to swap.
+  InputLatencySamples control_swap;  // Control-changing input to swap.
+};
+static InputLatencyState* g_input_latency{};
+
+static auto GetInputLatencyState() -> InputLatencyState* {
+  if (g_input_latency == nullptr) {
+    g_input_latency = new InputLatencyState();
+  }
+  return g_input_latency;
+}
+
+static auto InputLatencyEnabled() -> bool {
+  assert(InGameThread());
+  return (g_graphics && g_graphics->network_debug_info_display_enabled())
+         || BenchmarkRecorder::recording();
+}
+
+auto InputLatency::GetTimestamp() -> int64_t {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void InputLatency::BeginInput(int64_t timestamp) {
+  if (!InputLatencyEnabled()) {
+    return;
+  }
+  InputLatencyState* state = GetInputLatencyState();
+  state->handling_input = true;
+  state->handling_timestamp = timestamp;
+  if (state->pending_input == 0) {
+    state->pending_input = timestamp;
+  }
+}
+
+void InputLatency::EndInput() {
+  assert(InGameThread());
+  if (g_input_latency) {
+    g_input_latency->handling_input = false;
+  }
+}
+
+void InputLatency::NoteControl() {
+  assert(InGameThread());
+
+  // Only changes made while handling input count (not ones from bots).
+  InputLatencyState* state = g_input_latency;
+  if (state == nullptr || !state->handling_input) {
+    return;
+  }
+  if (state->pending_control_input == 0) {
+    state->pending_control_input = state->handling_timestamp;
+  }
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->control.Add(GetTimestamp() - state->handling_timestamp);
+
+  // Only the first change per input event.
+  state->handling_input = false;
+}
+
+void InputLatency::NoteFrameBuilt(FrameDef* frame_def) {
+  assert(InGameThread());
+  InputLatencyState* state = g_input_latency;
+  if (state == nullptr || state->pending_input == 0) {
+    return;
+  }
+  frame_def->set_input_timestamp(state->pending_input);
+  frame_def->set_control_input_timestamp(state->pending_control_input);
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->frame.Add(GetTimestamp() - state->pending_input);
+  }
+  state->pending_input = 0;
+  state->pending_control_input = 0;
+}
+
+void InputLatency::NoteFrameSwapped(FrameDef* frame_def) {
+  if (frame_def->input_timestamp() == 0) {
+    return;
+  }
+  InputLatencyState* state = GetInputLatencyState();
+  int64_t now = GetTimestamp();
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->swap.Add(now - frame_def->input_timestamp());
+  if (frame_def->control_input_timestamp() != 0) {
+    state->control_swap.Add(now - frame_def->control_input_timestamp());
+  }
+}
+
+auto InputLatency::GetStatsString() -> std::string {
+  InputLatencyState* state = GetInputLatencyState();
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (state->swap.ms.empty()) {
+    return "";
+  }
+  std::string out = "input ms p50/p99";
+  char buffer[64];
+  for (auto&& stage :
+       {std::make_pair("ctl", &state->control),
+        std::make_pair("frame", &state->frame),
+        std::make_pair("swap", &state->swap),
+        std::make_pair("play", &state->control_swap)}) {
+    if (stage.second->ms.empty()) {
+      continue;
+    }
+    std::vector<float> sorted = stage.second->Sorted();
+    snprintf(buffer, sizeof(buffer), "  %s:%.1f/%.1f", stage.first,
+             Utils::SortedPercentile(sorted, 0.5),
+             Utils::SortedPercentile(sorted, 0.99));
+    out += buffer;
+  }
+  return out;
+}
+
+static void WriteInputLatencySamples(JsonWriter* writer, const char* key,
+                                     const InputLatencySamples& samples) {
+  std::vector<float> sorted = samples.Sorted();
+  writer->Key(key)
+      .BeginObject()
+      .Key("count")
+      .Int(static_cast<int64_t>(sorted.size()))
+      .Key("p50")
+      .Number(Utils::SortedPercentile(sorted, 0.5))
+      .Key("p90")
+      .Number(Utils::SortedPercentile(sorted, 0.9))
+      .Key("p99")
+      .Number(Utils::SortedPercentile(sorted, 0.99))
+      .Key("max")
+      .Number(sorted.empty() ? 0.0 : sorted.back())
+      .EndObject();
+}
+
+void InputLatency::WriteStatsJson(JsonWriter* writer) {
+  InputLatencyState* state = GetInputLatencyState();
+  std::lock_guard<std::mutex> lock(state->mutex);
+  writer->BeginObject();
+  WriteInputLatencySamples(writer, "to_control", state->control);
+  WriteInputLatencySamples(writer, "to_frame", state->frame);
+  WriteInputLatencySamples(writer, "to_swap", state->swap);
+  WriteInputLatencySamples(writer, "control_to_swap", state->control_swap);
+  writer->EndObject();
+}
+
+void InputLatency::Reset() {
+  InputLatencyState* state = GetInputLatencyState();
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->control = InputLatencySamples();
+  state->frame = InputLatencySamples();
+  state->swap = InputLatencySamples();
+  state->control_swap = InputLatencySamples();
+}
+
+}  // namespace ballistica
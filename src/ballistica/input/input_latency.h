@@ -0,0 +1,49 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_INPUT_INPUT_LATENCY_H_
+#define BALLISTICA_INPUT_INPUT_LATENCY_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Measures how long key and joystick input takes to show up on screen.
+/// The oldest input not yet drawn is followed to the first SpazNode control
+/// change it causes, to the first FrameDef built after it, and to when that
+/// frame is swapped to the screen. Only runs while the network debug
+/// display is up or a benchmark is being recorded.
+class InputLatency {
+ public:
+  /// Microseconds on a monotonic clock; what input events get stamped with.
+  static auto GetTimestamp() -> int64_t;
+
+  /// Called by Input around handling events it should follow.
+  /// Game thread only.
+  static void BeginInput(int64_t timestamp);
+  static void EndInput();
+
+  /// Called by SpazNode when one of its controls changes. Game thread only.
+  static void NoteControl();
+
+  /// Called by Graphics just before pushing each FrameDef.
+  static void NoteFrameBuilt(FrameDef* frame_def);
+
+  /// Called by GraphicsServer once a FrameDef has been drawn and swapped.
+  static void NoteFrameSwapped(FrameDef* frame_def);
+
+  /// Percentiles as a short line for the debug display (empty if there's
+  /// nothing yet).
+  static auto GetStatsString() -> std::string;
+
+  /// Percentiles as a json object value.
+  static void WriteStatsJson(JsonWriter* writer);
+
+  /// Drop samples gathered so far.
+  static void Reset();
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_INPUT_INPUT_LATENCY_H_
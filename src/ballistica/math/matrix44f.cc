@@ -103,6 +103,57 @@ auto Matrix44fFrustum(float left, float right, float bottom, float top,
   return Matrix44f(m_persp);
 }
 
+void Matrix44f::TransformPoints(const Vector3f* in, Vector3f* out,
+                                size_t count) const {
+#if BA_MATRIX44F_SSE
+  __m128 c0 = _mm_loadu_ps(m);
+  __m128 c1 = _mm_loadu_ps(m + 4);
+  __m128 c2 = _mm_loadu_ps(m + 8);
+  __m128 c3 = _mm_loadu_ps(m + 12);
+  float prod[4];
+  for (size_t i = 0; i < count; i++) {
+    const Vector3f& vec = in[i];
+    __m128 r = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(vec.x), c0),
+                              _mm_mul_ps(_mm_set1_ps(vec.y), c1)),
+                   _mm_mul_ps(_mm_set1_ps(vec.z), c2)),
+        c3);
+    _mm_storeu_ps(prod, r);
+    float div = 1.0f / prod[3];
+    out[i] = {prod[0] * div, prod[1] * div, prod[2] * div};
+  }
+#elif BA_MATRIX44F_NEON
+  float32x4_t c0 = vld1q_f32(m);
+  float32x4_t c1 = vld1q_f32(m + 4);
+  float32x4_t c2 = vld1q_f32(m + 8);
+  float32x4_t c3 = vld1q_f32(m + 12);
+  float prod[4];
+  for (size_t i = 0; i < count; i++) {
+    const Vector3f& vec = in[i];
+    float32x4_t r = vmulq_n_f32(c0, vec.x);
+    r = vaddq_f32(r, vmulq_n_f32(c1, vec.y));
+    r = vaddq_f32(r, vmulq_n_f32(c2, vec.z));
+    r = vaddq_f32(r, c3);
+    vst1q_f32(prod, r);
+    float div = 1.0f / prod[3];
+    out[i] = {prod[0] * div, prod[1] * div, prod[2] * div};
+  }
+#else
+  for (size_t i = 0; i < count; i++) {
+    out[i] = (*this) * in[i];
+  }
+#endif
+}
+
+void Matrix44f::TransformNormals(const Vector3f* in, Vector3f* out,
+                                 size_t count) const {
+  Matrix44f m2{*this};
+  m2.set_tx(0);
+  m2.set_ty(0);
+  m2.set_tz(0);
+  m2.TransformPoints(in, out, count);
+}
+
 auto Matrix44f::Transpose() const -> Matrix44f {
   Matrix44f tmp;  // NOLINT: uninitialized on purpose.
   for (int i = 0; i < 4; i++) {
@@ -7,6 +7,17 @@
 
 #include "ballistica/math/vector3f.h"
 
+// Use SIMD for the hot paths where available; the scalar versions
+// remain the reference (and the fallback everywhere else).
+#if defined(__SSE__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BA_MATRIX44F_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define BA_MATRIX44F_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace ballistica {
 
 class Matrix44f {
@@ -58,6 +69,36 @@ class Matrix44f {
   // Matrix multiplication.
   auto operator*(const Matrix44f& other) const -> Matrix44f {
     Matrix44f prod;  // NOLINT: uninitialized on purpose.
+#if BA_MATRIX44F_SSE
+    // Each column of the product is a combination of other's columns
+    // weighted by the corresponding column of ours.
+    __m128 o0 = _mm_loadu_ps(other.m);
+    __m128 o1 = _mm_loadu_ps(other.m + 4);
+    __m128 o2 = _mm_loadu_ps(other.m + 8);
+    __m128 o3 = _mm_loadu_ps(other.m + 12);
+    for (int c = 0; c < 4; c++) {
+      const float* col = m + c * 4;
+      __m128 r = _mm_add_ps(
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(col[0]), o0),
+                                _mm_mul_ps(_mm_set1_ps(col[1]), o1)),
+                     _mm_mul_ps(_mm_set1_ps(col[2]), o2)),
+          _mm_mul_ps(_mm_set1_ps(col[3]), o3));
+      _mm_storeu_ps(prod.m + c * 4, r);
+    }
+#elif BA_MATRIX44F_NEON
+    float32x4_t o0 = vld1q_f32(other.m);
+    float32x4_t o1 = vld1q_f32(other.m + 4);
+    float32x4_t o2 = vld1q_f32(other.m + 8);
+    float32x4_t o3 = vld1q_f32(other.m + 12);
+    for (int c = 0; c < 4; c++) {
+      const float* col = m + c * 4;
+      float32x4_t r = vmulq_n_f32(o0, col[0]);
+      r = vaddq_f32(r, vmulq_n_f32(o1, col[1]));
+      r = vaddq_f32(r, vmulq_n_f32(o2, col[2]));
+      r = vaddq_f32(r, vmulq_n_f32(o3, col[3]));
+      vst1q_f32(prod.m + c * 4, r);
+    }
+#else
     for (int c = 0; c < 4; c++) {
       for (int r = 0; r < 4; r++) {
         prod.set(c, r,
@@ -66,6 +107,7 @@ class Matrix44f {
                      + get(c, 3) * other.get(3, r));
       }
     }
+#endif
     return prod;
   }
 
@@ -90,11 +132,29 @@ class Matrix44f {
 
   // Matrix transformation of 3D vector.
   auto operator*(const Vector3f& vec) const -> Vector3f {
+#if BA_MATRIX44F_SSE
+    __m128 r = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(vec.x), _mm_loadu_ps(m)),
+                              _mm_mul_ps(_mm_set1_ps(vec.y),
+                                         _mm_loadu_ps(m + 4))),
+                   _mm_mul_ps(_mm_set1_ps(vec.z), _mm_loadu_ps(m + 8))),
+        _mm_loadu_ps(m + 12));
+    float prod[4];
+    _mm_storeu_ps(prod, r);
+#elif BA_MATRIX44F_NEON
+    float32x4_t r = vmulq_n_f32(vld1q_f32(m), vec.x);
+    r = vaddq_f32(r, vmulq_n_f32(vld1q_f32(m + 4), vec.y));
+    r = vaddq_f32(r, vmulq_n_f32(vld1q_f32(m + 8), vec.z));
+    r = vaddq_f32(r, vld1q_f32(m + 12));
+    float prod[4];
+    vst1q_f32(prod, r);
+#else
     float prod[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     for (int r = 0; r < 4; r++) {
       for (int c = 0; c < 3; c++) prod[r] += vec.v[c] * get(c, r);
       prod[r] += get(3, r);
     }
+#endif
     float div = 1.0f / prod[3];
     return {prod[0] * div, prod[1] * div, prod[2] * div};
   }
@@ -109,6 +169,15 @@ class Matrix44f {
     return m2 * val;
   }
 
+  // Transform 'count' points at once (same results as operator* on each).
+  // In-place use (in == out) is fine.
+  void TransformPoints(const Vector3f* in, Vector3f* out, size_t count) const;
+
+  // Rotate/scale 'count' vectors at once (same results as
+  // TransformAsNormal() on each). In-place use (in == out) is fine.
+  void TransformNormals(const Vector3f* in, Vector3f* out,
+                        size_t count) const;
+
   // Equality operator.
   auto operator==(const Matrix44f& other) const -> bool {
     return !memcmp(m, other.m, sizeof(m));
@@ -3,6 +3,8 @@
 #ifndef BALLISTICA_MATH_RANDOM_H_
 #define BALLISTICA_MATH_RANDOM_H_
 
+#include <cstdint>
+
 namespace ballistica {
 
 class Random {
@@ -12,6 +14,40 @@ class Random {
   static void GenList3D(float (*list)[3], int size);
 };
 
+/// A small fast generator with its own state, for when results need to be
+/// repeatable from a seed (unlike RandomFloat()). Not thread-safe; give
+/// each thread its own.
+class SeededRandom {
+ public:
+  explicit SeededRandom(uint64_t seed = 0) { Seed(seed); }
+
+  /// Restart our sequence; a given seed always yields the same values.
+  void Seed(uint64_t seed) {
+    // Run it through a splitmix64 step so nearby seeds give unrelated
+    // sequences.
+    uint64_t z = seed + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27u)) * 0x94d049bb133111ebull;
+    state_ = z ^ (z >> 31u);
+
+    // Xorshift gets stuck on zero.
+    if (state_ == 0) {
+      state_ = 1;
+    }
+  }
+
+  /// Return a value in the range [0, 1).
+  auto NextFloat() -> float {
+    state_ ^= state_ << 13u;
+    state_ ^= state_ >> 7u;
+    state_ ^= state_ << 17u;
+    return static_cast<float>(state_ >> 40u) * (1.0f / 16777216.0f);
+  }
+
+ private:
+  uint64_t state_{};
+};
+
 }  // namespace ballistica
 
 #endif  // BALLISTICA_MATH_RANDOM_H_
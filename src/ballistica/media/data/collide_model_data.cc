@@ -3,9 +3,93 @@
 #include "ballistica/media/data/collide_model_data.h"
 
 #include "ballistica/media/media.h"
+#include "ballistica/media/media_archive.h"
+#include "ballistica/platform/platform.h"
 
 namespace ballistica {
 
+// Bump this if OPCODE's tree building changes.
+const uint32_t kCollideTreeCacheVersion = 1;
+
+// Fixed layout at the head of each tree cache file; followed by the tree.
+struct CollideTreeCacheHeader {
+  uint32_t version;
+  uint32_t tri_count;
+  int64_t source_mod_time;
+  uint32_t tree_size;
+  uint32_t pad;
+};
+
+static auto GetCollideTreeCacheFileName(const std::string& file_name)
+    -> std::string {
+  std::string cache_dir = g_platform->GetConfigDirectory() + "/collidecache";
+
+  // (Preloads can run on several threads; statics init safely).
+  static bool made_cache_dir = (g_platform->MakeDir(cache_dir), true);
+  assert(made_cache_dir);
+  std::string name = file_name;
+  for (auto&& c : name) {
+    if (c == '/') {
+      c = '_';
+    }
+  }
+  return cache_dir + "/" + name + ".cache";
+}
+
+// Read a collision tree cached by a previous run (if it's still valid).
+static auto LoadCollideTreeCache(const std::string& file_name,
+                                 time_t mod_time, size_t tri_count,
+                                 std::vector<char>* tree) -> bool {
+  if (mod_time == 0) {
+    return false;
+  }
+  FILE* f =
+      g_platform->FOpen(GetCollideTreeCacheFileName(file_name).c_str(), "rb");
+  if (!f) {
+    return false;
+  }
+  bool success = false;
+  CollideTreeCacheHeader header{};
+  if (fread(&header, sizeof(header), 1, f) == 1
+      && header.version == kCollideTreeCacheVersion
+      && header.tri_count == tri_count
+      && header.source_mod_time == static_cast<int64_t>(mod_time)
+      && header.tree_size > 0) {
+    tree->resize(header.tree_size);
+    success = fread(tree->data(), tree->size(), 1, f) == 1;
+  }
+  fclose(f);
+  return success;
+}
+
+static void WriteCollideTreeCache(const std::string& file_name,
+                                  time_t mod_time, size_t tri_count,
+                                  dTriMeshDataID data) {
+  int tree_size = dGeomTriMeshDataGetTreeSize(data);
+  if (mod_time == 0 || tree_size <= 0) {
+    return;
+  }
+  std::vector<char> tree(static_cast<size_t>(tree_size));
+  dGeomTriMeshDataSaveTree(data, tree.data());
+  CollideTreeCacheHeader header{};
+  header.version = kCollideTreeCacheVersion;
+  header.tri_count = static_cast_check_fit<uint32_t>(tri_count);
+  header.source_mod_time = static_cast<int64_t>(mod_time);
+  header.tree_size = static_cast<uint32_t>(tree_size);
+  std::string cache_file_name = GetCollideTreeCacheFileName(file_name);
+  FILE* f = g_platform->FOpen(cache_file_name.c_str(), "wb");
+  if (f) {
+    bool success = fwrite(&header, sizeof(header), 1, f) == 1
+                   && fwrite(tree.data(), tree.size(), 1, f) == 1;
+    fclose(f);
+
+    // Attempt to clean up if it looks like something went wrong.
+    if (!success) {
+      g_platform->Unlink(cache_file_name.c_str());
+    }
+  }
+}
+
 CollideModelData::CollideModelData(const std::string& file_name_in)
     : file_name_(file_name_in) {
   file_name_full_ =
@@ -16,14 +100,14 @@ CollideModelData::CollideModelData(const std::string& file_name_in)
 void CollideModelData::DoPreload() {
   assert(!file_name_.empty());
 
-  FILE* f = g_platform->FOpen(file_name_full_.c_str(), "rb");
+  MediaFileReader f(file_name_full_);
   uint32_t i_vals[2];
-  if (!f) {
+  if (!f.is_open()) {
     throw Exception("Can't open collide model: '" + file_name_full_ + "'");
   }
 
   uint32_t version;
-  if (fread(&version, sizeof(version), 1, f) != 1) {
+  if (!f.Read(&version, sizeof(version))) {
     throw Exception("Error reading file header for '" + file_name_full_ + "'");
   }
 
@@ -35,7 +119,7 @@ void CollideModelData::DoPreload() {
   }
 
   // Read the vertex count and face count.
-  if (fread(i_vals, sizeof(i_vals), 1, f) != 1) {
+  if (!f.Read(i_vals, sizeof(i_vals))) {
     throw Exception("Read failed for " + file_name_full_);
   }
 
@@ -51,18 +135,16 @@ void CollideModelData::DoPreload() {
   // Need 3 floats per face-normal.
   normals_.resize(tri_count * 3);
 
-  if (fread(&(vertices_[0]), vertices_.size() * sizeof(dReal), 1, f) != 1) {
+  if (!f.Read(&(vertices_[0]), vertices_.size() * sizeof(dReal))) {
     throw Exception("Read failed for " + file_name_full_);
   }
-  if (fread(&(indices_[0]), indices_.size() * sizeof(uint32_t), 1, f) != 1) {
+  if (!f.Read(&(indices_[0]), indices_.size() * sizeof(uint32_t))) {
     throw Exception("Read failed for " + file_name_full_);
   }
-  if (fread(&(normals_[0]), normals_.size() * sizeof(dReal), 1, f) != 1) {
+  if (!f.Read(&(normals_[0]), normals_.size() * sizeof(dReal))) {
     throw Exception("Read failed for " + file_name_full_);
   }
 
-  fclose(f);
-
   tri_mesh_data_ = dGeomTriMeshDataCreate();
   BA_PRECONDITION(tri_mesh_data_);
 
@@ -72,15 +154,27 @@ void CollideModelData::DoPreload() {
   }
 
 #ifdef dSINGLE
-  dGeomTriMeshDataBuildSingle1(
-      tri_mesh_data_, &(vertices_[0]), 3 * sizeof(dReal),
-      static_cast_check_fit<int>(vertex_count), &(indices_[0]),
-      static_cast<int>(indices_.size()), 3 * sizeof(uint32_t), &(normals_[0]));
-  if (!HeadlessMode()) {
-    dGeomTriMeshDataBuildSingle1(tri_mesh_data_bg_, &(vertices_[0]),
-                                 3 * sizeof(dReal), i_vals[0], &(indices_[0]),
-                                 static_cast<int>(indices_.size()),
-                                 3 * sizeof(uint32_t), &(normals_[0]));
+  // Building the collision tree is the expensive part; we keep built ones
+  // around on disk to skip that next time.
+  time_t mod_time = g_media->GetMediaFileModTime(file_name_full_);
+  std::vector<char> tree;
+  bool built = false;
+  if (LoadCollideTreeCache(file_name_full_, mod_time, tri_count, &tree)) {
+    built = dGeomTriMeshDataBuildSingleWithTree(
+                tri_mesh_data_, &(vertices_[0]), 3 * sizeof(dReal),
+                static_cast_check_fit<int>(vertex_count), &(indices_[0]),
+                static_cast<int>(indices_.size()), 3 * sizeof(uint32_t),
+                &(normals_[0]), tree.data(), static_cast<int>(tree.size()))
+            != 0;
+  }
+  if (!built) {
+    dGeomTriMeshDataBuildSingle1(
+        tri_mesh_data_, &(vertices_[0]), 3 * sizeof(dReal),
+        static_cast_check_fit<int>(vertex_count), &(indices_[0]),
+        static_cast<int>(indices_.size()), 3 * sizeof(uint32_t),
+        &(normals_[0]));
+    WriteCollideTreeCache(file_name_full_, mod_time, tri_count,
+                          tri_mesh_data_);
   }
 #else
 #ifndef dDOUBLE
@@ -89,12 +183,13 @@ void CollideModelData::DoPreload() {
   dGeomTriMeshDataBuildDouble1(
       tri_mesh_data_, &(vertices_[0]), 3 * sizeof(dReal), vertex_count,
       &(indices_[0]), indices_.size(), 3 * sizeof(uint32_t), &(normals_[0]));
+#endif  // dSINGLE
+
+  // The bg dynamics thread gets its own data (ODE keeps a bit of
+  // per-data collision state) but it shares our tree read-only.
   if (!HeadlessMode()) {
-    dGeomTriMeshDataBuildDouble1(
-        tri_mesh_data_bg_, &(vertices_[0]), 3 * sizeof(dReal), i_vals[0],
-        &(indices_[0]), indices_.size(), 3 * sizeof(uint32_t), &(normals_[0]));
+    dGeomTriMeshDataBuildShared(tri_mesh_data_bg_, tri_mesh_data_);
   }
-#endif  // dSINGLE
 }  // namespace ballistica
 
 void CollideModelData::DoLoad() { assert(InGameThread()); }
@@ -112,10 +207,11 @@ void CollideModelData::DoUnload() {
     return;
   }
 
-  dGeomTriMeshDataDestroy(tri_mesh_data_);
+  // (The bg data shares our tree, so it goes first).
   if (tri_mesh_data_bg_) {
     dGeomTriMeshDataDestroy(tri_mesh_data_bg_);
   }
+  dGeomTriMeshDataDestroy(tri_mesh_data_);
 }
 
 auto CollideModelData::GetMeshData() -> dTriMeshDataID {
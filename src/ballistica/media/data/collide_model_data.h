@@ -29,7 +29,14 @@ class CollideModelData : public MediaComponentData {
       return "invalid CollideModel";
     }
   }
+  auto file_name() const -> const std::string& { return file_name_; }
   auto GetMeshData() -> dTriMeshDataID;
+
+  // Bytes of mesh data we're holding (0 if not loaded).
+  auto memory_size() const -> size_t {
+    return (vertices_.size() + normals_.size()) * sizeof(dReal)
+           + indices_.size() * sizeof(uint32_t);
+  }
   auto GetBGMeshData() -> dTriMeshDataID;
 
  private:
@@ -2,8 +2,11 @@
 
 #include "ballistica/media/data/model_data.h"
 
+#include <algorithm>
+
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/graphics/renderer.h"
+#include "ballistica/media/media_archive.h"
 
 namespace ballistica {
 
@@ -19,8 +22,8 @@ void ModelData::DoPreload() {
 #if !BA_HEADLESS_BUILD
 
   assert(!file_name_.empty());
-  FILE* f = g_platform->FOpen(file_name_full_.c_str(), "rb");
-  if (!f) {
+  MediaFileReader f(file_name_full_);
+  if (!f.is_open()) {
     throw Exception("Can't open model: '" + file_name_full_ + "'");
   }
 
@@ -31,10 +34,10 @@ void ModelData::DoPreload() {
 #endif
 
   uint32_t version;
-  if (fread(&version, sizeof(version), 1, f) != 1) {
+  if (!f.Read(&version, sizeof(version))) {
     throw Exception("Error reading file header for '" + file_name_full_ + "'");
   }
-  if (version != kBobFileID) {
+  if (version != kBobFileID && version != kBobLODFileID) {
     throw Exception("File: '" + file_name_full_
                     + "' is an old format or not a bob file (got id "
                     + std::to_string(version) + ", "
@@ -42,7 +45,7 @@ void ModelData::DoPreload() {
   }
 
   uint32_t mesh_format;
-  if (fread(&mesh_format, sizeof(mesh_format), 1, f) != 1) {
+  if (!f.Read(&mesh_format, sizeof(mesh_format))) {
     throw Exception("Error reading mesh_format for '" + file_name_full_ + "'");
   }
   format_ = static_cast<MeshFormat>(mesh_format);
@@ -51,41 +54,73 @@ void ModelData::DoPreload() {
                   || (format_ == MeshFormat::kUV16N8Index32));
 
   uint32_t vertex_count;
-  if (fread(&vertex_count, sizeof(vertex_count), 1, f) != 1) {
+  if (!f.Read(&vertex_count, sizeof(vertex_count))) {
     throw Exception("Error reading vertex_count for '" + file_name_full_ + "'");
   }
 
   uint32_t face_count;
-  if (fread(&face_count, sizeof(face_count), 1, f) != 1) {
+  if (!f.Read(&face_count, sizeof(face_count))) {
     throw Exception("Error reading face_count for '" + file_name_full_ + "'");
   }
+  header_size_ = 4 * sizeof(uint32_t);
+
+  // Lod bobs add a count and face counts for their reduced levels (always
+  // kMaxLODs of them so the header stays 16 byte aligned).
+  uint32_t lod_face_counts[kMaxLODs]{};
+  lod_count_ = 0;
+  if (version == kBobLODFileID) {
+    uint32_t lod_count;
+    if (!f.Read(&lod_count, sizeof(lod_count))
+        || !f.Read(lod_face_counts, sizeof(lod_face_counts))) {
+      throw Exception("Error reading lods for '" + file_name_full_ + "'");
+    }
+    BA_PRECONDITION(lod_count <= kMaxLODs);
+    lod_count_ = static_cast<int>(lod_count);
+    header_size_ += (1 + kMaxLODs) * sizeof(uint32_t);
+  }
+  lod_index_offsets_[0] = 0;
+  lod_index_counts_[0] = face_count * 3;
+  uint32_t total_face_count = face_count;
+  for (int i = 0; i < lod_count_; i++) {
+    lod_index_offsets_[i + 1] = total_face_count * 3;
+    lod_index_counts_[i + 1] = lod_face_counts[i] * 3;
+    total_face_count += lod_face_counts[i];
+  }
+
+  // Archived models get uploaded straight from the archive's mapping; we
+  // just make sure it holds everything it claims to.
+  if (f.is_archived()) {
+    if (!f.Skip(vertex_count * sizeof(VertexObjectFull)
+                + static_cast<size_t>(total_face_count) * 3
+                      * GetIndexSize())) {
+      throw Exception("Read failed for " + file_name_full_);
+    }
+    return;
+  }
+  face_count = total_face_count;
 
   vertices_.resize(vertex_count);
-  if (fread(&(vertices_[0]), vertices_.size() * sizeof(VertexObjectFull), 1, f)
-      != 1) {
+  if (!f.Read(&(vertices_[0]), vertices_.size() * sizeof(VertexObjectFull))) {
     throw Exception("Read failed for " + file_name_full_);
   }
   switch (GetIndexSize()) {
     case 1: {
       indices8_.resize(face_count * 3);
-      if (fread(indices8_.data(), indices8_.size() * sizeof(uint8_t), 1, f)
-          != 1) {
+      if (!f.Read(indices8_.data(), indices8_.size() * sizeof(uint8_t))) {
         throw Exception("Read failed for " + file_name_full_);
       }
       break;
     }
     case 2: {
       indices16_.resize(face_count * 3);
-      if (fread(indices16_.data(), indices16_.size() * sizeof(uint16_t), 1, f)
-          != 1) {
+      if (!f.Read(indices16_.data(), indices16_.size() * sizeof(uint16_t))) {
         throw Exception("Read failed for " + file_name_full_);
       }
       break;
     }
     case 4: {
       indices32_.resize(face_count * 3);
-      if (fread(indices32_.data(), indices32_.size() * sizeof(uint32_t), 1, f)
-          != 1) {
+      if (!f.Read(indices32_.data(), indices32_.size() * sizeof(uint32_t))) {
         throw Exception("Read failed for " + file_name_full_);
       }
       break;
@@ -94,15 +129,19 @@ void ModelData::DoPreload() {
       throw Exception();
   }
 
-  fclose(f);
-
 #endif  // BA_HEADLESS_BUILD
 }
 
 void ModelData::DoLoad() {
   assert(!renderer_data_.exists());
+  if (lod_count_ > 0) {
+    CalcBounds();
+  }
   renderer_data_ = Object::MakeRefCounted(
       g_graphics_server->renderer()->NewModelData(*this));
+  renderer_data_->set_memory_size(
+      GetVertexCount() * sizeof(VertexObjectFull)
+      + static_cast<size_t>(GetIndexCount()) * GetIndexSize());
 
   // once we're loaded lets free up our vert data memory
   std::vector<VertexObjectFull>().swap(vertices_);
@@ -111,6 +150,104 @@ void ModelData::DoLoad() {
   std::vector<uint32_t>().swap(indices32_);
 }
 
+void ModelData::CalcBounds() {
+  // Box center and the farthest vertex from it; not the tightest sphere
+  // but plenty for estimating screen size.
+  uint32_t vertex_count = GetVertexCount();
+  const VertexObjectFull* vertices = GetVertexData();
+  if (vertex_count == 0) {
+    return;
+  }
+  Vector3f min{vertices[0].position};
+  Vector3f max{min};
+  for (uint32_t i = 1; i < vertex_count; i++) {
+    const float* p = vertices[i].position;
+    min.x = std::min(min.x, p[0]);
+    min.y = std::min(min.y, p[1]);
+    min.z = std::min(min.z, p[2]);
+    max.x = std::max(max.x, p[0]);
+    max.y = std::max(max.y, p[1]);
+    max.z = std::max(max.z, p[2]);
+  }
+  bounds_center_ = (min + max) * 0.5f;
+  float radius_squared{};
+  for (uint32_t i = 0; i < vertex_count; i++) {
+    Vector3f offset = Vector3f(vertices[i].position) - bounds_center_;
+    radius_squared = std::max(radius_squared, offset.LengthSquared());
+  }
+  bounds_radius_ = sqrtf(radius_squared);
+}
+
+// The start of our .bob header (lod bobs follow this with their lod
+// counts); a 16 byte prefix which also keeps archived vertex data aligned.
+struct BobHeader {
+  uint32_t version;
+  uint32_t mesh_format;
+  uint32_t vertex_count;
+  uint32_t face_count;
+};
+
+auto ModelData::GetArchivedData() const -> const char* {
+  const char* data;
+  size_t size;
+  if (vertices_.empty()
+      && g_media->FindArchivedFile(file_name_full_, &data, &size)
+      && size >= sizeof(BobHeader)) {
+    return data;
+  }
+  return nullptr;
+}
+
+auto ModelData::GetVertexCount() const -> uint32_t {
+  if (const char* data = GetArchivedData()) {
+    BobHeader header{};
+    memcpy(&header, data, sizeof(header));
+    return header.vertex_count;
+  }
+  return static_cast<uint32_t>(vertices_.size());
+}
+
+auto ModelData::GetVertexData() const -> const VertexObjectFull* {
+  if (const char* data = GetArchivedData()) {
+    return reinterpret_cast<const VertexObjectFull*>(data + header_size_);
+  }
+  return vertices_.data();
+}
+
+auto ModelData::GetIndexCount() const -> uint32_t {
+  if (GetArchivedData()) {
+    return lod_index_offsets_[lod_count_] + lod_index_counts_[lod_count_];
+  }
+  switch (format_) {
+    case MeshFormat::kUV16N8Index8:
+      return static_cast<uint32_t>(indices8_.size());
+    case MeshFormat::kUV16N8Index16:
+      return static_cast<uint32_t>(indices16_.size());
+    case MeshFormat::kUV16N8Index32:
+      return static_cast<uint32_t>(indices32_.size());
+    default:
+      return 0;
+  }
+}
+
+auto ModelData::GetIndexData() const -> const void* {
+  if (const char* data = GetArchivedData()) {
+    BobHeader header{};
+    memcpy(&header, data, sizeof(header));
+    return data + header_size_ + header.vertex_count * sizeof(VertexObjectFull);
+  }
+  switch (format_) {
+    case MeshFormat::kUV16N8Index8:
+      return indices8_.data();
+    case MeshFormat::kUV16N8Index16:
+      return indices16_.data();
+    case MeshFormat::kUV16N8Index32:
+      return indices32_.data();
+    default:
+      return nullptr;
+  }
+}
+
 void ModelData::DoUnload() {
   assert(valid_);
   assert(renderer_data_.exists());
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "ballistica/math/vector3f.h"
 #include "ballistica/media/data/media_component_data.h"
 #include "ballistica/media/data/model_renderer_data.h"
 
@@ -30,12 +31,48 @@ class ModelData : public MediaComponentData {
     assert(renderer_data_.exists());
     return renderer_data_.get();
   }
+
+  // Bytes held by the renderer for us (0 if not loaded). The component
+  // should be locked when calling this from outside the graphics thread.
+  auto memory_size() const -> size_t {
+    return renderer_data_.exists() ? renderer_data_->memory_size() : 0;
+  }
+
+  // The data for the renderer to upload; only valid until DoLoad()
+  // completes. Models in a media archive point straight into its mapping
+  // rather than being copied in DoPreload(); nothing reads model vertices
+  // on the cpu so there's no reason for us to hold our own copy.
+  auto GetVertexCount() const -> uint32_t;
+  auto GetVertexData() const -> const VertexObjectFull*;
+  auto GetIndexCount() const -> uint32_t;
+  auto GetIndexData() const -> const void*;
+
   auto vertices() const -> const std::vector<VertexObjectFull>& {
     return vertices_;
   }
   auto indices8() const -> const std::vector<uint8_t>& { return indices8_; }
   auto indices16() const -> const std::vector<uint16_t>& { return indices16_; }
   auto indices32() const -> const std::vector<uint32_t>& { return indices32_; }
+  // Models from the asset pipeline can carry up to kMaxLODs reduced-detail
+  // versions of themselves; these share the full model's vertices and just
+  // have their own runs of indices following its own in the index data.
+  // Level 0 is the full model.
+  static const int kMaxLODs = 3;
+  auto lod_count() const -> int { return lod_count_; }
+  auto GetLODIndexOffset(int level) const -> uint32_t {
+    assert(level >= 0 && level <= lod_count_);
+    return lod_index_offsets_[level];
+  }
+  auto GetLODIndexCount(int level) const -> uint32_t {
+    assert(level >= 0 && level <= lod_count_);
+    return lod_index_counts_[level];
+  }
+
+  // Bounding sphere in model space for picking lods (only calculated for
+  // models that have them).
+  auto bounds_center() const -> const Vector3f& { return bounds_center_; }
+  auto bounds_radius() const -> float { return bounds_radius_; }
+
   auto GetIndexSize() const -> int {
     switch (format_) {
       case MeshFormat::kUV16N8Index8:
@@ -50,10 +87,20 @@ class ModelData : public MediaComponentData {
   }
 
  private:
+  // Our .bob file's contents when it lives in an archive (else nullptr).
+  auto GetArchivedData() const -> const char*;
+  void CalcBounds();
+
   Object::Ref<ModelRendererData> renderer_data_;
   std::string file_name_;
   std::string file_name_full_;
   MeshFormat format_{};
+  uint32_t header_size_{};
+  int lod_count_{};
+  uint32_t lod_index_offsets_[kMaxLODs + 1]{};
+  uint32_t lod_index_counts_[kMaxLODs + 1]{};
+  Vector3f bounds_center_{0.0f, 0.0f, 0.0f};
+  float bounds_radius_{};
   std::vector<VertexObjectFull> vertices_;
   std::vector<uint8_t> indices8_;
   std::vector<uint16_t> indices16_;
@@ -3,6 +3,8 @@
 #ifndef BALLISTICA_MEDIA_DATA_MODEL_RENDERER_DATA_H_
 #define BALLISTICA_MEDIA_DATA_MODEL_RENDERER_DATA_H_
 
+#include <atomic>
+
 #include "ballistica/core/object.h"
 
 namespace ballistica {
@@ -14,6 +16,13 @@ class ModelRendererData : public Object {
   auto GetDefaultOwnerThread() const -> ThreadIdentifier override {
     return ThreadIdentifier::kMain;
   }
+
+  // Bytes of vertex/index data handed over to the renderer.
+  auto memory_size() const -> size_t { return memory_size_; }
+  void set_memory_size(size_t val) { memory_size_ = val; }
+
+ private:
+  std::atomic<size_t> memory_size_{};
 };
 
 }  // namespace ballistica
@@ -25,6 +25,10 @@ namespace ballistica {
 
 const int kReadBufferSize = 32768;  // 32 KB buffers
 
+// Sounds that would decode to more than this stay compressed and get
+// streamed instead (announcer lines and the like).
+const size_t kMaxDecodedSoundSize = 256 * 1024;
+
 static auto CallbackRead(void* ptr, size_t size, size_t nmemb,
                          void* data_source) -> size_t {
   return fread(ptr, size, nmemb, static_cast<FILE*>(data_source));
@@ -151,6 +155,57 @@ static auto LoadOgg(const char* file_name, std::vector<char>* buffer,
   return !fallback;
 }
 
+// Get the decoded size and duration of an ogg file without decoding it.
+// Returns false if the file can't be read as an ogg.
+static auto GetOggDecodedSize(const char* file_name, size_t* size,
+                              millisecs_t* duration) -> bool {
+  FILE* f = g_platform->FOpen(file_name, "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  OggVorbis_File ogg_file;
+  ov_callbacks callbacks;
+  callbacks.read_func = CallbackRead;
+  callbacks.seek_func = CallbackSeek;
+  callbacks.close_func = CallbackClose;
+  callbacks.tell_func = CallbackTell;
+  if (ov_open_callbacks(f, &ogg_file, nullptr, 0, callbacks) != 0) {
+    fclose(f);
+    return false;
+  }
+  vorbis_info* p_info = ov_info(&ogg_file, -1);
+  ogg_int64_t frames = ov_pcm_total(&ogg_file, -1);
+  bool success = (p_info != nullptr && frames > 0 && p_info->rate > 0);
+  if (success) {
+    // (We always decode to 16 bit mono or stereo).
+    int frame_size = p_info->channels == 1 ? 2 : 4;
+    *size = static_cast<size_t>(frames) * frame_size;
+    *duration = static_cast<millisecs_t>(frames * 1000 / p_info->rate);
+  }
+  ov_clear(&ogg_file);
+  return success;
+}
+
+static auto LoadCompressedOgg(const char* file_name)
+    -> std::shared_ptr<const std::vector<char>> {
+  FILE* f = g_platform->FOpen(file_name, "rb");
+  if (f == nullptr) {
+    return {};
+  }
+  auto data = std::make_shared<std::vector<char>>();
+  char array[kReadBufferSize];
+  size_t bytes;
+  while ((bytes = fread(array, 1, sizeof(array), f)) > 0) {
+    data->insert(data->end(), array, array + bytes);
+  }
+  bool error = ferror(f) != 0;
+  fclose(f);
+  if (error || data->empty()) {
+    return {};
+  }
+  return data;
+}
+
 static void LoadCachedOgg(const char* file_name, std::vector<char>* buffer,
                           ALenum* format, ALsizei* freq) {
   std::string sound_cache_dir =
@@ -261,8 +316,22 @@ void SoundData::DoPreload() {
   if (strstr(file_name_full_.c_str(), "Music.ogg")) {
     is_streamed_ = true;
   } else if (strstr(file_name_full_.c_str(), ".ogg")) {
-    is_streamed_ = false;
-    LoadCachedOgg(file_name_full_.c_str(), &load_buffer_, &format_, &freq_);
+    // Long sounds get held compressed and streamed instead (if anything
+    // goes wrong here we just go the regular route which knows how to
+    // fall back gracefully).
+    size_t decoded_size{};
+    millisecs_t duration{};
+    if (GetOggDecodedSize(file_name_full_.c_str(), &decoded_size, &duration)
+        && decoded_size > kMaxDecodedSoundSize) {
+      compressed_data_ = LoadCompressedOgg(file_name_full_.c_str());
+    }
+    if (compressed_data_) {
+      is_streamed_ = true;
+      duration_ = duration;
+    } else {
+      is_streamed_ = false;
+      LoadCachedOgg(file_name_full_.c_str(), &load_buffer_, &format_, &freq_);
+    }
   } else {
     throw Exception("Unsupported sound file (needs to end in .ogg): '"
                     + file_name_full_ + "'");
@@ -271,14 +340,16 @@ void SoundData::DoPreload() {
 }
 
 void SoundData::DoLoad() {
-  assert(InAudioThread());
   assert(valid_);
 
 #if BA_ENABLE_AUDIO
+  assert(InAudioThread());
   assert(!g_audio_server->paused());
 
   // Note: streamed sources create buffers as they're used; not here.
-  if (!is_streamed_) {
+  if (is_streamed_) {
+    memory_size_ = compressed_data_ ? compressed_data_->size() : 0;
+  } else {
     // Generate our buffer.
     CHECK_AL_ERROR;
     alGenBuffers(1, &buffer_);
@@ -287,6 +358,14 @@ void SoundData::DoLoad() {
     // Preload pulled data into our load-buffer, and send that along to openal.
     alBufferData(buffer_, format_, &load_buffer_[0],
                  static_cast<ALsizei>(load_buffer_.size()), freq_);
+    memory_size_ = load_buffer_.size();
+
+    // (We only ever load 16 bit mono or stereo).
+    int frame_size = format_ == AL_FORMAT_STEREO16 ? 4 : 2;
+    if (freq_ > 0) {
+      duration_ = static_cast<millisecs_t>(load_buffer_.size()) * 1000
+                  / (frame_size * freq_);
+    }
 
     CHECK_AL_ERROR;
 
@@ -300,8 +379,8 @@ void SoundData::DoLoad() {
 
 void SoundData::DoUnload() {
   assert(valid_);
-  assert(InAudioThread());
 #if BA_ENABLE_AUDIO
+  assert(InAudioThread());
   if (!is_streamed_) {
     assert(buffer_);
     CHECK_AL_ERROR;
@@ -309,6 +388,10 @@ void SoundData::DoUnload() {
     CHECK_AL_ERROR;
   }
 #endif  // BA_ENABLE_AUDIO
+
+  // (Anything still streaming this keeps its own reference).
+  compressed_data_.reset();
+  memory_size_ = 0;
 }
 
 }  // namespace ballistica
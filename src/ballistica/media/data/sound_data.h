@@ -3,6 +3,8 @@
 #ifndef BALLISTICA_MEDIA_DATA_SOUND_DATA_H_
 #define BALLISTICA_MEDIA_DATA_SOUND_DATA_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,11 +37,25 @@ class SoundData : public MediaComponentData {
   }
 #endif  // BA_ENABLE_AUDIO
   auto is_streamed() const -> bool { return is_streamed_; }
+
+  /// Long sounds are kept ogg-compressed in memory and streamed when
+  /// played instead of being decoded up front. This is their data.
+  auto compressed_data() const
+      -> const std::shared_ptr<const std::vector<char>>& {
+    return compressed_data_;
+  }
   auto file_name() const -> const std::string& { return file_name_; }
   auto file_name_full() const -> const std::string& { return file_name_full_; }
   void UpdatePlayTime() { last_play_time_ = GetRealTime(); }
   auto last_play_time() const -> millisecs_t { return last_play_time_; }
 
+  // Bytes of sample data handed to the audio system (or compressed data
+  // we're holding on to).
+  auto memory_size() const -> size_t { return memory_size_; }
+
+  // Length at normal pitch once loaded (0 for music streams).
+  auto duration() const -> millisecs_t { return duration_; }
+
  private:
   std::string file_name_;
   std::string file_name_full_;
@@ -50,7 +66,10 @@ class SoundData : public MediaComponentData {
   ALsizei freq_{};
 #endif  // BA_ENABLE_AUDIO
   std::vector<char> load_buffer_;
+  std::shared_ptr<const std::vector<char>> compressed_data_;
   millisecs_t last_play_time_{};
+  std::atomic<size_t> memory_size_{};
+  millisecs_t duration_{};
 };
 
 }  // namespace ballistica
@@ -2,6 +2,8 @@
 
 #include "ballistica/media/data/texture_data.h"
 
+#include <mutex>
+
 #include "ballistica/graphics/graphics.h"
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/graphics/renderer.h"
@@ -39,6 +41,65 @@ static void rgba8888_unpremultiply_in_place(void* src, size_t cb) {
   }
 }
 
+// How many levels above its base a preload could drop, given the data it
+// actually has (uncompressed formats only carry their base level and build
+// the rest on the GPU). We don't shrink past 32 pixels; there's nothing to
+// gain from it.
+static auto GetMipBiasLimit(const TexturePreloadData& data) -> int {
+  int limit = 0;
+  for (int level = data.base_level + 1; level < kMaxTextureLevels; level++) {
+    if (data.buffers[level] == nullptr || data.widths[level] < 32
+        || data.heights[level] < 32) {
+      break;
+    }
+    limit++;
+  }
+  return limit;
+}
+
+// Estimate what a preload will take up on the GPU once uploaded.
+static auto GetResidentSize(const TexturePreloadData& data) -> size_t {
+  int base = data.base_level;
+  switch (data.formats[base]) {
+    case TextureFormat::kNone:
+      return 0;
+    case TextureFormat::kRGBA_8888:
+    case TextureFormat::kRGB_888:
+      return static_cast<size_t>(data.widths[base]) * data.heights[base] * 4
+             * 4 / 3;
+    case TextureFormat::kRGBA_4444:
+    case TextureFormat::kRGB_565:
+      return static_cast<size_t>(data.widths[base]) * data.heights[base] * 2
+             * 4 / 3;
+    default: {
+      size_t size = 0;
+      for (int i = base; i < kMaxTextureLevels && data.buffers[i]; i++) {
+        size += data.sizes[i];
+      }
+      return size;
+    }
+  }
+}
+
+// Whether loading a file could involve converting it to an uncompressed
+// format on this device (and so whether a conversion cache is worth
+// looking for).
+static auto MayNeedConversion(const std::string& file_name) -> bool {
+  size_t size = file_name.size();
+  if (size > 4 && !strcmp(file_name.c_str() + size - 4, ".dds")) {
+    // (Includes .android_dds).
+    return !g_graphics_server->SupportsTextureCompressionType(
+        TextureCompressionType::kS3TC);
+  }
+  if (size > 4 && !strcmp(file_name.c_str() + size - 4, ".ktx")) {
+    return !g_graphics_server->SupportsTextureCompressionType(
+               TextureCompressionType::kETC1)
+           || !g_graphics_server->SupportsTextureCompressionType(
+               TextureCompressionType::kETC2);
+  }
+  return false;
+}
+
 TextureData::TextureData() = default;
 TextureData::TextureData(const std::string& file_in, TextureType type_in,
                          TextureMinQuality min_quality_in)
@@ -104,6 +165,10 @@ void TextureData::DoPreload() {
     assert(!strings.empty());
     assert(strings.size() * 2 == positions.size());
 
+    // Platform text rendering isn't necessarily thread-safe and preloads
+    // can run on several threads at once.
+    static std::mutex text_texture_mutex;
+    std::lock_guard<std::mutex> text_lock(text_texture_mutex);
     void* tex_ref{g_platform->CreateTextTexture(
         width, height, strings, positions, visible_widths, scale)};
     uint8_t* pixels{g_platform->GetTextTextureData(tex_ref)};
@@ -176,10 +241,14 @@ void TextureData::DoPreload() {
       int file_name_size = static_cast<int>(file_name_full_.size());
       BA_PRECONDITION(file_name_size > 4);
 
-      // Etc1 or dxt3 for non-alpha and dxt5 for alpha (.android_dds files).
-      if (file_name_size > 12
-          && !strcmp(file_name_full_.c_str() + file_name_size - 12,
-                     ".android_dds")) {
+      if (MayNeedConversion(file_name_full_)
+          && preload_datas_[0].LoadConvertCache(file_name_full_,
+                                                GetConvertCacheKey())) {
+        // Converted on an earlier run; nothing more to do.
+      } else if (file_name_size > 12
+                 && !strcmp(file_name_full_.c_str() + file_name_size - 12,
+                            ".android_dds")) {
+        // Etc1 or dxt3 for non-alpha and dxt5 for alpha (.android_dds files).
 #if BA_ENABLE_OPENGL
         LoadDDS(file_name_full_, preload_datas_[0].buffers,
                 preload_datas_[0].widths, preload_datas_[0].heights,
@@ -201,7 +270,7 @@ void TextureData::DoPreload() {
                == TextureFormat::kDXT5)
               || (preload_datas_[0].formats[preload_datas_[0].base_level]
                   == TextureFormat::kDXT1)) {
-            preload_datas_[0].ConvertToUncompressed(this);
+            ConvertToUncompressed(&preload_datas_[0], file_name_full_);
           }
         }
       } else if (!strcmp(file_name_full_.c_str() + file_name_size - 4,
@@ -220,7 +289,7 @@ void TextureData::DoPreload() {
         // Decompress dxt1/dxt5 if we don't natively support it.
         if (!g_graphics_server->SupportsTextureCompressionType(
                 TextureCompressionType::kS3TC)) {
-          preload_datas_[0].ConvertToUncompressed(this);
+          ConvertToUncompressed(&preload_datas_[0], file_name_full_);
         }
       } else if (!strcmp(file_name_full_.c_str() + file_name_size - 4,
                          ".ktx")) {
@@ -247,7 +316,7 @@ void TextureData::DoPreload() {
                  == TextureFormat::kETC2_RGBA))
             && (!g_graphics_server->SupportsTextureCompressionType(
                 TextureCompressionType::kETC2))) {
-          preload_datas_[0].ConvertToUncompressed(this);
+          ConvertToUncompressed(&preload_datas_[0], file_name_full_);
         }
 
         // Decompress etc1 if we don't natively support it.
@@ -255,7 +324,7 @@ void TextureData::DoPreload() {
              == TextureFormat::kETC1)
             && (!g_graphics_server->SupportsTextureCompressionType(
                 TextureCompressionType::kETC1))) {
-          preload_datas_[0].ConvertToUncompressed(this);
+          ConvertToUncompressed(&preload_datas_[0], file_name_full_);
         }
 
       } else if (!strcmp(file_name_full_.c_str() + file_name_size - 4,
@@ -307,10 +376,14 @@ void TextureData::DoPreload() {
             throw Exception();
         }
 
-        // Etc1 or dxt3 for non-alpha and dxt5 for alpha (.android_dds files).
-        if (file_name_size > 12
-            && !strcmp(file_name_full_.c_str() + file_name_size - 12,
-                       ".android_dds")) {
+        if (MayNeedConversion(name)
+            && preload_datas_[d].LoadConvertCache(name,
+                                                  GetConvertCacheKey())) {
+          // Converted on an earlier run; nothing more to do.
+        } else if (file_name_size > 12
+                   && !strcmp(file_name_full_.c_str() + file_name_size - 12,
+                              ".android_dds")) {
+          // Etc1 or dxt3 for non-alpha and dxt5 for alpha (.android_dds).
           try {
 #if BA_ENABLE_OPENGL
             LoadDDS(name, preload_datas_[d].buffers, preload_datas_[d].widths,
@@ -337,7 +410,7 @@ void TextureData::DoPreload() {
                  == TextureFormat::kDXT5)
                 || (preload_datas_[d].formats[preload_datas_[d].base_level]
                     == TextureFormat::kDXT1)) {
-              preload_datas_[d].ConvertToUncompressed(this);
+              ConvertToUncompressed(&preload_datas_[d], name);
             }
           }
         } else if (!strcmp(file_name_full_.c_str() + file_name_size - 4,
@@ -356,7 +429,7 @@ void TextureData::DoPreload() {
           // Decompress dxt1/dxt5 if we don't natively support it.
           if (!g_graphics_server->SupportsTextureCompressionType(
                   TextureCompressionType::kS3TC)) {
-            preload_datas_[d].ConvertToUncompressed(this);
+            ConvertToUncompressed(&preload_datas_[d], name);
           }
         } else if (!strcmp(file_name_full_.c_str() + file_name_size - 4,
                            ".ktx")) {
@@ -378,7 +451,7 @@ void TextureData::DoPreload() {
                    == TextureFormat::kETC2_RGBA))
               && (!g_graphics_server->SupportsTextureCompressionType(
                   TextureCompressionType::kETC2))) {
-            preload_datas_[d].ConvertToUncompressed(this);
+            ConvertToUncompressed(&preload_datas_[d], name);
           }
 
           // Decompress etc1 if we don't natively support it.
@@ -386,7 +459,7 @@ void TextureData::DoPreload() {
                == TextureFormat::kETC1)
               && (!g_graphics_server->SupportsTextureCompressionType(
                   TextureCompressionType::kETC1))) {
-            preload_datas_[d].ConvertToUncompressed(this);
+            ConvertToUncompressed(&preload_datas_[d], name);
           }
 
         } else if (!strcmp(file_name_full_.c_str() + file_name_size - 4,
@@ -414,6 +487,27 @@ void TextureData::DoPreload() {
       throw Exception("unknown texture type");
     }
   }
+
+  // Skip any extra top levels we've been demoted by (file textures only;
+  // generated ones are small and single-level anyway).
+  if (!packer_.exists() && !is_qr_code_ && type_ == TextureType::k2D) {
+    TexturePreloadData* data = &preload_datas_[0];
+    int limit = GetMipBiasLimit(*data);
+    mip_bias_limit_ = limit;
+    data->base_level += std::min(static_cast<int>(mip_bias_), limit);
+  }
+}
+
+auto TextureData::GetConvertCacheKey() const -> int {
+  // These determine which level we end up converting.
+  return static_cast<int>(g_graphics_server->texture_quality()) * 16
+         + static_cast<int>(min_quality_);
+}
+
+void TextureData::ConvertToUncompressed(TexturePreloadData* data,
+                                        const std::string& file_name) {
+  data->ConvertToUncompressed(this);
+  data->WriteConvertCache(file_name, GetConvertCacheKey());
 }
 
 void TextureData::DoLoad() {
@@ -428,6 +522,11 @@ void TextureData::DoLoad() {
   // full quality.
   assert(!preload_datas_.empty());
   base_level_ = preload_datas_[0].base_level;
+  size_t resident_size = 0;
+  for (auto&& data : preload_datas_) {
+    resident_size += GetResidentSize(data);
+  }
+  resident_size_ = resident_size;
 
   // If we're done, kill our preload data.
   preload_datas_.clear();
@@ -439,6 +538,7 @@ void TextureData::DoUnload() {
   assert(renderer_data_.exists());
   renderer_data_.Clear();
   base_level_ = 0;
+  resident_size_ = 0;
 }
 
 }  // namespace ballistica
@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_MEDIA_DATA_TEXTURE_DATA_H_
 #define BALLISTICA_MEDIA_DATA_TEXTURE_DATA_H_
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -45,7 +46,24 @@ class TextureData : public MediaComponentData {
   }
   auto base_level() const -> int { return base_level_; }
 
+  // Extra top mip levels to skip on our next load; Media raises this for
+  // idle textures when over its texture memory budget.
+  auto mip_bias() const -> int { return mip_bias_; }
+  void set_mip_bias(int val) { mip_bias_ = val; }
+
+  // How far we could actually be demoted, as of our last preload.
+  auto mip_bias_limit() const -> int { return mip_bias_limit_; }
+
+  // Rough GPU bytes held for this texture while loaded (0 otherwise).
+  auto resident_size() const -> size_t { return resident_size_; }
+
  private:
+  // Convert a preload out of a compression type we don't support,
+  // caching the result so we can skip this next time.
+  void ConvertToUncompressed(TexturePreloadData* data,
+                             const std::string& file_name);
+  auto GetConvertCacheKey() const -> int;
+
   Object::Ref<TextPacker> packer_;
   bool is_qr_code_ = false;
   std::string file_name_;
@@ -55,6 +73,9 @@ class TextureData : public MediaComponentData {
   TextureMinQuality min_quality_ = TextureMinQuality::kLow;
   Object::Ref<TextureRendererData> renderer_data_;
   int base_level_ = 0;
+  std::atomic<int> mip_bias_{};
+  std::atomic<int> mip_bias_limit_{};
+  std::atomic<size_t> resident_size_{};
 };
 
 }  // namespace ballistica
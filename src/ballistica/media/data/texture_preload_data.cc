@@ -6,8 +6,12 @@
 #include <cstring>
 #endif
 
+#include "ballistica/graphics/graphics_server.h"
+#include "ballistica/graphics/texture/block_decode.h"
 #include "ballistica/graphics/texture/ktx.h"
 #include "ballistica/media/component/texture.h"
+#include "ballistica/media/media.h"
+#include "ballistica/platform/platform.h"
 
 namespace ballistica {
 
@@ -162,6 +166,43 @@ static auto PackRGBA(unsigned char r, unsigned char g, unsigned char b,
   return ((a << 24) | (b << 16) | (g << 8) | r);
 }
 
+// Expand a 565 color to 8 bit channels (matching the original rounding).
+static void Unpack565(uint16_t color, uint32_t* r, uint32_t* g, uint32_t* b) {
+  uint32_t temp;
+  temp = (color >> 11u) * 255u + 16u;
+  *r = (temp / 32u + temp) / 32u;
+  temp = ((color & 0x07E0u) >> 5u) * 255u + 32u;
+  *g = (temp / 64u + temp) / 64u;
+  temp = (color & 0x001Fu) * 255u + 16u;
+  *b = (temp / 32u + temp) / 32u;
+}
+
+// Build the 4 color palette for a DXT color block. Colors get the
+// provided alpha; three_color_mode_allowed enables DXT1's transparent
+// black mode (used when color0 <= color1).
+static void BuildDXTColorPalette(const uint8_t* block_storage,
+                                 bool three_color_mode_allowed,
+                                 unsigned char alpha, uint32_t palette[4]) {
+  uint16_t color0, color1;
+  memcpy(&color0, block_storage, sizeof(color0));
+  memcpy(&color1, block_storage + 2, sizeof(color1));
+  uint32_t r0, g0, b0, r1, g1, b1;
+  Unpack565(color0, &r0, &g0, &b0);
+  Unpack565(color1, &r1, &g1, &b1);
+  palette[0] = PackRGBA(r0, g0, b0, alpha);
+  palette[1] = PackRGBA(r1, g1, b1, alpha);
+  if (color0 > color1 || !three_color_mode_allowed) {
+    palette[2] = PackRGBA((2 * r0 + r1) / 3, (2 * g0 + g1) / 3,
+                          (2 * b0 + b1) / 3, alpha);
+    palette[3] = PackRGBA((r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3,
+                          (b0 + 2 * b1) / 3, alpha);
+  } else {
+    palette[2] =
+        PackRGBA((r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2, alpha);
+    palette[3] = PackRGBA(0, 0, 0, alpha);
+  }
+}
+
 // void DecompressBlockDXT1(): Decompresses one block of a DXT1 texture and
 // stores the resulting pixels at the appropriate offset in 'image'.
 //
@@ -175,81 +216,18 @@ static void DecompressBlockDXT1(uint32_t x, uint32_t y, uint32_t width,
                                 uint32_t height,
                                 const unsigned char* block_storage,
                                 uint32_t* image) {
-  uint16_t color0, color1;
-  memcpy(&color0, block_storage, sizeof(color0));
-  memcpy(&color1, block_storage + 2, sizeof(color1));
-
-  uint32_t temp;
-
-  temp = (color0 >> 11u) * 255u + 16u;
-  auto r0 = (unsigned char)((temp / 32u + temp) / 32u);
-  temp = ((color0 & 0x07E0u) >> 5u) * 255u + 32u;
-  auto g0 = (unsigned char)((temp / 64u + temp) / 64u);
-  temp = (color0 & 0x001Fu) * 255u + 16u;
-  auto b0 = (unsigned char)((temp / 32 + temp) / 32);
-
-  temp = (color1 >> 11u) * 255u + 16u;
-  auto r1 = (unsigned char)((temp / 32u + temp) / 32u);
-  temp = ((color1 & 0x07E0u) >> 5u) * 255u + 32u;
-  auto g1 = (unsigned char)((temp / 64u + temp) / 64u);
-  temp = (color1 & 0x001Fu) * 255u + 16u;
-  auto b1 = (unsigned char)((temp / 32u + temp) / 32u);
-
-  uint32_t code = *reinterpret_cast<const uint32_t*>(block_storage + 4);
-
-  for (int j = 0; j < 4; j++) {
-    for (int i = 0; i < 4; i++) {
-      uint32_t final_color = 0;
-      auto positionCode =
-          static_cast<uint8_t>((code >> 2 * (4 * j + i)) & 0x03);
-
-      if (color0 > color1) {
-        switch (positionCode) {
-          case 0:
-            final_color = PackRGBA(r0, g0, b0, 255);
-            break;
-          case 1:
-            final_color = PackRGBA(r1, g1, b1, 255);
-            break;
-          case 2:
-            final_color =
-                PackRGBA(static_cast<uint8_t>((2 * r0 + r1) / 3),
-                         static_cast<uint8_t>((2 * g0 + g1) / 3),
-                         static_cast<uint8_t>((2 * b0 + b1) / 3), 255);
-            break;
-          case 3:
-            final_color =
-                PackRGBA(static_cast<uint8_t>((r0 + 2 * r1) / 3),
-                         static_cast<uint8_t>((g0 + 2 * g1) / 3),
-                         static_cast<uint8_t>((b0 + 2 * b1) / 3), 255);
-            break;
-          default:
-            break;
-        }
-      } else {
-        switch (positionCode) {
-          case 0:
-            final_color = PackRGBA(r0, g0, b0, 255);
-            break;
-          case 1:
-            final_color = PackRGBA(r1, g1, b1, 255);
-            break;
-          case 2:
-            final_color = PackRGBA(static_cast<uint8_t>((r0 + r1) / 2),
-                                   static_cast<uint8_t>((g0 + g1) / 2),
-                                   static_cast<uint8_t>((b0 + b1) / 2), 255);
-            break;
-          case 3:
-            final_color = PackRGBA(0, 0, 0, 255);
-            break;
-          default:
-            break;
-        }
-      }
-      if ((x + i < width) && (y + j < height)) {
-        image[(y + j) * width + (x + i)] = final_color;
-      }
-    }
+  uint32_t palette[4];
+  BuildDXTColorPalette(block_storage, true, 255, palette);
+  uint32_t code;
+  memcpy(&code, block_storage + 4, sizeof(code));
+
+  // Interior blocks can go straight to the image.
+  if (x + 4 <= width && y + 4 <= height) {
+    ExpandBlockPalette(palette, code, image + y * width + x, width);
+  } else {
+    uint32_t block[16];
+    ExpandBlockPalette(palette, code, block, 4);
+    StoreBlock(block, x, y, width, height, image);
   }
 }
 
@@ -267,16 +245,16 @@ static void BlockDecompressImageDXT1(uint32_t width, uint32_t height,
                                      uint32_t* image) {
   uint32_t block_count_x = (width + 3) / 4;
   uint32_t block_count_y = (height + 3) / 4;
-  // uint32_t blockWidth = (width < 4) ? width : 4;
-  // uint32_t blockHeight = (height < 4) ? height : 4;
-
-  for (uint32_t j = 0; j < block_count_y; j++) {
-    for (uint32_t i = 0; i < block_count_x; i++) {
-      DecompressBlockDXT1(i * 4, j * 4, width, height, block_storage + i * 8,
-                          image);
-    }
-    block_storage += block_count_x * 8;
-  }
+  ForEachBlockRowRange(
+      block_count_y, block_count_x, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t j = begin; j < end; j++) {
+          const unsigned char* row = block_storage + j * block_count_x * 8;
+          for (uint32_t i = 0; i < block_count_x; i++) {
+            DecompressBlockDXT1(i * 4, j * 4, width, height, row + i * 8,
+                                image);
+          }
+        }
+      });
 }
 
 // void DecompressBlockDXT5(): Decompresses one block of a DXT5 texture and
@@ -292,103 +270,41 @@ static void BlockDecompressImageDXT1(uint32_t width, uint32_t height,
 static void DecompressBlockDXT5(uint32_t x, uint32_t y, uint32_t width,
                                 uint32_t height, const uint8_t* block_storage,
                                 uint32_t* image) {
-  uint8_t alpha0 = *block_storage;
-  uint8_t alpha1 = *(block_storage + 1);
-
-  const uint8_t* bits = block_storage + 2;
-  uint32_t alpha_code_1 =
-      bits[2] | (bits[3] << 8) | (bits[4] << 16) | (bits[5] << 24);
-  uint16_t alpha_code_2 = bits[0] | (bits[1] << 8);
-
-  uint16_t color0, color1;
-  memcpy(&color0, block_storage + 8, sizeof(color0));
-  memcpy(&color1, block_storage + 10, sizeof(color1));
-
-  uint32_t temp;
-
-  temp = (color0 >> 11u) * 255u + 16u;
-  auto r0 = (uint8_t)((temp / 32u + temp) / 32u);
-  temp = ((color0 & 0x07E0u) >> 5u) * 255u + 32u;
-  auto g0 = (uint8_t)((temp / 64u + temp) / 64u);
-  temp = (color0 & 0x001Fu) * 255u + 16u;
-  auto b0 = (uint8_t)((temp / 32u + temp) / 32u);
-
-  temp = (color1 >> 11u) * 255u + 16u;
-  auto r1 = (uint8_t)((temp / 32u + temp) / 32u);
-  temp = ((color1 & 0x07E0u) >> 5u) * 255u + 32u;
-  auto g1 = (uint8_t)((temp / 64u + temp) / 64u);
-  temp = (color1 & 0x001Fu) * 255u + 16u;
-  auto b1 = (uint8_t)((temp / 32u + temp) / 32u);
-
-  uint32_t code = *reinterpret_cast<const uint32_t*>(block_storage + 12);
-
-  for (int j = 0; j < 4; j++) {
-    for (int i = 0; i < 4; i++) {
-      int alpha_code_index = 3 * (4 * j + i);
-      int alpha_code;
-
-      if (alpha_code_index <= 12) {
-        alpha_code = (alpha_code_2 >> alpha_code_index) & 0x07;
-      } else if (alpha_code_index == 15) {
-        // NOLINTNEXTLINE
-        alpha_code = (alpha_code_2 >> 15) | ((alpha_code_1 << 1) & 0x06);
-      } else {
-        // NOLINTNEXTLINE
-        alpha_code = (alpha_code_1 >> (alpha_code_index - 16)) & 0x07;
-      }
+  uint32_t alpha0 = block_storage[0];
+  uint32_t alpha1 = block_storage[1];
+  uint32_t alphas[8];
+  alphas[0] = alpha0;
+  alphas[1] = alpha1;
+  if (alpha0 > alpha1) {
+    for (uint32_t c = 2; c < 8; c++) {
+      alphas[c] = ((8 - c) * alpha0 + (c - 1) * alpha1) / 7;
+    }
+  } else {
+    for (uint32_t c = 2; c < 6; c++) {
+      alphas[c] = ((6 - c) * alpha0 + (c - 1) * alpha1) / 5;
+    }
+    alphas[6] = 0;
+    alphas[7] = 255;
+  }
 
-      uint8_t final_alpha;
-      if (alpha_code == 0) {
-        final_alpha = alpha0;
-      } else if (alpha_code == 1) {
-        final_alpha = alpha1;
-      } else {
-        if (alpha0 > alpha1) {
-          final_alpha = static_cast<uint8_t>(
-              ((8 - alpha_code) * alpha0 + (alpha_code - 1) * alpha1) / 7);
-        } else {
-          if (alpha_code == 6) {
-            final_alpha = 0;
-          } else if (alpha_code == 7) {
-            final_alpha = 255;
-          } else {
-            final_alpha = static_cast<uint8_t>(
-                ((6 - alpha_code) * alpha0 + (alpha_code - 1) * alpha1) / 5);
-          }
-        }
-      }
+  // 48 bits of 3 bit alpha indices, pixel 0 in the low bits.
+  uint64_t alpha_codes = 0;
+  for (int b = 5; b >= 0; b--) {
+    alpha_codes = (alpha_codes << 8) | block_storage[2 + b];
+  }
 
-      auto colorCode = static_cast<uint8_t>((code >> 2 * (4 * j + i)) & 0x03);
-
-      uint32_t final_color = 0;
-      switch (colorCode) {
-        case 0:
-          final_color = PackRGBA(r0, g0, b0, final_alpha);
-          break;
-        case 1:
-          final_color = PackRGBA(r1, g1, b1, final_alpha);
-          break;
-        case 2:
-          final_color =
-              PackRGBA(static_cast<uint8_t>((2 * r0 + r1) / 3),
-                       static_cast<uint8_t>((2 * g0 + g1) / 3),
-                       static_cast<uint8_t>((2 * b0 + b1) / 3), final_alpha);
-          break;
-        case 3:
-          final_color =
-              PackRGBA(static_cast<uint8_t>((r0 + 2 * r1) / 3),
-                       static_cast<uint8_t>((g0 + 2 * g1) / 3),
-                       static_cast<uint8_t>((b0 + 2 * b1) / 3), final_alpha);
-          break;
-        default:
-          break;
-      }
+  uint32_t palette[4];
+  BuildDXTColorPalette(block_storage + 8, false, 0, palette);
+  uint32_t code;
+  memcpy(&code, block_storage + 12, sizeof(code));
 
-      if ((x + i < width) && (y + j < height)) {
-        image[(y + j) * width + (x + i)] = final_color;
-      }
-    }
+  uint32_t block[16];
+  ExpandBlockPalette(palette, code, block, 4);
+  for (auto& pixel : block) {
+    pixel |= alphas[alpha_codes & 0x07] << 24;
+    alpha_codes >>= 3;
   }
+  StoreBlock(block, x, y, width, height, image);
 }
 
 static void BlockDecompressImageDXT5(uint32_t width, uint32_t height,
@@ -396,12 +312,16 @@ static void BlockDecompressImageDXT5(uint32_t width, uint32_t height,
                                      uint32_t* image) {
   uint32_t block_count_x = (width + 3) / 4;
   uint32_t block_count_y = (height + 3) / 4;
-  for (uint32_t j = 0; j < block_count_y; j++) {
-    for (uint32_t i = 0; i < block_count_x; i++)
-      DecompressBlockDXT5(i * 4, j * 4, width, height, block_storage + i * 16,
-                          image);
-    block_storage += block_count_x * 16;
-  }
+  ForEachBlockRowRange(
+      block_count_y, block_count_x, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t j = begin; j < end; j++) {
+          const uint8_t* row = block_storage + j * block_count_x * 16;
+          for (uint32_t i = 0; i < block_count_x; i++) {
+            DecompressBlockDXT5(i * 4, j * 4, width, height, row + i * 16,
+                                image);
+          }
+        }
+      });
 }
 
 void TexturePreloadData::ConvertToUncompressed(TextureData* texture) {
@@ -565,6 +485,151 @@ void TexturePreloadData::ConvertToUncompressed(TextureData* texture) {
   }
 }
 
+// Bump this if the conversion itself changes.
+const uint32_t kConvertCacheVersion = 1;
+
+static auto GetConvertCacheFileName(const std::string& file_name,
+                                    int quality_key) -> std::string {
+  std::string cache_dir = g_platform->GetConfigDirectory() + "/texturecache";
+
+  // (Preloads can run on several threads; statics init safely).
+  static bool made_cache_dir = (g_platform->MakeDir(cache_dir), true);
+  assert(made_cache_dir);
+  std::string name = file_name;
+  for (auto&& c : name) {
+    if (c == '/') {
+      c = '_';
+    }
+  }
+  return cache_dir + "/" + name + "_" + std::to_string(quality_key)
+         + ".cache";
+}
+
+// A cache is only good on a device lacking the same compression types.
+static auto GetCompressionSupportMask() -> uint32_t {
+  uint32_t mask = 0;
+  for (auto t : {TextureCompressionType::kS3TC, TextureCompressionType::kPVR,
+                 TextureCompressionType::kETC1,
+                 TextureCompressionType::kETC2}) {
+    if (g_graphics_server->SupportsTextureCompressionType(t)) {
+      mask |= 0x01u << static_cast<uint32_t>(t);
+    }
+  }
+  return mask;
+}
+
+static auto GetUncompressedSize(TextureFormat format, int width, int height)
+    -> size_t {
+  size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+  switch (format) {
+    case TextureFormat::kRGBA_8888:
+      return pixels * 4;
+    case TextureFormat::kRGB_888:
+      return pixels * 3;
+    case TextureFormat::kRGBA_4444:
+    case TextureFormat::kRGB_565:
+      return pixels * 2;
+    default:
+      return 0;
+  }
+}
+
+// Fixed layout at the head of each cache file; followed by the pixels.
+struct ConvertCacheHeader {
+  uint32_t version;
+  uint32_t compression_mask;
+  int64_t source_mod_time;
+  int32_t level;
+  int32_t format;
+  int32_t width;
+  int32_t height;
+};
+
+auto TexturePreloadData::LoadConvertCache(const std::string& file_name,
+                                          int quality_key) -> bool {
+  time_t mod_time = g_media->GetMediaFileModTime(file_name);
+  if (mod_time == 0) {
+    return false;
+  }
+  FILE* f = g_platform->FOpen(
+      GetConvertCacheFileName(file_name, quality_key).c_str(), "rb");
+  if (!f) {
+    return false;
+  }
+  bool success = false;
+  ConvertCacheHeader header{};
+  if (fread(&header, sizeof(header), 1, f) == 1
+      && header.version == kConvertCacheVersion
+      && header.compression_mask == GetCompressionSupportMask()
+      && header.source_mod_time == static_cast<int64_t>(mod_time)
+      && header.level >= 0 && header.level < kMaxTextureLevels) {
+    auto format = static_cast<TextureFormat>(header.format);
+    size_t size = GetUncompressedSize(format, header.width, header.height);
+    if (size > 0) {
+      auto* buffer = static_cast<uint8_t*>(malloc(size));
+      BA_PRECONDITION(buffer);
+      if (fread(buffer, size, 1, f) == 1) {
+        int level = header.level;
+        buffers[level] = buffer;
+        sizes[level] = size;
+        formats[level] = format;
+        widths[level] = header.width;
+        heights[level] = header.height;
+        base_level = level;
+        success = true;
+      } else {
+        free(buffer);
+      }
+    }
+  }
+  fclose(f);
+  return success;
+}
+
+void TexturePreloadData::WriteConvertCache(const std::string& file_name,
+                                           int quality_key) const {
+  time_t mod_time = g_media->GetMediaFileModTime(file_name);
+  if (mod_time == 0) {
+    return;
+  }
+
+  // ConvertToUncompressed only converts (and we only keep) the first
+  // populated level.
+  int level = 0;
+  while (level < kMaxTextureLevels && formats[level] == TextureFormat::kNone) {
+    level++;
+  }
+  if (level == kMaxTextureLevels || !buffers[level]) {
+    return;
+  }
+  size_t size = GetUncompressedSize(formats[level], widths[level],
+                                    heights[level]);
+  if (size == 0) {
+    return;
+  }
+  ConvertCacheHeader header{};
+  header.version = kConvertCacheVersion;
+  header.compression_mask = GetCompressionSupportMask();
+  header.source_mod_time = static_cast<int64_t>(mod_time);
+  header.level = level;
+  header.format = static_cast<int32_t>(formats[level]);
+  header.width = widths[level];
+  header.height = heights[level];
+
+  std::string cache_file_name = GetConvertCacheFileName(file_name, quality_key);
+  FILE* f = g_platform->FOpen(cache_file_name.c_str(), "wb");
+  if (f) {
+    bool success = fwrite(&header, sizeof(header), 1, f) == 1
+                   && fwrite(buffers[level], size, 1, f) == 1;
+    fclose(f);
+
+    // Attempt to clean up if it looks like something went wrong.
+    if (!success) {
+      g_platform->Unlink(cache_file_name.c_str());
+    }
+  }
+}
+
 TexturePreloadData::~TexturePreloadData() {
   for (auto& buffer : buffers) {
     if (buffer) {
@@ -27,6 +27,14 @@ class TexturePreloadData {
   ~TexturePreloadData();
   void ConvertToUncompressed(TextureData* texture);
 
+  // Devices lacking a compression type would otherwise redo the above
+  // on every load, so results get cached on disk. Load returns true if
+  // there is a cache for this file (converted with this quality key on a
+  // device with the same compression support) and its data was read in.
+  auto LoadConvertCache(const std::string& file_name, int quality_key)
+      -> bool;
+  void WriteConvertCache(const std::string& file_name, int quality_key) const;
+
   uint8_t* buffers[kMaxTextureLevels]{};
   size_t sizes[kMaxTextureLevels]{};
   TextureFormat formats[kMaxTextureLevels]{};
@@ -6,7 +6,11 @@
 #include <sys/stat.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
+
 #include "ballistica/audio/audio_server.h"
+#include "ballistica/core/memory_stats.h"
 #include "ballistica/game/game.h"
 #include "ballistica/generic/timer.h"
 #include "ballistica/graphics/graphics_server.h"
@@ -15,7 +19,10 @@
 #include "ballistica/media/component/data.h"
 #include "ballistica/media/component/model.h"
 #include "ballistica/media/component/texture.h"
+#include "ballistica/media/data/model_data.h"
 #include "ballistica/media/data/sound_data.h"
+#include "ballistica/media/data/texture_preload_data.h"
+#include "ballistica/media/media_archive.h"
 #include "ballistica/media/media_server.h"
 #include "ballistica/python/python_sys.h"
 
@@ -32,11 +39,83 @@ namespace ballistica {
 // seconds.
 #define TEXT_TEXTURE_PRUNE_TIME 10000
 
+// Texture residency: a texture counts as idle (and can be demoted) after
+// this long without being drawn, and as in-use (and can be promoted back)
+// if drawn within the last second. We demote a couple of levels at most.
+const millisecs_t kTextureIdleTime = 10000;
+const millisecs_t kTextureActiveTime = 1000;
+const int kMaxTextureMipBias = 2;
+
 #define QR_TEXTURE_PRUNE_TIME 10000
 
 // How long we should spend loading media in each runPendingLoads() call.
 #define PENDING_LOAD_PROCESS_TIME 5
 
+// Roughly how much data we upload to the GPU per RunPendingGraphicsLoads()
+// call (we always do at least one component to keep things moving).
+const size_t kPendingGraphicsLoadBytes = 4 * 1024 * 1024;
+
+// Don't budget-evict anything used very recently; it'd likely just come
+// right back.
+const millisecs_t kMinMemoryEvictIdleTime = 5000;
+
+// Budget eviction is incremental so a big overage doesn't hitch one prune.
+const int kMaxMemoryEvictionsPerPrune = 8;
+
+// Estimated bytes a loaded component is holding.
+static auto GetMediaMemorySize(MediaComponentData* c) -> size_t {
+  if (!c->loaded()) {
+    return 0;
+  }
+  switch (c->GetMediaType()) {
+    case MediaType::kTexture:
+      return static_cast<TextureData*>(c)->resident_size();
+    case MediaType::kModel: {
+      // Renderer data comes and goes in the graphics thread.
+      if (!c->TryLock()) {
+        return 0;
+      }
+      MediaComponentData::LockGuard lock(
+          c, MediaComponentData::LockGuard::kInheritLock);
+      return static_cast<ModelData*>(c)->memory_size();
+    }
+    case MediaType::kSound:
+      return static_cast<SoundData*>(c)->memory_size();
+    case MediaType::kCollideModel:
+      return static_cast<CollideModelData*>(c)->memory_size();
+    default:
+      return 0;
+  }
+}
+
+// Rough size of the data a pending graphics load will hand to the GPU.
+static auto GetPendingGraphicsLoadSize(MediaComponentData* c) -> size_t {
+  if (c->loaded()) {
+    return 0;
+  }
+  size_t size{};
+  switch (c->GetMediaType()) {
+    case MediaType::kTexture: {
+      auto* t = static_cast<TextureData*>(c);
+      for (auto&& preload_data : t->preload_datas()) {
+        for (size_t level_size : preload_data.sizes) {
+          size += level_size;
+        }
+      }
+      break;
+    }
+    case MediaType::kModel: {
+      auto* m = static_cast<ModelData*>(c);
+      size = m->GetVertexCount() * sizeof(VertexObjectFull)
+             + static_cast<size_t>(m->GetIndexCount()) * m->GetIndexSize();
+      break;
+    }
+    default:
+      break;
+  }
+  return size;
+}
+
 void Media::Init() {
   // Just create our singleton.
   assert(g_media == nullptr);
@@ -45,29 +124,78 @@ void Media::Init() {
 
 Media::Media() {
   media_paths_.emplace_back("ba_data");
+  for (auto&& path : media_paths_) {
+    if (auto archive = MediaArchive::Open(path)) {
+      archives_.push_back(std::move(archive));
+    }
+  }
   for (bool& have_pending_load : have_pending_loads_) {
     have_pending_load = false;
   }
 }
 
-void Media::LoadSystemTexture(SystemTextureID id, const char* name) {
-  assert(media_lists_locked_);
-  system_textures_.push_back(GetTextureData(name));
+void Media::AddSystemTexture(SystemTextureID id, const char* name) {
+  system_texture_names_.push_back(name);
+  system_textures_.emplace_back();
   assert(system_textures_.size() == static_cast<int>(id) + 1);
 }
 
-void Media::LoadSystemCubeMapTexture(SystemCubeMapTextureID id,
-                                     const char* name) {
-  assert(media_lists_locked_);
-  system_cube_map_textures_.push_back(GetCubeMapTextureData(name));
+void Media::AddSystemCubeMapTexture(SystemCubeMapTextureID id,
+                                    const char* name) {
+  system_cube_map_texture_names_.push_back(name);
+  system_cube_map_textures_.emplace_back();
   assert(system_cube_map_textures_.size() == static_cast<int>(id) + 1);
 }
 
-void Media::LoadSystemSound(SystemSoundID id, const char* name) {
-  system_sounds_.push_back(GetSoundData(name));
+void Media::AddSystemSound(SystemSoundID id, const char* name) {
+  system_sound_names_.push_back(name);
+  system_sounds_.emplace_back();
   assert(system_sounds_.size() == static_cast<int>(id) + 1);
 }
 
+// System media can get asked for by code already holding the lists lock.
+template <typename F>
+static void WithMediaListsLock(bool held, F&& f) {
+  if (held) {
+    f();
+  } else {
+    Media::MediaListsLock lock;
+    f();
+  }
+}
+
+void Media::LoadSystemTexture(SystemTextureID id) {
+  assert(InGameThread());
+  auto index = static_cast<size_t>(id);
+  WithMediaListsLock(
+      media_lists_lock_owner_.load() == std::this_thread::get_id(),
+      [this, index] {
+        system_textures_[index] =
+            GetTextureData(system_texture_names_[index]);
+      });
+}
+
+void Media::LoadSystemCubeMapTexture(SystemCubeMapTextureID id) {
+  assert(InGameThread());
+  auto index = static_cast<size_t>(id);
+  WithMediaListsLock(
+      media_lists_lock_owner_.load() == std::this_thread::get_id(),
+      [this, index] {
+        system_cube_map_textures_[index] =
+            GetCubeMapTextureData(system_cube_map_texture_names_[index]);
+      });
+}
+
+void Media::LoadSystemSound(SystemSoundID id) {
+  assert(InGameThread());
+  auto index = static_cast<size_t>(id);
+  WithMediaListsLock(
+      media_lists_lock_owner_.load() == std::this_thread::get_id(),
+      [this, index] {
+        system_sounds_[index] = GetSoundData(system_sound_names_[index]);
+      });
+}
+
 void Media::LoadSystemData(SystemDataID id, const char* name) {
   system_datas_.push_back(GetDataData(name));
   assert(system_datas_.size() == static_cast<int>(id) + 1);
@@ -80,113 +208,144 @@ void Media::LoadSystemModel(SystemModelID id, const char* name) {
 
 void Media::LoadSystemMedia() {
   assert(InGameThread());
-  assert(g_audio_server && g_media_server && g_graphics_server);
+  assert(g_media_server && g_graphics_server);
+#if BA_ENABLE_AUDIO
+  assert(g_audio_server);
+#endif
   assert(g_graphics_server
          && g_graphics_server->texture_compression_types_are_set());
   assert(g_graphics && g_graphics_server->texture_quality_set());
 
+  // Anything not waiting on the renderer may be underway already.
+  if (!early_system_media_loaded_) {
+    LoadEarlySystemMedia();
+  }
+
   // Just grab the lock once for all this stuff for efficiency.
   MediaListsLock lock;
 
   // System textures:
-  LoadSystemTexture(SystemTextureID::kUIAtlas, "uiAtlas");
-  LoadSystemTexture(SystemTextureID::kButtonSquare, "buttonSquare");
-  LoadSystemTexture(SystemTextureID::kWhite, "white");
-  LoadSystemTexture(SystemTextureID::kFontSmall0, "fontSmall0");
-  LoadSystemTexture(SystemTextureID::kFontBig, "fontBig");
-  LoadSystemTexture(SystemTextureID::kCursor, "cursor");
-  LoadSystemTexture(SystemTextureID::kBoxingGlove, "boxingGlovesColor");
-  LoadSystemTexture(SystemTextureID::kShield, "shield");
-  LoadSystemTexture(SystemTextureID::kExplosion, "explosion");
-  LoadSystemTexture(SystemTextureID::kTextClearButton, "textClearButton");
-  LoadSystemTexture(SystemTextureID::kWindowHSmallVMed, "windowHSmallVMed");
-  LoadSystemTexture(SystemTextureID::kWindowHSmallVSmall, "windowHSmallVSmall");
-  LoadSystemTexture(SystemTextureID::kGlow, "glow");
-  LoadSystemTexture(SystemTextureID::kScrollWidget, "scrollWidget");
-  LoadSystemTexture(SystemTextureID::kScrollWidgetGlow, "scrollWidgetGlow");
-  LoadSystemTexture(SystemTextureID::kFlagPole, "flagPoleColor");
-  LoadSystemTexture(SystemTextureID::kScorch, "scorch");
-  LoadSystemTexture(SystemTextureID::kScorchBig, "scorchBig");
-  LoadSystemTexture(SystemTextureID::kShadow, "shadow");
-  LoadSystemTexture(SystemTextureID::kLight, "light");
-  LoadSystemTexture(SystemTextureID::kShadowSharp, "shadowSharp");
-  LoadSystemTexture(SystemTextureID::kLightSharp, "lightSharp");
-  LoadSystemTexture(SystemTextureID::kShadowSoft, "shadowSoft");
-  LoadSystemTexture(SystemTextureID::kLightSoft, "lightSoft");
-  LoadSystemTexture(SystemTextureID::kSparks, "sparks");
-  LoadSystemTexture(SystemTextureID::kEye, "eyeColor");
-  LoadSystemTexture(SystemTextureID::kEyeTint, "eyeColorTintMask");
-  LoadSystemTexture(SystemTextureID::kFuse, "fuse");
-  LoadSystemTexture(SystemTextureID::kShrapnel1, "shrapnel1Color");
-  LoadSystemTexture(SystemTextureID::kSmoke, "smoke");
-  LoadSystemTexture(SystemTextureID::kCircle, "circle");
-  LoadSystemTexture(SystemTextureID::kCircleOutline, "circleOutline");
-  LoadSystemTexture(SystemTextureID::kCircleNoAlpha, "circleNoAlpha");
-  LoadSystemTexture(SystemTextureID::kCircleOutlineNoAlpha,
-                    "circleOutlineNoAlpha");
-  LoadSystemTexture(SystemTextureID::kCircleShadow, "circleShadow");
-  LoadSystemTexture(SystemTextureID::kSoftRect, "softRect");
-  LoadSystemTexture(SystemTextureID::kSoftRect2, "softRect2");
-  LoadSystemTexture(SystemTextureID::kSoftRectVertical, "softRectVertical");
-  LoadSystemTexture(SystemTextureID::kStartButton, "startButton");
-  LoadSystemTexture(SystemTextureID::kBombButton, "bombButton");
-  LoadSystemTexture(SystemTextureID::kOuyaAButton, "ouyaAButton");
-  LoadSystemTexture(SystemTextureID::kBackIcon, "backIcon");
-  LoadSystemTexture(SystemTextureID::kNub, "nub");
-  LoadSystemTexture(SystemTextureID::kArrow, "arrow");
-  LoadSystemTexture(SystemTextureID::kMenuButton, "menuButton");
-  LoadSystemTexture(SystemTextureID::kUsersButton, "usersButton");
-  LoadSystemTexture(SystemTextureID::kActionButtons, "actionButtons");
-  LoadSystemTexture(SystemTextureID::kTouchArrows, "touchArrows");
-  LoadSystemTexture(SystemTextureID::kTouchArrowsActions, "touchArrowsActions");
-  LoadSystemTexture(SystemTextureID::kRGBStripes, "rgbStripes");
-  LoadSystemTexture(SystemTextureID::kUIAtlas2, "uiAtlas2");
-  LoadSystemTexture(SystemTextureID::kFontSmall1, "fontSmall1");
-  LoadSystemTexture(SystemTextureID::kFontSmall2, "fontSmall2");
-  LoadSystemTexture(SystemTextureID::kFontSmall3, "fontSmall3");
-  LoadSystemTexture(SystemTextureID::kFontSmall4, "fontSmall4");
-  LoadSystemTexture(SystemTextureID::kFontSmall5, "fontSmall5");
-  LoadSystemTexture(SystemTextureID::kFontSmall6, "fontSmall6");
-  LoadSystemTexture(SystemTextureID::kFontSmall7, "fontSmall7");
-  LoadSystemTexture(SystemTextureID::kFontExtras, "fontExtras");
-  LoadSystemTexture(SystemTextureID::kFontExtras2, "fontExtras2");
-  LoadSystemTexture(SystemTextureID::kFontExtras3, "fontExtras3");
-  LoadSystemTexture(SystemTextureID::kFontExtras4, "fontExtras4");
-  LoadSystemTexture(SystemTextureID::kCharacterIconMask, "characterIconMask");
-  LoadSystemTexture(SystemTextureID::kBlack, "black");
-  LoadSystemTexture(SystemTextureID::kWings, "wings");
+  AddSystemTexture(SystemTextureID::kUIAtlas, "uiAtlas");
+  AddSystemTexture(SystemTextureID::kButtonSquare, "buttonSquare");
+  AddSystemTexture(SystemTextureID::kWhite, "white");
+  AddSystemTexture(SystemTextureID::kFontSmall0, "fontSmall0");
+  AddSystemTexture(SystemTextureID::kFontBig, "fontBig");
+  AddSystemTexture(SystemTextureID::kCursor, "cursor");
+  AddSystemTexture(SystemTextureID::kBoxingGlove, "boxingGlovesColor");
+  AddSystemTexture(SystemTextureID::kShield, "shield");
+  AddSystemTexture(SystemTextureID::kExplosion, "explosion");
+  AddSystemTexture(SystemTextureID::kTextClearButton, "textClearButton");
+  AddSystemTexture(SystemTextureID::kWindowHSmallVMed, "windowHSmallVMed");
+  AddSystemTexture(SystemTextureID::kWindowHSmallVSmall, "windowHSmallVSmall");
+  AddSystemTexture(SystemTextureID::kGlow, "glow");
+  AddSystemTexture(SystemTextureID::kScrollWidget, "scrollWidget");
+  AddSystemTexture(SystemTextureID::kScrollWidgetGlow, "scrollWidgetGlow");
+  AddSystemTexture(SystemTextureID::kFlagPole, "flagPoleColor");
+  AddSystemTexture(SystemTextureID::kScorch, "scorch");
+  AddSystemTexture(SystemTextureID::kScorchBig, "scorchBig");
+  AddSystemTexture(SystemTextureID::kShadow, "shadow");
+  AddSystemTexture(SystemTextureID::kLight, "light");
+  AddSystemTexture(SystemTextureID::kShadowSharp, "shadowSharp");
+  AddSystemTexture(SystemTextureID::kLightSharp, "lightSharp");
+  AddSystemTexture(SystemTextureID::kShadowSoft, "shadowSoft");
+  AddSystemTexture(SystemTextureID::kLightSoft, "lightSoft");
+  AddSystemTexture(SystemTextureID::kSparks, "sparks");
+  AddSystemTexture(SystemTextureID::kEye, "eyeColor");
+  AddSystemTexture(SystemTextureID::kEyeTint, "eyeColorTintMask");
+  AddSystemTexture(SystemTextureID::kFuse, "fuse");
+  AddSystemTexture(SystemTextureID::kShrapnel1, "shrapnel1Color");
+  AddSystemTexture(SystemTextureID::kSmoke, "smoke");
+  AddSystemTexture(SystemTextureID::kCircle, "circle");
+  AddSystemTexture(SystemTextureID::kCircleOutline, "circleOutline");
+  AddSystemTexture(SystemTextureID::kCircleNoAlpha, "circleNoAlpha");
+  AddSystemTexture(SystemTextureID::kCircleOutlineNoAlpha,
+                   "circleOutlineNoAlpha");
+  AddSystemTexture(SystemTextureID::kCircleShadow, "circleShadow");
+  AddSystemTexture(SystemTextureID::kSoftRect, "softRect");
+  AddSystemTexture(SystemTextureID::kSoftRect2, "softRect2");
+  AddSystemTexture(SystemTextureID::kSoftRectVertical, "softRectVertical");
+  AddSystemTexture(SystemTextureID::kStartButton, "startButton");
+  AddSystemTexture(SystemTextureID::kBombButton, "bombButton");
+  AddSystemTexture(SystemTextureID::kOuyaAButton, "ouyaAButton");
+  AddSystemTexture(SystemTextureID::kBackIcon, "backIcon");
+  AddSystemTexture(SystemTextureID::kNub, "nub");
+  AddSystemTexture(SystemTextureID::kArrow, "arrow");
+  AddSystemTexture(SystemTextureID::kMenuButton, "menuButton");
+  AddSystemTexture(SystemTextureID::kUsersButton, "usersButton");
+  AddSystemTexture(SystemTextureID::kActionButtons, "actionButtons");
+  AddSystemTexture(SystemTextureID::kTouchArrows, "touchArrows");
+  AddSystemTexture(SystemTextureID::kTouchArrowsActions, "touchArrowsActions");
+  AddSystemTexture(SystemTextureID::kRGBStripes, "rgbStripes");
+  AddSystemTexture(SystemTextureID::kUIAtlas2, "uiAtlas2");
+  AddSystemTexture(SystemTextureID::kFontSmall1, "fontSmall1");
+  AddSystemTexture(SystemTextureID::kFontSmall2, "fontSmall2");
+  AddSystemTexture(SystemTextureID::kFontSmall3, "fontSmall3");
+  AddSystemTexture(SystemTextureID::kFontSmall4, "fontSmall4");
+  AddSystemTexture(SystemTextureID::kFontSmall5, "fontSmall5");
+  AddSystemTexture(SystemTextureID::kFontSmall6, "fontSmall6");
+  AddSystemTexture(SystemTextureID::kFontSmall7, "fontSmall7");
+  AddSystemTexture(SystemTextureID::kFontExtras, "fontExtras");
+  AddSystemTexture(SystemTextureID::kFontExtras2, "fontExtras2");
+  AddSystemTexture(SystemTextureID::kFontExtras3, "fontExtras3");
+  AddSystemTexture(SystemTextureID::kFontExtras4, "fontExtras4");
+  AddSystemTexture(SystemTextureID::kCharacterIconMask, "characterIconMask");
+  AddSystemTexture(SystemTextureID::kBlack, "black");
+  AddSystemTexture(SystemTextureID::kWings, "wings");
 
   // System cube map textures:
-  LoadSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionChar,
-                           "reflectionChar#");
-  LoadSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionPowerup,
-                           "reflectionPowerup#");
-  LoadSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSoft,
-                           "reflectionSoft#");
-  LoadSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSharp,
-                           "reflectionSharp#");
-  LoadSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSharper,
-                           "reflectionSharper#");
-  LoadSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSharpest,
-                           "reflectionSharpest#");
+  AddSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionChar,
+                          "reflectionChar#");
+  AddSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionPowerup,
+                          "reflectionPowerup#");
+  AddSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSoft,
+                          "reflectionSoft#");
+  AddSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSharp,
+                          "reflectionSharp#");
+  AddSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSharper,
+                          "reflectionSharper#");
+  AddSystemCubeMapTexture(SystemCubeMapTextureID::kReflectionSharpest,
+                          "reflectionSharpest#");
+
+  // Hooray!
+  system_media_loaded_ = true;
+}
+
+void Media::LoadEarlySystemMedia() {
+  assert(InGameThread());
+  assert(g_media_server);
+#if BA_ENABLE_AUDIO
+  assert(g_audio_server);
+#endif
+  assert(!early_system_media_loaded_);
+
+  MediaListsLock lock;
 
   // System sounds:
-  LoadSystemSound(SystemSoundID::kDeek, "deek");
-  LoadSystemSound(SystemSoundID::kBlip, "blip");
-  LoadSystemSound(SystemSoundID::kBlank, "blank");
-  LoadSystemSound(SystemSoundID::kPunch, "punch01");
-  LoadSystemSound(SystemSoundID::kClick, "click01");
-  LoadSystemSound(SystemSoundID::kErrorBeep, "error");
-  LoadSystemSound(SystemSoundID::kSwish, "swish");
-  LoadSystemSound(SystemSoundID::kSwish2, "swish2");
-  LoadSystemSound(SystemSoundID::kSwish3, "swish3");
-  LoadSystemSound(SystemSoundID::kTap, "tap");
-  LoadSystemSound(SystemSoundID::kCorkPop, "corkPop");
-  LoadSystemSound(SystemSoundID::kGunCock, "gunCocking");
-  LoadSystemSound(SystemSoundID::kTickingCrazy, "tickingCrazy");
-  LoadSystemSound(SystemSoundID::kSparkle, "sparkle01");
-  LoadSystemSound(SystemSoundID::kSparkle2, "sparkle02");
-  LoadSystemSound(SystemSoundID::kSparkle3, "sparkle03");
+  AddSystemSound(SystemSoundID::kDeek, "deek");
+  AddSystemSound(SystemSoundID::kBlip, "blip");
+  AddSystemSound(SystemSoundID::kBlank, "blank");
+  AddSystemSound(SystemSoundID::kPunch, "punch01");
+  AddSystemSound(SystemSoundID::kClick, "click01");
+  AddSystemSound(SystemSoundID::kErrorBeep, "error");
+  AddSystemSound(SystemSoundID::kSwish, "swish");
+  AddSystemSound(SystemSoundID::kSwish2, "swish2");
+  AddSystemSound(SystemSoundID::kSwish3, "swish3");
+  AddSystemSound(SystemSoundID::kTap, "tap");
+  AddSystemSound(SystemSoundID::kCorkPop, "corkPop");
+  AddSystemSound(SystemSoundID::kGunCock, "gunCocking");
+  AddSystemSound(SystemSoundID::kTickingCrazy, "tickingCrazy");
+  AddSystemSound(SystemSoundID::kSparkle, "sparkle01");
+  AddSystemSound(SystemSoundID::kSparkle2, "sparkle02");
+  AddSystemSound(SystemSoundID::kSparkle3, "sparkle03");
+
+  // UI feedback sounds load now; the rest on first use.
+  if (!HeadlessMode()) {
+    for (auto id : {SystemSoundID::kDeek, SystemSoundID::kBlip,
+                    SystemSoundID::kClick, SystemSoundID::kErrorBeep,
+                    SystemSoundID::kSwish, SystemSoundID::kTap}) {
+      LoadSystemSound(id);
+    }
+  }
 
   // System datas:
   // (crickets)
@@ -284,8 +443,7 @@ void Media::LoadSystemMedia() {
   LoadSystemModel(SystemModelID::kCrossOut, "crossOut");
   LoadSystemModel(SystemModelID::kWing, "wing");
 
-  // Hooray!
-  system_media_loaded_ = true;
+  early_system_media_loaded_ = true;
 }
 
 Media::~Media() = default;
@@ -331,11 +489,24 @@ void Media::PrintLoadInfo() {
     num++;
   }
   assert(media_lists_locked_);
+  size_t sound_pcm_size{};
+  size_t sound_compressed_size{};
+  int sound_pcm_count{};
+  int sound_compressed_count{};
   for (auto&& i : sounds_) {
     millisecs_t preload_time = i.second->preload_time();
     millisecs_t load_time = i.second->load_time();
     total_preload_time += preload_time;
     total_load_time += load_time;
+    if (size_t size = GetMediaMemorySize(i.second.get())) {
+      if (i.second->is_streamed()) {
+        sound_compressed_size += size;
+        sound_compressed_count++;
+      } else {
+        sound_pcm_size += size;
+        sound_pcm_count++;
+      }
+    }
     snprintf(buffer, sizeof(buffer), "%-3d %-50s %10d %10d", num,
              i.second->GetName().c_str(),
              static_cast_check_fit<int>(preload_time),
@@ -375,6 +546,25 @@ void Media::PrintLoadInfo() {
            static_cast<int>(total_preload_time),
            static_cast<int>(total_load_time));
   Log(buffer, true, false);
+  snprintf(buffer, sizeof(buffer),
+           "Media memory used: %.1fMB (budget %.1fMB); budget evictions: %i"
+           " (%.1fMB)",
+           static_cast<double>(media_memory_used_) / (1024.0 * 1024.0),
+           static_cast<double>(media_memory_budget_) / (1024.0 * 1024.0),
+           static_cast<int>(media_memory_evictions_),
+           static_cast<double>(media_memory_bytes_evicted_)
+               / (1024.0 * 1024.0));
+  Log(buffer, true, false);
+  snprintf(buffer, sizeof(buffer),
+           "Audio memory used: %.1fMB (%.1fMB pcm in %i sounds; %.1fMB"
+           " compressed in %i sounds)",
+           static_cast<double>(sound_pcm_size + sound_compressed_size)
+               / (1024.0 * 1024.0),
+           static_cast<double>(sound_pcm_size) / (1024.0 * 1024.0),
+           sound_pcm_count,
+           static_cast<double>(sound_compressed_size) / (1024.0 * 1024.0),
+           sound_compressed_count);
+  Log(buffer, true, false);
 }
 
 void Media::MarkAllMediaForLoad() {
@@ -737,7 +927,8 @@ auto Media::RunPendingAudioLoads() -> bool {
 // Runs the pending loads that need to run from the graphics thread.
 auto Media::RunPendingGraphicsLoads() -> bool {
   assert(InGraphicsThread());
-  return RunPendingLoadList(&pending_loads_graphics_);
+  return RunPendingLoadList(&pending_loads_graphics_,
+                            kPendingGraphicsLoadBytes);
 }
 
 // Runs the pending loads that run in the main thread.  Also clears the list of
@@ -748,9 +939,13 @@ auto Media::RunPendingLoadsGameThread() -> bool {
 }
 
 template <class T>
-auto Media::RunPendingLoadList(std::vector<Object::Ref<T>*>* c_list) -> bool {
-  bool flush = false;
-  millisecs_t starttime = GetRealTime();
+auto Media::RunPendingLoadList(std::vector<Object::Ref<T>*>* c_list,
+                               size_t byte_budget) -> bool {
+  auto starttime = std::chrono::steady_clock::now();
+  auto out_of_time = [starttime] {
+    return std::chrono::steady_clock::now() - starttime
+           > std::chrono::milliseconds(PENDING_LOAD_PROCESS_TIME);
+  };
 
   std::vector<Object::Ref<T>*> l;
   std::vector<Object::Ref<T>*> l_unfinished;
@@ -758,12 +953,6 @@ auto Media::RunPendingLoadList(std::vector<Object::Ref<T>*>* c_list) -> bool {
   {
     std::lock_guard<std::mutex> lock(pending_load_list_mutex_);
 
-    // If we're already out of time.
-    if (!flush && GetRealTime() - starttime > PENDING_LOAD_PROCESS_TIME) {
-      bool return_val = (!c_list->empty());
-      return return_val;
-    }
-
     // Save time if there's nothing to load.
     if (c_list->empty()) {
       return false;
@@ -773,36 +962,48 @@ auto Media::RunPendingLoadList(std::vector<Object::Ref<T>*>* c_list) -> bool {
     l.swap(*c_list);
   }
 
-  // Run loads on our list until either the list is empty or we're out of time
-  // (don't want to block here for very long...)
-  // We should also think about the fact that even if a load is quick here it
-  // may add work on the graphics thread/etc so maybe we should add other
-  // restrictions.
-  bool out_of_time = false;
-  if (!l.empty()) {
-    while (true) {
-      for (auto i = l.begin(); i != l.end(); i++) {
-        if (!out_of_time) {
-          (***i).Load(false);
-
-          // If the load finished, pop it on our "done-loading" list.. otherwise
-          // keep it around.
-          l_finished.push_back(*i);  // else l_unfinished.push_back(*i);
-          if (GetRealTime() - starttime > PENDING_LOAD_PROCESS_TIME && !flush) {
-            out_of_time = true;
-          }
-        } else {
-          // Already out of time - just save this one for later.
-          l_unfinished.push_back(*i);
-        }
-      }
-      l = l_unfinished;
-      l_unfinished.clear();
-      if (l.empty() || out_of_time) {
-        break;
+  // When we're budgeting uploads, do the stuff that's actually being drawn
+  // (or was most recently asked for) first; the rest is speculative and can
+  // wait for later frames.
+  if (byte_budget) {
+    std::stable_sort(l.begin(), l.end(),
+                     [](Object::Ref<T>* a, Object::Ref<T>* b) {
+                       bool a_drawn = (**a).last_frame_def_num() != 0;
+                       bool b_drawn = (**b).last_frame_def_num() != 0;
+                       if (a_drawn != b_drawn) {
+                         return a_drawn;
+                       }
+                       return (**a).last_used_time() > (**b).last_used_time();
+                     });
+  }
+
+  // Run loads on our list until either the list is empty or we're out of
+  // time/bytes (don't want to block here for very long...)
+  // We always run at least one so we can't get stuck on a big one.
+  size_t bytes{};
+  bool out_of_budget{};
+  for (auto&& i : l) {
+    if (out_of_budget) {
+      // Already out of time/bytes - just save this one for later.
+      l_unfinished.push_back(i);
+      continue;
+    }
+    if (byte_budget) {
+      size_t size = GetPendingGraphicsLoadSize(&(**i));
+      if (!l_finished.empty() && bytes + size > byte_budget) {
+        out_of_budget = true;
+        l_unfinished.push_back(i);
+        continue;
       }
+      bytes += size;
+    }
+    (**i).Load(false);
+    l_finished.push_back(i);
+    if (out_of_time()) {
+      out_of_budget = true;
     }
   }
+  l.swap(l_unfinished);
 
   // Now add unfinished ones back onto the original list and finished ones into
   // the done list.
@@ -858,6 +1059,7 @@ void Media::Prune(int level) {
   }
 
   std::vector<Object::Ref<MediaComponentData>*> graphics_thread_unloads;
+  std::vector<Object::Ref<MediaComponentData>*> graphics_thread_reloads;
   std::vector<Object::Ref<MediaComponentData>*> audio_thread_unloads;
 
 #if SHOW_PRUNING_INFO
@@ -896,6 +1098,9 @@ void Media::Prune(int level) {
     }
   }
 
+  UpdateTextureResidency(current_time, &graphics_thread_reloads);
+  EvictForMemoryBudget(current_time, &graphics_thread_unloads);
+
   // prune text-textures more aggressively since we may generate lots of them
   // FIXME - we may want to prune based on total number of these instead of
   // time..
@@ -1028,8 +1233,19 @@ void Media::Prune(int level) {
   if (!graphics_thread_unloads.empty()) {
     g_graphics_server->PushComponentUnloadCall(graphics_thread_unloads);
   }
+  if (!graphics_thread_reloads.empty()) {
+    g_graphics_server->PushComponentReloadCall(graphics_thread_reloads);
+  }
   if (!audio_thread_unloads.empty()) {
+#if BA_ENABLE_AUDIO
     g_audio_server->PushComponentUnloadCall(audio_thread_unloads);
+#else
+    // No audio thread; there's nothing real to unload anyway.
+    for (auto&& i : audio_thread_unloads) {
+      (**i).Unload();
+    }
+    g_game->PushFreeMediaComponentRefsCall(audio_thread_unloads);
+#endif
   }
 
 #if SHOW_PRUNING_INFO
@@ -1061,6 +1277,179 @@ void Media::Prune(int level) {
 #endif  // SHOW_PRUNING_INFO
 }
 
+void Media::EvictForMemoryBudget(
+    millisecs_t current_time,
+    std::vector<Object::Ref<MediaComponentData>*>* graphics_unloads) {
+  assert(InGameThread());
+  assert(media_lists_locked_);
+
+  // Sounds count towards our total but are never evicted here (see the
+  // note on sound pruning above).
+  struct Candidate {
+    MediaComponentData* data;
+    const std::string* name;
+    int list;
+    size_t size;
+    double score;
+  };
+  std::vector<Candidate> candidates;
+  size_t used{};
+  size_t used_by_tag[MemoryStats::kTagCount]{};
+  auto tally = [&](auto&& list, int list_index, MemoryStats::Tag tag,
+                   bool evictable) {
+    for (auto&& i : list) {
+      MediaComponentData* c = i.second.get();
+      size_t size = GetMediaMemorySize(c);
+      used += size;
+      used_by_tag[static_cast<int>(tag)] += size;
+      millisecs_t idle = current_time - c->last_used_time();
+      if (evictable && size > 0 && idle > kMinMemoryEvictIdleTime
+          && c->object_strong_ref_count() <= 1) {
+        // Big things that have sat unused the longest go first.
+        candidates.push_back({c, &i.first, list_index, size,
+                              static_cast<double>(size)
+                                  * static_cast<double>(idle)});
+      }
+    }
+  };
+  tally(textures_, 0, MemoryStats::Tag::kTextures, true);
+  tally(text_textures_, 1, MemoryStats::Tag::kTextures, true);
+  tally(qr_textures_, 2, MemoryStats::Tag::kTextures, true);
+  tally(models_, 3, MemoryStats::Tag::kModels, true);
+  tally(collide_models_, 4, MemoryStats::Tag::kCollideModels, true);
+  tally(sounds_, 5, MemoryStats::Tag::kSounds, false);
+  media_memory_used_ = used;
+  for (auto tag : {MemoryStats::Tag::kTextures, MemoryStats::Tag::kModels,
+                   MemoryStats::Tag::kCollideModels,
+                   MemoryStats::Tag::kSounds}) {
+    MemoryStats::Set(tag,
+                     static_cast<int64_t>(used_by_tag[static_cast<int>(tag)]));
+  }
+
+  if (media_memory_budget_ == 0 || used <= media_memory_budget_) {
+    return;
+  }
+  int count = std::min(kMaxMemoryEvictionsPerPrune,
+                       static_cast<int>(candidates.size()));
+  std::partial_sort(
+      candidates.begin(), candidates.begin() + count, candidates.end(),
+      [](const Candidate& a, const Candidate& b) { return a.score > b.score; });
+  for (int i = 0; i < count && used > media_memory_budget_; i++) {
+    Candidate& candidate = candidates[static_cast<size_t>(i)];
+    MediaComponentData* c = candidate.data;
+
+    // Copy the name; erasing from the list frees the original.
+    std::string name = *candidate.name;
+    switch (candidate.list) {
+      case 0:
+        graphics_unloads->push_back(new Object::Ref<MediaComponentData>(c));
+        textures_.erase(name);
+        break;
+      case 1:
+        graphics_unloads->push_back(new Object::Ref<MediaComponentData>(c));
+        text_textures_.erase(name);
+        break;
+      case 2:
+        graphics_unloads->push_back(new Object::Ref<MediaComponentData>(c));
+        qr_textures_.erase(name);
+        break;
+      case 3:
+        graphics_unloads->push_back(new Object::Ref<MediaComponentData>(c));
+        models_.erase(name);
+        break;
+      case 4:
+        // We can unload it immediately since that happens in the game
+        // thread.
+        c->Unload();
+        collide_models_.erase(name);
+        break;
+      default:
+        continue;
+    }
+    used -= std::min(used, candidate.size);
+    media_memory_evictions_++;
+    media_memory_bytes_evicted_ += candidate.size;
+  }
+  media_memory_used_ = used;
+}
+
+void Media::UpdateTextureResidency(
+    millisecs_t current_time,
+    std::vector<Object::Ref<MediaComponentData>*>* reloads) {
+  assert(InGameThread());
+  assert(media_lists_locked_);
+  size_t resident = 0;
+  std::vector<TextureData*> idle;
+  std::vector<TextureData*> demoted_in_use;
+  for (auto&& i : textures_) {
+    TextureData* texture_data = i.second.get();
+    if (!texture_data->loaded()
+        || texture_data->texture_type() != TextureType::k2D) {
+      continue;
+    }
+    resident += texture_data->resident_size();
+    millisecs_t age = current_time - texture_data->last_used_time();
+    if (age > kTextureIdleTime
+        && texture_data->mip_bias()
+               < std::min(kMaxTextureMipBias, texture_data->mip_bias_limit())) {
+      idle.push_back(texture_data);
+    } else if (age < kTextureActiveTime && texture_data->mip_bias() > 0) {
+      demoted_in_use.push_back(texture_data);
+    }
+  }
+  texture_memory_resident_ = resident;
+
+  if (texture_memory_budget_ != 0 && resident > texture_memory_budget_) {
+    // Over budget; drop a level off the longest-idle textures until we
+    // expect to fit. (Each level is roughly 3/4 of a texture's memory).
+    std::sort(idle.begin(), idle.end(), [](TextureData* a, TextureData* b) {
+      return a->last_used_time() < b->last_used_time();
+    });
+    for (auto* texture_data : idle) {
+      if (resident <= texture_memory_budget_) {
+        break;
+      }
+      texture_data->set_mip_bias(texture_data->mip_bias() + 1);
+      resident -= texture_data->resident_size() * 3 / 4;
+      reloads->push_back(new Object::Ref<MediaComponentData>(texture_data));
+    }
+  } else if (!demoted_in_use.empty()) {
+    // We've got room; give the most recently drawn demoted texture its
+    // full mips back if it'll fit. Since that texture is in use, its
+    // reload can land mid-game as a synchronous load, so we only do one
+    // per prune.
+    auto* texture_data = *std::max_element(
+        demoted_in_use.begin(), demoted_in_use.end(),
+        [](TextureData* a, TextureData* b) {
+          return a->last_used_time() < b->last_used_time();
+        });
+    size_t full_size = texture_data->resident_size()
+                       << (2 * texture_data->mip_bias());
+    if (texture_memory_budget_ == 0
+        || resident - texture_data->resident_size() + full_size
+               <= texture_memory_budget_) {
+      texture_data->set_mip_bias(0);
+      reloads->push_back(new Object::Ref<MediaComponentData>(texture_data));
+    }
+  }
+}
+
+void Media::MarkComponentsForReload(
+    const std::vector<Object::Ref<MediaComponentData>*>& components) {
+  assert(InGameThread());
+  for (auto&& i : components) {
+    MediaComponentData* c = i->get();
+
+    // Something may have drawn it (and so loaded it) in the meantime.
+    if (!c->preloaded()) {
+      MediaComponentData::LockGuard lock(c);
+      have_pending_loads_[static_cast<int>(c->GetMediaType())] = true;
+      MarkComponentForLoad(c);
+    }
+    delete i;
+  }
+}
+
 auto Media::FindMediaFile(FileType type, const std::string& name)
     -> std::string {
   std::string file_out;
@@ -1133,11 +1522,30 @@ auto Media::FindMediaFile(FileType type, const std::string& name)
 
   const std::vector<std::string>& media_paths_used = media_paths_;
 
+  // Only some loaders can read out of archives (see MediaFileReader).
+  bool archivable = (type == FileType::kModel
+                     || type == FileType::kCollisionModel
+                     || (type == FileType::kTexture
+                         && (!strcmp(ext, ".dds") || !strcmp(ext, ".ktx"))));
+
   for (auto&& i : media_paths_used) {
     struct BA_STAT stats {};
     file_out = i + "/" + prefix + name + ext;  // NOLINT
     int result;
 
+    // Archived files save us the stat (and later the open).
+    if (archivable && !archives_.empty()) {
+      const char* data;
+      size_t size;
+      std::string archived_name = file_out;
+      if (strchr(archived_name.c_str(), '#')) {
+        archived_name.replace(archived_name.find('#'), 1, "_+x");
+      }
+      if (FindArchivedFile(archived_name, &data, &size)) {
+        return file_out;
+      }
+    }
+
     // '#' denotes a cube map texture, which is actually 6 files.
     if (strchr(file_out.c_str(), '#')) {
       std::string tmp_name = file_out;
@@ -1168,6 +1576,125 @@ auto Media::FindMediaFile(FileType type, const std::string& name)
   // return file_out;
 }
 
+auto Media::FindArchivedFile(const std::string& file_name, const char** data,
+                             size_t* size) const -> bool {
+  for (auto&& archive : archives_) {
+    const std::string& root = archive->media_path();
+    if (file_name.size() > root.size() + 1
+        && !file_name.compare(0, root.size(), root)
+        && file_name[root.size()] == '/') {
+      if (archive->Find(file_name.substr(root.size() + 1), data, size)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+auto Media::GetMediaFileModTime(const std::string& file_name) const
+    -> time_t {
+  std::string path = file_name;
+  const char* data;
+  size_t size;
+  for (auto&& archive : archives_) {
+    const std::string& root = archive->media_path();
+    if (file_name.size() > root.size() + 1
+        && !file_name.compare(0, root.size(), root)
+        && file_name[root.size()] == '/'
+        && archive->Find(file_name.substr(root.size() + 1), &data, &size)) {
+      path = root + "/" + MediaArchive::kFileName;
+      break;
+    }
+  }
+  struct BA_STAT stats {};
+  if (g_platform->Stat(path.c_str(), &stats) == 0) {
+    return stats.st_mtime;
+  }
+  return 0;
+}
+
+void Media::PrefetchMedia(const std::vector<std::string>& textures,
+                          const std::vector<std::string>& models,
+                          const std::vector<std::string>& collide_models,
+                          const std::vector<std::string>& sounds,
+                          const std::vector<std::string>& datas) {
+  // Just creating the datas is enough to get them preloading; they then
+  // live on our lists until nobody has used them for a while.
+  GetMediaForNames(textures, models, collide_models, sounds, datas, nullptr);
+}
+
+void Media::LoadMediaAsync(const std::vector<std::string>& textures,
+                           const std::vector<std::string>& models,
+                           const std::vector<std::string>& collide_models,
+                           const std::vector<std::string>& sounds,
+                           const std::vector<std::string>& datas,
+                           const Object::Ref<Runnable>& on_loaded) {
+  assert(InGameThread());
+  assert(on_loaded.exists());
+  async_loads_.emplace_back();
+  AsyncLoad& load = async_loads_.back();
+  load.on_loaded = on_loaded;
+  GetMediaForNames(textures, models, collide_models, sounds, datas,
+                   &load.components);
+
+  // Some or all of it may already be loaded; if so this fires right away
+  // (though still not until after we return).
+  UpdateAsyncLoads();
+}
+
+void Media::GetMediaForNames(
+    const std::vector<std::string>& textures,
+    const std::vector<std::string>& models,
+    const std::vector<std::string>& collide_models,
+    const std::vector<std::string>& sounds,
+    const std::vector<std::string>& datas,
+    std::vector<Object::Ref<MediaComponentData> >* components) {
+  assert(InGameThread());
+  MediaListsLock lock;
+  auto get_all = [components](const std::vector<std::string>& names,
+                              auto&& get) {
+    for (auto&& name : names) {
+      try {
+        auto data = get(name);
+        if (components) {
+          components->emplace_back(data.get());
+        }
+      } catch (const std::exception&) {
+        // Manifests can go stale; whatever's gone is just skipped.
+      }
+    }
+  };
+  get_all(textures,
+          [this](const std::string& n) { return GetTextureData(n); });
+  get_all(models, [this](const std::string& n) { return GetModelData(n); });
+  get_all(collide_models,
+          [this](const std::string& n) { return GetCollideModelData(n); });
+  get_all(sounds, [this](const std::string& n) { return GetSoundData(n); });
+  get_all(datas, [this](const std::string& n) { return GetDataData(n); });
+}
+
+void Media::UpdateAsyncLoads() {
+  assert(InGameThread());
+  for (auto i = async_loads_.begin(); i != async_loads_.end();) {
+    bool done = true;
+    for (auto&& c : i->components) {
+      if (!c->loaded()) {
+        done = false;
+        break;
+      }
+    }
+    if (done) {
+      // Run it as its own call; whatever it does shouldn't happen in the
+      // middle of our load bookkeeping.
+      Object::Ref<Runnable> on_loaded = i->on_loaded;
+      g_game->PushCall([on_loaded] { on_loaded->Run(); });
+      i = async_loads_.erase(i);
+    } else {
+      ++i;
+    }
+  }
+}
+
 void Media::AddPendingLoad(Object::Ref<MediaComponentData>* c) {
   switch ((**c).GetMediaType()) {
     case MediaType::kTexture:
@@ -1177,6 +1704,7 @@ void Media::AddPendingLoad(Object::Ref<MediaComponentData>* c) {
       pending_loads_graphics_.push_back(c);
       break;
     }
+#if BA_ENABLE_AUDIO
     case MediaType::kSound: {
       // Tell the audio thread there's pending loads.
       {
@@ -1186,8 +1714,10 @@ void Media::AddPendingLoad(Object::Ref<MediaComponentData>* c) {
       g_audio_server->PushHavePendingLoadsCall();
       break;
     }
+#endif  // BA_ENABLE_AUDIO
     default: {
-      // Tell the game thread there's pending loads.
+      // Tell the game thread there's pending loads. (Without audio there's
+      // no audio thread, so sounds land here too).
       {
         std::lock_guard<std::mutex> lock(pending_load_list_mutex_);
         pending_loads_other_.push_back(c);
@@ -1201,17 +1731,23 @@ void Media::AddPendingLoad(Object::Ref<MediaComponentData>* c) {
 void Media::ClearPendingLoadsDoneList() {
   assert(InGameThread());
 
-  std::lock_guard<std::mutex> lock(pending_load_list_mutex_);
-
   // Our explicitly-allocated reference pointer has made it back to us here in
   // the game thread.
   // We can now kill the reference knowing that it's safe for this component
   // to die at any time (anyone needing it to be alive now should be holding a
   // reference themselves).
-  for (Object::Ref<MediaComponentData>* i : pending_loads_done_) {
-    delete i;
+  {
+    std::lock_guard<std::mutex> lock(pending_load_list_mutex_);
+    for (Object::Ref<MediaComponentData>* i : pending_loads_done_) {
+      delete i;
+    }
+    pending_loads_done_.clear();
+  }
+
+  // Whatever just finished may complete some async load requests.
+  if (!async_loads_.empty()) {
+    UpdateAsyncLoads();
   }
-  pending_loads_done_.clear();
 }
 
 void Media::PreloadRunnable::Run() {
@@ -1243,12 +1779,14 @@ Media::MediaListsLock::MediaListsLock() {
   g_media->media_lists_mutex_.lock();
   assert(!g_media->media_lists_locked_);
   g_media->media_lists_locked_ = true;
+  g_media->media_lists_lock_owner_ = std::this_thread::get_id();
   BA_DEBUG_FUNCTION_TIMER_END_THREAD(20);
 }
 
 Media::MediaListsLock::~MediaListsLock() {
   assert(g_media->media_lists_locked_);
   g_media->media_lists_locked_ = false;
+  g_media->media_lists_lock_owner_ = std::thread::id();
   g_media->media_lists_mutex_.unlock();
 }
 
@@ -3,7 +3,11 @@
 #ifndef BALLISTICA_MEDIA_MEDIA_H_
 #define BALLISTICA_MEDIA_MEDIA_H_
 
+#include <atomic>
+#include <list>
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -43,6 +47,25 @@ class Media {
   }
 
   void AddPackage(const std::string& name, const std::string& path);
+
+  /// Kick off background loading for media we expect to need soon (an
+  /// upcoming activity's manifest, etc). Names that can't be found are
+  /// ignored. It all sticks around until pruned like any other media.
+  void PrefetchMedia(const std::vector<std::string>& textures,
+                     const std::vector<std::string>& models,
+                     const std::vector<std::string>& collide_models,
+                     const std::vector<std::string>& sounds,
+                     const std::vector<std::string>& datas);
+
+  /// Like PrefetchMedia(), but also runs on_loaded in the game thread once
+  /// everything requested has finished loading. This never blocks, so
+  /// it's the way to go for code wanting media soon without hitching.
+  void LoadMediaAsync(const std::vector<std::string>& textures,
+                      const std::vector<std::string>& models,
+                      const std::vector<std::string>& collide_models,
+                      const std::vector<std::string>& sounds,
+                      const std::vector<std::string>& datas,
+                      const Object::Ref<Runnable>& on_loaded);
   void Prune(int level = 0);
 
   /// Finish loading any media that has been preloaded but still needs to be
@@ -56,7 +79,8 @@ class Media {
   auto RunPendingGraphicsLoads() -> bool;
   void ClearPendingLoadsDoneList();
   template <class T>
-  auto RunPendingLoadList(std::vector<Object::Ref<T>*>* cList) -> bool;
+  auto RunPendingLoadList(std::vector<Object::Ref<T>*>* cList,
+                          size_t byte_budget = 0) -> bool;
 
   /// This function takes a newly allocated pointer which
   /// is deleted once the load is completed.
@@ -66,6 +90,15 @@ class Media {
   auto FindMediaFile(FileType fileType, const std::string& file_in)
       -> std::string;
 
+  /// Look for a full media path (as returned by FindMediaFile()) in our
+  /// media archives. Safe to call from any thread.
+  auto FindArchivedFile(const std::string& file_name, const char** data,
+                        size_t* size) const -> bool;
+
+  /// Modification time of a full media path, looking through archives
+  /// (archived files report their archive's time). Returns 0 if unknown.
+  auto GetMediaFileModTime(const std::string& file_name) const -> time_t;
+
   /// Unload renderer-specific bits only (gl display lists, etc) - used when
   /// recreating/adjusting the renderer.
   void UnloadRendererBits(bool textures, bool models);
@@ -107,24 +140,37 @@ class Media {
   auto GetCollideModelData(const std::string& file_name)
       -> Object::Ref<CollideModelData>;
 
-  // Get system assets.
+  // Get system assets. Other than a few everything needs (fonts, UI
+  // basics), system textures and sounds start loading on first request.
   auto GetTexture(SystemTextureID id) -> TextureData* {
     BA_PRECONDITION_FATAL(system_media_loaded_);  // Revert to assert later.
     assert(InGameThread());
     assert(static_cast<size_t>(id) < system_textures_.size());
-    return system_textures_[static_cast<int>(id)].get();
+    auto& texture = system_textures_[static_cast<int>(id)];
+    if (!texture.exists()) {
+      LoadSystemTexture(id);
+    }
+    return texture.get();
   }
   auto GetCubeMapTexture(SystemCubeMapTextureID id) -> TextureData* {
     BA_PRECONDITION_FATAL(system_media_loaded_);  // Revert to assert later.
     assert(InGameThread());
     assert(static_cast<size_t>(id) < system_cube_map_textures_.size());
-    return system_cube_map_textures_[static_cast<int>(id)].get();
+    auto& texture = system_cube_map_textures_[static_cast<int>(id)];
+    if (!texture.exists()) {
+      LoadSystemCubeMapTexture(id);
+    }
+    return texture.get();
   }
   auto GetSound(SystemSoundID id) -> SoundData* {
     BA_PRECONDITION_FATAL(system_media_loaded_);  // Revert to assert later.
     assert(InGameThread());
     assert(static_cast<size_t>(id) < system_sounds_.size());
-    return system_sounds_[static_cast<int>(id)].get();
+    auto& sound = system_sounds_[static_cast<int>(id)];
+    if (!sound.exists()) {
+      LoadSystemSound(id);
+    }
+    return sound.get();
   }
   auto GetModel(SystemModelID id) -> ModelData* {
     BA_PRECONDITION_FATAL(system_media_loaded_);  // Revert to assert later.
@@ -136,6 +182,14 @@ class Media {
   /// Load up hard-coded media for interface, etc.
   void LoadSystemMedia();
 
+  /// Start loading the hard-coded media that doesn't depend on the
+  /// renderer (sounds, datas and models) so it can overlap screen and
+  /// shader setup. LoadSystemMedia() does this itself if it hasn't been.
+  void LoadEarlySystemMedia();
+  auto early_system_media_loaded() const -> bool {
+    return early_system_media_loaded_;
+  }
+
   auto total_model_count() const -> uint32_t {
     return static_cast<uint32_t>(models_.size());
   }
@@ -149,6 +203,30 @@ class Media {
   auto total_collide_model_count() const -> uint32_t {
     return static_cast<uint32_t>(collide_models_.size());
   }
+
+  /// Byte budget for loaded file textures (0 means no limit). When we're
+  /// over it, textures that haven't been drawn lately get reloaded with
+  /// their top mips dropped; they get them back once drawn again and
+  /// there's room.
+  void set_texture_memory_budget(size_t val) { texture_memory_budget_ = val; }
+
+  /// Estimated bytes held by loaded file textures as of the last prune.
+  auto texture_memory_resident() const -> size_t {
+    return texture_memory_resident_;
+  }
+
+  /// Byte budget for all loaded media (0 means no limit). When we're over
+  /// it, each prune evicts a few unreferenced components, favoring big ones
+  /// that have sat unused the longest.
+  void set_media_memory_budget(size_t val) { media_memory_budget_ = val; }
+
+  /// Estimated bytes held by loaded media as of the last prune.
+  auto media_memory_used() const -> size_t { return media_memory_used_; }
+
+  /// Kick off fresh loads for components that were just unloaded for
+  /// reloading (as sent back by GraphicsServer::PushComponentReloadCall).
+  void MarkComponentsForReload(
+      const std::vector<Object::Ref<MediaComponentData>*>& components);
   struct PreloadRunnable : public Runnable {
     explicit PreloadRunnable(Object::Ref<MediaComponentData>* c_in) : c(c_in) {}
     void Run() override;
@@ -158,11 +236,28 @@ class Media {
  private:
   Media();
   static void MarkComponentForLoad(MediaComponentData* c);
-  void LoadSystemTexture(SystemTextureID id, const char* name);
-  void LoadSystemCubeMapTexture(SystemCubeMapTextureID id, const char* name);
-  void LoadSystemSound(SystemSoundID id, const char* name);
+  void AddSystemTexture(SystemTextureID id, const char* name);
+  void AddSystemCubeMapTexture(SystemCubeMapTextureID id, const char* name);
+  void AddSystemSound(SystemSoundID id, const char* name);
+  void LoadSystemTexture(SystemTextureID id);
+  void LoadSystemCubeMapTexture(SystemCubeMapTextureID id);
+  void LoadSystemSound(SystemSoundID id);
   void LoadSystemData(SystemDataID id, const char* name);
   void LoadSystemModel(SystemModelID id, const char* name);
+  void GetMediaForNames(
+      const std::vector<std::string>& textures,
+      const std::vector<std::string>& models,
+      const std::vector<std::string>& collide_models,
+      const std::vector<std::string>& sounds,
+      const std::vector<std::string>& datas,
+      std::vector<Object::Ref<MediaComponentData> >* components);
+  void UpdateAsyncLoads();
+  void EvictForMemoryBudget(
+      millisecs_t current_time,
+      std::vector<Object::Ref<MediaComponentData>*>* graphics_unloads);
+  void UpdateTextureResidency(
+      millisecs_t current_time,
+      std::vector<Object::Ref<MediaComponentData>*>* reloads);
 
   template <class T>
   auto GetComponentPendingLoadCount(
@@ -176,6 +271,10 @@ class Media {
       -> Object::Ref<T>;
 
   std::vector<std::string> media_paths_;
+
+  // Archives for our media paths (where present); these are opened at
+  // construction and immutable after that.
+  std::vector<std::unique_ptr<MediaArchive> > archives_;
   bool have_pending_loads_[static_cast<int>(MediaType::kLast)]{};
   std::unordered_map<std::string, std::string> packages_;
 
@@ -185,12 +284,17 @@ class Media {
   // Will be true while a MediaListsLock exists. Good to debug-verify this
   // during any media list access.
   bool media_lists_locked_{};
+  std::atomic<std::thread::id> media_lists_lock_owner_{};
 
   // 'hard-wired' internal media
   bool system_media_loaded_{};
+  bool early_system_media_loaded_{};
   std::vector<Object::Ref<TextureData> > system_textures_;
   std::vector<Object::Ref<TextureData> > system_cube_map_textures_;
   std::vector<Object::Ref<SoundData> > system_sounds_;
+  std::vector<const char*> system_texture_names_;
+  std::vector<const char*> system_cube_map_texture_names_;
+  std::vector<const char*> system_sound_names_;
   std::vector<Object::Ref<DataData> > system_datas_;
   std::vector<Object::Ref<ModelData> > system_models_;
 
@@ -211,6 +315,21 @@ class Media {
   std::vector<Object::Ref<MediaComponentData>*> pending_loads_datas_;
   std::vector<Object::Ref<MediaComponentData>*> pending_loads_other_;
   std::vector<Object::Ref<MediaComponentData>*> pending_loads_done_;
+
+  // Requests from LoadMediaAsync() still waiting on their media
+  // (game thread only).
+  struct AsyncLoad {
+    std::vector<Object::Ref<MediaComponentData> > components;
+    Object::Ref<Runnable> on_loaded;
+  };
+  std::list<AsyncLoad> async_loads_;
+
+  size_t texture_memory_budget_{};
+  size_t texture_memory_resident_{};
+  size_t media_memory_budget_{};
+  size_t media_memory_used_{};
+  size_t media_memory_evictions_{};
+  size_t media_memory_bytes_evicted_{};
 };
 
 }  // namespace ballistica
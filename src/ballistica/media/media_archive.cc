@@ -0,0 +1,130 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/media/media_archive.h"
+
+#include <cstring>
+
+#include "ballistica/media/media.h"
+#include "ballistica/platform/mapped_file.h"
+#include "ballistica/platform/platform.h"
+
+namespace ballistica {
+
+auto MediaArchive::Hash(const char* s, size_t len) -> uint64_t {
+  // 64 bit FNV-1a; must match the archive writer.
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<uint8_t>(s[i]);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+auto MediaArchive::Open(const std::string& media_path)
+    -> std::unique_ptr<MediaArchive> {
+  std::string path = media_path + "/" + kFileName;
+  std::unique_ptr<MediaArchive> archive(new MediaArchive());
+  archive->media_path_ = media_path;
+
+  archive->file_ = MappedFile::Open(path);
+  if (!archive->file_) {
+    return nullptr;
+  }
+  archive->data_ = archive->file_->data();
+  archive->size_ = archive->file_->size();
+
+  uint32_t header[4];
+  if (archive->size_ < sizeof(header)) {
+    throw Exception("Invalid media archive: '" + path + "'");
+  }
+  memcpy(header, archive->data_, sizeof(header));
+  if (header[0] != kMagic || header[1] != kVersion) {
+    throw Exception("Media archive '" + path
+                    + "' is an old format or not a media archive");
+  }
+  archive->entry_count_ = header[2];
+  size_t toc_end =
+      sizeof(header) + sizeof(TOCEntry) * size_t{archive->entry_count_};
+  if (toc_end > archive->size_) {
+    throw Exception("Invalid media archive: '" + path + "'");
+  }
+  archive->toc_ =
+      reinterpret_cast<const TOCEntry*>(archive->data_ + sizeof(header));
+
+  // Verify everything up front so lookups can trust the toc.
+  for (uint32_t i = 0; i < archive->entry_count_; i++) {
+    const TOCEntry& entry = archive->toc_[i];
+    if (entry.offset > archive->size_
+        || entry.size > archive->size_ - entry.offset
+        || size_t{entry.name_offset} + entry.name_size > archive->size_
+        || (i > 0 && archive->toc_[i - 1].hash > entry.hash)) {
+      throw Exception("Corrupt media archive: '" + path + "'");
+    }
+  }
+  return archive;
+}
+
+MediaArchive::~MediaArchive() = default;
+
+auto MediaArchive::Find(const std::string& name, const char** data,
+                        size_t* size) const -> bool {
+  assert(data && size);
+  uint64_t hash = Hash(name.c_str(), name.size());
+
+  // Binary search to the first entry with our hash and then walk any
+  // collisions.
+  uint32_t lo = 0;
+  uint32_t hi = entry_count_;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (toc_[mid].hash < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  for (uint32_t i = lo; i < entry_count_ && toc_[i].hash == hash; i++) {
+    const TOCEntry& entry = toc_[i];
+    if (entry.name_size == name.size()
+        && !memcmp(data_ + entry.name_offset, name.c_str(), name.size())) {
+      *data = data_ + entry.offset;
+      *size = static_cast<size_t>(entry.size);
+      return true;
+    }
+  }
+  return false;
+}
+
+MediaFileReader::MediaFileReader(const std::string& file_name) {
+  if (g_media->FindArchivedFile(file_name, &data_, &size_)) {
+    archived_ = true;
+  } else if ((file_ = MappedFile::Open(file_name))) {
+    data_ = file_->data();
+    size_ = file_->size();
+  } else {
+    data_ = nullptr;
+  }
+}
+
+MediaFileReader::~MediaFileReader() = default;
+
+auto MediaFileReader::Read(void* buffer, size_t size) -> bool {
+  assert(data_);
+  if (size > size_ - position_) {
+    return false;
+  }
+  memcpy(buffer, data_ + position_, size);
+  position_ += size;
+  return true;
+}
+
+auto MediaFileReader::Skip(size_t size) -> bool {
+  assert(data_);
+  if (size > size_ - position_) {
+    return false;
+  }
+  position_ += size;
+  return true;
+}
+
+}  // namespace ballistica
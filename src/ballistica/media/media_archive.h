@@ -0,0 +1,99 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_MEDIA_MEDIA_ARCHIVE_H_
+#define BALLISTICA_MEDIA_MEDIA_ARCHIVE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+// A packed, read-only archive of media files for one media path (written
+// by write_media_archive() in tools/batools/assetstaging.py). The whole file is
+// memory-mapped and entries are looked up through a hash-sorted table of
+// contents, so finding and reading a file costs no syscalls beyond the
+// page faults on its data.
+//
+// Layout (all little-endian):
+//   header:  uint32 magic, uint32 version, uint32 entry_count, uint32 pad
+//   toc:     entry_count x {uint64 hash, uint64 offset, uint64 size,
+//            uint32 name_offset, uint32 name_size}, sorted by hash
+//   names:   relative paths ('models/foo.bob') referenced by the toc
+//   data:    file payloads, each 16 byte aligned
+class MediaArchive {
+ public:
+  static const uint32_t kMagic = 0x4b504142;  // 'BAPK'
+  static const uint32_t kVersion = 1;
+
+  // Archive filename looked for in each media path.
+  static constexpr const char* kFileName = "media.bap";
+
+  // Attempt to open the archive for a media path. Returns nullptr if there
+  // is none; throws an Exception if there is one but it is invalid.
+  static auto Open(const std::string& media_path)
+      -> std::unique_ptr<MediaArchive>;
+
+  ~MediaArchive();
+
+  // Look up a file by path relative to our media path.
+  auto Find(const std::string& name, const char** data, size_t* size) const
+      -> bool;
+
+  auto media_path() const -> const std::string& { return media_path_; }
+
+  static auto Hash(const char* s, size_t len) -> uint64_t;
+
+ private:
+  struct TOCEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t name_offset;
+    uint32_t name_size;
+  };
+  static_assert(sizeof(TOCEntry) == 32, "unexpected toc entry size");
+
+  MediaArchive() = default;
+  std::string media_path_;
+  std::unique_ptr<MappedFile> file_;
+  const char* data_{};
+  size_t size_{};
+  const TOCEntry* toc_{};
+  uint32_t entry_count_{};
+  BA_DISALLOW_CLASS_COPIES(MediaArchive);
+};
+
+// Reads a media file either out of a media archive (when one contains it)
+// or from a mapping of the loose file on disk.
+class MediaFileReader {
+ public:
+  explicit MediaFileReader(const std::string& file_name);
+  ~MediaFileReader();
+
+  // Whether the file could be found/opened.
+  auto is_open() const -> bool { return data_ != nullptr; }
+
+  // Read exactly size bytes; returns false on failure.
+  auto Read(void* buffer, size_t size) -> bool;
+
+  // Skip ahead size bytes; returns false on failure.
+  auto Skip(size_t size) -> bool;
+
+  // Whether we're reading out of a (memory-mapped) archive.
+  auto is_archived() const -> bool { return archived_; }
+
+ private:
+  std::unique_ptr<MappedFile> file_;
+  const char* data_{};
+  size_t size_{};
+  size_t position_{};
+  bool archived_{};
+  BA_DISALLOW_CLASS_COPIES(MediaFileReader);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_MEDIA_MEDIA_ARCHIVE_H_
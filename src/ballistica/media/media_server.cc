@@ -2,6 +2,13 @@
 
 #include "ballistica/media/media_server.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "ballistica/core/event_trace.h"
 #include "ballistica/generic/huffman.h"
 #include "ballistica/generic/timer.h"
 #include "ballistica/generic/utils.h"
@@ -11,6 +18,80 @@
 
 namespace ballistica {
 
+// Workers that do the actual preloading (file reads, decoding, etc.) so that
+// it doesn't all serialize on the media thread. The media thread just feeds
+// them from its pending lists. One worker favors audio so sound decoding
+// runs alongside texture decoding instead of waiting for it.
+class MediaPreloadPool {
+ public:
+  MediaPreloadPool() {
+    // The game, render, audio and bg-dynamics threads all keep cores busy;
+    // use about half of what's there.
+    int count = std::clamp(
+        static_cast<int>(std::thread::hardware_concurrency()) / 2, 1, 4);
+    for (int i = 0; i < count; i++) {
+      threads_.emplace_back([this, i] { Run(i == 0); });
+    }
+  }
+
+  void Push(Object::Ref<MediaComponentData>* c, bool audio) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      (audio ? audio_queue_ : queue_).push_back(c);
+    }
+    cv_.notify_one();
+  }
+
+ private:
+  void Run(bool prefer_audio) {
+    g_platform->SetCurrentThreadName("ballistica media preload");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock,
+               [this] { return !queue_.empty() || !audio_queue_.empty(); });
+      std::deque<Object::Ref<MediaComponentData>*>* queue;
+      if (prefer_audio) {
+        queue = audio_queue_.empty() ? &queue_ : &audio_queue_;
+      } else {
+        queue = queue_.empty() ? &audio_queue_ : &queue_;
+      }
+      Object::Ref<MediaComponentData>* c = queue->front();
+      queue->pop_front();
+      lock.unlock();
+
+      // If someone else has this locked (most likely loading it on demand)
+      // come back to it later instead of stalling.
+      if (!(**c).TryLock()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        lock.lock();
+        queue->push_back(c);
+        continue;
+      }
+      try {
+        MediaComponentData::LockGuard guard(
+            &**c, MediaComponentData::LockGuard::kInheritLock);
+        (**c).Preload(true);
+      } catch (const std::exception& e) {
+        // It'll get another go (and fail properly) when loaded.
+        Log("Error preloading " + (**c).GetName() + ": " + e.what());
+      }
+
+      // Pass the ref-pointer along to the load queue.
+      g_media->AddPendingLoad(c);
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Object::Ref<MediaComponentData>*> queue_;
+  std::deque<Object::Ref<MediaComponentData>*> audio_queue_;
+  std::vector<std::thread> threads_;
+};
+
+// These run for the life of the app.
+static MediaPreloadPool* g_media_preload_pool{};
+
 MediaServer::MediaServer(Thread* thread)
     : Module("media", thread),
       writing_replay_(false),
@@ -194,6 +275,8 @@ void MediaServer::WriteReplayMessages() {
 }
 
 void MediaServer::Process() {
+  BA_TRACE_SCOPE("MediaServer::Process");
+
   // make sure we don't do any loading until we know what kind/quality of
   // textures we'll be loading
   if (!g_media || !g_graphics_server
@@ -202,18 +285,20 @@ void MediaServer::Process() {
     return;
   }
 
-  // process exactly 1 preload item.. empty out our non-audio list first
-  // (audio is less likely to cause noticeable hitches if it needs to be loaded
-  // on-demand, so that's a lower priority for us)
-  if (!pending_preloads_.empty()) {
-    (**pending_preloads_.back()).Preload();
-    // pass the ref-pointer along to the load queue
-    g_media->AddPendingLoad(pending_preloads_.back());
+  // Hand everything off to our preload workers, most recent first (the
+  // workers empty out the non-audio list first too; audio is less likely to
+  // cause noticeable hitches if it needs to be loaded on-demand, so that's a
+  // lower priority for us).
+  if (!g_media_preload_pool
+      && (!pending_preloads_.empty() || !pending_preloads_audio_.empty())) {
+    g_media_preload_pool = new MediaPreloadPool();
+  }
+  while (!pending_preloads_.empty()) {
+    g_media_preload_pool->Push(pending_preloads_.back(), false);
     pending_preloads_.pop_back();
-  } else if (!pending_preloads_audio_.empty()) {
-    (**pending_preloads_audio_.back()).Preload();
-    // pass the ref-pointer along to the load queue
-    g_media->AddPendingLoad(pending_preloads_audio_.back());
+  }
+  while (!pending_preloads_audio_.empty()) {
+    g_media_preload_pool->Push(pending_preloads_audio_.back(), true);
     pending_preloads_audio_.pop_back();
   }
 
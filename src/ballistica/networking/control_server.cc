@@ -0,0 +1,313 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/networking/control_server.h"
+
+#if !BA_OSTYPE_WINDOWS
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ballistica/core/memory_stats.h"
+#include "ballistica/game/connection/connection_set.h"
+#include "ballistica/game/game.h"
+#include "ballistica/game/net_stats.h"
+#include "ballistica/game/telemetry.h"
+#include "ballistica/generic/json_stream.h"
+#include "ballistica/networking/networking_sys.h"
+#include "ballistica/platform/platform.h"
+
+namespace ballistica {
+
+// Longer requests than this get the connection closed.
+const size_t kControlServerMaxLineLength = 65536;
+
+// How long we wait on the game thread before giving up on a request.
+const int kControlServerRequestTimeoutSeconds = 10;
+
+#ifdef MSG_NOSIGNAL
+// Dropped connections shouldn't take us down with SIGPIPE.
+const int kControlServerSendFlags = MSG_NOSIGNAL;
+#else
+const int kControlServerSendFlags = 0;
+#endif
+
+// Pulls the id and method out of a request line.
+class ControlRequestHandler : public JsonReader::Handler {
+ public:
+  auto OnBeginObject() -> bool override {
+    if (depth_ == 0) {
+      is_object_ = true;
+    }
+    depth_++;
+    return true;
+  }
+  auto OnEndObject() -> bool override {
+    depth_--;
+    return true;
+  }
+  auto OnBeginArray() -> bool override {
+    depth_++;
+    return true;
+  }
+  auto OnEndArray() -> bool override {
+    depth_--;
+    return true;
+  }
+  auto OnKey(const std::string& key) -> bool override {
+    if (depth_ == 1) {
+      key_ = key;
+    }
+    return true;
+  }
+  auto OnString(const std::string& val) -> bool override {
+    if (depth_ == 1 && key_ == "method") {
+      method_ = val;
+    } else if (depth_ == 1 && key_ == "id") {
+      id_json_.clear();
+      JsonWriter::AppendString(&id_json_, val.c_str());
+    }
+    return true;
+  }
+  auto OnNumber(double val) -> bool override {
+    if (depth_ == 1 && key_ == "id") {
+      id_json_ = JsonWriter().Number(val).str();
+    }
+    return true;
+  }
+
+  auto is_object() const -> bool { return is_object_; }
+  auto method() const -> const std::string& { return method_; }
+  auto id_json() const -> const std::string& { return id_json_; }
+
+ private:
+  int depth_{};
+  bool is_object_{};
+  std::string key_;
+  std::string method_;
+  std::string id_json_{"null"};
+};
+
+static auto MakeControlError(const std::string& id_json,
+                             const std::string& error) -> std::string {
+  JsonWriter writer;
+  writer.BeginObject()
+      .Key("id")
+      .Raw(id_json)
+      .Key("error")
+      .String(error)
+      .EndObject();
+  return writer.str();
+}
+
+// Runs in the game thread.
+static auto RunControlRequest(const std::string& id_json,
+                              const std::string& method) -> std::string {
+  assert(InGameThread());
+  JsonWriter writer;
+  writer.BeginObject().Key("id").Raw(id_json).Key("result");
+  if (method == "ping") {
+    writer.String("pong");
+  } else if (method == "stats") {
+    writer.BeginObject()
+        .Key("uptime_seconds")
+        .Number(static_cast<double>(g_platform->GetTicks()) * 0.001)
+        .Key("clients")
+        .Int(static_cast<int64_t>(
+            g_game->connections()->GetConnectionsToClients().size()))
+        .Key("party")
+        .BeginObject()
+        .Key("name")
+        .String(g_game->public_party_name())
+        .Key("public")
+        .Bool(g_game->public_party_enabled())
+        .Key("size")
+        .Int(g_game->public_party_size())
+        .Key("max_size")
+        .Int(g_game->public_party_max_size())
+        .Key("player_count")
+        .Int(g_game->public_party_player_count())
+        .EndObject()
+        .Key("load");
+    Telemetry::WriteStatsJson(&writer);
+    writer.Key("memory");
+    MemoryStats::WriteStatsJson(&writer);
+    writer.EndObject();
+  } else if (method == "roster") {
+    writer.Raw(g_game->GetGameRosterJson());
+  } else if (method == "net_stats") {
+    writer.Raw(NetStats::GetStatsJson(false));
+  } else if (method == "telemetry") {
+    writer.String(Telemetry::GetPrometheusText());
+  } else {
+    return MakeControlError(id_json, "Unknown method: '" + method + "'");
+  }
+  writer.EndObject();
+  return writer.str();
+}
+
+struct ControlRequestState {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done{};
+  std::string response;
+};
+
+// Handle one request line (in our thread); returns the response line.
+static auto HandleControlLine(const std::string& line) -> std::string {
+  ControlRequestHandler handler;
+  if (!JsonReader::Parse(line.c_str(), &handler) || !handler.is_object()) {
+    return MakeControlError("null", "Malformed request.");
+  }
+  std::string id_json = handler.id_json();
+  std::string method = handler.method();
+  if (g_game == nullptr) {
+    return MakeControlError(id_json, "Not ready.");
+  }
+
+  // Answer on the game thread, but do our socket writing here so a slow
+  // client can't stall it.
+  auto state = std::make_shared<ControlRequestState>();
+  g_game->PushCall([state, id_json, method] {
+    std::string response;
+    try {
+      response = RunControlRequest(id_json, method);
+    } catch (const std::exception& e) {
+      response = MakeControlError(id_json, e.what());
+    }
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->response = std::move(response);
+      state->done = true;
+    }
+    state->cv.notify_one();
+  });
+  std::unique_lock<std::mutex> lock(state->mutex);
+  if (!state->cv.wait_for(
+          lock, std::chrono::seconds(kControlServerRequestTimeoutSeconds),
+          [&state] { return state->done; })) {
+    return MakeControlError(id_json, "Timed out.");
+  }
+  return state->response;
+}
+
+#if !BA_OSTYPE_WINDOWS
+
+static auto SendAll(int sd, const std::string& data) -> bool {
+  size_t sent{};
+  while (sent < data.size()) {
+    auto result = send(sd, data.data() + sent, data.size() - sent,
+                       kControlServerSendFlags);
+    if (result <= 0) {
+      return false;
+    }
+    sent += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+static void ServeControlClient(int client_sd) {
+#ifdef SO_NOSIGPIPE
+  int on = 1;
+  setsockopt(client_sd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+  std::string pending;
+  char buffer[4096];
+  while (true) {
+    auto result = recv(client_sd, buffer, sizeof(buffer), 0);
+    if (result <= 0) {
+      return;
+    }
+    pending.append(buffer, static_cast<size_t>(result));
+
+    // Answer each complete line.
+    size_t start{};
+    size_t end;
+    while ((end = pending.find('\n', start)) != std::string::npos) {
+      std::string line = pending.substr(start, end - start);
+      start = end + 1;
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+      if (line.empty()) {
+        continue;
+      }
+      if (!SendAll(client_sd, HandleControlLine(line) + "\n")) {
+        return;
+      }
+    }
+    pending.erase(0, start);
+    if (pending.size() > kControlServerMaxLineLength) {
+      SendAll(client_sd, MakeControlError("null", "Request too long.") + "\n");
+      return;
+    }
+  }
+}
+
+static void RunControlServer(const std::string& path) {
+  // Keep serving; if something goes wrong we just start over.
+  while (true) {
+    int sd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sd < 0) {
+      Log("Error: Unable to open control socket; errno "
+          + std::to_string(errno));
+      return;
+    }
+    struct sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(path.c_str());
+    if (::bind(sd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr))
+            != 0
+        || chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0
+        || listen(sd, 8) != 0) {
+      Log("Error: Unable to serve control socket at '" + path + "'; errno "
+          + std::to_string(errno));
+      g_platform->CloseSocket(sd);
+      return;
+    }
+    while (true) {
+      int client_sd = accept(sd, nullptr, nullptr);
+      if (client_sd < 0) {
+        break;
+      }
+      ServeControlClient(client_sd);
+      g_platform->CloseSocket(client_sd);
+    }
+    g_platform->CloseSocket(sd);
+
+    // Keep from running wild if accept keeps failing.
+    Platform::SleepMS(1000);
+  }
+}
+
+#endif  // !BA_OSTYPE_WINDOWS
+
+void ControlServer::Start(const std::string& path) {
+  static bool started{};
+  if (started) {
+    throw Exception("The control server is already running.");
+  }
+#if BA_OSTYPE_WINDOWS
+  throw Exception("Control sockets are not supported on this platform.");
+#else
+  struct sockaddr_un addr {};
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    throw Exception("Invalid control socket path: '" + path + "'.",
+                    PyExcType::kValue);
+  }
+  started = true;
+
+  // Serves for the life of the app.
+  std::thread(RunControlServer, path).detach();
+#endif
+}
+
+}  // namespace ballistica
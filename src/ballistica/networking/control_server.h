@@ -0,0 +1,29 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_NETWORKING_CONTROL_SERVER_H_
+#define BALLISTICA_NETWORKING_CONTROL_SERVER_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Answers json-lines queries over a Unix domain socket, so orchestration
+/// can cheaply poll servers for stats without pushing Python through the
+/// telnet/stdin command channels. Each request is a line such as
+/// {"id": 1, "method": "stats"} and gets back a line with the same id and
+/// either a "result" or an "error". Methods are 'ping', 'stats' (uptime,
+/// party and load info), 'roster' (the party roster), 'net_stats'
+/// (NetStats' per-connection percentiles) and 'telemetry' (Telemetry's
+/// Prometheus text).
+class ControlServer {
+ public:
+  /// Start serving at path (replacing any stale socket there). The socket
+  /// is only accessible to our user.
+  static void Start(const std::string& path);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_NETWORKING_CONTROL_SERVER_H_
@@ -0,0 +1,97 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/platform/mapped_file.h"
+
+#if BA_OSTYPE_WINDOWS
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+
+#include "ballistica/platform/platform.h"
+
+namespace ballistica {
+
+auto MappedFile::Open(const std::string& path) -> std::unique_ptr<MappedFile> {
+  std::unique_ptr<MappedFile> file(new MappedFile());
+
+#if BA_OSTYPE_WINDOWS
+  // Go through FOpen so we get its utf-8 path handling.
+  FILE* f = g_platform->FOpen(path.c_str(), "rb");
+  if (f == nullptr) {
+    return nullptr;
+  }
+  auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(f)));
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(handle, &file_size)) {
+    fclose(f);
+    return nullptr;
+  }
+  file->size_ = static_cast<size_t>(file_size.QuadPart);
+
+  // (Empty files can't be mapped; they just get our empty view).
+  if (file->size_ > 0) {
+    HANDLE mapping =
+        CreateFileMapping(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)
+                         : nullptr;
+
+    // The view stays valid after the handles go away.
+    if (mapping) {
+      CloseHandle(mapping);
+    }
+    if (data == nullptr) {
+      fclose(f);
+      return nullptr;
+    }
+    file->data_ = static_cast<const char*>(data);
+    file->mapped_ = true;
+  }
+  fclose(f);
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat stats {};
+  if (fstat(fd, &stats) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  file->size_ = static_cast<size_t>(stats.st_size);
+
+  // (Empty files can't be mapped; they just get our empty view).
+  if (file->size_ > 0) {
+    void* data = mmap(nullptr, file->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      close(fd);
+      return nullptr;
+    }
+    file->data_ = static_cast<const char*>(data);
+    file->mapped_ = true;
+  }
+
+  // The mapping stays valid after the descriptor goes away.
+  close(fd);
+#endif
+  return file;
+}
+
+MappedFile::~MappedFile() {
+  if (!mapped_) {
+    return;
+  }
+#if BA_OSTYPE_WINDOWS
+  UnmapViewOfFile(data_);
+#else
+  munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+}  // namespace ballistica
@@ -0,0 +1,37 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_PLATFORM_MAPPED_FILE_H_
+#define BALLISTICA_PLATFORM_MAPPED_FILE_H_
+
+#include <memory>
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// A read-only view of a whole file mapped into memory, so loaders can
+/// parse it in place without read calls or copies into intermediate
+/// buffers; pages come in from disk as they're first touched. The view
+/// stays valid for the life of the object. Safe to use from any thread.
+class MappedFile {
+ public:
+  /// Map the file at path (a utf-8 path as with Platform::FOpen()).
+  /// Returns nullptr if it can't be opened or mapped.
+  static auto Open(const std::string& path) -> std::unique_ptr<MappedFile>;
+  ~MappedFile();
+
+  auto data() const -> const char* { return data_; }
+  auto size() const -> size_t { return size_; }
+
+ private:
+  MappedFile() = default;
+  const char* data_{""};
+  size_t size_{};
+  bool mapped_{};
+  BA_DISALLOW_CLASS_COPIES(MappedFile);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_PLATFORM_MAPPED_FILE_H_
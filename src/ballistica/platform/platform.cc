@@ -574,6 +574,108 @@ static void HandleArgs(int argc, char** argv) {
         fflush(stdout);
         exit(-1);
       }
+    } else if (!strcmp(argv[i], "-turbo")) {
+      if (g_buildconfig.headless_build()) {
+        g_app_globals->turbo_mode = true;
+      } else {
+        printf("%s", "Warning: -turbo is only supported in headless builds\n");
+        fflush(stdout);
+      }
+    } else if (!strcmp(argv[i], "-noidlepause")) {
+      g_app_globals->headless_idle_pause = false;
+    } else if (!strcmp(argv[i], "-physicsthreads")) {
+      int count{};
+      if (i + 1 < argc) {
+        count = atoi(argv[i + 1]);  // NOLINT
+      }
+      if (count < 1) {
+        printf("%s", "Error: expected count arg after -physicsthreads\n");
+        fflush(stdout);
+        exit(-1);
+      }
+      g_app_globals->physics_island_threads = count;
+    } else if (!strcmp(argv[i], "-physicsiterations")) {
+      int count{};
+      if (i + 1 < argc) {
+        count = atoi(argv[i + 1]);  // NOLINT
+      }
+      if (count < 1) {
+        printf("%s", "Error: expected count arg after -physicsiterations\n");
+        fflush(stdout);
+        exit(-1);
+      }
+      g_app_globals->physics_solver_iterations = count;
+    } else if (!strcmp(argv[i], "-physicssor")) {
+      float val{};
+      if (i + 1 < argc) {
+        val = static_cast<float>(atof(argv[i + 1]));  // NOLINT
+      }
+      if (val <= 0.0f || val >= 2.0f) {
+        printf("%s",
+               "Error: expected value between 0 and 2 after -physicssor\n");
+        fflush(stdout);
+        exit(-1);
+      }
+      g_app_globals->physics_solver_sor = val;
+    } else if (!strcmp(argv[i], "-capture")) {
+      if (g_buildconfig.headless_build()) {
+        printf("%s", "Error: -capture is not supported in headless builds\n");
+        fflush(stdout);
+        exit(-1);
+      }
+      if (i + 1 < argc) {
+        g_app_globals->capture_path = argv[i + 1];
+      } else {
+        printf("%s", "Error: expected path arg after -capture\n");
+        fflush(stdout);
+        exit(-1);
+      }
+    } else if (!strcmp(argv[i], "-capturefps")) {
+      int fps{};
+      if (i + 1 < argc) {
+        fps = atoi(argv[i + 1]);  // NOLINT
+      }
+      if (fps < 1 || fps > 1000) {
+        printf("%s", "Error: expected fps between 1 and 1000 after"
+                     " -capturefps\n");
+        fflush(stdout);
+        exit(-1);
+      }
+      g_app_globals->capture_fps = fps;
+    } else if (!strcmp(argv[i], "-interpolate")) {
+      g_app_globals->physics_render_interpolation = true;
+    } else if (!strcmp(argv[i], "-writebgcaches")) {
+      g_app_globals->write_bg_terrain_caches = true;
+    } else if (!strcmp(argv[i], "-broadphase")) {
+      const char* val = (i + 1 < argc) ? argv[i + 1] : "";
+      if (!strcmp(val, "hash")) {
+        g_app_globals->physics_broadphase = PhysicsBroadphase::kHash;
+      } else if (!strcmp(val, "sap")) {
+        g_app_globals->physics_broadphase = PhysicsBroadphase::kSweepAndPrune;
+      } else if (!strcmp(val, "quadtree")) {
+        g_app_globals->physics_broadphase = PhysicsBroadphase::kQuadTree;
+      } else {
+        printf("%s",
+               "Error: expected hash, sap, or quadtree after -broadphase\n");
+        fflush(stdout);
+        exit(-1);
+      }
+    } else if (!strcmp(argv[i], "-benchmark")) {
+      // Runs a benchmark, writes its results, and exits.
+      const char* val = (i + 1 < argc) ? argv[i + 1] : "";
+      if (strcmp(val, "cpu") != 0 && strcmp(val, "gpu") != 0
+          && strcmp(val, "micro") != 0) {
+        printf("%s", "Error: expected cpu, gpu, or micro after -benchmark\n");
+        fflush(stdout);
+        exit(-1);
+      }
+      if (g_buildconfig.headless_build() && strcmp(val, "micro") != 0) {
+        printf("%s", "Warning: -benchmark needs a build with graphics\n");
+        fflush(stdout);
+      }
+      g_app_globals->exec_command =
+          std::string("import ba.internal; ba.internal.run_") + val
+          + "_benchmark(exit_when_done=True)";
     } else if (!strcmp(argv[i], "--crash")) {
       int* invalid_ptr{&dummyval};
 
@@ -4,6 +4,8 @@
 
 #include "ballistica/platform/sdl/sdl_app.h"
 
+#include <thread>
+
 #include "ballistica/core/thread.h"
 #include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/game/game.h"
@@ -27,24 +29,7 @@ void SDLApp::HandleSDLEvent(const SDL_Event& event) {
     case SDL_JOYBUTTONUP:
     case SDL_JOYBALLMOTION:
     case SDL_JOYHATMOTION: {
-      // It seems that joystick connection/disconnection callbacks can fire
-      // while there are still events for that joystick in the queue.
-      // So take care to ignore events for no-longer-existing joysticks.
-      assert(event.jaxis.which == event.jbutton.which
-             && event.jaxis.which == event.jhat.which);
-      if (static_cast<size_t>(event.jbutton.which) >= sdl_joysticks_.size()
-          || sdl_joysticks_[event.jbutton.which] == nullptr) {
-        return;
-      }
-      Joystick* js = GetSDLJoyStickInput(&event);
-      if (js) {
-        if (g_input) {
-          g_input->PushJoystickEvent(event, js);
-        }
-      } else {
-        Log("Error: Unable to get SDL Joystick for event type "
-            + std::to_string(event.type));
-      }
+      HandleSDLJoystickEvent(event);
       break;
     }
 
@@ -347,12 +332,78 @@ SDLApp::SDLApp(Thread* thread) : App(thread) {
   }
 }
 
+auto SDLApp::HandleSDLJoystickEvent(const SDL_Event& event) -> void {
+  std::lock_guard<std::mutex> lock(sdl_joysticks_mutex_);
+
+  // It seems that joystick connection/disconnection callbacks can fire
+  // while there are still events for that joystick in the queue.
+  // So take care to ignore events for no-longer-existing joysticks.
+  assert(event.jaxis.which == event.jbutton.which
+         && event.jaxis.which == event.jhat.which);
+  if (static_cast<size_t>(event.jbutton.which) >= sdl_joysticks_.size()
+      || sdl_joysticks_[event.jbutton.which] == nullptr) {
+    return;
+  }
+
+  // Note that we push while still holding the lock so this can't land in
+  // the game thread after the removal of its joystick.
+  Joystick* js = GetSDLJoyStickInput(&event);
+  if (js) {
+    if (g_input) {
+      g_input->PushJoystickEvent(event, js);
+    }
+  } else {
+    Log("Error: Unable to get SDL Joystick for event type "
+        + std::to_string(event.type));
+  }
+}
+
+auto SDLApp::RunJoystickInputThread() -> void {
+  // Sample often enough that sticks and buttons reach the game thread well
+  // within a frame regardless of how long the main thread is tied up.
+  const millisecs_t sample_interval{2};
+  SDL_Event events[32];
+  while (true) {
+    SDL_JoystickUpdate();
+    int count;
+    while ((count = SDL_PeepEvents(events, 32, SDL_GETEVENT, SDL_JOYAXISMOTION,
+                                   SDL_JOYBUTTONUP))
+           > 0) {
+      for (int i = 0; i < count; ++i) {
+        HandleSDLJoystickEvent(events[i]);
+      }
+    }
+    Platform::SleepMS(sample_interval);
+  }
+}
+
 void SDLApp::RunEvents() {
   App::RunEvents();
+  PumpEvents();
+}
 
-  // Now run all pending SDL events until we run out or we're told to quit.
+auto SDLApp::PumpEvents() -> void {
+  assert(InMainThread());
+
+  // Run all pending SDL events until we run out or we're told to quit.
   SDL_Event event;
-  while (SDL_PollEvent(&event) && (!done())) {
+  if (!joystick_input_thread_) {
+    while (SDL_PollEvent(&event) && (!done())) {
+      HandleSDLEvent(event);
+    }
+    return;
+  }
+
+  // Joystick data events belong to the input thread; we take everything on
+  // either side of them (keeping order within each side).
+  SDL_PumpEvents();
+  while (!done()
+         && (SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_FIRSTEVENT,
+                            SDL_JOYAXISMOTION - 1)
+                 > 0
+             || SDL_PeepEvents(&event, 1, SDL_GETEVENT, SDL_JOYBUTTONUP + 1,
+                               SDL_LASTEVENT)
+                    > 0)) {
     HandleSDLEvent(event);
   }
 }
@@ -414,6 +465,13 @@ void SDLApp::SwapBuffers() {
   assert(thread()->IsCurrent());
   DoSwap();
 
+  // Swapping can block for a good part of a frame waiting on vsync; get
+  // anything that came in meanwhile on its way now instead of at our next
+  // event-loop pass.
+  if (UsesEventLoop()) {
+    PumpEvents();
+  }
+
   // FIXME: Move this somewhere reasonable. Not here.
   // On mac/ios we wanna delay our game-center login until we've drawn a few
   // frames, so lets do that here.
@@ -504,6 +562,23 @@ void SDLApp::OnBootstrapComplete() {
       // We want events from joysticks.
       SDL_JoystickEventState(SDL_ENABLE);
     }
+
+    // When we're running our own event loop, sample joysticks from their
+    // own thread instead of whenever the main thread gets around to it.
+    // (Mac joystick backends want their updates on the main thread so we
+    // leave things be there).
+#if BA_SDL2_BUILD && BA_ENABLE_SDL_JOYSTICKS
+    if (UsesEventLoop() && !g_buildconfig.ostype_macos()) {
+#ifdef SDL_HINT_AUTO_UPDATE_JOYSTICKS
+      // Main-thread pumping no longer needs to poll joysticks.
+      SDL_SetHint(SDL_HINT_AUTO_UPDATE_JOYSTICKS, "0");
+#endif
+      joystick_input_thread_ = true;
+
+      // Serves for the life of the app.
+      std::thread([this] { RunJoystickInputThread(); }).detach();
+    }
+#endif
   }
 }
 
@@ -549,6 +624,7 @@ void SDLApp::AddSDLInputDevice(Joystick* input, int index) {
   assert(index >= 0);
 
   // Keep a mapping of SDL input-device indices to Joysticks.
+  std::lock_guard<std::mutex> lock(sdl_joysticks_mutex_);
   if (static_cast_check_fit<int>(sdl_joysticks_.size()) <= index) {
     sdl_joysticks_.resize(static_cast<size_t>(index) + 1, nullptr);
   }
@@ -560,6 +636,7 @@ void SDLApp::AddSDLInputDevice(Joystick* input, int index) {
 void SDLApp::RemoveSDLInputDevice(int index) {
   assert(InMainThread());
   assert(index >= 0);
+  std::lock_guard<std::mutex> lock(sdl_joysticks_mutex_);
   Joystick* j = GetSDLJoyStickInput(index);
   assert(j);
   if (static_cast_check_fit<int>(sdl_joysticks_.size()) > index) {
@@ -573,7 +650,6 @@ void SDLApp::RemoveSDLInputDevice(int index) {
 }
 
 auto SDLApp::GetSDLJoyStickInput(const SDL_Event* e) const -> Joystick* {
-  assert(InMainThread());
   int joy_id;
 
   // Attempt to pull the joystick id from the event.
@@ -598,7 +674,6 @@ auto SDLApp::GetSDLJoyStickInput(const SDL_Event* e) const -> Joystick* {
 }
 
 auto SDLApp::GetSDLJoyStickInput(int sdl_joystick_id) const -> Joystick* {
-  assert(InMainThread());
   for (auto sdl_joystick : sdl_joysticks_) {
     if ((sdl_joystick != nullptr) && (*sdl_joystick).sdl_joystick_id() >= 0
         && (*sdl_joystick).sdl_joystick_id() == sdl_joystick_id)
@@ -5,6 +5,7 @@
 
 #if BA_SDL_BUILD
 
+#include <mutex>
 #include <vector>
 
 #include "ballistica/app/app.h"
@@ -34,11 +35,22 @@ class SDLApp : public App {
 
  private:
   // Given an sdl joystick ID, returns our ballistica input for it.
+  // Outside of the main thread, sdl_joysticks_mutex_ must be held.
   auto GetSDLJoyStickInput(int sdl_joystick_id) const -> Joystick*;
 
   // The same but using sdl events.
   auto GetSDLJoyStickInput(const SDL_Event* e) const -> Joystick*;
 
+  // Handle whatever SDL events are pending in the main thread.
+  auto PumpEvents() -> void;
+
+  // Joystick data events get sampled and forwarded to the game thread from
+  // a thread of their own when we run our own event loop, so stick and
+  // button input never waits on rendering or vsync. These are safe to call
+  // from either thread.
+  auto RunJoystickInputThread() -> void;
+  auto HandleSDLJoystickEvent(const SDL_Event& event) -> void;
+
   auto DoSwap() -> void;
   auto SwapBuffers() -> void;
   auto UpdateAutoVSync(int diff) -> void;
@@ -52,8 +64,13 @@ class SDLApp : public App {
   float average_vsync_fps_{60.0f};
   int vsync_good_frame_count_{};
   int vsync_bad_frame_count_{};
+  bool joystick_input_thread_{};
   std::vector<Joystick*> sdl_joysticks_;
 
+  // Held when changing sdl_joysticks_ or reading it outside the main
+  // thread.
+  std::mutex sdl_joysticks_mutex_;
+
   /// This is in points; not pixels.
   Vector2f screen_dimensions_{1.0f, 1.0f};
 };
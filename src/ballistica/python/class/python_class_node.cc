@@ -3,9 +3,15 @@
 #include "ballistica/python/class/python_class_node.h"
 
 #include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+#include "ballistica/app/app_globals.h"
 #include "ballistica/game/game_stream.h"
 #include "ballistica/python/python.h"
+#include "ballistica/scene/node/node_attribute.h"
+#include "ballistica/scene/node/node_type.h"
 #include "ballistica/scene/scene.h"
 
 namespace ballistica {
@@ -133,6 +139,39 @@ auto PythonClassNode::tp_repr(PythonClassNode* self) -> PyObject* {
   BA_PYTHON_CATCH;
 }
 
+// Plain 'node.foo' access hands us interned name strings, so we map those
+// straight to each node type's attr; the usual path would build a string
+// and hash it (twice). We hold refs to the names so they can't go away
+// and be reused at the same address.
+static std::unordered_map<PyObject*, std::vector<NodeAttributeUnbound*> >*
+    g_node_attrs_by_interned_name{};
+
+auto PythonClassNode::LookUpAttribute(NodeType* node_type, PyObject* attr)
+    -> NodeAttributeUnbound* {
+  assert(InGameThread());
+  if (!PyUnicode_CHECK_INTERNED(attr)) {
+    return node_type->GetAttribute(PyUnicode_AsUTF8(attr), false);
+  }
+  if (g_node_attrs_by_interned_name == nullptr) {
+    g_node_attrs_by_interned_name = new std::unordered_map<
+        PyObject*, std::vector<NodeAttributeUnbound*> >();
+  }
+  auto i = g_node_attrs_by_interned_name->find(attr);
+  if (i == g_node_attrs_by_interned_name->end()) {
+    // First time seeing this name; look it up on all types at once.
+    std::string name = PyUnicode_AsUTF8(attr);
+    std::vector<NodeAttributeUnbound*> attrs(
+        g_app_globals->node_types_by_id.size());
+    for (auto&& type : g_app_globals->node_types_by_id) {
+      attrs.at(static_cast<size_t>(type.first)) =
+          type.second->GetAttribute(name, false);
+    }
+    Py_INCREF(attr);
+    i = g_node_attrs_by_interned_name->emplace(attr, std::move(attrs)).first;
+  }
+  return i->second[node_type->id()];
+}
+
 auto PythonClassNode::tp_getattro(PythonClassNode* self, PyObject* attr)
     -> PyObject* {
   BA_PYTHON_TRY;
@@ -143,12 +182,13 @@ auto PythonClassNode::tp_getattro(PythonClassNode* self, PyObject* attr)
   // If our node exists and has this attr, return it.
   // Otherwise do default python path.
   Node* node = self->node_->get();
-  const char* attr_name = PyUnicode_AsUTF8(attr);
-  if (node && node->HasAttribute(attr_name)) {
-    return Python::GetNodeAttr(node, attr_name);
-  } else {
-    return PyObject_GenericGetAttr(reinterpret_cast<PyObject*>(self), attr);
+  if (node) {
+    if (NodeAttributeUnbound* node_attr =
+            LookUpAttribute(node->type(), attr)) {
+      return Python::GetNodeAttr(NodeAttribute(node, node_attr));
+    }
   }
+  return PyObject_GenericGetAttr(reinterpret_cast<PyObject*>(self), attr);
   BA_PYTHON_CATCH;
 }
 
@@ -312,9 +352,9 @@ auto PythonClassNode::ConnectAttr(PythonClassNode* self, PyObject* args)
   if (!node) {
     throw Exception(PyExcType::kNodeNotFound);
   }
-  char *src_attr_name, *dst_attr_name;
-  if (!PyArg_ParseTuple(args, "sOs", &src_attr_name, &dst_node_obj,
-                        &dst_attr_name)) {
+  PyObject *src_attr_obj, *dst_attr_obj;
+  if (!PyArg_ParseTuple(args, "UOU", &src_attr_obj, &dst_node_obj,
+                        &dst_attr_obj)) {
     return nullptr;
   }
 
@@ -323,10 +363,17 @@ auto PythonClassNode::ConnectAttr(PythonClassNode* self, PyObject* args)
   if (!dst_node) {
     throw Exception(PyExcType::kNodeNotFound);
   }
-  NodeAttributeUnbound* src_attr =
-      node->type()->GetAttribute(std::string(src_attr_name));
+  // (Literal names come in interned so these usually skip string work;
+  // misses go through the regular lookup to get its not-found error).
+  NodeAttributeUnbound* src_attr = LookUpAttribute(node->type(), src_attr_obj);
+  if (!src_attr) {
+    src_attr = node->type()->GetAttribute(PyUnicode_AsUTF8(src_attr_obj));
+  }
   NodeAttributeUnbound* dst_attr =
-      dst_node->type()->GetAttribute(std::string(dst_attr_name));
+      LookUpAttribute(dst_node->type(), dst_attr_obj);
+  if (!dst_attr) {
+    dst_attr = dst_node->type()->GetAttribute(PyUnicode_AsUTF8(dst_attr_obj));
+  }
 
   // Push to output_stream first to catch scene mismatch errors.
   if (GameStream* output_stream = node->scene()->GetGameStream()) {
@@ -376,7 +423,12 @@ auto PythonClassNode::tp_setattro(PythonClassNode* self, PyObject* attr,
   if (!n) {
     throw Exception(PyExcType::kNodeNotFound);
   }
-  Python::SetNodeAttr(n, PyUnicode_AsUTF8(attr), val);
+  if (NodeAttributeUnbound* node_attr = LookUpAttribute(n->type(), attr)) {
+    Python::SetNodeAttr(NodeAttribute(n, node_attr), val);
+  } else {
+    // (This gives the standard not-found error).
+    Python::SetNodeAttr(n, PyUnicode_AsUTF8(attr), val);
+  }
   return 0;
   BA_PYTHON_INT_CATCH;
 }
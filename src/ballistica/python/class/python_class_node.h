@@ -20,6 +20,11 @@ class PythonClassNode : public PythonClass {
   static PyTypeObject type_obj;
   auto GetNode(bool doraise = true) const -> Node*;
 
+  /// Look up an attr by Python name string (fast for interned names).
+  /// Returns nullptr if the type has no such attr.
+  static auto LookUpAttribute(NodeType* node_type, PyObject* attr)
+      -> NodeAttributeUnbound*;
+
  private:
   static auto tp_new(PyTypeObject* type, PyObject* args, PyObject* keywds)
       -> PyObject*;
@@ -18,6 +18,35 @@ namespace ballistica {
 
 static const int kMemberCount = 3;
 
+// Dead instances we hang on to for reuse.
+static const int kMaxFreeVec3s = 256;
+static PythonClassVec3* g_free_vec3s[kMaxFreeVec3s];
+static int g_free_vec3_count{};
+
+// Pull a float out of a number, taking fast paths for exact floats/ints.
+// Returns false if the object is not a number.
+static auto GetVec3Scalar(PyObject* o, float* val) -> bool {
+  if (PyFloat_CheckExact(o)) {
+    *val = static_cast<float>(PyFloat_AS_DOUBLE(o));
+    return true;
+  }
+  if (PyLong_CheckExact(o)) {
+    double dval = PyLong_AsDouble(o);
+
+    // (on overflow let the general path below deal with it)
+    if (dval != -1.0 || !PyErr_Occurred()) {
+      *val = static_cast<float>(dval);
+      return true;
+    }
+    PyErr_Clear();
+  }
+  if (PyNumber_Check(o)) {
+    *val = Python::GetPyFloat(o);
+    return true;
+  }
+  return false;
+}
+
 PyTypeObject PythonClassVec3::type_obj;
 PySequenceMethods PythonClassVec3::as_sequence_;
 PyNumberMethods PythonClassVec3::as_number_;
@@ -49,6 +78,7 @@ void PythonClassVec3::SetupType(PyTypeObject* obj) {
       "      The vector's Z component.\n";
 
   obj->tp_new = tp_new;
+  obj->tp_dealloc = (destructor)tp_dealloc;
   obj->tp_repr = (reprfunc)tp_repr;
   obj->tp_methods = tp_methods;
   obj->tp_getattro = (getattrofunc)tp_getattro;
@@ -68,15 +98,35 @@ void PythonClassVec3::SetupType(PyTypeObject* obj) {
   as_number_.nb_subtract = (binaryfunc)nb_subtract;
   as_number_.nb_multiply = (binaryfunc)nb_multiply;
   as_number_.nb_negative = (unaryfunc)nb_negative;
+
+  // Vec3s are mutable anyway, so in-place ops modify the vector itself
+  // instead of allocating a new one.
+  as_number_.nb_inplace_add = (binaryfunc)nb_inplace_add;
+  as_number_.nb_inplace_subtract = (binaryfunc)nb_inplace_subtract;
+  as_number_.nb_inplace_multiply = (binaryfunc)nb_inplace_multiply;
   obj->tp_as_number = &as_number_;
+}
+
+auto PythonClassVec3::Alloc() -> PythonClassVec3* {
+  if (g_free_vec3_count > 0) {
+    PythonClassVec3* obj = g_free_vec3s[--g_free_vec3_count];
+    PyObject_Init(reinterpret_cast<PyObject*>(obj), &type_obj);
+    return obj;
+  }
+  return reinterpret_cast<PythonClassVec3*>(type_obj.tp_alloc(&type_obj, 0));
+}
 
-  // Note: we could fill out the in-place versions of these
-  // if we're not going for immutability..
+void PythonClassVec3::tp_dealloc(PythonClassVec3* self) {
+  // Only exact Vec3s get recycled; subclass instances may be bigger.
+  if (Py_TYPE(self) == &type_obj && g_free_vec3_count < kMaxFreeVec3s) {
+    g_free_vec3s[g_free_vec3_count++] = self;
+    return;
+  }
+  Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
 }
 
 auto PythonClassVec3::Create(const Vector3f& val) -> PyObject* {
-  auto obj =
-      reinterpret_cast<PythonClassVec3*>(type_obj.tp_alloc(&type_obj, 0));
+  auto obj = Alloc();
   if (obj) {
     obj->value = val;
   }
@@ -85,7 +135,10 @@ auto PythonClassVec3::Create(const Vector3f& val) -> PyObject* {
 
 auto PythonClassVec3::tp_new(PyTypeObject* type, PyObject* args,
                              PyObject* keywds) -> PyObject* {
-  auto self = reinterpret_cast<PythonClassVec3*>(type->tp_alloc(type, 0));
+  auto self =
+      type == &type_obj
+          ? Alloc()
+          : reinterpret_cast<PythonClassVec3*>(type->tp_alloc(type, 0));
   if (self) {
     BA_PYTHON_TRY;
 
@@ -108,11 +161,13 @@ auto PythonClassVec3::tp_new(PyTypeObject* type, PyObject* args,
       self->value.x = self->value.y = self->value.z = val;
     } else {
       // Otherwise interpret as individual x, y, z float vals defaulting to 0.
+      // (recycled instances aren't zeroed, so start from scratch)
+      self->value = Vector3f(0.0f, 0.0f, 0.0f);
       static const char* kwlist[] = {"x", "y", "z", nullptr};
       if (!PyArg_ParseTupleAndKeywords(
               args, keywds, "|fff", const_cast<char**>(kwlist), &self->value.x,
               &self->value.y, &self->value.z)) {
-        Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+        Py_DECREF(self);
         return nullptr;
       }
     }
@@ -197,10 +252,9 @@ auto PythonClassVec3::nb_multiply(PyObject* l, PyObject* r) -> PyObject* {
   // If left side is vec3.
   if (Check(l)) {
     // Try right as single number.
-    if (Python::CanGetPyDouble(r)) {
-      assert(Check(l));
-      return Create(reinterpret_cast<PythonClassVec3*>(l)->value
-                    * Python::GetPyFloat(r));
+    float val;
+    if (GetVec3Scalar(r, &val)) {
+      return Create(reinterpret_cast<PythonClassVec3*>(l)->value * val);
     }
 
     // Try right as a vec3-able value.
@@ -215,10 +269,9 @@ auto PythonClassVec3::nb_multiply(PyObject* l, PyObject* r) -> PyObject* {
     assert(Check(r));
 
     // Try left as single value.
-    if (Python::CanGetPyDouble(l)) {
-      assert(Check(r));
-      return Create(Python::GetPyFloat(l)
-                    * reinterpret_cast<PythonClassVec3*>(r)->value);
+    float val;
+    if (GetVec3Scalar(l, &val)) {
+      return Create(val * reinterpret_cast<PythonClassVec3*>(r)->value);
     }
 
     // Try left as a vec3-able value.
@@ -236,6 +289,44 @@ auto PythonClassVec3::nb_multiply(PyObject* l, PyObject* r) -> PyObject* {
   BA_PYTHON_CATCH;
 }
 
+auto PythonClassVec3::nb_inplace_add(PythonClassVec3* self, PyObject* other)
+    -> PyObject* {
+  if (!Check(other)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+  self->value += reinterpret_cast<PythonClassVec3*>(other)->value;
+  Py_INCREF(self);
+  return reinterpret_cast<PyObject*>(self);
+}
+
+auto PythonClassVec3::nb_inplace_subtract(PythonClassVec3* self,
+                                          PyObject* other) -> PyObject* {
+  if (!Check(other)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+  self->value -= reinterpret_cast<PythonClassVec3*>(other)->value;
+  Py_INCREF(self);
+  return reinterpret_cast<PyObject*>(self);
+}
+
+auto PythonClassVec3::nb_inplace_multiply(PythonClassVec3* self,
+                                          PyObject* other) -> PyObject* {
+  BA_PYTHON_TRY;
+  float val;
+  if (GetVec3Scalar(other, &val)) {
+    self->value *= val;
+  } else if (Python::CanGetPyVector3f(other)) {
+    Vector3f& lvec(self->value);
+    Vector3f rvec(Python::GetPyVector3f(other));
+    lvec = Vector3f(lvec.x * rvec.x, lvec.y * rvec.y, lvec.z * rvec.z);
+  } else {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+  Py_INCREF(self);
+  return reinterpret_cast<PyObject*>(self);
+  BA_PYTHON_CATCH;
+}
+
 auto PythonClassVec3::tp_richcompare(PythonClassVec3* c1, PyObject* c2, int op)
     -> PyObject* {
   // Always return false against other types.
@@ -286,6 +377,14 @@ auto PythonClassVec3::Cross(PythonClassVec3* self, PyObject* other)
   BA_PYTHON_CATCH;
 }
 
+auto PythonClassVec3::Distance(PythonClassVec3* self, PyObject* other)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  return PyFloat_FromDouble(
+      (self->value - Python::GetPyVector3f(other)).Length());
+  BA_PYTHON_CATCH;
+}
+
 PyMethodDef PythonClassVec3::tp_methods[] = {
     {"length", (PyCFunction)Length, METH_NOARGS,
      "length() -> float\n"
@@ -303,6 +402,12 @@ PyMethodDef PythonClassVec3::tp_methods[] = {
      "cross(other: Vec3) -> Vec3\n"
      "\n"
      "Returns the cross product of this vector and another."},
+    {"distance", (PyCFunction)Distance, METH_O,
+     "distance(other: Vec3) -> float\n"
+     "\n"
+     "Returns the distance between this vector and another.\n"
+     "\n"
+     "Equivalent to (self - other).length() without the intermediate Vec3."},
     {nullptr}};
 
 auto PythonClassVec3::tp_getattro(PythonClassVec3* self, PyObject* attr)
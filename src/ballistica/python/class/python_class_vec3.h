@@ -20,6 +20,7 @@ class PythonClassVec3 : public PythonClass {
   static auto Normalized(PythonClassVec3* self) -> PyObject*;
   static auto Dot(PythonClassVec3* self, PyObject* other) -> PyObject*;
   static auto Cross(PythonClassVec3* self, PyObject* other) -> PyObject*;
+  static auto Distance(PythonClassVec3* self, PyObject* other) -> PyObject*;
   static PyTypeObject type_obj;
   Vector3f value;
 
@@ -27,6 +28,11 @@ class PythonClassVec3 : public PythonClass {
   static PyMethodDef tp_methods[];
   static PySequenceMethods as_sequence_;
   static PyNumberMethods as_number_;
+
+  // Alloc/dealloc go through a free-list of recycled instances since these
+  // churn through in gameplay math.
+  static auto Alloc() -> PythonClassVec3*;
+  static void tp_dealloc(PythonClassVec3* self);
   static auto tp_repr(PythonClassVec3* self) -> PyObject*;
   static auto sq_length(PythonClassVec3* self) -> Py_ssize_t;
   static auto sq_item(PythonClassVec3* self, Py_ssize_t i) -> PyObject*;
@@ -36,6 +42,12 @@ class PythonClassVec3 : public PythonClass {
   static auto nb_subtract(PythonClassVec3* l, PythonClassVec3* r) -> PyObject*;
   static auto nb_multiply(PyObject* l, PyObject* r) -> PyObject*;
   static auto nb_negative(PythonClassVec3* self) -> PyObject*;
+  static auto nb_inplace_add(PythonClassVec3* self, PyObject* other)
+      -> PyObject*;
+  static auto nb_inplace_subtract(PythonClassVec3* self, PyObject* other)
+      -> PyObject*;
+  static auto nb_inplace_multiply(PythonClassVec3* self, PyObject* other)
+      -> PyObject*;
   static auto tp_new(PyTypeObject* type, PyObject* args, PyObject* keywds)
       -> PyObject*;
   static auto tp_getattro(PythonClassVec3* self, PyObject* attr) -> PyObject*;
@@ -4,6 +4,7 @@
 
 #include "ballistica/app/app.h"
 #include "ballistica/app/app_globals.h"
+#include "ballistica/app/config_writer.h"
 #include "ballistica/core/logging.h"
 #include "ballistica/game/connection/connection_set.h"
 #include "ballistica/game/game_stream.h"
@@ -667,54 +668,9 @@ auto PyCommitConfig(PyObject* self, PyObject* args, PyObject* keywds)
   if (config_obj == nullptr || !Python::IsPyString(config_obj)) {
     throw Exception("ERROR ON JSON DUMP");
   }
-  std::string final_str = Python::GetPyString(config_obj);
-  std::string path = g_platform->GetConfigFilePath();
-  std::string path_temp = path + ".tmp";
-  std::string path_prev = path + ".prev";
-  if (explicit_bool(true)) {
-    FILE* f_out = g_platform->FOpen(path_temp.c_str(), "wb");
-    if (f_out == nullptr) {
-      throw Exception("Error opening config file for writing: '" + path_temp
-                      + "': " + g_platform->GetErrnoString());
-    }
-
-    // Write to temp file.
-    size_t result = fwrite(&final_str[0], final_str.size(), 1, f_out);
-    if (result != 1) {
-      fclose(f_out);
-      throw Exception("Error writing config file to '" + path_temp
-                      + "': " + g_platform->GetErrnoString());
-    }
-    fclose(f_out);
-
-    // Now backup any existing config to .prev.
-    if (g_platform->FilePathExists(path)) {
-      // On windows, rename doesn't overwrite existing files.. need to kill
-      // the old explicitly.
-      // (hmm; should we just do this everywhere for consistency?)
-      if (g_buildconfig.ostype_windows()) {
-        if (g_platform->FilePathExists(path_prev)) {
-          int result2 = g_platform->Remove(path_prev.c_str());
-          if (result2 != 0) {
-            throw Exception("Error removing prev config file '" + path_prev
-                            + "': " + g_platform->GetErrnoString());
-          }
-        }
-      }
-      int result2 = g_platform->Rename(path.c_str(), path_prev.c_str());
-      if (result2 != 0) {
-        throw Exception("Error backing up config file to '" + path_prev
-                        + "': " + g_platform->GetErrnoString());
-      }
-    }
 
-    // Now move temp into place.
-    int result2 = g_platform->Rename(path_temp.c_str(), path.c_str());
-    if (result2 != 0) {
-      throw Exception("Error renaming temp config file to final '" + path
-                      + "': " + g_platform->GetErrnoString());
-    }
-  }
+  // Gets written out in the background shortly.
+  ConfigWriter::Commit(Python::GetPyString(config_obj));
   Py_RETURN_NONE;
   BA_PYTHON_CATCH;
 }
@@ -816,10 +772,12 @@ auto PySetStressTesting(PyObject* self, PyObject* args) -> PyObject* {
   Platform::SetLastPyCall("set_stress_testing");
   int testing;
   int player_count;
-  if (!PyArg_ParseTuple(args, "pi", &testing, &player_count)) {
+  int churn{1};
+  if (!PyArg_ParseTuple(args, "pi|p", &testing, &player_count, &churn)) {
     return nullptr;
   }
-  g_app->PushSetStressTestingCall(static_cast<bool>(testing), player_count);
+  g_app->PushSetStressTestingCall(static_cast<bool>(testing), player_count,
+                                  static_cast<bool>(churn));
   Py_RETURN_NONE;
   BA_PYTHON_CATCH;
 }
@@ -951,7 +909,8 @@ auto PythonMethodsApp::GetMethods() -> std::vector<PyMethodDef> {
          "(internal)"},
 
         {"set_stress_testing", PySetStressTesting, METH_VARARGS,
-         "set_stress_testing(testing: bool, player_count: int) -> None\n"
+         "set_stress_testing(testing: bool, player_count: int,\n"
+         "    churn: bool = True) -> None\n"
          "\n"
          "(internal)"},
 
@@ -970,7 +929,10 @@ auto PythonMethodsApp::GetMethods() -> std::vector<PyMethodDef> {
          METH_VARARGS | METH_KEYWORDS,
          "commit_config(config: str) -> None\n"
          "\n"
-         "(internal)"},
+         "(internal)\n"
+         "\n"
+         "Queue config contents to be written to disk in the background;\n"
+         "commits in quick succession coalesce into a single write."},
 
         {"apply_config", PyApplyConfig, METH_VARARGS,
          "apply_config() -> None\n"
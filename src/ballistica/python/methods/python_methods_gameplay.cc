@@ -2,9 +2,13 @@
 
 #include "ballistica/python/methods/python_methods_gameplay.h"
 
+#include <algorithm>
 #include <list>
+#include <utility>
+#include <vector>
 
 #include "ballistica/app/app.h"
+#include "ballistica/app/app_globals.h"
 #include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/dynamics/collision.h"
 #include "ballistica/dynamics/dynamics.h"
@@ -22,6 +26,7 @@
 #include "ballistica/python/python_context_call_runnable.h"
 #include "ballistica/python/python_sys.h"
 #include "ballistica/scene/node/node.h"
+#include "ballistica/scene/node/node_attribute.h"
 #include "ballistica/scene/node/node_type.h"
 #include "ballistica/scene/scene.h"
 
@@ -81,6 +86,175 @@ auto PyGetNodes(PyObject* self, PyObject* args) -> PyObject* {
   BA_PYTHON_CATCH;
 }
 
+// Looks up a node's position without going through Python. Returns false
+// for nodes that have none.
+static auto GetNodePosition(Node* node, float* position) -> bool {
+  NodeAttributeUnbound* attr = node->type()->GetAttribute("position", false);
+  if (!attr || attr->type() != NodeAttributeType::kFloatArray) {
+    return false;
+  }
+  float vals[kNodeAttrReadBufferSize];
+  if (attr->ReadFloats(node, vals, kNodeAttrReadBufferSize) < 3) {
+    return false;
+  }
+  position[0] = vals[0];
+  position[1] = vals[1];
+  position[2] = vals[2];
+  return true;
+}
+
+static auto NodeDistanceSquared(const float* a, const Vector3f& b) -> float {
+  float dx = a[0] - b.x;
+  float dy = a[1] - b.y;
+  float dz = a[2] - b.z;
+  return dx * dx + dy * dy + dz * dz;
+}
+
+// Returns the node-type to filter by (or nullptr for none).
+static auto GetNodeTypeFilter(PyObject* type_obj) -> NodeType* {
+  if (type_obj == Py_None) {
+    return nullptr;
+  }
+  std::string type_name = Python::GetPyString(type_obj);
+  auto i = g_app_globals->node_types.find(type_name);
+  if (i == g_app_globals->node_types.end()) {
+    throw Exception("Invalid node type: '" + type_name + "'.",
+                    PyExcType::kValue);
+  }
+  return i->second;
+}
+
+static auto GetContextScene() -> Scene* {
+  HostActivity* host_activity = Context::current().GetHostActivity();
+  if (!host_activity) {
+    throw Exception(PyExcType::kContext);
+  }
+  return host_activity->scene();
+}
+
+auto PyGetNodesInRadius(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_nodes_in_radius");
+  PyObject* position_obj;
+  float radius;
+  PyObject* type_obj{Py_None};
+  static const char* kwlist[] = {"position", "radius", "type", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "Of|O",
+                                   const_cast<char**>(kwlist), &position_obj,
+                                   &radius, &type_obj)) {
+    return nullptr;
+  }
+  Vector3f center = Python::GetPyVector3f(position_obj);
+  NodeType* node_type = GetNodeTypeFilter(type_obj);
+  float radius_squared = radius * radius;
+  std::vector<std::pair<float, Node*> > found;
+  float position[3];
+  for (auto&& i : GetContextScene()->nodes()) {
+    Node* node = i.get();
+    if ((node_type && node->type() != node_type)
+        || !GetNodePosition(node, position)) {
+      continue;
+    }
+    float dist_squared = NodeDistanceSquared(position, center);
+    if (dist_squared <= radius_squared) {
+      found.emplace_back(dist_squared, node);
+    }
+  }
+  std::stable_sort(
+      found.begin(), found.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+  PyObject* py_list = PyList_New(static_cast<Py_ssize_t>(found.size()));
+  BA_PRECONDITION(py_list);
+  for (size_t i = 0; i < found.size(); i++) {
+    PyList_SET_ITEM(py_list, static_cast<Py_ssize_t>(i),
+                    found[i].second->NewPyRef());
+  }
+  return py_list;
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetNearestNode(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_nearest_node");
+  PyObject* position_obj;
+  PyObject* type_obj{Py_None};
+  PyObject* exclude_obj{Py_None};
+  static const char* kwlist[] = {"position", "type", "exclude", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|OO",
+                                   const_cast<char**>(kwlist), &position_obj,
+                                   &type_obj, &exclude_obj)) {
+    return nullptr;
+  }
+  Vector3f center = Python::GetPyVector3f(position_obj);
+  NodeType* node_type = GetNodeTypeFilter(type_obj);
+  Node* exclude =
+      exclude_obj == Py_None ? nullptr : Python::GetPyNode(exclude_obj, true);
+  Node* nearest{};
+  float nearest_dist_squared{};
+  float position[3];
+  for (auto&& i : GetContextScene()->nodes()) {
+    Node* node = i.get();
+    if (node == exclude || (node_type && node->type() != node_type)
+        || !GetNodePosition(node, position)) {
+      continue;
+    }
+    float dist_squared = NodeDistanceSquared(position, center);
+    if (!nearest || dist_squared < nearest_dist_squared) {
+      nearest = node;
+      nearest_dist_squared = dist_squared;
+    }
+  }
+  if (!nearest) {
+    Py_RETURN_NONE;
+  }
+  return nearest->NewPyRef();
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetNodeDistances(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_node_distances");
+  PyObject* nodes_obj;
+  PyObject* position_obj;
+  static const char* kwlist[] = {"nodes", "position", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "OO",
+                                   const_cast<char**>(kwlist), &nodes_obj,
+                                   &position_obj)) {
+    return nullptr;
+  }
+  Vector3f center = Python::GetPyVector3f(position_obj);
+  if (!PySequence_Check(nodes_obj)) {
+    throw Exception("Object is not a sequence.", PyExcType::kType);
+  }
+  PythonRef sequence(PySequence_Fast(nodes_obj, "Not a sequence."),
+                     PythonRef::kSteal);
+  assert(sequence.exists());
+  Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence.get());
+  PyObject** py_objects = PySequence_Fast_ITEMS(sequence.get());
+  PyObject* py_list = PyList_New(size);
+  BA_PRECONDITION(py_list);
+  PythonRef list_ref(py_list, PythonRef::kSteal);
+  float position[3];
+  for (Py_ssize_t i = 0; i < size; i++) {
+    // Dead nodes and ones without positions get None.
+    Node* node = Python::GetPyNode(py_objects[i], true);
+    PyObject* val;
+    if (node && GetNodePosition(node, position)) {
+      float dist_squared = NodeDistanceSquared(position, center);
+      val = PyFloat_FromDouble(std::sqrt(dist_squared));
+    } else {
+      val = Py_None;
+      Py_INCREF(val);
+    }
+    PyList_SET_ITEM(py_list, i, val);
+  }
+  return list_ref.NewRef();
+  BA_PYTHON_CATCH;
+}
+
 static auto DoGetCollideValue(Dynamics* dynamics, const Collision* c,
                               const char* name) -> PyObject* {
   BA_PYTHON_TRY;
@@ -183,6 +357,151 @@ auto PyGetCollisionInfo(PyObject* self, PyObject* args) -> PyObject* {
   BA_PYTHON_CATCH;
 }
 
+auto PySetCollisionBatchCall(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("set_collision_batch_call");
+  PyObject* call_obj;
+  static const char* kwlist[] = {"call", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "O",
+                                   const_cast<char**>(kwlist), &call_obj)) {
+    return nullptr;
+  }
+  HostActivity* host_activity = Context::current().GetHostActivity();
+  if (!host_activity) {
+    throw Exception(PyExcType::kContext);
+  }
+  if (call_obj != Py_None && !PyCallable_Check(call_obj)) {
+    throw Exception("Expected a callable or None.", PyExcType::kType);
+  }
+  host_activity->scene()->dynamics()->SetCollisionBatchCall(call_obj);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PySetPhysicsSolver(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("set_physics_solver");
+  PyObject* iterations_obj = Py_None;
+  PyObject* sor_obj = Py_None;
+  PyObject* surface_layer_obj = Py_None;
+  PyObject* max_correcting_vel_obj = Py_None;
+  static const char* kwlist[] = {"iterations", "sor", "surface_layer",
+                                 "max_correcting_vel", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(
+          args, keywds, "|OOOO", const_cast<char**>(kwlist), &iterations_obj,
+          &sor_obj, &surface_layer_obj, &max_correcting_vel_obj)) {
+    return nullptr;
+  }
+  int iterations = iterations_obj == Py_None
+                       ? g_app_globals->physics_solver_iterations
+                       : Python::GetPyInt(iterations_obj);
+  float sor = sor_obj == Py_None ? g_app_globals->physics_solver_sor
+                                 : Python::GetPyFloat(sor_obj);
+  float surface_layer = surface_layer_obj == Py_None
+                            ? g_app_globals->physics_contact_surface_layer
+                            : Python::GetPyFloat(surface_layer_obj);
+  float max_correcting_vel = max_correcting_vel_obj == Py_None
+                                 ? g_app_globals->physics_max_correcting_vel
+                                 : Python::GetPyFloat(max_correcting_vel_obj);
+  HostActivity* host_activity = Context::current().GetHostActivity();
+  if (!host_activity) {
+    throw Exception(PyExcType::kContext);
+  }
+  if (iterations < 1) {
+    throw Exception("iterations must be at least 1.", PyExcType::kValue);
+  }
+  if (sor <= 0.0f || sor >= 2.0f) {
+    throw Exception("sor must be between 0 and 2.", PyExcType::kValue);
+  }
+  if (surface_layer < 0.0f) {
+    throw Exception("surface_layer can't be negative.", PyExcType::kValue);
+  }
+  host_activity->scene()->dynamics()->SetSolverSettings(
+      iterations, sor, surface_layer, max_correcting_vel);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetSceneDigest(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_scene_digest");
+  int per_node{};
+  static const char* kwlist[] = {"per_node", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p",
+                                   const_cast<char**>(kwlist), &per_node)) {
+    return nullptr;
+  }
+  // Replays and client sessions have no context of their own to call
+  // from, so fall back to whatever scene is showing.
+  Scene* scene = Context::current().GetMutableScene();
+  if (!scene) {
+    scene = g_game->GetForegroundScene();
+  }
+  if (!scene) {
+    throw Exception("No scene found.", PyExcType::kContext);
+  }
+  if (!per_node) {
+    return PyLong_FromUnsignedLongLong(scene->GetDigest());
+  }
+  std::vector<std::pair<Node*, uint64_t> > digests = scene->GetNodeDigests();
+  PyObject* py_list = PyList_New(static_cast<Py_ssize_t>(digests.size()));
+  BA_PRECONDITION(py_list);
+  for (size_t i = 0; i < digests.size(); i++) {
+    PyList_SET_ITEM(
+        py_list, static_cast<Py_ssize_t>(i),
+        Py_BuildValue("(LsK)", static_cast<long long>(  // NOLINT
+                                   digests[i].first->id()),
+                      digests[i].first->type()->name().c_str(),
+                      static_cast<unsigned long long>(  // NOLINT
+                          digests[i].second)));
+  }
+  return py_list;
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetSceneSnapshot(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_scene_snapshot");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  HostActivity* host_activity = Context::current().GetHostActivity();
+  if (!host_activity) {
+    throw Exception(PyExcType::kContext);
+  }
+  std::vector<uint8_t> snapshot = host_activity->scene()->GetSnapshot();
+  return PyBytes_FromStringAndSize(
+      reinterpret_cast<const char*>(snapshot.data()),
+      static_cast<Py_ssize_t>(snapshot.size()));
+  BA_PYTHON_CATCH;
+}
+
+auto PyApplySceneSnapshot(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("apply_scene_snapshot");
+  const char* data{};
+  Py_ssize_t size{};
+  static const char* kwlist[] = {"snapshot", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "y#",
+                                   const_cast<char**>(kwlist), &data, &size)) {
+    return nullptr;
+  }
+  HostActivity* host_activity = Context::current().GetHostActivity();
+  if (!host_activity) {
+    throw Exception(PyExcType::kContext);
+  }
+  std::vector<uint8_t> snapshot(data, data + size);
+  return PyLong_FromLong(host_activity->scene()->ApplySnapshot(snapshot));
+  BA_PYTHON_CATCH;
+}
+
 auto PyCameraShake(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
@@ -725,6 +1044,84 @@ auto PythonMethodsGameplay::GetMethods() -> std::vector<PyMethodDef> {
        "depth, nodes involved, etc. Only call this in the handler of a\n"
        "collision-triggered callback or message"},
 
+      {"set_collision_batch_call", (PyCFunction)PySetCollisionBatchCall,
+       METH_VARARGS | METH_KEYWORDS,
+       "set_collision_batch_call(call: Optional[Callable[[list], None]])\n"
+       "  -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Batch collision-triggered Python work for the current activity.\n"
+       "\n"
+       "While set, material 'call' and 'message' actions are not run\n"
+       "individually; instead, once per step after all other collision\n"
+       "actions have run, 'call' is passed a list of (node, opposingnode,\n"
+       "action) tuples in the order they would otherwise have run. 'action'\n"
+       "is the callable for 'call' actions or the message for 'message'\n"
+       "actions (to be delivered to 'node'). Records whose nodes died\n"
+       "before the batch ran are dropped using the usual rules. Note that\n"
+       "ba.getcollision() is not valid while handling a batch. Pass None\n"
+       "to go back to individual calls."},
+
+      {"set_physics_solver", (PyCFunction)PySetPhysicsSolver,
+       METH_VARARGS | METH_KEYWORDS,
+       "set_physics_solver(iterations: Optional[int] = None,\n"
+       "  sor: Optional[float] = None,\n"
+       "  surface_layer: Optional[float] = None,\n"
+       "  max_correcting_vel: Optional[float] = None) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Set physics solver settings for the current activity's scene.\n"
+       "\n"
+       "'iterations' is the number of solver passes per step, 'sor' its\n"
+       "over-relaxation factor (between 0 and 2), 'surface_layer' how deep\n"
+       "contacts may sink before being pushed apart and\n"
+       "'max_correcting_vel' a cap on the speed they get pushed apart at\n"
+       "(negative for unlimited). Values not passed revert to the app\n"
+       "defaults. Fewer iterations cost less CPU but make stacks and\n"
+       "resting contacts softer."},
+
+      {"get_scene_digest", (PyCFunction)PyGetSceneDigest,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_scene_digest(per_node: bool = False) -> Any\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Return a hash of the current (or else foreground) scene's state.\n"
+       "\n"
+       "This covers the same state as get_scene_snapshot(). With per_node,\n"
+       "returns a list of (node_id, node_type, hash) tuples instead, so two\n"
+       "runs that should step identically (such as a replay and the game\n"
+       "it was recorded from) can find the first node that diverged.\n"
+       "Only bitwise-identical state hashes the same."},
+
+      {"get_scene_snapshot", (PyCFunction)PyGetSceneSnapshot,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_scene_snapshot() -> bytes\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Capture the current activity's node state for apply_scene_snapshot().\n"
+       "\n"
+       "This covers plain-data attribute values (numbers, bools, strings\n"
+       "and arrays of those), physics body states and any node-specific\n"
+       "resync data. References (materials, textures, other nodes, etc.),\n"
+       "timers and Python state are not included. Snapshots are only valid\n"
+       "within the running app."},
+
+      {"apply_scene_snapshot", (PyCFunction)PyApplySceneSnapshot,
+       METH_VARARGS | METH_KEYWORDS,
+       "apply_scene_snapshot(snapshot: bytes) -> int\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Restore the current activity's nodes to a get_scene_snapshot() state.\n"
+       "\n"
+       "Nodes that have died since are skipped and ones created since are\n"
+       "left alone. Attributes are only set where they differ from the\n"
+       "snapshot. Returns the number of nodes restored."},
+
       {"getnodes", PyGetNodes, METH_VARARGS,
        "getnodes() -> list\n"
        "\n"
@@ -732,6 +1129,43 @@ auto PythonMethodsGameplay::GetMethods() -> std::vector<PyMethodDef> {
        "\n"
        "Category: Gameplay Functions"},
 
+      {"get_nodes_in_radius", (PyCFunction)PyGetNodesInRadius,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_nodes_in_radius(position: Sequence[float], radius: float,\n"
+       "type: Optional[str] = None) -> list[ba.Node]\n"
+       "\n"
+       "Return nodes in the current ba.Context within a distance of a point.\n"
+       "\n"
+       "Category: Gameplay Functions\n"
+       "\n"
+       "Only nodes with a 'position' attr are considered, optionally only\n"
+       "those of a given type. Results are sorted nearest first. This is\n"
+       "much cheaper than checking each node's position from Python."},
+
+      {"get_nearest_node", (PyCFunction)PyGetNearestNode,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_nearest_node(position: Sequence[float],\n"
+       "type: Optional[str] = None, exclude: Optional[ba.Node] = None)\n"
+       "-> Optional[ba.Node]\n"
+       "\n"
+       "Return the node in the current ba.Context nearest to a point.\n"
+       "\n"
+       "Category: Gameplay Functions\n"
+       "\n"
+       "Only nodes with a 'position' attr are considered, optionally only\n"
+       "those of a given type. Returns None if there are none."},
+
+      {"get_node_distances", (PyCFunction)PyGetNodeDistances,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_node_distances(nodes: Sequence[ba.Node],\n"
+       "position: Sequence[float]) -> list[Optional[float]]\n"
+       "\n"
+       "Return the distances from each of some nodes to a point.\n"
+       "\n"
+       "Category: Gameplay Functions\n"
+       "\n"
+       "Dead nodes and nodes with no 'position' attr give None."},
+
       {"printnodes", PyPrintNodes, METH_VARARGS,
        "printnodes() -> None\n"
        "\n"
@@ -8,13 +8,17 @@
 #endif
 
 #include "ballistica/game/host_activity.h"
+#include "ballistica/generic/lambda_runnable.h"
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/media/component/collide_model.h"
 #include "ballistica/media/component/data.h"
 #include "ballistica/media/component/model.h"
 #include "ballistica/media/component/sound.h"
 #include "ballistica/media/component/texture.h"
+#include "ballistica/media/media.h"
 #include "ballistica/python/python.h"
+#include "ballistica/python/python_context_call.h"
+#include "ballistica/python/python_media_handles.h"
 #include "ballistica/python/python_sys.h"
 #include "ballistica/ui/ui.h"
 
@@ -24,17 +28,33 @@ namespace ballistica {
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "hicpp-signed-bitwise"
 
+// Look up media by name through the current activity's handle table,
+// falling back to the context target (and storing the result) on a miss.
+template <typename F>
+static auto GetNamedMedia(PythonMediaHandles::Type type, PyObject* name_obj,
+                          F&& get_media) -> PyObject* {
+  if (PyObject* media = PythonMediaHandles::Get(type, name_obj)) {
+    return media;
+  }
+  PyObject* media = get_media(Python::GetPyString(name_obj))->NewPyRef();
+  PythonMediaHandles::Store(type, name_obj, media);
+  return media;
+}
+
 auto PyGetTexture(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("gettexture");
-  const char* name;
+  PyObject* name_obj;
   static const char* kwlist[] = {"name", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
-                                   const_cast<char**>(kwlist), &name)) {
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "U",
+                                   const_cast<char**>(kwlist), &name_obj)) {
     return nullptr;
   }
-  return Context::current_target().GetTexture(name)->NewPyRef();
+  return GetNamedMedia(PythonMediaHandles::Type::kTexture, name_obj,
+                       [](const std::string& name) {
+                         return Context::current_target().GetTexture(name);
+                       });
   BA_PYTHON_CATCH;
 }
 
@@ -58,13 +78,16 @@ auto PyGetPackageTexture(PyObject* self, PyObject* args, PyObject* keywds)
 auto PyGetSound(PyObject* self, PyObject* args, PyObject* keywds) -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("getsound");
-  const char* name;
+  PyObject* name_obj;
   static const char* kwlist[] = {"name", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
-                                   const_cast<char**>(kwlist), &name)) {
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "U",
+                                   const_cast<char**>(kwlist), &name_obj)) {
     return nullptr;
   }
-  return Context::current_target().GetSound(name)->NewPyRef();
+  return GetNamedMedia(PythonMediaHandles::Type::kSound, name_obj,
+                       [](const std::string& name) {
+                         return Context::current_target().GetSound(name);
+                       });
   BA_PYTHON_CATCH;
 }
 
@@ -88,13 +111,16 @@ auto PyGetPackageSound(PyObject* self, PyObject* args, PyObject* keywds)
 auto PyGetData(PyObject* self, PyObject* args, PyObject* keywds) -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("getdata");
-  const char* name;
+  PyObject* name_obj;
   static const char* kwlist[] = {"name", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
-                                   const_cast<char**>(kwlist), &name)) {
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "U",
+                                   const_cast<char**>(kwlist), &name_obj)) {
     return nullptr;
   }
-  return Context::current_target().GetData(name)->NewPyRef();
+  return GetNamedMedia(PythonMediaHandles::Type::kData, name_obj,
+                       [](const std::string& name) {
+                         return Context::current_target().GetData(name);
+                       });
   BA_PYTHON_CATCH;
 }
 
@@ -118,13 +144,16 @@ auto PyGetPackageData(PyObject* self, PyObject* args, PyObject* keywds)
 auto PyGetModel(PyObject* self, PyObject* args, PyObject* keywds) -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("getmodel");
-  const char* name;
+  PyObject* name_obj;
   static const char* kwlist[] = {"name", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
-                                   const_cast<char**>(kwlist), &name)) {
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "U",
+                                   const_cast<char**>(kwlist), &name_obj)) {
     return nullptr;
   }
-  return Context::current_target().GetModel(name)->NewPyRef();
+  return GetNamedMedia(PythonMediaHandles::Type::kModel, name_obj,
+                       [](const std::string& name) {
+                         return Context::current_target().GetModel(name);
+                       });
   BA_PYTHON_CATCH;
 }
 
@@ -149,13 +178,16 @@ auto PyGetCollideModel(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("getcollidemodel");
-  const char* name;
+  PyObject* name_obj;
   static const char* kwlist[] = {"name", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
-                                   const_cast<char**>(kwlist), &name)) {
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "U",
+                                   const_cast<char**>(kwlist), &name_obj)) {
     return nullptr;
   }
-  return Context::current_target().GetCollideModel(name)->NewPyRef();
+  return GetNamedMedia(PythonMediaHandles::Type::kCollideModel, name_obj,
+                       [](const std::string& name) {
+                         return Context::current_target().GetCollideModel(name);
+                       });
   BA_PYTHON_CATCH;
 }
 
@@ -234,6 +266,88 @@ auto PyMusicPlayerShutdown(PyObject* self, PyObject* args, PyObject* keywds)
   BA_PYTHON_CATCH;
 }
 
+auto PyGetActivityMediaManifest(PyObject* self, PyObject* args,
+                                PyObject* keywds) -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_activity_media_manifest");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  HostActivity* host_activity = Context::current().GetHostActivity();
+  if (!host_activity) {
+    throw Exception(PyExcType::kContext);
+  }
+  std::vector<std::string> names[5];
+  const char* keys[5] = {"textures", "models", "collide_models", "sounds",
+                         "datas"};
+  host_activity->GetMediaNames(&names[0], &names[1], &names[2], &names[3],
+                               &names[4]);
+  PythonRef py_manifest(PyDict_New(), PythonRef::kSteal);
+  for (int i = 0; i < 5; i++) {
+    PythonRef py_names(PyList_New(0), PythonRef::kSteal);
+    for (auto&& name : names[i]) {
+      PythonRef py_name(PyUnicode_FromString(name.c_str()), PythonRef::kSteal);
+      PyList_Append(py_names.get(), py_name.get());
+    }
+    PyDict_SetItemString(py_manifest.get(), keys[i], py_names.get());
+  }
+  return py_manifest.NewRef();
+  BA_PYTHON_CATCH;
+}
+
+auto PyPrefetchMedia(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("prefetch_media");
+  PyObject* objs[5] = {Py_None, Py_None, Py_None, Py_None, Py_None};
+  static const char* kwlist[] = {"textures", "models", "collide_models",
+                                 "sounds",   "datas",  nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "|OOOOO",
+                                   const_cast<char**>(kwlist), &objs[0],
+                                   &objs[1], &objs[2], &objs[3], &objs[4])) {
+    return nullptr;
+  }
+  std::vector<std::string> names[5];
+  for (int i = 0; i < 5; i++) {
+    if (objs[i] != Py_None) {
+      names[i] = Python::GetPyStrings(objs[i]);
+    }
+  }
+  g_media->PrefetchMedia(names[0], names[1], names[2], names[3], names[4]);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyLoadMediaAsync(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("load_media_async");
+  PyObject* call_obj;
+  PyObject* objs[5] = {Py_None, Py_None, Py_None, Py_None, Py_None};
+  static const char* kwlist[] = {
+      "call", "textures", "models", "collide_models", "sounds", "datas",
+      nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "O|OOOOO",
+                                   const_cast<char**>(kwlist), &call_obj,
+                                   &objs[0], &objs[1], &objs[2], &objs[3],
+                                   &objs[4])) {
+    return nullptr;
+  }
+  std::vector<std::string> names[5];
+  for (int i = 0; i < 5; i++) {
+    if (objs[i] != Py_None) {
+      names[i] = Python::GetPyStrings(objs[i]);
+    }
+  }
+  auto call(Object::New<PythonContextCall>(call_obj));
+  g_media->LoadMediaAsync(names[0], names[1], names[2], names[3], names[4],
+                          NewLambdaRunnable([call] { call->Run(); }));
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
 auto PyReloadMedia(PyObject* self, PyObject* args) -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("reloadmedia");
@@ -269,7 +383,10 @@ auto PyMacMusicAppInit(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("macmusicappinit");
-  g_platform->MacMusicAppInit();
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    g_platform->MacMusicAppInit();
+  }
   Py_RETURN_NONE;
   BA_PYTHON_CATCH;
 }
@@ -278,7 +395,12 @@ auto PyMacMusicAppGetVolume(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("macmusicappgetvolume");
-  return PyLong_FromLong(g_platform->MacMusicAppGetVolume());
+  int volume;
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    volume = g_platform->MacMusicAppGetVolume();
+  }
+  return PyLong_FromLong(volume);
   BA_PYTHON_CATCH;
 }
 
@@ -292,7 +414,10 @@ auto PyMacMusicAppSetVolume(PyObject* self, PyObject* args, PyObject* keywds)
                                    const_cast<char**>(kwlist), &volume)) {
     return nullptr;
   }
-  g_platform->MacMusicAppSetVolume(volume);
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    g_platform->MacMusicAppSetVolume(volume);
+  }
   Py_RETURN_NONE;
   BA_PYTHON_CATCH;
 }
@@ -301,7 +426,10 @@ auto PyMacMusicAppGetLibrarySource(PyObject* self, PyObject* args,
                                    PyObject* keywds) -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("macmusicappgetlibrarysource");
-  g_platform->MacMusicAppGetLibrarySource();
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    g_platform->MacMusicAppGetLibrarySource();
+  }
   Py_RETURN_NONE;
   BA_PYTHON_CATCH;
 }
@@ -310,7 +438,10 @@ auto PyMacMusicAppStop(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("macmusicappstop");
-  g_platform->MacMusicAppStop();
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    g_platform->MacMusicAppStop();
+  }
   Py_RETURN_NONE;
   BA_PYTHON_CATCH;
 }
@@ -327,7 +458,12 @@ auto PyMacMusicAppPlayPlaylist(PyObject* self, PyObject* args, PyObject* keywds)
     return nullptr;
   }
   playlist = Python::GetPyString(playlist_obj);
-  if (g_platform->MacMusicAppPlayPlaylist(playlist)) {
+  bool result;
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    result = g_platform->MacMusicAppPlayPlaylist(playlist);
+  }
+  if (result) {
     Py_RETURN_TRUE;
   } else {
     Py_RETURN_FALSE;
@@ -339,8 +475,12 @@ auto PyMacMusicAppGetPlaylists(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
   Platform::SetLastPyCall("macmusicappgetplaylists");
+  std::list<std::string> playlists;
+  {
+    Python::ScopedInterpreterLockRelease gil_release;
+    playlists = g_platform->MacMusicAppGetPlaylists();
+  }
   PyObject* py_list = PyList_New(0);
-  std::list<std::string> playlists = g_platform->MacMusicAppGetPlaylists();
   for (auto&& i : playlists) {
     PyObject* str_obj = PyUnicode_FromString(i.c_str());
     PyList_Append(py_list, str_obj);
@@ -562,6 +702,47 @@ auto PythonMethodsMedia::GetMethods() -> std::vector<PyMethodDef> {
        "ba.Texture\n"
        "\n"
        "(internal)"},
+
+      {"get_activity_media_manifest", (PyCFunction)PyGetActivityMediaManifest,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_activity_media_manifest() -> dict[str, list[str]]\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Return the names of all media requested so far in the current\n"
+       "activity, keyed by 'textures', 'models', 'collide_models', 'sounds'\n"
+       "and 'datas'."},
+
+      {"prefetch_media", (PyCFunction)PyPrefetchMedia,
+       METH_VARARGS | METH_KEYWORDS,
+       "prefetch_media(textures: Optional[Sequence[str]] = None,\n"
+       "  models: Optional[Sequence[str]] = None,\n"
+       "  collide_models: Optional[Sequence[str]] = None,\n"
+       "  sounds: Optional[Sequence[str]] = None,\n"
+       "  datas: Optional[Sequence[str]] = None) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Start loading media in the background ahead of when it is needed.\n"
+       "Names that can't be found are ignored."},
+
+      {"load_media_async", (PyCFunction)PyLoadMediaAsync,
+       METH_VARARGS | METH_KEYWORDS,
+       "load_media_async(call: Callable[[], Any],\n"
+       "  textures: Optional[Sequence[str]] = None,\n"
+       "  models: Optional[Sequence[str]] = None,\n"
+       "  collide_models: Optional[Sequence[str]] = None,\n"
+       "  sounds: Optional[Sequence[str]] = None,\n"
+       "  datas: Optional[Sequence[str]] = None) -> None\n"
+       "\n"
+       "Load media in the background, calling back once it is all loaded.\n"
+       "\n"
+       "Category: Asset Functions\n"
+       "\n"
+       "This returns immediately; the call is run in the current context\n"
+       "once everything listed has loaded, after which ba.gettexture() and\n"
+       "friends can fetch it without hitching. Names that can't be found\n"
+       "are skipped."},
   };
 }
 
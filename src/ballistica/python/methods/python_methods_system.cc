@@ -2,24 +2,44 @@
 
 #include "ballistica/python/methods/python_methods_system.h"
 
+#include <algorithm>
+#include <chrono>
 #include <list>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "ballistica/app/app.h"
 #include "ballistica/app/app_config.h"
 #include "ballistica/app/app_globals.h"
+#include "ballistica/app/microbenchmarks.h"
+#include "ballistica/core/event_trace.h"
+#include "ballistica/core/startup_timeline.h"
 #include "ballistica/game/game_stream.h"
 #include "ballistica/game/host_activity.h"
+#include "ballistica/game/load_test.h"
+#include "ballistica/game/net_stats.h"
 #include "ballistica/game/session/host_session.h"
 #include "ballistica/game/session/replay_client_session.h"
+#include "ballistica/game/telemetry.h"
+#include "ballistica/generic/lambda_runnable.h"
+#include "ballistica/generic/timer.h"
+#include "ballistica/generic/timer_list.h"
+#include "ballistica/graphics/benchmark_recorder.h"
 #include "ballistica/graphics/camera.h"
 #include "ballistica/graphics/graphics.h"
 #include "ballistica/input/input.h"
 #include "ballistica/media/component/texture.h"
 #include "ballistica/media/media.h"
+#include "ballistica/media/media_server.h"
+#include "ballistica/networking/control_server.h"
 #include "ballistica/python/python.h"
+#include "ballistica/python/python_context_call.h"
 #include "ballistica/python/python_context_call_runnable.h"
+#include "ballistica/python/python_gc.h"
+#include "ballistica/python/python_sampler.h"
 #include "ballistica/python/python_sys.h"
+#include "ballistica/scene/node/spaz_node.h"
 #include "ballistica/scene/scene.h"
 
 namespace ballistica {
@@ -385,6 +405,392 @@ auto PyPrintLoadInfo(PyObject* self, PyObject* args, PyObject* keywds)
   BA_PYTHON_CATCH;
 }
 
+// Bounces a call between the game and media threads, timing each round
+// trip (for measuring cross-thread message latency).
+struct ThreadLatencyBenchmark {
+  int remaining{};
+  std::chrono::steady_clock::time_point send_time;
+  std::vector<double> round_trip_times;
+};
+
+static void ThreadLatencyBenchmarkPing(
+    const std::shared_ptr<ThreadLatencyBenchmark>& benchmark) {
+  benchmark->send_time = std::chrono::steady_clock::now();
+  g_media_server->PushCall([benchmark] {
+    g_game->PushCall([benchmark] {
+      std::vector<double>& times = benchmark->round_trip_times;
+      times.push_back(std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now()
+                          - benchmark->send_time)
+                          .count());
+      if (--benchmark->remaining > 0) {
+        ThreadLatencyBenchmarkPing(benchmark);
+        return;
+      }
+      std::sort(times.begin(), times.end());
+      char buffer[256];
+      snprintf(buffer, sizeof(buffer),
+               "Thread ping-pong (game <-> media) over %d round trips:"
+               " min %.1fus, median %.1fus, 99%% %.1fus, max %.1fus",
+               static_cast<int>(times.size()), times.front(),
+               times[times.size() / 2], times[times.size() * 99 / 100],
+               times.back());
+      Log(buffer);
+    });
+  });
+}
+
+auto PyRunThreadLatencyBenchmark(PyObject* self, PyObject* args,
+                                 PyObject* keywds) -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("run_thread_latency_benchmark");
+  int count{1000};
+  static const char* kwlist[] = {"count", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "|i",
+                                   const_cast<char**>(kwlist), &count)) {
+    return nullptr;
+  }
+  BA_PRECONDITION(count > 0);
+  auto benchmark = std::make_shared<ThreadLatencyBenchmark>();
+  benchmark->remaining = count;
+  benchmark->round_trip_times.reserve(static_cast<size_t>(count));
+  ThreadLatencyBenchmarkPing(benchmark);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyRunMicrobenchmarks(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("run_microbenchmarks");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  return PyUnicode_FromString(Microbenchmarks::Run().c_str());
+  BA_PYTHON_CATCH;
+}
+
+auto PyRunTimerBenchmark(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("run_timer_benchmark");
+  int count{10000};
+  static const char* kwlist[] = {"count", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "|i",
+                                   const_cast<char**>(kwlist), &count)) {
+    return nullptr;
+  }
+  BA_PRECONDITION(count > 0);
+
+  // Timers get spread over 10 seconds (in pseudo-random order).
+  const TimerMedium kSpan = 10000;
+  uint32_t seed = 12345;
+  auto next_length = [&seed, kSpan] {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<TimerMedium>(1 + (seed >> 8) % kSpan);
+  };
+  using clock = std::chrono::steady_clock;
+  auto ns_per = [](clock::time_point start, int ops) {
+    return std::chrono::duration<double, std::nano>(clock::now() - start)
+               .count()
+           / std::max(ops, 1);
+  };
+  int fired{};
+  auto runnable = NewLambdaRunnable([&fired] { fired++; });
+  TimerList list;
+  std::vector<int> ids;
+  ids.reserve(static_cast<size_t>(count));
+
+  auto start = clock::now();
+  for (int i = 0; i < count; i++) {
+    ids.push_back(list.NewTimer(0, next_length(), 0, 0, runnable)->id());
+  }
+  double insert_ns = ns_per(start, count);
+
+  // Replace every other timer (the delete-and-recreate pattern gameplay
+  // code does constantly) while the rest stay live.
+  start = clock::now();
+  for (int i = 0; i < count; i += 2) {
+    list.DeleteTimer(ids[i]);
+    ids[i] = list.NewTimer(0, next_length(), 0, 0, runnable)->id();
+  }
+  double replace_ns = ns_per(start, count / 2);
+
+  // Run through it all a frame at a time.
+  start = clock::now();
+  for (TimerMedium t = 0; t <= kSpan; t += 16) {
+    list.Run(t);
+  }
+  list.Run(kSpan);
+  double run_ns = ns_per(start, fired);
+  char buffer[256];
+  snprintf(buffer, sizeof(buffer),
+           "Timer benchmark with %d live timers: insert %.0fns,"
+           " delete+insert %.0fns, run %.0fns per timer fired (%d fired)",
+           count, insert_ns, replace_ns, run_ns, fired);
+  Log(buffer);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PySetSpazStepProfiling(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("set_spaz_step_profiling");
+  int enabled{};
+  static const char* kwlist[] = {"enabled", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "p",
+                                   const_cast<char**>(kwlist), &enabled)) {
+    return nullptr;
+  }
+  SpazNode::SetStepProfilingEnabled(enabled);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PySetPythonCallProfiling(PyObject* self, PyObject* args,
+                              PyObject* keywds) -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("set_python_call_profiling");
+  int enabled{};
+  static const char* kwlist[] = {"enabled", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "p",
+                                   const_cast<char**>(kwlist), &enabled)) {
+    return nullptr;
+  }
+  PythonContextCall::SetProfilingEnabled(enabled);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStartPythonSampling(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("start_python_sampling");
+  const char* path;
+  float rate{100.0f};
+  static const char* kwlist[] = {"path", "rate", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s|f",
+                                   const_cast<char**>(kwlist), &path, &rate)) {
+    return nullptr;
+  }
+  PythonSampler::Start(path, rate);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStopPythonSampling(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("stop_python_sampling");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  PythonSampler::Stop();
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStartBenchmarkRecording(PyObject* self, PyObject* args,
+                               PyObject* keywds) -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("start_benchmark_recording");
+  const char* path;
+  static const char* kwlist[] = {"path", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
+                                   const_cast<char**>(kwlist), &path)) {
+    return nullptr;
+  }
+  BenchmarkRecorder::Start(path);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStopBenchmarkRecording(PyObject* self, PyObject* args,
+                              PyObject* keywds) -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("stop_benchmark_recording");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  BenchmarkRecorder::Stop();
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStartControlServer(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("start_control_server");
+  const char* path;
+  static const char* kwlist[] = {"path", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
+                                   const_cast<char**>(kwlist), &path)) {
+    return nullptr;
+  }
+  ControlServer::Start(path);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStartEventTrace(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("start_event_trace");
+  const char* path;
+  static const char* kwlist[] = {"path", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s",
+                                   const_cast<char**>(kwlist), &path)) {
+    return nullptr;
+  }
+  EventTrace::Start(path);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStopEventTrace(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("stop_event_trace");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  EventTrace::Stop();
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyStartLoadTest(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("start_load_test");
+  const char* path;
+  int steps;
+  int seed{};
+  PyObject* call_obj{Py_None};
+  static const char* kwlist[] = {"path", "steps", "seed", "call", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "si|iO",
+                                   const_cast<char**>(kwlist), &path, &steps,
+                                   &seed, &call_obj)) {
+    return nullptr;
+  }
+  Object::Ref<PythonContextCall> call;
+  if (call_obj != Py_None) {
+    call = Object::New<PythonContextCall>(call_obj);
+  }
+  LoadTest::Start(path, steps, static_cast<uint32_t>(seed), call);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
+auto PyCollectGarbage(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("collect_garbage");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  return PyLong_FromLongLong(PythonGC::RunFull());
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetGCStats(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_gc_stats");
+  int reset{};
+  static const char* kwlist[] = {"reset", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p",
+                                   const_cast<char**>(kwlist), &reset)) {
+    return nullptr;
+  }
+  PythonRef result(PyDict_New(), PythonRef::kSteal);
+  const char* names[] = {"gen0", "gen1", "full"};
+  for (int i = 0; i <= PythonGC::kFullCollection; i++) {
+    const PythonGC::GenerationStats& stats = PythonGC::GetStats(i);
+    PythonRef entry(
+        Py_BuildValue("{sLsLsLsdsdsd}", "collections", stats.collections,
+                      "deferred", stats.deferred, "forced", stats.forced,
+                      "total_ms", stats.total_seconds * 1000.0, "max_ms",
+                      stats.max_seconds * 1000.0, "last_ms",
+                      stats.last_seconds * 1000.0),
+        PythonRef::kSteal);
+    PyDict_SetItemString(result.get(), names[i], entry.get());
+  }
+  if (reset) {
+    PythonGC::ResetStats();
+  }
+  return result.HandOver();
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetTelemetryText(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_telemetry_text");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  return PyUnicode_FromString(Telemetry::GetPrometheusText().c_str());
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetNetStats(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_net_stats");
+  int include_samples = 0;
+  static const char* kwlist[] = {"include_samples", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "|p",
+                                   const_cast<char**>(kwlist),
+                                   &include_samples)) {
+    return nullptr;
+  }
+  return PyUnicode_FromString(
+      NetStats::GetStatsJson(static_cast<bool>(include_samples)).c_str());
+  BA_PYTHON_CATCH;
+}
+
+auto PyGetStartupTimeline(PyObject* self, PyObject* args, PyObject* keywds)
+    -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("get_startup_timeline");
+  static const char* kwlist[] = {nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "",
+                                   const_cast<char**>(kwlist))) {
+    return nullptr;
+  }
+  return PyUnicode_FromString(StartupTimeline::GetText().c_str());
+  BA_PYTHON_CATCH;
+}
+
+auto PySetTelemetryLogInterval(PyObject* self, PyObject* args,
+                               PyObject* keywds) -> PyObject* {
+  BA_PYTHON_TRY;
+  Platform::SetLastPyCall("set_telemetry_log_interval");
+  double interval;
+  static const char* kwlist[] = {"interval", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "d",
+                                   const_cast<char**>(kwlist), &interval)) {
+    return nullptr;
+  }
+  Telemetry::SetLogInterval(interval);
+  Py_RETURN_NONE;
+  BA_PYTHON_CATCH;
+}
+
 auto PyGetReplaysDir(PyObject* self, PyObject* args, PyObject* keywds)
     -> PyObject* {
   BA_PYTHON_TRY;
@@ -1005,6 +1411,184 @@ auto PythonMethodsSystem::GetMethods() -> std::vector<PyMethodDef> {
        "\n"
        "Category: General Utility Functions"},
 
+      {"run_thread_latency_benchmark",
+       (PyCFunction)PyRunThreadLatencyBenchmark, METH_VARARGS | METH_KEYWORDS,
+       "run_thread_latency_benchmark(count: int = 1000) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Bounce calls between the game and media threads and log how long\n"
+       "each round trip takes."},
+
+      {"run_microbenchmarks", (PyCFunction)PyRunMicrobenchmarks,
+       METH_VARARGS | METH_KEYWORDS,
+       "run_microbenchmarks() -> str\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Time low-level engine primitives in isolation and return the results\n"
+       "as a json string."},
+
+      {"run_timer_benchmark", (PyCFunction)PyRunTimerBenchmark,
+       METH_VARARGS | METH_KEYWORDS,
+       "run_timer_benchmark(count: int = 10000) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Time creating, replacing and running a large number of timers\n"
+       "and log the results."},
+
+      {"set_spaz_step_profiling", (PyCFunction)PySetSpazStepProfiling,
+       METH_VARARGS | METH_KEYWORDS,
+       "set_spaz_step_profiling(enabled: bool) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Start or stop timing the phases of spaz node steps. Stopping logs\n"
+       "the average time each phase took per step."},
+
+      {"set_python_call_profiling", (PyCFunction)PySetPythonCallProfiling,
+       METH_VARARGS | METH_KEYWORDS,
+       "set_python_call_profiling(enabled: bool) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Start or stop counting context-call runs (timers, callbacks, etc.)\n"
+       "and time spent in them per call site. Stopping logs the busiest."},
+
+      {"start_python_sampling", (PyCFunction)PyStartPythonSampling,
+       METH_VARARGS | METH_KEYWORDS,
+       "start_python_sampling(path: str, rate: float = 100.0) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Start sampling the game thread's Python stack 'rate' times per\n"
+       "second. Stopping writes totals to 'path' in folded-stack format\n"
+       "(as used by flamegraph tools)."},
+
+      {"stop_python_sampling", (PyCFunction)PyStopPythonSampling,
+       METH_VARARGS | METH_KEYWORDS,
+       "stop_python_sampling() -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Stop a start_python_sampling() run and write its results."},
+
+      {"start_benchmark_recording", (PyCFunction)PyStartBenchmarkRecording,
+       METH_VARARGS | METH_KEYWORDS,
+       "start_benchmark_recording(path: str) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Start recording per-frame build/render times, gpu pass times and\n"
+       "memory use. Stopping writes them to 'path' as JSON."},
+
+      {"stop_benchmark_recording", (PyCFunction)PyStopBenchmarkRecording,
+       METH_VARARGS | METH_KEYWORDS,
+       "stop_benchmark_recording() -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Stop a start_benchmark_recording() run and write its results."},
+
+      {"start_control_server", (PyCFunction)PyStartControlServer,
+       METH_VARARGS | METH_KEYWORDS,
+       "start_control_server(path: str) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Serve json-lines stats/roster queries on a Unix domain socket at\n"
+       "'path' (only accessible to our user). Each request line looks like\n"
+       "{\"id\": 1, \"method\": \"stats\"}; methods are 'ping', 'stats',\n"
+       "'roster', 'net_stats' and 'telemetry'."},
+
+      {"start_event_trace", (PyCFunction)PyStartEventTrace,
+       METH_VARARGS | METH_KEYWORDS,
+       "start_event_trace(path: str) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Start recording traced engine events from all threads. Stopping\n"
+       "writes them to 'path' in Chrome trace format (for chrome://tracing\n"
+       "or Perfetto)."},
+
+      {"stop_event_trace", (PyCFunction)PyStopEventTrace,
+       METH_VARARGS | METH_KEYWORDS,
+       "stop_event_trace() -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Stop a start_event_trace() run and write its results."},
+
+      {"start_load_test", (PyCFunction)PyStartLoadTest,
+       METH_VARARGS | METH_KEYWORDS,
+       "start_load_test(path: str, steps: int, seed: int = 0,\n"
+       "    call: Optional[Callable[[], None]] = None) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Measure the next 'steps' game steps, then write step-time\n"
+       "percentiles, node/collision counts and client traffic as JSON to\n"
+       "'path' and run 'call'. The seed is applied to the C rand() used\n"
+       "by stress-test inputs."},
+
+      {"collect_garbage", (PyCFunction)PyCollectGarbage,
+       METH_VARARGS | METH_KEYWORDS,
+       "collect_garbage() -> int\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Run a full Python garbage collection, recording its duration in\n"
+       "get_gc_stats(). Returns the number of unreachable objects found."},
+
+      {"get_gc_stats", (PyCFunction)PyGetGCStats,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_gc_stats(reset: bool = False) -> dict[str, dict[str, Any]]\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Return counts and durations of engine-run garbage collections for\n"
+       "'gen0', 'gen1' and 'full' collections. Young-generation ones run\n"
+       "between game updates when they fit the idle budget; 'deferred'\n"
+       "counts times one was due but didn't fit and 'forced' counts ones\n"
+       "run over budget because they had waited too long."},
+
+      {"get_telemetry_text", (PyCFunction)PyGetTelemetryText,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_telemetry_text() -> str\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Return per-thread event loop load, queue depths, game step times\n"
+       "and scene step phase times in Prometheus text format."},
+
+      {"get_net_stats", (PyCFunction)PyGetNetStats,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_net_stats(include_samples: bool = False) -> str\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Return json covering the last few minutes of ping, traffic, resend\n"
+       "and buffering percentiles for current and recently closed\n"
+       "connections (optionally with their per-second samples)."},
+
+      {"get_startup_timeline", (PyCFunction)PyGetStartupTimeline,
+       METH_VARARGS | METH_KEYWORDS,
+       "get_startup_timeline() -> str\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Return a table of when each bootstrapping phase started and how\n"
+       "long it took (and on which thread), up to the first drawn frame."},
+
+      {"set_telemetry_log_interval", (PyCFunction)PySetTelemetryLogInterval,
+       METH_VARARGS | METH_KEYWORDS,
+       "set_telemetry_log_interval(interval: float) -> None\n"
+       "\n"
+       "(internal)\n"
+       "\n"
+       "Log a line of load stats every 'interval' real seconds (0 stops)."},
+
       {"print_context", (PyCFunction)PyPrintContext,
        METH_VARARGS | METH_KEYWORDS,
        "print_context() -> None\n"
@@ -1179,6 +1179,7 @@ auto PyScrollWidget(PyObject* self, PyObject* args, PyObject* keywds)
   PyObject* claims_up_down_obj{Py_None};
   PyObject* claims_tab_obj{Py_None};
   PyObject* autoselect_obj{Py_None};
+  PyObject* on_scroll_call_obj{Py_None};
 
   static const char* kwlist[] = {"edit",
                                  "parent",
@@ -1198,16 +1199,18 @@ auto PyScrollWidget(PyObject* self, PyObject* args, PyObject* keywds)
                                  "claims_up_down",
                                  "claims_tab",
                                  "autoselect",
+                                 "on_scroll_call",
                                  nullptr};
 
   if (!PyArg_ParseTupleAndKeywords(
-          args, keywds, "|OOOOOOOOOOOOOOOOOO", const_cast<char**>(kwlist),
+          args, keywds, "|OOOOOOOOOOOOOOOOOOO", const_cast<char**>(kwlist),
           &edit_obj, &parent_obj, &size_obj, &pos_obj, &background_obj,
           &selected_child_obj, &capture_arrows_obj, &on_select_call_obj,
           &center_small_content_obj, &color_obj, &highlight_obj,
           &border_opacity_obj, &simple_culling_v_obj,
           &selection_loops_to_parent_obj, &claims_left_right_obj,
-          &claims_up_down_obj, &claims_tab_obj, &autoselect_obj))
+          &claims_up_down_obj, &claims_tab_obj, &autoselect_obj,
+          &on_scroll_call_obj))
     return nullptr;
 
   if (!g_game->IsInUIContext()) {
@@ -1256,6 +1259,9 @@ auto PyScrollWidget(PyObject* self, PyObject* args, PyObject* keywds)
   if (on_select_call_obj != Py_None) {
     widget->SetOnSelectCall(on_select_call_obj);
   }
+  if (on_scroll_call_obj != Py_None) {
+    widget->SetOnScrollCall(on_scroll_call_obj);
+  }
   if (center_small_content_obj != Py_None) {
     widget->set_center_small_content(
         Python::GetPyBool(center_small_content_obj));
@@ -2662,7 +2668,8 @@ auto PythonMethodsUI::GetMethods() -> std::vector<PyMethodDef> {
        "  claims_left_right: bool = None,\n"
        "  claims_up_down: bool = None,\n"
        "  claims_tab: bool = None,\n"
-       "  autoselect: bool = None) -> ba.Widget\n"
+       "  autoselect: bool = None,\n"
+       "  on_scroll_call: Callable = None) -> ba.Widget\n"
        "\n"
        "Create or edit a scroll widget.\n"
        "\n"
@@ -2670,7 +2677,11 @@ auto PythonMethodsUI::GetMethods() -> std::vector<PyMethodDef> {
        "\n"
        "Pass a valid existing ba.Widget as 'edit' to modify it; otherwise\n"
        "a new one is created and returned. Arguments that are not set to None\n"
-       "are applied to the Widget."},
+       "are applied to the Widget.\n"
+       "\n"
+       "If on_scroll_call is given, it is called with the current scroll\n"
+       "offset (from the top of the content) and the visible height as the\n"
+       "widget scrolls."},
 
       {"hscrollwidget", (PyCFunction)PyHScrollWidget,
        METH_VARARGS | METH_KEYWORDS,
@@ -44,6 +44,7 @@
 #include "ballistica/python/python_command.h"
 #include "ballistica/python/python_context_call_runnable.h"
 #include "ballistica/scene/node/node_attribute.h"
+#include "ballistica/scene/node/node_message.h"
 #include "ballistica/ui/ui.h"
 #include "ballistica/ui/widget/text_widget.h"
 
@@ -610,9 +611,23 @@ auto Python::GetPyDouble(PyObject* o) -> double {
 }
 
 auto Python::GetPyFloats(PyObject* o) -> std::vector<float> {
+  std::vector<float> vals;
+  GetPyFloats(o, &vals);
+  return vals;
+}
+
+void Python::GetPyFloats(PyObject* o, std::vector<float>* vals) {
   assert(HaveGIL());
   BA_PRECONDITION_FATAL(o != nullptr);
+  assert(vals);
 
+  // Vec3s are common here and would otherwise go through a temp list of
+  // temp floats.
+  if (PythonClassVec3::Check(o)) {
+    const Vector3f& v = reinterpret_cast<PythonClassVec3*>(o)->value;
+    vals->assign({v.x, v.y, v.z});
+    return;
+  }
   if (!PySequence_Check(o)) {
     throw Exception("Object is not a sequence.", PyExcType::kType);
   }
@@ -620,12 +635,10 @@ auto Python::GetPyFloats(PyObject* o) -> std::vector<float> {
   assert(sequence.exists());
   Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence.get());
   PyObject** py_objects = PySequence_Fast_ITEMS(sequence.get());
-  std::vector<float> vals(static_cast<size_t>(size));
-  assert(vals.size() == size);
+  vals->resize(static_cast<size_t>(size));
   for (Py_ssize_t i = 0; i < size; i++) {
-    vals[i] = Python::GetPyFloat(py_objects[i]);
+    (*vals)[i] = Python::GetPyFloat(py_objects[i]);
   }
-  return vals;
 }
 
 auto Python::GetPyStrings(PyObject* o) -> std::vector<std::string> {
@@ -990,8 +1003,8 @@ void Python::Reset(bool do_init) {
     assert(PyDict_Check(obj(ObjID::kConfig).get()));
 
     // Turn off fancy-pants cyclic garbage-collection.
-    // We run it only at explicit times to avoid random hitches and keep
-    // things more deterministic.
+    // We run it only at explicit times (see PythonGC) to avoid random
+    // hitches and keep things more deterministic.
     // Non-reference-looped objects will still get cleaned up
     // immediately, so we should try to structure things to avoid
     // reference loops (just like Swift, ObjC, etc).
@@ -1264,111 +1277,52 @@ void Python::DoBuildNodeMessage(PyObject* args, int arg_offset, Buffer<char>* b,
   }
   type = Python::GetPyString(obj);
   NodeMessageType ac = Scene::GetNodeMessageType(type);
-  const char* format = Scene::GetNodeMessageFormat(ac);
-  assert(format);
-  const char* f = format;
-
-  // Allow space for 1 type byte (fixme - may need more than 1).
-  size_t full_size = 1;
-  for (Py_ssize_t i = arg_offset + 1; i < tuple_size; i++) {
-    // Make sure our format string ends the same time as our arg count.
-    if (*f == 0) {
-      throw Exception(
-          "Wrong number of arguments on node message '" + type + "'.",
-          PyExcType::kValue);
-    }
-    obj = PyTuple_GET_ITEM(args, i);
-    BA_PRECONDITION(obj);
-    switch (*f) {
-      case 'I':
-
-        // 4 byte int
-        if (!PyNumber_Check(obj)) {
-          throw Exception("Expected an int for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += 4;
-        break;
-      case 'i':
-
-        // 2 byte int.
-        if (!PyNumber_Check(obj)) {
-          throw Exception("Expected an int for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += 2;
-        break;
-      case 'c':  // NOLINT(bugprone-branch-clone)
-
-        // 1 byte int.
-        if (!PyNumber_Check(obj)) {
-          throw Exception("Expected an int for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += 1;
-        break;
-      case 'b':
-
-        // bool (currently 1 byte int).
-        if (!PyNumber_Check(obj)) {
-          throw Exception("Expected an int for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += 1;
-        break;
-      case 'F':
-
-        // 32 bit float.
-        if (!PyNumber_Check(obj)) {
-          throw Exception("Expected a float for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += 4;
-        break;
-      case 'f':
-
-        // 16 bit float.
-        if (!PyNumber_Check(obj)) {
-          throw Exception("Expected a float for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += 2;
-        break;
-      case 's':
-        if (!PyUnicode_Check(obj)) {
-          throw Exception("Expected a string for node message arg "
-                              + std::to_string(i - (arg_offset + 1)) + ".",
-                          PyExcType::kType);
-        }
-        full_size += strlen(PyUnicode_AsUTF8(obj)) + 1;
-        break;
-      default:
-        throw Exception("Invalid argument type: " + std::to_string(*f) + ".",
-                        PyExcType::kValue);
-        break;
-    }
-    f++;
-  }
+  const NodeMessageSpec* spec = GetNodeMessageSpec(ac);
+  assert(spec);
 
-  // Make sure our format string ends the same time as our arg count.
-  if (*f != 0) {
+  // Make sure our format ends the same time as our arg count.
+  if (static_cast<size_t>(tuple_size - (arg_offset + 1))
+      != spec->field_count) {
     throw Exception("Wrong number of arguments on node message '" + type + "'.",
                     PyExcType::kValue);
   }
+
+  // Allow space for 1 type byte (fixme - may need more than 1).
+  // Only strings need a look at the args to size things up.
+  size_t full_size = 1 + spec->fixed_size;
+  if (spec->has_strings) {
+    const char* f = spec->format;
+    for (Py_ssize_t i = arg_offset + 1; i < tuple_size; i++, f++) {
+      if (*f != 's') {
+        continue;
+      }
+      obj = PyTuple_GET_ITEM(args, i);
+      BA_PRECONDITION(obj);
+      if (!PyUnicode_Check(obj)) {
+        throw Exception("Expected a string for node message arg "
+                            + std::to_string(i - (arg_offset + 1)) + ".",
+                        PyExcType::kType);
+      }
+      full_size += strlen(PyUnicode_AsUTF8(obj)) + 1;
+    }
+  }
   (*b).Resize(full_size);
   char* ptr = (*b).data();
   *ptr = static_cast<char>(ac);
   ptr++;
-  f = format;
-  for (Py_ssize_t i = arg_offset + 1; i < tuple_size; i++) {
+
+  // Now check and pack everything in one pass.
+  const char* f = spec->format;
+  for (Py_ssize_t i = arg_offset + 1; i < tuple_size; i++, f++) {
     obj = PyTuple_GET_ITEM(args, i);
     BA_PRECONDITION(obj);
+    if (*f != 's' && !PyNumber_Check(obj)) {
+      const char* what = (*f == 'F' || *f == 'f') ? "a float" : "an int";
+      throw Exception(std::string("Expected ") + what
+                          + " for node message arg "
+                          + std::to_string(i - (arg_offset + 1)) + ".",
+                      PyExcType::kType);
+    }
     switch (*f) {
       case 'I':
         Utils::EmbedInt32NBO(
@@ -1396,11 +1350,12 @@ void Python::DoBuildNodeMessage(PyObject* args, int arg_offset, Buffer<char>* b,
         Utils::EmbedString(&ptr, PyUnicode_AsUTF8(obj));
         break;
       default:
-        throw Exception(PyExcType::kValue);
+        throw Exception("Invalid argument type: " + std::to_string(*f) + ".",
+                        PyExcType::kValue);
         break;
     }
-    f++;
   }
+  assert(ptr == (*b).data() + full_size);
 }
 
 auto Python::GetPythonFileLocation(bool pretty) -> std::string {
@@ -1445,8 +1400,12 @@ auto Python::GetPythonFileLocation(bool pretty) -> std::string {
 void Python::SetNodeAttr(Node* node, const char* attr_name,
                          PyObject* value_obj) {
   assert(node);
-  GameStream* out_stream = node->scene()->GetGameStream();
-  NodeAttribute attr = node->GetAttribute(attr_name);
+  SetNodeAttr(node->GetAttribute(attr_name), value_obj);
+}
+
+void Python::SetNodeAttr(const NodeAttribute& attr, PyObject* value_obj) {
+  assert(attr.node && attr.attr);
+  GameStream* out_stream = attr.node->scene()->GetGameStream();
   switch (attr.type()) {
     case NodeAttributeType::kFloat: {
       float val = Python::GetPyFloat(value_obj);
@@ -1482,7 +1441,12 @@ void Python::SetNodeAttr(Node* node, const char* attr_name,
       break;
     }
     case NodeAttributeType::kFloatArray: {
-      std::vector<float> vals = Python::GetPyFloats(value_obj);
+      // These get set constantly (positions, colors, etc.) so we reuse
+      // one buffer's storage rather than allocating each time. (We take
+      // it while we work so anything nested just gets a fresh one).
+      static std::vector<float> spare_vals;
+      std::vector<float> vals = std::move(spare_vals);
+      Python::GetPyFloats(value_obj, &vals);
       if (out_stream) {
         out_stream->SetNodeAttr(attr, vals);
       }
@@ -1490,6 +1454,7 @@ void Python::SetNodeAttr(Node* node, const char* attr_name,
       // If something was driving this attr, disconnect it.
       attr.DisconnectIncoming();
       attr.Set(vals);
+      spare_vals = std::move(vals);
       break;
     }
     case NodeAttributeType::kIntArray: {
@@ -1704,17 +1669,20 @@ auto Python::DoNewNode(PyObject* args, PyObject* keywds) -> Node* {
     Py_ssize_t pos{};
 
     // We want to set initial attrs in order based on their attr indices.
-    std::list<std::pair<NodeAttributeUnbound*, PyObject*> > attr_vals;
+    // (Keys are usually interned literals so this lookup is cheap, and we
+    // keep the resolved attrs so the sets don't look them up again).
+    std::vector<std::pair<NodeAttributeUnbound*, PyObject*> > attr_vals;
+    attr_vals.reserve(static_cast<size_t>(PyDict_GET_SIZE(dict)));
 
     // Grab all initial attr/values and add them to a list.
     while (PyDict_Next(dict, &pos, &key, &value)) {
       if (!PyUnicode_Check(key)) {
         throw Exception("Expected string key in attr dict.", PyExcType::kType);
       }
-      try {
-        attr_vals.emplace_back(
-            t->GetAttribute(std::string(PyUnicode_AsUTF8(key))), value);
-      } catch (const std::exception&) {
+      if (NodeAttributeUnbound* attr =
+              PythonClassNode::LookUpAttribute(t, key)) {
+        attr_vals.emplace_back(attr, value);
+      } else {
         Log("ERROR: Attr not found on initial attr set: '"
             + std::string(PyUnicode_AsUTF8(key)) + "' on " + type + " node '"
             + name + "'");
@@ -1722,10 +1690,10 @@ auto Python::DoNewNode(PyObject* args, PyObject* keywds) -> Node* {
     }
 
     // Run the sets in the order of attr indices.
-    attr_vals.sort(CompareAttrIndices);
+    std::stable_sort(attr_vals.begin(), attr_vals.end(), CompareAttrIndices);
     for (auto&& i : attr_vals) {
       try {
-        SetNodeAttr(node, i.first->name().c_str(), i.second);
+        SetNodeAttr(NodeAttribute(node, i.first), i.second);
       } catch (const std::exception& e) {
         Log("ERROR: exception in initial attr set for attr '" + i.first->name()
             + "' on " + type + " node '" + name + "':" + e.what());
@@ -1775,7 +1743,11 @@ auto Python::DoNewNode(PyObject* args, PyObject* keywds) -> Node* {
 // attr.
 auto Python::GetNodeAttr(Node* node, const char* attr_name) -> PyObject* {
   assert(node);
-  NodeAttribute attr = node->GetAttribute(attr_name);
+  return GetNodeAttr(node->GetAttribute(attr_name));
+}
+
+auto Python::GetNodeAttr(const NodeAttribute& attr) -> PyObject* {
+  assert(attr.node && attr.attr);
   switch (attr.type()) {
     case NodeAttributeType::kFloat:
       return PyFloat_FromDouble(attr.GetAsFloat());
@@ -1821,25 +1793,43 @@ auto Python::GetNodeAttr(Node* node, const char* attr_name) -> PyObject* {
       break;
     }
     case NodeAttributeType::kFloatArray: {
-      std::vector<float> vals = attr.GetAsFloats();
-      Py_ssize_t size = vals.size();
+      // Most of these are short (positions, colors, etc.) so try to read
+      // them without allocating first.
+      float buffer[kNodeAttrReadBufferSize];
+      std::vector<float> vals;
+      const float* data = buffer;
+      size_t count = attr.ReadFloats(buffer, kNodeAttrReadBufferSize);
+      if (count > kNodeAttrReadBufferSize) {
+        vals = attr.GetAsFloats();
+        data = vals.data();
+        count = vals.size();
+      }
+      auto size = static_cast<Py_ssize_t>(count);
       PyObject* vals_obj = PyTuple_New(size);
       BA_PRECONDITION(vals_obj);
       for (Py_ssize_t i = 0; i < size; i++) {
-        PyTuple_SET_ITEM(vals_obj, i, PyFloat_FromDouble(vals[i]));
+        PyTuple_SET_ITEM(vals_obj, i, PyFloat_FromDouble(data[i]));
       }
       return vals_obj;
       break;
     }
     case NodeAttributeType::kIntArray: {
-      std::vector<int64_t> vals = attr.GetAsInts();
-      Py_ssize_t size = vals.size();
+      int64_t buffer[kNodeAttrReadBufferSize];
+      std::vector<int64_t> vals;
+      const int64_t* data = buffer;
+      size_t count = attr.ReadInts(buffer, kNodeAttrReadBufferSize);
+      if (count > kNodeAttrReadBufferSize) {
+        vals = attr.GetAsInts();
+        data = vals.data();
+        count = vals.size();
+      }
+      auto size = static_cast<Py_ssize_t>(count);
       PyObject* vals_obj = PyTuple_New(size);
       BA_PRECONDITION(vals_obj);
       for (Py_ssize_t i = 0; i < size; i++) {
         PyTuple_SET_ITEM(vals_obj, i,
                          PyLong_FromLong(static_cast_check_fit<long>(  // NOLINT
-                             vals[i])));
+                             data[i])));
       }
       return vals_obj;
       break;
@@ -2408,6 +2398,18 @@ void Python::SetRawConfigValue(const char* name, float value) {
   }
 }
 
+void Python::SetRawConfigValue(const char* name, const std::string& value) {
+  assert(InGameThread());
+  assert(objexists(ObjID::kConfig));
+  PythonRef value_obj(PyUnicode_FromString(value.c_str()), PythonRef::kSteal);
+  int result =
+      PyDict_SetItemString(obj(ObjID::kConfig).get(), name, value_obj.get());
+  if (result == -1) {
+    PyErr_Clear();
+    throw Exception("Error setting config dict value.");
+  }
+}
+
 auto Python::GetRawConfigValue(const char* name) -> PyObject* {
   assert(InGameThread());
   assert(objexists(ObjID::kConfig));
@@ -2614,6 +2616,15 @@ Python::ScopedInterpreterLock::ScopedInterpreterLock()
 
 Python::ScopedInterpreterLock::~ScopedInterpreterLock() { delete impl_; }
 
+Python::ScopedInterpreterLockRelease::ScopedInterpreterLockRelease() {
+  assert(HaveGIL());
+  thread_state_ = PyEval_SaveThread();
+}
+
+Python::ScopedInterpreterLockRelease::~ScopedInterpreterLockRelease() {
+  PyEval_RestoreThread(thread_state_);
+}
+
 template <typename T>
 auto IsPyEnum(Python::ObjID enum_class_id, PyObject* obj) -> bool {
   PyObject* enum_class_obj = g_python->obj(enum_class_id).get();
@@ -12,6 +12,7 @@
 
 #include "ballistica/ballistica.h"
 #include "ballistica/core/context.h"
+#include "ballistica/core/event_trace.h"
 #include "ballistica/core/object.h"
 #include "ballistica/generic/buffer.h"
 #include "ballistica/generic/runnable.h"
@@ -30,8 +31,17 @@ class Python {
    public:
     explicit ScopedCallLabel(const char* label) {
       prev_label_ = current_label_;
+      current_label_ = label;
+#if BA_ENABLE_EVENT_TRACING
+      EventTrace::Begin(label);
+#endif
+    }
+    ~ScopedCallLabel() {
+#if BA_ENABLE_EVENT_TRACING
+      EventTrace::End();
+#endif
+      current_label_ = prev_label_;
     }
-    ~ScopedCallLabel() { current_label_ = prev_label_; }
     static auto current_label() -> const char* { return current_label_; }
 
    private:
@@ -56,6 +66,19 @@ class Python {
     Impl* impl_{};
   };
 
+  /// Lets other Python threads run while we do slow native work (file io,
+  /// blocking platform calls, etc.). Nothing within its scope may touch
+  /// Python; throwing is fine though since the GIL comes back on unwind.
+  class ScopedInterpreterLockRelease {
+   public:
+    ScopedInterpreterLockRelease();
+    ~ScopedInterpreterLockRelease();
+
+   private:
+    PyThreadState* thread_state_{};
+    BA_DISALLOW_CLASS_COPIES(ScopedInterpreterLockRelease);
+  };
+
   /// Return whether the current thread holds the global-interpreter-lock.
   /// We must always hold the GIL while running python code.
   /// This *should* generally be the case by default, but this can be handy for
@@ -169,6 +192,7 @@ class Python {
   auto GetRawConfigValue(const char* name, int default_value) -> int;
   auto GetRawConfigValue(const char* name, bool default_value) -> bool;
   void SetRawConfigValue(const char* name, float value);
+  void SetRawConfigValue(const char* name, const std::string& value);
 
   void RunDeepLink(const std::string& url);
   auto GetResource(const char* key, const char* fallback_resource = nullptr,
@@ -219,6 +243,9 @@ class Python {
   }
   static auto GetPyDouble(PyObject* o) -> double;
   static auto GetPyFloats(PyObject* o) -> std::vector<float>;
+
+  /// Fill an existing vector (reusing its storage) with floats from o.
+  static void GetPyFloats(PyObject* o, std::vector<float>* vals);
   static auto GetPyInts64(PyObject* o) -> std::vector<int64_t>;
   static auto GetPyInts(PyObject* o) -> std::vector<int>;
   static auto GetPyStrings(PyObject* o) -> std::vector<std::string>;
@@ -238,6 +265,10 @@ class Python {
   static void SetNodeAttr(Node* node, const char* attr_name,
                           PyObject* value_obj);
 
+  /// Versions for when the attr has already been looked up.
+  static auto GetNodeAttr(const NodeAttribute& attr) -> PyObject*;
+  static void SetNodeAttr(const NodeAttribute& attr, PyObject* value_obj);
+
   static void SetPythonException(PyExcType exctype, const char* description);
 
   static void DoBuildNodeMessage(PyObject* args, int arg_offset,
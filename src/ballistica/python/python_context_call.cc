@@ -2,6 +2,13 @@
 
 #include "ballistica/python/python_context_call.h"
 
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "ballistica/game/host_activity.h"
 #include "ballistica/game/session/host_session.h"
 #include "ballistica/python/python.h"
@@ -12,6 +19,17 @@ namespace ballistica {
 // FIXME - should be static member var
 PythonContextCall* PythonContextCall::current_call_ = nullptr;
 
+// Per-call-site stats for SetProfilingEnabled(). Times are inclusive of
+// any calls nested within.
+struct PythonCallSiteStats {
+  int64_t calls{};
+  double seconds{};
+};
+static bool g_python_call_profiling{};
+static std::chrono::steady_clock::time_point g_python_call_profile_start;
+static std::unordered_map<std::string, PythonCallSiteStats>*
+    g_python_call_site_stats{};
+
 PythonContextCall::PythonContextCall(PyObject* obj_in) {
   assert(InGameThread());
   // as a sanity test, store the current context ptr just to make sure it
@@ -69,7 +87,14 @@ void PythonContextCall::MarkDead() {
   object_.Release();
 }
 
-void PythonContextCall::Run(PyObject* args) {
+void PythonContextCall::Run(PyObject* args) { DoRun(args, nullptr, 0); }
+
+void PythonContextCall::Run(PyObject* const* args, size_t arg_count) {
+  DoRun(nullptr, args, arg_count);
+}
+
+void PythonContextCall::DoRun(PyObject* args_tuple, PyObject* const* args,
+                              size_t arg_count) {
   assert(this);
 
   if (!g_python) {
@@ -90,22 +115,48 @@ void PythonContextCall::Run(PyObject* args) {
   }
 #endif  // BA_DEBUG_BUILD
 
-  // Restore the context from when we were made.
-  ScopedSetContext cp(context_);
+  // Restore the context from when we were made. Most timers and
+  // collision callbacks already run in their own context so we skip the
+  // swap for those (but still put it back if the call changes it).
+  std::optional<ScopedSetContext> set_context;
+  bool context_matched = (*g_context == context_);
+  if (!context_matched) {
+    set_context.emplace(context_);
+  }
 
   // Hold a ref to this call throughout this process
   // so we know it'll still exist if we need to report
   // exception info and whatnot.
   Object::Ref<PythonContextCall> keep_alive_ref(this);
 
+  std::chrono::steady_clock::time_point start_time;
+  bool profiling = g_python_call_profiling;
+  if (profiling) {
+    start_time = std::chrono::steady_clock::now();
+  }
+
   PythonContextCall* prev_call = current_call_;
   current_call_ = this;
   assert(Python::HaveGIL());
-  PyObject* o = PyObject_Call(
-      object_.get(),
-      args ? args : g_python->obj(Python::ObjID::kEmptyTuple).get(), nullptr);
+  PyObject* o;
+  if (args_tuple) {
+    o = PyObject_Call(object_.get(), args_tuple, nullptr);
+  } else {
+    o = PyObject_Vectorcall(object_.get(), args, arg_count, nullptr);
+  }
   current_call_ = prev_call;
 
+  if (profiling && g_python_call_site_stats) {
+    PythonCallSiteStats& stats = (*g_python_call_site_stats)[file_loc_];
+    stats.calls++;
+    stats.seconds += std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start_time)
+                         .count();
+  }
+  if (context_matched && !(*g_context == context_)) {
+    *g_context = context_;
+  }
+
   if (o) {
     Py_DECREF(o);
   } else {
@@ -124,6 +175,51 @@ void PythonContextCall::Run(PyObject* args) {
   }
 }
 
+void PythonContextCall::SetProfilingEnabled(bool enabled) {
+  assert(InGameThread());
+  if (enabled == g_python_call_profiling) {
+    return;
+  }
+  g_python_call_profiling = enabled;
+  if (enabled) {
+    if (g_python_call_site_stats == nullptr) {
+      g_python_call_site_stats =
+          new std::unordered_map<std::string, PythonCallSiteStats>();
+    }
+    g_python_call_site_stats->clear();
+    g_python_call_profile_start = std::chrono::steady_clock::now();
+    return;
+  }
+  assert(g_python_call_site_stats);
+  double duration = std::max(
+      std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                    - g_python_call_profile_start)
+          .count(),
+      0.001);
+  std::vector<std::pair<std::string, PythonCallSiteStats> > sites(
+      g_python_call_site_stats->begin(), g_python_call_site_stats->end());
+  g_python_call_site_stats->clear();
+  std::sort(sites.begin(), sites.end(), [](const auto& a, const auto& b) {
+    return a.second.seconds > b.second.seconds;
+  });
+  const size_t kMaxSitesShown = 20;
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "Python call profile (%.1fs, %d call sites):", duration,
+           static_cast<int>(sites.size()));
+  std::string out = buffer;
+  for (size_t i = 0; i < std::min(sites.size(), kMaxSitesShown); i++) {
+    const PythonCallSiteStats& stats = sites[i].second;
+    snprintf(buffer, sizeof(buffer), "\n  %8.1f/s %8.2fus avg %6.1fms total  ",
+             static_cast<double>(stats.calls) / duration,
+             stats.seconds * 1000000.0 / static_cast<double>(stats.calls),
+             stats.seconds * 1000.0);
+    out += buffer;
+    out += sites[i].first.empty() ? "<unknown>" : sites[i].first;
+  }
+  Log(out);
+}
+
 void PythonContextCall::LogContext() {
   assert(InGameThread());
   std::string s = std::string("  root call: ") + object().Str();
@@ -26,6 +26,9 @@ class PythonContextCall : public Object {
   explicit PythonContextCall(PyObject* callable);
   void Run(PyObject* args = nullptr);
   void Run(const PythonRef& args) { Run(args.get()); }
+
+  /// Run with positional args passed straight through (no tuple needed).
+  void Run(PyObject* const* args, size_t arg_count);
   auto Exists() const -> bool { return object_.exists(); }
   auto GetObjectDescription() const -> std::string override;
   void MarkDead();
@@ -33,8 +36,13 @@ class PythonContextCall : public Object {
   auto file_loc() const -> const std::string& { return file_loc_; }
   void LogContext();
 
+  /// Start or stop counting calls and time spent per call site (by
+  /// file_loc()). Stopping logs the busiest sites.
+  static void SetProfilingEnabled(bool enabled);
+
  private:
   void GetTrace();  // we try to grab basic trace info
+  void DoRun(PyObject* args_tuple, PyObject* const* args, size_t arg_count);
   std::string file_loc_;
   int line_{};
   bool dead_ = false;
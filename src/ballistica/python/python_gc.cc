@@ -0,0 +1,164 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/python/python_gc.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "ballistica/python/python.h"
+#include "ballistica/python/python_sys.h"
+
+namespace ballistica {
+
+// Once generation 0 is this many multiples past its threshold we collect
+// it regardless of budget.
+const int kPythonGCForceMultiplier = 8;
+
+// Full collections longer than this get a log warning.
+const double kPythonGCFullWarnSeconds = 0.1;
+
+struct PythonGCState {
+  PyObject* get_count{};
+  PyObject* get_threshold{};
+  PyObject* collect{};
+  PythonGC::GenerationStats stats[3];
+
+  // Smoothed recent durations of young collections; our guess for what
+  // the next one will take.
+  double expected_seconds[2]{};
+};
+static PythonGCState* g_python_gc{};
+
+static auto GetPythonGCState() -> PythonGCState* {
+  assert(Python::HaveGIL());
+  if (g_python_gc == nullptr) {
+    PyObject* gc_module = PyImport_ImportModule("gc");
+    BA_PRECONDITION(gc_module);
+    auto* state = new PythonGCState();
+    state->get_count = PyObject_GetAttrString(gc_module, "get_count");
+    state->get_threshold = PyObject_GetAttrString(gc_module, "get_threshold");
+    state->collect = PyObject_GetAttrString(gc_module, "collect");
+    Py_DECREF(gc_module);
+    BA_PRECONDITION(state->get_count && state->get_threshold
+                    && state->collect);
+    g_python_gc = state;
+  }
+  return g_python_gc;
+}
+
+// Fetch a 3-int tuple from one of the gc module's getters.
+static auto GetGCInts(PyObject* call, int64_t vals[3]) -> bool {
+  PyObject* result = PyObject_CallNoArgs(call);
+  if (result == nullptr) {
+    PyErr_Print();
+    return false;
+  }
+  bool ok = PyTuple_Check(result) && PyTuple_GET_SIZE(result) == 3;
+  for (Py_ssize_t i = 0; ok && i < 3; i++) {
+    vals[i] = PyLong_AsLongLong(PyTuple_GET_ITEM(result, i));
+  }
+  Py_DECREF(result);
+  if (PyErr_Occurred()) {
+    PyErr_Print();
+    ok = false;
+  }
+  return ok;
+}
+
+// Run a collection and record its duration; returns seconds taken.
+static auto Collect(PythonGCState* state, int generation,
+                    int64_t* unreachable) -> double {
+  auto start_time = std::chrono::steady_clock::now();
+  PyObject* result =
+      generation == PythonGC::kFullCollection
+          ? PyObject_CallNoArgs(state->collect)
+          : PyObject_CallFunction(state->collect, "i", generation);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start_time)
+                       .count();
+  if (result == nullptr) {
+    PyErr_Print();
+  } else {
+    if (unreachable != nullptr) {
+      *unreachable = PyLong_AsLongLong(result);
+    }
+    Py_DECREF(result);
+  }
+  PythonGC::GenerationStats& stats = state->stats[generation];
+  stats.collections++;
+  stats.total_seconds += seconds;
+  stats.max_seconds = std::max(stats.max_seconds, seconds);
+  stats.last_seconds = seconds;
+  return seconds;
+}
+
+void PythonGC::RunIdle(double budget_seconds) {
+  assert(InGameThread());
+  PythonGCState* state = GetPythonGCState();
+  int64_t counts[3];
+  int64_t thresholds[3];
+  if (!GetGCInts(state->get_count, counts)
+      || !GetGCInts(state->get_threshold, thresholds)) {
+    return;
+  }
+
+  // Mirror Python's own scheduling: generation 1 when enough generation 0
+  // collections have happened since it last ran, otherwise generation 0
+  // when enough objects have been allocated.
+  int generation;
+  if (counts[1] > thresholds[1]) {
+    generation = 1;
+  } else if (counts[0] > thresholds[0]) {
+    generation = 0;
+  } else {
+    return;
+  }
+  bool overdue = counts[0] > thresholds[0] * kPythonGCForceMultiplier;
+  bool forced{};
+  if (state->expected_seconds[generation] > budget_seconds) {
+    if (generation == 1 && counts[0] > thresholds[0]
+        && state->expected_seconds[0] <= budget_seconds) {
+      // Can't fit the bigger one; at least keep up with allocations.
+      generation = 0;
+    } else if (overdue) {
+      forced = true;
+    } else {
+      state->stats[generation].deferred++;
+      return;
+    }
+  }
+  double seconds = Collect(state, generation, nullptr);
+  if (forced) {
+    state->stats[generation].forced++;
+  }
+  double& expected = state->expected_seconds[generation];
+  expected = state->stats[generation].collections == 1
+                 ? seconds
+                 : expected * 0.8 + seconds * 0.2;
+}
+
+auto PythonGC::RunFull() -> int64_t {
+  assert(InGameThread());
+  PythonGCState* state = GetPythonGCState();
+  int64_t unreachable{};
+  double seconds = Collect(state, kFullCollection, &unreachable);
+  if (seconds > kPythonGCFullWarnSeconds) {
+    Log("Warning: full Python garbage collection took "
+        + std::to_string(static_cast<int>(seconds * 1000.0)) + "ms.");
+  }
+  return unreachable;
+}
+
+auto PythonGC::GetStats(int generation) -> const GenerationStats& {
+  BA_PRECONDITION(generation >= 0 && generation <= kFullCollection);
+  return GetPythonGCState()->stats[generation];
+}
+
+void PythonGC::ResetStats() {
+  PythonGCState* state = GetPythonGCState();
+  for (auto& stats : state->stats) {
+    stats = GenerationStats();
+  }
+}
+
+}  // namespace ballistica
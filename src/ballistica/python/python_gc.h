@@ -0,0 +1,47 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_PYTHON_PYTHON_GC_H_
+#define BALLISTICA_PYTHON_PYTHON_GC_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// Engine-controlled Python cyclic garbage collection.
+/// Automatic collection is disabled at startup (it can otherwise kick in
+/// anywhere, including mid-step). Instead, young-generation collections
+/// run in leftover time at the end of game updates when they're due and
+/// expected to fit, and full collections only happen at explicit quiet
+/// points such as activity transitions.
+class PythonGC {
+ public:
+  struct GenerationStats {
+    int64_t collections{};
+    int64_t deferred{};
+    int64_t forced{};
+    double total_seconds{};
+    double max_seconds{};
+    double last_seconds{};
+  };
+
+  /// Generation used for stats of full collections.
+  static const int kFullCollection = 2;
+
+  /// Run a generation 0 or 1 collection if Python's thresholds say one is
+  /// due and its expected duration fits within budget_seconds. Collections
+  /// that keep not fitting eventually get run anyway so young generations
+  /// can't grow without bound.
+  static void RunIdle(double budget_seconds);
+
+  /// Run a full collection; returns the number of unreachable objects.
+  static auto RunFull() -> int64_t;
+
+  static auto GetStats(int generation) -> const GenerationStats&;
+  static void ResetStats();
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_PYTHON_PYTHON_GC_H_
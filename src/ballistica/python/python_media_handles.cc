@@ -0,0 +1,104 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/python/python_media_handles.h"
+
+#include <unordered_map>
+#include <utility>
+
+#include "ballistica/core/context.h"
+#include "ballistica/game/host_activity.h"
+#include "ballistica/python/python_ref.h"
+
+namespace ballistica {
+
+// Stored objects keyed by their interned name (which we hold a ref to so
+// the pointer stays unique).
+struct PythonMediaHandlesEntry {
+  PythonRef name;
+  PythonRef media;
+};
+typedef std::unordered_map<PyObject*, PythonMediaHandlesEntry>
+    PythonMediaHandlesTable;
+
+struct PythonMediaHandlesActivity {
+  PythonMediaHandlesTable
+      tables[static_cast<int>(PythonMediaHandles::Type::kLast)];
+};
+
+static std::unordered_map<HostActivity*, PythonMediaHandlesActivity>*
+    g_python_media_handles{};
+
+static auto GetLiveActivity() -> HostActivity* {
+  HostActivity* activity = Context::current().GetHostActivity();
+  if (activity == nullptr || activity->shutting_down()) {
+    return nullptr;
+  }
+  return activity;
+}
+
+auto PythonMediaHandles::Get(Type type, PyObject* name) -> PyObject* {
+  assert(InGameThread());
+  assert(PyUnicode_Check(name));
+  if (g_python_media_handles == nullptr) {
+    return nullptr;
+  }
+  HostActivity* activity = GetLiveActivity();
+  if (activity == nullptr) {
+    return nullptr;
+  }
+  auto i = g_python_media_handles->find(activity);
+  if (i == g_python_media_handles->end()) {
+    return nullptr;
+  }
+
+  // Names given as literals are already interned, in which case this is
+  // just a flag check.
+  Py_INCREF(name);
+  PyUnicode_InternInPlace(&name);
+  PythonRef name_ref(name, PythonRef::kSteal);
+
+  auto& table = i->second.tables[static_cast<int>(type)];
+  auto j = table.find(name);
+  if (j == table.end()) {
+    return nullptr;
+  }
+  return j->second.media.NewRef();
+}
+
+void PythonMediaHandles::Store(Type type, PyObject* name, PyObject* media) {
+  assert(InGameThread());
+  assert(PyUnicode_Check(name));
+  assert(media);
+  HostActivity* activity = GetLiveActivity();
+  if (activity == nullptr) {
+    return;
+  }
+  if (g_python_media_handles == nullptr) {
+    g_python_media_handles =
+        new std::unordered_map<HostActivity*, PythonMediaHandlesActivity>();
+  }
+  Py_INCREF(name);
+  PyUnicode_InternInPlace(&name);
+  PythonRef name_ref(name, PythonRef::kSteal);
+  auto& table =
+      (*g_python_media_handles)[activity].tables[static_cast<int>(type)];
+  table[name] = {name_ref, PythonRef(media, PythonRef::kAcquire)};
+}
+
+void PythonMediaHandles::ClearActivity(HostActivity* activity) {
+  assert(InGameThread());
+  if (g_python_media_handles == nullptr) {
+    return;
+  }
+  auto i = g_python_media_handles->find(activity);
+  if (i == g_python_media_handles->end()) {
+    return;
+  }
+
+  // Pull the tables out before releasing anything; media dying here
+  // shouldn't find us mid-erase.
+  PythonMediaHandlesActivity handles = std::move(i->second);
+  g_python_media_handles->erase(i);
+}
+
+}  // namespace ballistica
@@ -0,0 +1,37 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_PYTHON_PYTHON_MEDIA_HANDLES_H_
+#define BALLISTICA_PYTHON_PYTHON_MEDIA_HANDLES_H_
+
+#include "ballistica/ballistica.h"
+#include "ballistica/python/python_sys.h"
+
+namespace ballistica {
+
+/// Per-activity tables of the Python media objects handed out by
+/// ba.gettexture() and friends, keyed by interned name. Repeat requests
+/// for a name within an activity then resolve with a single pointer-keyed
+/// lookup and get back the very same object, without going through the
+/// activity's string-keyed maps or (when nothing else was holding the
+/// media) the media lists and their lock. Everything is held until the
+/// activity dies. Game thread only.
+class PythonMediaHandles {
+ public:
+  enum class Type { kTexture, kSound, kData, kModel, kCollideModel, kLast };
+
+  /// Return a new reference to the object stored for a name in the current
+  /// activity, or nullptr if there is none (or we're not in a live
+  /// activity).
+  static auto Get(Type type, PyObject* name) -> PyObject*;
+
+  /// Store an object handed out for a name in the current activity. Does
+  /// nothing outside of live activities.
+  static void Store(Type type, PyObject* name, PyObject* media);
+
+  /// Drop everything stored for an activity; called as it dies.
+  static void ClearActivity(HostActivity* activity);
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_PYTHON_PYTHON_MEDIA_HANDLES_H_
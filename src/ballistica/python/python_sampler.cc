@@ -0,0 +1,170 @@
+// Released under the MIT License. See LICENSE for details.
+
+#include "ballistica/python/python_sampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ballistica/core/thread.h"
+#include "ballistica/platform/platform.h"
+#include "ballistica/python/python.h"
+#include "ballistica/python/python_sys.h"
+
+namespace ballistica {
+
+// Deeper stacks get cut off at the root end.
+const size_t kPythonSamplerMaxDepth = 64;
+
+// Everything here is only touched with the GIL held, except for
+// stopping which is atomic. (Intentionally leaked so we can't die out
+// from under a running sampler at shutdown).
+struct PythonSamplerState {
+  std::string path;
+  std::chrono::microseconds interval{};
+  PyThreadState* game_thread_state{};
+  std::thread thread;
+  std::atomic<bool> stopping{};
+  std::unordered_map<std::string, int64_t> stack_counts;
+  int64_t sample_count{};
+};
+static PythonSamplerState* g_python_sampler{};
+
+static auto DescribeFrame(PyFrameObject* frame) -> std::string {
+  PyCodeObject* code = frame->f_code;
+  const char* name = PyUnicode_AsUTF8(code->co_name);
+  const char* file = PyUnicode_AsUTF8(code->co_filename);
+  std::string file_str = file ? file : "?";
+  size_t slash = file_str.find_last_of("/\\");
+  if (slash != std::string::npos) {
+    file_str = file_str.substr(slash + 1);
+  }
+
+  // Semicolons separate frames in folded output.
+  std::string out = std::string(name ? name : "?") + " (" + file_str + ":"
+                    + std::to_string(code->co_firstlineno) + ")";
+  std::replace(out.begin(), out.end(), ';', ':');
+  return out;
+}
+
+static void TakePythonSample(PythonSamplerState* state) {
+  assert(Python::HaveGIL());
+  std::vector<PyFrameObject*> frames;
+  for (PyFrameObject* f = state->game_thread_state->frame;
+       f != nullptr && frames.size() < kPythonSamplerMaxDepth; f = f->f_back) {
+    frames.push_back(f);
+  }
+  std::string stack;
+  if (const char* label = Python::ScopedCallLabel::current_label()) {
+    stack = std::string("[") + label + "]";
+  }
+  if (frames.empty()) {
+    if (stack.empty()) {
+      stack = "(idle)";
+    }
+  } else {
+    for (auto i = frames.rbegin(); i != frames.rend(); ++i) {
+      if (!stack.empty()) {
+        stack += ";";
+      }
+      stack += DescribeFrame(*i);
+    }
+  }
+  state->stack_counts[stack]++;
+  state->sample_count++;
+}
+
+static void RunPythonSampler(PythonSamplerState* state) {
+  Thread::AddCurrentThreadName("pysampler");
+
+  // Make ourself a thread-state once and then just pass the GIL back and
+  // forth with it.
+  PyGILState_STATE gil_state = PyGILState_Ensure();
+  PyThreadState* thread_state = PyEval_SaveThread();
+  auto next_sample = std::chrono::steady_clock::now();
+  while (!state->stopping.load()) {
+    next_sample += state->interval;
+    std::this_thread::sleep_until(next_sample);
+    PyEval_RestoreThread(thread_state);
+    if (!state->stopping.load()) {
+      TakePythonSample(state);
+    }
+    PyEval_SaveThread();
+
+    // If we fall way behind (GIL held for ages), don't try to catch up.
+    next_sample = std::max(next_sample, std::chrono::steady_clock::now());
+  }
+  PyEval_RestoreThread(thread_state);
+  PyGILState_Release(gil_state);
+  Thread::ClearCurrentThreadName();
+}
+
+auto PythonSampler::running() -> bool {
+  return g_python_sampler != nullptr && g_python_sampler->thread.joinable();
+}
+
+void PythonSampler::Start(const std::string& path, float rate) {
+  assert(InGameThread());
+  assert(Python::HaveGIL());
+  if (running()) {
+    throw Exception("Python sampler is already running.");
+  }
+  if (!(rate > 0.0f && rate <= 10000.0f)) {
+    throw Exception("Sample rate must be between 0 and 10000.",
+                    PyExcType::kValue);
+  }
+  if (g_python_sampler == nullptr) {
+    g_python_sampler = new PythonSamplerState();
+  }
+  PythonSamplerState* state = g_python_sampler;
+  state->path = path;
+  state->interval = std::chrono::microseconds(
+      std::max(static_cast<int64_t>(1000000.0f / rate), int64_t{100}));
+  state->game_thread_state = PyThreadState_Get();
+  state->stopping = false;
+  state->stack_counts.clear();
+  state->sample_count = 0;
+  state->thread = std::thread(RunPythonSampler, state);
+}
+
+void PythonSampler::Stop() {
+  assert(InGameThread());
+  assert(Python::HaveGIL());
+  if (!running()) {
+    return;
+  }
+  PythonSamplerState* state = g_python_sampler;
+  state->stopping = true;
+
+  // The sampler may be waiting on the GIL; give it up while we wait.
+  Py_BEGIN_ALLOW_THREADS;
+  state->thread.join();
+  Py_END_ALLOW_THREADS;
+
+  // Biggest first; makes the file somewhat readable as-is.
+  std::vector<std::pair<std::string, int64_t> > stacks(
+      state->stack_counts.begin(), state->stack_counts.end());
+  state->stack_counts.clear();
+  std::sort(stacks.begin(), stacks.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+  FILE* f = g_platform->FOpen(state->path.c_str(), "wb");
+  if (!f) {
+    Log("Error: Unable to write Python samples to '" + state->path + "'.");
+    return;
+  }
+  for (auto&& stack : stacks) {
+    fprintf(f, "%s %lld\n", stack.first.c_str(),
+            static_cast<long long>(stack.second));  // NOLINT
+  }
+  fclose(f);
+  Log("Wrote " + std::to_string(state->sample_count) + " Python samples ("
+      + std::to_string(stacks.size()) + " unique stacks) to '" + state->path
+      + "'.");
+}
+
+}  // namespace ballistica
@@ -0,0 +1,37 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_PYTHON_PYTHON_SAMPLER_H_
+#define BALLISTICA_PYTHON_PYTHON_SAMPLER_H_
+
+#include <string>
+
+#include "ballistica/ballistica.h"
+
+namespace ballistica {
+
+/// A sampling profiler for Python code running in the game thread.
+/// A helper thread periodically grabs the GIL and records the game
+/// thread's current Python stack (plus any Python::ScopedCallLabel), and
+/// stopping writes the totals to a file in 'folded' format (one
+/// 'frame;frame;frame count' line per unique stack) for use with
+/// flamegraph tools.
+///
+/// Since samples are taken when the game thread yields the GIL, they land
+/// on Python bytecode boundaries; time the game thread spends waiting
+/// shows up as '(idle)' and time in long-running C++ gets attributed to
+/// whatever Python runs next.
+class PythonSampler {
+ public:
+  /// Start sampling at the given rate (per second), writing results to
+  /// path when stopped. Must be called from the game thread.
+  static void Start(const std::string& path, float rate);
+
+  /// Stop sampling (if running) and write results.
+  static void Stop();
+
+  static auto running() -> bool;
+};
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_PYTHON_PYTHON_SAMPLER_H_
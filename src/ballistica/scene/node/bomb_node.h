@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_SCENE_NODE_BOMB_NODE_H_
 #define BALLISTICA_SCENE_NODE_BOMB_NODE_H_
 
+#include "ballistica/core/object_pool.h"
 #include "ballistica/dynamics/bg/bg_dynamics_fuse.h"
 #include "ballistica/scene/node/prop_node.h"
 
@@ -10,6 +11,7 @@ namespace ballistica {
 
 class BombNode : public PropNode {
  public:
+  BA_OBJECT_POOLED(BombNode);
   static auto InitType() -> NodeType*;
   explicit BombNode(Scene* scene);
   void Step() override;
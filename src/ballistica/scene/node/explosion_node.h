@@ -5,24 +5,26 @@
 
 #include <vector>
 
+#include "ballistica/core/object_pool.h"
 #include "ballistica/scene/node/node.h"
 
 namespace ballistica {
 
 class ExplosionNode : public Node {
  public:
+  BA_OBJECT_POOLED(ExplosionNode);
   static auto InitType() -> NodeType*;
   explicit ExplosionNode(Scene* scene);
   ~ExplosionNode() override;
   void Draw(FrameDef* frame_def) override;
   void Step() override;
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void set_position(const std::vector<float>& vals);
-  auto velocity() const -> std::vector<float> { return velocity_; }
+  auto velocity() const -> const std::vector<float>& { return velocity_; }
   void set_velocity(const std::vector<float>& vals);
   auto radius() const -> float { return radius_; }
   void set_radius(float val) { radius_ = val; }
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void set_color(const std::vector<float>& vals);
   auto big() const -> bool { return big_; }
   void set_big(bool val);
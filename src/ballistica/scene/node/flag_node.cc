@@ -10,6 +10,7 @@
 #include "ballistica/graphics/component/simple_component.h"
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/scene/node/node_attribute.h"
+#include "ballistica/scene/node/node_message.h"
 #include "ballistica/scene/node/node_type.h"
 #include "ballistica/scene/scene.h"
 
@@ -32,6 +33,10 @@ const float kFlagCanvasScaleDiagonal{
 const float kFlagRadius{0.1f};
 const float kFlagHeight{1.5f};
 
+// Covers the pole plus the cloth flapping off any side of it.
+const float kFlagCullRadius{kFlagHeight * 0.5f + kFlagCanvasWidth
+                            + kFlagCanvasHeight};
+
 const float kFlagMassRadius{0.3f};
 const float kFlagMassHeight{1.0f};
 
@@ -212,34 +217,19 @@ void FlagNode::HandleMessage(const char* data_in) {
 
   switch (extract_node_message_type(&data)) {
     case NodeMessageType::kFooting: {
-      footing_ += Utils::ExtractInt8(&data);
+      footing_ += NodeFootingMessage::Extract(data).delta;
       break;
     }
 
     case NodeMessageType::kImpulse: {
-      float px = Utils::ExtractFloat16NBO(&data);
-      float py = Utils::ExtractFloat16NBO(&data);
-      float pz = Utils::ExtractFloat16NBO(&data);
-
-      float vx = Utils::ExtractFloat16NBO(&data);
-      float vy = Utils::ExtractFloat16NBO(&data);
-      float vz = Utils::ExtractFloat16NBO(&data);
-
-      float mag = Utils::ExtractFloat16NBO(&data);
-      float velocity_mag = Utils::ExtractFloat16NBO(&data);
-      float radius = Utils::ExtractFloat16NBO(&data);
-      Utils::ExtractInt16NBO(&data);  // calc-force-only
-
-      float force_dir_x = Utils::ExtractFloat16NBO(&data);
-      float force_dir_y = Utils::ExtractFloat16NBO(&data);
-      float force_dir_z = Utils::ExtractFloat16NBO(&data);
-
+      // (calc-force-only is ignored here)
+      auto m = NodeImpulseMessage::Extract(data);
       float applied_mag = body_->ApplyImpulse(
-          px, py, pz, vx, vy, vz, force_dir_x, force_dir_y, force_dir_z,
-          0.2f * mag, 0.2f * velocity_mag, radius, false);
+          m.px, m.py, m.pz, m.vx, m.vy, m.vz, m.force_dir_x, m.force_dir_y,
+          m.force_dir_z, 0.2f * m.mag, 0.2f * m.velocity_mag, m.radius, false);
 
-      Vector3f to_flag =
-          Vector3f(px, py, pz) - Vector3f(dBodyGetPosition(body_->body()));
+      Vector3f to_flag = Vector3f(m.px, m.py, m.pz)
+                         - Vector3f(dBodyGetPosition(body_->body()));
       to_flag *= -0.0001f * applied_mag / to_flag.Length();
 
       flag_impulse_add_x_ += to_flag.x;
@@ -261,26 +251,31 @@ void FlagNode::Draw(FrameDef* frame_def) {
 
   // Flag cloth.
   {
-    // Update the dynamic portion of our mesh data.
+    // Update the dynamic portion of our mesh data if the cloth has moved
+    // since we last drew (we often draw several frames per step); the
+    // renderer only re-uploads when we hand it new data.
     // FIXME - should move this all to BG dynamics thread
-    auto v_dynamic(Object::New<MeshBuffer<VertexObjectSplitDynamic>>(25));
-
-    VertexObjectSplitDynamic* vd = &v_dynamic->elements[0];
-    for (int i = 0; i < 25; i++) {
-      vd[i].position[0] = flag_points_[i].x;
-      vd[i].position[1] = flag_points_[i].y;
-      vd[i].position[2] = flag_points_[i].z;
-      vd[i].normal[0] = static_cast_check_fit<int16_t>(std::max(
-          -32767,
-          std::min(32767, static_cast<int>(flag_normals_[i].x * 32767.0f))));
-      vd[i].normal[1] = static_cast_check_fit<int16_t>(std::max(
-          -32767,
-          std::min(32767, static_cast<int>(flag_normals_[i].y * 32767.0f))));
-      vd[i].normal[2] = static_cast_check_fit<int16_t>(std::max(
-          -32767,
-          std::min(32767, static_cast<int>(flag_normals_[i].z * 32767.0f))));
+    if (flag_mesh_dirty_) {
+      flag_mesh_dirty_ = false;
+      auto v_dynamic(Object::New<MeshBuffer<VertexObjectSplitDynamic>>(25));
+
+      VertexObjectSplitDynamic* vd = &v_dynamic->elements[0];
+      for (int i = 0; i < 25; i++) {
+        vd[i].position[0] = flag_points_[i].x;
+        vd[i].position[1] = flag_points_[i].y;
+        vd[i].position[2] = flag_points_[i].z;
+        vd[i].normal[0] = static_cast_check_fit<int16_t>(std::max(
+            -32767,
+            std::min(32767, static_cast<int>(flag_normals_[i].x * 32767.0f))));
+        vd[i].normal[1] = static_cast_check_fit<int16_t>(std::max(
+            -32767,
+            std::min(32767, static_cast<int>(flag_normals_[i].y * 32767.0f))));
+        vd[i].normal[2] = static_cast_check_fit<int16_t>(std::max(
+            -32767,
+            std::min(32767, static_cast<int>(flag_normals_[i].z * 32767.0f))));
+      }
+      mesh_.SetDynamicData(v_dynamic);
     }
-    mesh_.SetDynamicData(v_dynamic);
 
     // Render a subtle sharp shadow in higher quality modes.
     if (frame_def->quality() > GraphicsQuality::kLow) {
@@ -295,13 +290,15 @@ void FlagNode::Draw(FrameDef* frame_def) {
     // Now beauty pass.
     {
       ObjectComponent c(frame_def->beauty_pass());
-      c.SetWorldSpace(true);
-      c.SetColor(color_[0], color_[1], color_[2]);
-      c.SetReflection(ReflectionType::kSoft);
-      c.SetReflectionScale(0.05f, 0.05f, 0.05f);
-      c.SetDoubleSided(true);
-      c.SetTexture(color_texture_);
-      c.DrawMesh(&mesh_);
+      if (!c.IsBodyCulled(*body_, kFlagCullRadius)) {
+        c.SetWorldSpace(true);
+        c.SetColor(color_[0], color_[1], color_[2]);
+        c.SetReflection(ReflectionType::kSoft);
+        c.SetReflectionScale(0.05f, 0.05f, 0.05f);
+        c.SetDoubleSided(true);
+        c.SetTexture(color_texture_);
+        c.DrawMesh(&mesh_);
+      }
       c.Submit();
     }
 
@@ -353,13 +350,15 @@ void FlagNode::Draw(FrameDef* frame_def) {
   // Flag pole.
   {
     ObjectComponent c(frame_def->beauty_pass());
-    c.SetTexture(g_media->GetTexture(SystemTextureID::kFlagPole));
-    c.SetReflection(ReflectionType::kSharp);
-    c.SetReflectionScale(0.1f, 0.1f, 0.1f);
-    c.PushTransform();
-    c.TransformToBody(*body_);
-    c.DrawModel(g_media->GetModel(SystemModelID::kFlagPole));
-    c.PopTransform();
+    if (!c.IsBodyCulled(*body_, kFlagCullRadius)) {
+      c.SetTexture(g_media->GetTexture(SystemTextureID::kFlagPole));
+      c.SetReflection(ReflectionType::kSharp);
+      c.SetReflectionScale(0.1f, 0.1f, 0.1f);
+      c.PushTransform();
+      c.TransformToBody(*body_);
+      c.DrawModel(g_media->GetModel(SystemModelID::kFlagPole));
+      c.PopTransform();
+    }
     c.Submit();
   }
 
@@ -494,7 +493,10 @@ void FlagNode::Step() {
       }
     }
   }
+  // The cloth is purely visual; no need to simulate it if we never draw.
+#if !BA_HEADLESS_BUILD
   UpdateFlagMesh();
+#endif  // !BA_HEADLESS_BUILD
 }
 
 auto FlagNode::GetRigidBody(int id) -> RigidBody* { return body_.get(); }
@@ -541,6 +543,7 @@ void FlagNode::ResetFlagMesh() {
   }
   flag_impulse_add_x_ = flag_impulse_add_y_ = flag_impulse_add_z_ = 0;
   have_flag_impulse_ = false;
+  flag_mesh_dirty_ = true;
 }
 
 void FlagNode::UpdateFlagMesh() {
@@ -653,7 +656,7 @@ void FlagNode::UpdateFlagMesh() {
                           flag_points_[i + kFlagSizeX] - flag_points_[i])
               .Normalized();
     }
-  }
+  }  flag_mesh_dirty_ = true;
 }
 
 void FlagNode::GetRigidBodyPickupLocations(int id, float* obj, float* character,
@@ -30,7 +30,7 @@ class FlagNode : public Node {
   void set_color_texture(Texture* val) { color_texture_ = val; }
   auto light_weight() const -> bool { return light_weight_; }
   void SetLightWeight(bool val);
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& vals);
   auto GetMaterials() const -> std::vector<Material*>;
   void SetMaterials(const std::vector<Material*>& materials);
@@ -70,6 +70,7 @@ class FlagNode : public Node {
   Vector3f flag_points_[25]{};
   Vector3f flag_normals_[25]{};
   Vector3f flag_velocities_[25]{};
+  bool flag_mesh_dirty_{true};  // Cloth moved since we last drew?
 };
 
 }  // namespace ballistica
@@ -5,21 +5,23 @@
 
 #include <vector>
 
+#include "ballistica/core/object_pool.h"
 #include "ballistica/scene/node/node.h"
 
 namespace ballistica {
 
 class FlashNode : public Node {
  public:
+  BA_OBJECT_POOLED(FlashNode);
   static auto InitType() -> NodeType*;
   explicit FlashNode(Scene* scene);
   ~FlashNode() override;
   void Draw(FrameDef* frame_def) override;
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& vals);
   auto size() const -> float { return size_; }
   void set_size(float val) { size_ = val; }
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void set_color(const std::vector<float>& vals) { color_ = vals; }
 
  private:
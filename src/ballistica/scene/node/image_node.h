@@ -19,17 +19,17 @@ class ImageNode : public Node {
   explicit ImageNode(Scene* scene);
   ~ImageNode() override;
   void Draw(FrameDef* frame_def) override;
-  auto scale() const -> std::vector<float> { return scale_; }
+  auto scale() const -> const std::vector<float>& { return scale_; }
   void SetScale(const std::vector<float>& scale);
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& val);
   auto opacity() const -> float { return opacity_; }
   void set_opacity(float val) { opacity_ = val; }
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& val);
-  auto tint_color() const -> std::vector<float> { return tint_color_; }
+  auto tint_color() const -> const std::vector<float>& { return tint_color_; }
   void SetTintColor(const std::vector<float>& val);
-  auto tint2_color() const -> std::vector<float> { return tint2_color_; }
+  auto tint2_color() const -> const std::vector<float>& { return tint2_color_; }
   void SetTint2Color(const std::vector<float>& val);
   auto fill_screen() const -> bool { return fill_screen_; }
   void SetFillScreen(bool val);
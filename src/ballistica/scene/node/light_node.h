@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "ballistica/core/object_pool.h"
 #include "ballistica/dynamics/bg/bg_dynamics_shadow.h"
 #include "ballistica/scene/node/node.h"
 
@@ -13,11 +14,12 @@ namespace ballistica {
 // A light source
 class LightNode : public Node {
  public:
+  BA_OBJECT_POOLED(LightNode);
   static auto InitType() -> NodeType*;
   explicit LightNode(Scene* scene);
   void Draw(FrameDef* frame_def) override;
   void Step() override;
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& val);
   auto intensity() const -> float { return intensity_; }
   void SetIntensity(float val);
@@ -25,7 +27,7 @@ class LightNode : public Node {
     return volume_intensity_scale_;
   }
   void SetVolumeIntensityScale(float val);
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& val);
   auto radius() const -> float { return radius_; }
   void SetRadius(float val);
@@ -17,16 +17,16 @@ class LocatorNode : public Node {
 
   void Draw(FrameDef* frame_def) override;
 
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& vals);
 
   auto visibility() const -> bool { return visibility_; }
   void set_visibility(bool val) { visibility_ = val; }
 
-  auto size() const -> std::vector<float> { return size_; }
+  auto size() const -> const std::vector<float>& { return size_; }
   void SetSize(const std::vector<float>& vals);
 
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& vals);
 
   auto opacity() const -> float { return opacity_; }
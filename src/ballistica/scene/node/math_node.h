@@ -19,7 +19,7 @@ class MathNode : public Node {
   auto GetOutput() -> std::vector<float>;
   auto input_1() const -> const std::vector<float>& { return input_1_; }
   void set_input_1(const std::vector<float>& vals) { input_1_ = vals; }
-  auto input_2() const -> std::vector<float> { return input_2_; }
+  auto input_2() const -> const std::vector<float>& { return input_2_; }
   void set_input_2(const std::vector<float>& vals) { input_2_ = vals; }
   auto GetOperation() const -> std::string;
   void SetOperation(const std::string& val);
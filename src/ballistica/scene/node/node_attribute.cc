@@ -2,6 +2,8 @@
 
 #include "ballistica/scene/node/node_attribute.h"
 
+#include <algorithm>
+
 #include "ballistica/scene/node/node.h"
 #include "ballistica/scene/node/node_attribute_connection.h"
 #include "ballistica/scene/node/node_type.h"
@@ -154,6 +156,20 @@ void NodeAttributeUnbound::Set(Node* node, const std::vector<int64_t>& value) {
                   + node_type()->name() + "' as an int array.");
 }
 
+auto NodeAttributeUnbound::ReadFloats(Node* node, float* out, size_t capacity)
+    -> size_t {
+  std::vector<float> vals = GetAsFloats(node);
+  std::copy_n(vals.begin(), std::min(vals.size(), capacity), out);
+  return vals.size();
+}
+
+auto NodeAttributeUnbound::ReadInts(Node* node, int64_t* out, size_t capacity)
+    -> size_t {
+  std::vector<int64_t> vals = GetAsInts(node);
+  std::copy_n(vals.begin(), std::min(vals.size(), capacity), out);
+  return vals.size();
+}
+
 auto NodeAttributeUnbound::GetAsNode(Node* node) -> Node* {
   throw Exception("Can't get attr '" + name() + "' on node type '"
                   + node_type()->name() + "' as a node.");
@@ -3,6 +3,7 @@
 #ifndef BALLISTICA_SCENE_NODE_NODE_ATTRIBUTE_H_
 #define BALLISTICA_SCENE_NODE_NODE_ATTRIBUTE_H_
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -13,6 +14,10 @@ namespace ballistica {
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "OCUnusedMacroInspection"
 
+// A handy stack buffer size for ReadFloats()/ReadInts(); covers positions,
+// colors, and most other array attrs.
+const size_t kNodeAttrReadBufferSize = 16;
+
 // Unbound node attribute; these are statically stored in a node type
 // and contain logic to get/set a particular attribute on a node
 // in various ways.
@@ -84,6 +89,13 @@ class NodeAttributeUnbound {
   virtual auto GetAsCollideModels(Node* node) -> std::vector<CollideModel*>;
   virtual void Set(Node* node, const std::vector<CollideModel*>& values);
 
+  // Allocation-free array reads: these copy up to capacity values to out
+  // and return the full count (so callers can fall back to the vector
+  // versions when it's larger). By default they wrap the vector versions;
+  // attrs bound to stored arrays skip the temporary.
+  virtual auto ReadFloats(Node* node, float* out, size_t capacity) -> size_t;
+  virtual auto ReadInts(Node* node, int64_t* out, size_t capacity) -> size_t;
+
   auto is_read_only() const -> bool {
     return static_cast<bool>(flags_ & kNodeAttributeFlagReadOnly);
   }
@@ -127,7 +139,7 @@ class NodeAttribute {
   auto name() const -> const std::string& { return attr->name(); }
   auto node_type() const -> NodeType* { return attr->node_type(); }
   auto index() const -> int { return attr->index(); }
-  void DisconnectIncoming() { attr->DisconnectIncoming(node); }
+  void DisconnectIncoming() const { attr->DisconnectIncoming(node); }
   auto is_read_only() const -> bool { return attr->is_read_only(); }
   auto GetAsFloat() const -> float { return attr->GetAsFloat(node); }
   void Set(float value) const { attr->Set(node, value); }
@@ -140,10 +152,16 @@ class NodeAttribute {
   auto GetAsFloats() const -> std::vector<float> {
     return attr->GetAsFloats(node);
   }
+  auto ReadFloats(float* out, size_t capacity) const -> size_t {
+    return attr->ReadFloats(node, out, capacity);
+  }
   void Set(const std::vector<float>& value) const { attr->Set(node, value); }
   auto GetAsInts() const -> std::vector<int64_t> {
     return attr->GetAsInts(node);
   }
+  auto ReadInts(int64_t* out, size_t capacity) const -> size_t {
+    return attr->ReadInts(node, out, capacity);
+  }
   void Set(const std::vector<int64_t>& value) const { attr->Set(node, value); }
   auto GetAsNode() const -> Node* { return attr->GetAsNode(node); }
   void Set(Node* value) const { attr->Set(node, value); }
@@ -564,6 +582,14 @@ class NodeAttributeUnboundCollideModelArray : public NodeAttributeUnbound {
       assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
       return tnode->GETTER();                                             \
     }                                                                     \
+    auto ReadFloats(Node* node, float* out, size_t capacity)              \
+        -> size_t override {                                              \
+      BA_NODE_TYPE_CLASS* tnode = static_cast<BA_NODE_TYPE_CLASS*>(node); \
+      assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
+      const std::vector<float>& vals = tnode->GETTER();                   \
+      std::copy_n(vals.begin(), std::min(vals.size(), capacity), out);    \
+      return vals.size();                                                 \
+    }                                                                     \
     void Set(Node* node, const std::vector<float>& vals) override {       \
       BA_NODE_TYPE_CLASS* tnode = static_cast<BA_NODE_TYPE_CLASS*>(node); \
       assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
@@ -585,6 +611,14 @@ class NodeAttributeUnboundCollideModelArray : public NodeAttributeUnbound {
       assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
       return tnode->GETTER();                                             \
     }                                                                     \
+    auto ReadFloats(Node* node, float* out, size_t capacity)              \
+        -> size_t override {                                              \
+      BA_NODE_TYPE_CLASS* tnode = static_cast<BA_NODE_TYPE_CLASS*>(node); \
+      assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
+      const std::vector<float>& vals = tnode->GETTER();                   \
+      std::copy_n(vals.begin(), std::min(vals.size(), capacity), out);    \
+      return vals.size();                                                 \
+    }                                                                     \
   };                                                                      \
   Attr_##NAME NAME;
 
@@ -672,6 +706,14 @@ class NodeAttributeUnboundCollideModelArray : public NodeAttributeUnbound {
       assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
       return tnode->GETTER();                                             \
     }                                                                     \
+    auto ReadInts(Node* node, int64_t* out, size_t capacity)              \
+        -> size_t override {                                              \
+      BA_NODE_TYPE_CLASS* tnode = static_cast<BA_NODE_TYPE_CLASS*>(node); \
+      assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
+      const std::vector<int64_t>& vals = tnode->GETTER();                 \
+      std::copy_n(vals.begin(), std::min(vals.size(), capacity), out);    \
+      return vals.size();                                                 \
+    }                                                                     \
     void Set(Node* node, const std::vector<int64_t>& vals) override {     \
       BA_NODE_TYPE_CLASS* tnode = static_cast<BA_NODE_TYPE_CLASS*>(node); \
       assert(dynamic_cast<BA_NODE_TYPE_CLASS*>(node) == tnode);           \
@@ -2,12 +2,19 @@
 
 #include "ballistica/scene/node/node_attribute_connection.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "ballistica/scene/node/node.h"
 #include "ballistica/scene/node/node_attribute.h"
 #include "ballistica/scene/node/node_type.h"
 
 namespace ballistica {
 
+NodeAttributeConnection::~NodeAttributeConnection() = default;
+
 void NodeAttributeConnection::Update() {
   assert(src_node.exists() && dst_node.exists());
   auto* src_node_p{src_node.get()};
@@ -26,25 +33,75 @@ void NodeAttributeConnection::Update() {
     NodeAttributeUnbound* dst_attr =
         dst_node->type()->GetAttribute(dst_attr_index);
     assert(dst_attr);
+    bool dst_passive = !dst_node->type()->has_step();
     switch (dst_attr->type()) {
-      case NodeAttributeType::kFloat:
-        dst_attr->Set(dst_node.get(), src_attr->GetAsFloat(src_node_p));
-        break;
-      case NodeAttributeType::kInt:
-        dst_attr->Set(dst_node.get(), src_attr->GetAsInt(src_node_p));
-        break;
-      case NodeAttributeType::kBool:
-        dst_attr->Set(dst_node.get(), src_attr->GetAsBool(src_node_p));
-        break;
-      case NodeAttributeType::kString:
-        dst_attr->Set(dst_node.get(), src_attr->GetAsString(src_node_p));
-        break;
+      case NodeAttributeType::kFloat: {
+        float value = src_attr->GetAsFloat(src_node_p);
+        if (dst_passive && have_last_value && value == last_float) {
+          return;
+        }
+        dst_attr->Set(dst_node.get(), value);
+        last_float = value;
+        have_last_value = true;
+        break;
+      }
+      case NodeAttributeType::kInt: {
+        int64_t value = src_attr->GetAsInt(src_node_p);
+        if (dst_passive && have_last_value && value == last_int) {
+          return;
+        }
+        dst_attr->Set(dst_node.get(), value);
+        last_int = value;
+        have_last_value = true;
+        break;
+      }
+      case NodeAttributeType::kBool: {
+        bool value = src_attr->GetAsBool(src_node_p);
+        if (dst_passive && have_last_value && value == (last_int != 0)) {
+          return;
+        }
+        dst_attr->Set(dst_node.get(), value);
+        last_int = value;
+        have_last_value = true;
+        break;
+      }
+      case NodeAttributeType::kString: {
+        std::string value = src_attr->GetAsString(src_node_p);
+        if (dst_passive && have_last_value && value == last_string) {
+          return;
+        }
+        dst_attr->Set(dst_node.get(), value);
+        last_string = std::move(value);
+        have_last_value = true;
+        break;
+      }
       case NodeAttributeType::kIntArray:
         dst_attr->Set(dst_node.get(), src_attr->GetAsInts(src_node_p));
         break;
-      case NodeAttributeType::kFloatArray:
-        dst_attr->Set(dst_node.get(), src_attr->GetAsFloats(src_node_p));
-        break;
+      case NodeAttributeType::kFloatArray: {
+        // Read into our stored copy without allocating where possible;
+        // (after the first update it already has the capacity we need).
+        float buffer[kNodeAttrReadBufferSize];
+        size_t count =
+            src_attr->ReadFloats(src_node_p, buffer, kNodeAttrReadBufferSize);
+        if (count > kNodeAttrReadBufferSize) {
+          std::vector<float> value = src_attr->GetAsFloats(src_node_p);
+          if (dst_passive && have_last_value && value == last_floats) {
+            return;
+          }
+          last_floats = std::move(value);
+        } else {
+          if (dst_passive && have_last_value && count == last_floats.size()
+              && std::equal(buffer, buffer + count, last_floats.begin())) {
+            return;
+          }
+          last_floats.assign(buffer, buffer + count);
+        }
+        have_last_value = false;  // (Until the set goes through).
+        dst_attr->Set(dst_node.get(), last_floats);
+        have_last_value = true;
+        break;
+      }
       case NodeAttributeType::kNode:
         dst_attr->Set(dst_node.get(), src_attr->GetAsNode(src_node_p));
         break;
@@ -4,20 +4,35 @@
 #define BALLISTICA_SCENE_NODE_NODE_ATTRIBUTE_CONNECTION_H_
 
 #include <list>
+#include <string>
+#include <vector>
 
 #include "ballistica/core/object.h"
+#include "ballistica/core/object_pool.h"
 
 namespace ballistica {
 
 class NodeAttributeConnection : public Object {
  public:
+  BA_OBJECT_POOLED(NodeAttributeConnection);
   NodeAttributeConnection() = default;
+  ~NodeAttributeConnection() override;
   void Update();
   Object::WeakRef<Node> src_node;
   int src_attr_index{};
   Object::WeakRef<Node> dst_node;
   int dst_attr_index{};
   bool have_error{};
+
+  // The last value we pushed (for the common value types). Nodes that
+  // don't step never change connected attrs themselves (and setting attrs
+  // from Python breaks the connection) so we can skip re-setting those
+  // to what they already have.
+  bool have_last_value{};
+  float last_float{};
+  int64_t last_int{};
+  std::string last_string;
+  std::vector<float> last_floats;
   std::list<Object::Ref<NodeAttributeConnection> >::iterator src_iterator;
 };
 
@@ -0,0 +1,227 @@
+// Released under the MIT License. See LICENSE for details.
+
+#ifndef BALLISTICA_SCENE_NODE_NODE_MESSAGE_H_
+#define BALLISTICA_SCENE_NODE_NODE_MESSAGE_H_
+
+#include <cstring>
+
+#include "ballistica/ballistica.h"
+#include "ballistica/generic/utils.h"
+
+namespace ballistica {
+
+// Node messages go out as a type byte followed by packed fields as laid out
+// by a format string. Types: I is 32 bit int, i is 16 bit int, c is 8 bit
+// int, F is 32 bit float, f is 16 bit float, s is string, b is bool.
+// Multi-byte ints and 16 bit floats are in network byte order. This layout
+// is part of the game-stream protocol so it can't change as such; the
+// structs below just give nodes typed views of it.
+
+// Bytes taken by one format field, or 0 for variable-size ones (strings).
+constexpr auto NodeMessageFieldSize(char f) -> size_t {
+  switch (f) {
+    case 'I':
+    case 'F':
+      return 4;
+    case 'i':
+    case 'f':
+      return 2;
+    case 'c':
+    case 'b':
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+// Bytes taken by all fixed-size fields in a format.
+constexpr auto NodeMessageFixedSize(const char* format) -> size_t {
+  return *format ? NodeMessageFieldSize(*format)
+                       + NodeMessageFixedSize(format + 1)
+                 : 0;
+}
+
+constexpr auto NodeMessageFieldCount(const char* format) -> size_t {
+  return *format ? 1 + NodeMessageFieldCount(format + 1) : 0;
+}
+
+constexpr auto NodeMessageHasStrings(const char* format) -> bool {
+  return *format && (*format == 's' || NodeMessageHasStrings(format + 1));
+}
+
+// Everything needed to pack or validate a message of some type; worked
+// out at compile time so senders never have to walk formats to size them.
+struct NodeMessageSpec {
+  constexpr NodeMessageSpec(NodeMessageType type_in, const char* name_in,
+                            const char* format_in)
+      : type(type_in),
+        name(name_in),
+        format(format_in),
+        fixed_size(NodeMessageFixedSize(format_in)),
+        field_count(NodeMessageFieldCount(format_in)),
+        has_strings(NodeMessageHasStrings(format_in)) {}
+  NodeMessageType type;
+  const char* name;
+  const char* format;
+  size_t fixed_size;
+  size_t field_count;
+  bool has_strings;
+};
+
+// Pull a payload made up entirely of 16 bit fields in one go.
+template <size_t N>
+inline void ExtractNodeMessageShorts(const char* data, uint16_t (&out)[N]) {
+  memcpy(out, data, sizeof(out));
+  for (auto& val : out) {
+    val = ntohs(val);  // NOLINT
+  }
+}
+
+inline auto NodeMessageHalf(uint16_t val) -> float {
+  return Utils::HalfToFloat(val);
+}
+
+inline auto NodeMessageShort(uint16_t val) -> int16_t {
+  return static_cast<int16_t>(val);
+}
+
+// Typed payloads for the messages that carry data. Each Extract() takes
+// the buffer just past the type byte.
+
+struct NodeImpulseMessage {
+  static constexpr const char* kFormat = "fffffffffifff";
+  static constexpr size_t kSize = NodeMessageFixedSize(kFormat);
+  static auto Extract(const char* data) -> NodeImpulseMessage {
+    uint16_t raw[kSize / 2];
+    static_assert(sizeof(raw) == kSize);
+    ExtractNodeMessageShorts(data, raw);
+    NodeImpulseMessage m;
+    m.px = NodeMessageHalf(raw[0]);
+    m.py = NodeMessageHalf(raw[1]);
+    m.pz = NodeMessageHalf(raw[2]);
+    m.vx = NodeMessageHalf(raw[3]);
+    m.vy = NodeMessageHalf(raw[4]);
+    m.vz = NodeMessageHalf(raw[5]);
+    m.mag = NodeMessageHalf(raw[6]);
+    m.velocity_mag = NodeMessageHalf(raw[7]);
+    m.radius = NodeMessageHalf(raw[8]);
+    m.calc_force_only = static_cast<bool>(NodeMessageShort(raw[9]));
+    m.force_dir_x = NodeMessageHalf(raw[10]);
+    m.force_dir_y = NodeMessageHalf(raw[11]);
+    m.force_dir_z = NodeMessageHalf(raw[12]);
+    return m;
+  }
+  float px, py, pz;
+  float vx, vy, vz;
+  float mag;
+  float velocity_mag;
+  float radius;
+  bool calc_force_only;
+  float force_dir_x, force_dir_y, force_dir_z;
+};
+
+struct NodeKickbackMessage {
+  static constexpr const char* kFormat = "fffffff";
+  static constexpr size_t kSize = NodeMessageFixedSize(kFormat);
+  static auto Extract(const char* data) -> NodeKickbackMessage {
+    uint16_t raw[kSize / 2];
+    static_assert(sizeof(raw) == kSize);
+    ExtractNodeMessageShorts(data, raw);
+    NodeKickbackMessage m;
+    m.pos_x = NodeMessageHalf(raw[0]);
+    m.pos_y = NodeMessageHalf(raw[1]);
+    m.pos_z = NodeMessageHalf(raw[2]);
+    m.dir_x = NodeMessageHalf(raw[3]);
+    m.dir_y = NodeMessageHalf(raw[4]);
+    m.dir_z = NodeMessageHalf(raw[5]);
+    m.mag = NodeMessageHalf(raw[6]);
+    return m;
+  }
+  float pos_x, pos_y, pos_z;
+  float dir_x, dir_y, dir_z;
+  float mag;
+};
+
+struct NodeStandMessage {
+  static constexpr const char* kFormat = "ffff";
+  static constexpr size_t kSize = NodeMessageFixedSize(kFormat);
+  static auto Extract(const char* data) -> NodeStandMessage {
+    uint16_t raw[kSize / 2];
+    static_assert(sizeof(raw) == kSize);
+    ExtractNodeMessageShorts(data, raw);
+    NodeStandMessage m;
+    m.x = NodeMessageHalf(raw[0]);
+    m.y = NodeMessageHalf(raw[1]);
+    m.z = NodeMessageHalf(raw[2]);
+    m.angle = NodeMessageHalf(raw[3]);
+    return m;
+  }
+  float x, y, z;
+  float angle;
+};
+
+struct NodeKnockoutMessage {
+  static constexpr const char* kFormat = "f";
+  static auto Extract(const char* data) -> NodeKnockoutMessage {
+    return {Utils::ExtractFloat16NBO(&data)};
+  }
+  float amount;
+};
+
+// Used for all celebrate variants.
+struct NodeCelebrateMessage {
+  static constexpr const char* kFormat = "i";
+  static auto Extract(const char* data) -> NodeCelebrateMessage {
+    return {Utils::ExtractInt16NBO(&data)};
+  }
+  int duration;
+};
+
+struct NodeFootingMessage {
+  static constexpr const char* kFormat = "c";
+  static auto Extract(const char* data) -> NodeFootingMessage {
+    return {Utils::ExtractInt8(&data)};
+  }
+  int delta;
+};
+
+// All message types, in NodeMessageType order.
+constexpr NodeMessageSpec kNodeMessageSpecs[] = {
+    {NodeMessageType::kFlash, "flash", ""},
+    {NodeMessageType::kCelebrate, "celebrate", NodeCelebrateMessage::kFormat},
+    {NodeMessageType::kCelebrateL, "celebrate_l",
+     NodeCelebrateMessage::kFormat},
+    {NodeMessageType::kCelebrateR, "celebrate_r",
+     NodeCelebrateMessage::kFormat},
+    {NodeMessageType::kImpulse, "impulse", NodeImpulseMessage::kFormat},
+    {NodeMessageType::kKickback, "kick_back", NodeKickbackMessage::kFormat},
+    {NodeMessageType::kKnockout, "knockout", NodeKnockoutMessage::kFormat},
+    {NodeMessageType::kHurtSound, "hurt_sound", ""},
+    {NodeMessageType::kPickedUp, "picked_up", ""},
+    {NodeMessageType::kJumpSound, "jump_sound", ""},
+    {NodeMessageType::kAttackSound, "attack_sound", ""},
+    {NodeMessageType::kScreamSound, "scream_sound", ""},
+    {NodeMessageType::kStand, "stand", NodeStandMessage::kFormat},
+    {NodeMessageType::kFooting, "footing", NodeFootingMessage::kFormat},
+};
+
+constexpr auto NodeMessageSpecsInOrder(size_t i = 0) -> bool {
+  return i == sizeof(kNodeMessageSpecs) / sizeof(kNodeMessageSpecs[0])
+         || (static_cast<size_t>(kNodeMessageSpecs[i].type) == i
+             && NodeMessageSpecsInOrder(i + 1));
+}
+static_assert(NodeMessageSpecsInOrder(),
+              "kNodeMessageSpecs must be in NodeMessageType order.");
+
+// Return the spec for a message type, or nullptr for unknown ones.
+inline auto GetNodeMessageSpec(NodeMessageType type) -> const NodeMessageSpec* {
+  auto index = static_cast<size_t>(type);
+  if (index >= sizeof(kNodeMessageSpecs) / sizeof(kNodeMessageSpecs[0])) {
+    return nullptr;
+  }
+  return &kNodeMessageSpecs[index];
+}
+
+}  // namespace ballistica
+
+#endif  // BALLISTICA_SCENE_NODE_NODE_MESSAGE_H_
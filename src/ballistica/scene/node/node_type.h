@@ -62,6 +62,12 @@ class NodeType {
   }
 
   void set_id(int val) { id_ = val; }
+
+  /// Whether this type's nodes do anything in Step(); scenes skip the
+  /// call for those that don't.
+  auto has_step() const -> bool { return has_step_; }
+  void set_has_step(bool val) { has_step_ = val; }
+
   auto attributes_by_index() const
       -> const std::vector<NodeAttributeUnbound*>& {
     return attributes_by_index_;
@@ -73,6 +79,7 @@ class NodeType {
   std::string name_;
   std::unordered_map<std::string, NodeAttributeUnbound*> attributes_by_name_;
   std::vector<NodeAttributeUnbound*> attributes_by_index_;
+  bool has_step_{true};
   friend class NodeAttributeUnbound;
   friend class Node;
 };
@@ -2,12 +2,15 @@
 
 #include "ballistica/scene/node/prop_node.h"
 
+#include <algorithm>
+
 #include "ballistica/dynamics/dynamics.h"
 #include "ballistica/generic/utils.h"
 #include "ballistica/graphics/area_of_interest.h"
 #include "ballistica/graphics/camera.h"
 #include "ballistica/graphics/component/object_component.h"
 #include "ballistica/graphics/component/simple_component.h"
+#include "ballistica/scene/node/node_message.h"
 #include "ballistica/scene/scene.h"
 
 namespace ballistica {
@@ -55,21 +58,11 @@ void PropNode::HandleMessage(const char* data_in) {
   bool handled = true;
   switch (extract_node_message_type(&data)) {
     case NodeMessageType::kImpulse: {
-      float px = Utils::ExtractFloat16NBO(&data);
-      float py = Utils::ExtractFloat16NBO(&data);
-      float pz = Utils::ExtractFloat16NBO(&data);
-      float vx = Utils::ExtractFloat16NBO(&data);
-      float vy = Utils::ExtractFloat16NBO(&data);
-      float vz = Utils::ExtractFloat16NBO(&data);
-      float mag = Utils::ExtractFloat16NBO(&data);
-      float velocity_mag = Utils::ExtractFloat16NBO(&data);
-      float radius = Utils::ExtractFloat16NBO(&data);
-      Utils::ExtractInt16NBO(&data);  // calc-force-only
-      float fdirx = Utils::ExtractFloat16NBO(&data);
-      float fdiry = Utils::ExtractFloat16NBO(&data);
-      float fdirz = Utils::ExtractFloat16NBO(&data);
-      body_->ApplyImpulse(px, py, pz, vx, vy, vz, fdirx, fdiry, fdirz, mag,
-                          velocity_mag, radius, false);
+      // (calc-force-only is ignored here)
+      auto m = NodeImpulseMessage::Extract(data);
+      body_->ApplyImpulse(m.px, m.py, m.pz, m.vx, m.vy, m.vz, m.force_dir_x,
+                          m.force_dir_y, m.force_dir_z, m.mag, m.velocity_mag,
+                          m.radius, false);
       break;
     }
     default:
@@ -106,31 +99,33 @@ void PropNode::Draw(FrameDef* frame_def) {
   }
 
   ObjectComponent c(frame_def->beauty_pass());
-  c.SetTexture(color_texture_);
-  c.SetLightShadow(LightShadowType::kObject);
-  if (reflection_ != ReflectionType::kNone) {
-    c.SetReflection(reflection_);
-    c.SetReflectionScale(reflection_scale_r_, reflection_scale_g_,
-                         reflection_scale_b_);
-  }
-  if (flashing_ && frame_def->frame_number() % 10 < 5) {
-    c.SetColor(1.2f, 1.2f, 1.2f);
-  }
-  c.PushTransform();
-  c.TransformToBody(*body_);
   float s = model_scale_ * extra_model_scale_;
-  c.Scale(s, s, s);
-  c.DrawModel(model_->model_data());
-  c.PopTransform();
+
+  // Our models are built around unit-ish bodies; be generous.
+  if (!c.IsBodyCulled(*body_, 2.0f * std::max(s, body_scale_))) {
+    c.SetTexture(color_texture_);
+    c.SetLightShadow(LightShadowType::kObject);
+    if (reflection_ != ReflectionType::kNone) {
+      c.SetReflection(reflection_);
+      c.SetReflectionScale(reflection_scale_r_, reflection_scale_g_,
+                           reflection_scale_b_);
+    }
+    if (flashing_ && frame_def->frame_number() % 10 < 5) {
+      c.SetColor(1.2f, 1.2f, 1.2f);
+    }
+    c.PushTransform();
+    c.TransformToBody(*body_);
+    c.Scale(s, s, s);
+    c.DrawModel(model_->model_data());
+    c.PopTransform();
+  }
   c.Submit();
 
   {  // shadow
     assert(body_.exists());
-    const dReal* pos_raw = dGeomGetPosition(body_->geom());
     float pos[3];
-    pos[0] = pos_raw[0] + body_->blend_offset().x;
-    pos[1] = pos_raw[1] + body_->blend_offset().y;
-    pos[2] = pos_raw[2] + body_->blend_offset().z;
+    float r[12];
+    body_->GetRenderState(pos, r);
     float s_scale, s_density;
     shadow_.GetValues(&s_scale, &s_density);
     if (body_type_ == BodyType::PUCK) {
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "ballistica/core/object_pool.h"
 #include "ballistica/dynamics/bg/bg_dynamics_shadow.h"
 #include "ballistica/dynamics/part.h"
 #include "ballistica/media/component/model.h"
@@ -18,6 +19,7 @@ namespace ballistica {
 
 class PropNode : public Node {
  public:
+  BA_OBJECT_POOLED(PropNode);
   static auto InitType() -> NodeType*;
   explicit PropNode(Scene* scene, NodeType* node_type = nullptr);
   ~PropNode() override;
@@ -29,7 +31,7 @@ class PropNode : public Node {
     return (area_of_interest_ != nullptr);
   }
   void SetIsAreaOfInterest(bool val);
-  auto reflection_scale() const -> std::vector<float> {
+  auto reflection_scale() const -> const std::vector<float>& {
     return reflection_scale_;
   }
   void SetReflectionScale(const std::vector<float>& vals);
@@ -59,7 +61,7 @@ class PropNode : public Node {
   void SetVelocity(const std::vector<float>& vals);
   auto GetPosition() const -> std::vector<float>;
   void SetPosition(const std::vector<float>& vals);
-  auto extra_acceleration() const -> std::vector<float> {
+  auto extra_acceleration() const -> const std::vector<float>& {
     return extra_acceleration_;
   }
   void SetExtraAcceleration(const std::vector<float>& vals);
@@ -18,9 +18,9 @@ class RegionNode : public Node {
   explicit RegionNode(Scene* scene);
   void Draw(FrameDef* frame_def) override;
   void Step() override;
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& vals);
-  auto scale() const -> std::vector<float> { return scale_; }
+  auto scale() const -> const std::vector<float>& { return scale_; }
   void SetScale(const std::vector<float>& vals);
   auto GetMaterials() const -> std::vector<Material*>;
   void SetMaterials(const std::vector<Material*>& vals);
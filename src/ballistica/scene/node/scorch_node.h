@@ -5,17 +5,19 @@
 
 #include <vector>
 
+#include "ballistica/core/object_pool.h"
 #include "ballistica/scene/node/node.h"
 
 namespace ballistica {
 
 class ScorchNode : public Node {
  public:
+  BA_OBJECT_POOLED(ScorchNode);
   static auto InitType() -> NodeType*;
   explicit ScorchNode(Scene* scene);
   ~ScorchNode() override;
   void Draw(FrameDef* frame_def) override;
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& vals);
   auto presence() const -> float { return presence_; }
   void set_presence(float val) { presence_ = val; }
@@ -23,7 +25,7 @@ class ScorchNode : public Node {
   void set_size(float val) { size_ = val; }
   auto big() const -> bool { return big_; }
   void set_big(bool val) { big_ = val; }
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& vals);
 
  private:
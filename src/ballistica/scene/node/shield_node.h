@@ -17,13 +17,13 @@ class ShieldNode : public Node {
   ~ShieldNode() override;
   void Draw(FrameDef* frame_def) override;
   void Step() override;
-  auto position() const -> std::vector<float> { return position_; }
+  auto position() const -> const std::vector<float>& { return position_; }
   void SetPosition(const std::vector<float>& vals);
   auto radius() const -> float { return radius_; }
   void set_radius(float val) { radius_ = val; }
   auto hurt() const -> float { return hurt_; }
   void SetHurt(float val);
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& vals);
   auto always_show_health_bar() const -> bool {
     return always_show_health_bar_;
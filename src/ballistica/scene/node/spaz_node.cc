@@ -2,6 +2,10 @@
 
 #include "ballistica/scene/node/spaz_node.h"
 
+#include <chrono>
+#include <cstdio>
+#include <string>
+
 #include "ballistica/audio/audio.h"
 #include "ballistica/audio/audio_source.h"
 #include "ballistica/dynamics/bg/bg_dynamics_shadow.h"
@@ -17,9 +21,11 @@
 #include "ballistica/graphics/graphics_server.h"
 #include "ballistica/graphics/text/text_graphics.h"
 #include "ballistica/input/device/input_device.h"
+#include "ballistica/input/input_latency.h"
 #include "ballistica/media/component/sound.h"
 #include "ballistica/python/python.h"
 #include "ballistica/scene/node/node_attribute.h"
+#include "ballistica/scene/node/node_message.h"
 #include "ballistica/scene/node/node_type.h"
 #include "ode/ode_collision_util.h"
 
@@ -959,6 +965,7 @@ SpazNode::SpazNode(Scene* scene)
 void SpazNode::SetPickupPressed(bool val) {
   if (val == pickup_pressed_) return;
   pickup_pressed_ = val;
+  InputLatency::NoteControl();
 
   // press
   if (pickup_pressed_) {
@@ -986,6 +993,7 @@ void SpazNode::SetMoveLeftRight(float val) {
     return;
   }
   move_left_right_ = val;
+  InputLatency::NoteControl();
   lr_ = static_cast_check_fit<int8_t>(
       std::max(-127, std::min(127, static_cast<int>(127.0f * val))));
 }
@@ -995,6 +1003,7 @@ void SpazNode::SetMoveUpDown(float val) {
     return;
   }
   move_up_down_ = val;
+  InputLatency::NoteControl();
   ud_ = static_cast_check_fit<int8_t>(
       std::max(-127, std::min(127, static_cast<int>(127.0f * val))));
 }
@@ -1002,6 +1011,7 @@ void SpazNode::SetMoveUpDown(float val) {
 void SpazNode::SetFlyPressed(bool val) {
   if (val == fly_pressed_) return;
   fly_pressed_ = val;
+  InputLatency::NoteControl();
 
   // Press.
   if (fly_pressed_) {
@@ -1016,6 +1026,7 @@ void SpazNode::SetRun(float val) {
     return;
   }
   run_ = val;
+  InputLatency::NoteControl();
 }
 
 void SpazNode::SetBombPressed(bool val) {
@@ -1023,6 +1034,7 @@ void SpazNode::SetBombPressed(bool val) {
     return;
   }
   bomb_pressed_ = val;
+  InputLatency::NoteControl();
   if (bomb_pressed_) {
     if (frozen_ || knockout_) {
       return;
@@ -1041,6 +1053,7 @@ void SpazNode::SetPunchPressed(bool val) {
     return;
   }
   punch_pressed_ = val;
+  InputLatency::NoteControl();
   if (punch_pressed_) {
     if (frozen_ || knockout_) {
       return;
@@ -1082,6 +1095,7 @@ void SpazNode::SetJumpPressed(bool val) {
     return;
   }
   jump_pressed_ = val;
+  InputLatency::NoteControl();
   if (jump_pressed_) {
     if (!can_fly_ && !knockout_ && !frozen_) {
       if (Sound* sound = GetRandomMedia(jump_sounds_)) {
@@ -1639,7 +1653,7 @@ void SpazNode::HandleMessage(const char* data_in) {
       break;
     }
     case NodeMessageType::kKnockout: {
-      float amt = Utils::ExtractFloat16NBO(&data);
+      float amt = NodeKnockoutMessage::Extract(data).amount;
       knockout_ = static_cast_check_fit<uint8_t>(
           std::min(40, std::max(static_cast<int>(knockout_),
                                 static_cast<int>(amt * 0.07f))));
@@ -1647,37 +1661,38 @@ void SpazNode::HandleMessage(const char* data_in) {
       break;
     }
     case NodeMessageType::kCelebrate: {
-      int duration = Utils::ExtractInt16NBO(&data);
+      int duration = NodeCelebrateMessage::Extract(data).duration;
       celebrate_until_time_left_ = celebrate_until_time_right_ =
           scene()->time() + duration;
       break;
     }
     case NodeMessageType::kCelebrateL: {
-      int duration = Utils::ExtractInt16NBO(&data);
+      int duration = NodeCelebrateMessage::Extract(data).duration;
       celebrate_until_time_left_ = scene()->time() + duration;
       break;
     }
     case NodeMessageType::kCelebrateR: {
-      int duration = Utils::ExtractInt16NBO(&data);
+      int duration = NodeCelebrateMessage::Extract(data).duration;
       celebrate_until_time_right_ = scene()->time() + duration;
       break;
     }
     case NodeMessageType::kImpulse: {
       last_external_impulse_time_ = scene()->time();
       float dmg = 0.0f;
-      float px = Utils::ExtractFloat16NBO(&data);
-      float py = Utils::ExtractFloat16NBO(&data);
-      float pz = Utils::ExtractFloat16NBO(&data);
-      float vx = Utils::ExtractFloat16NBO(&data);
-      float vy = Utils::ExtractFloat16NBO(&data);
-      float vz = Utils::ExtractFloat16NBO(&data);
-      float mag = Utils::ExtractFloat16NBO(&data);
-      float velocity_mag = Utils::ExtractFloat16NBO(&data);
-      float radius = Utils::ExtractFloat16NBO(&data);
-      auto calc_force_only = static_cast<bool>(Utils::ExtractInt16NBO(&data));
-      float force_dir_x = Utils::ExtractFloat16NBO(&data);
-      float force_dir_y = Utils::ExtractFloat16NBO(&data);
-      float force_dir_z = Utils::ExtractFloat16NBO(&data);
+      auto m = NodeImpulseMessage::Extract(data);
+      float px = m.px;
+      float py = m.py;
+      float pz = m.pz;
+      float vx = m.vx;
+      float vy = m.vy;
+      float vz = m.vz;
+      float mag = m.mag;
+      float velocity_mag = m.velocity_mag;
+      float radius = m.radius;
+      bool calc_force_only = m.calc_force_only;
+      float force_dir_x = m.force_dir_x;
+      float force_dir_y = m.force_dir_y;
+      float force_dir_z = m.force_dir_z;
 
       // area of affect impulses apply to everything..
       if (radius > 0.0f) {
@@ -1772,31 +1787,22 @@ void SpazNode::HandleMessage(const char* data_in) {
       break;
     }
     case NodeMessageType::kStand: {
-      float x = Utils::ExtractFloat16NBO(&data);
-      float y = Utils::ExtractFloat16NBO(&data);
-      float z = Utils::ExtractFloat16NBO(&data);
-      float angle = Utils::ExtractFloat16NBO(&data);
-      Stand(x, y, z, angle);
+      auto m = NodeStandMessage::Extract(data);
+      Stand(m.x, m.y, m.z, m.angle);
       UpdatePartBirthTimes();
       break;
     }
     case NodeMessageType::kFooting: {
-      footing_ += Utils::ExtractInt8(&data);
+      footing_ += NodeFootingMessage::Extract(data).delta;
       trying_to_fly_ = false;
       break;
     }
     case NodeMessageType::kKickback: {
-      float pos_x = Utils::ExtractFloat16NBO(&data);
-      float pos_y = Utils::ExtractFloat16NBO(&data);
-      float pos_z = Utils::ExtractFloat16NBO(&data);
-      float dir_x = Utils::ExtractFloat16NBO(&data);
-      float dir_y = Utils::ExtractFloat16NBO(&data);
-      float dir_z = Utils::ExtractFloat16NBO(&data);
-      float mag = Utils::ExtractFloat16NBO(&data);
-      Vector3f v = Vector3f(dir_x, dir_y, dir_z).Normalized() * mag;
+      auto m = NodeKickbackMessage::Extract(data);
+      Vector3f v = Vector3f(m.dir_x, m.dir_y, m.dir_z).Normalized() * m.mag;
       dBodyID b = body_torso_->body();
       dBodyEnable(b);
-      dBodyAddForceAtPos(b, v.x, v.y, v.z, pos_x, pos_y, pos_z);
+      dBodyAddForceAtPos(b, v.x, v.y, v.z, m.pos_x, m.pos_y, m.pos_z);
       break;
     }
     case NodeMessageType::kFlash: {
@@ -1845,9 +1851,112 @@ void SpazNode::DoFlyPress() {
   }
 }
 
+// Phases of SpazNode::Step(), in the order they run.
+enum class SpazStepPhase {
+  kBodyBlending,
+  kInput,
+  kMomentum,
+  kShadowsAndWings,
+  kJointToggles,
+  kVelocityLimits,
+  kJolt,
+  kJoints,
+  kStatus,
+  kTorso,
+  kRunBall,
+  kActions,
+  kFinish,
+  kCount
+};
+
+static const char* const kSpazStepPhaseNames[] = {
+    "body blending", "input", "momentum", "shadows/wings", "joint toggles",
+    "velocity limits", "jolt", "joints", "status", "torso",
+    "run ball", "actions", "finish"};
+static_assert(sizeof(kSpazStepPhaseNames) / sizeof(kSpazStepPhaseNames[0])
+                  == static_cast<size_t>(SpazStepPhase::kCount),
+              "spaz step phase names out of sync");
+
+// Step profiling state; all of this lives in the logic thread.
+static bool g_spaz_step_profiling{};
+static double g_spaz_step_phase_seconds[static_cast<int>(
+    SpazStepPhase::kCount)]{};
+static int64_t g_spaz_step_profile_steps{};
+
+// Charges time to phases of a single Step() call. Each Begin() closes out
+// the previous phase; the last one closes when this goes out of scope.
+// When profiling is off this costs a flag check per phase.
+class SpazStepProfiler {
+ public:
+  SpazStepProfiler() : enabled_(g_spaz_step_profiling) {
+    if (enabled_) {
+      g_spaz_step_profile_steps++;
+    }
+  }
+  ~SpazStepProfiler() { EndPhase(); }
+  void Begin(SpazStepPhase phase) {
+    if (!enabled_) {
+      return;
+    }
+    EndPhase();
+    phase_ = phase;
+    start_ = std::chrono::steady_clock::now();
+  }
+
+ private:
+  void EndPhase() {
+    if (phase_ != SpazStepPhase::kCount) {
+      g_spaz_step_phase_seconds[static_cast<int>(phase_)] +=
+          std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                        - start_)
+              .count();
+    }
+  }
+  bool enabled_{};
+  SpazStepPhase phase_{SpazStepPhase::kCount};
+  std::chrono::steady_clock::time_point start_;
+};
+
+void SpazNode::SetStepProfilingEnabled(bool enabled) {
+  assert(InGameThread());
+  if (enabled == g_spaz_step_profiling) {
+    return;
+  }
+  g_spaz_step_profiling = enabled;
+  if (enabled) {
+    for (double& seconds : g_spaz_step_phase_seconds) {
+      seconds = 0.0;
+    }
+    g_spaz_step_profile_steps = 0;
+    return;
+  }
+  double total{};
+  for (double seconds : g_spaz_step_phase_seconds) {
+    total += seconds;
+  }
+  auto steps = static_cast<double>(std::max(g_spaz_step_profile_steps,
+                                            static_cast<int64_t>(1)));
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "Spaz step profile (%lld steps, %.2fus avg):",
+           static_cast<long long>(g_spaz_step_profile_steps),  // NOLINT
+           total * 1000000.0 / steps);
+  std::string out = buffer;
+  for (int i = 0; i < static_cast<int>(SpazStepPhase::kCount); i++) {
+    double seconds = g_spaz_step_phase_seconds[i];
+    snprintf(buffer, sizeof(buffer), "\n  %-16s %8.2fus %5.1f%%",
+             kSpazStepPhaseNames[i], seconds * 1000000.0 / steps,
+             total > 0.0 ? 100.0 * seconds / total : 0.0);
+    out += buffer;
+  }
+  Log(out);
+}
+
 // void SpazNode::update(uint32_t flags) {
 void SpazNode::Step() {
   BA_DEBUG_CHECK_BODIES();
+  SpazStepProfiler profiler;
+  profiler.Begin(SpazStepPhase::kBodyBlending);
 
   // update our body blending values
   {
@@ -1879,6 +1988,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kInput);
+
   step_count_++;
 
   const dReal* p_head = dGeomGetPosition(body_head_->geom());
@@ -2044,6 +2155,8 @@ void SpazNode::Step() {
                         + (1.0f - smoothering_diff) * (lr_norm_ - prev_lr);
   }
 
+  profiler.Begin(SpazStepPhase::kMomentum);
+
   float vel_length;
 
   // update smoothed avels and stuff
@@ -2096,6 +2209,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kShadowsAndWings);
+
   // Update shadows.
 #if !BA_HEADLESS_BUILD
   FullShadowSet* full_shadows = full_shadow_set_.get();
@@ -2173,6 +2288,8 @@ void SpazNode::Step() {
     wing_pos_right_ += wing_vel_right_;
   }
 
+  profiler.Begin(SpazStepPhase::kJointToggles);
+
   // Toggle angular components of some joints off and on for increased
   // efficiency 93 to 123.
 
@@ -2241,6 +2358,8 @@ void SpazNode::Step() {
     fly_time_++;
   }
 
+  profiler.Begin(SpazStepPhase::kVelocityLimits);
+
   // If we're not touching the ground and are moving fast enough, we can cause
   // damage to things we hit.
   {
@@ -2263,34 +2382,51 @@ void SpazNode::Step() {
       max_mag_squared_lin = 100.0f;
     }
 
-    dBodyID bodies[11];
-    bodies[0] = body_head_->body();
-    bodies[1] = body_torso_->body();
-    bodies[2] = upper_right_arm_body_->body();
-    bodies[3] = lower_right_arm_body_->body();
-    bodies[4] = upper_left_arm_body_->body();
-    bodies[5] = lower_left_arm_body_->body();
-    bodies[6] = upper_right_leg_body_->body();
-    bodies[7] = upper_left_leg_body_->body();
-    bodies[8] = lower_right_leg_body_->body();
-    bodies[9] = lower_left_leg_body_->body();
-    bodies[10] = nullptr;
-
-    for (dBodyID* body = bodies; *body != nullptr; body++) {
-      const dReal* aVel = dBodyGetAngularVel(*body);
-      float mag_squared =
-          aVel[0] * aVel[0] + aVel[1] * aVel[1] + aVel[2] * aVel[2];
-      if (mag_squared > max_mag_squared) {
-        float scale = max_mag_squared / mag_squared;
-        dBodySetAngularVel(*body, aVel[0] * scale, aVel[1] * scale,
-                           aVel[2] * scale);
+    // Do the magnitude math for all bodies at once over flat arrays (which
+    // compilers can vectorize); only the rare bodies that are actually over
+    // the limit go back through ODE.
+    const int kLimitedBodyCount = 10;
+    dBodyID bodies[kLimitedBodyCount] = {
+        body_head_->body(),
+        body_torso_->body(),
+        upper_right_arm_body_->body(),
+        lower_right_arm_body_->body(),
+        upper_left_arm_body_->body(),
+        lower_left_arm_body_->body(),
+        upper_right_leg_body_->body(),
+        upper_left_leg_body_->body(),
+        lower_right_leg_body_->body(),
+        lower_left_leg_body_->body()};
+    dReal a_vels[kLimitedBodyCount][3];
+    dReal l_vels[kLimitedBodyCount][3];
+    for (int i = 0; i < kLimitedBodyCount; i++) {
+      const dReal* a_vel = dBodyGetAngularVel(bodies[i]);
+      const dReal* l_vel = dBodyGetLinearVel(bodies[i]);
+      for (int j = 0; j < 3; j++) {
+        a_vels[i][j] = a_vel[j];
+        l_vels[i][j] = l_vel[j];
+      }
+    }
+    float a_mags_squared[kLimitedBodyCount];
+    float l_mags_squared[kLimitedBodyCount];
+    for (int i = 0; i < kLimitedBodyCount; i++) {
+      a_mags_squared[i] = a_vels[i][0] * a_vels[i][0]
+                          + a_vels[i][1] * a_vels[i][1]
+                          + a_vels[i][2] * a_vels[i][2];
+      l_mags_squared[i] = l_vels[i][0] * l_vels[i][0]
+                          + l_vels[i][1] * l_vels[i][1]
+                          + l_vels[i][2] * l_vels[i][2];
+    }
+    for (int i = 0; i < kLimitedBodyCount; i++) {
+      if (a_mags_squared[i] > max_mag_squared) {
+        float scale = max_mag_squared / a_mags_squared[i];
+        dBodySetAngularVel(bodies[i], a_vels[i][0] * scale,
+                           a_vels[i][1] * scale, a_vels[i][2] * scale);
       }
-      const dReal* lVel = dBodyGetLinearVel(*body);
-      mag_squared = lVel[0] * lVel[0] + lVel[1] * lVel[1] + lVel[2] * lVel[2];
-      if (mag_squared > max_mag_squared_lin) {
-        float scale = max_mag_squared_lin / mag_squared;
-        dBodySetLinearVel(*body, lVel[0] * scale, lVel[1] * scale,
-                          lVel[2] * scale);
+      if (l_mags_squared[i] > max_mag_squared_lin) {
+        float scale = max_mag_squared_lin / l_mags_squared[i];
+        dBodySetLinearVel(bodies[i], l_vels[i][0] * scale,
+                          l_vels[i][1] * scale, l_vels[i][2] * scale);
       }
     }
 
@@ -2311,6 +2447,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kJolt);
+
   // Update jolt stuff. If our head jolts suddenly we may knock ourself out for
   // a bit or may shatter.
   {
@@ -2360,6 +2498,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kJoints);
+
   bool head_turning = false;
 
   // If we're punching.
@@ -3109,6 +3249,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kStatus);
+
   // flap wings every now and then
   if (wings_) {
     if (scene()->stepnum() % 21 == 0 && RandomFloat() > 0.9f) {
@@ -3331,6 +3473,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kTorso);
+
   // torso
   {
     dBodyID b = stand_body_->body();
@@ -3520,6 +3664,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kRunBall);
+
   // Resize our run-ball based on our balance.
   // (so when we're laying on the ground its not propping our legs up in the
   // air)
@@ -3708,6 +3854,8 @@ void SpazNode::Step() {
     dJointSetAMotorParam(a_motor_brakes_, dParamVel3, 0.0f);
   }
 
+  profiler.Begin(SpazStepPhase::kActions);
+
   // If we're knocked out, stop any mid-progress punch.
   if (knockout_) {
     punch_ = 0;
@@ -3916,6 +4064,8 @@ void SpazNode::Step() {
     }
   }
 
+  profiler.Begin(SpazStepPhase::kFinish);
+
   if (flashing_ > 0) flashing_--;
 
   if (jump_ > 0) {
@@ -3992,6 +4142,20 @@ static void DrawBrightSpot(const BGDynamicsShadow& shadow, float radius,
 }
 #endif  // !BA_HEADLESS_BUILD
 
+void SpazNode::TransformToBody(RenderComponent* c, const RigidBody& body) {
+  for (const BodyRenderMatrix& entry : body_render_matrices_) {
+    if (entry.body == &body) {
+      c->MultMatrix(entry.matrix);
+      return;
+    }
+  }
+  body_render_matrices_.emplace_back();
+  BodyRenderMatrix& entry = body_render_matrices_.back();
+  entry.body = &body;
+  RenderComponent::GetBodyMatrix(body, entry.matrix);
+  c->MultMatrix(entry.matrix);
+}
+
 void SpazNode::DrawEyeBalls(RenderComponent* c, ObjectComponent* oc,
                             bool shading, float death_fade, float death_scale,
                             float* add_color) {
@@ -4009,7 +4173,7 @@ void SpazNode::DrawEyeBalls(RenderComponent* c, ObjectComponent* oc,
                    eye_ball_color_blue_);
     }
     c->PushTransform();
-    c->TransformToBody(*body_head_);
+    TransformToBody(c, *body_head_);
     if (eye_scale_ != 1.0f) c->Scale(eye_scale_, eye_scale_, eye_scale_);
     c->PushTransform();
     c->Translate(eye_offset_x_, eye_offset_y_, eye_offset_z_);
@@ -4077,7 +4241,7 @@ void SpazNode::DrawEyeLids(RenderComponent* c, float death_fade,
   if (!has_eyelids_ && blink_smooth_ < 0.1f) return;
 
   c->PushTransform();
-  c->TransformToBody(*body_head_);
+  TransformToBody(c, *body_head_);
   if (eye_scale_ != 1.0f) {
     c->Scale(eye_scale_, eye_scale_, eye_scale_);
   }
@@ -4103,7 +4267,7 @@ void SpazNode::DrawEyeLids(RenderComponent* c, float death_fade,
   // Left eyelid.
   c->FlipCullFace();
   c->PushTransform();
-  c->TransformToBody(*body_head_);
+  TransformToBody(c, *body_head_);
   if (eye_scale_ != 1.0f) c->Scale(eye_scale_, eye_scale_, eye_scale_);
 
   c->Translate(-eye_offset_x_, eye_offset_y_, eye_offset_z_);
@@ -4162,7 +4326,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Head.
   c->PushTransform();
-  c->TransformToBody(*body_head_);
+  TransformToBody(c, *body_head_);
   if (death_scale != 1.0f) {
     c->Scale(death_scale, death_scale, death_scale);
   }
@@ -4174,7 +4338,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
   // Hair tuft 1.
   if (hair_front_right_body_.exists()) {
     c->PushTransform();
-    c->TransformToBody(*hair_front_right_body_);
+    TransformToBody(c, *hair_front_right_body_);
     if (death_scale != 1.0f) {
       c->Scale(death_scale, death_scale, death_scale);
     }
@@ -4188,7 +4352,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
     c->Translate(offs[0] * m[0] + offs[1] * m[1] + offs[2] * m[2],
                  offs[0] * m[4] + offs[1] * m[5] + offs[2] * m[6],
                  offs[0] * m[8] + offs[1] * m[9] + offs[2] * m[10]);
-    c->TransformToBody(*hair_front_right_body_);
+    TransformToBody(c, *hair_front_right_body_);
     if (death_scale != 1.0f) {
       c->Scale(death_scale, death_scale, death_scale);
     }
@@ -4199,7 +4363,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
   // Hair tuft 2.
   if (hair_front_left_body_.exists()) {
     c->PushTransform();
-    c->TransformToBody(*hair_front_left_body_);
+    TransformToBody(c, *hair_front_left_body_);
     if (death_scale != 1.0f) c->Scale(death_scale, death_scale, death_scale);
     c->DrawModel(g_media->GetModel(SystemModelID::kHairTuft2));
     c->PopTransform();
@@ -4208,7 +4372,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
   // Hair tuft 3.
   if (hair_ponytail_top_body_.exists()) {
     c->PushTransform();
-    c->TransformToBody(*hair_ponytail_top_body_);
+    TransformToBody(c, *hair_ponytail_top_body_);
     if (death_scale != 1.0f) {
       c->Scale(death_scale, death_scale, death_scale);
     }
@@ -4219,7 +4383,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
   // Hair tuft 4.
   if (hair_ponytail_bottom_body_.exists()) {
     c->PushTransform();
-    c->TransformToBody(*hair_ponytail_bottom_body_);
+    TransformToBody(c, *hair_ponytail_bottom_body_);
     if (death_scale != 1.0f) {
       c->Scale(death_scale, death_scale, death_scale);
     }
@@ -4229,7 +4393,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Torso.
   c->PushTransform();
-  c->TransformToBody(*body_torso_);
+  TransformToBody(c, *body_torso_);
   if (death_scale != 1.0f) {
     c->Scale(death_scale, death_scale, death_scale);
   }
@@ -4240,7 +4404,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Pelvis.
   c->PushTransform();
-  c->TransformToBody(*body_pelvis_);
+  TransformToBody(c, *body_pelvis_);
   if (death_scale != 1.0f) {
     c->Scale(death_scale, death_scale, death_scale);
   }
@@ -4251,7 +4415,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Right upper arm.
   c->PushTransform();
-  c->TransformToBody(*upper_right_arm_body_);
+  TransformToBody(c, *upper_right_arm_body_);
 
   // Get the distance between the shoulder joint socket and the fore-arm
   // socket.. we'll use this to stretch our upper-arm to fill the gap.
@@ -4289,7 +4453,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Right lower arm.
   c->PushTransform();
-  c->TransformToBody(*lower_right_arm_body_);
+  TransformToBody(c, *lower_right_arm_body_);
   c->PushTransform();
   c->Translate(0, 0, 0.1f);
   c->Scale(1.0f, 1.0f, right_stretch);
@@ -4319,7 +4483,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Right upper leg.
   c->PushTransform();
-  c->TransformToBody(*upper_right_leg_body_);
+  TransformToBody(c, *upper_right_leg_body_);
 
   // Apply stretching if still intact.
   if (!shattered_) {
@@ -4347,7 +4511,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Right lower leg.
   c->PushTransform();
-  c->TransformToBody(*lower_right_leg_body_);
+  TransformToBody(c, *lower_right_leg_body_);
   if (death_scale != 1.0f) {
     c->Scale(death_scale, death_scale, 0.5f + death_scale * 0.5f);
   }
@@ -4357,7 +4521,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
   c->PopTransform();
 
   c->PushTransform();
-  c->TransformToBody(*right_toes_body_);
+  TransformToBody(c, *right_toes_body_);
   if (death_scale != 1.0f) {
     c->Scale(death_scale, death_scale, death_scale);
   }
@@ -4371,7 +4535,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Left upper arm.
   c->PushTransform();
-  c->TransformToBody(*upper_left_arm_body_);
+  TransformToBody(c, *upper_left_arm_body_);
   float left_stretch = 1.0f;
 
   // Stretch if not shattered.
@@ -4403,7 +4567,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Left lower arm.
   c->PushTransform();
-  c->TransformToBody(*lower_left_arm_body_);
+  TransformToBody(c, *lower_left_arm_body_);
   c->Scale(-1, 1, 1);
   c->PushTransform();
   c->Translate(0, 0, 0.1f);
@@ -4434,7 +4598,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Left upper leg.
   c->PushTransform();
-  c->TransformToBody(*upper_left_leg_body_);
+  TransformToBody(c, *upper_left_leg_body_);
 
   // Stretch if not shattered.
   if (!shattered_) {
@@ -4458,7 +4622,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Lower leg.
   c->PushTransform();
-  c->TransformToBody(*lower_left_leg_body_);
+  TransformToBody(c, *lower_left_leg_body_);
   c->Scale(-1.0f, 1.0f, 1.0f);
   if (death_scale != 1.0f)
     c->Scale(death_scale, death_scale, 0.5f + death_scale * 0.5f);
@@ -4469,7 +4633,7 @@ void SpazNode::DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
 
   // Toes.
   c->PushTransform();
-  c->TransformToBody(*left_toes_body_);
+  TransformToBody(c, *left_toes_body_);
   c->Scale(-1, 1, 1);
   if (death_scale != 1.0f) c->Scale(death_scale, death_scale, death_scale);
   if (toes_model_.exists()) c->DrawModel(toes_model_->model_data());
@@ -4492,6 +4656,7 @@ static void DrawRadialMeter(MeshIndexedSimpleFull* m, SimpleComponent* c,
 
 void SpazNode::Draw(FrameDef* frame_def) {
 #if !BA_HEADLESS_BUILD
+  body_render_matrices_.clear();
 
 #if BA_OSTYPE_MACOS
   if (g_graphics_server->renderer()->debug_draw_mode()) {
@@ -4501,7 +4666,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
     c.SetColor(1, 0, 0, 0.5f);
 
     c.PushTransform();
-    c.TransformToBody(*body_head_);
+    TransformToBody(&c, *body_head_);
 
     c.BeginDebugDrawTriangles();
     c.Vertex(0, 0.5f, 0);
@@ -4511,7 +4676,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
     c.PopTransform();
 
     c.PushTransform();
-    c.TransformToBody(*body_torso_);
+    TransformToBody(&c, *body_torso_);
     c.BeginDebugDrawTriangles();
     c.Vertex(0, 0.2f, 0);
     c.Vertex(0, 0, 0.2f);
@@ -4520,7 +4685,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
     c.PopTransform();
 
     c.PushTransform();
-    c.TransformToBody(*body_pelvis_);
+    TransformToBody(&c, *body_pelvis_);
     c.BeginDebugDrawTriangles();
     c.Vertex(0, 0.2f, 0);
     c.Vertex(0, 0, 0.2f);
@@ -4530,7 +4695,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
 
     c.SetColor(0.4f, 1.0f, 0.4f, 0.2f);
     c.PushTransform();
-    c.TransformToBody(*stand_body_);
+    TransformToBody(&c, *stand_body_);
     c.BeginDebugDrawTriangles();
     c.Vertex(0, 0.2f, 0);
     c.Vertex(0, 0, 0.5f);
@@ -4572,7 +4737,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
     if (explicit_bool(true)) {
       c.SetColor(1, 0, 0);
       c.PushTransform();
-      c.TransformToBody(*lower_left_leg_body_);
+      TransformToBody(&c, *lower_left_leg_body_);
       JointFixedEF* j = left_leg_ik_joint_;
       c.Translate(j->anchor2[0], j->anchor2[1], j->anchor2[2]);
       c.Rotate(90, 1, 0, 0);
@@ -4592,7 +4757,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
     if (explicit_bool(true)) {
       c.SetColor(0, 0, 1);
       c.PushTransform();
-      c.TransformToBody(*body_pelvis_);
+      TransformToBody(&c, *body_pelvis_);
       JointFixedEF* j = left_leg_ik_joint_;
       c.Translate(j->anchor1[0], j->anchor1[1], j->anchor1[2]);
       c.Rotate(90, 1, 0, 0);
@@ -4743,6 +4908,10 @@ void SpazNode::Draw(FrameDef* frame_def) {
   torso_pos[1] = torso_pos_raw[1] + body_torso_->blend_offset().y;
   torso_pos[2] = torso_pos_raw[2] + body_torso_->blend_offset().z;
 
+  // If our whole body (limbs, wings, gloves, etc) is out of view we can skip
+  // the beauty-pass drawing; overlays and shadows are still handled below.
+  bool body_culled = beauty_pass->CullSphere(Vector3f(torso_pos), 2.5f);
+
   // Curse time.
   if (curse_death_time_ > 0 && !dead_) {
     millisecs_t diff = (curse_death_time_ - scenetime) / 1000 + 1;
@@ -5065,7 +5234,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
   }
 
   // Draw all body parts with normal shading.
-  {
+  if (!body_culled) {
     {
       ObjectComponent c(beauty_pass);
       DrawBodyParts(&c, true, death_fade, death_scale, add_color);
@@ -5091,7 +5260,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
   }
 
   // Wings.
-  if (wings_) {
+  if (wings_ && !body_culled) {
     ObjectComponent c(beauty_pass);
     c.SetTransparent(false);
     c.SetColor(1, 1, 1, 1.0f);
@@ -5190,7 +5359,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
   }
 
   // Boxing gloves.
-  if (have_boxing_gloves_) {
+  if (have_boxing_gloves_ && !body_culled) {
     ObjectComponent c(beauty_pass);
     if (frozen_) {
       c.SetAddColor(0.1f, 0.1f, 0.4f);
@@ -5224,7 +5393,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
     c.SetTexture(g_media->GetTexture(SystemTextureID::kBoxingGlove));
 
     c.PushTransform();
-    c.TransformToBody(*lower_right_arm_body_);
+    TransformToBody(&c, *lower_right_arm_body_);
     if (death_scale != 1.0f) {
       c.Scale(death_scale, death_scale, death_scale);
     }
@@ -5233,7 +5402,7 @@ void SpazNode::Draw(FrameDef* frame_def) {
 
     c.FlipCullFace();
     c.PushTransform();
-    c.TransformToBody(*lower_left_arm_body_);
+    TransformToBody(&c, *lower_left_arm_body_);
     c.Scale(-1.0f, 1.0f, 1.0f);
     if (death_scale != 1.0f) {
       c.Scale(death_scale, death_scale, death_scale);
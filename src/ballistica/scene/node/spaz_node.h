@@ -17,6 +17,10 @@ namespace ballistica {
 class SpazNode : public Node {
  public:
   static auto InitType() -> NodeType*;
+
+  /// Time each phase of Step() across all spazzes (in any build type),
+  /// logging a per-phase breakdown when turned back off.
+  static void SetStepProfilingEnabled(bool enabled);
   explicit SpazNode(Scene* scene);
   ~SpazNode() override;
   void Step() override;
@@ -116,11 +120,11 @@ class SpazNode : public Node {
   void set_counter_texture(Texture* val) { counter_texture_ = val; }
   auto invincible() const -> bool { return invincible_; }
   void set_invincible(bool val) { invincible_ = val; }
-  auto name_color() const -> std::vector<float> { return name_color_; }
+  auto name_color() const -> const std::vector<float>& { return name_color_; }
   void SetNameColor(const std::vector<float>& vals);
-  auto highlight() const -> std::vector<float> { return highlight_; }
+  auto highlight() const -> const std::vector<float>& { return highlight_; }
   void set_highlight(const std::vector<float>& vals);
-  auto color() const -> std::vector<float> { return color_; }
+  auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& vals);
   auto hurt() const -> float { return hurt_; }
   void SetHurt(float val);
@@ -248,6 +252,11 @@ class SpazNode : public Node {
     kLowerRightArmJointBroken = 1u << 9u
   };
   void PlayHurtSound();
+
+  // Like RenderComponent::TransformToBody(), but each body's interpolated
+  // transform only gets calculated once per Draw(); we draw most bodies
+  // from several components (and passes) each frame.
+  void TransformToBody(RenderComponent* c, const RigidBody& body);
   void DrawBodyParts(ObjectComponent* c, bool shading, float death_fade,
                      float death_scale, float* add_color);
   void SetupEyeLidShading(ObjectComponent* c, float death_fade,
@@ -563,6 +572,11 @@ class SpazNode : public Node {
   millisecs_t last_hurt_change_time_{};
   bool billboard_cross_out_{};
   millisecs_t death_time_{};
+  struct BodyRenderMatrix {
+    const RigidBody* body;
+    float matrix[16];
+  };
+  std::vector<BodyRenderMatrix> body_render_matrices_;
 };
 
 }  // namespace ballistica
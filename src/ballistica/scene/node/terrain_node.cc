@@ -234,8 +234,10 @@ void TerrainNode::Draw(FrameDef* frame_def) {
     c.SetReflectionScale(reflection_scale_r_, reflection_scale_g_,
                          reflection_scale_b_);
   }
+  // (Floors tend to go see-through to show reflections, which we draw
+  // from high quality up).
   float opacity;
-  if (frame_def->quality() <= GraphicsQuality::kHigh
+  if (frame_def->quality() < GraphicsQuality::kHigh
       && opacity_in_low_or_medium_quality_ >= 0.0f) {
     opacity = opacity_in_low_or_medium_quality_;
   } else {
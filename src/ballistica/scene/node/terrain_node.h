@@ -39,7 +39,7 @@ class TerrainNode : public Node {
   }
   auto GetReflection() const -> std::string;
   void SetReflection(const std::string& val);
-  auto reflection_scale() const -> std::vector<float> {
+  auto reflection_scale() const -> const std::vector<float>& {
     return reflection_scale_;
   }
   void SetReflectionScale(const std::vector<float>& vals);
@@ -49,7 +49,7 @@ class TextNode : public Node {
   void SetVAlign(const std::string& val);
   auto color() const -> const std::vector<float>& { return color_; }
   void SetColor(const std::vector<float>& vals);
-  auto trail_color() const -> std::vector<float> { return trail_color_; }
+  auto trail_color() const -> const std::vector<float>& { return trail_color_; }
   void SetTrailColor(const std::vector<float>& vals);
   auto in_world() const -> bool { return in_world_; }
   void set_in_world(bool val) {
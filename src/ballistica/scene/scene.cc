@@ -2,13 +2,24 @@
 
 #include "ballistica/scene/scene.h"
 
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "ballistica/app/app_globals.h"
 #include "ballistica/audio/audio.h"
+#include "ballistica/core/event_trace.h"
 #include "ballistica/dynamics/bg/bg_dynamics.h"
 #include "ballistica/dynamics/dynamics.h"
 #include "ballistica/dynamics/part.h"
 #include "ballistica/game/game_stream.h"
+#include "ballistica/game/load_test.h"
 #include "ballistica/game/player.h"
+#include "ballistica/game/telemetry.h"
 #include "ballistica/graphics/camera.h"
 #include "ballistica/graphics/graphics.h"
 #include "ballistica/input/device/input_device.h"
@@ -26,7 +37,9 @@
 #include "ballistica/scene/node/light_node.h"
 #include "ballistica/scene/node/locator_node.h"
 #include "ballistica/scene/node/math_node.h"
+#include "ballistica/scene/node/node_attribute.h"
 #include "ballistica/scene/node/node_attribute_connection.h"
+#include "ballistica/scene/node/node_message.h"
 #include "ballistica/scene/node/null_node.h"
 #include "ballistica/scene/node/player_node.h"
 #include "ballistica/scene/node/region_node.h"
@@ -42,31 +55,40 @@
 
 namespace ballistica {
 
+// Set up a node type, noting whether its class overrides Step().
+template <typename T>
+static auto InitNodeType() -> NodeType* {
+  NodeType* node_type = T::InitType();
+  node_type->set_has_step(
+      !std::is_same<decltype(&T::Step), void (Node::*)()>::value);
+  return node_type;
+}
+
 void Scene::Init() {
-  NodeType* node_types[] = {NullNode::InitType(),
-                            GlobalsNode::InitType(),
-                            SessionGlobalsNode::InitType(),
-                            PropNode::InitType(),
-                            FlagNode::InitType(),
-                            BombNode::InitType(),
-                            ExplosionNode::InitType(),
-                            ShieldNode::InitType(),
-                            LightNode::InitType(),
-                            TextNode::InitType(),
-                            AnimCurveNode::InitType(),
-                            ImageNode::InitType(),
-                            TerrainNode::InitType(),
-                            MathNode::InitType(),
-                            LocatorNode::InitType(),
-                            PlayerNode::InitType(),
-                            CombineNode::InitType(),
-                            SoundNode::InitType(),
-                            SpazNode::InitType(),
-                            RegionNode::InitType(),
-                            ScorchNode::InitType(),
-                            FlashNode::InitType(),
-                            TextureSequenceNode::InitType(),
-                            TimeDisplayNode::InitType()};
+  NodeType* node_types[] = {InitNodeType<NullNode>(),
+                            InitNodeType<GlobalsNode>(),
+                            InitNodeType<SessionGlobalsNode>(),
+                            InitNodeType<PropNode>(),
+                            InitNodeType<FlagNode>(),
+                            InitNodeType<BombNode>(),
+                            InitNodeType<ExplosionNode>(),
+                            InitNodeType<ShieldNode>(),
+                            InitNodeType<LightNode>(),
+                            InitNodeType<TextNode>(),
+                            InitNodeType<AnimCurveNode>(),
+                            InitNodeType<ImageNode>(),
+                            InitNodeType<TerrainNode>(),
+                            InitNodeType<MathNode>(),
+                            InitNodeType<LocatorNode>(),
+                            InitNodeType<PlayerNode>(),
+                            InitNodeType<CombineNode>(),
+                            InitNodeType<SoundNode>(),
+                            InitNodeType<SpazNode>(),
+                            InitNodeType<RegionNode>(),
+                            InitNodeType<ScorchNode>(),
+                            InitNodeType<FlashNode>(),
+                            InitNodeType<TextureSequenceNode>(),
+                            InitNodeType<TimeDisplayNode>()};
 
   int next_type_id = 0;
   assert(g_app_globals != nullptr);
@@ -76,23 +98,10 @@ void Scene::Init() {
     t->set_id(next_type_id++);
   }
 
-  // Types: I is 32 bit int, i is 16 bit int, c is 8 bit int,
-  // F is 32 bit float, f is 16 bit float,
-  // s is string, b is bool.
-  SetupNodeMessageType("flash", NodeMessageType::kFlash, "");
-  SetupNodeMessageType("footing", NodeMessageType::kFooting, "c");
-  SetupNodeMessageType("impulse", NodeMessageType::kImpulse, "fffffffffifff");
-  SetupNodeMessageType("kick_back", NodeMessageType::kKickback, "fffffff");
-  SetupNodeMessageType("celebrate", NodeMessageType::kCelebrate, "i");
-  SetupNodeMessageType("celebrate_l", NodeMessageType::kCelebrateL, "i");
-  SetupNodeMessageType("celebrate_r", NodeMessageType::kCelebrateR, "i");
-  SetupNodeMessageType("knockout", NodeMessageType::kKnockout, "f");
-  SetupNodeMessageType("hurt_sound", NodeMessageType::kHurtSound, "");
-  SetupNodeMessageType("picked_up", NodeMessageType::kPickedUp, "");
-  SetupNodeMessageType("jump_sound", NodeMessageType::kJumpSound, "");
-  SetupNodeMessageType("attack_sound", NodeMessageType::kAttackSound, "");
-  SetupNodeMessageType("scream_sound", NodeMessageType::kScreamSound, "");
-  SetupNodeMessageType("stand", NodeMessageType::kStand, "ffff");
+  // Formats live with their message structs; see node_message.h.
+  for (auto&& spec : kNodeMessageSpecs) {
+    SetupNodeMessageType(spec.name, spec.type, spec.format);
+  }
 }
 
 void Scene::SetupNodeMessageType(const std::string& name, NodeMessageType val,
@@ -118,6 +127,13 @@ void Scene::SetMapBounds(float xmin, float ymin, float zmin, float xmax,
   bounds_max_[0] = xmax;
   bounds_max_[1] = ymax;
   bounds_max_[2] = zmax;
+
+  // Non-default collision spaces get sized to our bounds, so (re)build ours
+  // now. The default hash space is left alone; it needs no sizing.
+  if (g_app_globals->physics_broadphase != PhysicsBroadphase::kHash) {
+    dynamics_->SetBroadphase(g_app_globals->physics_broadphase, bounds_min_,
+                             bounds_max_);
+  }
 }
 
 Scene::Scene(millisecs_t start_time)
@@ -179,6 +195,10 @@ auto Scene::IsOutOfBounds(float x, float y, float z) -> bool {
 }
 
 void Scene::Draw(FrameDef* frame_def) {
+  if (g_app_globals->physics_render_interpolation) {
+    dynamics_->UpdateRenderInterpolation(frame_def->base_time());
+  }
+
   // Draw our nodes.
   for (auto&& i : nodes_) {
     g_graphics->PreNodeDraw();
@@ -220,27 +240,48 @@ auto Scene::GetPlayerNode(int id) -> PlayerNode* {
 }
 
 void Scene::Step() {
+  BA_TRACE_SCOPE("Scene::Step");
   out_of_bounds_nodes_.clear();
 
+  if (g_app_globals->physics_render_interpolation) {
+    dynamics_->StoreInterpolationStates(g_game->master_time());
+  }
+
+  // Time each phase for telemetry.
+  auto phase_start_time = std::chrono::steady_clock::now();
+  auto end_phase = [&phase_start_time](Telemetry::ScenePhase phase) {
+    auto now = std::chrono::steady_clock::now();
+    Telemetry::AddScenePhase(
+        phase, std::chrono::duration<double>(now - phase_start_time).count());
+    phase_start_time = now;
+  };
+
   // Step all our nodes.
   {
     in_step_ = true;
     last_step_real_time_ = GetRealTime();
     for (auto&& i : nodes_) {
       Node* node = i.get();
-      node->Step();
+      if (node->type()->has_step()) {
+        node->Step();
+      }
 
       // Now that it's stepped, pump new values to any nodes it's connected to.
-      node->UpdateConnections();
+      if (!node->attribute_connections().empty()) {
+        node->UpdateConnections();
+      }
     }
     in_step_ = false;
   }
+  end_phase(Telemetry::ScenePhase::kNodes);
   bool is_foreground = (g_game->GetForegroundScene() == this);
 
   // Add a step command to the output stream.
   if (output_stream_.exists()) {
+    BA_TRACE_SCOPE("GameStream::StepScene");
     output_stream_->StepScene(this);
   }
+  end_phase(Telemetry::ScenePhase::kOutputStream);
 
   // And step things locally.
   if (is_foreground) {
@@ -250,9 +291,18 @@ void Scene::Step() {
     g_bg_dynamics->Step(cam_pos);
 #endif  // !BA_HEADLESS_BUILD
   }
+  end_phase(Telemetry::ScenePhase::kBGDynamics);
 
   // Lastly step our sim.
   dynamics_->process();
+  end_phase(Telemetry::ScenePhase::kDynamics);
+
+  if (g_app_globals->turbo_mode) {
+    g_game->AddTurboSceneStepStats(nodes_.size(), dynamics_->collision_count());
+  }
+  if (LoadTest::running()) {
+    LoadTest::AddSceneStep(nodes_.size(), dynamics_->collision_count());
+  }
 
   time_ += kGameStepMilliseconds;
   stepnum_++;
@@ -335,11 +385,8 @@ void Scene::LanguageChanged() {
 }
 
 auto Scene::GetNodeMessageFormat(NodeMessageType type) -> const char* {
-  assert(g_app_globals != nullptr);
-  if ((unsigned int)type >= g_app_globals->node_message_formats.size()) {
-    return nullptr;
-  }
-  return g_app_globals->node_message_formats[static_cast<int>(type)].c_str();
+  const NodeMessageSpec* spec = GetNodeMessageSpec(type);
+  return spec ? spec->format : nullptr;
 }
 
 auto Scene::NewNode(const std::string& type_string, const std::string& name,
@@ -525,97 +572,450 @@ void Scene::DumpNodes(GameStream* out) {
   }
 }
 
-auto Scene::GetCorrectionMessage(bool blended) -> std::vector<uint8_t> {
-  // Let's loop over our nodes sending a bit of correction data.
+// Snapshots never leave the process, so values just get packed in their
+// native layouts.
+template <typename T>
+static void SnapshotPut(std::vector<uint8_t>* out, const T& val) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "snapshot values must be plain data");
+  size_t offset = out->size();
+  out->resize(offset + sizeof(T));
+  memcpy(out->data() + offset, &val, sizeof(T));
+}
 
-  // Go through until we find at least 1 node to send corrections for,
-  // or until we loop all the way through.
+static void SnapshotPutBytes(std::vector<uint8_t>* out, const void* data,
+                             size_t size) {
+  size_t offset = out->size();
+  out->resize(offset + size);
+  if (size > 0) {
+    memcpy(out->data() + offset, data, size);
+  }
+}
 
-  // 1 byte type, 1 byte blending, 2 byte node count
-  std::vector<uint8_t> message(4);
-  message[0] = BA_MESSAGE_SESSION_DYNAMICS_CORRECTION;
-  message[1] = static_cast<uint8_t>(blended);
-  int node_count = 0;
+namespace {
+class SnapshotReader {
+ public:
+  explicit SnapshotReader(const std::vector<uint8_t>& data) : data_(data) {}
+  template <typename T>
+  auto Get() -> T {
+    T val;
+    memcpy(&val, GetBytes(sizeof(T)), sizeof(T));
+    return val;
+  }
+  auto GetBytes(size_t size) -> const uint8_t* {
+    if (size > data_.size() - offset_) {
+      throw Exception("Invalid scene snapshot.", PyExcType::kValue);
+    }
+    const uint8_t* out = data_.data() + offset_;
+    offset_ += size;
+    return out;
+  }
 
-  std::vector<RigidBody*> dynamic_bodies;
+ private:
+  const std::vector<uint8_t>& data_;
+  size_t offset_{};
+};
+}  // namespace
+
+// Attr types we can capture; the rest are references to things.
+static auto IsSnapshotAttrType(NodeAttributeType type) -> bool {
+  switch (type) {
+    case NodeAttributeType::kFloat:
+    case NodeAttributeType::kInt:
+    case NodeAttributeType::kBool:
+    case NodeAttributeType::kString:
+    case NodeAttributeType::kFloatArray:
+    case NodeAttributeType::kIntArray:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void PutSnapshotAttr(std::vector<uint8_t>* out,
+                            NodeAttributeUnbound* attr, Node* node) {
+  switch (attr->type()) {
+    case NodeAttributeType::kFloat:
+      SnapshotPut(out, attr->GetAsFloat(node));
+      break;
+    case NodeAttributeType::kInt:
+      SnapshotPut(out, attr->GetAsInt(node));
+      break;
+    case NodeAttributeType::kBool:
+      SnapshotPut(out, static_cast<uint8_t>(attr->GetAsBool(node)));
+      break;
+    case NodeAttributeType::kString: {
+      std::string val = attr->GetAsString(node);
+      SnapshotPut(out, static_cast_check_fit<uint32_t>(val.size()));
+      SnapshotPutBytes(out, val.data(), val.size());
+      break;
+    }
+    case NodeAttributeType::kFloatArray: {
+      std::vector<float> vals = attr->GetAsFloats(node);
+      SnapshotPut(out, static_cast_check_fit<uint32_t>(vals.size()));
+      SnapshotPutBytes(out, vals.data(), vals.size() * sizeof(float));
+      break;
+    }
+    case NodeAttributeType::kIntArray: {
+      std::vector<int64_t> vals = attr->GetAsInts(node);
+      SnapshotPut(out, static_cast_check_fit<uint32_t>(vals.size()));
+      SnapshotPutBytes(out, vals.data(), vals.size() * sizeof(int64_t));
+      break;
+    }
+    default:
+      assert(false);
+  }
+}
+
+// Read an attr value and set it on node (if node is non-null) where it
+// differs from the current one.
+static void ApplySnapshotAttr(SnapshotReader* reader,
+                              NodeAttributeUnbound* attr, Node* node) {
+  switch (attr->type()) {
+    case NodeAttributeType::kFloat: {
+      auto val = reader->Get<float>();
+      if (node && attr->GetAsFloat(node) != val) {
+        attr->Set(node, val);
+      }
+      break;
+    }
+    case NodeAttributeType::kInt: {
+      auto val = reader->Get<int64_t>();
+      if (node && attr->GetAsInt(node) != val) {
+        attr->Set(node, val);
+      }
+      break;
+    }
+    case NodeAttributeType::kBool: {
+      bool val = reader->Get<uint8_t>() != 0;
+      if (node && attr->GetAsBool(node) != val) {
+        attr->Set(node, val);
+      }
+      break;
+    }
+    case NodeAttributeType::kString: {
+      auto size = reader->Get<uint32_t>();
+      auto* data = reinterpret_cast<const char*>(reader->GetBytes(size));
+      std::string val(data, size);
+      if (node && attr->GetAsString(node) != val) {
+        attr->Set(node, val);
+      }
+      break;
+    }
+    case NodeAttributeType::kFloatArray: {
+      auto count = reader->Get<uint32_t>();
+      const uint8_t* data = reader->GetBytes(count * sizeof(float));
+      std::vector<float> vals(count);
+      if (count > 0) {
+        memcpy(vals.data(), data, count * sizeof(float));
+      }
+      if (node && attr->GetAsFloats(node) != vals) {
+        attr->Set(node, vals);
+      }
+      break;
+    }
+    case NodeAttributeType::kIntArray: {
+      auto count = reader->Get<uint32_t>();
+      const uint8_t* data = reader->GetBytes(count * sizeof(int64_t));
+      std::vector<int64_t> vals(count);
+      if (count > 0) {
+        memcpy(vals.data(), data, count * sizeof(int64_t));
+      }
+      if (node && attr->GetAsInts(node) != vals) {
+        attr->Set(node, vals);
+      }
+      break;
+    }
+    default:
+      throw Exception("Invalid scene snapshot.", PyExcType::kValue);
+  }
+}
+
+// Write a single node's snapshot entry.
+static void PutNodeSnapshot(std::vector<uint8_t>* out, Node* node) {
+  SnapshotPut(out, node->id());
+  SnapshotPut(out, static_cast<int32_t>(node->type()->id()));
+
+  // Attrs, by index.
+  const std::vector<NodeAttributeUnbound*>& attrs =
+      node->type()->attributes_by_index();
+  size_t attr_count_offset = out->size();
+  uint16_t attr_count{};
+  SnapshotPut(out, attr_count);
+  for (NodeAttributeUnbound* attr : attrs) {
+    if (attr->is_read_only() || !IsSnapshotAttrType(attr->type())) {
+      continue;
+    }
+    SnapshotPut(out, static_cast_check_fit<uint16_t>(attr->index()));
+    PutSnapshotAttr(out, attr, node);
+    attr_count++;
+  }
+  memcpy(out->data() + attr_count_offset, &attr_count, sizeof(attr_count));
+
+  // Dynamic bodies, by part and body id.
+  size_t body_count_offset = out->size();
+  uint16_t body_count{};
+  SnapshotPut(out, body_count);
+  for (Part* part : node->parts()) {
+    for (RigidBody* body : part->rigid_bodies()) {
+      if (body->type() != RigidBody::Type::kBody) {
+        continue;
+      }
+      SnapshotPut(out, static_cast<int32_t>(part->id()));
+      SnapshotPut(out, static_cast<int32_t>(body->id()));
+      size_t offset = out->size();
+      out->resize(offset + RigidBody::kSnapshotSize);
+      body->GetSnapshot(out->data() + offset);
+      body_count++;
+    }
+  }
+  memcpy(out->data() + body_count_offset, &body_count, sizeof(body_count));
 
+  // Custom data.
+  std::vector<uint8_t> resync_data = node->GetResyncData();
+  SnapshotPut(out, static_cast_check_fit<uint32_t>(resync_data.size()));
+  SnapshotPutBytes(out, resync_data.data(), resync_data.size());
+}
+
+auto Scene::GetSnapshot() -> std::vector<uint8_t> {
+  assert(InGameThread());
+  std::vector<uint8_t> out;
+  SnapshotPut(&out, static_cast<uint32_t>(nodes_.size()));
   for (auto&& i : nodes_) {
-    Node* n = i.get();
-    assert(n);
-    if (n && !n->parts().empty()) {
-      dynamic_bodies.clear();
-      for (auto&& j : n->parts()) {
-        if (!j->rigid_bodies().empty()) {
-          for (auto&& k : j->rigid_bodies()) {
-            if (k->type() == RigidBody::Type::kBody) {
-              dynamic_bodies.push_back(k);
-            }
+    assert(i.exists());
+    PutNodeSnapshot(&out, i.get());
+  }
+  return out;
+}
+
+// 64 bit FNV-1a, continuing from hash.
+static auto DigestBytes(const uint8_t* data, size_t size, uint64_t hash)
+    -> uint64_t {
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+const uint64_t kDigestSeed = 14695981039346656037ull;
+
+auto Scene::GetNodeDigests() -> std::vector<std::pair<Node*, uint64_t> > {
+  assert(InGameThread());
+  std::vector<std::pair<Node*, uint64_t> > digests;
+  digests.reserve(nodes_.size());
+  std::vector<uint8_t> buffer;
+  for (auto&& i : nodes_) {
+    assert(i.exists());
+    buffer.resize(0);
+    PutNodeSnapshot(&buffer, i.get());
+    uint64_t digest = DigestBytes(buffer.data(), buffer.size(), kDigestSeed);
+    digests.emplace_back(i.get(), digest);
+  }
+  return digests;
+}
+
+auto Scene::GetDigest() -> uint64_t {
+  uint64_t hash = kDigestSeed;
+  for (auto&& i : GetNodeDigests()) {
+    hash = DigestBytes(reinterpret_cast<const uint8_t*>(&i.second),
+                       sizeof(i.second), hash);
+  }
+  return hash;
+}
+
+auto Scene::ApplySnapshot(const std::vector<uint8_t>& snapshot) -> int {
+  assert(InGameThread());
+  // (Weak refs since setters could conceivably kill other nodes).
+  std::unordered_map<int64_t, Object::WeakRef<Node> > nodes_by_id;
+  for (auto&& i : nodes_) {
+    nodes_by_id[i->id()] = i;
+  }
+  SnapshotReader reader(snapshot);
+  auto node_count = reader.Get<uint32_t>();
+  int restored_count{};
+  for (uint32_t n = 0; n < node_count; n++) {
+    auto node_id = reader.Get<int64_t>();
+    auto type_id = reader.Get<int32_t>();
+    auto type_iter = g_app_globals->node_types_by_id.find(type_id);
+    if (type_iter == g_app_globals->node_types_by_id.end()) {
+      throw Exception("Invalid scene snapshot.", PyExcType::kValue);
+    }
+    NodeType* node_type = type_iter->second;
+
+    // Entries for dead nodes still need reading through.
+    Node* node{};
+    auto i = nodes_by_id.find(node_id);
+    if (i != nodes_by_id.end() && i->second.exists()
+        && i->second->type() == node_type) {
+      node = i->second.get();
+    }
+    auto attr_count = reader.Get<uint16_t>();
+    for (int a = 0; a < attr_count; a++) {
+      auto index = reader.Get<uint16_t>();
+      if (index >= node_type->attributes_by_index().size()) {
+        throw Exception("Invalid scene snapshot.", PyExcType::kValue);
+      }
+      ApplySnapshotAttr(&reader, node_type->GetAttribute(index), node);
+    }
+    auto body_count = reader.Get<uint16_t>();
+    for (int b = 0; b < body_count; b++) {
+      auto part_id = reader.Get<int32_t>();
+      auto body_id = reader.Get<int32_t>();
+      const uint8_t* data = reader.GetBytes(RigidBody::kSnapshotSize);
+      if (node == nullptr) {
+        continue;
+      }
+      for (Part* part : node->parts()) {
+        if (part->id() != part_id) {
+          continue;
+        }
+        for (RigidBody* body : part->rigid_bodies()) {
+          if (body->id() == body_id
+              && body->type() == RigidBody::Type::kBody) {
+            body->ApplySnapshot(data);
           }
         }
       }
-      if (!dynamic_bodies.empty()) {
-        int node_embed_size = 5;  // 4 byte node-ID and 1 byte body-count
-        int body_count = 0;
-        for (auto&& i2 : dynamic_bodies) {
-          node_embed_size += 3 + i2->GetEmbeddedSizeFull();
-          body_count++;
-        }
+    }
+    auto resync_size = reader.Get<uint32_t>();
+    const uint8_t* resync_data = reader.GetBytes(resync_size);
+    if (node) {
+      if (resync_size > 0) {
+        node->ApplyResyncData(
+            std::vector<uint8_t>(resync_data, resync_data + resync_size));
+      }
+      restored_count++;
+    }
+  }
+  return restored_count;
+}
 
-        // Lastly add custom data.
-        node_embed_size += 2;  // size
-        int resync_data_size = n->GetResyncDataSize();
-        node_embed_size += resync_data_size;
-
-        // If this size puts us over our max packet size (and we've got
-        // something in the packet already) just ship what we've got.
-        // We'll come back to this one next time.
-        {
-          node_count++;
-          size_t old_size = message.size();
-          message.resize(old_size + node_embed_size);
-
-          // Embed node id.
-          auto stream_id_val = static_cast_check_fit<uint32_t>(n->stream_id());
-          memcpy(message.data() + old_size, &stream_id_val,
-                 sizeof(stream_id_val));
-
-          // Embed body count.
-          message[old_size + 4] = static_cast_check_fit<uint8_t>(body_count);
-          size_t offset = old_size + 5;
-          for (auto&& i2 : dynamic_bodies) {
-            // Embed body id.
-            message[offset++] = static_cast_check_fit<uint8_t>(i2->id());
-            int body_embed_size = i2->GetEmbeddedSizeFull();
-
-            // Embed body size.
-            auto val = static_cast_check_fit<uint16_t>(body_embed_size);
-            memcpy(message.data() + offset, &val, sizeof(val));
-            offset += 2;
-            char* p1 = reinterpret_cast<char*>(&(message[offset]));
-            char* p2 = p1;
-            i2->EmbedFull(&p2);
-            assert(p2 - p1 == body_embed_size);
-            offset += body_embed_size;
-          }
+// Correction messages past this size only carry the nodes that need it
+// most; the rest wait their turn for a later message.
+const size_t kMaxCorrectionMessageSize = 4 * kMaxPacketSize;
 
-          // Lastly embed custom data size and custom data.
-          auto val = static_cast_check_fit<uint16_t>(resync_data_size);
-          memcpy(message.data() + offset, &val, sizeof(val));
-          offset += 2;
-          if (resync_data_size > 0) {
-            std::vector<uint8_t> resync_data = n->GetResyncData();
-            assert(resync_data.size() == resync_data_size);
-            memcpy(message.data() + offset, &(resync_data[0]),
-                   resync_data.size());
-            offset += resync_data_size;
-          }
-          assert(offset == message.size());
+// Node resync data can change without bodies moving, so it gets a nudge.
+const float kResyncDataCorrectionPriority = 0.5f;
+
+auto Scene::GetCorrectionMessage(bool blended) -> std::vector<uint8_t> {
+  // Gather nodes that have something worth sending, rank them by how far
+  // clients are likely to have drifted, and send as many of the worst as
+  // fit in our size budget. Anything we skip keeps drifting (and aging)
+  // so it ranks higher next time.
+  struct Candidate {
+    Node* node;
+    size_t bodies_begin;
+    size_t bodies_end;
+    int resync_data_size;
+    int embed_size;
+    float priority;
+  };
+  std::vector<Candidate> candidates;
+  std::vector<RigidBody*> dynamic_bodies;
+
+  for (auto&& i : nodes_) {
+    Node* n = i.get();
+    assert(n);
+    if (!n || n->parts().empty()) {
+      continue;
+    }
+    size_t bodies_begin = dynamic_bodies.size();
+    for (auto&& j : n->parts()) {
+      for (auto&& k : j->rigid_bodies()) {
+        if (k->type() == RigidBody::Type::kBody) {
+          dynamic_bodies.push_back(k);
         }
       }
     }
+    if (dynamic_bodies.size() == bodies_begin) {
+      continue;
+    }
+    int resync_data_size = n->GetResyncDataSize();
+
+    // Skip nodes whose bodies are all lying still in the same state we
+    // last sent; clients already have that. (Nodes with custom resync
+    // data always go out since that can change regardless).
+    bool all_unchanged = (resync_data_size == 0);
+    float priority =
+        resync_data_size > 0 ? kResyncDataCorrectionPriority : 0.0f;
+
+    // 4 byte node-ID, 1 byte body-count, and 2 byte custom data size.
+    int embed_size = 7 + resync_data_size;
+    for (size_t b = bodies_begin; b < dynamic_bodies.size(); b++) {
+      RigidBody* body = dynamic_bodies[b];
+      if (all_unchanged && !body->IsAsleepSinceLastEmbed()) {
+        all_unchanged = false;
+      }
+      priority = std::max(priority, body->GetEmbedDivergence());
+      embed_size += 3 + body->GetEmbeddedSizeFull();
+    }
+    if (all_unchanged) {
+      dynamic_bodies.resize(bodies_begin);
+      continue;
+    }
+    candidates.push_back({n, bodies_begin, dynamic_bodies.size(),
+                          resync_data_size, embed_size, priority});
+  }
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     return a.priority > b.priority;
+                   });
+
+  // 1 byte type, 1 byte blending, 2 byte node count
+  std::vector<uint8_t> message(4);
+  message[0] = BA_MESSAGE_SESSION_DYNAMICS_CORRECTION;
+  message[1] = static_cast<uint8_t>(blended);
+  int node_count = 0;
+
+  for (auto&& c : candidates) {
+    // Once we're over budget, skip anything that doesn't fit (though
+    // always send at least one so nothing can get stuck).
+    size_t old_size = message.size();
+    if (node_count > 0 && old_size + c.embed_size > kMaxCorrectionMessageSize) {
+      continue;
+    }
+    node_count++;
+    message.resize(old_size + c.embed_size);
+
+    // Embed node id.
+    auto stream_id_val = static_cast_check_fit<uint32_t>(c.node->stream_id());
+    memcpy(message.data() + old_size, &stream_id_val, sizeof(stream_id_val));
+
+    // Embed body count.
+    message[old_size + 4] =
+        static_cast_check_fit<uint8_t>(c.bodies_end - c.bodies_begin);
+    size_t offset = old_size + 5;
+    for (size_t b = c.bodies_begin; b < c.bodies_end; b++) {
+      RigidBody* body = dynamic_bodies[b];
+
+      // Embed body id.
+      message[offset++] = static_cast_check_fit<uint8_t>(body->id());
+      int body_embed_size = body->GetEmbeddedSizeFull();
+
+      // Embed body size.
+      auto val = static_cast_check_fit<uint16_t>(body_embed_size);
+      memcpy(message.data() + offset, &val, sizeof(val));
+      offset += 2;
+      char* p1 = reinterpret_cast<char*>(&(message[offset]));
+      char* p2 = p1;
+      body->EmbedFull(&p2);
+      assert(p2 - p1 == body_embed_size);
+      offset += body_embed_size;
+    }
+
+    // Lastly embed custom data size and custom data.
+    auto val = static_cast_check_fit<uint16_t>(c.resync_data_size);
+    memcpy(message.data() + offset, &val, sizeof(val));
+    offset += 2;
+    if (c.resync_data_size > 0) {
+      std::vector<uint8_t> resync_data = c.node->GetResyncData();
+      assert(resync_data.size() == c.resync_data_size);
+      memcpy(message.data() + offset, &(resync_data[0]), resync_data.size());
+      offset += c.resync_data_size;
+    }
+    assert(offset == message.size());
   }
 
-  // If we embedded any nodes, send.
   // Store node count in packet.
   auto val = static_cast_check_fit<uint16_t>(node_count);
   memcpy(message.data() + 2, &val, sizeof(val));
@@ -5,6 +5,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "ballistica/core/object.h"
@@ -67,6 +68,28 @@ class Scene : public Object {
   auto DumpNodes(GameStream* out) -> void;
   auto GetCorrectionMessage(bool blended) -> std::vector<uint8_t>;
 
+  /// Capture the state of all current nodes: writable plain-data attrs
+  /// (numbers, bools, strings and arrays of those), exact rigid body
+  /// states, and any custom resync data. The result is only meaningful
+  /// within this process.
+  auto GetSnapshot() -> std::vector<uint8_t>;
+
+  /// Put nodes from a snapshot back the way they were. Nodes that have
+  /// since died are skipped and ones created since are left alone, as are
+  /// scene time and anything not listed above. Attrs only get set where
+  /// they differ from the snapshot so setters don't re-fire needlessly.
+  /// Returns the number of nodes restored.
+  auto ApplySnapshot(const std::vector<uint8_t>& snapshot) -> int;
+
+  /// Hashes of each node's snapshot state (see GetSnapshot()), in node
+  /// order, and a single hash of those for the whole scene. Runs that
+  /// should be stepping identically (a replay against the original game,
+  /// say) can compare these step by step to find where and in which node
+  /// they first diverge. Like snapshots, only bitwise-equal state
+  /// matches.
+  auto GetNodeDigests() -> std::vector<std::pair<Node*, uint64_t> >;
+  auto GetDigest() -> uint64_t;
+
   auto SetOutputStream(GameStream* val) -> void;
   auto stream_id() const -> int64_t { return stream_id_; }
   auto set_stream_id(int64_t val) -> void {
@@ -15,7 +15,7 @@ namespace ballistica {
 // How much of the screen the console covers when it is at full size.
 const float kConsoleSize = 0.9f;
 const float kConsoleZDepth = 0.0f;
-const int kConsoleLineLimit = 80;
+const size_t kConsoleLineLimit = 80;
 const int kStringBreakUpSize = 1950;
 const int kActivateKey1 = SDLK_BACKQUOTE;
 const int kActivateKey2 = SDLK_F2;
@@ -112,6 +112,7 @@ auto Console::HandleKeyPress(const SDL_Keysym* keysym) -> bool {
       if (input_string_ == "clear") {
         last_line_.clear();
         lines_.clear();
+        lines_start_ = 0;
       } else {
         g_game->PushInGameConsoleScriptCommand(input_string_);
       }
@@ -194,16 +195,26 @@ void Console::Print(const std::string& s_in) {
                                  &broken_up);
 
   // Spit out all completed lines and keep the last one as lastline.
-  for (size_t i = 0; i < broken_up.size() - 1; i++) {
-    lines_.emplace_back(broken_up[i], GetRealTime());
-    if (lines_.size() > kConsoleLineLimit) {
-      lines_.pop_front();
-    }
+  // (No use storing more than would fit in our scrollback).
+  size_t completed = broken_up.size() - 1;
+  size_t first =
+      completed > kConsoleLineLimit ? completed - kConsoleLineLimit : 0;
+  for (size_t i = first; i < completed; i++) {
+    AddLine(broken_up[i]);
   }
   last_line_ = broken_up[broken_up.size() - 1];
   last_line_mesh_dirty_ = true;
 }
 
+void Console::AddLine(const std::string& s) {
+  if (lines_.size() < kConsoleLineLimit) {
+    lines_.emplace_back(s, GetRealTime());
+  } else {
+    lines_[lines_start_] = Message(s, GetRealTime());
+    lines_start_ = (lines_start_ + 1) % lines_.size();
+  }
+}
+
 #pragma clang diagnostic pop
 
 void Console::Draw(RenderPass* pass) {
@@ -346,19 +357,29 @@ void Console::Draw(RenderPass* pass) {
         }
         v += 14;
       }
-      for (auto i = lines_.rbegin(); i != lines_.rend(); i++) {
-        int elem_count = i->getText().GetElementCount();
+      // Newest lines first; only those on screen keep meshes.
+      size_t line_count = lines_.size();
+      bool on_screen = true;
+      for (size_t n = 0; n < line_count; n++) {
+        size_t index = (lines_start_ + line_count - 1 - n) % line_count;
+        Message& line = lines_[index];
+        if (!on_screen) {
+          line.ReleaseText();
+          continue;
+        }
+        TextGroup& text = line.getText();
+        int elem_count = text.GetElementCount();
         for (int e = 0; e < elem_count; e++) {
-          c.SetTexture(i->getText().GetElementTexture(e));
+          c.SetTexture(text.GetElementTexture(e));
           c.PushTransform();
           c.Translate(h, v + 2, kConsoleZDepth);
           c.Scale(draw_scale, draw_scale);
-          c.DrawMesh(i->getText().GetElementMesh(e));
+          c.DrawMesh(text.GetElementMesh(e));
           c.PopTransform();
         }
         v += 14;
         if (v > pass->virtual_height() + 14) {
-          break;
+          on_screen = false;
         }
       }
       c.Submit();
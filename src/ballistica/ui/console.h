@@ -6,6 +6,7 @@
 #include <list>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "ballistica/core/object.h"
 #include "ballistica/graphics/renderer.h"
@@ -27,6 +28,8 @@ class Console {
   void Draw(RenderPass* pass);
 
  private:
+  void AddLine(const std::string& s);
+
   ImageMesh bg_mesh_;
   ImageMesh stripe_mesh_;
   ImageMesh shadow_mesh_;
@@ -53,13 +56,19 @@ class Console {
       return *s_mesh_;
     }
 
+    // Kill our mesh (when we're off screen).
+    void ReleaseText() { s_mesh_.Clear(); }
+
    private:
     Object::Ref<TextGroup> s_mesh_;
   };
   std::string input_string_;
   std::list<std::string> input_history_;
   int input_history_position_{};
-  std::list<Message> lines_;
+
+  // Scrollback ring; once full, the oldest line is at lines_start_.
+  std::vector<Message> lines_;
+  size_t lines_start_{};
   std::string last_line_;
   Object::Ref<TextGroup> last_line_mesh_group_;
   bool last_line_mesh_dirty_{true};
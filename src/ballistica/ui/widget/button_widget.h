@@ -15,8 +15,14 @@ class ButtonWidget : public Widget {
   ~ButtonWidget() override;
   void Draw(RenderPass* pass, bool transparent) override;
   auto HandleMessage(const WidgetMessage& m) -> bool override;
-  void set_width(float width) { width_ = width; }
-  void set_height(float height) { height_ = height; }
+  void set_width(float width) {
+    width_ = width;
+    NoteBoundsChange();
+  }
+  void set_height(float height) {
+    height_ = height;
+    NoteBoundsChange();
+  }
   auto GetWidth() -> float override;
   auto GetHeight() -> float override;
   void SetColor(float r, float g, float b) {
@@ -33,12 +33,14 @@ void CheckBoxWidget::SetText(const std::string& text) {
 void CheckBoxWidget::SetWidth(float width_in) {
   highlight_dirty_ = box_dirty_ = check_dirty_ = true;
   width_ = width_in;
+  NoteBoundsChange();
   text_.SetWidth(width_in - (2 * box_padding_ + box_size_ + 4));
 }
 
 void CheckBoxWidget::SetHeight(float height_in) {
   highlight_dirty_ = box_dirty_ = check_dirty_ = true;
   height_ = height_in;
+  NoteBoundsChange();
   text_.SetHeight(height_in);
 }
 
@@ -2,6 +2,8 @@
 
 #include "ballistica/ui/widget/container_widget.h"
 
+#include <algorithm>
+
 #include "ballistica/audio/audio.h"
 #include "ballistica/game/game.h"
 #include "ballistica/graphics/component/empty_component.h"
@@ -1061,6 +1063,7 @@ void ContainerWidget::AddWidget(Widget* w) {
     BA_DEBUG_UI_WRITE_LOCK;
     w->set_parent_widget(this);
     widgets_.insert(widgets_.end(), Object::Ref<Widget>(w));
+    nav_index_dirty_ = true;
   }
 
   // If we're not selectable ourself and our child is, select it.
@@ -1103,6 +1106,7 @@ auto ContainerWidget::IsAcceptingInput() const -> bool {
 void ContainerWidget::Clear() {
   BA_DEBUG_UI_WRITE_LOCK;
   widgets_.clear();
+  nav_index_dirty_ = true;
   selected_widget_ = nullptr;
   prev_selected_widget_ = nullptr;
 }
@@ -1246,6 +1250,7 @@ void ContainerWidget::DeleteWidget(Widget* w) {
         // issues.
         Object::Ref<Widget> w2 = *i;
         widgets_.erase(i);
+        nav_index_dirty_ = true;
         found = true;
         break;
       }
@@ -1418,124 +1423,122 @@ void ContainerWidget::SetSelected(bool s, SelectionCause cause) {
   }
 }
 
-auto ContainerWidget::GetClosestLeftWidget(float our_x, float our_y,
-                                           Widget* ignore_widget) -> Widget* {
+void ContainerWidget::UpdateNavIndex() {
+  if (!nav_index_dirty_) {
+    return;
+  }
+  nav_by_x_.clear();
+  for (size_t i = 0; i < widgets_.size(); i++) {
+    assert(widgets_[i].exists());
+    NavEntry entry{};
+    widgets_[i]->GetCenter(&entry.x, &entry.y);
+    entry.order = i;
+    entry.widget = widgets_[i].get();
+    nav_by_x_.push_back(entry);
+  }
+  nav_by_y_ = nav_by_x_;
+  std::stable_sort(
+      nav_by_x_.begin(), nav_by_x_.end(),
+      [](const NavEntry& a, const NavEntry& b) { return a.x < b.x; });
+  std::stable_sort(
+      nav_by_y_.begin(), nav_by_y_.end(),
+      [](const NavEntry& a, const NavEntry& b) { return a.y < b.y; });
+
+  // (Getting centers can lay out child containers, which dirties us).
+  nav_index_dirty_ = false;
+}
+
+auto ContainerWidget::GetClosestWidget(float our_x, float our_y,
+                                       Widget* ignore_widget, bool vertical,
+                                       bool forward) -> Widget* {
+  UpdateNavIndex();
+  const std::vector<NavEntry>& entries = vertical ? nav_by_y_ : nav_by_x_;
+  float our_pos = vertical ? our_y : our_x;
+  float our_cross_pos = vertical ? our_x : our_y;
+
+  // A widget's score is its distance over a slope term which tops out at
+  // this, so once we're this far along the axis past our best score,
+  // nothing further out can beat it (pad a bit for float slop).
+  const float max_divisor =
+      (AUTO_SELECT_SLOPE_WEIGHT * AUTO_SELECT_SLOPE_CLAMP
+       + (1.0f - AUTO_SELECT_SLOPE_WEIGHT) + AUTO_SELECT_SLOPE_OFFSET)
+      * 1.001f;
+
   Widget* w = nullptr;
-  float x, y;
   float closest_val = 9999.0f;
-  for (auto i = widgets_.begin(); i != widgets_.end(); i++) {
-    assert(i->exists());
-    (**i).GetCenter(&x, &y);
-    float slope = std::abs(x - our_x) / (std::max(0.001f, std::abs(y - our_y)));
+  size_t closest_order = 0;
+
+  // Returns false once there's no point looking further out.
+  auto consider = [&](const NavEntry& e) -> bool {
+    float dist_along = std::abs((vertical ? e.y : e.x) - our_pos);
+    if (w != nullptr && dist_along / max_divisor > closest_val) {
+      return false;
+    }
+    float dist_across = std::abs((vertical ? e.x : e.y) - our_cross_pos);
+    float slope = dist_along / (std::max(0.001f, dist_across));
     slope = std::min(
         slope, AUTO_SELECT_SLOPE_CLAMP);  // Beyond this, just go by distance.
     float slope_weighted = AUTO_SELECT_SLOPE_WEIGHT * slope
                            + (1.0f - AUTO_SELECT_SLOPE_WEIGHT) * 1.0f;
-    if (i->get() != ignore_widget && x < our_x && slope > AUTO_SELECT_MIN_SLOPE
-        && (**i).IsSelectable() && (**i).IsSelectableViaKeys()) {
+    if (e.widget != ignore_widget && slope > AUTO_SELECT_MIN_SLOPE
+        && e.widget->IsSelectable() && e.widget->IsSelectableViaKeys()) {
       // Take distance diff and multiply by our slope.
-      float xdist = x - our_x;
-      float ydist = y - our_y;
-      float dist = sqrtf(xdist * xdist + ydist * ydist);
+      float dist = sqrtf(dist_along * dist_along + dist_across * dist_across);
       float val =
           dist / std::max(0.001f, slope_weighted + AUTO_SELECT_SLOPE_OFFSET);
-      if (val < closest_val || w == nullptr) {
+
+      // Ties go to the earliest child, as when we simply scanned them all.
+      if (w == nullptr || val < closest_val
+          || (val == closest_val && e.order < closest_order)) {
         closest_val = val;
-        w = i->get();
+        closest_order = e.order;
+        w = e.widget;
+      }
+    }
+    return true;
+  };
+
+  // Walk outward from our position in the direction we're going.
+  if (forward) {
+    auto i = std::upper_bound(entries.begin(), entries.end(), our_pos,
+                              [vertical](float pos, const NavEntry& e) {
+                                return pos < (vertical ? e.y : e.x);
+                              });
+    for (; i != entries.end() && consider(*i); i++) {
+    }
+  } else {
+    auto i = std::lower_bound(entries.begin(), entries.end(), our_pos,
+                              [vertical](const NavEntry& e, float pos) {
+                                return (vertical ? e.y : e.x) < pos;
+                              });
+    while (i != entries.begin()) {
+      i--;
+      if (!consider(*i)) {
+        break;
       }
     }
   }
   return w;
 }
 
+auto ContainerWidget::GetClosestLeftWidget(float our_x, float our_y,
+                                           Widget* ignore_widget) -> Widget* {
+  return GetClosestWidget(our_x, our_y, ignore_widget, false, false);
+}
+
 auto ContainerWidget::GetClosestRightWidget(float our_x, float our_y,
                                             Widget* ignore_widget) -> Widget* {
-  Widget* w = nullptr;
-  float x, y;
-  float closest_val = 9999.0f;
-  for (auto i = widgets_.begin(); i != widgets_.end(); i++) {
-    assert(i->exists());
-    (**i).GetCenter(&x, &y);
-    float slope = std::abs(x - our_x) / (std::max(0.001f, std::abs(y - our_y)));
-    slope = std::min(
-        slope, AUTO_SELECT_SLOPE_CLAMP);  // beyond this, just go by distance
-    float slopeWeighted = AUTO_SELECT_SLOPE_WEIGHT * slope
-                          + (1.0f - AUTO_SELECT_SLOPE_WEIGHT) * 1.0f;
-    if (i->get() != ignore_widget && x > our_x && slope > AUTO_SELECT_MIN_SLOPE
-        && (**i).IsSelectable() && (**i).IsSelectableViaKeys()) {
-      // Take distance diff and multiply by our slope.
-      float xDist = x - our_x;
-      float yDist = y - our_y;
-      float dist = sqrtf(xDist * xDist + yDist * yDist);
-      float val =
-          dist / std::max(0.001f, slopeWeighted + AUTO_SELECT_SLOPE_OFFSET);
-      if (val < closest_val || w == nullptr) {
-        closest_val = val;
-        w = i->get();
-      }
-    }
-  }
-  return w;
+  return GetClosestWidget(our_x, our_y, ignore_widget, false, true);
 }
 
 auto ContainerWidget::GetClosestUpWidget(float our_x, float our_y,
-                                         Widget* ignoreWidget) -> Widget* {
-  Widget* w = nullptr;
-  float x, y;
-  float closest_val = 9999.0f;
-  for (auto i = widgets_.begin(); i != widgets_.end(); i++) {
-    assert(i->exists());
-    (**i).GetCenter(&x, &y);
-    float slope = std::abs(y - our_y) / (std::max(0.001f, std::abs(x - our_x)));
-    slope = std::min(
-        slope, AUTO_SELECT_SLOPE_CLAMP);  // Beyond this, just go by distance.
-    float slopeWeighted = AUTO_SELECT_SLOPE_WEIGHT * slope
-                          + (1.0f - AUTO_SELECT_SLOPE_WEIGHT) * 1.0f;
-    if (i->get() != ignoreWidget && y > our_y && slope > AUTO_SELECT_MIN_SLOPE
-        && (**i).IsSelectable() && (**i).IsSelectableViaKeys()) {
-      // Take distance diff and multiply by our slope.
-      float xDist = x - our_x;
-      float yDist = y - our_y;
-      float dist = sqrtf(xDist * xDist + yDist * yDist);
-      float val =
-          dist / std::max(0.001f, slopeWeighted + AUTO_SELECT_SLOPE_OFFSET);
-      if (val < closest_val || w == nullptr) {
-        closest_val = val;
-        w = i->get();
-      }
-    }
-  }
-  return w;
+                                         Widget* ignore_widget) -> Widget* {
+  return GetClosestWidget(our_x, our_y, ignore_widget, true, true);
 }
 
 auto ContainerWidget::GetClosestDownWidget(float our_x, float our_y,
-                                           Widget* ignoreWidget) -> Widget* {
-  Widget* w = nullptr;
-  float x, y;
-  float closest_val = 9999.0f;
-  for (auto i = widgets_.begin(); i != widgets_.end(); i++) {
-    assert(i->exists());
-    (**i).GetCenter(&x, &y);
-    float slope = std::abs(y - our_y) / (std::max(0.001f, std::abs(x - our_x)));
-    slope = std::min(
-        slope, AUTO_SELECT_SLOPE_CLAMP);  // Beyond this, just go by distance.
-    float slopeWeighted = AUTO_SELECT_SLOPE_WEIGHT * slope
-                          + (1.0f - AUTO_SELECT_SLOPE_WEIGHT) * 1.0f;
-    if (i->get() != ignoreWidget && y < our_y && slope > AUTO_SELECT_MIN_SLOPE
-        && (**i).IsSelectable() && (**i).IsSelectableViaKeys()) {
-      // Take distance diff and multiply by our slope.
-      float xDist = x - our_x;
-      float yDist = y - our_y;
-      float dist = sqrtf(xDist * xDist + yDist * yDist);
-      float val =
-          dist / std::max(0.001f, slopeWeighted + AUTO_SELECT_SLOPE_OFFSET);
-      if (val < closest_val || w == nullptr) {
-        closest_val = val;
-        w = i->get();
-      }
-    }
-  }
-  return w;
+                                           Widget* ignore_widget) -> Widget* {
+  return GetClosestWidget(our_x, our_y, ignore_widget, true, false);
 }
 
 void ContainerWidget::SelectDownWidget() {
@@ -1937,6 +1940,7 @@ void ContainerWidget::CheckLayout() {
     UpdateLayout();
     managed_ = true;
     needs_update_ = false;
+    nav_index_dirty_ = true;
   }
 }
 
@@ -1947,6 +1951,7 @@ void ContainerWidget::MarkForUpdate() {
       return;
     }
     w->needs_update_ = true;
+    w->nav_index_dirty_ = true;
     w = w->parent_widget();
   }
 }
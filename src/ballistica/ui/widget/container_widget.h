@@ -43,14 +43,19 @@ class ContainerWidget : public Widget {
   void SetRootSelectable(bool enable);
   void set_selectable(bool val) { selectable_ = val; }
 
+  // Called when children are added, removed, moved or resized.
+  void MarkNavIndexDirty() { nav_index_dirty_ = true; }
+
   virtual void SetWidth(float w) {
     bg_dirty_ = glow_dirty_ = true;
     width_ = w;
+    NoteBoundsChange();
     MarkForUpdate();
   }
   virtual void SetHeight(float h) {
     bg_dirty_ = glow_dirty_ = true;
     height_ = h;
+    NoteBoundsChange();
     MarkForUpdate();
   }
 
@@ -185,10 +190,27 @@ class ContainerWidget : public Widget {
 
   auto width() const -> float { return width_; }
   auto height() const -> float { return height_; }
-  void set_width(float val) { width_ = val; }
-  void set_height(float val) { height_ = val; }
+  void set_width(float val) {
+    width_ = val;
+    NoteBoundsChange();
+  }
+  void set_height(float val) {
+    height_ = val;
+    NoteBoundsChange();
+  }
 
  private:
+  // A child's center, for directional selection.
+  struct NavEntry {
+    float x;
+    float y;
+    size_t order;  // Index in widgets_.
+    Widget* widget;
+  };
+  void UpdateNavIndex();
+  auto GetClosestWidget(float our_x, float our_y, Widget* ignore_widget,
+                        bool vertical, bool forward) -> Widget*;
+
   // Given a container and a point, returns a selectable widget in the downward
   // direction or nullptr.
   auto GetClosestDownWidget(float x, float y, Widget* ignoreWidget) -> Widget*;
@@ -265,6 +287,11 @@ class ContainerWidget : public Widget {
   Object::WeakRef<ButtonWidget> start_button_;
   bool claims_outside_clicks_{};
 
+  // Child centers sorted by x and by y; rebuilt when layout changes.
+  std::vector<NavEntry> nav_by_x_;
+  std::vector<NavEntry> nav_by_y_;
+  bool nav_index_dirty_{true};
+
   // Keep these at the bottom so they're torn down first.
   // ...hmm that seems fragile; should I add explicit code to kill them?
   Object::Ref<PythonContextCall> on_activate_call_;
@@ -20,10 +20,12 @@ class ImageWidget : public Widget {
   void set_width(float width) {
     image_dirty_ = true;
     width_ = width;
+    NoteBoundsChange();
   }
   void set_height(float val) {
     image_dirty_ = true;
     height_ = val;
+    NoteBoundsChange();
   }
   auto GetWidth() -> float override;
   auto GetHeight() -> float override;
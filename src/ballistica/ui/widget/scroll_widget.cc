@@ -2,15 +2,21 @@
 
 #include "ballistica/ui/widget/scroll_widget.h"
 
+#include "ballistica/game/game.h"
 #include "ballistica/generic/real_timer.h"
 #include "ballistica/graphics/component/empty_component.h"
 #include "ballistica/graphics/component/simple_component.h"
+#include "ballistica/python/python_context_call.h"
+#include "ballistica/python/python_sys.h"
 #include "ballistica/ui/ui.h"
 
 namespace ballistica {
 
 #define V_MARGIN 5
 
+// How far we scroll between on-scroll-call reports.
+const float kScrollReportDistance = 10.0f;
+
 ScrollWidget::ScrollWidget() : touch_mode_(!g_platform->IsRunningOnDesktop()) {
   set_background(false);  // Influences default event handling.
   set_draggable(false);
@@ -585,6 +591,11 @@ void ScrollWidget::UpdateLayout() {
   thumb_dirty_ = true;
 }
 
+void ScrollWidget::SetOnScrollCall(PyObject* call_obj) {
+  on_scroll_call_ = Object::New<PythonContextCall>(call_obj);
+  reported_scroll_offset_ = -1.0f;
+}
+
 void ScrollWidget::Draw(RenderPass* pass, bool draw_transparent) {
   have_drawn_ = true;
   millisecs_t current_time = pass->frame_def()->base_time();
@@ -636,6 +647,21 @@ void ScrollWidget::Draw(RenderPass* pass, bool draw_transparent) {
         > 0.01f) {
       MarkForUpdate();
     }
+
+    if (on_scroll_call_.exists()
+        && (reported_scroll_offset_ < 0.0f
+            || std::abs(child_offset_v_smoothed_ - reported_scroll_offset_)
+                   >= kScrollReportDistance)) {
+      reported_scroll_offset_ = std::max(0.0f, child_offset_v_smoothed_);
+      PythonRef args(
+          Py_BuildValue("(ff)", reported_scroll_offset_,
+                        height() - 2 * (border_height_ + V_MARGIN)),
+          PythonRef::kSteal);
+
+      // Don't want to muck with the UI from within a draw.
+      g_game->PushPythonWeakCallArgs(
+          Object::WeakRef<PythonContextCall>(on_scroll_call_), args);
+    }
   }
 
   CheckLayout();
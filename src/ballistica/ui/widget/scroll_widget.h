@@ -46,6 +46,10 @@ class ScrollWidget : public ContainerWidget {
   void set_border_opacity(float val) { border_opacity_ = val; }
   auto border_opacity() const -> float { return border_opacity_; }
 
+  /// Gets called with our scroll offset (from the top of our child) and
+  /// visible height as we scroll, so Python can build lists lazily.
+  void SetOnScrollCall(PyObject* call_obj);
+
  protected:
   void UpdateLayout() override;
 
@@ -113,6 +117,8 @@ class ScrollWidget : public ContainerWidget {
   millisecs_t inertia_scroll_update_time_{};
   float inertia_scroll_rate_{};
   Object::Ref<RealTimer<ScrollWidget> > touch_delay_timer_;
+  Object::Ref<PythonContextCall> on_scroll_call_;
+  float reported_scroll_offset_{-1.0f};
 };
 
 }  // namespace ballistica
@@ -55,11 +55,13 @@ void TextWidget::set_on_activate_call(PyObject* call_tuple) {
 void TextWidget::SetWidth(float width_in) {
   highlight_dirty_ = outline_dirty_ = true;
   width_ = width_in;
+  NoteBoundsChange();
 }
 
 void TextWidget::SetHeight(float height_in) {
   highlight_dirty_ = outline_dirty_ = true;
   height_ = height_in;
+  NoteBoundsChange();
 }
 
 void TextWidget::SetEditable(bool e) {
@@ -218,6 +218,23 @@ auto Widget::GetPyWidget(bool new_ref) -> PyObject* {
   return py_ref_;
 }
 
+void Widget::set_translate(float x, float y) {
+  tx_ = x;
+  ty_ = y;
+  NoteBoundsChange();
+}
+
+void Widget::set_scale(float s) {
+  scale_ = s;
+  NoteBoundsChange();
+}
+
+void Widget::NoteBoundsChange() {
+  if (parent_widget_) {
+    parent_widget_->MarkNavIndexDirty();
+  }
+}
+
 void Widget::GetCenter(float* x, float* y) {
   *x = tx() + scale() * GetWidth() * 0.5f;
   *y = ty() + scale() * GetHeight() * 0.5f;
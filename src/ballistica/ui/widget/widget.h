@@ -197,10 +197,7 @@ class Widget : public Object {
 
   enum class SelectionCause { NEXT_SELECTED, PREV_SELECTED, NONE };
 
-  void set_translate(float x, float y) {
-    tx_ = x;
-    ty_ = y;
-  }
+  void set_translate(float x, float y);
   void set_stack_offset(float x, float y) {
     stack_offset_x_ = x;
     stack_offset_y_ = y;
@@ -214,11 +211,15 @@ class Widget : public Object {
 
   // Overall scale of the widget.
   auto scale() const -> float { return scale_; }
-  void set_scale(float s) { scale_ = s; }
+  void set_scale(float s);
 
   // Return the widget's center in its parent's space.
   virtual void GetCenter(float* x, float* y);
 
+  // Should be called when something affecting our center changes, so our
+  // parent's selection-navigation index gets rebuilt.
+  void NoteBoundsChange();
+
   // Translates a point from screen space to widget space.
   void ScreenPointToWidget(float* x, float* y) const;
   void WidgetPointToScreen(float* x, float* y) const;
@@ -64,7 +64,7 @@ OPCODECREATE::OPCODECREATE()
  *	Constructor.
  */
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-BaseModel::BaseModel() : mIMesh(null), mModelCode(0), mSource(null), mTree(null)
+BaseModel::BaseModel() : mIMesh(null), mModelCode(0), mSource(null), mTree(null), mTreeShared(false)
 {
 }
 
@@ -86,7 +86,9 @@ BaseModel::~BaseModel()
 void BaseModel::ReleaseBase()
 {
 	DELETESINGLE(mSource);
-	DELETESINGLE(mTree);
+	if(mTreeShared)	mTree = null;
+	else			DELETESINGLE(mTree);
+	mTreeShared = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
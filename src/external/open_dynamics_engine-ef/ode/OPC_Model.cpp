@@ -223,6 +223,31 @@ bool Model::Build(const OPCODECREATE& create)
  *	\return		amount of bytes used
  */
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool Model::BuildFromSerializedTree(MeshInterface* imesh, const void* data, udword size)
+{
+	if(!imesh || !imesh->IsValid())	return false;
+	Release();
+	mModelCode = 0;
+	SetMeshInterface(imesh);
+	udword NbTris = imesh->GetNbTriangles();
+	if(NbTris==1)
+	{
+		mModelCode |= OPC_SINGLE_NODE;
+		return size==0;
+	}
+	if(!CreateTree(true, false))	return false;
+	return static_cast<AABBNoLeafTree*>(mTree)->Deserialize(data, size, NbTris);
+}
+
+void Model::ShareTree(const Model& source, MeshInterface* imesh)
+{
+	Release();
+	SetMeshInterface(imesh);
+	mModelCode = source.mModelCode;
+	mTree = source.mTree;
+	mTreeShared = true;
+}
+
 udword Model::GetUsedBytes() const
 {
 	if(!mTree)	return 0;
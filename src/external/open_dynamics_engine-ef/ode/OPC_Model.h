@@ -54,6 +54,12 @@
 		///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		override(BaseModel)	udword				GetUsedBytes()	const;
 
+		// ballistica change: alternate ways to set up a no-leaf model; from
+		// a tree written by AABBNoLeafTree::Serialize(), or by sharing
+		// another model's tree (read-only; the source must outlive us).
+							bool				BuildFromSerializedTree(MeshInterface* imesh, const void* data, udword size);
+							void				ShareTree(const Model& source, MeshInterface* imesh);
+
 		private:
 #ifdef __MESHMERIZER_H__
 							CollisionHull*		mHull;			//!< Possible convex hull
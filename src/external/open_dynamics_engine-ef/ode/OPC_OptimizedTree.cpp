@@ -358,6 +358,79 @@ bool AABBNoLeafTree::Build(AABBTree* tree)
 	return true;
 }
 
+// ballistica change: serialized nodes store child links as indices
+// (even values) instead of pointers; leaf links (odd) are kept as-is.
+struct SerializedNoLeafNode
+{
+	float	mCenter[3];
+	float	mExtents[3];
+	udword	mPosData;
+	udword	mNegData;
+};
+
+udword AABBNoLeafTree::GetSerializedSize() const
+{
+	return mNbNodes * sizeof(SerializedNoLeafNode);
+}
+
+void AABBNoLeafTree::Serialize(void* buffer) const
+{
+	SerializedNoLeafNode* Out = (SerializedNoLeafNode*)buffer;
+	for(udword i=0;i<mNbNodes;i++)
+	{
+		const AABBNoLeafNode& N = mNodes[i];
+		SerializedNoLeafNode S;
+		S.mCenter[0] = N.mAABB.mCenter.x;
+		S.mCenter[1] = N.mAABB.mCenter.y;
+		S.mCenter[2] = N.mAABB.mCenter.z;
+		S.mExtents[0] = N.mAABB.mExtents.x;
+		S.mExtents[1] = N.mAABB.mExtents.y;
+		S.mExtents[2] = N.mAABB.mExtents.z;
+		S.mPosData = N.HasPosLeaf() ? udword(N.mPosData) : udword(N.GetPos() - mNodes) << 1;
+		S.mNegData = N.HasNegLeaf() ? udword(N.mNegData) : udword(N.GetNeg() - mNodes) << 1;
+		memcpy(&Out[i], &S, sizeof(S));
+	}
+}
+
+bool AABBNoLeafTree::Deserialize(const void* buffer, udword size, udword nb_tris)
+{
+	if(nb_tris<2 || size!=(nb_tris-1)*sizeof(SerializedNoLeafNode))	return false;
+	udword NbNodes = nb_tris-1;
+	AABBNoLeafNode* Nodes = new AABBNoLeafNode[NbNodes];
+	CHECKALLOC(Nodes);
+	const SerializedNoLeafNode* In = (const SerializedNoLeafNode*)buffer;
+	for(udword i=0;i<NbNodes;i++)
+	{
+		SerializedNoLeafNode S;
+		memcpy(&S, &In[i], sizeof(S));
+		AABBNoLeafNode& N = Nodes[i];
+		N.mAABB.mCenter.Set(S.mCenter[0], S.mCenter[1], S.mCenter[2]);
+		N.mAABB.mExtents.Set(S.mExtents[0], S.mExtents[1], S.mExtents[2]);
+		udword Links[2] = {S.mPosData, S.mNegData};
+		size_t* Outs[2] = {&N.mPosData, &N.mNegData};
+		for(int j=0;j<2;j++)
+		{
+			// Children always come later in the array, so this also
+			// guarantees we can't have cycles.
+			if(Links[j]&1)
+			{
+				if((Links[j]>>1)>=nb_tris)	{ DELETEARRAY(Nodes); return false; }
+				*Outs[j] = Links[j];
+			}
+			else
+			{
+				udword Index = Links[j]>>1;
+				if(Index<=i || Index>=NbNodes)	{ DELETEARRAY(Nodes); return false; }
+				*Outs[j] = size_t(&Nodes[Index]);
+			}
+		}
+	}
+	DELETEARRAY(mNodes);
+	mNodes = Nodes;
+	mNbNodes = NbNodes;
+	return true;
+}
+
 inline_ void ComputeMinMax(Point& min, Point& max, const VertexPointers& vp)
 {
 	// Compute triangle's AABB = a leaf box
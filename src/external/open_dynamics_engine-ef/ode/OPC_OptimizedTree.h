@@ -186,6 +186,13 @@
 	class OPCODE_API AABBNoLeafTree : public AABBOptimizedTree
 	{
 		IMPLEMENT_COLLISION_TREE(AABBNoLeafTree, AABBNoLeafNode)
+
+		// ballistica change: flat (pointer-free) serialization so built
+		// trees can be cached and loaded back in one read.
+		public:
+						udword				GetSerializedSize()	const;
+						void				Serialize(void* buffer)	const;
+						bool				Deserialize(const void* buffer, udword size, udword nb_tris);
 	};
 
 	class OPCODE_API AABBQuantizedTree : public AABBOptimizedTree
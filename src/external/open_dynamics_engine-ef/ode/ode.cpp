@@ -1453,6 +1453,8 @@ dxWorld * dWorldCreate()
   w->contactp.max_vel = dInfinity;
   w->contactp.min_depth = 0;
 
+  w->island_threads = 1;
+
   return w;
 }
 
@@ -1676,6 +1678,21 @@ int dWorldGetQuickStepNumIterations (dWorldID w)
 }
 
 
+void dWorldSetIslandThreadCount (dWorldID w, int count)
+{
+	dAASSERT(w);
+	dUASSERT (count > 0,"thread count must be > 0");
+	w->island_threads = count;
+}
+
+
+int dWorldGetIslandThreadCount (dWorldID w)
+{
+	dAASSERT(w);
+	return w->island_threads;
+}
+
+
 void dWorldSetQuickStepW (dWorldID w, dReal param)
 {
 	dAASSERT(w);
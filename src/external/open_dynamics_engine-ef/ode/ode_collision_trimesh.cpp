@@ -49,11 +49,11 @@ dxTriMeshData::~dxTriMeshData(){
 	//
 }
 
-void
+bool
 dxTriMeshData::Build(const void* Vertices, int VertexStide, int VertexCount,
 		     const void* Indices, int IndexCount, int TriStride,
 		     const void* in_Normals,
-		     bool Single){
+		     bool Single, const void* Tree, int TreeSize){
 	Mesh.SetNbTriangles(IndexCount / 3);
 	Mesh.SetNbVertices(VertexCount);
 	Mesh.SetPointers((IndexedTriangle*)Indices, (Point*)Vertices);
@@ -83,7 +83,13 @@ dxTriMeshData::Build(const void* Vertices, int VertexStide, int VertexCount,
 
 
 
-	BVTree.Build(TreeBuilder);
+	if (Tree) {
+		if (!BVTree.BuildFromSerializedTree(&Mesh, Tree, (udword)TreeSize)) {
+			return false;
+		}
+	} else {
+		BVTree.Build(TreeBuilder);
+	}
 
 	// compute model space AABB
 	dVector3 AABBMax, AABBMin;
@@ -126,6 +132,20 @@ dxTriMeshData::Build(const void* Vertices, int VertexStide, int VertexCount,
         last_trans[i] = 0.0;
 
     Normals = (dReal *) in_Normals;
+    return true;
+}
+
+void
+dxTriMeshData::BuildShared(const dxTriMeshData& Source){
+	Mesh = Source.Mesh;
+	BVTree.ShareTree(Source.BVTree, &Mesh);
+	for (int i=0; i<4; i++) {
+		AABBCenter[i] = Source.AABBCenter[i];
+		AABBExtents[i] = Source.AABBExtents[i];
+	}
+	for (int i=0; i<16; i++)
+		last_trans[i] = 0.0;
+	Normals = Source.Normals;
 }
 
 dTriMeshDataID dGeomTriMeshDataCreate(){
@@ -198,6 +218,48 @@ void dGeomTriMeshDataBuildSingle1(dTriMeshDataID g,
 }
 
 
+int dGeomTriMeshDataBuildSingleWithTree(dTriMeshDataID g,
+                                        const void* Vertices, int VertexStride, int VertexCount,
+                                        const void* Indices, int IndexCount, int TriStride,
+                                        const void* Normals,
+                                        const void* Tree, int TreeSize)
+{
+    dUASSERT(g, "argument not trimesh data");
+
+    return g->Build(Vertices, VertexStride, VertexCount,
+		    Indices, IndexCount, TriStride,
+		    Normals,
+		    true, Tree, TreeSize) ? 1 : 0;
+}
+
+
+void dGeomTriMeshDataBuildShared(dTriMeshDataID g, dTriMeshDataID source)
+{
+    dUASSERT(g, "argument not trimesh data");
+    dUASSERT(source, "argument not trimesh data");
+    g->BuildShared(*source);
+}
+
+
+int dGeomTriMeshDataGetTreeSize(dTriMeshDataID g)
+{
+    dUASSERT(g, "argument not trimesh data");
+    const AABBOptimizedTree* Tree = g->BVTree.GetTree();
+    // (We only ever build non-quantized no-leaf trees).
+    if (!Tree || g->BVTree.HasLeafNodes() || g->BVTree.IsQuantized()) return 0;
+    return (int)static_cast<const AABBNoLeafTree*>(Tree)->GetSerializedSize();
+}
+
+
+void dGeomTriMeshDataSaveTree(dTriMeshDataID g, void* Buffer)
+{
+    dUASSERT(g, "argument not trimesh data");
+    const AABBOptimizedTree* Tree = g->BVTree.GetTree();
+    if (Tree && !g->BVTree.HasLeafNodes() && !g->BVTree.IsQuantized())
+        static_cast<const AABBNoLeafTree*>(Tree)->Serialize(Buffer);
+}
+
+
 void dGeomTriMeshDataBuildSingle(dTriMeshDataID g,
 				 const void* Vertices, int VertexStride, int VertexCount,
                                  const void* Indices, int IndexCount, int TriStride)
@@ -341,6 +403,31 @@ void dxTriMesh::ClearTCCache(){
 }
 
 
+// Destroy the entry for geom (if any) and move the last one into its slot.
+// dArray already relocates its contents bitwise when it grows, so moving an
+// entry with memcpy is no different.
+template <class T>
+static void RemoveTCEntry(dArray<T>& cache, dxGeom* geom){
+	int n = cache.size();
+	for (int i = 0; i < n; ++i) {
+		if (cache[i].Geom == geom) {
+			cache[i].~T();
+			if (i != n - 1) {
+				memcpy(&cache[i], &cache[n - 1], sizeof(T));
+			}
+			cache.setSize(n - 1);
+			return;
+		}
+	}
+}
+
+void dxTriMesh::RemoveTCGeom(dxGeom* geom){
+	RemoveTCEntry(SphereTCCache, geom);
+	RemoveTCEntry(BoxTCCache, geom);
+	RemoveTCEntry(CCylinderTCCache, geom);
+}
+
+
 int dxTriMesh::AABBTest(dxGeom* g, dReal aabb[6]){
 	return 1;
 }
@@ -481,6 +568,13 @@ void dGeomTriMeshClearTCCache(dGeomID g){
 	Geom->ClearTCCache();
 }
 
+void dGeomTriMeshRemoveTCGeom(dGeomID g, dGeomID geom){
+	dUASSERT(g && g->type == dTriMeshClass, "argument not a trimesh");
+
+	dxTriMesh* Geom = (dxTriMesh*)g;
+	Geom->RemoveTCGeom(geom);
+}
+
 void dGeomTriMeshSetForceNormalMode(dGeomID g, int enable){
 	dUASSERT(g && g->type == dTriMeshClass, "argument not a trimesh");
 
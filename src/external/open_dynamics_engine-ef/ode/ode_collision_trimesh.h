@@ -66,6 +66,26 @@ void dGeomTriMeshDataBuildSingle1(dTriMeshDataID g,
                                   const void* Vertices, int VertexStride, int VertexCount, 
                                   const void* Indices, int IndexCount, int TriStride,
                                   const void* Normals);
+/*
+ * ballistica change: build with a collision tree previously written by
+ * dGeomTriMeshDataSaveTree() instead of building one. Returns 0 (leaving
+ * the data unusable) if the tree doesn't fit the mesh.
+ */
+int dGeomTriMeshDataBuildSingleWithTree(dTriMeshDataID g,
+                                        const void* Vertices, int VertexStride, int VertexCount,
+                                        const void* Indices, int IndexCount, int TriStride,
+                                        const void* Normals,
+                                        const void* Tree, int TreeSize);
+/* Bytes needed to save a built data's collision tree (0 if it can't be). */
+int dGeomTriMeshDataGetTreeSize(dTriMeshDataID g);
+void dGeomTriMeshDataSaveTree(dTriMeshDataID g, void* Buffer);
+/*
+ * ballistica change: build using the same vertices/indices/normals and
+ * collision tree as an already-built data. The tree is shared read-only,
+ * so source must outlive g.
+ */
+void dGeomTriMeshDataBuildShared(dTriMeshDataID g, dTriMeshDataID source);
+
 /*
 * Build TriMesh data with double pricision used in vertex data .
 */
@@ -137,6 +157,13 @@ int dGeomTriMeshIsTCEnabled(dGeomID g, int geomClass);
  */
 void dGeomTriMeshClearTCCache(dGeomID g);
 
+/*
+ * ballistica change: drops any temporal coherence cache entries this trimesh
+ * holds for a single geom. Call it before destroying a geom that may have
+ * collided with the trimesh so the caches don't grow without bound.
+ */
+void dGeomTriMeshRemoveTCGeom(dGeomID g, dGeomID geom);
+
 
 /*
  * sets the trimesh to "force-normal" mode in which its normals are always used
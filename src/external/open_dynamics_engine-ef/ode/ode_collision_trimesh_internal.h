@@ -54,10 +54,17 @@ struct dxTriMeshData  : public dBase {
     dxTriMeshData();
     ~dxTriMeshData();
     
-    void Build(const void* Vertices, int VertexStide, int VertexCount, 
+    // ballistica change: Tree/TreeSize optionally provide a serialized
+    // collision tree to use instead of building one (returns false if it
+    // doesn't fit the mesh).
+    bool Build(const void* Vertices, int VertexStide, int VertexCount, 
 	       const void* Indices, int IndexCount, int TriStride, 
 	       const void* Normals, 
-	       bool Single);
+	       bool Single, const void* Tree = NULL, int TreeSize = 0);
+
+    // ballistica change: set up using another data's mesh and (shared,
+    // read-only) collision tree.
+    void BuildShared(const dxTriMeshData& Source);
     
         /* aabb in model space */
         dVector3 AABBCenter;
@@ -131,6 +138,7 @@ struct dxTriMesh : public dxGeom{
 	~dxTriMesh();
 
 	void ClearTCCache();
+	void RemoveTCGeom(dxGeom* geom);
 
 	void setForceNormalMode(int f) {forceNormalMode=f;}
 
@@ -53,6 +53,12 @@ void dWorldImpulseToForce (dWorldID, dReal stepsize,
 void dWorldQuickStep (dWorldID w, dReal stepsize);
 void dWorldSetQuickStepNumIterations (dWorldID, int num);
 int dWorldGetQuickStepNumIterations (dWorldID);
+
+/* ericf addition: solve independent islands on this many threads (including
+ * the calling one). Results are identical to single-threaded stepping
+ * regardless of this value. Defaults to 1. */
+void dWorldSetIslandThreadCount (dWorldID, int count);
+int dWorldGetIslandThreadCount (dWorldID);
 void dWorldSetQuickStepW (dWorldID, dReal param);
 dReal dWorldGetQuickStepW (dWorldID);
 
@@ -119,6 +119,7 @@ struct dxWorld : public dBase {
   int adis_flag;		// auto-disable flag for new bodies
   dxQuickStepParameters qs;
   dxContactParameters contactp;
+  int island_threads;		// ericf addition: threads for island solving
 };
 
 
@@ -33,32 +33,90 @@
 #include "ode/ode_util.h"
 #include "ode/ode_misc.h"
 
+#include <vector>
+
 #define ALLOCA dALLOCA16
 
 typedef const dReal *dRealPtr;
 typedef dReal *dRealMutablePtr;
 #define dRealArray(name,n) dReal name[n];
 
+// Scratch storage for quickstep's larger temp arrays. Rather than hitting
+// malloc/free for each of these every step, we carve them out of a
+// per-thread arena whose chunks are kept around between steps. Buffers are
+// scoped locals and so are always released in the reverse order they were
+// allocated; this means releasing is just a rewind.
+class _ScratchArena{
+public:
+    struct Mark{
+        size_t chunk;
+        size_t used;
+    };
+    _ScratchArena():_current(0){
+    }
+    ~_ScratchArena(){
+        for (size_t i = 0; i < _chunks.size(); i++) free(_chunks[i].ptr);
+    }
+    void* alloc(size_t size, Mark* mark){
+        size = (size + 15) & ~static_cast<size_t>(15);
+        mark->chunk = _current;
+        mark->used = _current < _chunks.size() ? _chunks[_current].used : 0;
+
+        // Chunks past the current one are always empty.
+        while (_current < _chunks.size()
+               && _chunks[_current].used + size > _chunks[_current].size) {
+            _current++;
+            if (_current < _chunks.size()) _chunks[_current].used = 0;
+        }
+        if (_current == _chunks.size()) {
+            size_t chunk_size = _chunks.empty() ? 65536 : _chunks.back().size * 2;
+            if (chunk_size < size) chunk_size = size;
+            Chunk chunk;
+            chunk.ptr = static_cast<char*>(malloc(chunk_size));
+            dIASSERT(chunk.ptr);
+            chunk.size = chunk_size;
+            chunk.used = 0;
+            _chunks.push_back(chunk);
+        }
+        Chunk& chunk = _chunks[_current];
+        void* ptr = chunk.ptr + chunk.used;
+        chunk.used += size;
+        return ptr;
+    }
+    void release(const Mark& mark){
+        _current = mark.chunk;
+        if (_current < _chunks.size()) _chunks[_current].used = mark.used;
+    }
+private:
+    struct Chunk{
+        char* ptr;
+        size_t size;
+        size_t used;
+    };
+    std::vector<Chunk> _chunks;
+    size_t _current;
+};
+
+static thread_local _ScratchArena _scratch_arena;
+
 // ericf addition - a simple memory buffer
 class _Buffer{
 public:
-    _Buffer():_ptr(NULL),_allocated(false){
+    _Buffer():_ptr(NULL){
     }
     void allocate(unsigned long size){
-        if (_allocated && _ptr) free(_ptr);
-        //dIASSERT(size > 0);
-        _ptr = malloc(size);
+        dIASSERT(!_ptr);
+        _ptr = _scratch_arena.alloc(size, &_mark);
         dIASSERT(_ptr);
-        _allocated = true;
     }
     ~_Buffer(){
-        if (_allocated && _ptr) free(_ptr);
+        if (_ptr) _scratch_arena.release(_mark);
         _ptr = NULL;
     }
     void* getPtr() const {return _ptr;}
 private:
     void* _ptr;
-    bool _allocated;
+    _ScratchArena::Mark _mark;
 };
 
 
@@ -491,19 +549,21 @@ static void SOR_LCP (int m, int nb, dRealMutablePtr J, int *jb, dxBody * const *
 		qsort (order,m,sizeof(IndexError),&compare_index_error);
 #endif
 
-//ericf: we save and restore the random seed here so each island is not affected by the
-//existance of other islands
+//ericf: we start from the same random seed each time here so each island is not
+//affected by the existance of other islands. We run the generator on a local
+//copy of the seed (same math as dRandInt()) so islands can be solved in
+//parallel without fighting over the global one.
 #ifdef RANDOMLY_REORDER_CONSTRAINTS
-		unsigned long oldSeed = dRandGetSeed();
 		if ((iteration & 7) == 0) {
+			unsigned long seed = dRandGetSeed();
 			for (i=1; i<m; ++i) {
 				IndexError tmp = order[i];
-				int swapi = dRandInt(i+1);
+				seed = (1664525L*seed + 1013904223L) & 0xffffffff;
+				int swapi = (int) (double(seed) * (double(i+1) / 4294967296.0));
 				order[i] = order[swapi];
 				order[swapi] = tmp;
 			}
 		}
-		dRandSetSeed(oldSeed);
 #endif
 
 		//@@@ potential optimization: swap lambda and last_lambda pointers rather
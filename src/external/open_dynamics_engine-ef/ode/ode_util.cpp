@@ -24,7 +24,12 @@
 #include "ode/ode_objects_private.h"
 #include "ode/ode_joint.h"
 #include "ode/ode_util.h"
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #define ALLOCA dALLOCA16
 
@@ -94,6 +99,9 @@ static inline dReal sinc (dReal x)
 // given a body b, apply its linear and angular rotation over the time
 // interval h, thereby adjusting its position and orientation.
 
+// ericf addition: set on island worker threads while stepping.
+static thread_local bool dxDeferGeomMoved = false;
+
 void dxStepBody (dxBody *b, dReal h)
 {
     int j;
@@ -167,8 +175,12 @@ void dxStepBody (dxBody *b, dReal h)
     dQtoR (b->q,b->R);
 
     // notify all attached geoms that this body has moved
-    for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
-        dGeomMoved (geom);
+    // (ericf: unless we're solving islands in parallel; in that case this
+    // is done afterwards since it touches shared space lists)
+    if (!dxDeferGeomMoved) {
+        for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
+            dGeomMoved (geom);
+    }
 }
 
 //****************************************************************************
@@ -185,6 +197,181 @@ void dxStepBody (dxBody *b, dReal h)
 // bodies will not be included in the simulation. disabled bodies are
 // re-enabled if they are found to be part of an active island.
 
+// ericf addition: a minimal persistent worker pool for solving islands in
+// parallel. Tasks are handed out through an atomic counter; the calling
+// thread works on them too and returns once all are complete. The pool is
+// never destroyed (its threads simply sit idle at exit).
+
+class dxIslandWorkerPool {
+public:
+  static dxIslandWorkerPool *get() {
+    static dxIslandWorkerPool *pool = new dxIslandWorkerPool();
+    return pool;
+  }
+
+  void run (int thread_count, int task_count, void (*fn)(void *, int),
+            void *data) {
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex);
+    int helpers = thread_count - 1;
+    if (helpers > task_count - 1) helpers = task_count - 1;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      while ((int)threads.size() < helpers) {
+        int index = (int)threads.size();
+        unsigned long gen = generation;
+        threads.emplace_back([this, index, gen] { workerMain(index, gen); });
+      }
+      task_fn = fn;
+      task_data = data;
+      tasks = task_count;
+      next_task = 0;
+      active_helpers = helpers;
+      helpers_remaining = helpers;
+      generation++;
+    }
+    work_cv.notify_all();
+    processTasks();
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this] { return helpers_remaining == 0; });
+  }
+
+private:
+  void processTasks() {
+    for (;;) {
+      int task = next_task.fetch_add(1);
+      if (task >= tasks) break;
+      task_fn(task_data, task);
+    }
+  }
+
+  void workerMain (int index, unsigned long seen_generation) {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_cv.wait(lock, [&] { return generation != seen_generation; });
+        seen_generation = generation;
+        if (index >= active_helpers) continue;
+      }
+      processTasks();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        helpers_remaining--;
+      }
+      done_cv.notify_one();
+    }
+  }
+
+  std::mutex dispatch_mutex;
+  std::mutex mutex;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  std::vector<std::thread> threads;
+  unsigned long generation = 0;
+  void (*task_fn)(void *, int) = nullptr;
+  void *task_data = nullptr;
+  int tasks = 0;
+  std::atomic<int> next_task{0};
+  int active_helpers = 0;
+  int helpers_remaining = 0;
+};
+
+struct dxIslandBatch {
+  dxWorld *world;
+  dReal stepsize;
+  dstepper_fn_t stepper;
+  dxBody **body;
+  dxJoint **joint;
+  std::vector<int> body_start;	// per-island offsets (plus an end entry)
+  std::vector<int> joint_start;
+};
+
+static void dxStepIslandTask (void *data, int island)
+{
+  dxIslandBatch *batch = (dxIslandBatch*) data;
+  int b0 = batch->body_start[island];
+  int j0 = batch->joint_start[island];
+  bool old_defer = dxDeferGeomMoved;
+  dxDeferGeomMoved = true;
+  batch->stepper (batch->world, batch->body + b0,
+                  batch->body_start[island+1] - b0, batch->joint + j0,
+                  batch->joint_start[island+1] - j0, batch->stepsize);
+  dxDeferGeomMoved = old_defer;
+}
+
+// Like the single-threaded version below, except that we gather all
+// islands up front and then step them in parallel. Islands share no bodies
+// or joints, and the steppers don't touch anything else that's shared, so
+// the results match the single-threaded path exactly no matter how work
+// is divided. The one exception is the geom-moved notification, which
+// modifies space lists; we do that afterwards in the original order.
+static void dxProcessIslandsParallel (dxWorld *world, dReal stepsize,
+                                      dstepper_fn_t stepper)
+{
+  dxBody *b,*bb;
+  dxJoint *j;
+  int i;
+
+  dxIslandBatch batch;
+  batch.world = world;
+  batch.stepsize = stepsize;
+  batch.stepper = stepper;
+  batch.body = (dxBody**) ALLOCA (world->nb * sizeof(dxBody*));
+  batch.joint = (dxJoint**) ALLOCA (world->nj * sizeof(dxJoint*));
+  int bcount = 0;
+  int jcount = 0;
+
+  for (b=world->firstbody; b; b=(dxBody*)b->next) b->tag = 0;
+  for (j=world->firstjoint; j; j=(dxJoint*)j->next) j->tag = 0;
+
+  int stackalloc = (world->nj < world->nb) ? world->nj : world->nb;
+  dxBody **stack = (dxBody**) ALLOCA (stackalloc * sizeof(dxBody*));
+
+  for (bb=world->firstbody; bb; bb=(dxBody*)bb->next) {
+    if (bb->tag || (bb->flags & dxBodyDisabled)) continue;
+    bb->tag = 1;
+    batch.body_start.push_back(bcount);
+    batch.joint_start.push_back(jcount);
+
+    int stacksize = 0;
+    b = bb;
+    batch.body[bcount++] = bb;
+    goto quickstart;
+    while (stacksize > 0) {
+      b = stack[--stacksize];
+      batch.body[bcount++] = b;
+      quickstart:
+      for (dxJointNode *n=b->firstjoint; n; n=n->next) {
+	if (!n->joint->tag) {
+	  n->joint->tag = 1;
+	  batch.joint[jcount++] = n->joint;
+	  if (n->body && !n->body->tag) {
+	    n->body->tag = 1;
+	    stack[stacksize++] = n->body;
+	  }
+	}
+      }
+    }
+  }
+  int island_count = (int)batch.body_start.size();
+  batch.body_start.push_back(bcount);
+  batch.joint_start.push_back(jcount);
+
+  dxIslandWorkerPool::get()->run (world->island_threads, island_count,
+                                  &dxStepIslandTask, &batch);
+
+  // Now do our post-step tidying, in the same order the single-threaded
+  // path would have.
+  for (i=0; i<bcount; i++) {
+    b = batch.body[i];
+    for (dxGeom *geom = b->geom; geom; geom = dGeomGetBodyNext (geom))
+      dGeomMoved (geom);
+    b->tag = 1;
+    b->flags &= ~dxBodyDisabled;
+  }
+  for (i=0; i<jcount; i++) batch.joint[i]->tag = 1;
+}
+
+
 void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
 {
   dxBody *b,*bb,**body;
@@ -195,6 +382,11 @@ void dxProcessIslands (dxWorld *world, dReal stepsize, dstepper_fn_t stepper)
 
   // handle auto-disabling of bodies
   dInternalHandleAutoDisabling (world,stepsize);
+
+  if (world->island_threads > 1) {
+    dxProcessIslandsParallel (world,stepsize,stepper);
+    return;
+  }
   
   // make arrays for body and joint lists (for a single island) to go into
   body = (dxBody**) ALLOCA (world->nb * sizeof(dxBody*));
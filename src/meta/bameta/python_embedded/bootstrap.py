@@ -3,6 +3,7 @@
 
 from __future__ import annotations
 
+import os
 import sys
 import signal
 import threading
@@ -72,6 +73,13 @@ sys.stderr = _BAConsoleRedirect(sys.stderr, _ba.print_stderr)  # type: ignore
 # and then our bundled scripts last (don't want bundled site-package
 # stuff overwriting system versions)
 sys.path.insert(0, _ba.env()['python_directory_user'])
+
+# Builds can include a bytecode archive of our bundled scripts; importing
+# from that is a single file-open rather than a stat-fest across our
+# package dirs. (The loose files remain for anything that looks for them).
+_PYTHON_ARCHIVE = _ba.env()['python_directory_app'] + '.zip'
+if os.path.isfile(_PYTHON_ARCHIVE):
+    sys.path.append(_PYTHON_ARCHIVE)
 sys.path.append(_ba.env()['python_directory_app'])
 sys.path.append(_ba.env()['python_directory_app_site'])
 
@@ -137,6 +137,34 @@ class ServerConfig:
     team_colors: Optional[tuple[tuple[float, float, float],
                                 tuple[float, float, float]]] = None
 
+    # If present, the server prints a line of load stats every this many
+    # seconds: game step times, time spent in each phase of scene steps,
+    # and how busy and backed up each engine thread is. Handy for spotting
+    # lag before players notice it.
+    telemetry_log_interval: Optional[float] = None
+
+    # If present, the server answers queries on a Unix domain socket at
+    # this path, so orchestration can cheaply poll stats without sending
+    # Python commands. Requests and responses are single lines of json:
+    # send {"id": 1, "method": "stats"} and get back {"id": 1, "result":
+    # {...}} (or an "error" string). Methods are 'ping', 'stats' (uptime,
+    # client count, party info and load), 'roster' (the party roster),
+    # 'net_stats' (recent per-connection ping/traffic percentiles) and
+    # 'telemetry' (Prometheus-style text). Not supported on Windows.
+    control_socket_path: Optional[str] = None
+
+    # Pin engine threads to cpus on busy multi-server hosts. Keys are
+    # thread names ('game', 'media', 'audio', 'bg-dynamics',
+    # 'network-write', 'stdin' or 'default' for all others) and values are
+    # cpu lists such as '2' or '0-3,6', or a NUMA node such as 'node1'
+    # (Linux only). Supported on Linux and Windows.
+    thread_affinity: Optional[dict[str, str]] = None
+
+    # Thread scheduling priorities keyed as above; values are 'low',
+    # 'normal' or 'high'. On Linux, 'high' uses realtime round-robin
+    # scheduling if permitted and a lower nice value otherwise.
+    thread_priority: Optional[dict[str, str]] = None
+
     # (internal) stress-testing mode.
     stress_test_players: Optional[int] = None
 
@@ -167,6 +195,16 @@ class ShutdownCommand(ServerCommand):
     immediate: bool
 
 
+@dataclass
+class SoftRestartCommand(ServerCommand):
+    """Tells the server to restart its sessions in-process with a config.
+
+    Loaded media and Python modules are kept and clients stay connected.
+    """
+    config: ServerConfig
+    immediate: bool
+
+
 @dataclass
 class ChatMessageCommand(ServerCommand):
     """Chat message from the server."""
@@ -192,3 +230,23 @@ class KickCommand(ServerCommand):
     """Kick a client."""
     client_id: int
     ban_time: Optional[int]
+
+
+@dataclass
+class SamplePythonCommand(ServerCommand):
+    """Sample the game thread's Python stacks for a while."""
+    duration: float
+    path: Optional[str]
+    rate: float
+
+
+@dataclass
+class WriteTelemetryCommand(ServerCommand):
+    """Write engine load counters in Prometheus text format."""
+    path: Optional[str]
+
+
+@dataclass
+class WriteNetStatsCommand(ServerCommand):
+    """Write recent per-connection network stats as json."""
+    path: Optional[str]
@@ -7,6 +7,7 @@ from __future__ import annotations
 
 import hashlib
 import os
+import struct
 import sys
 import subprocess
 from functools import partial
@@ -52,6 +53,7 @@ class Config:
         self.tex_suffix: Optional[str] = None
         self.is_payload_full = False
         self.debug: Optional[bool] = None
+        self.build_media_archive = False
 
     def _parse_android_args(self, args: list[str]) -> None:
         # On Android we get nitpicky with what
@@ -138,6 +140,9 @@ class Config:
         if len(args) < 1:
             raise RuntimeError('Expected a platform argument.')
         platform = args[0]
+        self.build_media_archive = '-archive' in args
+        if self.build_media_archive:
+            args = [a for a in args if a != '-archive']
         if platform == '-android':
             self._parse_android_args(args)
         elif platform.startswith('-win'):
@@ -363,6 +368,123 @@ def _sync_standard_game_data(cfg: Config) -> None:
     _run(cmd)
 
 
+# Must match MediaArchive in src/ballistica/media/media_archive.h.
+MEDIA_ARCHIVE_NAME = 'media.bap'
+MEDIA_ARCHIVE_MAGIC = 0x4b504142
+MEDIA_ARCHIVE_VERSION = 1
+MEDIA_ARCHIVE_SUFFIXES = ('.bob', '.cob', '.dds', '.ktx')
+
+
+def _media_archive_hash(name: bytes) -> int:
+    # 64 bit FNV-1a.
+    hashval = 0xcbf29ce484222325
+    for byte in name:
+        hashval ^= byte
+        hashval = (hashval * 0x100000001b3) & 0xffffffffffffffff
+    return hashval
+
+
+def write_media_archive(media_root: str) -> None:
+    """Pack the archivable files in a media dir into a media archive.
+
+    The game memory-maps this and looks files up in it before hitting
+    the filesystem. Loose files are left in place (so anything that
+    can't read from the archive still works).
+    """
+    # pylint: disable=too-many-locals
+    names: list[bytes] = []
+    for root, _subdirs, fnames in os.walk(media_root):
+        for fname in fnames:
+            if fname.endswith(MEDIA_ARCHIVE_SUFFIXES):
+                names.append(
+                    os.path.relpath(os.path.join(root, fname),
+                                    media_root).replace(os.sep,
+                                                        '/').encode())
+
+    # Toc is sorted by hash for binary searching (and by name within a
+    # hash so output is deterministic).
+    names.sort(key=lambda n: (_media_archive_hash(n), n))
+    header_size = 16
+    entry_size = 32
+    names_offset = header_size + entry_size * len(names)
+    names_blob = b''.join(names)
+    data_offset = names_offset + len(names_blob)
+
+    toc = b''
+    layout: list[tuple[str, int]] = []
+    name_offset = names_offset
+    for name in names:
+        path = os.path.join(media_root, name.decode())
+        size = os.path.getsize(path)
+
+        # Keep payloads 16 byte aligned.
+        pad = -data_offset % 16
+        data_offset += pad
+        toc += struct.pack('<QQQII', _media_archive_hash(name), data_offset,
+                           size, name_offset, len(name))
+        layout.append((path, pad))
+        data_offset += size
+        name_offset += len(name)
+
+    outpath = os.path.join(media_root, MEDIA_ARCHIVE_NAME)
+    tmppath = outpath + '.tmp'
+    with open(tmppath, 'wb') as outfile:
+        outfile.write(
+            struct.pack('<IIII', MEDIA_ARCHIVE_MAGIC, MEDIA_ARCHIVE_VERSION,
+                        len(names), 0))
+        outfile.write(toc)
+        outfile.write(names_blob)
+        for path, pad in layout:
+            outfile.write(b'\0' * pad)
+            with open(path, 'rb') as infile:
+                outfile.write(infile.read())
+    os.replace(tmppath, outpath)
+    print(f'Wrote media archive ({len(names)} files): {outpath}')
+
+
+# Must match the path bootstrap.py looks for (python_directory_app + '.zip').
+PYTHON_ARCHIVE_NAME = 'python.zip'
+
+
+def write_python_archive(ba_data_root: str) -> None:
+    """Pack our bundled Python scripts' bytecode into a single zip archive.
+
+    The game puts this on sys.path ahead of the loose script dir so
+    imports come from one already-open file instead of probing a pile
+    of package dirs. Entries are stored uncompressed for quick reads, and
+    loose files are left in place (some code scans for those).
+    """
+    import zipfile
+    pyroot = os.path.join(ba_data_root, 'python')
+    entries: list[tuple[str, str]] = []
+    for root, subdirs, fnames in os.walk(pyroot):
+        subdirs[:] = sorted(d for d in subdirs if d != '__pycache__')
+        for fname in sorted(fnames):
+            if not fname.endswith('.py'):
+                continue
+            relpath = os.path.relpath(os.path.join(root, fname), pyroot)
+            relpath = relpath.replace(os.sep, '/')
+            pycpath = os.path.join(root, '__pycache__',
+                                   fname[:-3] + '.' + OPT_PYC_SUFFIX)
+
+            # Ship precompiled bytecode where we have it.
+            if os.path.exists(pycpath):
+                entries.append((relpath[:-3] + '.pyc', pycpath))
+            else:
+                entries.append((relpath, os.path.join(root, fname)))
+
+    outpath = os.path.join(ba_data_root, PYTHON_ARCHIVE_NAME)
+    tmppath = outpath + '.tmp'
+    with zipfile.ZipFile(tmppath, 'w', zipfile.ZIP_STORED) as zfile:
+        for arcname, path in entries:
+            # Fixed timestamps keep output deterministic.
+            info = zipfile.ZipInfo(arcname, date_time=(1980, 1, 1, 0, 0, 0))
+            with open(path, 'rb') as infile:
+                zfile.writestr(info, infile.read())
+    os.replace(tmppath, outpath)
+    print(f'Wrote python archive ({len(entries)} files): {outpath}')
+
+
 def _sync_server_files(cfg: Config) -> None:
     assert cfg.serverdst is not None
     assert cfg.debug is not None
@@ -504,6 +626,29 @@ def main(projroot: str, args: Optional[list[str]] = None) -> None:
     # Standard stuff in ba_data
     _sync_standard_game_data(cfg)
 
+    # Give staged models their reduced-detail levels (only touches plain
+    # bobs, so models that came through unchanged are skipped).
+    if cfg.include_models:
+        from batools.modellod import add_model_lods
+        assert cfg.dst is not None
+        add_model_lods(os.path.join(cfg.dst, 'ba_data'))
+
+    # Optionally pack up a media archive for quicker loading (or remove
+    # any stale one if not).
+    assert cfg.dst is not None
+    archive_path = os.path.join(cfg.dst, 'ba_data', MEDIA_ARCHIVE_NAME)
+    if cfg.build_media_archive:
+        write_media_archive(os.path.join(cfg.dst, 'ba_data'))
+    elif os.path.exists(archive_path):
+        os.unlink(archive_path)
+
+    # Likewise for our scripts' bytecode.
+    py_archive_path = os.path.join(cfg.dst, 'ba_data', PYTHON_ARCHIVE_NAME)
+    if cfg.build_media_archive and cfg.include_scripts:
+        write_python_archive(os.path.join(cfg.dst, 'ba_data'))
+    elif os.path.exists(py_archive_path):
+        os.unlink(py_archive_path)
+
     # On Android we need to build a payload file so it knows
     # what to pull out of the apk.
     if cfg.include_payload_file:
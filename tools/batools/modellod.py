@@ -0,0 +1,214 @@
+# Released under the MIT License. See LICENSE for details.
+#
+"""Generate reduced-detail versions of models as they get staged."""
+
+from __future__ import annotations
+
+import os
+import struct
+from typing import TYPE_CHECKING
+
+if TYPE_CHECKING:
+    from typing import Optional
+
+# Must match kBobFileID/kBobLODFileID in src/ballistica/ballistica.h and
+# ModelData::kMaxLODs in src/ballistica/media/data/model_data.h.
+BOB_FILE_ID = 45623
+BOB_LOD_FILE_ID = 45624
+MAX_LODS = 3
+
+# VertexObjectFull: float position[3], uint16 uv[2], int16 normal[3], pad.
+VERTEX_FORMAT = '<3f2H3h2x'
+VERTEX_SIZE = struct.calcsize(VERTEX_FORMAT)
+
+# Index type per MeshFormat value.
+INDEX_FORMATS = {0: 'B', 1: 'H', 2: 'I'}
+
+# Models smaller than this aren't worth the trouble.
+MIN_LOD_SOURCE_FACES = 256
+
+# Each level aims for this fraction of the previous one's faces, and we
+# stop adding levels once one doesn't get us at least most of the way.
+LOD_FACE_RATIO = 0.5
+LOD_MIN_REDUCTION = 0.8
+
+Face = tuple[int, int, int]
+
+
+def _normal_bucket(normal: tuple[int, int, int]) -> int:
+    # Dominant axis and its sign; keeps opposite sides of thin bits from
+    # getting merged together.
+    axis = max(range(3), key=lambda i: abs(normal[i]))
+    return axis * 2 + (1 if normal[axis] < 0 else 0)
+
+
+def _cluster(positions: list[tuple[float, float, float]],
+             buckets: list[int], faces: list[Face],
+             bounds_min: tuple[float, float, float], cell_size: float,
+             used: list[int]) -> list[Face]:
+    """Collapse vertices sharing a grid cell down to one of their own."""
+    # pylint: disable=too-many-locals
+    keys: dict[int, tuple[int, int, int, int]] = {}
+    sums: dict[tuple[int, int, int, int], list[float]] = {}
+    inv = 1.0 / cell_size
+    for i in used:
+        pos = positions[i]
+        key = (int((pos[0] - bounds_min[0]) * inv),
+               int((pos[1] - bounds_min[1]) * inv),
+               int((pos[2] - bounds_min[2]) * inv), buckets[i])
+        keys[i] = key
+        entry = sums.get(key)
+        if entry is None:
+            sums[key] = [pos[0], pos[1], pos[2], 1.0]
+        else:
+            entry[0] += pos[0]
+            entry[1] += pos[1]
+            entry[2] += pos[2]
+            entry[3] += 1.0
+
+    # Each cell is represented by the vertex nearest its average so we
+    # keep real uvs and normals (and can share the full model's vertices).
+    best: dict[tuple[int, int, int, int], tuple[float, int]] = {}
+    for i in used:
+        key = keys[i]
+        entry = sums[key]
+        pos = positions[i]
+        dist = ((pos[0] - entry[0] / entry[3])**2 +
+                (pos[1] - entry[1] / entry[3])**2 +
+                (pos[2] - entry[2] / entry[3])**2)
+        current = best.get(key)
+        if current is None or dist < current[0]:
+            best[key] = (dist, i)
+
+    out: list[Face] = []
+    seen: set[Face] = set()
+    for face in faces:
+        verts = (best[keys[face[0]]][1], best[keys[face[1]]][1],
+                 best[keys[face[2]]][1])
+        if (verts[0] == verts[1] or verts[1] == verts[2]
+                or verts[0] == verts[2]):
+            continue
+
+        # Rotate (keeping winding) so duplicates look the same.
+        low = verts.index(min(verts))
+        verts = (verts[low], verts[(low + 1) % 3], verts[(low + 2) % 3])
+        if verts in seen:
+            continue
+        seen.add(verts)
+        out.append(verts)
+    return out
+
+
+def generate_lods(positions: list[tuple[float, float, float]],
+                  normals: list[tuple[int, int, int]],
+                  faces: list[Face]) -> list[list[Face]]:
+    """Return up to MAX_LODS successively simpler face lists for a model.
+
+    These index into the model's own vertices, so a model's levels can
+    all share one vertex buffer.
+    """
+    if len(faces) < MIN_LOD_SOURCE_FACES:
+        return []
+    used = sorted({i for face in faces for i in face})
+    xvals = [positions[i][0] for i in used]
+    yvals = [positions[i][1] for i in used]
+    zvals = [positions[i][2] for i in used]
+    bounds_min = (min(xvals), min(yvals), min(zvals))
+    extent = max(
+        max(xvals) - bounds_min[0],
+        max(yvals) - bounds_min[1],
+        max(zvals) - bounds_min[2],
+    )
+    if extent <= 0.0:
+        return []
+    buckets = [_normal_bucket(n) for n in normals]
+
+    lods: list[list[Face]] = []
+    prev_count = len(faces)
+    for _level in range(MAX_LODS):
+        target = int(prev_count * LOD_FACE_RATIO)
+
+        # Find the finest grid that gets us down to our target.
+        low, high = 1, 1024
+        result: Optional[list[Face]] = None
+        while low <= high:
+            divisions = (low + high) // 2
+            candidate = _cluster(positions, buckets, faces, bounds_min,
+                                 extent / divisions, used)
+            if len(candidate) <= target:
+                result = candidate
+                low = divisions + 1
+            else:
+                high = divisions - 1
+        if (result is None or not result
+                or len(result) > prev_count * LOD_MIN_REDUCTION):
+            break
+        lods.append(result)
+        prev_count = len(result)
+    return lods
+
+
+def add_lods_to_bob(path: str) -> bool:
+    """Rewrite a .bob file with generated detail levels appended.
+
+    Returns True if the file was changed. Files that already have levels
+    or aren't worth simplifying are left alone.
+    """
+    # pylint: disable=too-many-locals
+    with open(path, 'rb') as infile:
+        data = infile.read()
+    version, mesh_format, vertex_count, face_count = struct.unpack_from(
+        '<4I', data, 0)
+    if version != BOB_FILE_ID:
+        return False
+    if mesh_format not in INDEX_FORMATS:
+        raise RuntimeError(f'Unknown mesh format {mesh_format} in {path}.')
+    index_format = INDEX_FORMATS[mesh_format]
+    index_size = struct.calcsize(index_format)
+    vertex_offset = 16
+    index_offset = vertex_offset + vertex_count * VERTEX_SIZE
+    index_end = index_offset + face_count * 3 * index_size
+    if len(data) < index_end:
+        raise RuntimeError(f'Truncated bob file: {path}.')
+
+    positions: list[tuple[float, float, float]] = []
+    normals: list[tuple[int, int, int]] = []
+    for vals in struct.iter_unpack(VERTEX_FORMAT,
+                                   data[vertex_offset:index_offset]):
+        positions.append((vals[0], vals[1], vals[2]))
+        normals.append((vals[5], vals[6], vals[7]))
+    indices = struct.unpack_from(f'<{face_count * 3}{index_format}', data,
+                                 index_offset)
+    faces = [(indices[i], indices[i + 1], indices[i + 2])
+             for i in range(0, len(indices), 3)]
+
+    lods = generate_lods(positions, normals, faces)
+    if not lods:
+        return False
+    lod_counts = [len(lod) for lod in lods]
+    lod_counts += [0] * (MAX_LODS - len(lods))
+    out = struct.pack('<8I', BOB_LOD_FILE_ID, mesh_format, vertex_count,
+                      face_count, len(lods), *lod_counts)
+    out += data[vertex_offset:index_end]
+    for lod in lods:
+        flat = [i for face in lod for i in face]
+        out += struct.pack(f'<{len(flat)}{index_format}', *flat)
+
+    tmppath = path + '.tmp'
+    with open(tmppath, 'wb') as outfile:
+        outfile.write(out)
+    os.replace(tmppath, path)
+    return True
+
+
+def add_model_lods(media_root: str) -> None:
+    """Add detail levels to all plain .bob files under a media dir."""
+    updated = 0
+    for root, _subdirs, fnames in os.walk(media_root):
+        for fname in fnames:
+            if fname.endswith('.bob'):
+                if add_lods_to_bob(os.path.join(root, fname)):
+                    updated += 1
+    if updated:
+        print(f'Generated detail levels for {updated} models in'
+              f' {media_root}.')